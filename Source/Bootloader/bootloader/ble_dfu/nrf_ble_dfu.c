@@ -462,6 +462,8 @@ static void process_handler_response_write(void               const * p_context,
                                            nrf_dfu_res_code_t         res_code,
                                            nrf_dfu_res_t      const * p_res)
 {
+    UNUSED_VARIABLE(p_res);
+
     uint32_t conn_token = (uint32_t) p_context;
 
     if (res_code != NRF_DFU_RES_CODE_SUCCESS)
@@ -477,10 +479,15 @@ static void process_handler_response_write(void               const * p_context,
 
         if (m_pkt_notif_target_cnt == 0)
         {
-            if (p_res != NULL)
-            {
-                response_crc_cmd_send(conn_token, p_res->offset, p_res->crc);
-            }
+            nrf_dfu_req_t dfu_req;
+
+            // The receipt is the response to a CRC request. The request handler can hold it back until
+            // the data is stored, which keeps the DFU controller from overrunning the flash buffers.
+            memset(&dfu_req, 0, sizeof(nrf_dfu_req_t));
+
+            dfu_req.req_type = NRF_DFU_OBJECT_OP_CRC;
+
+            nrf_dfu_req_handler_on_req((void const *)conn_token, &dfu_req, process_handler_response_calculate_crc);
 
             // Reset the counter for the number of firmware packets.
             m_pkt_notif_target_cnt = m_pkt_notif_target;
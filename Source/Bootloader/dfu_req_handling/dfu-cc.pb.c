@@ -56,7 +56,7 @@ const pb_field_t dfu_hash_fields[3] = {
     PB_LAST_FIELD
 };
 
-const pb_field_t dfu_init_command_fields[10] = {
+const pb_field_t dfu_init_command_fields[11] = {
     PB_FIELD(  1, UINT32  , OPTIONAL, STATIC  , FIRST, dfu_init_command_t, fw_version, fw_version, 0),
     PB_FIELD(  2, UINT32  , OPTIONAL, STATIC  , OTHER, dfu_init_command_t, hw_version, fw_version, 0),
     PB_FIELD(  3, UINT32  , REPEATED, STATIC  , OTHER, dfu_init_command_t, sd_req, hw_version, 0),
@@ -66,6 +66,7 @@ const pb_field_t dfu_init_command_fields[10] = {
     PB_FIELD(  7, UINT32  , OPTIONAL, STATIC  , OTHER, dfu_init_command_t, app_size, bl_size, 0),
     PB_FIELD(  8, MESSAGE , OPTIONAL, STATIC  , OTHER, dfu_init_command_t, hash, app_size, &dfu_hash_fields),
     PB_FIELD(  9, BOOL    , OPTIONAL, STATIC  , OTHER, dfu_init_command_t, is_debug, hash, &dfu_init_command_is_debug_default),
+    PB_FIELD( 10, UINT32  , OPTIONAL, STATIC  , OTHER, dfu_init_command_t, app_stream_size, is_debug, 0),
     PB_LAST_FIELD
 };
 
@@ -127,6 +127,8 @@ typedef struct {
     dfu_hash_t hash;
     bool has_is_debug;
     bool is_debug;
+    bool has_app_stream_size;
+    uint32_t app_stream_size;
 /* @@protoc_insertion_point(struct:dfu_init_command_t) */
 } dfu_init_command_t;
 
@@ -161,13 +163,13 @@ extern const bool dfu_init_command_is_debug_default;
 
 /* Initializer values for message structs */
 #define DFU_HASH_INIT_DEFAULT                    {(dfu_hash_type_t)0, {0, {0}}}
-#define DFU_INIT_COMMAND_INIT_DEFAULT            {false, 0, false, 0, 0, {0, 0, 0, 0}, false, (dfu_fw_type_t)0, false, 0, false, 0, false, 0, false, DFU_HASH_INIT_DEFAULT, false, false}
+#define DFU_INIT_COMMAND_INIT_DEFAULT            {false, 0, false, 0, 0, {0, 0, 0, 0}, false, (dfu_fw_type_t)0, false, 0, false, 0, false, 0, false, DFU_HASH_INIT_DEFAULT, false, false, false, 0}
 #define DFU_RESET_COMMAND_INIT_DEFAULT           {0}
 #define DFU_COMMAND_INIT_DEFAULT                 {false, (dfu_op_code_t)0, false, DFU_INIT_COMMAND_INIT_DEFAULT, false, DFU_RESET_COMMAND_INIT_DEFAULT}
 #define DFU_SIGNED_COMMAND_INIT_DEFAULT          {DFU_COMMAND_INIT_DEFAULT, (dfu_signature_type_t)0, {0, {0}}}
 #define DFU_PACKET_INIT_DEFAULT                  {false, DFU_COMMAND_INIT_DEFAULT, false, DFU_SIGNED_COMMAND_INIT_DEFAULT}
 #define DFU_HASH_INIT_ZERO                       {(dfu_hash_type_t)0, {0, {0}}}
-#define DFU_INIT_COMMAND_INIT_ZERO               {false, 0, false, 0, 0, {0, 0, 0, 0}, false, (dfu_fw_type_t)0, false, 0, false, 0, false, 0, false, DFU_HASH_INIT_ZERO, false, 0}
+#define DFU_INIT_COMMAND_INIT_ZERO               {false, 0, false, 0, 0, {0, 0, 0, 0}, false, (dfu_fw_type_t)0, false, 0, false, 0, false, 0, false, DFU_HASH_INIT_ZERO, false, 0, false, 0}
 #define DFU_RESET_COMMAND_INIT_ZERO              {0}
 #define DFU_COMMAND_INIT_ZERO                    {false, (dfu_op_code_t)0, false, DFU_INIT_COMMAND_INIT_ZERO, false, DFU_RESET_COMMAND_INIT_ZERO}
 #define DFU_SIGNED_COMMAND_INIT_ZERO             {DFU_COMMAND_INIT_ZERO, (dfu_signature_type_t)0, {0, {0}}}
@@ -186,6 +188,7 @@ extern const bool dfu_init_command_is_debug_default;
 #define DFU_INIT_COMMAND_APP_SIZE_TAG            7
 #define DFU_INIT_COMMAND_HASH_TAG                8
 #define DFU_INIT_COMMAND_IS_DEBUG_TAG            9
+#define DFU_INIT_COMMAND_APP_STREAM_SIZE_TAG     10
 #define DFU_COMMAND_OP_CODE_TAG                  1
 #define DFU_COMMAND_INIT_TAG                     2
 #define DFU_COMMAND_RESET_TAG                    3
@@ -197,7 +200,7 @@ extern const bool dfu_init_command_is_debug_default;
 
 /* Struct field encoding specification for nanopb */
 extern const pb_field_t dfu_hash_fields[3];
-extern const pb_field_t dfu_init_command_fields[10];
+extern const pb_field_t dfu_init_command_fields[11];
 extern const pb_field_t dfu_reset_command_fields[2];
 extern const pb_field_t dfu_command_fields[4];
 extern const pb_field_t dfu_signed_command_fields[4];
@@ -205,11 +208,11 @@ extern const pb_field_t dfu_packet_fields[3];
 
 /* Maximum encoded size of messages (where known) */
 #define DFU_HASH_SIZE                            36
-#define DFU_INIT_COMMAND_SIZE                    96
+#define DFU_INIT_COMMAND_SIZE                    102
 #define DFU_RESET_COMMAND_SIZE                   6
-#define DFU_COMMAND_SIZE                         108
-#define DFU_SIGNED_COMMAND_SIZE                  178
-#define DFU_PACKET_SIZE                          291
+#define DFU_COMMAND_SIZE                         114
+#define DFU_SIGNED_COMMAND_SIZE                  184
+#define DFU_PACKET_SIZE                          303
 
 /* Message IDs (where set with "msgid" option) */
 #ifdef PB_MSGID
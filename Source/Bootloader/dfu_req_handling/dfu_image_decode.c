@@ -0,0 +1,417 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+#include "dfu_image_decode.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "app_util.h"
+#include "crc32.h"
+#include "nrf_assert.h"
+#include "nrf_bootloader_info.h"
+#include "nrf_dfu_flash.h"
+#include "nrf_dfu_settings.h"
+#include "nrf_dfu_types.h"
+#include "sdk_config.h"
+
+#define NRF_LOG_MODULE_NAME dfu_image_decode
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+#define TOKEN_COPY_FLAG         0x80    /**< Token: copy instead of literal. */
+#define TOKEN_BASE_FLAG         0x40    /**< Token: copy from the current application instead of the decoded image. */
+#define TOKEN_LITERAL_LEN_MASK  0x7F    /**< Token: literal length - 1. */
+#define TOKEN_COPY_LEN_MASK     0x3F    /**< Token: copy length, see @ref dfu_image_decode.h. */
+
+#define COPY_OUTPUT_MIN_LEN     3       /**< Shortest copy from the decoded image. */
+
+/**@brief Decoding operations. */
+typedef enum
+{
+    DECODE_OP_LITERAL,                  /**< Copy from the stream. */
+    DECODE_OP_COPY_OUTPUT,              /**< Copy from the decoded image. */
+    DECODE_OP_COPY_BASE,                /**< Copy from the current application. */
+} decode_op_t;
+
+/**@brief Decoder state. */
+typedef struct
+{
+    uint32_t                    image_addr;     /**< Address of the image area. */
+    uint32_t                    image_size;     /**< Size of the decoded image. */
+    uint32_t                    stream_addr;    /**< Address of the stream. */
+    uint32_t                    stream_size;    /**< Size of the stream. */
+    uint32_t                    base_size;      /**< Size of the referenced part of the current application. */
+    uint8_t                  (* p_buffers)[FLASH_BUFFER_LENGTH]; /**< Buffers for the decoded image. */
+    size_t                      buffer_count;   /**< Number of buffers. */
+    uint32_t                    stream_pos;     /**< Position of the next stream byte. */
+    uint32_t                    out_pos;        /**< Position of the next decoded byte. */
+    uint32_t                    stored_chunks;  /**< Number of buffers stored in flash. */
+    size_t                      busy_buffers;   /**< Number of buffers being stored. */
+    decode_op_t                 op;             /**< Current operation. */
+    uint32_t                    op_len;         /**< Bytes left in the current operation. */
+    uint32_t                    op_src;         /**< Source position of the current operation. */
+    bool                        running;        /**< True while the decoding loop runs. */
+    bool                        failed;         /**< True if the stream was found invalid or a store failed. */
+    bool                        done;           /**< True if the whole image is decoded. */
+    dfu_image_decode_callback_t callback;       /**< Completion callback. */
+} decode_state_t;
+
+static decode_state_t m_decode;
+
+static void decode_run(void);
+
+
+/**@brief Function for reading a little endian value from the stream. */
+static uint32_t stream_read(size_t len)
+{
+    uint8_t const * p_src = (uint8_t const *)(m_decode.stream_addr + m_decode.stream_pos);
+    uint32_t        value = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        value |= (uint32_t)p_src[i] << (8 * i);
+    }
+
+    m_decode.stream_pos += len;
+
+    return value;
+}
+
+
+/**@brief Function for reading a byte of the decoded image.
+ *
+ * @details Bytes of the buffers that are stored are read back from flash, the rest from the buffers.
+ */
+static uint8_t output_read(uint32_t pos)
+{
+    uint32_t chunk = pos / FLASH_BUFFER_LENGTH;
+
+    if (chunk < m_decode.stored_chunks)
+    {
+        return *(uint8_t const *)(m_decode.image_addr + pos);
+    }
+
+    return m_decode.p_buffers[chunk % m_decode.buffer_count][pos % FLASH_BUFFER_LENGTH];
+}
+
+
+static void decode_store_completed(nrf_fstorage_evt_t * p_evt)
+{
+    ASSERT(m_decode.busy_buffers > 0);
+
+    if (p_evt->result != NRF_SUCCESS)
+    {
+        m_decode.failed = true;
+    }
+
+    m_decode.busy_buffers  -= 1;
+    m_decode.stored_chunks += 1;
+
+    decode_run();
+}
+
+
+/**@brief Function for storing the buffer that holds the last decoded byte. */
+static void output_store(void)
+{
+    uint32_t   chunk = (m_decode.out_pos - 1) / FLASH_BUFFER_LENGTH;
+    uint32_t   len   = m_decode.out_pos - chunk * FLASH_BUFFER_LENGTH;
+    ret_code_t err_code;
+
+    m_decode.busy_buffers += 1;
+
+    err_code = nrf_dfu_flash_store(m_decode.image_addr + chunk * FLASH_BUFFER_LENGTH,
+                                   m_decode.p_buffers[chunk % m_decode.buffer_count],
+                                   len,
+                                   decode_store_completed);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("%s(): failed storing %d B at offset 0x%08x", __func__, len, chunk * FLASH_BUFFER_LENGTH);
+        m_decode.busy_buffers -= 1;
+        m_decode.failed        = true;
+    }
+}
+
+
+/**@brief Function for reading the next operation from the stream.
+ *
+ * @return False if the operation is invalid.
+ */
+static bool op_fetch(void)
+{
+    uint32_t stream_left = m_decode.stream_size - m_decode.stream_pos;
+    uint8_t  token       = (uint8_t)stream_read(1);
+
+    if ((token & TOKEN_COPY_FLAG) == 0)
+    {
+        m_decode.op     = DECODE_OP_LITERAL;
+        m_decode.op_len = (token & TOKEN_LITERAL_LEN_MASK) + 1;
+        m_decode.op_src = m_decode.stream_pos;
+
+        if (m_decode.op_len > stream_left - 1)
+        {
+            return false;
+        }
+
+        // The literal bytes are consumed from the stream as they are copied.
+    }
+    else if ((token & TOKEN_BASE_FLAG) == 0)
+    {
+        if (stream_left < 3)
+        {
+            return false;
+        }
+
+        m_decode.op     = DECODE_OP_COPY_OUTPUT;
+        m_decode.op_len = (token & TOKEN_COPY_LEN_MASK) + COPY_OUTPUT_MIN_LEN;
+
+        uint32_t distance = stream_read(2) + 1;
+        if (distance > m_decode.out_pos)
+        {
+            return false;
+        }
+
+        m_decode.op_src = m_decode.out_pos - distance;
+    }
+    else
+    {
+        if (stream_left < 5)
+        {
+            return false;
+        }
+
+        m_decode.op     = DECODE_OP_COPY_BASE;
+        m_decode.op_len = (((token & TOKEN_COPY_LEN_MASK) << 8) | stream_read(1)) + 1;
+        m_decode.op_src = stream_read(3);
+
+        if ((m_decode.op_src > m_decode.base_size) ||
+            (m_decode.op_len > m_decode.base_size - m_decode.op_src))
+        {
+            return false;
+        }
+    }
+
+    return (m_decode.op_len <= m_decode.image_size - m_decode.out_pos);
+}
+
+
+/**@brief Function for decoding until the buffers are full or the stream ends. */
+static void decode_run(void)
+{
+    if (m_decode.running)
+    {
+        // Called from a store that completed synchronously.
+        return;
+    }
+
+    m_decode.running = true;
+
+    while (!m_decode.failed && !m_decode.done && (m_decode.busy_buffers < m_decode.buffer_count))
+    {
+        uint8_t byte;
+
+        if (m_decode.op_len == 0)
+        {
+            if (m_decode.stream_pos == m_decode.stream_size)
+            {
+                if (m_decode.out_pos != m_decode.image_size)
+                {
+                    NRF_LOG_WARNING("%s(): stream ended at image offset 0x%08x", __func__, m_decode.out_pos);
+                    m_decode.failed = true;
+                }
+                else
+                {
+                    if ((m_decode.out_pos % FLASH_BUFFER_LENGTH) != 0)
+                    {
+                        // Store the last, partially filled buffer.
+                        output_store();
+                    }
+
+                    m_decode.done = true;
+                }
+                break;
+            }
+
+            if (!op_fetch())
+            {
+                NRF_LOG_WARNING("%s(): invalid operation at stream offset 0x%08x", __func__, m_decode.stream_pos);
+                m_decode.failed = true;
+                break;
+            }
+        }
+
+        switch (m_decode.op)
+        {
+            case DECODE_OP_LITERAL:
+                byte = *(uint8_t const *)(m_decode.stream_addr + m_decode.stream_pos);
+                m_decode.stream_pos += 1;
+                break;
+
+            case DECODE_OP_COPY_OUTPUT:
+                byte = output_read(m_decode.op_src);
+                m_decode.op_src += 1;
+                break;
+
+            default:
+                byte = *(uint8_t const *)(MAIN_APPLICATION_START_ADDR + m_decode.op_src);
+                m_decode.op_src += 1;
+                break;
+        }
+
+        m_decode.p_buffers[(m_decode.out_pos / FLASH_BUFFER_LENGTH) % m_decode.buffer_count]
+                          [m_decode.out_pos % FLASH_BUFFER_LENGTH] = byte;
+
+        m_decode.out_pos += 1;
+        m_decode.op_len  -= 1;
+
+        if ((m_decode.out_pos % FLASH_BUFFER_LENGTH) == 0)
+        {
+            output_store();
+        }
+    }
+
+    m_decode.running = false;
+
+    if ((m_decode.busy_buffers == 0) &&
+        (m_decode.failed || m_decode.done) &&
+        (m_decode.callback != NULL))
+    {
+        dfu_image_decode_callback_t callback = m_decode.callback;
+
+        m_decode.callback = NULL;
+
+        NRF_LOG_INFO("Image decoding %s", m_decode.failed ? "failed" : "done");
+        callback(m_decode.failed ? NRF_DFU_RES_CODE_INVALID_OBJECT : NRF_DFU_RES_CODE_SUCCESS);
+    }
+}
+
+
+static void decode_erase_completed(nrf_fstorage_evt_t * p_evt)
+{
+    if (p_evt->result != NRF_SUCCESS)
+    {
+        m_decode.failed = true;
+    }
+
+    decode_run();
+}
+
+
+/**@brief Function for checking the referenced part of the current application. */
+static bool base_check(uint32_t base_crc)
+{
+    if (m_decode.base_size == 0)
+    {
+        return true;
+    }
+
+    // The current application must be valid, and must not be overwritten by the decoded image.
+    if ((s_dfu_settings.bank_0.bank_code != NRF_DFU_BANK_VALID_APP) ||
+        (m_decode.base_size > s_dfu_settings.bank_0.image_size)    ||
+        (m_decode.image_addr < MAIN_APPLICATION_START_ADDR + m_decode.base_size))
+    {
+        NRF_LOG_WARNING("%s(): current application cannot be used", __func__);
+        return false;
+    }
+
+    if (crc32_compute((uint8_t const *)MAIN_APPLICATION_START_ADDR, m_decode.base_size, NULL) != base_crc)
+    {
+        NRF_LOG_WARNING("%s(): current application does not match", __func__);
+        return false;
+    }
+
+    return true;
+}
+
+
+nrf_dfu_res_code_t dfu_image_decode_start(uint32_t                    image_addr,
+                                          uint32_t                    image_size,
+                                          uint32_t                    stream_addr,
+                                          uint32_t                    stream_size,
+                                          void                      * p_buffers,
+                                          size_t                      buffer_count,
+                                          dfu_image_decode_callback_t callback)
+{
+    uint32_t   base_crc;
+    ret_code_t err_code;
+
+    ASSERT((image_addr & (CODE_PAGE_SIZE - 1)) == 0);
+    ASSERT(stream_addr >= image_addr + image_size);
+    ASSERT((p_buffers != NULL) && (buffer_count > 0));
+    ASSERT(callback != NULL);
+
+    memset(&m_decode, 0, sizeof(m_decode));
+
+    m_decode.image_addr   = image_addr;
+    m_decode.image_size   = image_size;
+    m_decode.stream_addr  = stream_addr;
+    m_decode.stream_size  = stream_size;
+    m_decode.p_buffers    = p_buffers;
+    m_decode.buffer_count = buffer_count;
+
+    if ((stream_size < DFU_IMAGE_DECODE_HEADER_SIZE) ||
+        (stream_read(4) != DFU_IMAGE_DECODE_MAGIC))
+    {
+        NRF_LOG_WARNING("%s(): invalid stream header", __func__);
+        return NRF_DFU_RES_CODE_INVALID_OBJECT;
+    }
+
+    m_decode.base_size = stream_read(4);
+    base_crc           = stream_read(4);
+
+    if (!base_check(base_crc))
+    {
+        return NRF_DFU_RES_CODE_INVALID_OBJECT;
+    }
+
+    NRF_LOG_INFO("Decoding %d B stream into %d B image at 0x%08x (delta base: %d B)",
+                 stream_size, image_size, image_addr, m_decode.base_size);
+
+    m_decode.callback = callback;
+
+    err_code = nrf_dfu_flash_erase(image_addr, CEIL_DIV(image_size, CODE_PAGE_SIZE), decode_erase_completed);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_decode.callback = NULL;
+        return NRF_DFU_RES_CODE_OPERATION_FAILED;
+    }
+
+    return NRF_DFU_RES_CODE_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+#ifndef DFU_IMAGE_DECODE_H__
+#define DFU_IMAGE_DECODE_H__
+
+/**@file
+ *
+ * @brief Decoding of encoded application images.
+ *
+ * @details An application can be transferred as an encoded stream instead of a plain image. The init command
+ *          then holds the size of the stream in @c app_stream_size, while @c app_size and the hash describe
+ *          the decoded image as usual. The stream is received into the flash area following the image, and
+ *          decoded into the image area once all data objects are executed.
+ *
+ *          The stream starts with a 12-byte header (all values little endian):
+ *           - Magic number @ref DFU_IMAGE_DECODE_MAGIC (4 bytes).
+ *           - Number of bytes of the current application that may be referenced (4 bytes). Zero if the
+ *             stream is a compressed image that does not refer to the current application.
+ *           - CRC32 of the referenced part of the current application (4 bytes).
+ *
+ *          The header is followed by a sequence of operations, each starting with a token byte:
+ *           - @c 0xxxxxxx: Literal. The next (x + 1) bytes of the stream are copied to the image.
+ *           - @c 10xxxxxx, followed by a 16-bit distance d: (x + 3) bytes are copied from (d + 1) bytes back
+ *             in the decoded image.
+ *           - @c 11xxxxxx, followed by a byte y and a 24-bit offset o: ((x << 8) + y + 1) bytes are copied
+ *             from offset o of the current application.
+ *
+ *          The last operation type turns the stream into a delta against the current application. It is
+ *          only accepted when the current application stays intact during the update (dual bank layout).
+ *
+ *          Decoding uses the flash buffers of the request handler and reads both the stream and the
+ *          already decoded data directly from flash, so the RAM usage does not depend on the image size.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nrf_dfu_req_handler.h"
+
+#define DFU_IMAGE_DECODE_MAGIC          0x315A5253  /**< "SRZ1" */
+#define DFU_IMAGE_DECODE_HEADER_SIZE    12          /**< Size of the stream header. */
+
+/**@brief Decoding completion callback.
+ *
+ * @param[in] res_code @ref NRF_DFU_RES_CODE_SUCCESS if the whole image was decoded and stored.
+ */
+typedef void (* dfu_image_decode_callback_t)(nrf_dfu_res_code_t res_code);
+
+/**@brief Function for starting to decode an image.
+ *
+ * @details The image area is erased and the decoded image is stored in it. The callback is called once
+ *          all data is stored, or when the stream is found to be invalid.
+ *
+ * @param[in] image_addr   Address of the image area. Must be page aligned.
+ * @param[in] image_size   Size of the decoded image.
+ * @param[in] stream_addr  Address of the received stream. Must not be within the image area.
+ * @param[in] stream_size  Size of the received stream.
+ * @param[in] p_buffers    Buffers of @c FLASH_BUFFER_LENGTH bytes used to store the decoded image.
+ * @param[in] buffer_count Number of buffers.
+ * @param[in] callback     Completion callback.
+ *
+ * @retval NRF_DFU_RES_CODE_SUCCESS        Decoding started, the result is passed to the callback.
+ * @retval NRF_DFU_RES_CODE_INVALID_OBJECT The stream header is invalid or does not match the current application.
+ * @retval NRF_DFU_RES_CODE_OPERATION_FAILED The image area could not be erased.
+ */
+nrf_dfu_res_code_t dfu_image_decode_start(uint32_t                    image_addr,
+                                          uint32_t                    image_size,
+                                          uint32_t                    stream_addr,
+                                          uint32_t                    stream_size,
+                                          void                      * p_buffers,
+                                          size_t                      buffer_count,
+                                          dfu_image_decode_callback_t callback);
+
+#endif // DFU_IMAGE_DECODE_H__
@@ -38,6 +38,7 @@
  * 
  */
 #include "dfu_req_handling.h"
+#include "dfu_image_decode.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -80,14 +81,35 @@ extern app_timer_id_t const nrf_dfu_post_sd_bl_timeout_timer_id;
 extern app_timer_id_t const nrf_dfu_inactivity_timeout_timer_id;
 
 
+/** @brief Number of free flash buffers required before a CRC response is sent.
+ *
+ * The DFU controller waits for packet receipts (CRC responses) before it sends more data. Holding a receipt back
+ * until FLASH catches up throttles the controller instead of failing the object when the buffers run out.
+ */
+#ifndef FLASH_BUFFER_RECEIPT_THRESHOLD
+#define FLASH_BUFFER_RECEIPT_THRESHOLD (FLASH_BUFFER_COUNT / 2)
+#endif
+
+STATIC_ASSERT(FLASH_BUFFER_RECEIPT_THRESHOLD <= FLASH_BUFFER_COUNT);
+
 /** @brief Buffers used to schedule store of received packets to FLASH. */
 __ALIGN(4) static uint8_t  m_data_buf[FLASH_BUFFER_COUNT][FLASH_BUFFER_LENGTH];
 
 STATIC_ASSERT(DATA_OBJECT_MAX_SIZE < sizeof(m_data_buf));
 
+static uint16_t m_data_buf_len[FLASH_BUFFER_COUNT];      /**< The number of bytes scheduled for store from each buffer. */
+static uint16_t m_data_buf_crc_pos[FLASH_BUFFER_COUNT];  /**< The number of bytes of each buffer already included in the firmware image CRC. */
+
 static size_t m_data_buf_pos;     /**< The number of bytes written in the current buffer. */
 static size_t m_write_buffer_id;  /**< Index of the currently written data buffer. Must be between 0 and FLASH_BUFFER_COUNT - 1. */
-static size_t m_read_buffer_id;   /**< Index of the last read data buffer. Must be between 0 and FLASH_BUFFER_COUNT - 1. */
+static size_t m_read_buffer_id;   /**< Index of the oldest buffer being stored. Must be between 0 and FLASH_BUFFER_COUNT - 1. */
+static size_t m_busy_buffers;     /**< The number of buffers being stored. */
+
+/** @brief Contains a pointer to a callback function when a CRC response waits for free FLASH buffers. */
+static nrf_dfu_req_callback m_crc_callback_function;
+
+/** @brief Contains a context passed to the CRC callback function. */
+static void const * m_crc_callback_context;
 
 /** @brief Contains a pointer to a callback function when object execute should wait for FLASH.
  *
@@ -106,6 +128,9 @@ static bool m_objectexecute_callback_postvalidate;
 static uint32_t m_firmware_start_addr;  /**< Start address of the current firmware image. */
 static uint32_t m_firmware_size_req;    /**< The size of the entire firmware image. Defined by the init command. */
 
+static uint32_t m_image_start_addr;     /**< Start address of the decoded image if the firmware is an encoded application stream. */
+static uint32_t m_image_size_req;       /**< The size of the decoded image. Zero if the firmware is not encoded. */
+
 
 static bool m_valid_init_packet_present;        /**< True if init command was received and validated. */
 static bool m_is_dfu_complete_response_sent;    /**< True if the last DFU response was successfully sent. */
@@ -249,6 +274,40 @@ static void pb_decoding_callback(pb_istream_t *str, uint32_t tag, pb_wire_type_t
 }
 
 
+/** @brief Function for finding the location of the firmware, see @ref nrf_dfu_find_cache.
+ *
+ * @details An encoded application stream is placed after the area of the decoded image, and is decoded
+ *          into that area once it is received.
+ */
+static uint32_t firmware_location_find(dfu_init_command_t const * p_init)
+{
+    uint32_t image_area_size;
+    uint32_t err_code;
+
+    m_image_size_req = 0;
+
+    if ((p_init->type != DFU_FW_TYPE_APPLICATION) || (p_init->has_app_stream_size == false))
+    {
+        return nrf_dfu_find_cache(m_firmware_size_req, &m_firmware_start_addr);
+    }
+
+    image_area_size = CEIL_DIV(p_init->app_size, CODE_PAGE_SIZE) * CODE_PAGE_SIZE;
+
+    err_code = nrf_dfu_find_cache(image_area_size + p_init->app_stream_size, &m_image_start_addr);
+    if (err_code == NRF_SUCCESS)
+    {
+        m_image_size_req      = p_init->app_size;
+        m_firmware_start_addr = m_image_start_addr + image_area_size;
+        m_firmware_size_req   = p_init->app_stream_size;
+
+        NRF_LOG_INFO("Encoded image: %d B stream for %d B image at 0x%08x",
+                     m_firmware_size_req, m_image_size_req, m_image_start_addr);
+    }
+
+    return err_code;
+}
+
+
 static nrf_dfu_res_code_t dfu_handle_prevalidate(dfu_signed_command_t const * p_command, pb_istream_t * p_stream, uint8_t * p_init_cmd, uint32_t init_cmd_len)
 {
     dfu_init_command_t const * p_init = &p_command->command.init;
@@ -411,6 +470,11 @@ static nrf_dfu_res_code_t dfu_handle_prevalidate(dfu_signed_command_t const * p_
                 NRF_LOG_ERROR("No app image size");
                 return ext_error_set(NRF_DFU_EXT_ERROR_INIT_COMMAND_INVALID);
             }
+            if ((p_init->has_app_stream_size != false) && (p_init->app_stream_size == 0))
+            {
+                NRF_LOG_ERROR("No app stream size");
+                return ext_error_set(NRF_DFU_EXT_ERROR_INIT_COMMAND_INVALID);
+            }
             m_firmware_size_req += p_init->app_size;
             break;
 
@@ -474,6 +538,12 @@ static nrf_dfu_res_code_t dfu_handle_prevalidate(dfu_signed_command_t const * p_
             return ext_error_set(NRF_DFU_EXT_ERROR_INIT_COMMAND_INVALID);
     }
 
+    if ((p_init->has_app_stream_size != false) && (p_init->type != DFU_FW_TYPE_APPLICATION))
+    {
+        NRF_LOG_ERROR("Only applications can be encoded");
+        return ext_error_set(NRF_DFU_EXT_ERROR_INIT_COMMAND_INVALID);
+    }
+
     NRF_LOG_INFO("Running hash check");
     // SHA256 is the only supported hash
     memcpy(fw_hash.p_value, &p_init->hash.hash.bytes[0], NRF_CRYPTO_HASH_SIZE_SHA256);
@@ -487,7 +557,7 @@ static nrf_dfu_res_code_t dfu_handle_prevalidate(dfu_signed_command_t const * p_
     }
 
     // Find the location to place the DFU updates
-    err_code = nrf_dfu_find_cache(m_firmware_size_req, &m_firmware_start_addr);
+    err_code = firmware_location_find(p_init);
     if (err_code != NRF_SUCCESS)
     {
         NRF_LOG_ERROR("Can't find room for update");
@@ -577,9 +647,9 @@ static nrf_dfu_res_code_t nrf_dfu_postvalidate(dfu_init_command_t * p_init)
         if ((cur_SD_major_minor != new_SD_major_minor) ||
             (cur_SD_size        != new_SD_size))
         {
-            NRF_LOG_INFO("New and current SD are incompatible")
-            NRF_LOG_INFO("SD version: current %u, new %u", cur_SD_major_minor, new_SD_major_minor)
-            NRF_LOG_INFO("SD size: current %u, new %u", cur_SD_size, new_SD_size)
+            NRF_LOG_INFO("New and current SD are incompatible");
+            NRF_LOG_INFO("SD version: current %u, new %u", cur_SD_major_minor, new_SD_major_minor);
+            NRF_LOG_INFO("SD size: current %u, new %u", cur_SD_size, new_SD_size);
 
             // A new SD API does not match the current API.
             if (p_init->type == DFU_FW_TYPE_SOFTDEVICE)
@@ -899,27 +969,180 @@ static ret_code_t nrf_dfu_command_req(void                 const * p_context,
 }
 
 
+/** @brief Function for including the given part of a data buffer in the firmware image CRC.
+ *
+ * @param[in] buffer_id Index of the data buffer.
+ * @param[in] len       The number of bytes in the buffer that must be covered by the CRC.
+ */
+static void data_buf_crc_update(size_t buffer_id, size_t len)
+{
+    size_t const crc_pos = m_data_buf_crc_pos[buffer_id];
+
+    if (crc_pos < len)
+    {
+        s_dfu_settings.progress.firmware_image_crc = crc32_compute(&m_data_buf[buffer_id][crc_pos],
+                                                                   len - crc_pos,
+                                                                   &s_dfu_settings.progress.firmware_image_crc);
+        m_data_buf_crc_pos[buffer_id] = len;
+    }
+}
+
+
+/** @brief Function for bringing the firmware image CRC up to date with all received data.
+ *
+ * @details The CRC is normally updated when a buffer has been stored. This function covers the data that is still
+ *          waiting in the buffers, and is called only when the CRC must be reported or saved.
+ */
+static void data_crc_update(void)
+{
+    size_t buffer_id = m_read_buffer_id;
+
+    for (size_t i = 0; i < m_busy_buffers; i++)
+    {
+        data_buf_crc_update(buffer_id, m_data_buf_len[buffer_id]);
+        buffer_id = (buffer_id + 1) % FLASH_BUFFER_COUNT;
+    }
+
+    if (m_busy_buffers < FLASH_BUFFER_COUNT)
+    {
+        data_buf_crc_update(m_write_buffer_id, m_data_buf_pos);
+    }
+}
+
+
+/** @brief Function for dropping the data waiting in the buffers from the firmware image CRC.
+ *
+ * @details Used when the object is reverted. Buffers that are still being stored will not update the CRC
+ *          when they complete.
+ */
+static void data_crc_discard(void)
+{
+    for (size_t i = 0; i < FLASH_BUFFER_COUNT; i++)
+    {
+        m_data_buf_crc_pos[i] = m_data_buf_len[i];
+    }
+
+    if (m_busy_buffers < FLASH_BUFFER_COUNT)
+    {
+        m_data_buf_crc_pos[m_write_buffer_id] = FLASH_BUFFER_LENGTH;
+    }
+
+    m_data_buf_pos = 0;
+}
+
+
+/** @brief Function for sending the firmware image offset and CRC to a callback. */
+static void data_crc_response_send(void const * p_context, nrf_dfu_req_callback p_callback)
+{
+    nrf_dfu_res_t dfu_res;
+
+    data_crc_update();
+
+    memset(&dfu_res, 0, sizeof(dfu_res));
+
+    dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
+    dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
+
+    p_callback(p_context, NRF_DFU_RES_CODE_SUCCESS, &dfu_res);
+}
+
+
+/** @brief Function for sending the result of the postponed object execute command. */
+static void object_execute_complete(nrf_dfu_res_code_t res_code)
+{
+    nrf_dfu_req_callback p_callback = m_objectexecute_callback_function;
+
+    m_objectexecute_callback_function = NULL;
+    p_callback(m_objectexecute_callback_context, res_code, NULL);
+}
+
+
+static void image_decode_completed(nrf_dfu_res_code_t res_code)
+{
+    if (res_code == NRF_DFU_RES_CODE_SUCCESS)
+    {
+        // From now on, the decoded image is the firmware.
+        m_firmware_start_addr = m_image_start_addr;
+        m_firmware_size_req   = m_image_size_req;
+        m_image_size_req      = 0;
+
+        // The CRC collected during the transfer covers the stream. The bank CRC must cover the decoded image,
+        // as it is checked before the image is copied or started.
+        s_dfu_settings.progress.firmware_image_crc = crc32_compute((uint8_t const *)m_firmware_start_addr,
+                                                                   m_firmware_size_req,
+                                                                   NULL);
+
+        res_code = nrf_dfu_postvalidate(&dfu_init_packet.signed_command.command.init);
+    }
+
+    object_execute_complete(res_code);
+}
+
+
+/** @brief Function for validating the firmware once all data is stored in FLASH.
+ *
+ * @details An encoded application stream is decoded first. The result is sent to the postponed
+ *          object execute command.
+ */
+static void firmware_complete(void)
+{
+    nrf_dfu_res_code_t res_code;
+
+    if (m_image_size_req != 0)
+    {
+        res_code = dfu_image_decode_start(m_image_start_addr,
+                                          m_image_size_req,
+                                          m_firmware_start_addr,
+                                          m_firmware_size_req,
+                                          m_data_buf,
+                                          FLASH_BUFFER_COUNT,
+                                          image_decode_completed);
+        if (res_code != NRF_DFU_RES_CODE_SUCCESS)
+        {
+            object_execute_complete(res_code);
+        }
+        return;
+    }
+
+    object_execute_complete(nrf_dfu_postvalidate(&dfu_init_packet.signed_command.command.init));
+}
+
+
 static void nrf_dfu_flash_store_completed(nrf_fstorage_evt_t * p_evt)
 {
+    ASSERT(m_busy_buffers > 0);
+
+    // Update the CRC here rather than when the data is received, to keep the BLE event path short.
+    data_buf_crc_update(m_read_buffer_id, m_data_buf_len[m_read_buffer_id]);
+
     m_read_buffer_id = (m_read_buffer_id + 1) % FLASH_BUFFER_COUNT;
+    m_busy_buffers  -= 1;
+
+    if ((m_crc_callback_function != NULL) &&
+        (FLASH_BUFFER_COUNT - m_busy_buffers >= FLASH_BUFFER_RECEIPT_THRESHOLD))
+    {
+        nrf_dfu_req_callback p_callback = m_crc_callback_function;
+
+        m_crc_callback_function = NULL;
+        data_crc_response_send(m_crc_callback_context, p_callback);
+    }
 
     if (m_objectexecute_callback_function != NULL)
     {
-        size_t used_buffers = (FLASH_BUFFER_COUNT + m_write_buffer_id - m_read_buffer_id) % FLASH_BUFFER_COUNT;
-        size_t available_buffers = FLASH_BUFFER_COUNT - used_buffers;
+        size_t available_buffers = FLASH_BUFFER_COUNT - m_busy_buffers;
 
         // Make sure there are enough buffers to complete object execute command.
         // If this is last transfer, wait for all buffers to be stored and perform postvalidate.
-        if (( m_objectexecute_callback_postvalidate && (m_read_buffer_id == m_write_buffer_id)) ||
-            (!m_objectexecute_callback_postvalidate && (available_buffers * FLASH_BUFFER_LENGTH >= DATA_OBJECT_MAX_SIZE)))
+        if (m_objectexecute_callback_postvalidate)
         {
-            nrf_dfu_res_code_t ret_code = NRF_DFU_RES_CODE_SUCCESS;
-            if (m_objectexecute_callback_postvalidate)
+            if (m_busy_buffers == 0)
             {
-                ret_code = nrf_dfu_postvalidate(&dfu_init_packet.signed_command.command.init);
+                firmware_complete();
             }
-            m_objectexecute_callback_function(m_objectexecute_callback_context, ret_code, NULL);
-            m_objectexecute_callback_function = NULL;
+        }
+        else if (available_buffers * FLASH_BUFFER_LENGTH >= DATA_OBJECT_MAX_SIZE)
+        {
+            object_execute_complete(NRF_DFU_RES_CODE_SUCCESS);
         }
     }
 }
@@ -1020,15 +1243,15 @@ static ret_code_t nrf_dfu_data_req_write(void                 const * p_context,
 {
     size_t const object_size_current = s_dfu_settings.progress.firmware_image_offset -
                                        s_dfu_settings.progress.firmware_image_offset_last;
-    bool   const write_buffer_available = (m_read_buffer_id != ((m_write_buffer_id + 1) % FLASH_BUFFER_COUNT));
-    bool   const object_completed = (p_req->req_len + object_size_current == s_dfu_settings.progress.data_object_size);
+    size_t const free_buffer_bytes   = (m_busy_buffers < FLASH_BUFFER_COUNT) ?
+                                       ((FLASH_BUFFER_COUNT - m_busy_buffers) * FLASH_BUFFER_LENGTH - m_data_buf_pos) : 0;
+    bool   const object_completed    = (p_req->req_len + object_size_current == s_dfu_settings.progress.data_object_size);
 
     nrf_dfu_res_t dfu_res;
 
     memset(&dfu_res, 0, sizeof(dfu_res));
 
     dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
-    dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
 
     // Validate request
 
@@ -1046,40 +1269,35 @@ static ret_code_t nrf_dfu_data_req_write(void                 const * p_context,
         return NRF_SUCCESS;
     }
 
-    if (write_buffer_available == false)
+    if (free_buffer_bytes < p_req->req_len)
     {
-        if ((FLASH_BUFFER_LENGTH - m_data_buf_pos < p_req->req_len) ||
-            (object_completed != false))
-        {
-            NRF_LOG_WARNING("%s(): no write buffer available", __func__);
+        // The DFU controller did not wait for the packet receipts. There is nowhere to keep the data.
+        NRF_LOG_WARNING("%s(): no write buffer available", __func__);
 
-            // Flash operation failed. Revert CRC and offset.
-            s_dfu_settings.progress.data_object_size      = 0;
-            s_dfu_settings.progress.firmware_image_crc    = s_dfu_settings.progress.firmware_image_crc_last;
-            s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
+        // Flash operation failed. Revert CRC and offset.
+        data_crc_discard();
 
-            s_dfu_settings.write_offset = m_firmware_start_addr + s_dfu_settings.progress.firmware_image_offset;
+        s_dfu_settings.progress.data_object_size      = 0;
+        s_dfu_settings.progress.firmware_image_crc    = s_dfu_settings.progress.firmware_image_crc_last;
+        s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
 
-            // Update the return values
-            dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
-            dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
+        s_dfu_settings.write_offset = m_firmware_start_addr + s_dfu_settings.progress.firmware_image_offset;
 
-            p_callback(p_context, NRF_DFU_RES_CODE_OPERATION_FAILED, &dfu_res);
+        // Update the return values
+        dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
+        dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
 
-            return NRF_SUCCESS;
-        }
-    }
+        p_callback(p_context, NRF_DFU_RES_CODE_OPERATION_FAILED, &dfu_res);
 
-    // Copy data
+        return NRF_SUCCESS;
+    }
 
+    // Copy data. The CRC of the firmware image is updated when the data is stored, see @ref nrf_dfu_flash_store_completed.
 
-    // Update the CRC of the firmware image.
-    s_dfu_settings.progress.firmware_image_crc     = crc32_compute(p_req->p_req, p_req->req_len, &s_dfu_settings.progress.firmware_image_crc);
     s_dfu_settings.progress.firmware_image_offset += p_req->req_len;
 
-    // Update the return values
+    // Update the return values. The CRC is reported by NRF_DFU_OBJECT_OP_CRC.
     dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
-    dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
 
 
     ret_code_t rcode = NRF_SUCCESS;
@@ -1093,6 +1311,11 @@ static ret_code_t nrf_dfu_data_req_write(void                 const * p_context,
             copy_len = FLASH_BUFFER_LENGTH - m_data_buf_pos;
         }
 
+        if (m_data_buf_pos == 0)
+        {
+            m_data_buf_crc_pos[m_write_buffer_id] = 0;
+        }
+
         memcpy(&m_data_buf[m_write_buffer_id][m_data_buf_pos], &p_req->p_req[copy_pos], copy_len);
 
         m_data_buf_pos += copy_len;
@@ -1101,16 +1324,21 @@ static ret_code_t nrf_dfu_data_req_write(void                 const * p_context,
         if ((m_data_buf_pos == FLASH_BUFFER_LENGTH) ||
             ((object_completed != false) && (copy_pos == p_req->req_len)))
         {
+            size_t const buffer_id = m_write_buffer_id;
+
+            // Advance the ring before storing: the store may complete before nrf_dfu_flash_store() returns.
+            m_data_buf_len[buffer_id] = m_data_buf_pos;
+            m_write_buffer_id         = (m_write_buffer_id + 1) % FLASH_BUFFER_COUNT;
+            m_busy_buffers           += 1;
+
             rcode = nrf_dfu_flash_store(s_dfu_settings.write_offset,
-                                        &m_data_buf[m_write_buffer_id][0],
+                                        &m_data_buf[buffer_id][0],
                                         m_data_buf_pos,
                                         nrf_dfu_flash_store_completed);
             if (rcode == NRF_SUCCESS)
             {
                 NRF_LOG_INFO("Storing %d bytes at: 0x%08x", m_data_buf_pos, s_dfu_settings.write_offset);
 
-                m_write_buffer_id = (m_write_buffer_id + 1) % FLASH_BUFFER_COUNT;
-
                 s_dfu_settings.write_offset += m_data_buf_pos;
             }
             else
@@ -1118,7 +1346,12 @@ static ret_code_t nrf_dfu_data_req_write(void                 const * p_context,
                 NRF_LOG_ERROR("%s(): failed storing %d B at address: 0x%08x",
                               __func__, m_data_buf_pos, s_dfu_settings.write_offset);
 
+                m_write_buffer_id = buffer_id;
+                m_busy_buffers   -= 1;
+
                 // Flash operation failed. Revert CRC and offset.
+                data_crc_discard();
+
                 s_dfu_settings.progress.data_object_size      = 0;
                 s_dfu_settings.progress.firmware_image_crc    = s_dfu_settings.progress.firmware_image_crc_last;
                 s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
@@ -1163,6 +1396,9 @@ static ret_code_t nrf_dfu_data_req_execute(void                const * p_context
 
     NRF_LOG_INFO("Valid Data Execute");
 
+    // The CRC of the executed object is saved in the settings, so include the data that is still being stored.
+    data_crc_update();
+
     s_dfu_settings.progress.data_object_size           = 0;
     s_dfu_settings.progress.firmware_image_offset_last = s_dfu_settings.progress.firmware_image_offset;
     s_dfu_settings.progress.firmware_image_crc_last    = s_dfu_settings.progress.firmware_image_crc;
@@ -1179,23 +1415,20 @@ static ret_code_t nrf_dfu_data_req_execute(void                const * p_context
         // Postpone postvalidate until the whole image is written to FLASH.
         // Note that as both FLASH and BLE calls are performed from the same
         // context (irq level) we don't need to use critical section.
-        if (m_read_buffer_id == m_write_buffer_id)
-        {
-            nrf_dfu_res_code_t ret_code = nrf_dfu_postvalidate(&dfu_init_packet.signed_command.command.init);
-            p_callback(p_context, ret_code, NULL);
-        }
-        else
+        m_objectexecute_callback_function     = p_callback;
+        m_objectexecute_callback_context      = p_context;
+        m_objectexecute_callback_postvalidate = true;
+
+        if (m_busy_buffers == 0)
         {
-            m_objectexecute_callback_function     = p_callback;
-            m_objectexecute_callback_context      = p_context;
-            m_objectexecute_callback_postvalidate = true;
+            firmware_complete();
         }
     }
     else
     {
-        // Postpone response until there is enough space to hold entire object.
-        size_t used_buffers = (FLASH_BUFFER_COUNT + m_write_buffer_id - m_read_buffer_id) % FLASH_BUFFER_COUNT;
-        size_t available_buffers = FLASH_BUFFER_COUNT - used_buffers;
+        // Postpone response until there is enough space to hold entire object. This is the flow control
+        // of a DFU controller which does not request packet receipts.
+        size_t available_buffers = FLASH_BUFFER_COUNT - m_busy_buffers;
 
         if (available_buffers * FLASH_BUFFER_LENGTH >= DATA_OBJECT_MAX_SIZE)
         {
@@ -1217,14 +1450,24 @@ static uint32_t nrf_dfu_data_req_crc(void                 const * p_context,
                                      nrf_dfu_req_t        const * p_req,
                                      nrf_dfu_req_callback         p_callback)
 {
-    nrf_dfu_res_t dfu_res;
+    if (m_crc_callback_function != NULL)
+    {
+        // Only one response is held back. Release the previous one first.
+        nrf_dfu_req_callback p_pending_callback = m_crc_callback_function;
 
-    memset(&dfu_res, 0, sizeof(dfu_res));
+        m_crc_callback_function = NULL;
+        data_crc_response_send(m_crc_callback_context, p_pending_callback);
+    }
 
-    dfu_res.crc    = s_dfu_settings.progress.firmware_image_crc;
-    dfu_res.offset = s_dfu_settings.progress.firmware_image_offset;
+    if (FLASH_BUFFER_COUNT - m_busy_buffers < FLASH_BUFFER_RECEIPT_THRESHOLD)
+    {
+        // Postpone the response, and so the next data from the DFU controller, until FLASH catches up.
+        m_crc_callback_function = p_callback;
+        m_crc_callback_context  = p_context;
+        return NRF_SUCCESS;
+    }
 
-    p_callback(p_context, NRF_DFU_RES_CODE_SUCCESS, &dfu_res);
+    data_crc_response_send(p_context, p_callback);
 
     return NRF_SUCCESS;
 }
@@ -1236,6 +1479,8 @@ static uint32_t nrf_dfu_data_req_select(void                 const * p_context,
 {
     nrf_dfu_res_t dfu_res;
 
+    data_crc_update();
+
     memset(&dfu_res, 0, sizeof(dfu_res));
 
     dfu_res.crc      = s_dfu_settings.progress.firmware_image_crc;
@@ -1326,8 +1571,16 @@ ret_code_t nrf_dfu_req_handler_init(void)
             return NRF_SUCCESS;
         }
 
+        dfu_init_command_t const * p_init = &dfu_init_packet.signed_command.command.init;
+
+        if (p_init->has_app_stream_size != false)
+        {
+            // The bank holds both the decoded image and the stream.
+            m_firmware_size_req = p_init->app_size;
+        }
+
         // Location should still be valid, expecting result of find-cache to be true
-        (void)nrf_dfu_find_cache(m_firmware_size_req, &m_firmware_start_addr);
+        (void)firmware_location_find(p_init);
 
         // Setting valid init command to true to
         m_valid_init_packet_present = true;
@@ -39,6 +39,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "nrf_assert.h"
 #include "app_debug.h"
 #include "app_timer.h"
@@ -54,53 +55,145 @@
 #include "nrf_log.h"
 NRF_LOG_MODULE_REGISTER();
 
-#if (CONFIG_KBD_HELD_EVENT_INTERVAL_MS == 0)
-#error "Combo keys requires non zero CONFIG_KBD_HELD_EVENT_INTERVAL_MS."
-#endif
+#define KEY_COMBO_BIT_INVALID   0xFF    // Key-to-bit lookup table entry of a key which is not a combo member
 
 NRF_SECTION_DEF(combo_descriptions, key_combo_desc_t);
 NRF_SECTION_DEF(combo_member_keys, key_combo_member_t);
 
-static uint32_t           m_combo_bitmask = 0; // Combo bitmask of currently pressed keys
-static uint8_t            m_triggering_key_id; // Key which triggered combo timing
-static int32_t            m_combo_duration_ms; // Duration of current bitmask in milliseconds
-static key_combo_desc_t * m_active_combo = 0;  // When valid: pointer to combo description struct. Otherwise NULL
+typedef uint64_t key_combo_mask_t;
 
-static uint32_t key_id_to_bit_msk(uint8_t key_id)
+STATIC_ASSERT((sizeof(key_combo_mask_t) * 8) >= KEY_COMBO_MAX_MEMBERS);
+
+#define COMBO_COUNT()   NRF_SECTION_ITEM_COUNT(combo_descriptions, key_combo_desc_t)
+#define COMBO_GET(_i)   NRF_SECTION_ITEM_GET(combo_descriptions, key_combo_desc_t, (_i))
+
+APP_TIMER_DEF(m_combo_timer);
+
+static uint8_t                  m_key_bit[256];                                     // Combo member bit of each key ID
+static key_combo_mask_t         m_combo_masks[CONFIG_KBD_KEY_COMBO_MAX_COUNT];      // Precomputed key masks of chord combos
+static uint8_t                  m_combo_progress[CONFIG_KBD_KEY_COMBO_MAX_COUNT];   // Number of matched keys of sequence combos
+static key_combo_mask_t         m_combo_bitmask;        // Combo bitmask of currently pressed keys
+static uint32_t                 m_combo_timestamp;      // Time at which the active combo was matched
+static uint32_t                 m_press_timestamp;      // Time of the last key press
+static key_combo_desc_t const * m_active_combo;         // When valid: pointer to armed chord description. Otherwise NULL
+
+static key_combo_mask_t key_id_to_bit_msk(uint8_t key_id)
 {
-    for (unsigned int i = 0; i < NRF_SECTION_ITEM_COUNT(combo_member_keys, key_combo_member_t); ++i)
+    uint8_t bit = m_key_bit[key_id];
+
+    return (bit != KEY_COMBO_BIT_INVALID) ? ((key_combo_mask_t)1 << bit) : 0;
+}
+
+static void combo_trigger(key_combo_desc_t const * p_combo)
+{
+    NRF_LOG_DEBUG("Key combo triggered. key_combo_desc_t* = 0x%08x", p_combo);
+
+    p_combo->handler(0);
+}
+
+static void combo_timeout_handler(void * p_context)
+{
+    key_combo_desc_t const * p_combo = p_context;
+    uint32_t                 elapsed;
+
+    // The timeout may have been queued before the combo was invalidated or re-armed.
+    if (p_combo != m_active_combo)
     {
-        if (NRF_SECTION_ITEM_GET(combo_member_keys, key_combo_member_t, i)->key_id == key_id)
-        {
-            return (1ul << i);
-        }
+        return;
     }
 
-    return 0;
+    elapsed = app_timer_cnt_diff_compute(app_timer_cnt_get(), m_combo_timestamp);
+    if (elapsed < APP_TIMER_TICKS(p_combo->combo_duration_ms))
+    {
+        return;
+    }
+
+    // Chord triggers only once until the set of pressed keys changes.
+    m_active_combo = NULL;
+    combo_trigger(p_combo);
+}
+
+static void combo_chord_disarm(void)
+{
+    if (m_active_combo != NULL)
+    {
+        m_active_combo = NULL;
+        APP_ERROR_CHECK(app_timer_stop(m_combo_timer));
+    }
 }
 
-static uint32_t combo_desc_to_bitmask(key_combo_desc_t * combo_desc)
+static void combo_chord_arm(key_combo_desc_t const * p_combo, uint32_t timestamp)
 {
-    uint32_t bitmask = 0;
+    uint32_t ticks = APP_TIMER_TICKS(p_combo->combo_duration_ms);
+
+    NRF_LOG_DEBUG("Valid combo detected. key_combo_desc_t* = 0x%08x", p_combo);
 
-    for (unsigned int i = 0; i < combo_desc->combo_num_keys; ++i)
+    if (ticks == 0)
     {
-        bitmask |= key_id_to_bit_msk(combo_desc->combo_keys[i]);
+        combo_trigger(p_combo);
+        return;
     }
 
-    return bitmask;
+    m_active_combo    = p_combo;
+    m_combo_timestamp = timestamp;
+
+    APP_ERROR_CHECK(app_timer_start(m_combo_timer,
+                                    MAX(ticks, APP_TIMER_MIN_TIMEOUT_TICKS),
+                                    (void *)p_combo));
+}
+
+static void process_combo_sequences(uint8_t key_id, uint32_t timestamp)
+{
+    uint32_t elapsed = app_timer_cnt_diff_compute(timestamp, m_press_timestamp);
+
+    for (unsigned int i = 0; i < COMBO_COUNT(); ++i)
+    {
+        key_combo_desc_t const * p_combo = COMBO_GET(i);
+        uint8_t                  progress = m_combo_progress[i];
+        bool                     in_window;
+
+        if (p_combo->combo_type != KEY_COMBO_TYPE_SEQUENCE)
+        {
+            continue;
+        }
+
+        in_window = (elapsed <= APP_TIMER_TICKS(p_combo->combo_duration_ms));
+
+        if ((progress == 0) || !in_window || (p_combo->combo_keys[progress] != key_id))
+        {
+            // Sequence (re)starts with this key or is broken.
+            progress = (p_combo->combo_keys[0] == key_id) ? 1 : 0;
+        }
+        else
+        {
+            progress += 1;
+        }
+
+        if (progress == p_combo->combo_num_keys)
+        {
+            progress = 0;
+            combo_trigger(p_combo);
+        }
+
+        m_combo_progress[i] = progress;
+    }
 }
 
 static void process_combo_key_change(uint8_t key_id, bool key_press)
 {
-    uint32_t key_bitmask;
+    key_combo_mask_t key_bitmask;
+    uint32_t         timestamp = app_timer_cnt_get();
 
     key_bitmask = key_id_to_bit_msk(key_id);
 
     if (key_bitmask == 0)
     {
-        // Irrelevant key: invalidate combo
-        m_active_combo = NULL;
+        // Irrelevant key: invalidate combos
+        combo_chord_disarm();
+        if (key_press)
+        {
+            memset(m_combo_progress, 0, sizeof(m_combo_progress));
+        }
         return;
     }
 
@@ -119,79 +212,76 @@ static void process_combo_key_change(uint8_t key_id, bool key_press)
 
     NRF_LOG_DEBUG("Combo key id 0x%02X %s", key_id, (key_press ? "pressed" : "released"));
 
+    m_combo_bitmask ^= key_bitmask; // Add or remove key from bitmask
 
     if (key_press)
     {
-        m_combo_bitmask |= key_bitmask; // Add key to bitmask
-    }
-    else
-    {
-        m_combo_bitmask ^= key_bitmask; // Remove key from bitmask
+        process_combo_sequences(key_id, timestamp);
+        m_press_timestamp = timestamp;
     }
+
     // Reset state
-    m_active_combo      = NULL;
-    m_combo_duration_ms = 0;
+    combo_chord_disarm();
 
-    // Find matching combos
-    for (int i = 0; i < NRF_SECTION_ITEM_COUNT(combo_descriptions, key_combo_desc_t); ++i)
+    // Find matching chord
+    for (unsigned int i = 0; i < COMBO_COUNT(); ++i)
     {
-        if (m_combo_bitmask == combo_desc_to_bitmask(NRF_SECTION_ITEM_GET(combo_descriptions, key_combo_desc_t, i)))
+        if ((COMBO_GET(i)->combo_type == KEY_COMBO_TYPE_CHORD) && (m_combo_bitmask == m_combo_masks[i]))
         {
-            m_active_combo      = NRF_SECTION_ITEM_GET(combo_descriptions, key_combo_desc_t, i);
-            // When a key release triggers combo, choose first key in combo as trigger key, since key_id is no longer held
-            m_triggering_key_id = key_press ? key_id : m_active_combo->combo_keys[0];
-            NRF_LOG_DEBUG("Valid combo detected. key_combo_desc_t* = 0x%08x", m_active_combo);
+            combo_chord_arm(COMBO_GET(i), timestamp);
             break;
         }
     }
 }
 
-static void process_combo_key_held(uint8_t key_id)
+ret_code_t key_combo_util_init(void)
 {
-    if (m_active_combo == NULL        ||
-        key_id != m_triggering_key_id ||
-        m_combo_duration_ms == (int32_t) -1)
+    unsigned int member_count = 0;
+
+    if (COMBO_COUNT() > CONFIG_KBD_KEY_COMBO_MAX_COUNT)
     {
-        return;
+        NRF_LOG_ERROR("Too many key combos");
+        return NRF_ERROR_NO_MEM;
     }
 
-    m_combo_duration_ms += CONFIG_KBD_HELD_EVENT_INTERVAL_MS;
+    // Assign a bit to each registered member key
+    memset(m_key_bit, KEY_COMBO_BIT_INVALID, sizeof(m_key_bit));
 
-    if (m_combo_duration_ms >= m_active_combo->combo_duration_ms)
+    for (unsigned int i = 0; i < NRF_SECTION_ITEM_COUNT(combo_member_keys, key_combo_member_t); ++i)
     {
-        NRF_LOG_DEBUG("Key combo triggered. key_combo_desc_t* = 0x%08x", m_active_combo);
+        uint8_t key_id = NRF_SECTION_ITEM_GET(combo_member_keys, key_combo_member_t, i)->key_id;
 
-        m_active_combo->handler(0);
-
-        // Set to -1 to indicate that action has been triggered
-        m_combo_duration_ms = (int32_t) -1;
-    }
-    else
-    {
-        NRF_LOG_DEBUG("Key combo time remaining: %d ms", m_active_combo->combo_duration_ms - m_combo_duration_ms);
-    }
-}
+        if (m_key_bit[key_id] != KEY_COMBO_BIT_INVALID)
+        {
+            continue;
+        }
 
-ret_code_t key_combo_util_init(void)
-{
+        // Verify that total number of keys used in key combos does not exceed allotted data width
+        if (member_count >= KEY_COMBO_MAX_MEMBERS)
+        {
+            NRF_LOG_ERROR("Too many combo keys");
+            return NRF_ERROR_INVALID_DATA;
+        }
 
-    // Verify that total number of keys used in key combos does not exceed allotted data width
-    if (NRF_SECTION_ITEM_COUNT(combo_member_keys, key_combo_member_t) > 32)
-    {
-        NRF_LOG_ERROR("Too many combo keys");
-        return NRF_ERROR_INVALID_DATA;
+        m_key_bit[key_id] = member_count++;
     }
 
-    // Verify that keys are only used once in the same combo,
+    // Verify that keys are only used once in the same chord,
     // and that all keys are registered as combo members
-    for (int i = 0; i < NRF_SECTION_ITEM_COUNT(combo_descriptions, key_combo_desc_t); ++i)
+    for (unsigned int i = 0; i < COMBO_COUNT(); ++i)
     {
-        key_combo_desc_t * combo = NRF_SECTION_ITEM_GET(combo_descriptions, key_combo_desc_t, i);
-        uint32_t combo_bitmask = 0;
+        key_combo_desc_t const * combo = COMBO_GET(i);
+        key_combo_mask_t combo_bitmask = 0;
+
+        if ((combo->combo_num_keys == 0) || (combo->combo_num_keys > KEY_COMBO_MAX_KEYS))
+        {
+            NRF_LOG_ERROR("Invalid number of keys in key combo: %d", combo->combo_num_keys);
+            return NRF_ERROR_INVALID_DATA;
+        }
 
-        for (int j = 0; j < combo->combo_num_keys; ++j)
+        for (unsigned int j = 0; j < combo->combo_num_keys; ++j)
         {
-            uint32_t key_bitmask = key_id_to_bit_msk(combo->combo_keys[j]);
+            key_combo_mask_t key_bitmask = key_id_to_bit_msk(combo->combo_keys[j]);
 
             if (key_bitmask == 0)
             {
@@ -199,16 +289,22 @@ ret_code_t key_combo_util_init(void)
                 return NRF_ERROR_INVALID_DATA;
             }
 
-            if ((key_bitmask & combo_bitmask) != 0)
+            if ((combo->combo_type == KEY_COMBO_TYPE_CHORD) && ((key_bitmask & combo_bitmask) != 0))
             {
                 NRF_LOG_ERROR("Same key used more than once in key combo: 0x%02X", combo->combo_keys[j]);
                 return NRF_ERROR_INVALID_DATA;
             }
             combo_bitmask |= key_bitmask;
         }
+
+        m_combo_masks[i] = combo_bitmask;
     }
 
-    return NRF_SUCCESS;
+    m_combo_bitmask = 0;
+    m_active_combo  = NULL;
+    memset(m_combo_progress, 0, sizeof(m_combo_progress));
+
+    return app_timer_create(&m_combo_timer, APP_TIMER_MODE_SINGLE_SHOT, combo_timeout_handler);
 }
 
 bool key_combo_util_key_process(const event_t * p_event)
@@ -223,10 +319,6 @@ bool key_combo_util_key_process(const event_t * p_event)
             process_combo_key_change(p_event->key.id, false);
             break;
 
-        case EVT_KEY_HELD:
-            process_combo_key_held(p_event->key.id);
-            break;
-
         default:
             break;
     }
@@ -43,6 +43,13 @@
  * @ingroup other
  * @{
  * @brief Functions for detecting hardware-specific key combinations.
+ *
+ * @details Two kinds of key combinations are supported:
+ *          - Chords: a set of keys held together for a given time. The combination
+ *            triggers once when exactly these member keys have been held for the duration.
+ *          - Sequences: keys pressed one after another. The combination triggers
+ *            on the last key press if no other key was pressed in between and each
+ *            press followed the previous one within the given time window.
  */
 #ifndef __KEY_COMBO_UTIL_H__
 #define __KEY_COMBO_UTIL_H__
@@ -52,16 +59,30 @@
 #include "nrf_section.h"
 #include "event_bus.h"
 
+/**@brief Maximum number of keys in a single key combination. */
+#define KEY_COMBO_MAX_KEYS      6
+
+/**@brief Maximum number of keys that can be registered as combo members. */
+#define KEY_COMBO_MAX_MEMBERS   64
+
+/**@brief Key combination types. */
+enum
+{
+    KEY_COMBO_TYPE_CHORD,       /**< Keys held together for a given duration. */
+    KEY_COMBO_TYPE_SEQUENCE,    /**< Keys pressed in order, each within a given window after the previous one. */
+};
+
 /**@brief Definition for key combination triggered callback*/
 typedef void (*key_combo_handler_t)(void * p_context);
 
 /**@brief Key combo description. Used to describe key combinations. */
 typedef struct
 {
-    uint8_t             combo_keys[4];     
-    uint32_t            combo_duration_ms : 30;
-    uint32_t            combo_num_keys : 2;
-    key_combo_handler_t handler;           
+    uint8_t             combo_keys[KEY_COMBO_MAX_KEYS]; /**< Keys in the combination, in press order for sequences. */
+    uint8_t             combo_num_keys;                 /**< Number of keys in the combination. */
+    uint8_t             combo_type;                     /**< Type of the combination. */
+    uint32_t            combo_duration_ms;              /**< Hold duration (chords) or maximum time between presses (sequences). */
+    key_combo_handler_t handler;                        /**< Handler called when the combination is triggered. */
 } key_combo_desc_t;
 
 /**@brief Member key in a key combo. Used to register keys that will be used in one or more key combinations */
@@ -78,7 +99,8 @@ STATIC_ASSERT((sizeof(key_combo_member_t) % sizeof(uint32_t)) == 0);
 /**@brief Macro for registering key to use in subsequent combo definitions 
  * @details Key ID follows format = 0xRowColumn. E.g. 0x14 = key on row 1, column 4.
  *
- * @note Maximum 32 keys can be registered for use in key combos
+ * @note Maximum @ref KEY_COMBO_MAX_MEMBERS keys can be registered for use in key combos.
+ *       Registering the same key more than once is allowed.
  *
  * @param[in] _key_id   ID of key that will be used in one or more key combos. 
  */
@@ -86,19 +108,30 @@ STATIC_ASSERT((sizeof(key_combo_member_t) % sizeof(uint32_t)) == 0);
     NRF_SECTION_ITEM_REGISTER(combo_member_keys, static const key_combo_member_t CONCAT_2(_COMBO_MEMBER, __LINE__)) = \
         {.key_id = _key_id}
 
-/**@brief Macro for registering one-key combo handler. 
- * @param[in] key_id_1    First key ID in key combo
- * @param[in] duration_ms Duration in milliseconds that the combo keys must be pressed to trigger the combo
- * @param[in] evt_handler Event handler to call when combo is triggered
+/**@brief Macro for registering a key combo handler.
+ *
+ * @param[in] type        Key combo type (KEY_COMBO_TYPE_CHORD or KEY_COMBO_TYPE_SEQUENCE).
+ * @param[in] duration_ms Hold duration (chords) or maximum time between key presses (sequences) in milliseconds.
+ * @param[in] evt_handler Event handler to call when combo is triggered.
+ * @param[in] ...         IDs of the keys in the combo (at most @ref KEY_COMBO_MAX_KEYS).
  */
-#define KEY_COMBO_ONE_KEY_REGISTER(key_id_1, duration_ms, evt_handler)                                              \
+#define KEY_COMBO_REGISTER(type, duration_ms, evt_handler, ...)                                                    \
     NRF_SECTION_ITEM_REGISTER(combo_descriptions, static const key_combo_desc_t CONCAT_2(evt_handler, _combo_cb)) = \
         {                                                                                                           \
             .handler           = evt_handler,                                                                       \
-            .combo_keys        = {key_id_1, 0xFF, 0xFF, 0xFF},                                                      \
-            .combo_num_keys    = 1,                                                                                 \
+            .combo_keys        = { __VA_ARGS__ },                                                                   \
+            .combo_num_keys    = NUM_VA_ARGS(__VA_ARGS__),                                                          \
+            .combo_type        = type,                                                                              \
             .combo_duration_ms = duration_ms                                                                        \
         }
+
+/**@brief Macro for registering one-key combo handler. 
+ * @param[in] key_id_1    First key ID in key combo
+ * @param[in] duration_ms Duration in milliseconds that the combo keys must be pressed to trigger the combo
+ * @param[in] evt_handler Event handler to call when combo is triggered
+ */
+#define KEY_COMBO_ONE_KEY_REGISTER(key_id_1, duration_ms, evt_handler)                                              \
+    KEY_COMBO_REGISTER(KEY_COMBO_TYPE_CHORD, duration_ms, evt_handler, key_id_1)
    
 /**@brief Macro for registering two-key combo handler. 
  * @param[in] key_id_1    First key ID in key combo
@@ -107,13 +140,7 @@ STATIC_ASSERT((sizeof(key_combo_member_t) % sizeof(uint32_t)) == 0);
  * @param[in] evt_handler Event handler to call when combo is triggered
  */
 #define KEY_COMBO_TWO_KEY_REGISTER(key_id_1, key_id_2, duration_ms, evt_handler)                                    \
-    NRF_SECTION_ITEM_REGISTER(combo_descriptions, static const key_combo_desc_t CONCAT_2(evt_handler, _combo_cb)) = \
-        {                                                                                                           \
-            .handler           = evt_handler,                                                                       \
-            .combo_keys        = {key_id_1, key_id_2, 0xFF, 0xFF},                                                  \
-            .combo_num_keys    = 2,                                                                                 \
-            .combo_duration_ms = duration_ms                                                                        \
-        }
+    KEY_COMBO_REGISTER(KEY_COMBO_TYPE_CHORD, duration_ms, evt_handler, key_id_1, key_id_2)
 
 /**@brief Macro for registering three-key combo handler. 
  * @param[in] key_id_1    First key ID in key combo
@@ -123,15 +150,20 @@ STATIC_ASSERT((sizeof(key_combo_member_t) % sizeof(uint32_t)) == 0);
  * @param[in] evt_handler Event handler to call when combo is triggered
  */
 #define KEY_COMBO_THREE_KEY_REGISTER(key_id_1, key_id_2, key_id_3, duration_ms, evt_handler)                        \
-    NRF_SECTION_ITEM_REGISTER(combo_descriptions, static const key_combo_desc_t CONCAT_2(evt_handler, _combo_cb)) = \
-        {                                                                                                           \
-            .handler           = evt_handler,                                                                       \
-            .combo_keys        = {key_id_1, key_id_2, key_id_3, 0xFF},                                              \
-            .combo_num_keys    = 3,                                                                                 \
-            .combo_duration_ms = duration_ms                                                                        \
-        }
-        
+    KEY_COMBO_REGISTER(KEY_COMBO_TYPE_CHORD, duration_ms, evt_handler, key_id_1, key_id_2, key_id_3)
+
+/**@brief Macro for registering two-key sequence handler.
+ * @param[in] key_id_1    Key ID pressed first.
+ * @param[in] key_id_2    Key ID pressed second.
+ * @param[in] window_ms   Maximum time in milliseconds between the two key presses.
+ * @param[in] evt_handler Event handler to call when the sequence is detected.
+ */
+#define KEY_COMBO_SEQUENCE_REGISTER(key_id_1, key_id_2, window_ms, evt_handler)                                     \
+    KEY_COMBO_REGISTER(KEY_COMBO_TYPE_SEQUENCE, window_ms, evt_handler, key_id_1, key_id_2)
+
 /**@brief Key combo detection utility initialization
+ *
+ * @details Builds the key lookup table and the key masks of all registered combos.
  *
  * @return NRF_SUCCESS on success, otherwise an error code.
  */
@@ -147,4 +179,3 @@ bool key_combo_util_key_process(const event_t * p_event);
 
 #endif /* __KEY_COMBO_UTIL_H__ */
 /** @} */
-
@@ -53,6 +53,10 @@
 #define CONFIG_AUDIO_CODEC_OPUS                 3
 #define CONFIG_AUDIO_CODEC_SBC                  4
 
+// ANR engines:
+#define CONFIG_AUDIO_ANR_ENGINE_BUILTIN         0
+#define CONFIG_AUDIO_ANR_ENGINE_VOCAL           1
+
 // OPUS modes:
 #define CONFIG_OPUS_MODE_CELT                   (1 << 0)
 #define CONFIG_OPUS_MODE_SILK                   (1 << 1)
@@ -74,6 +74,14 @@
 # error "Unsupported Compression"
 #endif
 
+// Reserve space in front of encoded frames for the part of the ATVV frame header that the codec does not write
+// (sequence number and remote control ID), so that the header can be completed in place.
+#if CONFIG_AUDIO_ATVV_ENABLED
+# define CONFIG_AUDIO_FRAME_HEADROOM        3
+#else
+# define CONFIG_AUDIO_FRAME_HEADROOM        0
+#endif
+
 #if (defined(CONFIG_AUDIO_FRAME_SIZE_SAMPLES) && !defined(CONFIG_AUDIO_FRAME_SIZE_MS))
 # define CONFIG_AUDIO_FRAME_SIZE_MS (1000 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES / CONFIG_AUDIO_SAMPLING_FREQUENCY)
 #elif (defined(CONFIG_AUDIO_FRAME_SIZE_MS) && !defined(CONFIG_AUDIO_FRAME_SIZE_SAMPLES))
@@ -82,29 +90,57 @@
 # error "Either CONFIG_AUDIO_FRAME_SIZE_SAMPLES or CONFIG_AUDIO_FRAME_SIZE_MS has to be defined!"
 #endif
 
+// Select microphone sampling frequency. With sample rate conversion, it is independent of the codec sampling frequency.
+#if CONFIG_AUDIO_SRC_ENABLED
+# define CONFIG_PDM_SAMPLING_FREQUENCY          CONFIG_AUDIO_SRC_PDM_SAMPLING_FREQUENCY
+#else /* !CONFIG_AUDIO_SRC_ENABLED */
+# define CONFIG_PDM_SAMPLING_FREQUENCY          CONFIG_AUDIO_SAMPLING_FREQUENCY
+#endif /* CONFIG_AUDIO_SRC_ENABLED */
+
 // Create PDM configuration basing on audio settings.
-#if (CONFIG_AUDIO_SAMPLING_FREQUENCY == 8000)
+#if (CONFIG_PDM_SAMPLING_FREQUENCY == 8000)
 # define CONFIG_PDM_MCLKFREQ                    0x04100000
-# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   7936
-#elif (CONFIG_AUDIO_SAMPLING_FREQUENCY == 16000)
+# define CONFIG_PDM_REAL_SAMPLING_FREQUENCY     7936
+#elif (CONFIG_PDM_SAMPLING_FREQUENCY == 16000)
 # define CONFIG_PDM_MCLKFREQ                    0x08400000
-# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   16125
-#elif (CONFIG_AUDIO_SAMPLING_FREQUENCY == 24000)
+# define CONFIG_PDM_REAL_SAMPLING_FREQUENCY     16125
+#elif (CONFIG_PDM_SAMPLING_FREQUENCY == 24000)
 # define CONFIG_PDM_MCLKFREQ                    0x0C000000
-# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   23819
-#elif (CONFIG_AUDIO_SAMPLING_FREQUENCY == 32000)
+# define CONFIG_PDM_REAL_SAMPLING_FREQUENCY     23819
+#elif (CONFIG_PDM_SAMPLING_FREQUENCY == 32000)
 # define CONFIG_PDM_MCLKFREQ                    0x10000000
-# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   31250
+# define CONFIG_PDM_REAL_SAMPLING_FREQUENCY     31250
+#else
+# error "Unsuppored CONFIG_PDM_SAMPLING_FREQUENCY value!"
+#endif
+
+// Sampling frequency of audio passed to the codec.
+#if CONFIG_AUDIO_SRC_ENABLED
+# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   CONFIG_AUDIO_SAMPLING_FREQUENCY
+#else /* !CONFIG_AUDIO_SRC_ENABLED */
+# define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY   CONFIG_PDM_REAL_SAMPLING_FREQUENCY
+#endif /* CONFIG_AUDIO_SRC_ENABLED */
+
+// Number of mono samples captured in one block.
+#if ((CONFIG_AUDIO_CAPTURE_BLOCK_SIZE == 0) || (CONFIG_AUDIO_CAPTURE_BLOCK_SIZE > CONFIG_AUDIO_FRAME_SIZE_SAMPLES))
+# define CONFIG_AUDIO_BLOCK_SIZE_SAMPLES        CONFIG_AUDIO_FRAME_SIZE_SAMPLES
 #else
-# error "Unsuppored CONFIG_AUDIO_SAMPLING_FREQUENCY value!"
+# define CONFIG_AUDIO_BLOCK_SIZE_SAMPLES        CONFIG_AUDIO_CAPTURE_BLOCK_SIZE
 #endif
 
+// Number of capture blocks needed to fill an audio frame.
+#define CONFIG_AUDIO_BLOCKS_PER_FRAME           ((CONFIG_AUDIO_FRAME_SIZE_SAMPLES + CONFIG_AUDIO_BLOCK_SIZE_SAMPLES - 1) / \
+                                                 CONFIG_AUDIO_BLOCK_SIZE_SAMPLES)
+
 #if CONFIG_AUDIO_ANR_ENABLED
-# define CONFIG_PDM_BUFFER_SIZE_SAMPLES (2 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+# define CONFIG_PDM_BUFFER_SIZE_SAMPLES (2 * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES)
 #else /* !CONFIG_AUDIO_ANR_ENABLED */
-# define CONFIG_PDM_BUFFER_SIZE_SAMPLES (1 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+# define CONFIG_PDM_BUFFER_SIZE_SAMPLES (1 * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES)
 #endif /* CONFIG_AUDIO_ANR_ENABLED */
 
+// Keep the same duration of audio buffered regardless of the block size.
+#define CONFIG_PDM_BUFFER_POOL_SIZE     (CONFIG_AUDIO_BUFFER_POOL_SIZE * CONFIG_AUDIO_BLOCKS_PER_FRAME)
+
 // Calculate stack size.
 #if CONFIG_AUDIO_ENABLED
 # if (CONFIG_AUDIO_CODEC == CONFIG_AUDIO_CODEC_BV32FP)
@@ -52,6 +52,18 @@
 #define HID_USAGE_ID(_usage)            (((_usage) >>  0) & 0xFFFF)
 #define HID_USAGE_PAGE(_usage)          (((_usage) >> 16) & 0xFFFF)
 
+/*
+ * Units of relative motion events. Pointer motion is expressed in 1/HID_REL_POINTER_SCALE
+ * of a report count and wheel/pan motion in 1/HID_REL_WHEEL_SCALE of a detent.
+ */
+#if CONFIG_HID_HIGH_RES_ENABLED
+#define HID_REL_POINTER_SCALE           (1 << CONFIG_HID_POINTER_FRACTION_BITS)
+#define HID_REL_WHEEL_SCALE             CONFIG_HID_WHEEL_RES_MULTIPLIER
+#else
+#define HID_REL_POINTER_SCALE           1
+#define HID_REL_WHEEL_SCALE             1
+#endif
+
 #if defined(CONFIG_BOARD_NRF52832_PCA20023) || \
     defined(CONFIG_BOARD_NRF52832_PCA63519) || \
     defined(CONFIG_BOARD_NRF52810_PCA20031)
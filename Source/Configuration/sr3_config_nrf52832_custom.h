@@ -166,6 +166,40 @@
 // <o> Distance between noise and voice microphones [samples] <1-256>
 /**@brief Distance between noise and voice microphones [samples] <1-256> */
 #define CONFIG_AUDIO_ANR_DELAY_LENGTH 1
+
+// <o> Noise reduction engine
+// <i> Built-in - fixed-point NLMS adaptive filter followed by spectral noise suppression (Source/Libraries/dmnr.c).
+// <i> VOCAL - prebuilt VOCAL Technologies ANR library.
+//  <0=>Built-in
+//  <1=>VOCAL
+/**@brief Noise reduction engine */
+#define CONFIG_AUDIO_ANR_ENGINE 0
+
+// <o> Adaptive filter step size [1/1024] <1-1024>
+// <i> NLMS step size of the built-in engine. Larger values track changing noise faster at the cost of more residual noise.
+#if (CONFIG_AUDIO_ANR_ENGINE == CONFIG_AUDIO_ANR_ENGINE_BUILTIN)
+/**@brief Adaptive filter step size [1/1024] <1-1024> */
+#define CONFIG_AUDIO_ANR_STEP_SIZE 10
+#endif
+
+// <o> Spectral gain floor [%] <1-100>
+// <i> Minimum gain applied by the spectral suppression stage of the built-in engine. 100 disables spectral suppression.
+#if (CONFIG_AUDIO_ANR_ENGINE == CONFIG_AUDIO_ANR_ENGINE_BUILTIN)
+/**@brief Spectral gain floor [%] <1-100> */
+#define CONFIG_AUDIO_ANR_GAIN_FLOOR 18
+#endif
+// </e>
+
+// <e> Enable Noise Suppression
+// <i> Single-microphone spectral noise suppression. The noise floor of every band is tracked with minimum statistics and a Wiener gain is applied.
+// <i> Intended for builds without ANR, where it is the only noise reduction in the audio chain.
+/**@brief Enable Noise Suppression */
+#define CONFIG_AUDIO_NS_ENABLED 0
+
+// <o> Gain floor [%] <1-100>
+// <i> Minimum gain applied to bands that contain only noise. Lower values remove more noise at the cost of more audible artifacts.
+/**@brief Gain floor [%] <1-100> */
+#define CONFIG_AUDIO_NS_GAIN_FLOOR 18
 // </e>
 
 // <q> Enable Equalizer
@@ -178,6 +212,23 @@
 /**@brief Enable Gain Control */
 #define CONFIG_AUDIO_GAIN_CONTROL_ENABLED 0
 
+// <e> Enable Sample Rate Conversion
+// <i> Capture audio at the PDM sampling frequency and convert it to exactly the codec sampling frequency with a fixed-point polyphase resampler.
+// <i> Allows the codec sampling frequency to be changed at runtime when the codec supports it (ADPCM), for example on Android TV Voice request.
+// <i> Costs about 200 CPU cycles per output sample when upsampling and about 400 when halving the sampling frequency.
+/**@brief Enable Sample Rate Conversion */
+#define CONFIG_AUDIO_SRC_ENABLED 0
+
+// <o> PDM Sampling Frequency
+// <i> Nominal sampling frequency of the microphone. The real frequency is given in parentheses.
+//  <8000=>8 kHz (7936 Hz)
+//  <16000=>16 kHz (16125 Hz)
+//  <24000=>24 kHz (23819 Hz)
+//  <32000=>32 kHz (31250 Hz)
+/**@brief PDM Sampling Frequency */
+#define CONFIG_AUDIO_SRC_PDM_SAMPLING_FREQUENCY 16000
+// </e>
+
 // <o> Sampling Frequency
 // <i> Select audio sampling frequency.
 // <i> Note that not all combinations of sampling frequency and codec are supported.
@@ -197,6 +248,21 @@
 /**@brief ADPCM Options: Audio Frame Size */
 #define CONFIG_AUDIO_FRAME_SIZE_SAMPLES 256
 #endif /* CONFIG_AUDIO_CODEC == CONFIG_AUDIO_CODEC_ADPCM */
+
+// <o> Encoder lookahead <0-3>
+// <i> Number of following samples taken into account when the encoder chooses each code.
+// <i> 0 selects the table-driven encoder, which is byte-identical to the reference one.
+// <i> Higher values improve quality at the cost of CPU time. The stream stays decodable by any IMA/DVI ADPCM decoder.
+/**@brief ADPCM Options: Encoder lookahead <0-3> */
+#define CONFIG_ADPCM_LOOKAHEAD_DEPTH 0
+// </h>
+
+// <h> BV32FP Options
+// <q> Fixed-Point Encoder
+// <i> Use the integer-only port of the BV32 encoder instead of the floating-point reference implementation. Required on devices without FPU (nRF52810).
+// <i> Both encoders produce the same bit stream format.
+/**@brief BV32FP Options: Fixed-Point Encoder */
+#define CONFIG_BV32FP_FIXED_POINT_ENABLED 0
 // </h>
 
 // <h> Opus Options
@@ -452,6 +518,12 @@
 /**@brief Audio HID Service enabled */
 #define CONFIG_AUDIO_HID_ENABLED 0
 
+// <q> Audio HID Frame Packing
+// <i> Pack several encoded audio frames into one HID report. Each chunk of a frame is preceded by a one-byte length header.
+// <i> Reduces per-packet overhead when the ATT MTU is large. Requires a host that understands the packed format.
+/**@brief Audio HID Frame Packing */
+#define CONFIG_AUDIO_HID_PACKING_ENABLED 0
+
 // <e> Audio ATVV Service enabled
 // <i> ATVV Service for audio enabled and available for audio transmission.
 /**@brief Audio ATVV Service enabled */
@@ -474,11 +546,17 @@
 // </e>
 // </h>
 
-// <q> Enable Audio Processing Gauges
+// <e> Enable Audio Processing Gauges
 // <i> An Audio Processing Gauge is a statistical report of bit rate and CPU usage during a given audio transmission.
 /**@brief Enable Audio Processing Gauges */
 #define CONFIG_AUDIO_GAUGES_ENABLED (1 && NRF_LOG_ENABLED && CONFIG_AUDIO_ENABLED)
 
+// <q> Enable CPU Usage Histograms
+// <i> Collect a histogram of processing time of each audio processing stage, measured in CPU cycles. Allows to query percentiles of processing time. Takes 128 bytes of RAM per stage.
+/**@brief Enable CPU Usage Histograms */
+#define CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED 1
+// </e>
+
 // <h> Logging Options
 // <i> This section configures module-specific logging options.
 
@@ -518,6 +596,24 @@
 /**@brief ANR driver logging level */
 #define CONFIG_AUDIO_DRV_ANR_LOG_LEVEL 0
 
+// <o> Noise suppression driver logging level
+//  <0=> None
+//  <1=> Error
+//  <2=> Warning
+//  <3=> Info
+//  <4=> Debug
+/**@brief Noise suppression driver logging level */
+#define CONFIG_AUDIO_DRV_NS_LOG_LEVEL 0
+
+// <o> Sample rate conversion driver logging level
+//  <0=> None
+//  <1=> Error
+//  <2=> Warning
+//  <3=> Info
+//  <4=> Debug
+/**@brief Sample rate conversion driver logging level */
+#define CONFIG_AUDIO_DRV_SRC_LOG_LEVEL 0
+
 // <o> PDM driver logging level
 //  <0=> None
 //  <1=> Error
@@ -555,6 +651,40 @@
 /**@brief Battery Level Notification Threshold [percentage point] <0-100> */
 #define CONFIG_BATT_NOTIFICATION_THRESHOLD 1
 
+// <h> Battery State Estimation
+// <i> The battery state is estimated from the measured voltage and the charge drawn by the active loads.
+
+// <o> Battery Capacity [mAh] <1-10000>
+// <i> Configure the nominal capacity of the battery.
+/**@brief Battery Capacity [mAh] <1-10000> */
+#define CONFIG_BATT_MEAS_CAPACITY 1000
+
+// <o> Battery Internal Resistance [mOhm] <0-10000>
+// <i> Configure the internal resistance used to compensate the voltage drop caused by the active loads.
+/**@brief Battery Internal Resistance [mOhm] <0-10000> */
+#define CONFIG_BATT_MEAS_INTERNAL_RESISTANCE 600
+
+// <o> Idle Current [uA] <0-65535>
+// <i> Configure the average current drawn when none of the loads below is active.
+/**@brief Idle Current [uA] <0-65535> */
+#define CONFIG_BATT_MEAS_IDLE_CURRENT 50
+
+// <o> Audio Current [uA] <0-65535>
+// <i> Configure the additional current drawn while the microphone is enabled.
+/**@brief Audio Current [uA] <0-65535> */
+#define CONFIG_BATT_MEAS_AUDIO_CURRENT 2500
+
+// <o> Gyroscope Current [uA] <0-65535>
+// <i> Configure the additional current drawn while the gyroscope is powered up.
+/**@brief Gyroscope Current [uA] <0-65535> */
+#define CONFIG_BATT_MEAS_GYRO_CURRENT 3700
+
+// <o> LED Current [uA] <0-65535>
+// <i> Configure the additional current drawn while any of the LEDs is lit.
+/**@brief LED Current [uA] <0-65535> */
+#define CONFIG_BATT_MEAS_LED_CURRENT 2000
+// </h>
+
 // <h> Logging Options
 // <i> This section configures module-specific logging options.
 
@@ -642,6 +772,29 @@
 /**@brief Gyroscope Y Gain <1-255> */
 #define CONFIG_GYRO_Y_GAIN 8
 
+// <e> Motion-Gated Gyroscope Power
+// <i> Power the gyroscope down while the accelerometer reports the device stationary and wake it up on the first motion.
+// <i> Requires the LIS3DH accelerometer.
+/**@brief Gyroscope: Motion-Gated Gyroscope Power */
+#define CONFIG_GYRO_MOTION_GATING_ENABLED (0 && CONFIG_GYRO_ENABLED && CONFIG_ACC_ENABLED)
+
+// <o> Stationary Variance Threshold [mg^2] <1-65535>
+// <i> Sum of the per-axis acceleration variances below which the device is considered stationary.
+/**@brief Gyroscope: Stationary Variance Threshold [mg^2] <1-65535> */
+#define CONFIG_GYRO_STATIONARY_VARIANCE 150
+
+// <o> Stationary Time [ms] <200-5000>
+// <i> Set the time the device has to stay stationary before the gyroscope is powered down.
+/**@brief Gyroscope: Stationary Time [ms] <200-5000> */
+#define CONFIG_GYRO_STATIONARY_TIME 600
+
+// <o> Motion Wake-up Threshold <1-127>
+// <i> Set the minimal acceleration (in 16 mg steps) that wakes the gyroscope up.
+// <i> Should be lower than the system wakeup threshold, so that the gyroscope is ready before the cursor starts moving.
+/**@brief Gyroscope: Motion Wake-up Threshold <1-127> */
+#define CONFIG_GYRO_MOTION_WAKE_THRESHOLD 3
+// </e>
+
 // <h> Special Key Mapping
 // <i> Define the mapping of special keys.
 
@@ -753,6 +906,25 @@
 /**@brief Keyboard Polling Interval [ms] <1-100> */
 #define CONFIG_KBD_POLL_INTERVAL 15
 
+// <e> Use SX1509 Keypad Engine
+// <i> Let the SX1509 keypad engine scan the matrix and read the key data only when the expander asserts its NINT line.
+// <i> The full matrix is polled only while several keys are held. Relevant only if the SX1509 keyboard driver is selected.
+/**@brief Keyboard: Use SX1509 Keypad Engine */
+#define CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED 0
+
+// <o> Row Scan Time
+// <i> Time spent by the keypad engine on each row. Key debouncing takes half of this time.
+//  <0=>1 ms <1=>2 ms <2=>4 ms <3=>8 ms <4=>16 ms <5=>32 ms <6=>64 ms <7=>128 ms
+/**@brief Keyboard: SX1509 Keypad Engine Row Scan Time */
+#define CONFIG_KBD_SX1509_SCAN_TIME 2
+
+// <o> Auto Sleep Time
+// <i> Time without key activity after which the keypad engine enters its low-power mode.
+//  <0=>Off <1=>128 ms <2=>256 ms <3=>512 ms <4=>1 s <5=>2 s <6=>4 s <7=>8 s
+/**@brief Keyboard: SX1509 Keypad Engine Auto Sleep Time */
+#define CONFIG_KBD_SX1509_AUTO_SLEEP 4
+// </e>
+
 // <o> Key held event generation interval [ms] <0-10000>
 // <i> Configure the key held event rate (0 => Disable key held event generation).
 /**@brief Keyboard: Key held event generation interval [ms] <0-10000> */
@@ -763,6 +935,11 @@
 /**@brief Keyboard: Enable detection of key combinations */
 #define CONFIG_KBD_KEY_COMBO_ENABLED (1 && CONFIG_KBD_ENABLED)
 
+// <o> Maximum number of key combinations <1-32>
+// <i> Number of registered key combinations for which the key masks are precomputed at initialization.
+/**@brief Keyboard: Maximum number of key combinations <1-32> */
+#define CONFIG_KBD_KEY_COMBO_MAX_COUNT 8
+
 // <h> Special Key Mapping
 // <i> Define the mapping of special keys.
 
@@ -1602,6 +1779,18 @@
 #define CONFIG_ADV_INTERVAL_MS 20
 #define CONFIG_ADV_INTERVAL ROUNDED_DIV(1000u * CONFIG_ADV_INTERVAL_MS, 625)
 
+// <e> Adaptive Reconnection
+// <i> Learn which host the remote reconnects to most often and which advertising method works best with each host.
+// <i> Reconnection attempts are ordered to minimize the expected time to connect.
+/**@brief Adaptive Reconnection */
+#define CONFIG_ADV_RECONN_ENABLED 0
+
+// <o> Fallback Method Threshold [%] <0-100>
+// <i> When the preferred advertising method succeeds less often than this with a host, the other method is tried as well.
+/**@brief Fallback Method Threshold [%] <0-100> */
+#define CONFIG_ADV_RECONN_FALLBACK_LEVEL 50
+// </e>
+
 // <e> Manufacturer data payload
 // <i> This option adds manufacturer-specific data to the advertisement payload.
 /**@brief Manufacturer data payload */
@@ -1659,6 +1848,82 @@
 // <i> Set the number of attempts before giving up the Connection Parameter negotiation.
 /**@brief Maximum Attempts of Connection Parameter Negotiation <1-16>. */
 #define CONFIG_MAX_CONN_PARAMS_UPDATE_COUNT 3
+
+// <e> Traffic-Dependent Connection Parameters
+// <i> When enabled, the remote requests connection parameters that match the type of traffic that is currently sent.
+// <i> The parameters configured above are used when only keys are in use. The most demanding active traffic type selects the parameters.
+/**@brief Enable Traffic-Dependent Connection Parameters */
+#define CONFIG_CONN_POLICY_ENABLED 1
+
+// <o> Parameter Downgrade Delay [ms] <0-60000>
+// <i> Set the time for which the remote keeps the current parameters after the most demanding traffic type has ended.
+// <i> Upgrades are requested immediately.
+/**@brief Parameter Downgrade Delay [ms] <0-60000> */
+#define CONFIG_CONN_POLICY_DOWNGRADE_DELAY_MS 2000
+
+// <h> Air Mouse Traffic
+
+// <o> Minimum Connection Interval [ms] <7-4000>
+/**@brief Air Mouse Minimum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL_MS, 125)
+
+// <o> Maximum Connection Interval [ms] <7-4000>
+/**@brief Air Mouse Maximum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL_MS, 125)
+
+// <o> Slave Latency [number of connection events] <0-1000>
+/**@brief Air Mouse Slave Latency [number of connection events] <0-1000> */
+#define CONFIG_CONN_POLICY_AIR_MOUSE_SLAVE_LATENCY 9
+
+// <q> Request 2 Mbps PHY
+/**@brief Air Mouse Request 2 Mbps PHY */
+#define CONFIG_CONN_POLICY_AIR_MOUSE_PHY_2MBPS 0
+// </h>
+
+// <h> HID Voice Traffic
+
+// <o> Minimum Connection Interval [ms] <7-4000>
+/**@brief HID Voice Minimum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL_MS, 125)
+
+// <o> Maximum Connection Interval [ms] <7-4000>
+/**@brief HID Voice Maximum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL_MS, 125)
+
+// <o> Slave Latency [number of connection events] <0-1000>
+/**@brief HID Voice Slave Latency [number of connection events] <0-1000> */
+#define CONFIG_CONN_POLICY_HID_VOICE_SLAVE_LATENCY 4
+
+// <q> Request 2 Mbps PHY
+/**@brief HID Voice Request 2 Mbps PHY */
+#define CONFIG_CONN_POLICY_HID_VOICE_PHY_2MBPS 1
+// </h>
+
+// <h> ATVV Voice Traffic
+
+// <o> Minimum Connection Interval [ms] <7-4000>
+/**@brief ATVV Voice Minimum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL_MS, 125)
+
+// <o> Maximum Connection Interval [ms] <7-4000>
+/**@brief ATVV Voice Maximum Connection Interval [ms] <7-4000> */
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL_MS 7
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL_MS, 125)
+
+// <o> Slave Latency [number of connection events] <0-1000>
+/**@brief ATVV Voice Slave Latency [number of connection events] <0-1000> */
+#define CONFIG_CONN_POLICY_ATVV_VOICE_SLAVE_LATENCY 4
+
+// <q> Request 2 Mbps PHY
+/**@brief ATVV Voice Request 2 Mbps PHY */
+#define CONFIG_CONN_POLICY_ATVV_VOICE_PHY_2MBPS 1
+// </h>
+// </e>
 // </h>
 
 // <h> GATT Options
@@ -1832,6 +2097,15 @@
 /**@brief Address management submodule logging level */
 #define CONFIG_BLE_ADDR_LOG_LEVEL 4
 
+// <o> Reconnection strategy submodule logging level
+//  <0=> None
+//  <1=> Error
+//  <2=> Warning
+//  <3=> Info
+//  <4=> Debug
+/**@brief Reconnection strategy submodule logging level */
+#define CONFIG_BLE_RECONN_LOG_LEVEL 4
+
 // <o> HID submodule logging level
 //  <0=> None
 //  <1=> Error
@@ -1867,6 +2141,15 @@
 //  <4=> Debug
 /**@brief LESC submodule logging level */
 #define CONFIG_BLE_LESC_LOG_LEVEL 4
+
+// <o> Connection policy submodule logging level
+//  <0=> None
+//  <1=> Error
+//  <2=> Warning
+//  <3=> Info
+//  <4=> Debug
+/**@brief Connection policy submodule logging level */
+#define CONFIG_BLE_CONN_POLICY_LOG_LEVEL 4
 // </h>
 
 // <o> Radio TX Power
@@ -2095,6 +2378,20 @@
 #define CONFIG_IO_KEY_ROW_7 0xFFFFFFFF
 // </h>
 
+// <h> SX1509 Keyboard
+// <i> Configure the lines of the SX1509-based keyboard.
+
+// <o> NINT Pin
+// <i> SX1509 interrupt line. Used only if the SX1509 keypad engine is enabled. The line must be pulled up.
+//  <0=>P0.0   <1=>P0.1   <2=>P0.2   <3=>P0.3   <4=>P0.4   <5=>P0.5   <6=>P0.6   <7=>P0.7
+//  <8=>P0.8   <9=>P0.9   <10=>P0.10 <11=>P0.11 <12=>P0.12 <13=>P0.13 <14=>P0.14 <15=>P0.15
+//  <16=>P0.16 <17=>P0.17 <18=>P0.18 <19=>P0.19 <20=>P0.20 <21=>P0.21 <22=>P0.22 <23=>P0.23
+//  <24=>P0.24 <25=>P0.25 <26=>P0.26 <27=>P0.27 <28=>P0.28 <29=>P0.29 <30=>P0.30 <31=>P0.31
+//  <0xFFFFFFFF=>Disable
+/**@brief SX1509 Keyboard: NINT Pin */
+#define CONFIG_IO_KBD_SX1509_NINT 0xFFFFFFFF
+// </h>
+
 // <h> LEDs
 // <i> Configure the LED output.
 
@@ -2360,9 +2657,17 @@
 
 // <o> Audio Buffer Pool Size <3-16>
 // <i> More audio buffers provide better robustness of audio processing but require more memory resources.
+// <i> The pool holds this many audio frames worth of capture blocks.
 /**@brief Audio Buffer Pool Size <3-16> */
 #define CONFIG_AUDIO_BUFFER_POOL_SIZE 4
 
+// <o> Audio Capture Block Size <0-512>
+// <i> Number of samples captured by the microphone before they are passed to audio processing.
+// <i> Blocks smaller than the audio frame let ANR, noise suppression and equalization run while a frame is being captured, so only encoding is left when the frame is complete. This reduces the latency between the microphone and the radio at the cost of more frequent processing.
+// <i> 0 captures whole audio frames. Values larger than the audio frame size are limited to it.
+/**@brief Audio Capture Block Size <0-512> */
+#define CONFIG_AUDIO_CAPTURE_BLOCK_SIZE 0
+
 // <o> Audio Frame Pool Size <3-16>
 // <i> More audio frames provide better robustness of audio transmission but require more memory resources.
 /**@brief Audio Frame Pool Size <3-16> */
@@ -2403,6 +2708,27 @@
 /**@brief HID Report Pool Size <2-16> */
 #define CONFIG_HID_REPORT_POOL_SIZE 8
 
+// <q> HID Report Coalescing
+// <i> Merge key state changes into a queued HID report which has not been sent yet, as long as no press or release is hidden from the host. When the queue is full, the latest state is kept instead of dropping the oldest report.
+/**@brief HID Report Coalescing */
+#define CONFIG_HID_REPORT_COALESCING_ENABLED 0
+
+// <e> High-Resolution Mouse Reports
+// <i> Send 16-bit pointer, wheel and pan motion and expose a HID Resolution Multiplier for the wheel and the pan. Relative motion is accumulated with sub-unit precision, so slow movements are not lost.
+/**@brief Enable High-Resolution Mouse Reports */
+#define CONFIG_HID_HIGH_RES_ENABLED 0
+
+// <o> Pointer Fraction Bits <0-4>
+// <i> Number of fractional bits used to accumulate pointer motion.
+/**@brief Pointer Fraction Bits <0-4> */
+#define CONFIG_HID_POINTER_FRACTION_BITS 4
+
+// <o> Wheel Resolution Multiplier <2-16>
+// <i> Number of wheel and pan steps per detent reported when the host enables the Resolution Multiplier.
+/**@brief Wheel Resolution Multiplier <2-16> */
+#define CONFIG_HID_WHEEL_RES_MULTIPLIER 8
+// </e>
+
 // <o> HID Report Expiration [ms] <100-10000>
 // <i> Define the time after which a HID report expires and is not sent again.
 /**@brief HID Report Expiration [ms] <100-10000> */
@@ -2441,7 +2767,7 @@
 
 // <o> Max number of ATVV peers <1-8>
 // <i> Determines how many peers can interact with the ATVV Service.
-// <i> Note that only one of these can stream audio at a time.
+// <i> Peers that open the microphone stream the same audio frames concurrently.
 /**@brief ATVV Configuration: Max number of ATVV peers <1-8> */
 #define CONFIG_AUDIO_ATVV_PEER_NUM 1
 
@@ -2508,14 +2834,26 @@
 #define CONFIG_STACK_SIZE_AUDIO_BV32FP 6144
 
 // <o> OPUS/CELT Codec Stack Size [bytes] <0-65536:8>
-// <i> Additional stack space reserved if the OPUC/CELT codec is used.
+// <i> Additional stack space reserved if the OPUS/CELT codec is used. Temporary codec buffers are placed in the scratch arena.
 /**@brief OPUS/CELT Codec Stack Size [bytes] <0-65536:8> */
-#define CONFIG_STACK_SIZE_AUDIO_OPUS_CELT 19456
+#define CONFIG_STACK_SIZE_AUDIO_OPUS_CELT 5632
 
 // <o> OPUS/SILK Codec Stack Size [bytes] <0-65536:8>
-// <i> Additional stack space reserved if the OPUC/SILK codec is used.
+// <i> Additional stack space reserved if the OPUS/SILK codec is used. Temporary codec buffers are placed in the scratch arena.
 /**@brief OPUS/SILK Codec Stack Size [bytes] <0-65536:8> */
-#define CONFIG_STACK_SIZE_AUDIO_OPUS_SILK 25344
+#define CONFIG_STACK_SIZE_AUDIO_OPUS_SILK 16896
+
+// <o> OPUS/CELT Codec Scratch Size [bytes] <0-65536:8>
+// <i> Static arena used by the OPUS/CELT codec for temporary buffers instead of the stack.
+// <i> The arena must fit the largest frame size and complexity in use. Usage is reported by the Stack Usage Profiler.
+/**@brief OPUS/CELT Codec Scratch Size [bytes] <0-65536:8> */
+#define CONFIG_OPUS_SCRATCH_SIZE_CELT 18752
+
+// <o> OPUS/SILK Codec Scratch Size [bytes] <0-65536:8>
+// <i> Static arena used by the OPUS/SILK codec for temporary buffers instead of the stack.
+// <i> The arena must fit the largest frame size and complexity in use. Usage is reported by the Stack Usage Profiler.
+/**@brief OPUS/SILK Codec Scratch Size [bytes] <0-65536:8> */
+#define CONFIG_OPUS_SCRATCH_SIZE_SILK 16384
 
 // <o> Task Manager Stack Size for each task [bytes] <0-65536:8>
 // <i> Stack space reserved by the task manager for each task.
@@ -2699,6 +3037,17 @@
 // <i> Index of the first RTT channel occupied by audio.
 /**@brief Audio Probe: First audio channel index <2-63> */
 #define CONFIG_AUDIO_PROBE_RTT_CHANNEL_FIRST 2
+
+// <e> Multiplexed tap stream
+// <i> Send tapped audio as framed packets carrying probe point, sequence number and drop counter, so that several tap points can be captured through one RTT channel at once.
+/**@brief Audio Probe: Multiplexed tap stream */
+#define CONFIG_AUDIO_PROBE_STREAM_ENABLED 0
+
+// <q> Lossless compression
+// <i> Code tapped samples as Rice-coded differences. Frames which would not get smaller are sent as raw PCM.
+/**@brief Audio Probe: Lossless compression */
+#define CONFIG_AUDIO_PROBE_STREAM_COMPRESSION_ENABLED 1
+// </e>
 // </e>
 
 // <q> Enable Stack Usage Profiler
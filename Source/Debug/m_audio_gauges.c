@@ -42,66 +42,226 @@
 #include <string.h>
 
 #include "nrf_assert.h"
-#include "app_timer.h"
+#include "app_util.h"
 
 #include "m_audio_gauges.h"
 
 #if CONFIG_AUDIO_GAUGES_ENABLED
 
+#if !defined(__CORTEX_M)
+#include <time.h>
+#endif
+
 #define NRF_LOG_MODULE_NAME m_audio_gauges
 #define NRF_LOG_LEVEL CONFIG_AUDIO_MODULE_LOG_LEVEL
 #include "nrf_log.h"
 NRF_LOG_MODULE_REGISTER();
 
-#define FRAME_LENGTH_IN_TICKS   \
-        (CONFIG_AUDIO_FRAME_SIZE_SAMPLES * (APP_TIMER_CLOCK_FREQ / (APP_TIMER_PRESCALER + 1)) \
-        / CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY)
+#if defined(__CORTEX_M)
+/* On the target, processing time is measured in CPU cycles using the DWT cycle counter. */
+static void m_audio_cpu_gauge_clock_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static __INLINE uint32_t m_audio_cpu_gauge_clock_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t m_audio_cpu_gauge_clock_frequency(void)
+{
+    return SystemCoreClock;
+}
+
+#define CLZ(x)  __CLZ(x)
+#else /* !defined(__CORTEX_M) */
+/* On a host build, processing time is measured in nanoseconds using the monotonic clock. */
+static void m_audio_cpu_gauge_clock_init(void)
+{
+}
+
+static __INLINE uint32_t m_audio_cpu_gauge_clock_get(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+uint32_t m_audio_cpu_gauge_clock_frequency(void)
+{
+    return 1000000000ul;
+}
+
+#define CLZ(x)  __builtin_clz(x)
+#endif /* defined(__CORTEX_M) */
 
-void m_audio_cpu_gauge_reset(m_audio_cpu_gauge_t *p_gauge)
+#if CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+/* Histogram bin 0 counts times below 2^M_AUDIO_CPU_HISTOGRAM_MIN_LOG2. Each following octave is split into 2^M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2 bins. */
+#define HISTOGRAM_STEPS     (1u << M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2)
+
+static unsigned int m_audio_cpu_gauge_bin(uint32_t time)
 {
+    unsigned int octave;
+    unsigned int bin;
+
+    if (time < (1ul << M_AUDIO_CPU_HISTOGRAM_MIN_LOG2))
+    {
+        return 0;
+    }
+
+    octave = 31 - CLZ(time);
+    bin    = 1 + ((octave - M_AUDIO_CPU_HISTOGRAM_MIN_LOG2) << M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2) +
+             ((time >> (octave - M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2)) & (HISTOGRAM_STEPS - 1));
+
+    return (bin < M_AUDIO_CPU_HISTOGRAM_BINS) ? bin : (M_AUDIO_CPU_HISTOGRAM_BINS - 1);
+}
+
+void m_audio_cpu_gauge_bin_range(unsigned int bin, uint32_t *p_lower, uint32_t *p_upper)
+{
+    unsigned int octave;
+    unsigned int step;
+
+    ASSERT(bin < M_AUDIO_CPU_HISTOGRAM_BINS);
+    ASSERT((p_lower != NULL) && (p_upper != NULL));
+
+    if (bin == 0)
+    {
+        *p_lower = 0;
+        *p_upper = 1ul << M_AUDIO_CPU_HISTOGRAM_MIN_LOG2;
+        return;
+    }
+
+    octave   = M_AUDIO_CPU_HISTOGRAM_MIN_LOG2 + ((bin - 1) >> M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2);
+    step     = (bin - 1) & (HISTOGRAM_STEPS - 1);
+    *p_lower = (HISTOGRAM_STEPS + step) << (octave - M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2);
+    *p_upper = (bin < (M_AUDIO_CPU_HISTOGRAM_BINS - 1)) ?
+               ((HISTOGRAM_STEPS + step + 1) << (octave - M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2)) : UINT32_MAX;
+}
+
+uint32_t m_audio_cpu_gauge_percentile(const m_audio_cpu_gauge_t *p_gauge, unsigned int percentile)
+{
+    uint32_t count = 0;
+    uint32_t total = 0;
+    uint32_t threshold;
+    uint32_t lower, upper;
+    unsigned int bin;
+
     ASSERT(p_gauge != NULL);
+    ASSERT(percentile <= 100);
+
+    for (bin = 0; bin < M_AUDIO_CPU_HISTOGRAM_BINS; bin++)
+    {
+        total += p_gauge->histogram[bin];
+    }
+
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // Index (counting from 1) of the measurement which is the requested percentile.
+    threshold = CEIL_DIV((uint64_t)total * percentile, 100);
+    if (threshold == 0)
+    {
+        return p_gauge->min_time;
+    }
+
+    for (bin = 0; bin < (M_AUDIO_CPU_HISTOGRAM_BINS - 1); bin++)
+    {
+        count += p_gauge->histogram[bin];
+        if (count >= threshold)
+        {
+            break;
+        }
+    }
+
+    m_audio_cpu_gauge_bin_range(bin, &lower, &upper);
+
+    return (upper - 1 < p_gauge->max_time) ? (upper - 1) : p_gauge->max_time;
+}
+#endif /* CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED */
+
+void m_audio_cpu_gauge_reset(m_audio_cpu_gauge_t *p_gauge, uint32_t samples, uint32_t sampling_frequency)
+{
+    ASSERT(p_gauge != NULL);
+    ASSERT(sampling_frequency != 0);
+
+    m_audio_cpu_gauge_clock_init();
 
     memset(p_gauge, 0, sizeof(*p_gauge));
-    p_gauge->min_cpu_usage = ~0;
+    p_gauge->frame_time = (uint64_t)samples * m_audio_cpu_gauge_clock_frequency() / sampling_frequency;
+    p_gauge->min_time   = UINT32_MAX;
 }
 
 void m_audio_cpu_gauge_log(const m_audio_cpu_gauge_t *p_gauge, const char *p_prefix)
 {
     ASSERT(p_gauge != NULL);
 
+#if CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+    NRF_LOG_INFO("%s CPU usage (min/avg/p99/max): %u%%/%u%%/%u%%/%u%%, overruns: %u",
+                 p_prefix,
+                 m_audio_gauge_get_min_cpu_usage(p_gauge),
+                 m_audio_gauge_get_avg_cpu_usage(p_gauge),
+                 m_audio_gauge_time_to_cpu_usage(p_gauge, m_audio_cpu_gauge_percentile(p_gauge, 99)),
+                 m_audio_gauge_get_max_cpu_usage(p_gauge),
+                 m_audio_gauge_get_overrun_count(p_gauge));
+#else
     NRF_LOG_INFO("%s CPU usage (min/avg/max): %u%%/%u%%/%u%%",
                  p_prefix,
                  m_audio_gauge_get_min_cpu_usage(p_gauge),
                  m_audio_gauge_get_avg_cpu_usage(p_gauge),
                  m_audio_gauge_get_max_cpu_usage(p_gauge));
+#endif
 }
 
 void m_audio_measure_cpu_usage_start(m_audio_cpu_gauge_t *p_gauge)
 {
     ASSERT(p_gauge != NULL);
 
-    p_gauge->timestamp = app_timer_cnt_get();
+    p_gauge->timestamp = m_audio_cpu_gauge_clock_get();
 }
 
 void m_audio_measure_cpu_usage_end(m_audio_cpu_gauge_t *p_gauge)
 {
     uint32_t delta;
 
-    delta = app_timer_cnt_diff_compute(app_timer_cnt_get(), p_gauge->timestamp);
+    // Unsigned arithmetic handles the clock wrap-around.
+    delta = m_audio_cpu_gauge_clock_get() - p_gauge->timestamp;
+
+    p_gauge->cur_time    = delta;
+    p_gauge->total_time += p_gauge->frame_time;
+    p_gauge->cpu_time   += delta;
+    p_gauge->frames     += 1;
+
+    if (delta > p_gauge->frame_time)
+    {
+        p_gauge->overruns += 1;
+    }
 
-    p_gauge->cur_cpu_usage = 100ul * delta / FRAME_LENGTH_IN_TICKS;
-    p_gauge->total_time   += FRAME_LENGTH_IN_TICKS;
-    p_gauge->cpu_time     += delta;
+    if (p_gauge->max_time < delta)
+    {
+         p_gauge->max_time = delta;
+    }
 
-    if (p_gauge->max_cpu_usage < p_gauge->cur_cpu_usage)
+    if (p_gauge->min_time > delta)
     {
-         p_gauge->max_cpu_usage = p_gauge->cur_cpu_usage;
+        p_gauge->min_time = delta;
     }
 
-    if (p_gauge->min_cpu_usage > p_gauge->cur_cpu_usage)
+#if CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
     {
-        p_gauge->min_cpu_usage = p_gauge->cur_cpu_usage;
+        uint16_t *p_bin = &p_gauge->histogram[m_audio_cpu_gauge_bin(delta)];
+
+        // Saturate instead of wrapping around, so that percentiles stay meaningful.
+        if (*p_bin < UINT16_MAX)
+        {
+            *p_bin += 1;
+        }
     }
+#endif
 }
 
 void m_audio_bitrate_gauge_reset(m_audio_bitrate_gauge_t *p_gauge)
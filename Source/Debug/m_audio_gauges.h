@@ -47,14 +47,34 @@
 #include "app_util_platform.h"
 #include "sr3_config.h"
 
+/**@brief Processing times shorter than 2^M_AUDIO_CPU_HISTOGRAM_MIN_LOG2 clock ticks fall into the first histogram bin. */
+#define M_AUDIO_CPU_HISTOGRAM_MIN_LOG2      8
+
+/**@brief Number of histogram bins per octave of processing time (log2). */
+#define M_AUDIO_CPU_HISTOGRAM_STEPS_LOG2    2
+
+/**@brief Number of histogram bins. The last bin collects all longer processing times. */
+#define M_AUDIO_CPU_HISTOGRAM_BINS          64
+
+/**@brief CPU usage gauge.
+ *
+ * Processing time is measured in clock ticks: CPU cycles counted by DWT on the target,
+ * nanoseconds on a host build. Frame length is expressed in the same unit.
+ */
 typedef struct
 {
-    uint32_t    total_time;
-    uint32_t    cpu_time;
-    uint32_t    timestamp;
-    uint8_t     min_cpu_usage;
-    uint8_t     cur_cpu_usage;
-    uint8_t     max_cpu_usage;
+    uint64_t    total_time;     /**< Sum of frame lengths. */
+    uint64_t    cpu_time;       /**< Sum of processing times. */
+    uint32_t    timestamp;      /**< Start of the current measurement. */
+    uint32_t    frame_time;     /**< Duration of audio handled by one measurement. */
+    uint32_t    frames;         /**< Number of measurements. */
+    uint32_t    overruns;       /**< Number of measurements longer than a frame. */
+    uint32_t    min_time;       /**< Shortest processing time. */
+    uint32_t    cur_time;       /**< Last processing time. */
+    uint32_t    max_time;       /**< Longest processing time. */
+#if CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+    uint16_t    histogram[M_AUDIO_CPU_HISTOGRAM_BINS];  /**< Log-scale histogram of processing times. */
+#endif
 } m_audio_cpu_gauge_t;
 
 typedef struct
@@ -73,20 +93,33 @@ typedef struct
     nrf_atomic_u32_t    discarded;
 } m_audio_loss_gauge_t;
 
+__STATIC_INLINE uint8_t m_audio_gauge_time_to_cpu_usage(const m_audio_cpu_gauge_t *p_gauge, uint32_t time)
+{
+    uint32_t usage;
+
+    if (p_gauge->frame_time == 0)
+    {
+        return 0;
+    }
+
+    usage = 100ull * time / p_gauge->frame_time;
+    return (usage < UINT8_MAX) ? usage : UINT8_MAX;
+}
+
 __STATIC_INLINE uint8_t m_audio_gauge_get_cur_cpu_usage(const m_audio_cpu_gauge_t *p_gauge)
 {
-    return p_gauge->cur_cpu_usage;
+    return m_audio_gauge_time_to_cpu_usage(p_gauge, p_gauge->cur_time);
 }
 
 __STATIC_INLINE uint8_t m_audio_gauge_get_min_cpu_usage(const m_audio_cpu_gauge_t *p_gauge)
 {
-    return p_gauge->min_cpu_usage;
+    return (p_gauge->frames != 0) ? m_audio_gauge_time_to_cpu_usage(p_gauge, p_gauge->min_time) : 0;
 }
 
 __STATIC_INLINE uint8_t m_audio_gauge_get_avg_cpu_usage(const m_audio_cpu_gauge_t *p_gauge)
 {
-    uint32_t total_time;
-    uint32_t cpu_time;
+    uint64_t total_time;
+    uint64_t cpu_time;
 
     CRITICAL_REGION_ENTER();
     total_time  = p_gauge->total_time;
@@ -103,7 +136,12 @@ __STATIC_INLINE uint8_t m_audio_gauge_get_avg_cpu_usage(const m_audio_cpu_gauge_
 
 __STATIC_INLINE uint8_t m_audio_gauge_get_max_cpu_usage(const m_audio_cpu_gauge_t *p_gauge)
 {
-    return p_gauge->max_cpu_usage;
+    return m_audio_gauge_time_to_cpu_usage(p_gauge, p_gauge->max_time);
+}
+
+__STATIC_INLINE uint32_t m_audio_gauge_get_overrun_count(const m_audio_cpu_gauge_t *p_gauge)
+{
+    return p_gauge->overruns;
 }
 
 __STATIC_INLINE uint8_t m_audio_gauge_get_cur_bitrate(const m_audio_bitrate_gauge_t *p_gauge)
@@ -156,11 +194,45 @@ __STATIC_INLINE uint32_t m_audio_gauge_get_discarded_count(const m_audio_loss_ga
 
 #if CONFIG_AUDIO_GAUGES_ENABLED
 
-void m_audio_cpu_gauge_reset(m_audio_cpu_gauge_t *p_gauge);
+/**@brief Reset a processing time gauge.
+ *
+ * @param[out] p_gauge              Gauge.
+ * @param[in]  samples              Number of samples handled by one measurement.
+ * @param[in]  sampling_frequency   Sampling frequency of these samples.
+ */
+void m_audio_cpu_gauge_reset(m_audio_cpu_gauge_t *p_gauge, uint32_t samples, uint32_t sampling_frequency);
 void m_audio_cpu_gauge_log(const m_audio_cpu_gauge_t *p_gauge, const char *p_prefix);
 void m_audio_measure_cpu_usage_start(m_audio_cpu_gauge_t *p_gauge);
 void m_audio_measure_cpu_usage_end(m_audio_cpu_gauge_t *p_gauge);
 
+/**@brief Get the frequency of the clock used to measure processing time.
+ *
+ * @return Number of clock ticks per second.
+ */
+uint32_t m_audio_cpu_gauge_clock_frequency(void);
+
+#if CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+/**@brief Get a percentile of processing time.
+ *
+ * The result is the upper edge of the histogram bin containing the percentile,
+ * limited to the longest measured processing time. Its resolution is a quarter of an octave.
+ *
+ * @param[in] p_gauge       Gauge.
+ * @param[in] percentile    Percentile (0-100).
+ *
+ * @return Processing time in clock ticks, or 0 if nothing has been measured.
+ */
+uint32_t m_audio_cpu_gauge_percentile(const m_audio_cpu_gauge_t *p_gauge, unsigned int percentile);
+
+/**@brief Get the range of processing times counted by a histogram bin.
+ *
+ * @param[in]  bin      Bin index.
+ * @param[out] p_lower  Shortest processing time counted by the bin.
+ * @param[out] p_upper  Processing time following the longest one counted by the bin.
+ */
+void m_audio_cpu_gauge_bin_range(unsigned int bin, uint32_t *p_lower, uint32_t *p_upper);
+#endif /* CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED */
+
 void m_audio_bitrate_gauge_reset(m_audio_bitrate_gauge_t *p_gauge);
 void m_audio_bitrate_gauge_log(const m_audio_bitrate_gauge_t *p_gauge, const char *p_prefix);
 void m_audio_measure_bitrate(m_audio_bitrate_gauge_t *p_gauge, unsigned int bytes);
@@ -173,7 +245,7 @@ void m_audio_count_discarded(m_audio_loss_gauge_t *p_gauge);
 
 #else /* !CONFIG_AUDIO_GAUGES_ENABLED */
 
-#define m_audio_cpu_gauge_reset(p_gauge)            do { } while (0)
+#define m_audio_cpu_gauge_reset(p_gauge, n, freq)   do { } while (0)
 #define m_audio_cpu_gauge_log(p_gauge, prefix)      do { } while (0)
 #define m_audio_measure_cpu_usage_start(p_gauge)    do { } while (0)
 #define m_audio_measure_cpu_usage_end(p_gauge)      do { } while (0)
@@ -88,9 +88,48 @@ NRF_LOG_MODULE_REGISTER();
 #define AUDIO_PROBE_INFO_SUBCOMMAND             "info"
 #define AUDIO_CHANNEL_STRING_SIZE               5 // Maximum length of channel number strings ("1", "2", "none"), including trailing zero
 
+/* Probe points see either captured blocks or whole codec frames */
+#if (CONFIG_PDM_BUFFER_SIZE_SAMPLES > CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+# define AUDIO_PROBE_MAX_SAMPLES                CONFIG_PDM_BUFFER_SIZE_SAMPLES
+#else
+# define AUDIO_PROBE_MAX_SAMPLES                CONFIG_AUDIO_FRAME_SIZE_SAMPLES
+#endif
+
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+/* Synchronization word which starts every frame of the multiplexed tap stream */
+#define AUDIO_STREAM_SYNC                       0xA55A
+
+/* Frame payload coding: raw little-endian PCM, or Rice coding with parameter (coding - AUDIO_STREAM_CODING_RICE) */
+#define AUDIO_STREAM_CODING_RAW                 0
+#define AUDIO_STREAM_CODING_RICE                1
+
+/* Largest Rice parameter tried. Deltas of 16-bit samples are 17 bits long after zigzag mapping. */
+#define AUDIO_STREAM_RICE_K_MAX                 15
+
+/* Quotients of this size or larger are sent as this many ones followed by the raw 17-bit value */
+#define AUDIO_STREAM_RICE_ESCAPE                24
+#define AUDIO_STREAM_RICE_ESCAPE_BITS           17
+
+/**@brief Header of a frame in the multiplexed tap stream. All fields are little-endian. */
+typedef PACKED_STRUCT
+{
+    uint16_t    sync;           /**< AUDIO_STREAM_SYNC. */
+    uint8_t     point;          /**< Probe point, @ref m_audio_probe_point_enum_t. */
+    uint8_t     coding;         /**< Payload coding. */
+    uint16_t    sequence;       /**< Frame counter of the probe point, incremented also for dropped frames. */
+    uint16_t    samples;        /**< Number of samples in the frame. */
+    uint16_t    payload_size;   /**< Number of payload bytes following the header. */
+    uint16_t    dropped;        /**< Number of frames of the probe point dropped so far. */
+} m_audio_probe_frame_header_t;
+
+# define AUDIO_TAP_BUFFER_SIZE                  (sizeof(m_audio_probe_frame_header_t) + (sizeof(int16_t) * AUDIO_PROBE_MAX_SAMPLES))
+#else /* !CONFIG_AUDIO_PROBE_STREAM_ENABLED */
+# define AUDIO_TAP_BUFFER_SIZE                  (sizeof(int16_t) * AUDIO_PROBE_MAX_SAMPLES)
+#endif /* CONFIG_AUDIO_PROBE_STREAM_ENABLED */
+
 /* Sizes are increased by 1 byte because SEGGER RTT channels are actually 1 byte smaller than demanded */
-#define AUDIO_CHANNEL_UP_BUFFER_SIZE            ((sizeof(int16_t) * CONFIG_PDM_BUFFER_SIZE_SAMPLES * CONFIG_AUDIO_PROBE_RTT_TAP_BUFFERS) + 1)
-#define AUDIO_CHANNEL_DOWN_BUFFER_SIZE          ((sizeof(int16_t) * CONFIG_PDM_BUFFER_SIZE_SAMPLES * CONFIG_AUDIO_PROBE_RTT_INJECT_BUFFERS) + 1)
+#define AUDIO_CHANNEL_UP_BUFFER_SIZE            ((AUDIO_TAP_BUFFER_SIZE * CONFIG_AUDIO_PROBE_RTT_TAP_BUFFERS) + 1)
+#define AUDIO_CHANNEL_DOWN_BUFFER_SIZE          ((sizeof(int16_t) * AUDIO_PROBE_MAX_SAMPLES * CONFIG_AUDIO_PROBE_RTT_INJECT_BUFFERS) + 1)
 
 /**@brief Type representing audio probe point direction. */
 typedef enum {
@@ -125,6 +164,8 @@ const m_audio_probe_point_t audio_test_points[] = {
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_PDM_OUT, "pdm.out", M_AUDIO_PROBE_OUTPUT),
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_ANR_IN, "anr.in", M_AUDIO_PROBE_INPUT),
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_ANR_OUT, "anr.out", M_AUDIO_PROBE_OUTPUT),
+    DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_NS_IN, "ns.in", M_AUDIO_PROBE_INPUT),
+    DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_NS_OUT, "ns.out", M_AUDIO_PROBE_OUTPUT),
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_EQ_IN, "eq.in", M_AUDIO_PROBE_INPUT),
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_EQ_OUT, "eq.out", M_AUDIO_PROBE_OUTPUT),
     DEFINE_AUDIO_POINT(M_AUDIO_PROBE_POINT_GAIN_IN, "gain.in", M_AUDIO_PROBE_INPUT),
@@ -137,6 +178,20 @@ const m_audio_probe_point_t audio_test_points[] = {
 
 STATIC_ASSERT(M_AUDIO_PROBE_POINTS_NUM == ARRAY_SIZE(audio_test_points));
 
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+/**@brief Multiplexed tap stream statistics of a probe point. */
+typedef struct
+{
+    uint16_t    sequence;   /**< Sequence number of the next frame. */
+    uint32_t    sent;       /**< Number of frames written to RTT. */
+    uint32_t    dropped;    /**< Number of frames which did not fit into RTT. */
+    uint32_t    bytes;      /**< Number of bytes written to RTT. */
+} m_audio_probe_stream_stats_t;
+
+static m_audio_probe_stream_stats_t m_audio_stream_stats[M_AUDIO_PROBE_POINTS_NUM];
+static uint8_t                      m_audio_stream_frame[AUDIO_TAP_BUFFER_SIZE];
+#endif /* CONFIG_AUDIO_PROBE_STREAM_ENABLED */
+
 /* RTT buffers for audio */
 #if CONFIG_AUDIO_PROBE_RTT_CHANNELS_UP
 static uint8_t m_channels_up[CONFIG_AUDIO_PROBE_RTT_CHANNELS_UP][AUDIO_CHANNEL_UP_BUFFER_SIZE];
@@ -267,6 +322,14 @@ static bool m_audio_probe_channel_valid(int8_t channel, m_audio_probe_point_type
 /**@brief Check if a probe channel is connected to a probe point */
 static bool m_audio_probe_channel_is_occupied(int8_t channel, m_audio_probe_point_type_t point_type)
 {
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+    if (point_type == M_AUDIO_PROBE_OUTPUT)
+    {
+        // Tap points are multiplexed and may share a channel.
+        return false;
+    }
+#endif
+
     for (unsigned int point = 0; point < M_AUDIO_PROBE_POINTS_NUM; point++)
     {
         if (*(audio_test_points[point].p_channel) == channel) // channel occupied
@@ -368,6 +431,23 @@ static void m_audio_probe_info_cli_cmd(nrf_cli_t const * p_cli, size_t argc, cha
                             audio_test_points[point].name, *(audio_test_points[point].p_channel));
         }
     }
+
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\r\n%12s\t%s\t%s\t%s\r\n", "Tap", "Sent", "Dropped", "Bytes");
+    for (int point = 0; point < M_AUDIO_PROBE_POINTS_NUM; ++point)
+    {
+        const m_audio_probe_stream_stats_t *p_stats = &m_audio_stream_stats[point];
+
+        if ((audio_test_points[point].type != M_AUDIO_PROBE_OUTPUT) ||
+            ((p_stats->sent == 0) && (p_stats->dropped == 0)))
+        {
+            continue;
+        }
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%12s\t%u\t%u\t%u\r\n",
+                        audio_test_points[point].name, p_stats->sent, p_stats->dropped, p_stats->bytes);
+    }
+#endif /* CONFIG_AUDIO_PROBE_STREAM_ENABLED */
 }
 
 /**@brief CLI handler function "audio probe" */
@@ -464,6 +544,196 @@ void m_audio_probe_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
     }
 }
 
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+/**@brief Bit writer used by the Rice coder. */
+typedef struct
+{
+    uint8_t     *p_data;    /**< Output buffer. */
+    size_t      size;       /**< Output buffer size in bytes. */
+    size_t      pos;        /**< Number of complete bytes written. */
+    uint32_t    acc;        /**< Pending bits, MSB first. */
+    uint8_t     bits;       /**< Number of pending bits. */
+} m_audio_probe_bit_writer_t;
+
+/**@brief Append the lowest @p count bits of @p value. Return false if the output buffer is full. */
+static bool m_audio_probe_bits_put(m_audio_probe_bit_writer_t *p_writer, uint32_t value, uint8_t count)
+{
+    ASSERT(count <= 24);
+
+    p_writer->acc   = (p_writer->acc << count) | (value & ((1UL << count) - 1));
+    p_writer->bits += count;
+
+    while (p_writer->bits >= 8)
+    {
+        if (p_writer->pos >= p_writer->size)
+        {
+            return false;
+        }
+
+        p_writer->bits -= 8;
+        p_writer->p_data[p_writer->pos++] = (uint8_t)(p_writer->acc >> p_writer->bits);
+    }
+
+    return true;
+}
+
+/**@brief Map a signed sample difference to an unsigned value: 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4... */
+static __INLINE uint32_t m_audio_probe_zigzag(int32_t delta)
+{
+    return (delta >= 0) ? ((uint32_t)delta << 1) : ((((uint32_t)(-delta)) << 1) - 1);
+}
+
+/**@brief Number of bits needed to Rice-code the sample differences of a buffer with parameter k. */
+static uint32_t m_audio_probe_rice_cost(const int16_t *p_samples, size_t samples, uint8_t k)
+{
+    uint32_t cost = 0;
+
+    for (size_t i = 1; i < samples; i++)
+    {
+        uint32_t q = m_audio_probe_zigzag(p_samples[i] - p_samples[i - 1]) >> k;
+
+        cost += (q < AUDIO_STREAM_RICE_ESCAPE) ? (q + 1 + k) : (AUDIO_STREAM_RICE_ESCAPE + AUDIO_STREAM_RICE_ESCAPE_BITS);
+    }
+
+    return cost;
+}
+
+/**@brief Rice-code a buffer: the first sample as 16-bit little-endian, then the coded differences.
+ *
+ * @return Payload size in bytes, or 0 if the coded payload would not be smaller than raw PCM.
+ */
+static size_t m_audio_probe_rice_encode(const int16_t *p_samples, size_t samples, uint8_t *p_out, uint8_t *p_k)
+{
+    m_audio_probe_bit_writer_t writer;
+    size_t raw_size = samples * sizeof(int16_t);
+    uint32_t best_cost = UINT32_MAX;
+    uint8_t best_k = 0;
+
+    if (samples < 2)
+    {
+        return 0;
+    }
+
+    for (uint8_t k = 0; k <= AUDIO_STREAM_RICE_K_MAX; k++)
+    {
+        uint32_t cost = m_audio_probe_rice_cost(p_samples, samples, k);
+
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            best_k    = k;
+        }
+    }
+
+    if ((sizeof(int16_t) + CEIL_DIV(best_cost, 8)) >= raw_size)
+    {
+        return 0;
+    }
+
+    p_out[0] = (uint8_t)(p_samples[0]);
+    p_out[1] = (uint8_t)((uint16_t)p_samples[0] >> 8);
+
+    writer.p_data = &p_out[sizeof(int16_t)];
+    writer.size   = raw_size - sizeof(int16_t);
+    writer.pos    = 0;
+    writer.acc    = 0;
+    writer.bits   = 0;
+
+    for (size_t i = 1; i < samples; i++)
+    {
+        uint32_t u = m_audio_probe_zigzag(p_samples[i] - p_samples[i - 1]);
+        uint32_t q = u >> best_k;
+        bool     ok;
+
+        if (q < AUDIO_STREAM_RICE_ESCAPE)
+        {
+            // Unary quotient: q ones and a terminating zero, written in chunks which fit the writer.
+            while (q >= 16)
+            {
+                (void)m_audio_probe_bits_put(&writer, 0xFFFF, 16);
+                q -= 16;
+            }
+            ok = m_audio_probe_bits_put(&writer, ((1UL << q) - 1) << 1, q + 1) &&
+                 m_audio_probe_bits_put(&writer, u, best_k);
+        }
+        else
+        {
+            ok = m_audio_probe_bits_put(&writer, (1UL << AUDIO_STREAM_RICE_ESCAPE) - 1, AUDIO_STREAM_RICE_ESCAPE) &&
+                 m_audio_probe_bits_put(&writer, u, AUDIO_STREAM_RICE_ESCAPE_BITS);
+        }
+
+        if (!ok)
+        {
+            return 0;
+        }
+    }
+
+    // Flush the last byte, padded with zeros.
+    if ((writer.bits > 0) && !m_audio_probe_bits_put(&writer, 0, 8 - writer.bits))
+    {
+        return 0;
+    }
+
+    *p_k = best_k;
+    return sizeof(int16_t) + writer.pos;
+}
+
+/**@brief Send a buffer as one frame of the multiplexed tap stream. */
+static void m_audio_probe_stream_write(m_audio_probe_point_enum_t point,
+                                       unsigned int channel,
+                                       const int16_t *p_samples,
+                                       size_t samples)
+{
+    m_audio_probe_stream_stats_t *p_stats = &m_audio_stream_stats[point];
+    m_audio_probe_frame_header_t header;
+    uint8_t *p_payload = &m_audio_stream_frame[sizeof(header)];
+    size_t payload_size = 0;
+    size_t frame_size;
+    uint8_t k;
+
+    ASSERT((sizeof(header) + (samples * sizeof(int16_t))) <= sizeof(m_audio_stream_frame));
+
+    header.sync     = AUDIO_STREAM_SYNC;
+    header.point    = (uint8_t)point;
+    header.coding   = AUDIO_STREAM_CODING_RAW;
+    header.sequence = p_stats->sequence++;
+    header.samples  = (uint16_t)samples;
+    header.dropped  = (uint16_t)p_stats->dropped;
+
+#if CONFIG_AUDIO_PROBE_STREAM_COMPRESSION_ENABLED
+    payload_size = m_audio_probe_rice_encode(p_samples, samples, p_payload, &k);
+    if (payload_size > 0)
+    {
+        header.coding = AUDIO_STREAM_CODING_RICE + k;
+    }
+#else
+    UNUSED_VARIABLE(k);
+#endif
+    if (payload_size == 0)
+    {
+        payload_size = samples * sizeof(int16_t);
+        memcpy(p_payload, p_samples, payload_size);
+    }
+
+    header.payload_size = (uint16_t)payload_size;
+    memcpy(m_audio_stream_frame, &header, sizeof(header));
+    frame_size = sizeof(header) + payload_size;
+
+    // In SEGGER_RTT_MODE_NO_BLOCK_SKIP mode a frame is either written completely or not at all.
+    if (SEGGER_RTT_Write(channel, m_audio_stream_frame, frame_size) == frame_size)
+    {
+        p_stats->sent  += 1;
+        p_stats->bytes += frame_size;
+        NRF_LOG_DEBUG("%s: sent frame %u, %u bytes.", audio_test_points[point].name, header.sequence, frame_size);
+    }
+    else
+    {
+        p_stats->dropped += 1;
+        NRF_LOG_DEBUG("%s: dropped frame %u.", audio_test_points[point].name, header.sequence);
+    }
+}
+#endif /* CONFIG_AUDIO_PROBE_STREAM_ENABLED */
+
 void m_audio_probe_point(m_audio_probe_point_enum_t point, int16_t *buffer, size_t buffer_size_samples)
 {
     size_t bytes_transfered;
@@ -484,6 +754,11 @@ void m_audio_probe_point(m_audio_probe_point_enum_t point, int16_t *buffer, size
         }
         else
         {
+#if CONFIG_AUDIO_PROBE_STREAM_ENABLED
+            /* tap data to the multiplexed stream */
+            m_audio_probe_stream_write(point, *(audio_test_points[point].p_channel), buffer, buffer_size_samples);
+            UNUSED_VARIABLE(bytes_transfered);
+#else
             /* tap data */
             bytes_transfered = SEGGER_RTT_Write(*(audio_test_points[point].p_channel), buffer, buffer_size_bytes);
             NRF_LOG_DEBUG("%s: sent %d bytes.", audio_test_points[point].name, bytes_transfered);
@@ -491,6 +766,7 @@ void m_audio_probe_point(m_audio_probe_point_enum_t point, int16_t *buffer, size
             {
                 NRF_LOG_WARNING("Tapped an incomplete audio buffer. Recorded sound may be corrupted.");
             }
+#endif /* CONFIG_AUDIO_PROBE_STREAM_ENABLED */
         }
     }
 }
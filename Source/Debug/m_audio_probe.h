@@ -66,6 +66,8 @@ typedef enum
     M_AUDIO_PROBE_POINT_GAIN_IN,     /**< Inject audio before gain control */
     M_AUDIO_PROBE_POINT_GAIN_OUT,    /**< Tap audio after gain control */
     M_AUDIO_PROBE_INFO_SUBCOMMAND,   /**< Dummy entry to simplify autocompletion of audio probe commands in CLI. */
+    M_AUDIO_PROBE_POINT_NS_IN,       /**< Inject audio before noise suppression */
+    M_AUDIO_PROBE_POINT_NS_OUT,      /**< Tap audio after noise suppression */
     M_AUDIO_PROBE_POINT_PDM_OUT,     /**< Tap audio after PDM microphone */
     M_AUDIO_PROBE_POINTS_NUM
 } m_audio_probe_point_enum_t;
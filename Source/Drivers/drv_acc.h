@@ -57,22 +57,40 @@ typedef enum {
   DRV_ACC_MODE_WAKE_UP,
   DRV_ACC_MODE_CLICK_DETECT,
   DRV_ACC_MODE_IDLE,
+  DRV_ACC_MODE_MOTION_TRACK,
+  DRV_ACC_MODE_MOTION_WAKE,
 } drv_acc_mode_t;
 
 #define DRV_ACC_MODE_DEFAULT    DRV_ACC_MODE_IDLE
 
+/**@brief Number of samples the accelerometer FIFO can hold. */
+#define DRV_ACC_FIFO_SIZE       32
+
+/**@brief Sampling rate used in the DRV_ACC_MODE_MOTION_TRACK mode [Hz]. */
+#define DRV_ACC_MOTION_TRACK_ODR 100
+
+/**@brief Acceleration sample, in mg. */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} drv_acc_sample_t;
+
 /**@brief Callback type. */
 typedef void (*drv_acc_callback_t)(void);
 
 /**@brief Accelerometer driver initialization.
  *
  * @note This function uses unscheduled I2C transactions - must be called only in MAIN CONTEXT.
+ * @note Both callbacks are executed in the interrupt context.
  *
- * @param[in]   click_handler Callback used to report click events.
+ * @param[in]   click_handler   Callback used to report click events.
+ * @param[in]   motion_handler  Callback used to report motion in the DRV_ACC_MODE_MOTION_WAKE mode.
  *
  * @return      NRF_SUCCESS on success, otherwise an error code.
  */
-ret_code_t drv_acc_init(drv_acc_callback_t click_handler);
+ret_code_t drv_acc_init(drv_acc_callback_t click_handler, drv_acc_callback_t motion_handler);
 
 /**@brief Set the mode of operation.
  *
@@ -84,6 +102,18 @@ ret_code_t drv_acc_init(drv_acc_callback_t click_handler);
  */
 ret_code_t drv_acc_mode_set(drv_acc_mode_t mode);
 
+/**@brief Read the samples collected in the FIFO since the last read.
+ *
+ * @note This function uses unscheduled I2C transactions - must be called in MAIN CONTEXT only.
+ * @note The FIFO is only filled in the DRV_ACC_MODE_MOTION_TRACK mode.
+ *
+ * @param[out]      p_samples   Buffer for the samples, oldest first.
+ * @param[in,out]   p_count     In: capacity of the buffer. Out: number of samples read.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t drv_acc_fifo_read(drv_acc_sample_t *p_samples, uint8_t *p_count);
+
 #endif /* __DRV_ACC_H__ */
 
 /** @} */
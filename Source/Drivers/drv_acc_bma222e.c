@@ -81,6 +81,10 @@ static app_gpiote_user_id_t     m_acc_gpiote;
 #error Click detection not yet supported by this driver
 #endif
 
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+#error Motion-gated gyroscope power not yet supported by this driver
+#endif
+
 /**@brief Reads one or more consecutive registers from the device.
  *
  * @note This function uses unscheduled TWI transactions - must be called only in MAIN CONTEXT.
@@ -434,13 +438,22 @@ ret_code_t drv_acc_mode_set(drv_acc_mode_t mode)
     return status;
 }
 
-ret_code_t drv_acc_init(drv_acc_callback_t click_handler)
+ret_code_t drv_acc_fifo_read(drv_acc_sample_t *p_samples, uint8_t *p_count)
+{
+    UNUSED_PARAMETER(p_samples);
+    UNUSED_PARAMETER(p_count);
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+ret_code_t drv_acc_init(drv_acc_callback_t click_handler, drv_acc_callback_t motion_handler)
 {
     uint32_t low_to_high_mask = (1 << CONFIG_IO_ACC_IRQ);
     uint32_t high_to_low_mask = (0 << CONFIG_IO_ACC_IRQ);
     ret_code_t status;
 
     UNUSED_PARAMETER(click_handler);
+    UNUSED_PARAMETER(motion_handler);
 
     status = app_gpiote_user_register(&m_acc_gpiote,
                                       &low_to_high_mask,
@@ -77,6 +77,16 @@ static app_gpiote_user_id_t     m_acc_gpiote;
 static drv_acc_callback_t       m_acc_callback;
 #endif
 
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+static drv_acc_callback_t       m_acc_motion_callback;
+#endif
+
+// Samples are read straight from the OUT_X_L..OUT_Z_H registers into drv_acc_sample_t.
+STATIC_ASSERT(sizeof(drv_acc_sample_t) == 6);
+
+// CTRL_REG1 value used in the motion track mode selects 100 Hz ODR.
+STATIC_ASSERT(DRV_ACC_MOTION_TRACK_ODR == 100);
+
 /**@brief Reads one or more consecutive registers from the device.
  *
  * @note This function uses unscheduled TWI transactions - must be called only in MAIN CONTEXT.
@@ -254,12 +264,19 @@ static void m_acc_interupt_handler(uint32_t const *p_event_pins_low_to_high,
                                    uint32_t const *p_event_pins_high_to_low)
 {
 #if CONFIG_ACC_USE_CLICK_DETECTION
-    if ((m_acc_mode == DRV_ACC_MODE_CLICK_DETECT) && m_acc_callback)
+    if (((m_acc_mode == DRV_ACC_MODE_CLICK_DETECT) || (m_acc_mode == DRV_ACC_MODE_MOTION_TRACK)) &&
+        m_acc_callback)
     {
         NRF_LOG_DEBUG("<Accelerometer Interrupt>");
         m_acc_callback();
     }
 #endif /* CONFIG_ACC_USE_CLICK_DETECTION */
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+    if ((m_acc_mode == DRV_ACC_MODE_MOTION_WAKE) && m_acc_motion_callback)
+    {
+        m_acc_motion_callback();
+    }
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
 }
 
 /**@brief Sets the accelerometer in idle mode.
@@ -300,19 +317,19 @@ static ret_code_t lis3dh_idle_mode_set(void)
     return lis3dh_write_regs(CTRL_REG1, &reg_val, 1);
 }
 
-/**@brief Sets the accelerometer in wakeup mode - see AN3308 application note - page 23.
+/**@brief Configures the inertial interrupt - see AN3308 application note - page 23.
+ *
+ * @param[in] threshold Contents of the INT1_THS register.
  *
  * @return NRF_SUCCESS on success, otherwise an error code.
  */
-static ret_code_t lis3dh_wakeup_mode_set(void)
+static ret_code_t lis3dh_inertial_int_set(uint8_t threshold)
 {
     uint8_t ctrl_regs[] = {0x5F, 0x01, 0x40, 0x00, 0x00};
-    uint8_t int1_ths[]  = {CONFIG_ACC_WAKEUP_THRESHOLD, 0x00};
+    uint8_t int1_ths[]  = {threshold, 0x00};
     ret_code_t status;
     uint8_t reg_val;
 
-    NRF_LOG_INFO("DRV_ACC_MODE_WAKE_UP");
-
     // Disable all interrupts.
     status = lis3dh_int_enable(0x00, 0x00);
     if (status != NRF_SUCCESS)
@@ -351,6 +368,106 @@ static ret_code_t lis3dh_wakeup_mode_set(void)
     return lis3dh_int_enable(0x2A, 0x00);
 }
 
+/**@brief Sets the accelerometer in wakeup mode.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static ret_code_t lis3dh_wakeup_mode_set(void)
+{
+    NRF_LOG_INFO("DRV_ACC_MODE_WAKE_UP");
+
+    return lis3dh_inertial_int_set(CONFIG_ACC_WAKEUP_THRESHOLD);
+}
+
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+/**@brief Sets the accelerometer in motion wake mode.
+ *
+ * @details Same as the wakeup mode, but with a lower threshold, so that the gyroscope
+ *          starts waking up on the first movement of the hand, before the cursor moves.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static ret_code_t lis3dh_motion_wake_mode_set(void)
+{
+    NRF_LOG_INFO("DRV_ACC_MODE_MOTION_WAKE");
+
+    return lis3dh_inertial_int_set(CONFIG_GYRO_MOTION_WAKE_THRESHOLD);
+}
+
+/**@brief Sets the accelerometer in motion track mode.
+ *
+ * @details The accelerometer samples continuously at DRV_ACC_MOTION_TRACK_ODR in normal mode
+ *          and keeps the latest DRV_ACC_FIFO_SIZE samples in the FIFO (stream mode).
+ *          Click detection is active as well, if enabled.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static ret_code_t lis3dh_motion_track_mode_set(void)
+{
+#if CONFIG_ACC_USE_CLICK_DETECTION
+    uint8_t ctrl_regs[] = {0x57, 0x04, 0x80, 0x00, FIFO_EN};
+    uint8_t click_cfg[] = {CONFIG_ACC_CLICK_THRESHOLD,
+                           CONFIG_ACC_CLICK_TIMELIMIT,
+                           CONFIG_ACC_CLICK_LATENCY};
+#else
+    uint8_t ctrl_regs[] = {0x57, 0x00, 0x00, 0x00, FIFO_EN};
+#endif
+    ret_code_t status;
+    uint8_t reg_val;
+
+    NRF_LOG_INFO("DRV_ACC_MODE_MOTION_TRACK");
+
+    // Disable all interrupts.
+    status = lis3dh_int_enable(0x00, 0x00);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // Flush the FIFO.
+    reg_val = FIFO_MODE_BYPASS;
+    status = lis3dh_write_regs(FIFO_CTRL_REG, &reg_val, 1);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // Update configuration.
+    status = lis3dh_write_regs(CTRL_REG1, ctrl_regs, sizeof(ctrl_regs));
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    reg_val = FIFO_MODE_STREAM;
+    status = lis3dh_write_regs(FIFO_CTRL_REG, &reg_val, 1);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+#if CONFIG_ACC_USE_CLICK_DETECTION
+    status = lis3dh_write_regs(CLICK_THS, click_cfg, sizeof(click_cfg));
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // Clear interrupts.
+    status = lis3dh_int_clear();
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // Enable selected interrupts.
+    return lis3dh_int_enable(0x00, CONFIG_ACC_CLICK_AXES);
+#else
+    return NRF_SUCCESS;
+#endif
+}
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
+
 #if CONFIG_ACC_USE_CLICK_DETECTION
 /**@brief Sets the accelerometer in click detect mode  - see AN3308 application note - page 35.
  *
@@ -416,6 +533,12 @@ static ret_code_t lis3dh_mode_set(drv_acc_mode_t mode)
 #endif
         case DRV_ACC_MODE_IDLE:
             return lis3dh_idle_mode_set();
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+        case DRV_ACC_MODE_MOTION_TRACK:
+            return lis3dh_motion_track_mode_set();
+        case DRV_ACC_MODE_MOTION_WAKE:
+            return lis3dh_motion_wake_mode_set();
+#endif
         default:
             return NRF_ERROR_NOT_SUPPORTED;
     }
@@ -459,6 +582,10 @@ ret_code_t drv_acc_mode_set(drv_acc_mode_t mode)
         {
 #if CONFIG_ACC_USE_CLICK_DETECTION
             case DRV_ACC_MODE_CLICK_DETECT:
+            case DRV_ACC_MODE_MOTION_TRACK:
+#endif
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+            case DRV_ACC_MODE_MOTION_WAKE:
 #endif
             case DRV_ACC_MODE_WAKE_UP:
                 status = lis3dh_enable_pio_interrupts();
@@ -479,7 +606,53 @@ ret_code_t drv_acc_mode_set(drv_acc_mode_t mode)
     return status;
 }
 
-ret_code_t drv_acc_init(drv_acc_callback_t click_handler)
+ret_code_t drv_acc_fifo_read(drv_acc_sample_t *p_samples, uint8_t *p_count)
+{
+    ret_code_t status;
+    uint8_t fifo_src;
+    uint8_t count;
+
+    ASSERT((p_samples != NULL) && (p_count != NULL));
+
+    if (m_acc_mode != DRV_ACC_MODE_MOTION_TRACK)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    status = lis3dh_read_regs(FIFO_SRC_REG, &fifo_src, 1);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // The FSS field saturates at 31 - overrun flag signals a full FIFO.
+    count = (fifo_src & FIFO_SRC_OVRUN) ? DRV_ACC_FIFO_SIZE : (fifo_src & FIFO_SRC_FSS_MSK);
+    count = MIN(count, *p_count);
+
+    if (count > 0)
+    {
+        // With the FIFO enabled, the register address wraps around from OUT_Z_H to OUT_X_L.
+        status = lis3dh_read_regs(OUT_X_L, (uint8_t *)p_samples, count * sizeof(drv_acc_sample_t));
+        if (status != NRF_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        // Left-justified data, 1 mg/digit at +/-2 g full scale.
+        p_samples[i].x /= 16;
+        p_samples[i].y /= 16;
+        p_samples[i].z /= 16;
+    }
+
+    *p_count = count;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_acc_init(drv_acc_callback_t click_handler, drv_acc_callback_t motion_handler)
 {
     uint32_t low_to_high_mask = (1 << CONFIG_IO_ACC_IRQ);
     uint32_t high_to_low_mask = (0 << CONFIG_IO_ACC_IRQ);
@@ -488,6 +661,11 @@ ret_code_t drv_acc_init(drv_acc_callback_t click_handler)
 #if CONFIG_ACC_USE_CLICK_DETECTION
     m_acc_callback = click_handler;
 #endif
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+    m_acc_motion_callback = motion_handler;
+#else
+    UNUSED_PARAMETER(motion_handler);
+#endif
 
     status = app_gpiote_user_register(&m_acc_gpiote,
                                       &low_to_high_mask,
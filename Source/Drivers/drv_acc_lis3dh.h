@@ -306,6 +306,7 @@ typedef struct
 #define FIFO_SRC_WTM                            BIT_7
 #define FIFO_SRC_OVRUN                          BIT_6
 #define FIFO_SRC_EMPTY                          BIT_5
+#define FIFO_SRC_FSS_MSK                        0x1F
 
 // Click interrupt register
 #define CLICK_CFG       0x38
@@ -386,5 +387,9 @@ typedef struct
 #define FIFO_CTRL_REG   0x2E
 #define FIFO_SRC_REG    0x2F
 
+// FIFO modes
+#define FIFO_MODE_BYPASS                        0x00
+#define FIFO_MODE_STREAM                        0x80
+
 #endif /* __DRV_ACC_LIS3DH_TYPES_H__ */
 /** @} */
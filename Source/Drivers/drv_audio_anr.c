@@ -51,6 +51,8 @@
 #include "nrf_log.h"
 NRF_LOG_MODULE_REGISTER();
 
+#if (CONFIG_AUDIO_ANR_ENGINE == CONFIG_AUDIO_ANR_ENGINE_VOCAL)
+
 typedef int16_t sint15;
 #include "vocal_anr.h"
 
@@ -71,6 +73,8 @@ void drv_audio_anr_init(void)
     global_mdm_pre_reset();
     vocal_application_startup();
     anr__initialize(&anr_cfg);
+
+    NRF_LOG_INFO("VOCAL ANR: %u taps, delay %u", CONFIG_AUDIO_ANR_LENGTH, CONFIG_AUDIO_ANR_DELAY_LENGTH);
 }
 
 void drv_audio_anr_perfrom(int16_t *p_samples, unsigned int buffer_size)
@@ -92,4 +96,58 @@ void drv_audio_anr_perfrom(int16_t *p_samples, unsigned int buffer_size)
     }
 }
 
+#elif (CONFIG_AUDIO_ANR_ENGINE == CONFIG_AUDIO_ANR_ENGINE_BUILTIN)
+
+#include "app_error.h"
+#include "app_util.h"
+#include "dmnr.h"
+
+#if ((CONFIG_AUDIO_ANR_STEP_SIZE < 1) || (CONFIG_AUDIO_ANR_STEP_SIZE > 1024))
+#error "CONFIG_AUDIO_ANR_STEP_SIZE must be in range <1-1024>!"
+#endif
+
+#if ((CONFIG_AUDIO_ANR_GAIN_FLOOR < 1) || (CONFIG_AUDIO_ANR_GAIN_FLOOR > 100))
+#error "CONFIG_AUDIO_ANR_GAIN_FLOOR must be in range <1-100>!"
+#endif
+
+static dmnr_t   m_dmnr;
+static int16_t  m_ref_history[2 * CONFIG_AUDIO_ANR_LENGTH];
+static int32_t  m_weights[CONFIG_AUDIO_ANR_LENGTH];
+static int16_t  m_delay_line[CONFIG_AUDIO_ANR_DELAY_LENGTH];
+
+STATIC_ASSERT(CONFIG_AUDIO_ANR_DELAY_LENGTH > 0);
+
+void drv_audio_anr_init(void)
+{
+    const dmnr_config_t dmnr_cfg =
+    {
+        .p_ref_history  = m_ref_history,
+        .p_weights      = m_weights,
+        .p_delay_line   = m_delay_line,
+        .filter_length  = CONFIG_AUDIO_ANR_LENGTH,
+        .delay_length   = CONFIG_AUDIO_ANR_DELAY_LENGTH,
+        .step_size      = CONFIG_AUDIO_ANR_STEP_SIZE * 32,
+        .gain_floor     = (CONFIG_AUDIO_ANR_GAIN_FLOOR * 32767) / 100,
+    };
+
+    APP_ERROR_CHECK_BOOL(dmnr_init(&m_dmnr, &dmnr_cfg) == 0);
+
+    NRF_LOG_INFO("Built-in ANR: %u taps, delay %u, step %u/1024, floor %u%%",
+                 CONFIG_AUDIO_ANR_LENGTH,
+                 CONFIG_AUDIO_ANR_DELAY_LENGTH,
+                 CONFIG_AUDIO_ANR_STEP_SIZE,
+                 CONFIG_AUDIO_ANR_GAIN_FLOOR);
+}
+
+void drv_audio_anr_perfrom(int16_t *p_samples, unsigned int buffer_size)
+{
+    ASSERT(p_samples != NULL);
+
+    dmnr_process(&m_dmnr, p_samples, buffer_size);
+}
+
+#else
+#error "Unsupported ANR engine!"
+#endif
+
 #endif /* (CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_ANR_ENABLED) */
@@ -57,24 +57,39 @@ NRF_LOG_MODULE_REGISTER();
 
 #include "dvi_adpcm.h"
 
+#if ((CONFIG_ADPCM_LOOKAHEAD_DEPTH < 0) || (CONFIG_ADPCM_LOOKAHEAD_DEPTH > 3))
+# error "Unsupported ADPCM encoder lookahead!"
+#endif
+
 static dvi_adpcm_state_t    m_adpcm_state;
 
 void drv_audio_codec_init(void)
 {
     dvi_adpcm_init_state(&m_adpcm_state);
 
-    NRF_LOG_INFO("ADPCM Codec selected (frame: %u ms)", CONFIG_AUDIO_FRAME_SIZE_MS);
+    NRF_LOG_INFO("ADPCM Codec selected (frame: %u ms, lookahead: %u)",
+                 CONFIG_AUDIO_FRAME_SIZE_MS,
+                 CONFIG_ADPCM_LOOKAHEAD_DEPTH);
 }
 
 void drv_audio_codec_encode(int16_t *input_samples, m_audio_frame_t *p_frame)
 {
     int frame_size;
 
-    dvi_adpcm_encode((void *)input_samples,
-                    (CONFIG_AUDIO_FRAME_SIZE_SAMPLES * sizeof(*input_samples)),
-                    p_frame->data,
-                    &frame_size,
-                    &m_adpcm_state, true);
+#if (CONFIG_ADPCM_LOOKAHEAD_DEPTH > 0)
+    dvi_adpcm_encode_lookahead((void *)input_samples,
+                               (CONFIG_AUDIO_FRAME_SIZE_SAMPLES * sizeof(*input_samples)),
+                               p_frame->data,
+                               &frame_size,
+                               &m_adpcm_state, true,
+                               CONFIG_ADPCM_LOOKAHEAD_DEPTH);
+#else
+    dvi_adpcm_encode_fast((void *)input_samples,
+                          (CONFIG_AUDIO_FRAME_SIZE_SAMPLES * sizeof(*input_samples)),
+                          p_frame->data,
+                          &frame_size,
+                          &m_adpcm_state, true);
+#endif
 
     p_frame->data_size = frame_size;
 }
@@ -90,6 +105,7 @@ static void drv_audio_codec_info_cmd(nrf_cli_t const * p_cli, size_t argc, char
     }
 
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Codec: ADPCM\r\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\tLookahead:\t%u\r\n", CONFIG_ADPCM_LOOKAHEAD_DEPTH);
 }
 
 static const nrf_cli_static_entry_t drv_audio_codec_subcmds_table[] =
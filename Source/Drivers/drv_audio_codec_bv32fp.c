@@ -59,30 +59,49 @@ NRF_LOG_MODULE_REGISTER();
 #include "bvcommon.h"
 #include "bv32cnst.h"
 #include "bv32strct.h"
+#if CONFIG_BV32FP_FIXED_POINT_ENABLED
+#include "bv32fx.h"
+#else
 #include "bv32.h"
+#endif
 #include "bitpack.h"
 
-#if !defined(__FPU_USED) || (!__FPU_USED)
-#error "BV32FP codec requires FPU!".
+#if (!CONFIG_BV32FP_FIXED_POINT_ENABLED) && (!defined(__FPU_USED) || (!__FPU_USED))
+#error "BV32FP codec requires FPU! Enable CONFIG_BV32FP_FIXED_POINT_ENABLED on devices without FPU."
 #endif
 
 #if (CONFIG_AUDIO_SAMPLING_FREQUENCY != 16000)
 # error "Selected sampling frequency is not supported by the BV32FP codec!"
 #endif
+
+#if CONFIG_BV32FP_FIXED_POINT_ENABLED
+static struct BV32FX_Encoder_State  m_enc_state;
+#else
 static struct BV32_Encoder_State    m_enc_state;
+#endif
 
 void drv_audio_codec_init(void)
 {
+#if CONFIG_BV32FP_FIXED_POINT_ENABLED
+    Reset_BV32FX_Coder(&m_enc_state);
+
+    NRF_LOG_INFO("BV32FP Codec selected (frame: %u ms, fixed-point encoder)", CONFIG_AUDIO_FRAME_SIZE_MS);
+#else
     Reset_BV32_Coder(&m_enc_state);
 
     NRF_LOG_INFO("BV32FP Codec selected (frame: %u ms)", CONFIG_AUDIO_FRAME_SIZE_MS);
+#endif
 }
 
 void drv_audio_codec_encode(int16_t *input_samples, m_audio_frame_t *p_frame)
 {
     struct BV32_Bit_Stream bs;
 
+#if CONFIG_BV32FP_FIXED_POINT_ENABLED
+    BV32FX_Encode(&bs, &m_enc_state, input_samples);
+#else
     BV32_Encode(&bs, &m_enc_state, input_samples);
+#endif
     BV32_BitPack(p_frame->data, &bs);
 
     p_frame->data_size = sizeof(p_frame->data);
@@ -99,6 +118,8 @@ static void drv_audio_codec_info_cmd(nrf_cli_t const * p_cli, size_t argc, char
     }
 
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Codec: BV32FP\r\n");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Encoder: %s\r\n",
+                    (CONFIG_BV32FP_FIXED_POINT_ENABLED) ? "fixed-point" : "floating-point");
 }
 
 static const nrf_cli_static_entry_t drv_audio_codec_subcmds_table[] =
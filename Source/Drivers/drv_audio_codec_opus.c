@@ -43,6 +43,7 @@
 #include "nrf.h"
 #include "nrf_assert.h"
 #include "app_debug.h"
+#include "app_util.h"
 
 #include "drv_audio.h"
 #include "drv_audio_codec.h"
@@ -56,11 +57,14 @@
 NRF_LOG_MODULE_REGISTER();
 
 #include "opus.h"
+#include "custom_support.h"
 #define OPUS_MAX_FRAME_SIZE 3840
+#define OPUS_SCRATCH_PATTERN 0xA5A5A5A5UL
 
 #if   (CONFIG_OPUS_MODE == CONFIG_OPUS_MODE_CELT)
 # define OPUS_APPLICATION    OPUS_APPLICATION_RESTRICTED_LOWDELAY
 # define OPUS_ENCODER_SIZE   7180
+# define OPUS_SCRATCH_SIZE   CONFIG_OPUS_SCRATCH_SIZE_CELT
 # define OPUS_MODE           "CELT"
 # if (CONFIG_AUDIO_SAMPLING_FREQUENCY != 8000) && \
      (CONFIG_AUDIO_SAMPLING_FREQUENCY != 16000) && \
@@ -75,6 +79,7 @@ NRF_LOG_MODULE_REGISTER();
 #elif (CONFIG_OPUS_MODE == CONFIG_OPUS_MODE_SILK)
 # define OPUS_APPLICATION    OPUS_APPLICATION_VOIP
 # define OPUS_ENCODER_SIZE   10916
+# define OPUS_SCRATCH_SIZE   CONFIG_OPUS_SCRATCH_SIZE_SILK
 # define OPUS_MODE           "SILK"
 # if (CONFIG_AUDIO_SAMPLING_FREQUENCY != 8000) && \
      (CONFIG_AUDIO_SAMPLING_FREQUENCY != 16000)
@@ -93,6 +98,14 @@ NRF_LOG_MODULE_REGISTER();
 __ALIGN(4) static uint8_t           m_opus_encoder[OPUS_ENCODER_SIZE];
 static OpusEncoder * const          m_opus_state = (OpusEncoder *)m_opus_encoder;
 
+/**@brief Scratch arena used by Opus for temporary buffers. */
+__ALIGN(8) static uint32_t          m_opus_scratch[CEIL_DIV(OPUS_SCRATCH_SIZE, sizeof(uint32_t))];
+
+#if CONFIG_STACK_PROFILER_ENABLED
+static size_t                       m_opus_scratch_usage;       /**< Scratch usage of the last opus_encode() call. */
+static size_t                       m_opus_scratch_max_usage;   /**< Maximum scratch usage of all opus_encode() calls. */
+#endif
+
 #if CONFIG_CLI_ENABLED
 static bool                         m_opus_encoder_initialized;
 static uint8_t                      m_opus_complexity = CONFIG_OPUS_COMPLEXITY;
@@ -104,6 +117,47 @@ static bool                         m_opus_vbr        = ((CONFIG_OPUS_BITRATE ==
 # define                            m_opus_vbr          ((CONFIG_OPUS_BITRATE == 0) || (CONFIG_OPUS_VBR_ENABLED != 0))
 #endif /* CONFIG_CLI_ENABLED */
 
+void *drv_audio_codec_opus_scratch_get(size_t size)
+{
+    UNUSED_PARAMETER(size);
+
+    return m_opus_scratch;
+}
+
+void drv_audio_codec_opus_scratch_check(char const *p_top)
+{
+    // Stop before Opus writes past the arena.
+    APP_ERROR_CHECK_BOOL(p_top <= (char const *)&m_opus_scratch[ARRAY_SIZE(m_opus_scratch)]);
+}
+
+#if CONFIG_STACK_PROFILER_ENABLED
+static void drv_audio_codec_scratch_usage_update(void)
+{
+    size_t used_words = ARRAY_SIZE(m_opus_scratch);
+    size_t i;
+
+    // Find the highest word written by the last opus_encode() call.
+    while ((used_words > 0) && (m_opus_scratch[used_words - 1] == OPUS_SCRATCH_PATTERN))
+    {
+        used_words--;
+    }
+
+    // Restore the pattern, so that the next call is measured separately.
+    for (i = 0; i < used_words; i++)
+    {
+        m_opus_scratch[i] = OPUS_SCRATCH_PATTERN;
+    }
+
+    m_opus_scratch_usage = used_words * sizeof(uint32_t);
+
+    if (m_opus_scratch_usage > m_opus_scratch_max_usage)
+    {
+        m_opus_scratch_max_usage = m_opus_scratch_usage;
+        NRF_LOG_INFO("Maximum scratch usage: %u out of %u bytes", m_opus_scratch_max_usage, OPUS_SCRATCH_SIZE);
+    }
+}
+#endif /* CONFIG_STACK_PROFILER_ENABLED */
+
 static void drv_audio_codec_log_config(const char *action)
 {
     if (m_opus_bitrate == OPUS_AUTO)
@@ -126,8 +180,15 @@ static void drv_audio_codec_log_config(const char *action)
 
 void drv_audio_codec_init(void)
 {
+    size_t i;
+
     ASSERT(opus_encoder_get_size(1) == sizeof(m_opus_encoder));
 
+    for (i = 0; i < ARRAY_SIZE(m_opus_scratch); i++)
+    {
+        m_opus_scratch[i] = OPUS_SCRATCH_PATTERN;
+    }
+
     APP_ERROR_CHECK_BOOL(opus_encoder_init(m_opus_state, CONFIG_AUDIO_SAMPLING_FREQUENCY, 1, OPUS_APPLICATION) == OPUS_OK);
 
     APP_ERROR_CHECK_BOOL(opus_encoder_ctl(m_opus_state, OPUS_SET_BITRATE(m_opus_bitrate))                      == OPUS_OK);
@@ -160,6 +221,10 @@ void drv_audio_codec_encode(int16_t *input_samples, m_audio_frame_t *p_frame)
 
     APP_ERROR_CHECK_BOOL((frame_size >= 0) && (frame_size <= OPUS_MAX_FRAME_SIZE));
 
+#if CONFIG_STACK_PROFILER_ENABLED
+    drv_audio_codec_scratch_usage_update();
+#endif
+
 #if CONFIG_OPUS_HEADER_ENABLED
     p_frame->data[0] = frame_size >> 8;
     p_frame->data[1] = frame_size >> 0;
@@ -212,6 +277,13 @@ static void drv_audio_codec_info_cmd(nrf_cli_t const * p_cli, size_t argc, char
     }
 
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\tComplexity:\t%u\r\n", m_opus_complexity);
+
+#if CONFIG_STACK_PROFILER_ENABLED
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\tScratch Usage:\t%u bytes (maximum: %u out of %u bytes)\r\n",
+                    m_opus_scratch_usage,
+                    m_opus_scratch_max_usage,
+                    OPUS_SCRATCH_SIZE);
+#endif
 }
 
 static void drv_audio_codec_set_bitrate_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "nrf_assert.h"
+#include "app_error.h"
+#include "drv_audio_ns.h"
+#include "sr3_config.h"
+
+#if (CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_NS_ENABLED)
+
+#include "spns.h"
+
+#define NRF_LOG_MODULE_NAME drv_audio_ns
+#define NRF_LOG_LEVEL CONFIG_AUDIO_DRV_NS_LOG_LEVEL
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+#if ((CONFIG_AUDIO_NS_GAIN_FLOOR < 1) || (CONFIG_AUDIO_NS_GAIN_FLOOR > 100))
+#error "CONFIG_AUDIO_NS_GAIN_FLOOR must be in range <1-100>!"
+#endif
+
+static spns_t m_spns;
+
+void drv_audio_ns_init(void)
+{
+    APP_ERROR_CHECK_BOOL(spns_init(&m_spns, (CONFIG_AUDIO_NS_GAIN_FLOOR * 32767) / 100) == 0);
+
+    NRF_LOG_INFO("Noise suppression: %u bands, floor %u%%", SPNS_BANDS, CONFIG_AUDIO_NS_GAIN_FLOOR);
+}
+
+void drv_audio_ns_perform(int16_t *p_samples, unsigned int buffer_size)
+{
+    ASSERT(p_samples != NULL);
+
+    spns_process(&m_spns, p_samples, buffer_size);
+}
+
+#endif /* (CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_NS_ENABLED) */
@@ -79,7 +79,7 @@ STATIC_ASSERT(IS_IO_VALID(CONFIG_IO_PDM_MIC_PWR_CTRL));
 
 static nrf_balloc_t const *         mp_buffer_pool;
 static drv_audio_buffer_handler_t   m_buffer_handler;
-static uint8_t                      m_skip_buffers;
+static uint16_t                     m_skip_buffers;
 #if CONFIG_AUDIO_GAUGES_ENABLED
 static m_audio_loss_gauge_t         m_loss_gauge;
 #endif
@@ -96,8 +96,8 @@ ret_code_t drv_audio_enable(void)
 #endif /* CONFIG_PDM_MIC_PWR_CTRL_ENABLED */
 
     // Skip buffers with invalid data.
-    m_skip_buffers = MAX(1, ROUNDED_DIV(CONFIG_PDM_TRANSIENT_STATE_LEN,
-                                        CONFIG_AUDIO_FRAME_SIZE_MS));
+    m_skip_buffers = MAX(1, ROUNDED_DIV(CONFIG_PDM_TRANSIENT_STATE_LEN * CONFIG_PDM_REAL_SAMPLING_FREQUENCY,
+                                        1000ul * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES));
 
 #if CONFIG_AUDIO_GAUGES_ENABLED
     // Reset driver data loss gauge.
@@ -279,8 +279,8 @@ static void drv_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\tCapture time:\t\t%u:%02u\r\n",
-                    buffers_total * CONFIG_AUDIO_FRAME_SIZE_SAMPLES / CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY / 60,
-                    buffers_total * CONFIG_AUDIO_FRAME_SIZE_SAMPLES / CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY % 60);
+                    buffers_total * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES / CONFIG_PDM_REAL_SAMPLING_FREQUENCY / 60,
+                    buffers_total * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES / CONFIG_PDM_REAL_SAMPLING_FREQUENCY % 60);
 
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "nrf_assert.h"
+#include "app_util.h"
+#include "drv_audio_src.h"
+#include "sr3_config.h"
+
+#if (CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_SRC_ENABLED)
+
+#include "sinc_resampler.h"
+
+#define NRF_LOG_MODULE_NAME drv_audio_src
+#define NRF_LOG_LEVEL CONFIG_AUDIO_DRV_SRC_LOG_LEVEL
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+/* The buffer is sized for the lowest output frequency, which needs the longest filter. */
+#define SRC_BUFFER_SIZE SINC_RESAMPLER_BUFFER_SIZE(CONFIG_AUDIO_BLOCK_SIZE_SAMPLES,         \
+                                                   CONFIG_PDM_REAL_SAMPLING_FREQUENCY,      \
+                                                   DRV_AUDIO_SRC_MIN_FREQUENCY)
+
+static sinc_resampler_t  m_resampler;
+static int16_t      m_buffer[SRC_BUFFER_SIZE];
+
+ret_code_t drv_audio_src_init(uint32_t frequency)
+{
+    if ((frequency < DRV_AUDIO_SRC_MIN_FREQUENCY) || (frequency > DRV_AUDIO_SRC_MAX_FREQUENCY))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (sinc_resampler_init(&m_resampler, m_buffer, ARRAY_SIZE(m_buffer),
+                       CONFIG_PDM_REAL_SAMPLING_FREQUENCY, frequency) != 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    NRF_LOG_INFO("Sample rate conversion: %u Hz -> %u Hz", CONFIG_PDM_REAL_SAMPLING_FREQUENCY, frequency);
+
+    return NRF_SUCCESS;
+}
+
+void drv_audio_src_write(const int16_t *p_samples, unsigned int count)
+{
+    ASSERT(p_samples != NULL);
+
+    if (sinc_resampler_write(&m_resampler, p_samples, count) != count)
+    {
+        NRF_LOG_WARNING("Input buffer overflow. Discarding samples.");
+    }
+}
+
+unsigned int drv_audio_src_read(int16_t *p_samples, unsigned int count)
+{
+    ASSERT(p_samples != NULL);
+
+    return sinc_resampler_read(&m_resampler, p_samples, count);
+}
+
+#endif /* (CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_SRC_ENABLED) */
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ *
+ * @defgroup DRV_AUDIO_SRC Audio Sample Rate Conversion
+ * @{
+ * @ingroup  MOD_AUDIO
+ * @brief Conversion of captured audio from the PDM sampling frequency to the codec sampling frequency.
+ */
+#ifndef __DRV_AUDIO_SRC_H__
+#define __DRV_AUDIO_SRC_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+/**@brief Lowest supported output sampling frequency. */
+#define DRV_AUDIO_SRC_MIN_FREQUENCY     8000
+
+/**@brief Highest supported output sampling frequency. */
+#define DRV_AUDIO_SRC_MAX_FREQUENCY     48000
+
+/**@brief Initialize Sample Rate Conversion.
+ *
+ * @param[in] frequency     Output sampling frequency.
+ *
+ * @return NRF_SUCCESS              Conversion initialized.
+ * @return NRF_ERROR_INVALID_PARAM  Unsupported sampling frequency.
+ */
+ret_code_t drv_audio_src_init(uint32_t frequency);
+
+/**@brief Feed captured samples to Sample Rate Conversion.
+ *
+ * @details Output produced from the previous input should be read with @ref drv_audio_src_read first.
+ *
+ * @param[in] p_samples     Pointer to samples at the PDM sampling frequency.
+ * @param[in] count         Number of samples, at most CONFIG_AUDIO_BLOCK_SIZE_SAMPLES.
+ */
+void drv_audio_src_write(const int16_t *p_samples, unsigned int count);
+
+/**@brief Read converted samples.
+ *
+ * @param[out] p_samples    Pointer to the buffer for samples at the output sampling frequency.
+ * @param[in]  count        Maximum number of samples to read.
+ *
+ * @return Number of samples read. Less than @p count means that all input has been converted.
+ */
+unsigned int drv_audio_src_read(int16_t *p_samples, unsigned int count);
+
+#endif /** __DRV_AUDIO_SRC_H__ */
+/** @} */
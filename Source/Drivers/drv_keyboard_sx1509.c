@@ -49,6 +49,7 @@
 
 #include "app_debug.h"
 #include "app_error.h"
+#include "app_gpiote.h"
 #include "app_timer.h"
 
 #include "drv_keyboard.h"
@@ -68,6 +69,28 @@ NRF_LOG_MODULE_REGISTER();
 #define KEYBOARD_NUM_OF_COLUMNS 8   //!< Number of columns in the keyboard matrix.
 #define KEYBOARD_NUM_OF_ROWS    8   //!< Number of rows in the keyboard matrix.
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+// Check pin configuration.
+STATIC_ASSERT(IS_IO_VALID(CONFIG_IO_KBD_SX1509_NINT));
+
+#define KEYPAD_SCAN_TIME_MS     (1ul << CONFIG_KBD_SX1509_SCAN_TIME)    //!< Time the keypad engine spends on each row.
+
+/**@brief Time without NINT after which the reported key is considered released.
+ *
+ * @details The keypad engine asserts NINT on every scan cycle as long as a key is held.
+ *          Allow two full cycles before reporting the release.
+ */
+#define KEYPAD_RELEASE_TIMEOUT  APP_TIMER_TICKS(2 * KEYBOARD_NUM_OF_ROWS * KEYPAD_SCAN_TIME_MS)
+
+/**@brief Keyboard driver modes. */
+typedef enum
+{
+    DRV_KEYBOARD_MODE_DISABLED, //!< Keyboard scanning is disabled.
+    DRV_KEYBOARD_MODE_ENGINE,   //!< The SX1509 keypad engine scans the matrix and signals key presses on NINT.
+    DRV_KEYBOARD_MODE_POLL,     //!< The matrix is polled column by column.
+} drv_keyboard_mode_t;
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
+
 /**@brief SX1509 configuration */
 static const uint8_t m_register_config[][2] =
 {
@@ -85,6 +108,53 @@ static const uint8_t m_register_config[][2] =
 /**@brief Address of RegDataA register */
 static uint8_t m_RegDataA = RegDataA;
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+/**@brief Address of RegKeyData1 register */
+static uint8_t m_RegKeyData1 = RegKeyData1;
+
+/**@brief SX1509 configuration switching from the keypad engine to column polling. */
+static uint8_t m_poll_config[][2] =
+{
+    { RegKeyConfig2,       0x00 }, // Turn the keypad engine off.
+    { RegDebounceEnableB,  0x00 }, // Disable debouncing on Port B (columns).
+    { RegClock,            0x00 }, // Turn the oscillator off.
+    { RegDirA,             0xFF }, // Set Port A (rows) pins as inputs.
+    { RegOpenDrainA,       0x00 }, // Set Port A (rows) pins as push-pull.
+    { RegPullUpA,          0xFF }, // Enable pull-ups on Port A (rows).
+    { RegPolarityA,        0xFF }, // Enable polarity inversion on Port A (rows).
+    { RegPullUpB,          0x00 }, // Disable pull-ups on Port B (columns).
+    { RegPolarityB,        0xFF }, // Enable polarity inversion on Port B (columns).
+    { RegDataB,            0x00 }, // Do not drive Port B (columns).
+    { RegOpenDrainB,       0xFF }, // Set Port B (columns) pins as open-drain.
+    { RegDirB,             0x00 }, // Set Port B (columns) pins as outputs.
+    { RegInputDisableB,    0xFF }, // Disable inputs on Port B (columns).
+};
+
+/**@brief SX1509 configuration switching from column polling to the keypad engine.
+ *
+ * @note The keypad engine drives Port A (rows) and senses Port B (columns).
+ */
+static uint8_t m_engine_config[][2] =
+{
+    { RegDataB,            0x00 }, // Do not drive Port B (columns).
+    { RegDirB,             0xFF }, // Set Port B (columns) pins as inputs.
+    { RegInputDisableB,    0x00 }, // Enable inputs on Port B (columns).
+    { RegOpenDrainB,       0x00 }, // Set Port B (columns) pins as push-pull.
+    { RegPolarityB,        0x00 }, // Disable polarity inversion on Port B (columns).
+    { RegPullUpB,          0xFF }, // Enable pull-ups on Port B (columns).
+    { RegPolarityA,        0x00 }, // Disable polarity inversion on Port A (rows).
+    { RegPullUpA,          0x00 }, // Disable pull-ups on Port A (rows).
+    { RegOpenDrainA,       0xFF }, // Set Port A (rows) pins as open-drain.
+    { RegDirA,             0x00 }, // Set Port A (rows) pins as outputs.
+    { RegClock,            0x40 }, // Use the internal 2 MHz oscillator.
+    { RegMisc,             0x10 }, // ClkX = fOSC.
+    { RegDebounceConfig,   CONFIG_KBD_SX1509_SCAN_TIME },  // Debounce time: half of the row scan time.
+    { RegDebounceEnableB,  0xFF }, // Enable debouncing on Port B (columns).
+    { RegKeyConfig1,       (CONFIG_KBD_SX1509_AUTO_SLEEP << 4) | CONFIG_KBD_SX1509_SCAN_TIME }, // Auto sleep and row scan time.
+    { RegKeyConfig2,       ((KEYBOARD_NUM_OF_ROWS - 1) << 3) | (KEYBOARD_NUM_OF_COLUMNS - 1) }, // Matrix size. Turns the engine on.
+};
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
+
 /**@brief Column switch commands */
 static uint8_t m_col_switch[][2] =
 {
@@ -106,6 +176,13 @@ static bool                           m_keys_blocked;                         //
 static drv_keyboard_event_handler_t   m_keyboard_event_handler;               //!< Keyboard event handler.
 static nrf_atomic_flag_t              m_read_operation_active;                //!< Flag protecting shared data used in read operation.
 static uint8_t                        m_row_state[KEYBOARD_NUM_OF_COLUMNS];   //!< Buffer for row state.
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+APP_TIMER_DEF                         (m_release_timer);
+static app_gpiote_user_id_t           m_keyboard_gpiote;                      //!< GPIOTE Handle.
+static drv_keyboard_mode_t            m_keyboard_mode;                        //!< Current driver mode.
+static nrf_atomic_flag_t              m_key_data_pending;                     //!< NINT was asserted while the bus transaction was active.
+static uint8_t                        m_key_data[2];                          //!< Buffer for RegKeyData1 (columns) and RegKeyData2 (rows).
+#endif
 
 /**@brief TWI transfers performing keyboard scan */
 static const nrf_twi_mngr_transfer_t s_scan_transfers[] =
@@ -145,6 +222,61 @@ static const nrf_twi_mngr_transfer_t s_scan_transfers[] =
     NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_col_switch[8][0]), 2, 0),
 };
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+/**@brief TWI transfers reading the key reported by the keypad engine. Reading also releases NINT. */
+static const nrf_twi_mngr_transfer_t s_key_data_transfers[] =
+{
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &m_RegKeyData1,        1, NRF_TWI_MNGR_NO_STOP),
+    NRF_TWI_MNGR_READ   (SX1509_TWI_ADDRESS, &(m_key_data[0]),      2, 0),
+};
+
+/**@brief TWI transfers switching to column polling */
+static const nrf_twi_mngr_transfer_t s_poll_enter_transfers[] =
+{
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[0][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[1][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[2][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[3][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[4][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[5][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[6][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[7][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[8][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[9][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[10][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[11][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_poll_config[12][0]), 2, 0),
+};
+
+/**@brief TWI transfers switching to the keypad engine. The pending key data is read and NINT released at the end. */
+static const nrf_twi_mngr_transfer_t s_engine_enter_transfers[] =
+{
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[0][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[1][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[2][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[3][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[4][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[5][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[6][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[7][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[8][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[9][0]),  2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[10][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[11][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[12][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[13][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[14][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &(m_engine_config[15][0]), 2, 0),
+    NRF_TWI_MNGR_WRITE  (SX1509_TWI_ADDRESS, &m_RegKeyData1,            1, NRF_TWI_MNGR_NO_STOP),
+    NRF_TWI_MNGR_READ   (SX1509_TWI_ADDRESS, &(m_key_data[0]),          2, 0),
+};
+
+STATIC_ASSERT(ARRAY_SIZE(s_poll_enter_transfers) == ARRAY_SIZE(m_poll_config));
+STATIC_ASSERT(ARRAY_SIZE(s_engine_enter_transfers) == ARRAY_SIZE(m_engine_config) + 2);
+
+static void drv_keyboard_engine_enter(void);
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
+
 /**@brief HAL TWI callback processing keyboard scan result */
 static void drv_keyboard_process_scan_result(ret_code_t status, void *p_user_data)
 {
@@ -189,6 +321,20 @@ static void drv_keyboard_process_scan_result(ret_code_t status, void *p_user_dat
         blocking_mask |= m_row_state[column];
     }
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+    if ((m_keyboard_mode == DRV_KEYBOARD_MODE_POLL) && (m_key_vector_size == 0) && !m_keys_blocked)
+    {
+        // All keys are released: hand the matrix back to the keypad engine.
+        APP_ERROR_CHECK(app_timer_stop(m_keyboard_timer));
+        if (callback != NULL)
+        {
+            callback(m_key_vector, m_key_vector_size, m_keys_blocked);
+        }
+        drv_keyboard_engine_enter();
+        return;
+    }
+#endif
+
     nrf_atomic_flag_clear(&m_read_operation_active);
     if (callback != NULL)
     {
@@ -221,10 +367,188 @@ static ret_code_t drv_keyboard_schedule_scan(drv_keyboard_event_handler_t callba
     return status;
 }
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+/**@brief Schedule a TWI transaction while the read operation flag is held. */
+static void drv_keyboard_transaction_schedule(nrf_twi_mngr_transfer_t const *p_transfers,
+                                              uint8_t number_of_transfers,
+                                              nrf_twi_mngr_callback_t callback)
+{
+    static nrf_twi_mngr_transaction_t transaction;
+
+    transaction.callback            = callback;
+    transaction.p_user_data         = NULL;
+    transaction.p_transfers         = p_transfers;
+    transaction.number_of_transfers = number_of_transfers;
+    transaction.p_required_twi_cfg  = &g_twi_bus_config[CONFIG_KBD_TWI_BUS];
+
+    APP_ERROR_CHECK(twi_schedule(&transaction));
+}
+
+/**@brief Return the index of the only bit set in the mask, or -1 if not exactly one bit is set. */
+static int drv_keyboard_single_bit(uint8_t mask)
+{
+    if ((mask == 0) || ((mask & (mask - 1)) != 0))
+    {
+        return -1;
+    }
+
+    return 31 - __CLZ(mask);
+}
+
+/**@brief HAL TWI callback that starts column polling once the matrix is reconfigured. */
+static void drv_keyboard_poll_started(ret_code_t status, void *p_user_data)
+{
+    APP_ERROR_CHECK(status);
+
+    nrf_atomic_flag_clear(&m_read_operation_active);
+
+    if (m_keyboard_mode == DRV_KEYBOARD_MODE_POLL)
+    {
+        APP_ERROR_CHECK(app_timer_start(m_keyboard_timer,
+                                        APP_TIMER_TICKS(CONFIG_KBD_POLL_INTERVAL),
+                                        (void *)m_keyboard_event_handler));
+    }
+}
+
+/**@brief Switch to column polling. Must be called with the read operation flag held. */
+static void drv_keyboard_poll_enter(void)
+{
+    NRF_LOG_DEBUG("Keypad engine: several keys held, polling the matrix");
+
+    m_keyboard_mode = DRV_KEYBOARD_MODE_POLL;
+    APP_ERROR_CHECK(app_timer_stop(m_release_timer));
+
+    drv_keyboard_transaction_schedule(s_poll_enter_transfers,
+                                      ARRAY_SIZE(s_poll_enter_transfers),
+                                      drv_keyboard_poll_started);
+}
+
+/**@brief HAL TWI callback processing the key reported by the keypad engine. */
+static void drv_keyboard_process_key_data(ret_code_t status, void *p_user_data)
+{
+    int row, column;
+
+    APP_ERROR_CHECK(status);
+
+    if (m_keyboard_mode != DRV_KEYBOARD_MODE_ENGINE)
+    {
+        nrf_atomic_flag_clear(&m_read_operation_active);
+        return;
+    }
+
+    // Key data is active low. RegKeyData1 holds the columns, RegKeyData2 the rows.
+    column = drv_keyboard_single_bit(~m_key_data[0]);
+    row    = drv_keyboard_single_bit(~m_key_data[1]);
+
+    if ((m_key_data[0] == 0xFF) || (m_key_data[1] == 0xFF))
+    {
+        // No key reported.
+    }
+    else if ((row < 0) ||
+             (column < 0) ||
+             ((m_key_vector_size != 0) && (m_key_vector[0] != KEYBOARD_KEY_ID(row, column))))
+    {
+        // Several keys are held. Let the column scan resolve them and detect blocked keys.
+        drv_keyboard_poll_enter();
+        return;
+    }
+    else
+    {
+        // The key is held as long as the engine keeps reporting it.
+        APP_ERROR_CHECK(app_timer_stop(m_release_timer));
+        APP_ERROR_CHECK(app_timer_start(m_release_timer, KEYPAD_RELEASE_TIMEOUT, NULL));
+
+        if (m_key_vector_size == 0)
+        {
+            m_key_vector[0]   = KEYBOARD_KEY_ID(row, column);
+            m_key_vector_size = 1;
+            m_keys_blocked    = false;
+
+            m_keyboard_event_handler(m_key_vector, m_key_vector_size, m_keys_blocked);
+        }
+    }
+
+    if (nrf_atomic_flag_clear_fetch(&m_key_data_pending))
+    {
+        // NINT was asserted during this transaction.
+        drv_keyboard_transaction_schedule(s_key_data_transfers,
+                                          ARRAY_SIZE(s_key_data_transfers),
+                                          drv_keyboard_process_key_data);
+        return;
+    }
+
+    nrf_atomic_flag_clear(&m_read_operation_active);
+}
+
+/**@brief Switch to the keypad engine. Must be called with the read operation flag held. */
+static void drv_keyboard_engine_enter(void)
+{
+    m_keyboard_mode = DRV_KEYBOARD_MODE_ENGINE;
+    nrf_atomic_flag_clear(&m_key_data_pending);
+
+    drv_keyboard_transaction_schedule(s_engine_enter_transfers,
+                                      ARRAY_SIZE(s_engine_enter_transfers),
+                                      drv_keyboard_process_key_data);
+}
+
+/**@brief NINT handler. Reads the key data from the keypad engine. */
+static void drv_keyboard_interrupt_handler(uint32_t const *p_event_pins_low_to_high,
+                                           uint32_t const *p_event_pins_high_to_low)
+{
+    if (m_keyboard_mode != DRV_KEYBOARD_MODE_ENGINE)
+    {
+        return;
+    }
+
+    if (nrf_atomic_flag_set_fetch(&m_read_operation_active))
+    {
+        // Read the key data as soon as the current transaction is finished.
+        nrf_atomic_flag_set(&m_key_data_pending);
+        return;
+    }
+
+    drv_keyboard_transaction_schedule(s_key_data_transfers,
+                                      ARRAY_SIZE(s_key_data_transfers),
+                                      drv_keyboard_process_key_data);
+}
+
+/**@brief Reports the key released when the keypad engine stops reporting it. */
+static void drv_keyboard_release_timer_handler(void *p_context)
+{
+    if (m_keyboard_mode != DRV_KEYBOARD_MODE_ENGINE)
+    {
+        return;
+    }
+
+    if (nrf_atomic_flag_set_fetch(&m_read_operation_active))
+    {
+        // Key data is being read right now. Check again later.
+        APP_ERROR_CHECK(app_timer_start(m_release_timer, KEYPAD_RELEASE_TIMEOUT, NULL));
+        return;
+    }
+
+    if (m_key_vector_size != 0)
+    {
+        m_key_vector_size = 0;
+        m_keyboard_event_handler(m_key_vector, m_key_vector_size, false);
+    }
+
+    nrf_atomic_flag_clear(&m_read_operation_active);
+}
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
+
 static void drv_keyboard_timer_handler(void *p_context)
 {
     ret_code_t status;
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+    if (m_keyboard_mode != DRV_KEYBOARD_MODE_POLL)
+    {
+        // Timeout queued before the matrix was handed back to the keypad engine.
+        return;
+    }
+#endif
+
     status = drv_keyboard_schedule_scan((drv_keyboard_event_handler_t)(p_context));
     if (status == NRF_ERROR_BUSY)
     {
@@ -271,6 +595,31 @@ ret_code_t drv_keyboard_init(drv_keyboard_event_handler_t keyboard_event_handler
     nrf_atomic_flag_clear(&m_read_operation_active);
     m_keyboard_event_handler = keyboard_event_handler;
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+    uint32_t low_to_high_mask = 0;
+    uint32_t high_to_low_mask = (1ul << CONFIG_IO_KBD_SX1509_NINT);
+
+    m_keyboard_mode = DRV_KEYBOARD_MODE_DISABLED;
+    nrf_atomic_flag_clear(&m_key_data_pending);
+
+    status = app_gpiote_user_register(&m_keyboard_gpiote,
+                                      &low_to_high_mask,
+                                      &high_to_low_mask,
+                                      drv_keyboard_interrupt_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    status = app_timer_create(&m_release_timer,
+                              APP_TIMER_MODE_SINGLE_SHOT,
+                              drv_keyboard_release_timer_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
+
     return app_timer_create(&m_keyboard_timer,
                             APP_TIMER_MODE_REPEATED,
                             drv_keyboard_timer_handler);
@@ -303,6 +652,57 @@ ret_code_t drv_keyboard_keys_get(uint8_t *p_pressed_keys,
     return NRF_SUCCESS;
 }
 
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+ret_code_t drv_keyboard_enable(void)
+{
+    ret_code_t status;
+
+    if (nrf_atomic_flag_set_fetch(&m_read_operation_active))
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    status = app_gpiote_user_enable(m_keyboard_gpiote);
+    if (status != NRF_SUCCESS)
+    {
+        nrf_atomic_flag_clear(&m_read_operation_active);
+        return status;
+    }
+
+    if (m_key_vector_size != 0)
+    {
+        // Keys held since the last scan: poll until they are released.
+        drv_keyboard_poll_enter();
+    }
+    else
+    {
+        drv_keyboard_engine_enter();
+    }
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_keyboard_disable(void)
+{
+    ret_code_t status;
+
+    m_keyboard_mode = DRV_KEYBOARD_MODE_DISABLED;
+
+    status = app_gpiote_user_disable(m_keyboard_gpiote);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    status = app_timer_stop(m_release_timer);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    return app_timer_stop(m_keyboard_timer);
+}
+#else /* !CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
 ret_code_t drv_keyboard_enable(void)
 {
     return app_timer_start(m_keyboard_timer,
@@ -314,6 +714,7 @@ ret_code_t drv_keyboard_disable(void)
 {
     return app_timer_stop(m_keyboard_timer);
 }
+#endif /* CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED */
 
 #if CONFIG_PWR_MGMT_ENABLED
 bool drv_keyboard_shutdown(bool wakeup)
@@ -52,13 +52,17 @@
 
 #include "sdk_errors.h"
 
-/**@brief Touchpad output data.  */
+/**@brief Touchpad output data.
+ *
+ * @note Motion is given in HID relative units, i.e. pixels multiplied by HID_REL_POINTER_SCALE
+ *       and wheel detents multiplied by HID_REL_WHEEL_SCALE.
+ */
 typedef struct
 {
     int16_t x;
     int16_t y;
-    int8_t  scroll;
-    int8_t  pan;
+    int16_t scroll;
+    int16_t pan;
 
     bool    tap;
 } drv_touchpad_data_t;
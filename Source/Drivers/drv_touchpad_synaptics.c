@@ -53,6 +53,7 @@
 
 #include "twi_common.h"
 #include "resources.h"
+#include "sr3_config.h"
 
 #if CONFIG_TOUCHPAD_ENABLED
 
@@ -180,8 +181,8 @@ static void touchpad_read_callback(ret_code_t status, void *p_user_data)
     {
         p_data->x       = 0;
         p_data->y       = 0;
-        p_data->scroll  = (int8_t) m_buffer[6] / 2;
-        p_data->pan     = (int8_t) m_buffer[5] / 2;
+        p_data->scroll  = (int8_t) m_buffer[6] * HID_REL_WHEEL_SCALE / 2;
+        p_data->pan     = (int8_t) m_buffer[5] * HID_REL_WHEEL_SCALE / 2;
     }
     else
     {
@@ -189,11 +190,11 @@ static void touchpad_read_callback(ret_code_t status, void *p_user_data)
         // m_x = x*sqrt(abs(x)); m_y = y*sqrt(abs(y)
         x32f = (float)((int8_t)m_buffer[0]);
         arm_sqrt_f32(x32f * (x32f < 0 ? -1 : 1), &sqrtf);
-        p_data->x = (int16_t)(x32f * sqrtf);
+        p_data->x = (int16_t)(x32f * sqrtf * HID_REL_POINTER_SCALE);
 
         y32f = (float)((int8_t)m_buffer[1]);
         arm_sqrt_f32(y32f * (y32f < 0 ? -1 : 1), &sqrtf);
-        p_data->y = -(int16_t)(y32f * sqrtf);
+        p_data->y = -(int16_t)(y32f * sqrtf * HID_REL_POINTER_SCALE);
 
         p_data->scroll  = 0;
         p_data->pan     = 0;
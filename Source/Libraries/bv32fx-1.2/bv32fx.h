@@ -0,0 +1,80 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx.h: BV32 fixed-point encoder interface
+
+  $Log$
+******************************************************************************/
+
+#ifndef  BV32FX_H
+#define  BV32FX_H
+
+/*
+ * The fixed-point encoder produces the same bit stream format as the
+ * floating-point reference and shares its constants, bit stream structure
+ * and bit packing (bv32cnst.h, bv32strct.h, bitpack.c) from bv32fp-1.2.
+ * It is not bit-exact: quantizer indices often differ from the reference,
+ * while the decoded SNR stays within 0.5 dB of it (Tests/bv32fx).
+ *
+ * Signal buffers hold 16-bit PCM scaled to Q6 in 32-bit words, LPC
+ * coefficients are Q24, LSPs are Q19 and log-gains are Q16.
+ */
+
+#include <stdint.h>
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+
+struct BV32FX_Encoder_State {
+int32_t	x[XOFF];		/* high-pass filtered input, Q6 */
+int32_t	xwd[XDOFF];		/* memory of DECF:1 decimated version of xw(), Q4 */
+int32_t	dq[XOFF];		/* quantized short-term pred error, Q6 */
+int32_t	dfm[DFO];		/* decimated xwd() filter memory, Q4 */
+int32_t	stpem[LPCO];		/* ST Pred. Error filter memory, Q6 */
+int32_t	stwpm[LPCO];		/* ST Weighting all-Pole Memory, Q6 */
+int32_t	stnfm[LPCO];		/* ST Noise Feedback filter Memory, Q6 */
+int32_t	ltsym[MAXPP1+FRSZ];	/* long-term synthesis filter memory, Q6 */
+int32_t	ltnfm[MAXPP1+FRSZ];	/* long-term noise feedback filter memory, Q6 */
+int32_t	lsppm[LPCO*LSPPORDER];	/* LSP Predictor Memory, Q19 */
+int32_t	allast[LPCO+1];		/* LPC of previous frame, Q24 */
+int32_t	lsplast[LPCO];		/* LSP of previous frame, Q19 */
+int32_t	lgpm[LGPORDER];		/* log-gain predictor memory, Q16 */
+int32_t	hpfzm[HPO];
+int32_t	hpfpm[HPO];
+int32_t	prevlg[2];		/* Q16 */
+int32_t	lmax;			/* level-adaptation, Q16 */
+int32_t	lmin;
+int32_t	lmean;
+int32_t	x1;
+int32_t	level;
+int cpplast;		/* pitch period pf the previous frame */
+};
+
+extern void Reset_BV32FX_Coder(
+struct BV32FX_Encoder_State *cs);
+
+extern void BV32FX_Encode(
+struct BV32_Bit_Stream *bs,
+struct BV32FX_Encoder_State *cs,
+short  *inx);
+
+#endif /* BV32FX_H */
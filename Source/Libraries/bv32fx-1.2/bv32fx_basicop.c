@@ -0,0 +1,194 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx_basicop.c: BV32 fixed-point basic operators
+
+  $Log$
+******************************************************************************/
+
+#include <stdint.h>
+#include "bv32fxlib.h"
+
+#define PI_Q29  1686629713L     /* pi, Q29 */
+
+/* Number of significant bits of x (0 for x == 0) */
+int bvfx_bitlen(uint64_t x)
+{
+   int n = 0;
+
+   if (x >> 32) { x >>= 32; n += 32; }
+   if (x >> 16) { x >>= 16; n += 16; }
+   if (x >> 8)  { x >>= 8;  n += 8; }
+   if (x >> 4)  { x >>= 4;  n += 4; }
+   if (x >> 2)  { x >>= 2;  n += 2; }
+   if (x >> 1)  { x >>= 1;  n += 1; }
+   return n + (int)x;
+}
+
+/* Scale x by 2^-shift (rounding right shift or left shift) */
+int32_t bvfx_scale(int64_t x, int shift)
+{
+   if (shift > 0)
+      return (int32_t)BVFX_RND(x, shift);
+   return (int32_t)(x << -shift);
+}
+
+/*
+ * Compare x1*y1 > x2*y2 for y1, y2 >= 0 without overflowing. The x pair is
+ * scaled by a common power of two, so the result is exact up to the 31 most
+ * significant bits of the larger x.
+ */
+int bvfx_gt(int64_t x1, int32_t y1, int64_t x2, int32_t y2)
+{
+   uint64_t m1 = (x1 < 0) ? -(uint64_t)x1 : (uint64_t)x1;
+   uint64_t m2 = (x2 < 0) ? -(uint64_t)x2 : (uint64_t)x2;
+   int s = bvfx_bitlen(m1 | m2) - 31;
+
+   if (s > 0) {
+      x1 >>= s;
+      x2 >>= s;
+   }
+   return (x1 * y1) > (x2 * y2);
+}
+
+/* log2(x) in Q16 for x > 0 */
+int32_t bvfx_log2(uint64_t x)
+{
+   uint64_t m;
+   int32_t frac = 0;
+   int n, i;
+
+   n = bvfx_bitlen(x) - 1;
+   m = (n >= 30) ? (x >> (n - 30)) : (x << (30 - n));  /* [1, 2) in Q30 */
+
+   /* one fraction bit per squaring */
+   for (i = 0; i < 16; i++) {
+      m = (m * m) >> 30;
+      frac <<= 1;
+      if (m >= ((uint64_t)1 << 31)) {
+         m >>= 1;
+         frac |= 1;
+      }
+   }
+   return (n << 16) + frac;
+}
+
+/* 2^x for x in Q16; the result is an integer (saturated to 32 bits) */
+int32_t bvfx_pow2(int32_t x)
+{
+   static const int32_t c[] = {
+      1073741824, 744261118, 257941248, 59597083, 10327387,
+      1431680, 165394, 16377, 1419};    /* ln(2)^k / k!, Q30 */
+   int64_t acc, f;
+   int n, k;
+
+   n = x >> 16;
+   f = (int64_t)(x & 0xFFFF) << 14;    /* fraction, Q30 */
+   acc = c[8];
+   for (k = 7; k >= 0; k--)
+      acc = c[k] + ((acc * f) >> 30);   /* 2^f in [1, 2), Q30 */
+
+   if (n >= 31)
+      return INT32_MAX;
+   if (n < -32)
+      return 0;
+   if (n < 30)
+      return (int32_t)BVFX_RND(acc, 30 - n);
+   return bvfx_sat32(acc << (n - 30));
+}
+
+/* cos(pi * u) in Q30 for u in [0, 1], Q19 */
+int32_t bvfx_cospi(int32_t u)
+{
+   static const int32_t cc[] = {
+      1073741824, -536870912, 44739243, -1491308, 26631, -296};
+   static const int32_t sc[] = {
+      1073741824, -178956971, 8947849, -213044, 2959};
+   int64_t t, z, acc;
+   int32_t sign = 1;
+   int k;
+
+   t = (int64_t)u << 11;               /* Q30 */
+   if (t > (1L << 29)) {                /* cos(pi*u) = -cos(pi*(1-u)) */
+      t = (1L << 30) - t;
+      sign = -1;
+   }
+
+   if (t <= (1L << 28)) {               /* cos(theta), theta <= pi/4 */
+      t = (t * PI_Q29) >> 29;
+      z = (t * t) >> 30;
+      acc = cc[5];
+      for (k = 4; k >= 0; k--)
+         acc = cc[k] + ((acc * z) >> 30);
+   } else {                             /* sin(pi/2 - theta) */
+      t = (((1L << 29) - t) * PI_Q29) >> 29;
+      z = (t * t) >> 30;
+      acc = sc[4];
+      for (k = 3; k >= 0; k--)
+         acc = sc[k] + ((acc * z) >> 30);
+      acc = (acc * t) >> 30;
+   }
+   return sign * (int32_t)acc;
+}
+
+/* Integer square root */
+static uint32_t isqrt64(uint64_t x)
+{
+   uint64_t r = 0, b = (uint64_t)1 << 62;
+
+   while (b > x)
+      b >>= 2;
+   while (b != 0) {
+      if (x >= r + b) {
+         x -= r + b;
+         r = (r >> 1) + b;
+      } else {
+         r >>= 1;
+      }
+      b >>= 2;
+   }
+   return (uint32_t)r;
+}
+
+/*
+ * acos(x) / pi in Q30 for x in [-1, 1], Q30. Uses the polynomial
+ * approximation 4.4.46 of Abramowitz and Stegun (|error| <= 2e-8).
+ */
+int32_t bvfx_acospi(int32_t x)
+{
+   static const int32_t c[] = {
+      536870905, -73346144, 30411473, -17148706,
+      10558309, -5840425, 2279721, -431498};    /* a_k / pi, Q30 */
+   int64_t acc, ax;
+   uint32_t s;
+   int k;
+
+   ax = (x < 0) ? -(int64_t)x : x;
+   if (ax > (1L << 30))
+      ax = 1L << 30;
+   acc = c[7];
+   for (k = 6; k >= 0; k--)
+      acc = c[k] + ((acc * ax) >> 30);
+   s = isqrt64((uint64_t)((1L << 30) - ax) << 30);    /* sqrt(1-|x|), Q30 */
+   acc = ((int64_t)s * acc) >> 30;
+
+   return (x < 0) ? (int32_t)((1L << 30) - acc) : (int32_t)acc;
+}
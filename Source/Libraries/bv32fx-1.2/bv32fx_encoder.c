@@ -0,0 +1,159 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx_encoder.c: BV32 Fixed-Point Encoder Main Subroutines
+
+  $Log$
+******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "bv32fxlib.h"
+
+#define MINE_Q16        (-(2L << 16))     /* MinE */
+#define TMINE_Q12       (10L << 12)     /* TMinE for a Q6 signal */
+#define LOG2_SFRSZ_Q16  348778          /* log2(SFRSZ) */
+#define LTWFL_Q15       16384           /* LTWFL */
+
+void Reset_BV32FX_Coder(struct BV32FX_Encoder_State *c)
+{
+   int k;
+
+   memset(c, 0, sizeof(*c));
+   c->allast[0] = BVFX_ONE_Q24;
+   for (k = 0; k < LPCO; k++)
+      c->lsplast[k] = ((int32_t)(k+1) << 19) / (LPCO+1);
+   c->cpplast = 12*cpp_scale;
+   c->prevlg[0] = MINE_Q16;
+   c->prevlg[1] = MINE_Q16;
+   c->lmax = -(100L << 16);
+   c->lmin = 100L << 16;
+   c->lmean = 8L << 16;
+   c->x1 = 27L << 15;      /* 13.5 */
+   c->level = 27L << 15;
+}
+
+void BV32FX_Encode(
+                   struct BV32_Bit_Stream *bs,
+                   struct BV32FX_Encoder_State *cs,
+                   short  *inx)
+{
+   int32_t x[LX];
+   int32_t dq[LX];
+   int32_t xw[FRSZ];
+   int32_t r[LPCO+1];
+   int32_t a[LPCO+1];
+   int32_t aw[LPCO+1];
+   int32_t lsp[LPCO];
+   int32_t lspq[LPCO];
+   int32_t cbs[VDIM*CBSZ];
+   int32_t qv[SFRSZ];
+   int32_t bq[3], beta;
+   int32_t gainq[2], lg, ppt;
+   int64_t e, ee;
+   int pp, cpp;
+   int i, issf;
+   int32_t *fp0, *fp1;
+
+   /* copy state memory to local memory buffers */
+   memcpy(x, cs->x, XOFF * sizeof(int32_t));
+   for (i = 0; i < FRSZ; i++) x[XOFF+i] = (int32_t)inx[i] << BVFX_SIG_Q;
+
+   /* highpass filtering & pre-emphasis filtering */
+   bvfx_azfilter(bvfx_hpfb, 14, HPO, x+XOFF, x+XOFF, FRSZ, cs->hpfzm, 1);
+   bvfx_apfilter(bvfx_hpfa, 14, HPO, x+XOFF, x+XOFF, FRSZ, cs->hpfpm, 1);
+
+   /* copy to coder state */
+   memcpy(cs->x, x+FRSZ, XOFF * sizeof(int32_t));
+
+   /* perform lpc analysis with asymmetrical window */
+   bvfx_autocor(r, x+LX-WINSZ);          /* windowed and smoothed lags */
+   bvfx_levinson(r, a, cs->allast);      /* Levinson-Durbin recursion */
+   for (i = 0; i <= LPCO; i++) a[i] = (int32_t)BVFX_RND((int64_t)a[i] * bvfx_bwel[i], 30);
+
+   bvfx_a2lsp(a, lsp, cs->lsplast);
+
+   bvfx_lspquan(lspq, bs->lspidx, lsp, cs->lsppm);
+
+   bvfx_lsp2a(lspq, a);
+
+   /* calculate lpc prediction residual */
+   memcpy(dq, cs->dq, XOFF * sizeof(int32_t));   /* copy dq() state to buffer */
+   bvfx_azfilter(a, 24, LPCO, x+XOFF, dq+XOFF, FRSZ, cs->stpem, 1);
+
+   /* use weighted version of lpc filter as noise feedback filter */
+   for (i = 0; i <= LPCO; i++) aw[i] = (int32_t)BVFX_RND((int64_t)a[i] * bvfx_stwal[i], 30);
+
+   /* get perceptually weighted version of speech */
+   bvfx_apfilter(aw, 24, LPCO, dq+XOFF, xw, FRSZ, cs->stwpm, 1);
+
+   /* get the coarse version of pitch period using 8:1 decimation */
+   cpp = bvfx_coarsepitch(xw, cs->xwd, cs->dfm, cs->cpplast);
+   cs->cpplast = cpp;
+
+   /* refine the pitch period in the neighborhood of coarse pitch period
+   also calculate the pitch predictor tap for single-tap predictor */
+   pp = bvfx_refinepitch(dq, cpp, &ppt);
+   bs->ppidx = (pp - MINPP);
+
+   /* vq 3 pitch predictor taps with minimum residual energy */
+   bs->bqidx = bvfx_pitchtapquan(dq, pp, bq);
+
+   /* get coefficients for long-term noise feedback filter (ppt is in [0, 1]) */
+   beta = (int32_t)(((int64_t)LTWFL_Q15 * ppt) >> 15);
+
+   /* Loop over excitation sub-frames */
+   for (issf = 0; issf < NSF; issf++) {
+
+      /* calculate pitch prediction residual */
+      fp0 = dq + XOFF + issf*SFRSZ;
+      fp1 = dq + XOFF + issf*SFRSZ - (pp-2) - 1;
+      ee = 0;
+      for (i = 0; i < SFRSZ; i++) {
+         e = ((int64_t)(*fp0++) << 15) - (int64_t)bq[0]*fp1[0] - (int64_t)bq[1]*fp1[-1] - (int64_t)bq[2]*fp1[-2];
+         e = BVFX_RND(e, 15);
+         fp1++;
+         ee += e*e;
+      }
+
+      /* log-gain quantization within each sub-frame */
+      lg = (ee < TMINE_Q12) ? MINE_Q16 : (bvfx_log2((uint64_t)ee) - (2*BVFX_SIG_Q << 16) - LOG2_SFRSZ_Q16);
+      bs->gidx[issf] = bvfx_gainquan(gainq+issf, lg, cs->lgpm, cs->prevlg, cs->level);
+
+      /* Level Estimation */
+      bvfx_estlevel(cs->prevlg[0], &cs->level, &cs->lmax, &cs->lmin,
+         &cs->lmean, &cs->x1);
+
+      /* scale the excitation codebook */
+      for (i = 0; i < (VDIM*CBSZ); i++) cbs[i] = bvfx_sat(BVFX_RND((int64_t)gainq[issf] * bvfx_cccb[i], 12 + 13 - BVFX_SIG_Q));
+
+      /* perform noise feedback coding of the excitation signal */
+      bvfx_excquan(qv, bs->qvidx+issf*NVPSSF, dq+XOFF+issf*SFRSZ,
+         aw, bq, beta, cs->ltsym, cs->ltnfm, cs->stnfm, cbs, pp);
+
+      /* update quantized short-term prediction residual buffer */
+      memcpy(dq+XOFF+issf*SFRSZ, qv, SFRSZ * sizeof(int32_t));
+   }
+
+   /* update state memory */
+   memcpy(cs->dq, dq+FRSZ, XOFF * sizeof(int32_t));
+   memcpy(cs->lsplast, lspq, LPCO * sizeof(int32_t));
+}
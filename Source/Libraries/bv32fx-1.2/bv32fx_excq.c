@@ -0,0 +1,292 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx_excq.c: BV32 fixed-point gain and excitation quantization
+
+  $Log$
+******************************************************************************/
+
+#include <stdint.h>
+#include "bv32fxlib.h"
+
+#define ESTL_TH_Q15  6554    /* 0.2 */
+
+/* Log-gain quantization; lg and the log-gain memories are Q16, *gainq is the linear gain in Q12 */
+int bvfx_gainquan(int32_t *gainq, int32_t lg, int32_t *lgpm, int32_t *prevlg, int32_t level)
+{
+   int32_t elg, lgpe, limit, gq, dmin = 0, d;
+   int64_t a0;
+   int i, n, gidx = 0;
+
+   /* CALCULATE ESTIMATED LOG-GAIN */
+   a0 = 0;
+   for (i = 0; i < LGPORDER; i++) {
+      a0 += (int64_t)bvfx_lgp[i] * lgpm[i];
+   }
+   elg = ((int32_t)bvfx_lgmean << 5) + (int32_t)BVFX_RND(a0, 15);
+
+   /* SUBTRACT LOG-GAIN MEAN & ESTIMATED LOG-GAIN TO GET PREDICTION ERROR */
+   lgpe = lg - elg;
+
+   /* SCALAR QUANTIZATION OF LOG-GAIN PREDICTION ERROR */
+   for (i = 0; i < LGPECBSZ; i++) {
+      d = lgpe - ((int32_t)bvfx_lgpecb[bvfx_idxord[i]] << 5);
+      if (d < 0) {
+         d = -d;
+      }
+      if (i == 0 || d < dmin) {
+         dmin = d;
+         /* index into ordered codebook */
+         gidx = i;
+      }
+   }
+
+   /* CALCULATE QUANTIZED LOG-GAIN */
+   gq = ((int32_t)bvfx_lgpecb[bvfx_idxord[gidx]] << 5) + elg;
+
+   /* LOOK UP FROM lgclimit() TABLE THE MAXIMUM LOG GAIN CHANGE ALLOWED */
+   i = (prevlg[0] - level - (LGLB * 65536L)) >> 17; /* get column index */
+   if (i >= NGB) {
+      i = NGB - 1;
+   } else if (i < 0) {
+      i = 0;
+   }
+   n = (prevlg[0] - prevlg[1] - (GCLB * 65536L)) >> 17;  /* get row index */
+   if (n >= NGCB) {
+      n = NGCB - 1;
+   } else if (n < 0) {
+      n = 0;
+   }
+   i = i * NGCB + n;
+
+   /* CHECK WHETHER QUANTIZED LOG-GAIN CAUSE A GAIN CHANGE > LGCLIMIT */
+   limit = prevlg[0] + ((int32_t)bvfx_lgclimit[i] << 7);
+   while (gq > limit && gidx > 0) { /* if quantized gain exceeds limit */
+      gidx -= 1;     /* decrement gain quantizer index by 1 */
+      gq = ((int32_t)bvfx_lgpecb[bvfx_idxord[gidx]] << 5) + elg;
+   }
+   /* get true codebook index */
+   gidx = bvfx_idxord[gidx];
+
+   /* UPDATE LOG-GAIN PREDICTOR MEMORY */
+   prevlg[1] = prevlg[0];
+   prevlg[0] = gq;
+   for (i = LGPORDER - 1; i > 0; i--) {
+      lgpm[i] = lgpm[i-1];
+   }
+   lgpm[0] = (int32_t)bvfx_lgpecb[gidx] << 5;
+
+   /* CONVERT QUANTIZED LOG-GAIN TO LINEAR DOMAIN */
+   *gainq = bvfx_pow2((gq >> 1) + (12L << 16));
+
+   return gidx;
+}
+
+/* Input level estimation, all values Q16 */
+void bvfx_estlevel(int32_t lg, int32_t *level, int32_t *lmax, int32_t *lmin,
+                   int32_t *lmean, int32_t *x1)
+{
+   int32_t lth;
+
+   /* UPDATE THE NEW MAXIMUM, MINIMUM, & MEAN OF LOG-GAIN */
+   if (lg > *lmax) *lmax = lg;	/* use new log-gain as max if it is > max */
+   else *lmax = *lmean + (int32_t)BVFX_RND((int64_t)(*lmax - *lmean) * 8191, 13);
+   if (lg < *lmin) *lmin = lg;	/* use new log-gain as min if it is < min */
+   else *lmin = *lmean + (int32_t)BVFX_RND((int64_t)(*lmin - *lmean) * 8191, 13);
+   *lmean = (int32_t)BVFX_RND((int64_t)*lmean * 2046 + *lmax + *lmin, 11);
+
+   /* UPDATE ESTIMATED INPUT LEVEL, BY CALCULATING A RUNNING AVERAGE
+   (USING AN EXPONENTIAL WINDOW) OF LOG-GAINS EXCEEDING lmean */
+   lth = *lmean + (int32_t)BVFX_RND((int64_t)(*lmax - *lmean) * ESTL_TH_Q15, 15);
+   if (lg > lth) {
+      *x1 = (int32_t)BVFX_RND((int64_t)*x1 * 511 + lg, 9);
+      *level = (int32_t)BVFX_RND((int64_t)*level * 511 + *x1, 9);
+   }
+}
+
+/* Noise feedback coding of the excitation; signals in Q6 */
+void bvfx_excquan(
+                  int32_t *qv,
+                  short   *idx,
+                  const int32_t *d,
+                  const int32_t *h,
+                  const int32_t *b,
+                  int32_t beta,
+                  int32_t *ltsym,
+                  int32_t *ltnfm,
+                  int32_t *stnfm,
+                  const int32_t *cb,
+                  int     pp)
+{
+   int32_t qzir[VDIM], zbuf[VDIM];
+   int32_t buf[LPCO+SFRSZ]; /* buffer for filter memory & signal */
+   int32_t ltfv[VDIM], ppv[VDIM];
+   int32_t qzsr[VDIM*CBSZ];
+   int32_t *fp1, *fp2, *fp3, *fp4, v;
+   const int32_t *cp;
+   int64_t a0, a1, E, Emin;
+   int32_t e, sign;
+   int i, j, m, n, jmin, iv;
+
+   /* COPY FILTER MEMORY TO BEGINNING PART OF TEMPORARY BUFFER */
+   fp1 = &stnfm[LPCO-1];
+   for (i = 0; i < LPCO; i++) {
+      buf[i] = *fp1--;    /* this buffer is used to avoid memory shifts */
+   }
+
+   /* COMPUTE CODEBOOK ZERO-STATE RESPONSE */
+   cp = cb;
+   fp3 = qzsr;
+   for (j = 0; j < CBSZ; j++) {
+      *fp3 = *cp++;	/* no multiply-add needed for 1st ZSR vector element*/
+      for (n = 1; n < VDIM; n++) { /* loop from 2nd to last vector element */
+         /* PERFORM MULTIPLY-ADDS ALONG THE DELAY LINE OF FILTER */
+         fp4 = fp3;  /* fp4 --> first element of current ZSR vector */
+         a0 = (int64_t)(*cp++) << 24;    /* initialize a0 to codebook element */
+         for (i = 0; i < n; i++) {
+            a0 -= (int64_t)(*fp4++) * h[n-i];
+         }
+         *fp4 = bvfx_sat(BVFX_RND(a0, 24));
+      }
+      fp3 += VDIM;    /* fp3 --> 1st element of next ZSR vector */
+   }
+
+   /* LOOP THROUGH EVERY VECTOR OF THE CURRENT SUBFRAME */
+   iv = 0;     /* iv = index of the current vector */
+   for (m = 0; m < SFRSZ; m += VDIM) {
+
+      /* COMPUTE PITCH-PREDICTED VECTOR, WHICH SHOULD BE INDEPENDENT OF THE
+      RESIDUAL VQ CODEVECTORS BEING TRIED IF VDIM < MIN. PITCH PERIOD */
+      for (n = m; n < m + VDIM; n++) {
+         fp1 = &ltsym[MAXPP1+n-pp+1];
+         a1  = (int64_t)b[0] * *fp1--;
+         a1 += (int64_t)b[1] * *fp1--;
+         a1 += (int64_t)b[2] * *fp1--;  /* a1=pitch predicted vector of LT syn filt */
+         ppv[n-m] = bvfx_sat(BVFX_RND(a1, 15));
+
+         a1 += (int64_t)beta * ltnfm[MAXPP1+n-pp];
+         ltfv[n-m] = bvfx_sat(BVFX_RND(a1, 15));
+      }
+
+      /* COMPUTE ZERO-INPUT RESPONSE */
+      for (n = m; n < m + VDIM; n++) {
+
+         /* PERFORM MULTIPLY-ADDS ALONG THE DELAY LINE OF FILTER */
+         fp1 = &buf[n];
+         a0 = (int64_t)d[n] << 24;
+         for (i = LPCO; i > 0; i--) {
+            a0 -= (int64_t)(*fp1++) * h[i];
+         }
+         v = bvfx_sat(BVFX_RND(a0, 24));
+
+         /* v NOW CONTAINS v[n]; SUBTRACT THE SUM OF THE TWO LONG_TERM
+         FILTERS TO GET THE ZERO-INPUT RESPONSE */
+         qzir[n-m] = v - ltfv[n-m];   /* q[n] = u[n] during ZIR computation */
+
+         /* UPDATE SHORT-TERM NOISE FEEDBACK FILTER MEMORY */
+         *fp1 = v - ppv[n-m];    /* qs[n] */
+      }
+
+      /* LOOP THROUGH EVERY CODEVECTOR OF THE RESIDUAL VQ CODEBOOK */
+      /* AND FIND THE ONE THAT MINIMIZES THE ENERGY OF q[n] */
+
+      Emin = INT64_MAX;
+      jmin = 0;
+      sign = 1;
+      fp4 = qzsr;
+      for (j = 0; j < CBSZ; j++) {
+         /* Try positive sign */
+         fp2 = qzir;
+         E = 0;
+         for (n = 0; n < VDIM; n++) {
+            e = *fp2++ - *fp4++;
+            E += (int64_t)e * e;
+         }
+         if (E < Emin) {
+            jmin = j;
+            Emin = E;
+            sign = 1;
+         }
+         /* Try negative sign */
+         fp4 -= VDIM;
+         fp2 = qzir;
+         E = 0;
+         for (n = 0; n < VDIM; n++) {
+            e = *fp2++ + *fp4++;
+            E += (int64_t)e * e;
+         }
+         if (E < Emin) {
+            jmin = j;
+            Emin = E;
+            sign = -1;
+         }
+      }
+
+      /* THE BEST CODEVECTOR HAS BEEN FOUND; ASSIGN VQ CODEBOOK INDEX */
+      if (sign == 1)
+         idx[iv++] = jmin;
+      else
+         idx[iv++] = jmin + CBSZ; /* MSB of index is sign bit */
+
+      /* BORROW zbuf[] TO STORE FINAL VQ OUTPUT VECTOR WITH CORRECT SIGN */
+      cp = &cb[jmin*VDIM]; /* cp points to start of best codevector */
+      for (n = 0; n < VDIM; n++) {
+         zbuf[n] = sign * *cp++;
+      }
+
+      /* LOOP THROUGH EVERY ELEMENT OF THE CURRENT VECTOR */
+      for (n = m; n < m + VDIM; n++) {
+
+         /* PERFORM MULTIPLY-ADDS ALONG THE DELAY LINE OF FILTER */
+         fp1 = &buf[n];
+         a0 = (int64_t)d[n] << 24;
+         for (i = LPCO; i > 0; i--) {
+            a0 -= (int64_t)(*fp1++) * h[i];
+         }
+         v = bvfx_sat(BVFX_RND(a0, 24));
+
+         /* COMPUTE VQ ERROR q[n] = u[n] - uq[n] AND UPDATE LONG-TERM
+         NOISE FEEDBACK FILTER MEMORY */
+         ltnfm[MAXPP1+n] = bvfx_sat((int64_t)v - ltfv[n-m] - zbuf[n-m]);
+
+         /* CALCULATE QUANTIZED LPC EXCITATION VECTOR qv[n] AND UPDATE
+         LONG-TERM PREDICTOR MEMORY */
+         qv[n] = bvfx_sat((int64_t)zbuf[n-m] + ppv[n-m]);
+         ltsym[MAXPP1+n] = qv[n];
+
+         /* UPDATE SHORT-TERM NOISE FEEDBACK FILTER MEMORY */
+         *fp1 = v - qv[n];
+      }
+   }
+
+   /* UPDATE NOISE FEEDBACK FILTER MEMORY AFTER FILTERING CURRENT SUBFRAME */
+   for (i = 0; i < LPCO; i++) {
+      stnfm[i] = *fp1--;
+   }
+
+   /* UPDATE LONG-TERM PREDICTOR MEMORY AFTER PROCESSING CURRENT SUBFRAME */
+   fp2 = &ltnfm[SFRSZ];
+   fp3 = &ltsym[SFRSZ];
+   for (i = 0; i < MAXPP1; i++) {
+      ltnfm[i] = fp2[i];
+      ltsym[i] = fp3[i];
+   }
+}
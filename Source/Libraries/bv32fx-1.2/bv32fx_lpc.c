@@ -0,0 +1,553 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx_lpc.c: BV32 fixed-point LPC analysis, LSP conversion and quantization
+
+  $Log$
+******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "bv32fxlib.h"
+
+#define MAXDIM  FRSZ    /* maximum vector dimension */
+#define MAXORDER LPCO   /* maximum filter order */
+#define NAB     ((LPCO >> 1) + 1)
+#define NBIS    4       /* number of bisections */
+
+#define LSPMIN_Q19   786      /* 0.00150 */
+#define LSPMAX_Q19   523108   /* 0.99775 */
+#define DLSPMIN_Q19  6554     /* 0.01250 */
+
+/* All-pole filter; a[0] is assumed to be one */
+void bvfx_apfilter(
+                   const int32_t *a,
+                   int     q,
+                   int     m,
+                   const int32_t *x,
+                   int32_t *y,
+                   int     lg,
+                   int32_t *mem,
+                   short   update)
+{
+   int32_t buf[MAXORDER+MAXDIM]; /* buffer for filter memory & signal */
+   int32_t *fp1;
+   int64_t a0;
+   int i, n;
+
+   /* copy filter memory to beginning part of temporary buffer */
+   fp1 = &mem[m-1];
+   for (i = 0; i < m; i++) {
+      buf[i] = *fp1--;    /* this buffer is used to avoid memory shifts */
+   }
+
+   /* loop through every element of the current vector */
+   for (n = 0; n < lg; n++) {
+
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = &buf[n];
+      a0 = (int64_t)x[n] << q;
+      for (i = m; i > 0; i--) {
+         a0 -= (int64_t)(*fp1++) * a[i];
+      }
+
+      /* update the output & temporary buffer for filter memory */
+      y[n] = bvfx_sat(BVFX_RND(a0, q));
+      *fp1 = y[n];
+   }
+
+   /* get the filter memory after filtering the current vector */
+   if (update) {
+      for (i = 0; i < m; i++) {
+         mem[i] = *fp1--;
+      }
+   }
+}
+
+/* All-zero filter */
+void bvfx_azfilter(
+                   const int32_t *a,
+                   int     q,
+                   int     m,
+                   const int32_t *x,
+                   int32_t *y,
+                   int     lg,
+                   int32_t *mem,
+                   short   update)
+{
+   int32_t buf[MAXORDER+MAXDIM]; /* buffer for filter memory & signal */
+   int32_t *fp1;
+   int64_t a0;
+   int i, n;
+
+   /* copy filter memory to beginning part of temporary buffer */
+   fp1 = &mem[m-1];
+   for (i = 0; i < m; i++) {
+      buf[i] = *fp1--;    /* this buffer is used to avoid memory shifts */
+   }
+
+   /* loop through every element of the current vector */
+   for (n = 0; n < lg; n++) {
+
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = &buf[n];
+      a0 = 0;
+      for (i = m; i > 0; i--) {
+         a0 += (int64_t)(*fp1++) * a[i];
+      }
+
+      /* update the temporary buffer for filter memory */
+      *fp1 = x[n];
+
+      /* do the last multiply-add separately and get the output */
+      y[n] = bvfx_sat(BVFX_RND(a0 + (int64_t)x[n] * a[0], q));
+   }
+
+   /* get the filter memory after filtering the current vector */
+   if (update) {
+      for (i = 0; i < m; i++) {
+         mem[i] = *fp1--;
+      }
+   }
+}
+
+/*
+ * Windowed autocorrelation with spectral smoothing. The lags are normalized
+ * so that r[0] lies in [2^29, 2^30); a silent window gives all zeros.
+ */
+void bvfx_autocor(int32_t *r, const int32_t *x)
+{
+   int32_t buf[WINSZ];
+   int64_t a0, r0 = 0;
+   int i, n, s = 0;
+
+   /* apply analysis window */
+   for (n = 0; n < WINSZ; n++) {
+      buf[n] = (int32_t)BVFX_RND((int64_t)x[n] * bvfx_winl[n], 15);
+   }
+
+   /* compute autocorrelation coefficients up to lag order */
+   for (i = 0; i <= LPCO; i++) {
+      a0 = 0;
+      for (n = i; n < WINSZ; n++) {
+         a0 += (int64_t)buf[n] * buf[n - i];
+      }
+      if (i == 0) {
+         r0 = a0;
+         s = bvfx_bitlen((uint64_t)r0) - 30;
+      }
+      r[i] = (r0 > 0) ? bvfx_scale(a0, s) : 0;
+   }
+
+   /* apply spectral smoothing */
+   for (i = 0; i <= LPCO; i++) {
+      r[i] = (int32_t)BVFX_RND((int64_t)r[i] * bvfx_sstwin[i], 30);
+   }
+}
+
+/*  Levinson-Durbin recursion */
+void bvfx_levinson(const int32_t *r, int32_t *a, int32_t *old_a)
+{
+   int64_t alpha, a0;
+   int32_t rc, a1;
+   int mh, minc, ip;
+
+   a[0] = BVFX_ONE_Q24;
+   if (r[0] <= 0) goto illcond;
+
+   /* start durbin's recursion */
+   rc = -(int32_t)(((int64_t)r[1] << 24) / r[0]);
+   a[1] = rc;
+   alpha = r[0] + BVFX_RND((int64_t)r[1] * rc, 24);           /* Q30 */
+   if (alpha <= 0) goto illcond;
+   for (minc = 2; minc <= LPCO; minc++) {
+      a0 = 0;
+      for (ip = 0; ip <= minc - 1; ip++)
+         a0 += ((int64_t)r[minc - ip] * a[ip]) >> 8;         /* Q46 */
+
+      /* the reflection coefficient has to stay below one */
+      if (((a0 < 0) ? -a0 : a0) >= (alpha << 16)) goto illcond;
+      rc = -(int32_t)((a0 << 8) / alpha);
+
+      mh = minc / 2;
+      for (ip = 1; ip <= mh; ip++) {
+         a1 = a[ip] + (int32_t)BVFX_RND((int64_t)rc * a[minc - ip], 24);
+         a[minc - ip] += (int32_t)BVFX_RND((int64_t)rc * a[ip], 24);
+         a[ip] = a1;
+      }
+      a[minc] = rc;
+      alpha += BVFX_RND((int64_t)rc * (a0 >> 16), 24);
+      if (alpha <= 0) goto illcond;
+   }
+
+   memcpy(old_a, a, (LPCO + 1) * sizeof(int32_t));
+   return;
+
+illcond:
+   memcpy(a, old_a, (LPCO + 1) * sizeof(int32_t));
+}
+
+/* Evaluate a series expansion in Chebyshev polynomials, x in Q30 */
+static int32_t FNevChebP(int32_t x, const int32_t *c, int nd2)
+{
+   int32_t b[NAB];
+   int i;
+
+   b[0] = c[nd2];
+   b[1] = c[nd2-1] + (int32_t)BVFX_RND((int64_t)x * b[0], 29);
+   for (i = 2; i < nd2; i++)
+      b[i] = c[nd2-i] - b[i-2] + (int32_t)BVFX_RND((int64_t)x * b[i-1], 29);
+   return c[0] - b[nd2-2] + (int32_t)BVFX_RND((int64_t)x * b[nd2-1], 30);
+}
+
+/* Equivalent of y1 * y2 <= 0 */
+static __inline int sign_change(int32_t y1, int32_t y2)
+{
+   return (y1 == 0) || (y2 == 0) || ((y1 < 0) != (y2 < 0));
+}
+
+/*
+ * Convert predictor coefficients to line spectral pairs; see a2lsp.c of the
+ * floating-point reference for a description of the method.
+ */
+void bvfx_a2lsp(const int32_t *pc, int32_t *lsp, int32_t *old_lsp)
+{
+   int32_t fa[NAB], fb[NAB];
+   int32_t ta[NAB], tb[NAB];
+   int32_t *t;
+   int32_t xlow, xmid, xhigh, xroot, dx;
+   int32_t ylow, ymid, yhigh;
+   int i, j, nf, nd2, nab = NAB, ngrd;
+
+   /* symmetric and antisymmetric polynomials, Q20 */
+   fb[0] = fa[0] = 1L << 20;
+   for (i = 1, j = LPCO; i <= (LPCO/2); i++, j--) {
+      fa[i] = (int32_t)BVFX_RND((int64_t)pc[i] + pc[j], 4) - fa[i-1];
+      fb[i] = (int32_t)BVFX_RND((int64_t)pc[i] - pc[j], 4) + fb[i-1];
+   }
+
+   nd2 = LPCO/2;
+
+   ta[0] = fa[nab-1];
+   tb[0] = fb[nab-1];
+   for (i = 1, j = nab - 2; i < nab; ++i, --j) {
+      ta[i] = 2 * fa[j];
+      tb[i] = 2 * fb[j];
+   }
+
+   nf = 0;
+   t = ta;
+   xroot = INT32_MAX;
+   ngrd = 0;
+   xlow = (int32_t)bvfx_grid[0] << 15;
+   ylow = FNevChebP(xlow, t, nd2);
+
+   /* Root search loop */
+   while (ngrd < (Ngrd-1) && nf < LPCO) {
+
+      /* New trial point */
+      ngrd++;
+      xhigh = xlow;
+      yhigh = ylow;
+      xlow = (int32_t)bvfx_grid[ngrd] << 15;
+      ylow = FNevChebP(xlow, t, nd2);
+
+      if (sign_change(ylow, yhigh)) {
+
+         /* Bisections of the interval containing a sign change */
+         dx = xhigh - xlow;
+         for (i = 1; i <= NBIS; ++i) {
+            dx >>= 1;
+            xmid = xlow + dx;
+            ymid = FNevChebP(xmid, t, nd2);
+            if (sign_change(ylow, ymid)) {
+               yhigh = ymid;
+               xhigh = xmid;
+            } else {
+               ylow = ymid;
+               xlow = xmid;
+            }
+         }
+
+         /*
+         * Linear interpolation in the subinterval with a sign change
+         * (take care if yhigh=ylow=0)
+         */
+         if (yhigh != ylow)
+            xmid = xlow + (int32_t)(((int64_t)dx * ylow) / ((int64_t)ylow - yhigh));
+         else
+            xmid = xlow + dx;
+
+         /* New root position */
+         lsp[nf] = (int32_t)BVFX_RND((int64_t)bvfx_acospi(xmid), 11);
+         ++nf;
+
+         /* Start the search for the roots of the next polynomial at the
+         * estimated location of the root just found */
+         if (xmid >= xroot) {
+            xmid = xlow - dx;
+         }
+         xroot = xmid;
+         if (t == ta)
+            t = tb;
+         else
+            t = ta;
+         xlow = xmid;
+         ylow = FNevChebP(xlow, t, nd2);
+      }
+   }
+
+   /* if LPCO roots have not been found */
+   if (nf != LPCO) {
+      memcpy(lsp, old_lsp, LPCO * sizeof(int32_t));
+   }
+   /* else update LSP of previous frame with the new LSP */
+   else {
+      memcpy(old_lsp, lsp, LPCO * sizeof(int32_t));
+   }
+}
+
+/* Convert line spectral pairs to predictor coefficients */
+void bvfx_lsp2a(const int32_t *lsp, int32_t *a)
+{
+   int32_t c1, c2, p[LPCO+1], q[LPCO+1];
+   int orderd2, n, i, nor;
+
+   orderd2 = LPCO/2;
+   for (i = 1; i <= LPCO; i++)
+      p[i] = q[i] = 0;
+   /* Get Q & P polyn. less the (1 +- z-1) ( or (1 +- z-2) ) factor, Q24 */
+   p[0] = q[0] = BVFX_ONE_Q24;
+   for (n = 1; n <= orderd2; n++) {
+      nor = 2 * n;
+      c1 = bvfx_cospi(lsp[nor-1]);      /* half of the coefficient, Q30 */
+      c2 = bvfx_cospi(lsp[nor-2]);
+      for (i = nor; i >= 2; i--) {
+         q[i] += q[i-2] - (int32_t)BVFX_RND((int64_t)c1 * q[i-1], 29);
+         p[i] += p[i-2] - (int32_t)BVFX_RND((int64_t)c2 * p[i-1], 29);
+      }
+      q[1] -= c1 >> 5;
+      p[1] -= c2 >> 5;
+   }
+   /* Get the the predictor coeff. */
+   a[0] = BVFX_ONE_Q24;
+   a[1] = (int32_t)(((int64_t)p[1] + q[1]) >> 1);
+   for (i = 1, n = 2; i < LPCO; i++, n++)
+      a[n] = (int32_t)(((int64_t)p[i] + p[n] + q[n] - q[i]) >> 1);
+}
+
+/* Order the lsp and impose minimum spacing (stblz_lsp) */
+static void bvfx_stblz_lsp(int32_t *lsp, int order)
+{
+   int k, i;
+   int32_t mintmp, maxtmp, a0;
+
+   /* order lsps as minimum stability requirement */
+   do {
+      k = 0;
+      for (i = 0; i < order - 1; i++) {
+         if (lsp[i] > lsp[i+1]) {
+            a0 = lsp[i+1];
+            lsp[i+1] = lsp[i];
+            lsp[i] = a0;
+            k = 1;
+         }
+      }
+   } while (k > 0);
+
+   /* impose basic lsp properties */
+   maxtmp = LSPMAX_Q19 - (order-1) * DLSPMIN_Q19;
+
+   if (lsp[0] < LSPMIN_Q19)
+      lsp[0] = LSPMIN_Q19;
+   else if (lsp[0] > maxtmp)
+      lsp[0] = maxtmp;
+
+   for (i = 0; i < order-1; i++) {
+      mintmp = lsp[i] + DLSPMIN_Q19;
+      maxtmp += DLSPMIN_Q19;
+      if (lsp[i+1] < mintmp)
+         lsp[i+1] = mintmp;
+      else if (lsp[i+1] > maxtmp)
+         lsp[i+1] = maxtmp;
+   }
+}
+
+/* MSE VQ, codebook in Q(19-shift) */
+static void vqmse(int32_t *xq, short *idx, const int32_t *x, const int16_t *cb,
+                  int shift, int vdim, int cbsz)
+{
+   const int16_t *fp1;
+   int64_t dmin = INT64_MAX, d;
+   int32_t e;
+   int j, k;
+
+   fp1 = cb;
+   *idx = 0;
+   for (j = 0; j < cbsz; j++) {
+      d = 0;
+      for (k = 0; k < vdim; k++) {
+         e = x[k] - ((int32_t)(*fp1++) << shift);
+         d += (int64_t)e * e;
+      }
+      if (d < dmin) {
+         dmin = d;
+         *idx = j;
+      }
+   }
+
+   j = *idx * vdim;
+   for (k = 0; k < vdim; k++) {
+      xq[k] = (int32_t)cb[j + k] << shift;
+   }
+}
+
+/* WMSE VQ with optional enforcement of the ordering property (xa != NULL) */
+static void vqwmse(int32_t *xq, short *idx, const int32_t *x, const int32_t *w,
+                   const int32_t *xa, const int16_t *cb, int vdim, int cbsz)
+{
+   const int16_t *fp1;
+   int64_t dmin = INT64_MAX, d;
+   int32_t e, xqc, xqp;
+   int j, k, stbl;
+
+   fp1 = cb;
+   *idx = -1;
+   for (j = 0; j < cbsz; j++) {
+
+      /* check stability */
+      stbl = 1;
+      if (xa != NULL) {
+         xqp = 0;
+         for (k = 0; k < vdim; k++) {
+            xqc = xa[k] + fp1[k];
+            if (xqc < xqp)
+               stbl = 0;
+            xqp = xqc;
+         }
+      }
+
+      /* calculate distortion */
+      d = 0;
+      for (k = 0; k < vdim; k++) {
+         e = x[k] - *fp1++;
+         d += (int64_t)w[k] * (((int64_t)e * e) >> 10);
+      }
+
+      if (stbl > 0 && d < dmin) {
+         dmin = d;
+         *idx = j;
+      }
+   }
+
+   if (*idx == -1) {
+      *idx = 1;    /* Encoder-decoder synchronization lost for clean channel */
+   }
+
+   fp1 = cb + (*idx)*vdim;
+   for (k = 0; k < vdim; k++) {
+      xq[k] = *fp1++;
+   }
+}
+
+/* Two-stage MA-predictive LSP quantization, all vectors in Q19 */
+void bvfx_lspquan(int32_t *lspq, short *lspidx, const int32_t *lsp, int32_t *lsppm)
+{
+   int32_t d[LPCO], w[LPCO];
+   int32_t elsp[LPCO], lspe[LPCO];
+   int32_t lspeq1[LPCO], lspeq2[LPCO];
+   int32_t lspa[LPCO];
+   const int16_t *fp1;
+   int32_t *fp2, *fp3;
+   int64_t a0;
+   int i, k;
+
+   /* CALCULATE THE WEIGHTS FOR WEIGHTED MEAN-SQUARE ERROR DISTORTION */
+   for (i = 0; i < LPCO - 1 ; i++) {
+      d[i] = lsp[i+1] - lsp[i];       /* LSP difference vector */
+      if (d[i] < 1)
+         d[i] = 1;
+   }
+   w[0] = (1L << 29) / d[0];          /* 1/d in Q10 */
+   for (i = 1; i < LPCO - 1 ; i++) {
+      if (d[i] < d[i-1])
+         w[i] = (1L << 29) / d[i];
+      else
+         w[i] = (1L << 29) / d[i-1];
+   }
+   w[LPCO-1] = (1L << 29) / d[LPCO-2];
+
+   /* CALCULATE ESTIMATED (MA-PREDICTED) LSP VECTOR */
+   fp1 = bvfx_lspp;
+   fp2 = lsppm;
+   for (i = 0; i < LPCO; i++) {
+      a0 = 0;
+      for (k = 0; k < LSPPORDER; k++) {
+         a0 += (int64_t)(*fp1++) * (*fp2++);
+      }
+      elsp[i] = (int32_t)BVFX_RND(a0, 14);
+   }
+
+   /* SUBTRACT LSP MEAN VALUE & ESTIMATED LSP TO GET PREDICTION ERROR */
+   for (i = 0; i < LPCO; i++) {
+      lspe[i] = lsp[i] - ((int32_t)bvfx_lspmean[i] << 4) - elsp[i];
+   }
+
+   /* PERFORM FIRST-STAGE VQ CODEBOOK SEARCH, MSE VQ */
+   vqmse(lspeq1, &lspidx[0], lspe, bvfx_lspecb1, 3, LPCO, LSPECBSZ1);
+
+   /* CALCULATE QUANTIZATION ERROR VECTOR OF FIRST-STAGE VQ */
+   for (i = 0; i < LPCO; i++) {
+      d[i] = lspe[i] - lspeq1[i];
+   }
+
+   /* PERFORM SECOND-STAGE VQ CODEBOOK SEARCH */
+   for (i = 0; i < SVD1; i++)
+      lspa[i] = ((int32_t)bvfx_lspmean[i] << 4) + elsp[i] + lspeq1[i];
+   vqwmse(lspeq2, &lspidx[1], d, w, lspa, bvfx_lspecb21, SVD1, LSPECBSZ21);
+   vqwmse(&lspeq2[SVD1], &lspidx[2], &d[SVD1], &w[SVD1], NULL, bvfx_lspecb22,
+      SVD2, LSPECBSZ22);
+
+   /* GET OVERALL QUANTIZER OUTPUT VECTOR OF THE TWO-STAGE VQ */
+   for (i = 0; i < LPCO; i++) {
+      lspe[i] = lspeq1[i] + lspeq2[i];
+   }
+
+   /* UPDATE LSP MA PREDICTOR MEMORY */
+   i = LPCO * LSPPORDER - 1;
+   fp2 = &lsppm[i];
+   fp3 = &lsppm[i - 1];
+   for (i = LPCO - 1; i >= 0; i--) {
+      for (k = LSPPORDER; k > 1; k--) {
+         *fp2-- = *fp3--;
+      }
+      *fp2-- = lspe[i];
+      fp3--;
+   }
+
+   /* CALCULATE QUANTIZED LSP */
+   for (i = 0; i < LPCO; i++) {
+      lspq[i] = lspe[i] + elsp[i] + ((int32_t)bvfx_lspmean[i] << 4);
+   }
+
+   /* ENSURE CORRECT ORDERING & MINIMUM SPACING TO GUARANTEE STABILITY */
+   bvfx_stblz_lsp(lspq, LPCO);
+}
@@ -0,0 +1,485 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fx_pitch.c: BV32 fixed-point pitch analysis and pitch tap quantization
+
+  $Log$
+******************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "bv32fxlib.h"
+
+/* coarse pitch thresholds, Q15 */
+#define MPTH4_Q15   9830    /* 0.30 */
+#define TH1_Q15     23921   /* 0.73 */
+#define TH2_Q15     13107   /* 0.40 */
+#define LPTH1_Q15   25559   /* 0.78 */
+#define LPTH2_Q15   14090   /* 0.43 */
+
+/* (1 -+ MPDTH) and (1 -+ SMDTH) as rational numbers */
+#define MPR1_NUM    94
+#define MPR2_NUM    106
+#define MPR_DEN     100
+#define SMDTH1_NUM  905
+#define SMDTH2_NUM  1095
+#define SMDTH_DEN   1000
+
+/* refined pitch search */
+#define FS      (XOFF+1)    /* Frame Starting index */
+#define FE      (XOFF+FRSZ) /* Frame Ending index */
+#define DEV     6
+
+/* limits for normalized correlations and energies */
+#define COR_BITS    20
+#define ENERGY_BITS 27
+
+/* Threshold t (Q15) applied to a cor2 value */
+#define TH(cor2, t) (((cor2) >> 15) * (t))
+
+/* Normalize a vector of 64-bit values so that the largest magnitude has at most 'bits' bits */
+static void normalize(int32_t *y, const int64_t *x, int n, int bits)
+{
+   uint64_t m = 0, v;
+   int i, s;
+
+   for (i = 0; i < n; i++) {
+      v = (x[i] < 0) ? -(uint64_t)x[i] : (uint64_t)x[i];
+      m |= v;
+   }
+   s = (m != 0) ? (bvfx_bitlen(m) - bits) : 0;
+   for (i = 0; i < n; i++) {
+      y[i] = bvfx_scale(x[i], s);
+   }
+}
+
+/*
+ * Coarse pitch search in the 8:1 decimated domain. Correlations and energies
+ * are normalized separately; all decisions compare ratios cor2/energy, which
+ * is not affected by the scaling.
+ */
+int bvfx_coarsepitch(	/* in the undecimated domain Q3 */
+                     const int32_t *xw,
+                     int32_t *xwdm,
+                     int32_t *dfm,	/* (i/o) ellipse low pass filter memory */
+                     int     cpplast)	/* in the undecimated domain Q3 */
+{
+   int32_t xwd[LXD];
+   int64_t cor64[MAXPPD1+1], energy64[MAXPPD1+1];
+   int32_t _cor[MAXPPD1+1], _energy[MAXPPD1+1];
+   int64_t _cor2[MAXPPD1+1];
+   int32_t *cor, *energy;
+   int64_t *cor2;
+   int64_t cor2i[MAX_NPEAKS], cor2max, cor2m, ci;
+   int32_t energyi[MAX_NPEAKS], energymax, energym, eni, deltae;
+   int32_t tmp[DFO+FRSZ], threshold, a, b, c;
+   int32_t *fp1, *fp2;
+   const int32_t *fp3;
+   int32_t *xp0, *xp1, *xp2, *xp3;
+   int64_t s, t;
+   int   cpp, maxdev, plag[MAX_NPEAKS], mplth;	/* in the undecimated domain Q3 */
+   int   i, j, k, n, npeaks, imax, im, idx[HMAXPPD];
+   int   flag, mpflag, m;
+
+   cor = _cor+1;
+   cor2 = _cor2+1;
+   energy = _energy+1;
+
+   /* LOWPASS FILTER xw() TO 800 Hz; SHIFT & OUTPUT INTO xwd() */
+
+   /* load xwd[] buffer memory */
+   for (i = 0; i < XDOFF; i++) xwd[i] = xwdm[i];
+
+   /* copy memory to temp buffer */
+   fp1 = tmp; fp2 = dfm;
+   for (i = 0; i < DFO; i++) *fp1++ = *fp2++;
+
+   /* AP and AZ filtering and decimation, Q4 (the filter has a peak gain of about 650) */
+   xp0 = xwd+XDOFF;
+   fp3 = xw;
+   for (i = 0; i < FRSZD; i++) {
+      for (k = 0; k < DECF; k++) {
+         t = (int64_t)(*fp3++ >> 2) << 28;
+         fp2 = fp1-1;
+         for (j = 0; j < DFO; j++) t -= (int64_t)bvfx_adf[j+1] * (*fp2--);
+         *fp1++ = bvfx_sat32(BVFX_RND(t, 28));
+      }
+      fp2 = fp1-1;
+      t = (int64_t)bvfx_bdf[0] * (*fp2--);
+      for (j = 0; j < DFO; j++) t += (int64_t)bvfx_bdf[j+1] * (*fp2--);
+      *xp0++ = bvfx_sat32(BVFX_RND(t, 28));
+   }
+
+   /* copy temp buffer to memory */
+   fp1 -= DFO;
+   for (i = 0; i < DFO; i++) dfm[i] = *fp1++;
+   for (i = 0; i < XDOFF; i++) xwdm[i] = xwd[FRSZD+i];
+
+   /* COMPUTE CORRELATION & ENERGY OF PREDICTION BASIS VECTOR */
+
+   xp0 = xwd+MAXPPD1;
+   xp1 = xwd+MAXPPD1-M1;
+   s = t = 0;
+   for (i = 0; i < (LXD-MAXPPD1); i++) {
+      s += (int64_t)(*xp1) * (*xp1);
+      t += (int64_t)(*xp0++) * (*xp1++);
+   }
+   if (s == 0) t = 0;
+   energy64[M1] = s;
+   cor64[M1] = t;
+
+   xp2 = xwd+LXD-M1-1;
+   xp3 = xwd+MAXPPD1-M1-1;
+
+   for (i = M1; i < M2; i++) {
+      xp0 = xwd+MAXPPD1;
+      xp1 = xwd+MAXPPD1-i-1;
+      t = 0;
+      for (j = 0; j < (LXD-MAXPPD1); j++) t += (int64_t)(*xp0++) * (*xp1++);
+      s = s - (int64_t)(*xp2) * (*xp2) + (int64_t)(*xp3) * (*xp3);
+      if (s == 0) t = 0;
+      cor64[i+1] = t;
+      energy64[i+1] = s;
+      xp2--; xp3--;
+   }
+
+   normalize(_cor, cor64, M2-M1+1, COR_BITS);
+   normalize(_energy, energy64, M2-M1+1, ENERGY_BITS);
+   for (i = M1-1; i < M2; i++) {
+      cor2[i] = (int64_t)cor[i] * ((cor[i] < 0) ? -cor[i] : cor[i]);
+   }
+
+   /* FIND POSITIVE COR*COR/ENERGY PEAKS */
+   npeaks = 0;
+   n = MINPPD-1;
+   while ((npeaks < MAX_NPEAKS) && (n < MAXPPD)) {
+      if (bvfx_gt(cor2[n], energy[n-1], cor2[n-1], energy[n]) &&
+         bvfx_gt(cor2[n], energy[n+1], cor2[n+1], energy[n]) && (cor2[n] > 0)) {
+         idx[npeaks] = n;
+         npeaks++;
+      }
+      n++;
+   }
+
+   /* RETURN EARLY IF THERE IS NO PEAK OR ONLY ONE PEAK */
+   if (npeaks == 0)   /* if there are no positive peak, */
+      return MINPPD*cpp_scale; /* return minimum pitch period */
+   if (npeaks == 1)   /* if there is exactly one peak, */
+      return (idx[0]+1)*cpp_scale; /* return the time lag for this peak */
+
+   /* IF PROGRAM PROCEEDS TO HERE, THERE ARE 2 OR MORE PEAKS */
+   cor2max = 0;
+   energymax = 1;
+   imax = 0;
+   for (i = 0; i < npeaks; i++) {
+
+      /* USE QUADRATIC INTERPOLATION TO FIND THE INTERPOLATED cor[] AND
+      energy[] CORRESPONDING TO INTERPOLATED PEAK OF cor2[]/energy[].
+      The coefficients of y(x)=ax^2+bx+c are doubled, cor[] is kept in
+      units of 1/128 and energy[] in units of 1/8. */
+      n = idx[i];
+      a = cor[n+1] + cor[n-1] - 2*cor[n];
+      b = cor[n+1] - cor[n-1];
+      c = cor[n];
+
+      /* INITIALIZE VARIABLES BEFORE SEARCHING FOR INTERPOLATED PEAK */
+      im = 0;
+      cor2m = cor2[n] << 14;
+      energym = energy[n] << 3;
+      eni = energy[n] << 3;
+
+      /* DERTERMINE WHICH SIDE THE INTERPOLATED PEAK FALLS IN, THEN
+      DO THE SEARCH IN THE APPROPRIATE RANGE */
+      if (bvfx_gt(cor2[n+1], energy[n-1], cor2[n-1], energy[n+1])) { /* if right side */
+         deltae = energy[n+1] - energy[n]; /* increment for linear interp. */
+         for (k = 0; k < HDECF; k++) {
+            m = k + 1;
+            ci = (int64_t)a*m*m + (int64_t)8*b*m + ((int64_t)c << 7);
+            eni += deltae;
+            if (bvfx_gt(ci*ci, energym, cor2m, eni)) {
+               im = k+1;
+               cor2m = ci*ci;
+               energym = eni;
+            }
+         }
+      } else {    /* if interpolated peak is on the left side */
+         deltae = energy[n-1] - energy[n]; /* increment for linear interp. */
+         for (k = 0; k < HDECF; k++) {
+            m = k + 1;
+            ci = (int64_t)a*m*m - (int64_t)8*b*m + ((int64_t)c << 7);
+            eni += deltae;
+            if (bvfx_gt(ci*ci, energym, cor2m, eni)) {
+               im = -k-1;
+               cor2m = ci*ci;
+               energym = eni;
+            }
+         }
+      }
+
+      /* SEARCH DONE; ASSIGN cor2[] AND energy[] CORRESPONDING TO
+      INTERPOLATED PEAK */
+      plag[i] = (idx[i]+1)*cpp_scale+im; 	/* lag of interp. peak */
+      cor2i[i] = cor2m;
+      energyi[i] = energym;
+
+      /* SEARCH FOR GLOBAL MAXIMUM OF INTERPOLATED cor2[]/energy[] peak */
+      if (i == 0 || bvfx_gt(cor2m, energymax, cor2max, energym)) {
+         imax = i;
+         cor2max = cor2m;
+         energymax = energym;
+      }
+   }
+   cpp = plag[imax];	/* first candidate for coarse pitch period */
+   mplth = plag[npeaks-1]; /* set mplth to the lag of last peak */
+
+   /* FIND THE LARGEST PEAK (IF THERE IS ANY) AROUND THE LAST PITCH */
+   maxdev = cpplast >> 2; /* maximum deviation from last pitch */
+   im = -1;
+   cor2m = 0;
+   energym = 1;
+   for (i = 0; i < npeaks; i++) {  /* loop thru the peaks before the largest peak */
+      if (abs(plag[i]-cpplast) <= maxdev) {
+         if (im == -1 || bvfx_gt(cor2i[i], energym, cor2m, energyi[i])) {
+            im = i;
+            cor2m = cor2i[i];
+            energym = energyi[i];
+         }
+      }
+   } /* if there is no peaks around last pitch, then im is still -1 */
+
+   /* NOW SEE IF WE SHOULD PICK ANY ALTERNATICE PEAK */
+   /* FIRST, SEARCH FIRST HALF OF PITCH RANGE, SEE IF ANY QUALIFIED PEAK
+   HAS LARGE ENOUGH PEAKS AT EVERY MULTIPLE OF ITS LAG */
+   i = 0;
+   while (2*plag[i] < mplth) {
+
+      /* DETERMINE THE APPROPRIATE THRESHOLD FOR THIS PEAK */
+      if (i != im) {  /* if not around last pitch, */
+         threshold = TH1_Q15;    /* use a higher threshold */
+      } else {        /* if around last pitch */
+         threshold = TH2_Q15;    /* use a lower threshold */
+      }
+
+      /* IF THRESHOLD EXCEEDED, TEST PEAKS AT MULTIPLES OF THIS LAG */
+      if (bvfx_gt(cor2i[i], energymax, TH(cor2max, threshold), energyi[i])) {
+         flag = 1;
+         j = i+1;
+         k = 0;
+         n = 2*plag[i]; /* initialize n to twice the current lag */
+         while (n <= mplth) { /* loop thru all multiple lag <= mplth */
+            mpflag = 0;   /* initialize multiple pitch flag to 0 */
+            while (j < npeaks) { /* loop thru peaks with larger lags */
+               if (MPR_DEN*plag[j] > MPR2_NUM*n) { /* if range exceeded, */
+                  break;          /* break the innermost while loop */
+               }
+               if (MPR_DEN*plag[j] > MPR1_NUM*n) { /* if current peak lag within range, */
+                  /* then check if peak value large enough */
+                  if (k < 4) {
+                     c = bvfx_mpth[k];
+                  } else {
+                     c = MPTH4_Q15;
+                  }
+                  if (bvfx_gt(cor2i[j], energymax, TH(cor2max, c), energyi[j])) {
+                     mpflag = 1; /* if peak large enough, set mpflag, */
+                     break; /* and break the innermost while loop */
+                  }
+               }
+               j++;
+            }
+            /* if no qualified peak found at this multiple lag */
+            if (mpflag == 0) {
+               flag = 0;     /* disqualify the lag plag[i] */
+               break;      /* and break the while (n<=mplth) loop */
+            }
+            k++;
+            n += plag[i]; /* update n to the next multiple pitch lag */
+         }
+         /* if there is a qualified peak at every multiple of plag[i], */
+         if (flag == 1) {
+            return plag[i];         /* and return to calling function */
+         }
+      }
+      i++;
+      if (i == npeaks)
+         break;      /* to avoid out of array bound error */
+   }
+
+   /* IF PROGRAM PROCEEDS TO HERE, NONE OF THE PEAKS WITH LAGS < 0.5*mplth
+   QUALIFIES AS THE FINAL PITCH. IN THIS CASE, CHECK IF
+   THERE IS ANY PEAK LARGE ENOUGH AROUND LAST PITCH.  IF SO, USE ITS
+   LAG AS THE FINAL PITCH. */
+   if (im != -1) {   /* if there is at least one peak around last pitch */
+      if (im == imax) { /* if this peak is also the global maximum, */
+         return cpp;   /* return first pitch candidate at global max */
+      }
+      if (im < imax) { /* if lag of this peak < lag of global max, */
+         if (bvfx_gt(cor2m, energymax, TH(cor2max, LPTH2_Q15), energym)) {
+            if (plag[im] > HMAXPPD*cpp_scale) {
+               return plag[im];
+            }
+            for (k = 2; k <= 5; k++) { /* check if current candidate pitch */
+               /* is a sub-multiple of the time lag of the global maximum peak */
+               if ((SMDTH_DEN*k*plag[im] > SMDTH1_NUM*plag[imax]) &&
+                   (SMDTH_DEN*k*plag[im] < SMDTH2_NUM*plag[imax])) {
+                  return plag[im];
+               }
+            }
+         }
+      } else {           /* if lag of this peak > lag of global max, */
+         if (bvfx_gt(cor2m, energymax, TH(cor2max, LPTH1_Q15), energym)) {
+            return plag[im];         /* accept its lag */
+         }
+      }
+   }
+
+   /* IF PROGRAM PROCEEDS TO HERE, WE HAVE NO CHOICE BUT TO ACCEPT THE
+   LAG OF THE GLOBAL MAXIMUM */
+   return cpp;
+}
+
+/*
+ * Refine the pitch period around the coarse pitch and return the single-tap
+ * predictor coefficient in *ppt (Q15, limited to [0, 1]).
+ */
+int bvfx_refinepitch(const int32_t *x, int cpp, int32_t *ppt)
+{
+   int64_t cor64[2*DEV+1], energy64[2*DEV+1], energy, t;
+   int32_t cor[2*DEV+1], en[2*DEV+1];
+   int64_t cor2, cor2max;
+   const int32_t *fp0, *fp1, *fp2, *fp3;
+   uint64_t m;
+   int lb, ub, pp, i, j, imax, s;
+
+   if (cpp >= MAXPP) cpp = MAXPP-1;
+   if (cpp < MINPP) cpp = MINPP;
+   lb = cpp-DEV;
+   if (lb < MINPP) lb = MINPP; /* lower bound of pitch period search range */
+   ub = cpp+DEV;
+   /* to avoid selecting MAXPP as the refined pitch period */
+   if (ub >= MAXPP) ub = MAXPP-1;
+
+   /* correlation & energy for all candidate lags */
+   fp1 = x+FS-1-lb;
+   energy = 0;
+   for (j = 0; j < (FE-FS+1); j++) {
+      energy += (int64_t)(*fp1) * (*fp1);
+      fp1++;
+   }
+
+   fp0 = x+FE-lb-1;
+   fp1 = x+FS-lb-2;
+   for (i = lb; i <= ub; i++) {
+      fp2 = x+FS-1;
+      fp3 = x+FS-i-1;
+      t = 0;
+      for (j = 0; j < (FE-FS+1); j++) t += (int64_t)(*fp2++) * (*fp3++);
+      if (i > lb) {
+         energy += (int64_t)(*fp1) * (*fp1) - (int64_t)(*fp0) * (*fp0);
+         fp0--; fp1--;
+      }
+      cor64[i-lb] = t;
+      energy64[i-lb] = energy;
+   }
+
+   normalize(cor, cor64, ub-lb+1, COR_BITS);
+   normalize(en, energy64, ub-lb+1, ENERGY_BITS);
+
+   imax = 0;
+   cor2max = (int64_t)cor[0] * cor[0];
+   for (i = 1; i <= ub-lb; i++) {
+      cor2 = (int64_t)cor[i] * cor[i];
+      if (bvfx_gt(cor2, en[imax], cor2max, en[i])) {
+         imax = i;
+         cor2max = cor2;
+      }
+   }
+   pp = lb + imax;
+
+   /* ppt = cor/energy, only the range [0, 1] is of interest */
+   t = cor64[imax];
+   energy = energy64[imax];
+   if (energy <= 0 || t <= 0) {
+      *ppt = 0;
+   } else if (t >= energy) {
+      *ppt = 1L << 15;
+   } else {
+      m = (uint64_t)energy;
+      s = bvfx_bitlen(m) - 31;
+      if (s > 0) {
+         t >>= s;
+         energy >>= s;
+      }
+      *ppt = (int32_t)((t << 15) / energy);
+   }
+
+   return pp;
+}
+
+/* Vector quantization of the 3-tap pitch predictor, taps b[] in Q15 */
+int bvfx_pitchtapquan(const int32_t *x, int pp, int32_t *b)
+{
+   int64_t p64[9], t, cor, cormax = 0;
+   int32_t p[9], s0, s1, s2;
+   int64_t t0, t1, t2;
+   const int32_t *xt, *fp0, *fp1;
+   const int16_t *cp;
+   int ppm2, qidx = 0, i, j;
+
+   ppm2 = pp-2;
+   xt = x + XOFF;
+
+   for (i = 0; i < 3; i++) {
+      fp0 = xt; fp1 = x+XOFF-ppm2-i-1;
+      t = 0;
+      for (j = 0; j < FRSZ; j++) t += (int64_t)(*fp0++) * (*fp1++);
+      p64[i] = t;
+   }
+
+   fp0 = x+XOFF-ppm2-3;
+   s0 = *fp0++; s1 = *fp0++; s2 = *fp0--;
+   t0 = p64[8] = (int64_t)s0*s0; t1 = p64[4] = (int64_t)s0*s1; p64[5] = (int64_t)s0*s2;
+   s0 = *fp0++; s1 = *fp0++; s2 = *fp0--;
+   t2 = (int64_t)s0*s0; p64[8] += t2; p64[4] += (int64_t)s0*s1; p64[5] += (int64_t)s0*s2;
+   for (i = 0; i < (FRSZ-2); i++) {
+      s0 = *fp0++; s1 = *fp0++; s2 = *fp0--;
+      p64[8] += (int64_t)s0*s0; p64[4] += (int64_t)s0*s1; p64[5] += (int64_t)s0*s2;
+   }
+   s0 = *fp0++; s1 = *fp0++; s2 = *fp0--;
+   p64[7] = p64[8] + (int64_t)s0*s0 - t0;
+   p64[3] = p64[4] + (int64_t)s0*s1 - t1;
+   p64[6] = p64[7] + (int64_t)s1*s1 - t2;
+
+   normalize(p, p64, 9, 30);
+
+   cp = bvfx_pp9cb;
+   for (i = 0; i < PPCBSZ; i++) {
+      cor = 0;
+      for (j = 0; j < 9; j++) cor += (int64_t)(*cp++) * p[j];
+      if (i == 0 || cor > cormax) {
+         cormax = cor; qidx = i;
+      }
+   }
+
+   cp = bvfx_pp9cb + qidx*9;
+   for (i = 0; i < 3; i++) b[i] = cp[i];   /* b = pp9cb/2, Q15 */
+
+   return qidx;
+}
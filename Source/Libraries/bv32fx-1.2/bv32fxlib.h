@@ -0,0 +1,180 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point Encoder ANSI-C Source Code             */
+/* Ported from the BV32 Floating-Point ANSI-C Source Code, Version 1.2       */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bv32fxlib.h: BV32 fixed-point encoder internals
+
+  $Log$
+******************************************************************************/
+
+#ifndef  BV32FXLIB_H
+#define  BV32FXLIB_H
+
+#include <stdint.h>
+#include "bv32fx.h"
+
+/* Q format of signal buffers and saturation limit (64 x 16-bit full scale) */
+#define BVFX_SIG_Q      6
+#define BVFX_SIG_MAX    ((int32_t)((1L << 27) - 1))
+
+#define BVFX_ONE_Q24    ((int32_t)1 << 24)
+
+/* Rounding arithmetic right shift of a 64-bit accumulator (s > 0) */
+#define BVFX_RND(v, s)  (((v) + ((int64_t)1 << ((s) - 1))) >> (s))
+
+/* Limit a 64-bit value to the signal range */
+static __inline int32_t bvfx_sat(int64_t v)
+{
+   if (v > BVFX_SIG_MAX) return BVFX_SIG_MAX;
+   if (v < -BVFX_SIG_MAX) return -BVFX_SIG_MAX;
+   return (int32_t)v;
+}
+
+/* Limit a 64-bit value to the 32-bit range */
+static __inline int32_t bvfx_sat32(int64_t v)
+{
+   if (v > INT32_MAX) return INT32_MAX;
+   if (v < -INT32_MAX) return -INT32_MAX;
+   return (int32_t)v;
+}
+
+/* Basic operators */
+int bvfx_bitlen(uint64_t x);
+int32_t bvfx_scale(int64_t x, int shift);
+int bvfx_gt(int64_t x1, int32_t y1, int64_t x2, int32_t y2);
+int32_t bvfx_log2(uint64_t x);
+int32_t bvfx_pow2(int32_t x);
+int32_t bvfx_cospi(int32_t u);
+int32_t bvfx_acospi(int32_t x);
+
+/* Function Prototypes */
+void bvfx_apfilter(
+const int32_t *a,	/* (i) a[m+1] prediction coefficients           */
+int     q,		/* (i) Q format of a[]                          */
+int     m,		/* (i) filter order                             */
+const int32_t *x,	/* (i) input signal                             */
+int32_t *y,		/* (o) output signal                            */
+int     lg,		/* (i) size of filtering                        */
+int32_t *mem,		/* (i/o) filter memory                          */
+short   update);	/* (i) flag for memory update                   */
+
+void bvfx_azfilter(
+const int32_t *a,	/* (i) prediction coefficients                  */
+int     q,		/* (i) Q format of a[]                          */
+int     m,		/* (i) filter order                             */
+const int32_t *x,	/* (i) input signal vector                      */
+int32_t *y,		/* (o) output signal vector                     */
+int     lg,		/* (i) size of filtering                        */
+int32_t *mem,		/* (i/o) filter memory before filtering         */
+short   update);	/* (i) flag for memory update                   */
+
+void bvfx_autocor(
+int32_t *r,		/* (o) smoothed autocorrelation, r[0] ~ Q30     */
+const int32_t *x);	/* (i) WINSZ samples of input signal            */
+
+void bvfx_levinson(
+const int32_t *r,	/* (i) autocorrelation coefficients             */
+int32_t *a,		/* (o) LPC coefficients, Q24                    */
+int32_t *old_a);	/* (i/o) LPC coefficients of previous frame     */
+
+void bvfx_a2lsp(
+const int32_t *pc,	/* (i) predictor coefficients, Q24              */
+int32_t *lsp,		/* (o) line spectral pairs, Q19                 */
+int32_t *old_lsp);	/* (i/o) old lsp[] (in case not found 8 roots)  */
+
+void bvfx_lsp2a(
+const int32_t *lsp,	/* (i) LSP vector, Q19                          */
+int32_t *a);		/* (o) LPC coefficients, Q24                    */
+
+void bvfx_lspquan(
+int32_t *lspq,
+short   *lspidx,
+const int32_t *lsp,
+int32_t *lsppm);
+
+int bvfx_coarsepitch(
+const int32_t *xw,
+int32_t *xwd,
+int32_t *dfm,
+int     cpplast);
+
+int bvfx_refinepitch(
+const int32_t *x,
+int     cpp,
+int32_t *ppt);
+
+int bvfx_pitchtapquan(
+const int32_t *x,
+int     pp,
+int32_t *b);
+
+int bvfx_gainquan(
+int32_t *gainq,
+int32_t lg,
+int32_t *lgpm,
+int32_t *prevlg,
+int32_t level);
+
+void bvfx_estlevel(
+int32_t lg,
+int32_t *level,
+int32_t *lmax,
+int32_t *lmin,
+int32_t *lmean,
+int32_t *x1);
+
+void bvfx_excquan(
+int32_t *qv,		/* output quantized excitation signal vector */
+short   *idx,		/* quantizer codebook index for uq[] vector */
+const int32_t *d,	/* input prediction residual signal vector */
+const int32_t *h,	/* noise feedback filter coefficient array, Q24 */
+const int32_t *b,	/* coefficient of 3-tap pitch predictor, Q15 */
+int32_t beta,		/* coefficient of 1-tap LT noise feedback filter, Q15 */
+int32_t *ltsym,		/* long-term synthesis filter memory */
+int32_t *ltnfm,		/* long-term noise feedback filter memory */
+int32_t *stnfm,		/* short-term noise feedback filter memory */
+const int32_t *cb,	/* scaled excitation codebook */
+int     pp);		/* pitch period (# of 16 kHz samples) */
+
+/* Tables */
+extern const int32_t  bvfx_hpfa[];
+extern const int32_t  bvfx_hpfb[];
+extern const uint16_t bvfx_winl[];
+extern const int32_t  bvfx_sstwin[];
+extern const int32_t  bvfx_bwel[];
+extern const int32_t  bvfx_stwal[];
+extern const int16_t  bvfx_grid[];
+extern const int16_t  bvfx_lspecb1[LSPECBSZ1*LPCO];
+extern const int16_t  bvfx_lspecb21[LSPECBSZ21*SVD1];
+extern const int16_t  bvfx_lspecb22[LSPECBSZ22*SVD2];
+extern const int16_t  bvfx_lspmean[LPCO];
+extern const int16_t  bvfx_lspp[LSPPORDER*LPCO];
+extern const int16_t  bvfx_pp9cb[PPCBSZ*9];
+extern const int16_t  bvfx_lgpecb[LGPECBSZ];
+extern const int16_t  bvfx_lgp[LGPORDER];
+extern const int16_t  bvfx_lgmean;
+extern const int16_t  bvfx_lgclimit[NGB*NGCB];
+extern const int16_t  bvfx_cccb[CBSZ*VDIM];
+extern const int32_t  bvfx_adf[];
+extern const int32_t  bvfx_bdf[];
+extern const int16_t  bvfx_mpth[];
+extern const uint8_t  bvfx_idxord[LGPECBSZ];
+
+#endif /* BV32FXLIB_H */
@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dmnr.h"
+
+/* Adaptive filter weights are Q28. */
+#define DMNR_WEIGHT_SHIFT       28
+
+/* Adaptation is frozen while the voice level exceeds the reference level by this factor (Q8). */
+#define DMNR_FREEZE_RATIO_Q8    (2 * 256)
+
+/* Level follower time constant (as a shift): 32 samples, 2 ms at 16 kHz. */
+#define DMNR_LEVEL_SHIFT        5
+
+static inline int16_t dmnr_sat16(int32_t x)
+{
+    if (x > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+static inline int32_t dmnr_sat32(int64_t x)
+{
+    if (x > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (x < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)x;
+}
+
+static inline int32_t dmnr_abs(int32_t x)
+{
+    return (x < 0) ? -x : x;
+}
+
+/* Run one sample through the adaptive noise canceller and return the residual. */
+static int32_t dmnr_nlms(dmnr_t *p_dmnr, int16_t voice, int16_t ref)
+{
+    const unsigned int len = p_dmnr->cfg.filter_length;
+    int16_t *p_hist        = p_dmnr->cfg.p_ref_history;
+    int32_t *p_w           = p_dmnr->cfg.p_weights;
+    const int16_t *p_x;
+    int64_t acc;
+    int32_t d, e;
+    unsigned int k;
+
+    /* Delay the voice microphone so that the filter can model a causal path. */
+    if (p_dmnr->cfg.delay_length != 0)
+    {
+        d = p_dmnr->cfg.p_delay_line[p_dmnr->delay_pos];
+        p_dmnr->cfg.p_delay_line[p_dmnr->delay_pos] = voice;
+        if (++p_dmnr->delay_pos == p_dmnr->cfg.delay_length)
+        {
+            p_dmnr->delay_pos = 0;
+        }
+    }
+    else
+    {
+        d = voice;
+    }
+
+    /* The history is stored twice so that the newest len samples are always contiguous. */
+    p_dmnr->ref_pos = (p_dmnr->ref_pos == 0) ? (uint16_t)(len - 1) : (uint16_t)(p_dmnr->ref_pos - 1);
+    p_x = &p_hist[p_dmnr->ref_pos];
+    p_dmnr->ref_energy += (int32_t)ref * ref - (int32_t)p_x[0] * p_x[0];
+    p_hist[p_dmnr->ref_pos]       = ref;
+    p_hist[p_dmnr->ref_pos + len] = ref;
+
+    acc = 0;
+    for (k = 0; k < len; k++)
+    {
+        acc += (int64_t)p_w[k] * p_x[k];
+    }
+    e = d - (int32_t)(acc >> DMNR_WEIGHT_SHIFT);
+
+    /* Freeze adaptation while speech dominates the voice microphone. */
+    p_dmnr->voice_level += (dmnr_abs(d)   - p_dmnr->voice_level) >> DMNR_LEVEL_SHIFT;
+    p_dmnr->ref_level   += (dmnr_abs(ref) - p_dmnr->ref_level)   >> DMNR_LEVEL_SHIFT;
+
+    if (((int64_t)p_dmnr->voice_level << 8) <= (int64_t)p_dmnr->ref_level * DMNR_FREEZE_RATIO_Q8)
+    {
+        /* Normalized step: mu * e / |x|^2 in Q28 per unit of x, limited so that g * x fits 32 bits. */
+        int64_t g = ((int64_t)p_dmnr->cfg.step_size * e) << (DMNR_WEIGHT_SHIFT - 15);
+
+        g /= p_dmnr->ref_energy + 64 * (int64_t)len;
+        if (g > INT16_MAX)
+        {
+            g = INT16_MAX;
+        }
+        else if (g < -INT16_MAX)
+        {
+            g = -INT16_MAX;
+        }
+
+        if (g != 0)
+        {
+            for (k = 0; k < len; k++)
+            {
+                /* A weight driven past the Q28 range must stick at the limit instead of flipping sign. */
+                p_w[k] = dmnr_sat32((int64_t)p_w[k] + (int32_t)g * p_x[k]);
+            }
+        }
+    }
+
+    return e;
+}
+
+int dmnr_init(dmnr_t *p_dmnr, const dmnr_config_t *p_cfg)
+{
+    if ((p_dmnr == NULL) || (p_cfg == NULL) ||
+        (p_cfg->filter_length == 0) ||
+        (p_cfg->p_ref_history == NULL) ||
+        (p_cfg->p_weights == NULL) ||
+        ((p_cfg->delay_length != 0) && (p_cfg->p_delay_line == NULL)))
+    {
+        return -1;
+    }
+
+    memset(p_dmnr, 0, sizeof(*p_dmnr));
+    p_dmnr->cfg = *p_cfg;
+
+    if (spns_init(&p_dmnr->spns, p_cfg->gain_floor) != 0)
+    {
+        return -1;
+    }
+
+    memset(p_cfg->p_ref_history, 0, 2 * p_cfg->filter_length * sizeof(int16_t));
+    memset(p_cfg->p_weights, 0, p_cfg->filter_length * sizeof(int32_t));
+    if (p_cfg->delay_length != 0)
+    {
+        memset(p_cfg->p_delay_line, 0, p_cfg->delay_length * sizeof(int16_t));
+    }
+
+    return 0;
+}
+
+void dmnr_process(dmnr_t *p_dmnr, int16_t *p_samples, unsigned int pairs)
+{
+    const int16_t *p_in = p_samples;
+    int16_t *p_out      = p_samples;
+    unsigned int i;
+
+    for (i = 0; i < pairs; i++)
+    {
+        int16_t voice = *p_in++;
+        int16_t ref   = *p_in++;
+
+        *p_out++ = dmnr_sat16(dmnr_nlms(p_dmnr, voice, ref));
+    }
+
+    spns_process(&p_dmnr->spns, p_samples, pairs);
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ *
+ * @defgroup DMNR Dual-microphone noise reduction
+ * @{
+ * @ingroup  MOD_AUDIO
+ * @brief Fixed-point two-microphone noise reduction.
+ *
+ * @details The engine works in two stages:
+ *          - A normalized LMS adaptive filter predicts the noise present in the voice
+ *            microphone from the noise microphone and subtracts it. Adaptation is frozen
+ *            while the voice microphone is much louder than the noise microphone, so the
+ *            filter does not learn to cancel the speech itself.
+ *          - The residual is processed by the spectral noise suppressor (@ref SPNS),
+ *            which removes the noise that is not coherent between the microphones.
+ *
+ *          The library uses only the Opus FFT and the C library, so it can be built
+ *          and profiled on a host with the same FIXED_POINT/OPUS_BUILD definitions as
+ *          the firmware. Output is delayed by @ref SPNS_FFT_SIZE samples plus the
+ *          configured delay.
+ */
+#ifndef __DMNR_H__
+#define __DMNR_H__
+
+#include <stdint.h>
+#include "spns.h"
+
+/**@brief Noise reduction configuration. */
+typedef struct
+{
+    int16_t        *p_ref_history;  ///< Reference history buffer, 2 * filter_length samples.
+    int32_t        *p_weights;      ///< Adaptive filter weights, filter_length entries.
+    int16_t        *p_delay_line;   ///< Voice delay buffer, delay_length samples (may be NULL if delay_length is 0).
+    uint16_t        filter_length;  ///< Number of adaptive filter taps.
+    uint16_t        delay_length;   ///< Delay applied to the voice microphone, in samples.
+    uint16_t        step_size;      ///< NLMS step size in Q15.
+    uint16_t        gain_floor;     ///< Minimum spectral gain in Q15, see @ref spns_init.
+} dmnr_config_t;
+
+/**@brief Noise reduction state. */
+typedef struct
+{
+    dmnr_config_t           cfg;
+
+    /* Adaptive filter. */
+    uint16_t                ref_pos;
+    uint16_t                delay_pos;
+    int64_t                 ref_energy;
+    int32_t                 voice_level;
+    int32_t                 ref_level;
+
+    /* Spectral suppression. */
+    spns_t                  spns;
+} dmnr_t;
+
+/**@brief Initialize noise reduction.
+ *
+ * @param[out] p_dmnr   Pointer to the state to initialize.
+ * @param[in]  p_cfg    Configuration. Buffers referenced by it must stay valid while the state is in use.
+ *
+ * @return 0 on success, -1 if the configuration is invalid.
+ */
+int dmnr_init(dmnr_t *p_dmnr, const dmnr_config_t *p_cfg);
+
+/**@brief Process a block of samples.
+ *
+ * @param[in,out] p_dmnr    Pointer to the state.
+ * @param[in,out] p_samples Interleaved voice/noise sample pairs. Mono output is written in place.
+ * @param[in]     pairs     Number of sample pairs.
+ *
+ * @note The FFT work buffers are shared with @ref SPNS, so only one instance may be processed at a time.
+ */
+void dmnr_process(dmnr_t *p_dmnr, int16_t *p_samples, unsigned int pairs);
+
+#endif /* __DMNR_H__ */
+/** @} */
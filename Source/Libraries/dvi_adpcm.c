@@ -56,6 +56,75 @@ static const int16_t stepsizeTable[] = {
 
 #define stepsizeTableSize sizeof(stepsizeTable) / sizeof(int16_t)
 
+/** Reconstruction table used by the fast encoders.
+ *
+ *  Row i holds, for every 3-bit code magnitude m, the value vpdiff that the
+ *  successive-approximation quantizer adds for m with step = stepsizeTable[i]:
+ *  (step >> 3) plus the sum of the step parts selected by the bits of m.
+ *  The same sums are the quantizer decision thresholds, so one row is enough
+ *  to both pick the code and reconstruct the sample.
+ */
+#define VPDIFF_ROW(s)                                                          \
+    { ((s) >> 3),                                                              \
+      ((s) >> 3) + ((s) >> 2),                                                 \
+      ((s) >> 3) + ((s) >> 1),                                                 \
+      ((s) >> 3) + ((s) >> 1) + ((s) >> 2),                                    \
+      ((s) >> 3) + (s),                                                        \
+      ((s) >> 3) + (s) + ((s) >> 2),                                           \
+      ((s) >> 3) + (s) + ((s) >> 1),                                           \
+      ((s) >> 3) + (s) + ((s) >> 1) + ((s) >> 2) }
+
+static const int32_t vpdiffTable[][8] = {
+    VPDIFF_ROW(7),     VPDIFF_ROW(8),     VPDIFF_ROW(9),     VPDIFF_ROW(10),    VPDIFF_ROW(11),
+    VPDIFF_ROW(12),    VPDIFF_ROW(13),    VPDIFF_ROW(14),    VPDIFF_ROW(16),    VPDIFF_ROW(17),
+    VPDIFF_ROW(19),    VPDIFF_ROW(21),    VPDIFF_ROW(23),    VPDIFF_ROW(25),    VPDIFF_ROW(28),
+    VPDIFF_ROW(31),    VPDIFF_ROW(34),    VPDIFF_ROW(37),    VPDIFF_ROW(41),    VPDIFF_ROW(45),
+    VPDIFF_ROW(50),    VPDIFF_ROW(55),    VPDIFF_ROW(60),    VPDIFF_ROW(66),    VPDIFF_ROW(73),
+    VPDIFF_ROW(80),    VPDIFF_ROW(88),    VPDIFF_ROW(97),    VPDIFF_ROW(107),   VPDIFF_ROW(118),
+    VPDIFF_ROW(130),   VPDIFF_ROW(143),   VPDIFF_ROW(157),   VPDIFF_ROW(173),   VPDIFF_ROW(190),
+    VPDIFF_ROW(209),   VPDIFF_ROW(230),   VPDIFF_ROW(253),   VPDIFF_ROW(279),   VPDIFF_ROW(307),
+    VPDIFF_ROW(337),   VPDIFF_ROW(371),   VPDIFF_ROW(408),   VPDIFF_ROW(449),   VPDIFF_ROW(494),
+    VPDIFF_ROW(544),   VPDIFF_ROW(598),   VPDIFF_ROW(658),   VPDIFF_ROW(724),   VPDIFF_ROW(796),
+    VPDIFF_ROW(876),   VPDIFF_ROW(963),   VPDIFF_ROW(1060),  VPDIFF_ROW(1166),  VPDIFF_ROW(1282),
+    VPDIFF_ROW(1411),  VPDIFF_ROW(1552),  VPDIFF_ROW(1707),  VPDIFF_ROW(1878),  VPDIFF_ROW(2066),
+    VPDIFF_ROW(2272),  VPDIFF_ROW(2499),  VPDIFF_ROW(2749),  VPDIFF_ROW(3024),  VPDIFF_ROW(3327),
+    VPDIFF_ROW(3660),  VPDIFF_ROW(4026),  VPDIFF_ROW(4428),  VPDIFF_ROW(4871),  VPDIFF_ROW(5358),
+    VPDIFF_ROW(5894),  VPDIFF_ROW(6484),  VPDIFF_ROW(7132),  VPDIFF_ROW(7845),  VPDIFF_ROW(8630),
+    VPDIFF_ROW(9493),  VPDIFF_ROW(10442), VPDIFF_ROW(11487), VPDIFF_ROW(12635), VPDIFF_ROW(13899),
+    VPDIFF_ROW(15289), VPDIFF_ROW(16818), VPDIFF_ROW(18500), VPDIFF_ROW(20350), VPDIFF_ROW(22385),
+    VPDIFF_ROW(24623), VPDIFF_ROW(27086), VPDIFF_ROW(29794), VPDIFF_ROW(32767)
+};
+
+/** Step index that follows each index and code magnitude, already clamped. */
+#define NEXT_INDEX(i, d)    ((((i) + (d)) < 0) ? 0 : ((((i) + (d)) > 88) ? 88 : ((i) + (d))))
+#define NEXT_INDEX_ROW(i)                                                      \
+    { NEXT_INDEX(i, -1), NEXT_INDEX(i, -1), NEXT_INDEX(i, -1), NEXT_INDEX(i, -1), \
+      NEXT_INDEX(i, 2),  NEXT_INDEX(i, 4),  NEXT_INDEX(i, 6),  NEXT_INDEX(i, 8) }
+
+static const uint8_t nextIndexTable[][8] = {
+    NEXT_INDEX_ROW(0),  NEXT_INDEX_ROW(1),  NEXT_INDEX_ROW(2),  NEXT_INDEX_ROW(3),  NEXT_INDEX_ROW(4),
+    NEXT_INDEX_ROW(5),  NEXT_INDEX_ROW(6),  NEXT_INDEX_ROW(7),  NEXT_INDEX_ROW(8),  NEXT_INDEX_ROW(9),
+    NEXT_INDEX_ROW(10), NEXT_INDEX_ROW(11), NEXT_INDEX_ROW(12), NEXT_INDEX_ROW(13), NEXT_INDEX_ROW(14),
+    NEXT_INDEX_ROW(15), NEXT_INDEX_ROW(16), NEXT_INDEX_ROW(17), NEXT_INDEX_ROW(18), NEXT_INDEX_ROW(19),
+    NEXT_INDEX_ROW(20), NEXT_INDEX_ROW(21), NEXT_INDEX_ROW(22), NEXT_INDEX_ROW(23), NEXT_INDEX_ROW(24),
+    NEXT_INDEX_ROW(25), NEXT_INDEX_ROW(26), NEXT_INDEX_ROW(27), NEXT_INDEX_ROW(28), NEXT_INDEX_ROW(29),
+    NEXT_INDEX_ROW(30), NEXT_INDEX_ROW(31), NEXT_INDEX_ROW(32), NEXT_INDEX_ROW(33), NEXT_INDEX_ROW(34),
+    NEXT_INDEX_ROW(35), NEXT_INDEX_ROW(36), NEXT_INDEX_ROW(37), NEXT_INDEX_ROW(38), NEXT_INDEX_ROW(39),
+    NEXT_INDEX_ROW(40), NEXT_INDEX_ROW(41), NEXT_INDEX_ROW(42), NEXT_INDEX_ROW(43), NEXT_INDEX_ROW(44),
+    NEXT_INDEX_ROW(45), NEXT_INDEX_ROW(46), NEXT_INDEX_ROW(47), NEXT_INDEX_ROW(48), NEXT_INDEX_ROW(49),
+    NEXT_INDEX_ROW(50), NEXT_INDEX_ROW(51), NEXT_INDEX_ROW(52), NEXT_INDEX_ROW(53), NEXT_INDEX_ROW(54),
+    NEXT_INDEX_ROW(55), NEXT_INDEX_ROW(56), NEXT_INDEX_ROW(57), NEXT_INDEX_ROW(58), NEXT_INDEX_ROW(59),
+    NEXT_INDEX_ROW(60), NEXT_INDEX_ROW(61), NEXT_INDEX_ROW(62), NEXT_INDEX_ROW(63), NEXT_INDEX_ROW(64),
+    NEXT_INDEX_ROW(65), NEXT_INDEX_ROW(66), NEXT_INDEX_ROW(67), NEXT_INDEX_ROW(68), NEXT_INDEX_ROW(69),
+    NEXT_INDEX_ROW(70), NEXT_INDEX_ROW(71), NEXT_INDEX_ROW(72), NEXT_INDEX_ROW(73), NEXT_INDEX_ROW(74),
+    NEXT_INDEX_ROW(75), NEXT_INDEX_ROW(76), NEXT_INDEX_ROW(77), NEXT_INDEX_ROW(78), NEXT_INDEX_ROW(79),
+    NEXT_INDEX_ROW(80), NEXT_INDEX_ROW(81), NEXT_INDEX_ROW(82), NEXT_INDEX_ROW(83), NEXT_INDEX_ROW(84),
+    NEXT_INDEX_ROW(85), NEXT_INDEX_ROW(86), NEXT_INDEX_ROW(87), NEXT_INDEX_ROW(88)
+};
+
+/** Sum of squared errors used by the lookahead encoder. */
+typedef uint64_t dvi_adpcm_cost_t;
+
 void dvi_adpcm_init_state(dvi_adpcm_state_t * state)
 {
     state->valpred = 0;
@@ -178,3 +247,198 @@ int dvi_adpcm_encode(void *in_buf, int in_size, void *out_buf, int *out_size, vo
     return 0;
 }
 
+/**
+ * Quantize one sample and update the predictor.
+ *
+ * Equivalent of steps 1 - 5 of dvi_adpcm_encode() without data-dependent
+ * branches, apart from the clamp that is rarely taken. The decision thresholds
+ * of codes 4 - 7 are the step plus those of codes 0 - 3, so after the first
+ * decision the low two bits of the magnitude are the number of thresholds
+ * reached, found with independent comparisons instead of a chain.
+ */
+static __inline int32_t dvi_adpcm_quantize(int32_t val, int32_t *p_valpred, int32_t *p_index)
+{
+    const int32_t *row = vpdiffTable[*p_index];
+    int32_t diff = val - *p_valpred;
+    int32_t neg  = diff >> 31;              /* -1 if diff < 0, else 0 */
+    int32_t hi;
+    int32_t mag;
+    int32_t valpred;
+
+    /* diff >= threshold(m) <=> |diff| + row[0] >= row[m] */
+    diff  = ((diff ^ neg) - neg) + row[0];
+    hi    = -(diff >= row[4]);            /* -1 for codes 4 - 7, else 0 */
+    diff -= (row[4] - row[0]) & hi;       /* row[4] - row[0] is the step */
+    mag   = (hi & 4) + (diff >= row[1]) + (diff >= row[2]) + (diff >= row[3]);
+
+    valpred = *p_valpred + ((row[mag] ^ neg) - neg);
+    if ((uint32_t)(valpred - INT16_MIN) > UINT16_MAX)
+    {
+        valpred = (valpred < 0) ? INT16_MIN : INT16_MAX;
+    }
+
+    *p_valpred = valpred;
+    *p_index   = nextIndexTable[*p_index][mag];
+
+    return mag | (neg & 8);
+}
+
+/**
+ * Update the predictor with a given code, as the decoder does.
+ */
+static __inline void dvi_adpcm_apply(int32_t delta, int32_t *p_valpred, int32_t *p_index)
+{
+    int32_t vpdiff  = vpdiffTable[*p_index][delta & 7];
+    int32_t valpred = *p_valpred + ((delta & 8) ? -vpdiff : vpdiff);
+
+    valpred = (valpred > INT16_MAX) ? INT16_MAX : valpred;
+    valpred = (valpred < INT16_MIN) ? INT16_MIN : valpred;
+
+    *p_valpred = valpred;
+    *p_index   = nextIndexTable[*p_index][delta & 7];
+}
+
+/**
+ * Write the optional header and return the pointer to the first code byte.
+ */
+static int8_t * dvi_adpcm_header(void *out_buf, int in_samples, int *out_size, dvi_adpcm_state_t *state, bool header_flag)
+{
+    int8_t *out_sbuf = out_buf;
+
+    *out_size = in_samples / 2;
+
+    if (header_flag)
+    {
+        ((dvi_adpcm_state_t *)out_buf)->valpred = htons(state->valpred);
+        ((dvi_adpcm_state_t *)out_buf)->index = state->index;
+        *out_size += sizeof(dvi_adpcm_state_t);
+        out_sbuf  += sizeof(dvi_adpcm_state_t);
+    }
+
+    return out_sbuf;
+}
+
+int dvi_adpcm_encode_fast(void *in_buf, int in_size, void *out_buf, int *out_size, void *state_, bool header_flag)
+{
+    dvi_adpcm_state_t *state = (dvi_adpcm_state_t *)state_;
+    const int16_t *s = (const int16_t *)in_buf;
+    int32_t valpred = state->valpred;
+    int32_t index   = state->index;
+    int32_t delta;
+    uint8_t *out_sbuf;
+
+    in_size /= 2;
+    out_sbuf = (uint8_t *)dvi_adpcm_header(out_buf, in_size, out_size, state, header_flag);
+
+    /* Two samples per iteration, one output byte each. */
+    for (; in_size > 1; in_size -= 2)
+    {
+        delta       = dvi_adpcm_quantize(*s++, &valpred, &index) << 4;
+        delta      |= dvi_adpcm_quantize(*s++, &valpred, &index);
+        *out_sbuf++ = (uint8_t)delta;
+    }
+
+    if (in_size)
+    {
+        *out_sbuf++ = (uint8_t)(dvi_adpcm_quantize(*s++, &valpred, &index) << 4);
+    }
+
+    state->valpred   = (int16_t)valpred;
+    state->index     = index;
+    return 0;
+}
+
+/**
+ * Squared error of the plain encoder over the next samples.
+ */
+static dvi_adpcm_cost_t dvi_adpcm_greedy_cost(const int16_t *s, int count, int32_t valpred, int32_t index)
+{
+    dvi_adpcm_cost_t cost = 0;
+    int32_t err;
+
+    for (; count > 0; --count)
+    {
+        (void)dvi_adpcm_quantize(*s, &valpred, &index);
+        err   = *s++ - valpred;
+        cost += (dvi_adpcm_cost_t)((int64_t)err * err);
+    }
+
+    return cost;
+}
+
+int dvi_adpcm_encode_lookahead(void *in_buf, int in_size, void *out_buf, int *out_size, void *state_, bool header_flag, int depth)
+{
+    dvi_adpcm_state_t *state = (dvi_adpcm_state_t *)state_;
+    const int16_t *s = (const int16_t *)in_buf;
+    int32_t valpred = state->valpred;
+    int32_t index   = state->index;
+    int32_t outputbuffer = 0;
+    int32_t bufferstep = 1;
+    uint8_t *out_sbuf;
+    int n;
+
+    in_size /= 2;
+    out_sbuf = (uint8_t *)dvi_adpcm_header(out_buf, in_size, out_size, state, header_flag);
+
+    for (n = 0; n < in_size; ++n)
+    {
+        /* Samples past the end of this buffer are not known yet. */
+        int ahead = ((in_size - n - 1) < depth) ? (in_size - n - 1) : depth;
+        int32_t cand_valpred = valpred;
+        int32_t cand_index = index;
+        int32_t greedy;
+        int32_t delta;
+        int32_t mag;
+        int32_t err;
+        dvi_adpcm_cost_t cost;
+        dvi_adpcm_cost_t best_cost;
+
+        /* Start from the plain encoder decision... */
+        greedy    = dvi_adpcm_quantize(s[n], &cand_valpred, &cand_index);
+        err       = s[n] - cand_valpred;
+        best_cost = (dvi_adpcm_cost_t)((int64_t)err * err) +
+                    dvi_adpcm_greedy_cost(&s[n + 1], ahead, cand_valpred, cand_index);
+        delta     = greedy;
+
+        /* ...and check whether a neighbouring magnitude does better over the lookahead window. */
+        for (mag = (greedy & 7) - 1; mag <= (greedy & 7) + 1; mag += 2)
+        {
+            if ((mag < 0) || (mag > 7))
+            {
+                continue;
+            }
+
+            cand_valpred = valpred;
+            cand_index   = index;
+            dvi_adpcm_apply(mag | (greedy & 8), &cand_valpred, &cand_index);
+
+            err  = s[n] - cand_valpred;
+            cost = (dvi_adpcm_cost_t)((int64_t)err * err) +
+                   dvi_adpcm_greedy_cost(&s[n + 1], ahead, cand_valpred, cand_index);
+
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                delta     = mag | (greedy & 8);
+            }
+        }
+
+        dvi_adpcm_apply(delta, &valpred, &index);
+
+        if (bufferstep)
+        {
+            outputbuffer = (delta << 4) & 0xf0;
+        }
+        else
+        {
+            *out_sbuf++ = (uint8_t)((delta & 0x0f) | outputbuffer);
+        }
+        bufferstep = !bufferstep;
+    }
+    /* Output last step, if needed. */
+    if (!bufferstep) *out_sbuf++ = (uint8_t)outputbuffer;
+
+    state->valpred   = (int16_t)valpred;
+    state->index     = index;
+    return 0;
+}
@@ -55,6 +55,26 @@ typedef struct __attribute__((__packed__))
 
 int dvi_adpcm_encode(void *in_buf, int in_size, void *out_buf, int *out_size, void *state, bool hflag);
 
+/**
+ * Encode samples with the table-driven encoder.
+ *
+ * Produces exactly the same output as dvi_adpcm_encode(), with fewer branches
+ * and one output byte written per two samples.
+ */
+int dvi_adpcm_encode_fast(void *in_buf, int in_size, void *out_buf, int *out_size, void *state, bool hflag);
+
+/**
+ * Encode samples choosing every code with a lookahead.
+ *
+ * For each sample the code of the plain encoder and its two neighbouring
+ * magnitudes are tried, and the one giving the smallest squared error over
+ * this and the next @p depth samples (encoded by the plain encoder) is kept.
+ * The output is a regular IMA/DVI ADPCM stream that any decoder accepts.
+ *
+ * @arg[in] depth : Number of samples to look ahead, limited to the input buffer.
+ */
+int dvi_adpcm_encode_lookahead(void *in_buf, int in_size, void *out_buf, int *out_size, void *state, bool hflag, int depth);
+
 /**
  * Initialize encoder state.
  *
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @file
+ * @brief Smart Remote 3 platform support for Opus.
+ *
+ * Opus is built with NONTHREADSAFE_PSEUDOSTACK, so all temporary buffers are taken
+ * from a static scratch arena owned by the Opus codec driver instead of the stack.
+ * Every allocation is checked against the end of the arena before the buffer is used.
+ */
+
+#ifndef CUSTOM_SUPPORT_H
+#define CUSTOM_SUPPORT_H
+
+#include <stddef.h>
+#include "opus_defines.h"
+
+/**@brief Function for getting the Opus scratch arena.
+ *
+ * @param[in] size  Size requested by Opus (GLOBAL_STACK_SIZE). It is not used, as the
+ *                  arena is sized for the configured codec mode and every allocation is checked.
+ *
+ * @return Pointer to the scratch arena.
+ */
+void *drv_audio_codec_opus_scratch_get(size_t size);
+
+/**@brief Function for checking an Opus scratch allocation.
+ *
+ * @param[in] p_top  End of the latest allocation. It must not be past the end of the arena.
+ */
+void drv_audio_codec_opus_scratch_check(char const *p_top);
+
+#define OPUS_CHECK_SCRATCH(stack) drv_audio_codec_opus_scratch_check(stack)
+
+#define OVERRIDE_OPUS_ALLOC_SCRATCH
+static OPUS_INLINE void *opus_alloc_scratch(size_t size)
+{
+    return drv_audio_codec_opus_scratch_get(size);
+}
+
+#endif /* CUSTOM_SUPPORT_H */
@@ -141,7 +141,9 @@ extern char *global_stack_top;
 #else
 
 #define ALIGN(stack, size) ((stack) += ((size) - (long)(stack)) & ((size) - 1))
-#define PUSH(stack, size, type) (ALIGN((stack),sizeof(type)/sizeof(char)),(stack)+=(size)*(sizeof(type)/sizeof(char)),(type*)((stack)-(size)*(sizeof(type)/sizeof(char))))
+/* Align every buffer like alloca() does. Aligning to the element size is not enough for the
+   32-bit accesses made by the ARM EDSP pitch correlation, nor for structures of odd sizes. */
+#define PUSH(stack, size, type) (ALIGN((stack),8),(stack)+=(size)*(sizeof(type)/sizeof(char)),OPUS_CHECK_SCRATCH(stack),(type*)((stack)-(size)*(sizeof(type)/sizeof(char))))
 #if 0 /* Set this to 1 to instrument pseudostack usage */
 #define RESTORE_STACK (printf("%ld %s:%d\n", global_stack-scratch_ptr, __FILE__, __LINE__),global_stack = _saved_stack)
 #else
@@ -152,6 +154,10 @@ extern char *global_stack_top;
 #endif /* ENABLE_VALGRIND */
 
 #include "os_support.h"
+/* Platforms with a fixed scratch size can check every allocation before it is used */
+#ifndef OPUS_CHECK_SCRATCH
+#define OPUS_CHECK_SCRATCH(stack) ((void)0)
+#endif
 #define VARDECL(type, var) type *var
 #define ALLOC(var, size, type) var = PUSH(global_stack, size, type)
 #define SAVE_STACK char *_saved_stack = global_stack;
@@ -47,6 +47,20 @@
 /* Added for Smart Remote 3 nRF52 */
 #define SBC_JOINT_STE_INCLUDED FALSE
 
+/* Added for Smart Remote 3 nRF52 */
+/* Set SBC_POLYPHASE_OPT to TRUE to use the polyphase analysis filter (sbc_analysis_poly.c) */
+/* instead of the shifting one. Both produce bit-exact output. */
+#ifndef SBC_POLYPHASE_OPT
+#define SBC_POLYPHASE_OPT TRUE
+#endif
+
+/* Added for Smart Remote 3 nRF52 */
+/* Set SBC_BIT_ALLOC_CACHE to TRUE to skip the bit allocation when the scale factors, */
+/* bitpool and allocation method are the same as in the previous frame. */
+#ifndef SBC_BIT_ALLOC_CACHE
+#define SBC_BIT_ALLOC_CACHE TRUE
+#endif
+
 #define SBC_MAX_NUM_OF_SUBBANDS 8
 /* Changed for Smart Remote 3 nRF52 (was: 2) */
 #define SBC_MAX_NUM_OF_CHANNELS 1
@@ -193,6 +207,14 @@ typedef struct SBC_ENC_PARAMS_TAG
 
     SINT16 as16Bits[SBC_MAX_NUM_OF_CHANNELS*SBC_MAX_NUM_OF_SUBBANDS];
 
+    /* Added for Smart Remote 3 nRF52 */
+#if (SBC_BIT_ALLOC_CACHE == TRUE)
+    SINT16 as16CachedScaleFactor[SBC_MAX_NUM_OF_CHANNELS*SBC_MAX_NUM_OF_SUBBANDS];
+    SINT16 s16CachedBitPool;
+    SINT16 s16CachedAllocationMethod;
+    UINT8  u8BitAllocCacheValid;
+#endif
+
     UINT8  *pu8Packet;
     UINT8  *pu8NextPacket;
     UINT16 FrameHeader;
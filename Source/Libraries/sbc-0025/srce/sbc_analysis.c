@@ -27,6 +27,9 @@
 #include "sbc_enc_func_declare.h"
 /*#include <math.h>*/
 
+/* Changed for Smart Remote 3 nRF52: replaced by sbc_analysis_poly.c if SBC_POLYPHASE_OPT is set. */
+#if (SBC_POLYPHASE_OPT == FALSE)
+
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
 #define WIND_4_SUBBANDS_0_1 (SINT32)0x01659F45  /* gas32CoeffFor4SBs[8] = -gas32CoeffFor4SBs[32] = 0x01659F45 */
 #define WIND_4_SUBBANDS_0_2 (SINT32)0x115B1ED2  /* gas32CoeffFor4SBs[16] = -gas32CoeffFor4SBs[24] = 0x115B1ED2 */
@@ -1106,3 +1109,4 @@ void SbcAnalysisInit (void)
     memset(s16X,0,ENC_VX_BUFFER_SIZE*sizeof(SINT16));
     ShiftCounter=0;
 }
+#endif /* SBC_POLYPHASE_OPT == FALSE */
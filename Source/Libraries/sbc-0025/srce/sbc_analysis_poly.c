@@ -0,0 +1,208 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 1999-2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  This file contains the polyphase variant of the analysis filter. It
+ *  produces exactly the same subband samples as sbc_analysis.c, but keeps
+ *  the input history in a transposed layout: for every phase the samples
+ *  used by one output are stored next to each other, so both the history and
+ *  the window coefficients are read contiguously and two taps can be
+ *  accumulated with a single dual 16x16+32 multiply-accumulate.
+ *
+ *  Added for Smart Remote 3 nRF52.
+ *
+ ******************************************************************************/
+#include <string.h>
+#include "sbc_encoder.h"
+#include "sbc_enc_func_declare.h"
+
+#if (SBC_POLYPHASE_OPT == TRUE)
+
+/* Every phase of the window feeds two outputs with 5 taps each: s32DCTY[sb]
+ * uses the history samples of even age (in blocks) and s32DCTY[sb + NumOfSubBands]
+ * the ones of odd age. */
+#define SBC_POLY_TAPS   5
+
+/* Two 16-bit window coefficients packed into one word, the first one in the lower half. */
+#define SBC_COEFF_PAIR(c0, c1)  ((SINT32)(((UINT32)(UINT16)(c1) << 16) | (UINT16)(c0)))
+
+/* Window coefficients (the same values as WIND_x_SUBBANDS_y_z in sbc_analysis.c), ordered
+ * by phase and padded to 3 pairs per output. */
+static const SINT32 as32PolyCoeff4SBs[SUB_BANDS_4 * 2 * 3] =
+{
+    SBC_COEFF_PAIR(     0,    358), SBC_COEFF_PAIR(  4443,  -4443), SBC_COEFF_PAIR(  -358,      0),   /* s32DCTY[0] */
+    SBC_COEFF_PAIR(   126,    848), SBC_COEFF_PAIR(  9644,    848), SBC_COEFF_PAIR(   126,      0),   /* s32DCTY[4] */
+    SBC_COEFF_PAIR(    18,    670), SBC_COEFF_PAIR(  6389,  -2544), SBC_COEFF_PAIR(  -100,      0),   /* s32DCTY[1] */
+    SBC_COEFF_PAIR(   128,    201), SBC_COEFF_PAIR(  9235,   1055), SBC_COEFF_PAIR(    90,      0),   /* s32DCTY[5] */
+    SBC_COEFF_PAIR(    49,    946), SBC_COEFF_PAIR(  8081,   -944), SBC_COEFF_PAIR(    61,      0),   /* s32DCTY[2] */
+    SBC_COEFF_PAIR(    61,   -944), SBC_COEFF_PAIR(  8081,    946), SBC_COEFF_PAIR(    49,      0),   /* s32DCTY[6] */
+    SBC_COEFF_PAIR(    90,   1055), SBC_COEFF_PAIR(  9235,    201), SBC_COEFF_PAIR(   128,      0),   /* s32DCTY[3] */
+    SBC_COEFF_PAIR(  -100,  -2544), SBC_COEFF_PAIR(  6389,    670), SBC_COEFF_PAIR(    18,      0)    /* s32DCTY[7] */
+};
+
+static const SINT32 as32PolyCoeff8SBs[SUB_BANDS_8 * 2 * 3] =
+{
+    SBC_COEFF_PAIR(     0,    185), SBC_COEFF_PAIR(  2228,  -2228), SBC_COEFF_PAIR(  -185,      0),   /* s32DCTY[0] */
+    SBC_COEFF_PAIR(    66,    424), SBC_COEFF_PAIR(  4815,    424), SBC_COEFF_PAIR(    66,      0),   /* s32DCTY[8] */
+    SBC_COEFF_PAIR(     5,    263), SBC_COEFF_PAIR(  2719,  -1743), SBC_COEFF_PAIR(  -115,      0),   /* s32DCTY[1] */
+    SBC_COEFF_PAIR(    69,    290), SBC_COEFF_PAIR(  4764,    502), SBC_COEFF_PAIR(    58,      0),   /* s32DCTY[9] */
+    SBC_COEFF_PAIR(    11,    343), SBC_COEFF_PAIR(  3197,  -1280), SBC_COEFF_PAIR(   -54,      0),   /* s32DCTY[2] */
+    SBC_COEFF_PAIR(    65,     96), SBC_COEFF_PAIR(  4612,    532), SBC_COEFF_PAIR(    48,      0),   /* s32DCTY[10] */
+    SBC_COEFF_PAIR(    18,    418), SBC_COEFF_PAIR(  3644,   -856), SBC_COEFF_PAIR(    -6,      0),   /* s32DCTY[3] */
+    SBC_COEFF_PAIR(    53,   -161), SBC_COEFF_PAIR(  4367,    521), SBC_COEFF_PAIR(    37,      0),   /* s32DCTY[11] */
+    SBC_COEFF_PAIR(    27,    480), SBC_COEFF_PAIR(  4039,   -480), SBC_COEFF_PAIR(    30,      0),   /* s32DCTY[4] */
+    SBC_COEFF_PAIR(    30,   -480), SBC_COEFF_PAIR(  4039,    480), SBC_COEFF_PAIR(    27,      0),   /* s32DCTY[12] */
+    SBC_COEFF_PAIR(    37,    521), SBC_COEFF_PAIR(  4367,   -161), SBC_COEFF_PAIR(    53,      0),   /* s32DCTY[5] */
+    SBC_COEFF_PAIR(    -6,   -856), SBC_COEFF_PAIR(  3644,    418), SBC_COEFF_PAIR(    18,      0),   /* s32DCTY[13] */
+    SBC_COEFF_PAIR(    48,    532), SBC_COEFF_PAIR(  4612,     96), SBC_COEFF_PAIR(    65,      0),   /* s32DCTY[6] */
+    SBC_COEFF_PAIR(   -54,  -1280), SBC_COEFF_PAIR(  3197,    343), SBC_COEFF_PAIR(    11,      0),   /* s32DCTY[14] */
+    SBC_COEFF_PAIR(    58,    502), SBC_COEFF_PAIR(  4764,    290), SBC_COEFF_PAIR(    69,      0),   /* s32DCTY[7] */
+    SBC_COEFF_PAIR(  -115,  -1743), SBC_COEFF_PAIR(  2719,    263), SBC_COEFF_PAIR(     5,      0)    /* s32DCTY[15] */
+};
+
+#if defined(__GNUC__) && defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define SBC_POLY_DUAL_MAC TRUE
+static __inline SINT32 sbc_poly_smlad(UINT32 u32X, SINT32 s32C, SINT32 s32Acc)
+{
+    __asm__ ("smlad %0, %1, %2, %3" : "=r" (s32Acc) : "r" (u32X), "r" (s32C), "r" (s32Acc));
+    return s32Acc;
+}
+#elif defined(__CC_ARM) && defined(__TARGET_FEATURE_DSPMUL)
+#define SBC_POLY_DUAL_MAC TRUE
+#define sbc_poly_smlad(u32X, s32C, s32Acc) __smlad((u32X), (s32C), (s32Acc))
+#else
+#define SBC_POLY_DUAL_MAC FALSE
+#endif
+
+/* History rings, one pair (even and odd sample age) per channel and phase. Each ring
+ * is stored twice so that it can be read linearly from any start position. */
+static SINT16   s16PolyHist[SBC_MAX_NUM_OF_CHANNELS][SUB_BANDS_8][2][2 * SBC_POLY_TAPS];
+static UINT8    u8PolyPos[2];   /* Position of the newest sample in ring 0 and 1. */
+static UINT8    u8PolyEven;     /* Ring currently holding the samples of even age. */
+static SINT32   s32DCTY[16];
+
+/****************************************************************************
+* sbc_poly_dot - 5-tap window product of one history ring
+*
+* RETURNS : sum of ps16X[k] * coefficient k
+*/
+static __inline SINT32 sbc_poly_dot(const SINT16 *ps16X, const SINT32 *ps32C)
+{
+#if (SBC_POLY_DUAL_MAC == TRUE)
+    UINT32 u32X01, u32X23;
+    SINT32 s32Acc;
+
+    memcpy(&u32X01, &ps16X[0], sizeof(u32X01));
+    memcpy(&u32X23, &ps16X[2], sizeof(u32X23));
+
+    s32Acc = (SINT32)ps16X[4] * (SINT16)ps32C[2];
+    s32Acc = sbc_poly_smlad(u32X01, ps32C[0], s32Acc);
+    return sbc_poly_smlad(u32X23, ps32C[1], s32Acc);
+#else
+    return (SINT32)ps16X[0] * (SINT16)ps32C[0]
+         + (SINT32)ps16X[1] * (SINT16)(ps32C[0] >> 16)
+         + (SINT32)ps16X[2] * (SINT16)ps32C[1]
+         + (SINT32)ps16X[3] * (SINT16)(ps32C[1] >> 16)
+         + (SINT32)ps16X[4] * (SINT16)ps32C[2];
+#endif
+}
+
+/****************************************************************************
+* sbc_poly_analysis - performs Analysis of the input audio stream
+*
+* RETURNS : N/A
+*/
+static void sbc_poly_analysis(SBC_ENC_PARAMS *pstrEncParams,
+                              SINT32 s32NumOfSubBands,
+                              const SINT32 *ps32Coeff)
+{
+    SINT16 *ps16PcmBuf;
+    SINT32 *ps32SbBuf;
+    SINT16 *ps16Even, *ps16Odd;
+    const SINT32 *ps32C;
+    SINT32  s32Blk, s32Ch, s32Sb;
+    SINT32  s32NumOfChannels, s32NumOfBlocks;
+    UINT32  u32Even, u32Odd, u32Pos;
+
+    s32NumOfChannels = pstrEncParams->s16NumOfChannels;
+    s32NumOfBlocks   = pstrEncParams->s16NumOfBlocks;
+
+    ps16PcmBuf = pstrEncParams->ps16NextPcmBuffer;
+    ps32SbBuf  = pstrEncParams->s32SbBuffer;
+
+    for (s32Blk = 0; s32Blk < s32NumOfBlocks; s32Blk++)
+    {
+        /* The ring holding the odd-age samples drops its oldest one and takes the
+         * new block, the samples of the other ring age by one block. */
+        u32Odd  = u8PolyEven;
+        u32Even = u32Odd ^ 1;
+        u32Pos  = (u8PolyPos[u32Even] == 0) ? (SBC_POLY_TAPS - 1) : (u8PolyPos[u32Even] - 1U);
+
+        u8PolyPos[u32Even] = (UINT8)u32Pos;
+        u8PolyEven         = (UINT8)u32Even;
+
+        for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++)
+        {
+            ps32C = ps32Coeff;
+
+            for (s32Sb = 0; s32Sb < s32NumOfSubBands; s32Sb++)
+            {
+                ps16Even = s16PolyHist[s32Ch][s32Sb][u32Even];
+                ps16Odd  = s16PolyHist[s32Ch][s32Sb][u32Odd];
+
+                /* Samples of a block arrive oldest first, phase s32Sb takes the one of age s32Sb. */
+                ps16Even[u32Pos] = ps16PcmBuf[(s32NumOfSubBands - 1 - s32Sb) * s32NumOfChannels + s32Ch];
+                ps16Even[u32Pos + SBC_POLY_TAPS] = ps16Even[u32Pos];
+
+                s32DCTY[s32Sb]                    = sbc_poly_dot(&ps16Even[u32Pos], &ps32C[0]);
+                s32DCTY[s32Sb + s32NumOfSubBands] = sbc_poly_dot(&ps16Odd[u8PolyPos[u32Odd]], &ps32C[3]);
+
+                ps32C += 6;
+            }
+
+            if (s32NumOfSubBands == SUB_BANDS_4)
+                SBC_FastIDCT4(s32DCTY, ps32SbBuf);
+            else
+                SBC_FastIDCT8(s32DCTY, ps32SbBuf);
+
+            ps32SbBuf += s32NumOfSubBands;
+        }
+
+        ps16PcmBuf += s32NumOfSubBands * s32NumOfChannels;
+    }
+}
+
+void SbcAnalysisFilter4(SBC_ENC_PARAMS *pstrEncParams)
+{
+    sbc_poly_analysis(pstrEncParams, SUB_BANDS_4, as32PolyCoeff4SBs);
+}
+
+void SbcAnalysisFilter8(SBC_ENC_PARAMS *pstrEncParams)
+{
+    sbc_poly_analysis(pstrEncParams, SUB_BANDS_8, as32PolyCoeff8SBs);
+}
+
+void SbcAnalysisInit(void)
+{
+    memset(s16PolyHist, 0, sizeof(s16PolyHist));
+    memset(u8PolyPos, 0, sizeof(u8PolyPos));
+    u8PolyEven = 0;
+}
+
+#endif /* SBC_POLYPHASE_OPT == TRUE */
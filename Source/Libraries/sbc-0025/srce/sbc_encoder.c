@@ -113,6 +113,35 @@ SINT32   s32LRDiff[SBC_MAX_NUM_OF_BLOCKS]    = {0};
 SINT32   s32LRSum[SBC_MAX_NUM_OF_BLOCKS]     = {0};
 #endif
 
+#if (SBC_BIT_ALLOC_CACHE == TRUE)
+/****************************************************************************
+* sbc_enc_bit_alloc_cached - checks whether the bit allocation of the previous
+* frame can be reused and updates the cache key otherwise
+*
+* RETURNS : TRUE if as16Bits is up to date
+*/
+static UINT8 sbc_enc_bit_alloc_cached(SBC_ENC_PARAMS *pstrEncParams)
+{
+    UINT32 u32ScfSize = pstrEncParams->s16NumOfChannels *
+                        pstrEncParams->s16NumOfSubBands * sizeof(SINT16);
+
+    if (pstrEncParams->u8BitAllocCacheValid &&
+        (pstrEncParams->s16CachedBitPool == pstrEncParams->s16BitPool) &&
+        (pstrEncParams->s16CachedAllocationMethod == pstrEncParams->s16AllocationMethod) &&
+        (memcmp(pstrEncParams->as16CachedScaleFactor, pstrEncParams->as16ScaleFactor, u32ScfSize) == 0))
+    {
+        return TRUE;
+    }
+
+    memcpy(pstrEncParams->as16CachedScaleFactor, pstrEncParams->as16ScaleFactor, u32ScfSize);
+    pstrEncParams->s16CachedBitPool          = pstrEncParams->s16BitPool;
+    pstrEncParams->s16CachedAllocationMethod = pstrEncParams->s16AllocationMethod;
+    pstrEncParams->u8BitAllocCacheValid      = TRUE;
+
+    return FALSE;
+}
+#endif
+
 void SBC_Encoder(SBC_ENC_PARAMS *pstrEncParams)
 {
     SINT32 s32Ch;                               /* counter for ch*/
@@ -261,10 +290,17 @@ void SBC_Encoder(SBC_ENC_PARAMS *pstrEncParams)
         pstrEncParams->s16MaxBitNeed = (SINT16)maxBit;
 
         /* bit allocation */
-        if ((pstrEncParams->s16ChannelMode == SBC_STEREO) || (pstrEncParams->s16ChannelMode == SBC_JOINT_STEREO))
-            sbc_enc_bit_alloc_ste(pstrEncParams);
-        else
-            sbc_enc_bit_alloc_mono(pstrEncParams);
+#if (SBC_BIT_ALLOC_CACHE == TRUE)
+        /* Added for Smart Remote 3 nRF52: as16Bits depends only on the scale factors, */
+        /* bitpool and allocation method, so it is still valid if none of them changed. */
+        if (!sbc_enc_bit_alloc_cached(pstrEncParams))
+#endif
+        {
+            if ((pstrEncParams->s16ChannelMode == SBC_STEREO) || (pstrEncParams->s16ChannelMode == SBC_JOINT_STEREO))
+                sbc_enc_bit_alloc_ste(pstrEncParams);
+            else
+                sbc_enc_bit_alloc_mono(pstrEncParams);
+        }
 
         /* save the beginning of the frame. pu8NextPacket is modified in EncPacking() */
         // pu8 = pstrEncParams->pu8NextPacket;
@@ -410,6 +446,10 @@ void SBC_Encoder_Init(SBC_ENC_PARAMS *pstrEncParams)
 
     SbcAnalysisInit();
 
+#if (SBC_BIT_ALLOC_CACHE == TRUE)
+    pstrEncParams->u8BitAllocCacheValid = FALSE;
+#endif
+
     memset(&sbc_prtc_cb, 0, sizeof(tSBC_PRTC_CB));
     sbc_prtc_cb.base = 6 + pstrEncParams->s16NumOfChannels*pstrEncParams->s16NumOfSubBands/2;
 }
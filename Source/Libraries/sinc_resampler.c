@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sinc_resampler.h"
+
+#define SINC_RESAMPLER_TABLE_SIZE    (SINC_RESAMPLER_ZERO_CROSSINGS * SINC_RESAMPLER_TABLE_STEPS + 1)
+
+/* Distances are Q16 fractions of an input sample; this shift turns them into table indexes. */
+#define SINC_RESAMPLER_INDEX_SHIFT   (16 - SINC_RESAMPLER_TABLE_STEPS_LOG2)
+#define SINC_RESAMPLER_INDEX_MASK    ((1ul << SINC_RESAMPLER_INDEX_SHIFT) - 1)
+
+/*
+ * Right half of the interpolation filter, Q15: h(d) = fc * sinc(fc * d) * kaiser(d / Nz, beta),
+ * sampled at d = i / SINC_RESAMPLER_TABLE_STEPS, with fc = 0.9, Nz = 8, beta = 7.
+ */
+static const int16_t m_filter[SINC_RESAMPLER_TABLE_SIZE] =
+{
+     29490,  29480,  29450,  29401,  29331,  29242,  29133,  29005,  28857,  28691,  28505,  28301,
+     28078,  27837,  27579,  27303,  27010,  26700,  26373,  26031,  25673,  25300,  24912,  24510,
+     24095,  23666,  23225,  22772,  22307,  21831,  21345,  20849,  20344,  19830,  19309,  18780,
+     18244,  17702,  17155,  16603,  16047,  15487,  14924,  14359,  13793,  13226,  12658,  12090,
+     11524,  10959,  10396,   9836,   9280,   8727,   8179,   7636,   7098,   6567,   6043,   5525,
+      5016,   4514,   4021,   3538,   3063,   2599,   2145,   1702,   1270,    849,    440,     43,
+      -341,   -713,  -1073,  -1419,  -1752,  -2072,  -2378,  -2670,  -2949,  -3214,  -3465,  -3702,
+     -3924,  -4133,  -4328,  -4509,  -4676,  -4829,  -4969,  -5094,  -5207,  -5305,  -5391,  -5464,
+     -5523,  -5571,  -5606,  -5628,  -5639,  -5638,  -5626,  -5603,  -5569,  -5525,  -5471,  -5407,
+     -5334,  -5252,  -5161,  -5062,  -4955,  -4840,  -4719,  -4590,  -4456,  -4315,  -4169,  -4018,
+     -3862,  -3702,  -3538,  -3371,  -3201,  -3028,  -2852,  -2675,  -2496,  -2316,  -2135,  -1954,
+     -1773,  -1593,  -1413,  -1234,  -1056,   -880,   -706,   -534,   -365,   -199,    -36,    124,
+       280,    432,    581,    725,    864,    999,   1129,   1254,   1374,   1488,   1597,   1701,
+      1799,   1892,   1978,   2059,   2134,   2203,   2267,   2324,   2375,   2421,   2461,   2495,
+      2523,   2545,   2562,   2574,   2579,   2580,   2575,   2565,   2550,   2531,   2506,   2477,
+      2443,   2406,   2364,   2318,   2268,   2215,   2158,   2098,   2035,   1969,   1900,   1829,
+      1756,   1680,   1603,   1524,   1443,   1362,   1279,   1195,   1110,   1025,    940,    854,
+       768,    683,    598,    513,    429,    346,    264,    183,    104,     26,    -51,   -126,
+      -199,   -270,   -339,   -406,   -471,   -534,   -594,   -651,   -706,   -759,   -809,   -856,
+      -900,   -942,   -980,  -1016,  -1049,  -1080,  -1107,  -1132,  -1153,  -1172,  -1188,  -1201,
+     -1212,  -1219,  -1224,  -1227,  -1227,  -1224,  -1219,  -1211,  -1201,  -1189,  -1175,  -1158,
+     -1140,  -1119,  -1097,  -1073,  -1047,  -1019,   -990,   -960,   -928,   -895,   -861,   -826,
+      -790,   -753,   -716,   -678,   -639,   -600,   -560,   -520,   -480,   -440,   -400,   -360,
+      -320,   -280,   -241,   -202,   -163,   -125,    -88,    -52,    -16,     19,     54,     87,
+       119,    150,    181,    210,    238,    265,    290,    315,    338,    360,    381,    400,
+       418,    435,    450,    464,    477,    488,    498,    507,    514,    521,    526,    529,
+       532,    533,    533,    532,    530,    527,    523,    518,    512,    504,    496,    488,
+       478,    467,    456,    444,    432,    419,    405,    391,    376,    361,    346,    330,
+       314,    298,    281,    265,    248,    231,    214,    198,    181,    164,    147,    131,
+       115,     98,     83,     67,     52,     37,     22,      8,     -6,    -20,    -33,    -45,
+       -57,    -69,    -80,    -91,   -101,   -110,   -119,   -128,   -136,   -143,   -150,   -157,
+      -163,   -168,   -173,   -177,   -181,   -184,   -186,   -189,   -190,   -191,   -192,   -192,
+      -192,   -192,   -191,   -189,   -188,   -185,   -183,   -180,   -177,   -173,   -170,   -166,
+      -162,   -157,   -152,   -148,   -143,   -137,   -132,   -127,   -121,   -115,   -110,   -104,
+       -98,    -92,    -87,    -81,    -75,    -69,    -64,    -58,    -52,    -47,    -41,    -36,
+       -31,    -26,    -21,    -16,    -12,     -7,     -3,      1,      5,      9,     13,     16,
+        20,     23,     26,     28,     31,     33,     36,     38,     39,     41,     43,     44,
+        45,     46,     47,     48,     48,     48,     49,     49,     49,     49,     48,     48,
+        47,     47,     46,     45,     44,     43,     42,     41,     40,     39,     38,     36,
+        35,     34,     32,     31,     30,     28,     27,     25,     24,     22,     21,     20,
+        18,     17,     16,     14,     13,     12,     11,     10,      8,      7,      6,      5,
+         4,      4,      3,      2,      1,      1,      0,     -1,     -1,     -2,     -2,     -3,
+        -3,     -3,     -4,     -4,     -4,     -4,     -4,     -4,      0,
+};
+
+int sinc_resampler_init(sinc_resampler_t *p_resampler,
+                        int16_t *p_buffer,
+                        unsigned int buffer_size,
+                        uint32_t in_rate,
+                        uint32_t out_rate)
+{
+    if ((p_resampler == NULL) || (p_buffer == NULL) || (in_rate == 0) || (out_rate == 0) ||
+        (in_rate > UINT16_MAX) || (out_rate > UINT16_MAX))
+    {
+        return -1;
+    }
+
+    memset(p_resampler, 0, sizeof(*p_resampler));
+
+    p_resampler->wing = SINC_RESAMPLER_WING(in_rate, out_rate);
+    if (buffer_size < SINC_RESAMPLER_BUFFER_SIZE(1, in_rate, out_rate))
+    {
+        return -1;
+    }
+
+    p_resampler->p_buffer       = p_buffer;
+    p_resampler->buffer_size    = buffer_size;
+    p_resampler->out_rate       = out_rate;
+    p_resampler->step_int       = in_rate / out_rate;
+    p_resampler->step_rem       = in_rate % out_rate;
+    p_resampler->scale          = (out_rate >= in_rate) ? 65536 : ((out_rate << 16) / in_rate);
+    p_resampler->phase_to_q16   = (uint32_t)((1ull << 32) / out_rate);
+
+    // Start with silence as history, so that the first output sample is aligned with the first input sample.
+    memset(p_buffer, 0, p_resampler->wing * sizeof(int16_t));
+    p_resampler->fill           = p_resampler->wing;
+    p_resampler->pos            = p_resampler->wing - 1;
+    p_resampler->phase          = 0;
+
+    return 0;
+}
+
+unsigned int sinc_resampler_write(sinc_resampler_t *p_resampler, const int16_t *p_samples, unsigned int count)
+{
+    unsigned int discard;
+
+    // Drop the samples which are no longer needed by the left wing of the filter.
+    discard = p_resampler->pos + 1 - p_resampler->wing;
+    if (discard > 0)
+    {
+        memmove(p_resampler->p_buffer,
+                &p_resampler->p_buffer[discard],
+                (p_resampler->fill - discard) * sizeof(int16_t));
+        p_resampler->fill -= discard;
+        p_resampler->pos  -= discard;
+    }
+
+    if (count > (unsigned int)(p_resampler->buffer_size - p_resampler->fill))
+    {
+        count = p_resampler->buffer_size - p_resampler->fill;
+    }
+
+    memcpy(&p_resampler->p_buffer[p_resampler->fill], p_samples, count * sizeof(int16_t));
+    p_resampler->fill += count;
+
+    return count;
+}
+
+/**@brief Apply one wing of the filter.
+ *
+ * @param[in] p_samples Input samples, in the order of increasing distance from the output sample.
+ * @param[in] step      Distance between consecutive input samples: -1 for the left wing, 1 for the right wing.
+ * @param[in] distance  Distance of the first input sample from the output sample, Q16.
+ * @param[in] scale     Filter scale, Q16.
+ */
+static int64_t sinc_resampler_wing(const int16_t *p_samples, int step, uint32_t distance, uint32_t scale)
+{
+    uint32_t position = (uint32_t)(((uint64_t)distance * scale) >> 16);
+    int64_t  acc      = 0;
+
+    for (;;)
+    {
+        uint32_t index = position >> SINC_RESAMPLER_INDEX_SHIFT;
+        int32_t  coeff;
+
+        if (index >= (SINC_RESAMPLER_TABLE_SIZE - 1))
+        {
+            break;
+        }
+
+        coeff = m_filter[index] +
+                (((m_filter[index + 1] - m_filter[index]) * (int32_t)(position & SINC_RESAMPLER_INDEX_MASK)) >> SINC_RESAMPLER_INDEX_SHIFT);
+
+        acc       += (int32_t)(*p_samples) * coeff;
+        p_samples += step;
+        position  += scale;
+    }
+
+    return acc;
+}
+
+unsigned int sinc_resampler_read(sinc_resampler_t *p_resampler, int16_t *p_samples, unsigned int count)
+{
+    const int16_t *p_buffer = p_resampler->p_buffer;
+    unsigned int produced;
+
+    for (produced = 0; produced < count; produced++)
+    {
+        uint32_t fraction;
+        int64_t  acc;
+        int32_t  sample;
+
+        if ((p_resampler->pos + p_resampler->wing) >= p_resampler->fill)
+        {
+            break;
+        }
+
+        // Multiply by the reciprocal instead of dividing: 64-bit division is slow on Cortex-M.
+        fraction = (uint32_t)(((uint64_t)p_resampler->phase * p_resampler->phase_to_q16) >> 16);
+
+        acc  = sinc_resampler_wing(&p_buffer[p_resampler->pos], -1, fraction, p_resampler->scale);
+        acc += sinc_resampler_wing(&p_buffer[p_resampler->pos + 1], 1, 65536 - fraction, p_resampler->scale);
+
+        // Remove the Q15 of the coefficients and restore the gain of the stretched filter.
+        sample = (int32_t)((((acc + (1 << 14)) >> 15) * p_resampler->scale + (1 << 15)) >> 16);
+        if (sample > INT16_MAX)
+        {
+            sample = INT16_MAX;
+        }
+        else if (sample < INT16_MIN)
+        {
+            sample = INT16_MIN;
+        }
+        p_samples[produced] = (int16_t)sample;
+
+        p_resampler->pos   += p_resampler->step_int;
+        p_resampler->phase += p_resampler->step_rem;
+        if (p_resampler->phase >= p_resampler->out_rate)
+        {
+            p_resampler->phase -= p_resampler->out_rate;
+            p_resampler->pos   += 1;
+        }
+    }
+
+    return produced;
+}
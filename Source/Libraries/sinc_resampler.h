@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ *
+ * @defgroup SINC_RESAMPLER Sample rate converter
+ * @{
+ * @ingroup  MOD_AUDIO
+ * @brief Fixed-point polyphase sample rate converter.
+ *
+ * @details Converts between any two sampling rates using bandlimited interpolation: every
+ *          output sample is a sum of input samples weighted by a Kaiser-windowed sinc,
+ *          read from a table with @ref SINC_RESAMPLER_TABLE_STEPS phases per input sample and
+ *          linearly interpolated between the phases. When the output rate is lower than the
+ *          input rate, the filter is stretched so that its cutoff follows the output Nyquist
+ *          frequency, which suppresses aliasing.
+ *
+ *          The ratio is tracked exactly as a fraction of the rates, so the converter does not
+ *          drift. It costs 2 x @ref SINC_RESAMPLER_ZERO_CROSSINGS multiply-accumulate operations per
+ *          output sample for upsampling, proportionally more for downsampling.
+ *          Output is delayed by @ref SINC_RESAMPLER_ZERO_CROSSINGS samples of the lower rate.
+ *
+ *          Input is appended with @ref sinc_resampler_write and converted with @ref sinc_resampler_read,
+ *          so that output can be taken in blocks of any size.
+ */
+#ifndef __SINC_RESAMPLER_H__
+#define __SINC_RESAMPLER_H__
+
+#include <stdint.h>
+
+/**@brief Number of zero crossings of the interpolation filter on each side. */
+#define SINC_RESAMPLER_ZERO_CROSSINGS    8
+
+/**@brief Number of filter phases per input sample (log2). */
+#define SINC_RESAMPLER_TABLE_STEPS_LOG2  6
+
+/**@brief Number of filter phases per input sample. */
+#define SINC_RESAMPLER_TABLE_STEPS       (1 << SINC_RESAMPLER_TABLE_STEPS_LOG2)
+
+/**@brief Number of input samples used on each side of an output sample. */
+#define SINC_RESAMPLER_WING(in_rate, out_rate)                                                   \
+        (((out_rate) >= (in_rate)) ? SINC_RESAMPLER_ZERO_CROSSINGS :                             \
+         ((SINC_RESAMPLER_ZERO_CROSSINGS * (in_rate) + (out_rate) - 1) / (out_rate)))
+
+/**@brief Size of the buffer, in samples, needed to convert blocks of @p block samples. */
+#define SINC_RESAMPLER_BUFFER_SIZE(block, in_rate, out_rate)                                     \
+        ((block) + 2 * (SINC_RESAMPLER_WING(in_rate, out_rate) + 1))
+
+/**@brief Sample rate converter state. */
+typedef struct
+{
+    int16_t     *p_buffer;      /**< Input history and pending input. */
+    uint16_t    buffer_size;    /**< Size of the buffer in samples. */
+    uint16_t    fill;           /**< Number of samples in the buffer. */
+    uint16_t    pos;            /**< Buffer index of the last input sample before the next output sample. */
+    uint16_t    wing;           /**< Number of input samples used on each side of an output sample. */
+    uint32_t    out_rate;       /**< Output rate. */
+    uint32_t    step_int;       /**< Integer part of the input samples per output sample. */
+    uint32_t    step_rem;       /**< Fractional part of the input samples per output sample, in 1/out_rate. */
+    uint32_t    phase;          /**< Position of the next output sample after pos, in 1/out_rate. */
+    uint32_t    phase_to_q16;   /**< Factor converting the phase to a Q16 fraction, Q16: 2^32 / out_rate. */
+    uint32_t    scale;          /**< Filter scale, Q16: min(1, out_rate / in_rate). */
+} sinc_resampler_t;
+
+/**@brief Initialize a sample rate converter.
+ *
+ * @param[out] p_resampler  Pointer to the state to initialize.
+ * @param[in]  p_buffer     Buffer for input samples, see @ref SINC_RESAMPLER_BUFFER_SIZE.
+ * @param[in]  buffer_size  Size of the buffer in samples.
+ * @param[in]  in_rate      Input sampling rate.
+ * @param[in]  out_rate     Output sampling rate.
+ *
+ * @return 0 on success, -1 if the rates are invalid or the buffer cannot hold the filter history.
+ */
+int sinc_resampler_init(sinc_resampler_t *p_resampler,
+                        int16_t *p_buffer,
+                        unsigned int buffer_size,
+                        uint32_t in_rate,
+                        uint32_t out_rate);
+
+/**@brief Append input samples.
+ *
+ * @param[in,out] p_resampler   Pointer to the state.
+ * @param[in]     p_samples     Input samples.
+ * @param[in]     count         Number of input samples.
+ *
+ * @return Number of samples accepted. Samples that do not fit into the buffer are discarded.
+ */
+unsigned int sinc_resampler_write(sinc_resampler_t *p_resampler, const int16_t *p_samples, unsigned int count);
+
+/**@brief Convert buffered input.
+ *
+ * @param[in,out] p_resampler   Pointer to the state.
+ * @param[out]    p_samples     Output samples.
+ * @param[in]     count         Maximum number of output samples.
+ *
+ * @return Number of output samples produced. Less than @p count means that more input is needed.
+ */
+unsigned int sinc_resampler_read(sinc_resampler_t *p_resampler, int16_t *p_samples, unsigned int count);
+
+#endif /* __SINC_RESAMPLER_H__ */
+/** @} */
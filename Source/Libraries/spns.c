@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "spns.h"
+#include "modes.h"
+
+/* Left shift applied to windowed samples before the FFT to keep precision in the scaled transform. */
+#define SPNS_FFT_SHIFT          10
+
+/* Right shift applied to bin power so that band power scaled by (1 << 15) fits 64 bits. */
+#define SPNS_POWER_SHIFT        10
+
+/* Band power smoothing: new = old - old / 8 + power / 8. */
+#define SPNS_SMOOTH_SHIFT       3
+
+/* Sub-window length in frames: 64 hops of 3.75 ms at 16 kHz. */
+#define SPNS_SUBWINDOW_FRAMES   64
+
+/* Noise estimate scale, Q4: compensates the downward bias of the minimum and over-subtracts slightly. */
+#define SPNS_NOISE_BIAS_Q4      40
+
+/* Gain release: the gain may fall by half of the distance to the new gain per frame. */
+#define SPNS_RELEASE_SHIFT      1
+
+/* Square-root periodic Hann window, Q15. w[n]^2 + w[n + N/2]^2 == 1. */
+static const int16_t m_window[SPNS_FFT_SIZE] =
+{
+        0,   858,  1715,  2571,  3425,  4277,  5126,  5971,  6813,  7650,
+     8481,  9307, 10126, 10938, 11743, 12540, 13328, 14107, 14876, 15636,
+    16384, 17121, 17847, 18560, 19261, 19948, 20622, 21281, 21926, 22556,
+    23170, 23769, 24351, 24917, 25466, 25997, 26510, 27005, 27482, 27939,
+    28378, 28797, 29197, 29576, 29935, 30274, 30592, 30888, 31164, 31419,
+    31651, 31863, 32052, 32219, 32365, 32488, 32588, 32667, 32723, 32757,
+    32767, 32757, 32723, 32667, 32588, 32488, 32365, 32219, 32052, 31863,
+    31651, 31419, 31164, 30888, 30592, 30274, 29935, 29576, 29197, 28797,
+    28378, 27939, 27482, 27005, 26510, 25997, 25466, 24917, 24351, 23769,
+    23170, 22556, 21926, 21281, 20622, 19948, 19261, 18560, 17847, 17121,
+    16384, 15636, 14876, 14107, 13328, 12540, 11743, 10938, 10126,  9307,
+     8481,  7650,  6813,  5971,  5126,  4277,  3425,  2571,  1715,   858,
+};
+
+/* First bin of every band; bands are about 270 Hz wide at low and 1 kHz wide at high frequencies. */
+static const uint8_t m_band_edges[SPNS_BANDS + 1] =
+{
+    0, 2, 4, 6, 8, 10, 12, 14, 17, 20, 24, 28, 33, 39, 46, 53, SPNS_FFT_SIZE / 2 + 1
+};
+
+static kiss_fft_cpx m_fft_in[SPNS_FFT_SIZE];
+static kiss_fft_cpx m_fft_out[SPNS_FFT_SIZE];
+
+static inline int16_t spns_sat16(int32_t x)
+{
+    if (x > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+/* Update the minimum statistics of one band and return its noise estimate. */
+static uint64_t spns_noise_update(spns_t *p_spns, unsigned int band, uint64_t smooth)
+{
+    uint64_t noise;
+    unsigned int i;
+
+    if (smooth < p_spns->min_current[band])
+    {
+        p_spns->min_current[band] = smooth;
+    }
+
+    noise = p_spns->min_current[band];
+    for (i = 0; i < SPNS_MIN_SUBWINDOWS; i++)
+    {
+        if (p_spns->min_window[band][i] < noise)
+        {
+            noise = p_spns->min_window[band][i];
+        }
+    }
+
+    return (noise * SPNS_NOISE_BIAS_Q4) >> 4;
+}
+
+/* Close the current sub-window: keep its minima and start a new one. */
+static void spns_subwindow_next(spns_t *p_spns)
+{
+    unsigned int band;
+
+    for (band = 0; band < SPNS_BANDS; band++)
+    {
+        p_spns->min_window[band][p_spns->subwindow] = p_spns->min_current[band];
+        p_spns->min_current[band]                   = p_spns->smooth_power[band];
+    }
+
+    if (++p_spns->subwindow == SPNS_MIN_SUBWINDOWS)
+    {
+        p_spns->subwindow = 0;
+    }
+}
+
+/* Process the current frame and produce SPNS_HOP_SIZE output samples. */
+static void spns_frame(spns_t *p_spns)
+{
+    unsigned int n, k, band;
+
+    for (n = 0; n < SPNS_FFT_SIZE; n++)
+    {
+        m_fft_in[n].r = ((int32_t)p_spns->in_frame[n] * m_window[n]) >> (15 - SPNS_FFT_SHIFT);
+        m_fft_in[n].i = 0;
+    }
+
+    opus_fft_c(p_spns->p_fft, m_fft_in, m_fft_out);
+
+    for (band = 0; band < SPNS_BANDS; band++)
+    {
+        uint64_t power = 0;
+        uint64_t smooth;
+        uint64_t noise;
+        uint32_t gain;
+
+        for (k = m_band_edges[band]; k < m_band_edges[band + 1]; k++)
+        {
+            int32_t re = m_fft_out[k].r;
+            int32_t im = m_fft_out[k].i;
+
+            power += ((uint64_t)((int64_t)re * re) + (uint64_t)((int64_t)im * im)) >> SPNS_POWER_SHIFT;
+        }
+
+        smooth = p_spns->smooth_power[band];
+        if (p_spns->min_current[band] == UINT64_MAX)
+        {
+            /* First frame: start smoothing from the current power rather than from silence. */
+            smooth = power;
+        }
+        smooth = smooth - (smooth >> SPNS_SMOOTH_SHIFT) + (power >> SPNS_SMOOTH_SHIFT);
+        p_spns->smooth_power[band] = smooth;
+
+        noise = spns_noise_update(p_spns, band, smooth);
+        p_spns->noise_power[band] = noise;
+
+        /* Wiener gain SNR / (1 + SNR) with the a-posteriori SNR estimated as (S - N) / N. */
+        if (noise >= smooth)
+        {
+            gain = 0;
+        }
+        else
+        {
+            gain = 32767 - (uint32_t)((noise << 15) / smooth);
+        }
+        if (gain < p_spns->gain_floor)
+        {
+            gain = p_spns->gain_floor;
+        }
+
+        /* Open instantly, close gradually to limit musical noise. */
+        if (gain < p_spns->gain[band])
+        {
+            gain = p_spns->gain[band] - ((p_spns->gain[band] - gain) >> SPNS_RELEASE_SHIFT);
+        }
+        p_spns->gain[band] = (uint16_t)gain;
+
+        for (k = m_band_edges[band]; k < m_band_edges[band + 1]; k++)
+        {
+            int32_t re = (int32_t)(((int64_t)m_fft_out[k].r * gain) >> 15);
+            int32_t im = (int32_t)(((int64_t)m_fft_out[k].i * gain) >> 15);
+
+            m_fft_out[k].r = re;
+            m_fft_out[k].i = im;
+            if ((k != 0) && (k != SPNS_FFT_SIZE / 2))
+            {
+                m_fft_out[SPNS_FFT_SIZE - k].r = re;
+                m_fft_out[SPNS_FFT_SIZE - k].i = -im;
+            }
+        }
+    }
+
+    if (++p_spns->subwindow_frames == SPNS_SUBWINDOW_FRAMES)
+    {
+        p_spns->subwindow_frames = 0;
+        spns_subwindow_next(p_spns);
+    }
+
+    opus_ifft_c(p_spns->p_fft, m_fft_out, m_fft_in);
+
+    for (n = 0; n < SPNS_HOP_SIZE; n++)
+    {
+        int32_t head = (int32_t)(((int64_t)m_fft_in[n].r * m_window[n]) >> 15);
+        int32_t tail = (int32_t)(((int64_t)m_fft_in[n + SPNS_HOP_SIZE].r * m_window[n + SPNS_HOP_SIZE]) >> 15);
+        int32_t sum  = p_spns->overlap[n] + head;
+
+        p_spns->out_frame[n] = spns_sat16((sum + (1 << (SPNS_FFT_SHIFT - 1))) >> SPNS_FFT_SHIFT);
+        p_spns->overlap[n]   = tail;
+    }
+
+    memcpy(&p_spns->in_frame[0], &p_spns->in_frame[SPNS_HOP_SIZE], SPNS_HOP_SIZE * sizeof(int16_t));
+}
+
+int spns_init(spns_t *p_spns, uint16_t gain_floor)
+{
+    const CELTMode *p_mode;
+    unsigned int band, i;
+
+    if (p_spns == NULL)
+    {
+        return -1;
+    }
+
+    /* The 48 kHz/960 static mode contains a 120-point FFT state; no allocation is needed. */
+    p_mode = opus_custom_mode_create(48000, 960, NULL);
+    if ((p_mode == NULL) || (p_mode->mdct.kfft[2]->nfft != SPNS_FFT_SIZE))
+    {
+        return -1;
+    }
+
+    memset(p_spns, 0, sizeof(*p_spns));
+    p_spns->p_fft      = p_mode->mdct.kfft[2];
+    p_spns->gain_floor = gain_floor;
+
+    for (band = 0; band < SPNS_BANDS; band++)
+    {
+        p_spns->min_current[band] = UINT64_MAX;
+        for (i = 0; i < SPNS_MIN_SUBWINDOWS; i++)
+        {
+            p_spns->min_window[band][i] = UINT64_MAX;
+        }
+        p_spns->gain[band] = 32767;
+    }
+
+    return 0;
+}
+
+void spns_process(spns_t *p_spns, int16_t *p_samples, unsigned int count)
+{
+    while (count--)
+    {
+        p_spns->in_frame[SPNS_HOP_SIZE + p_spns->fill] = *p_samples;
+        *p_samples++ = p_spns->out_frame[p_spns->fill];
+
+        if (++p_spns->fill == SPNS_HOP_SIZE)
+        {
+            p_spns->fill = 0;
+            spns_frame(p_spns);
+        }
+    }
+}
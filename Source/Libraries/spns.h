@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ *
+ * @defgroup SPNS Spectral noise suppression
+ * @{
+ * @ingroup  MOD_AUDIO
+ * @brief Fixed-point single-channel spectral noise suppressor.
+ *
+ * @details The signal is analysed with a 120-point FFT using 50% overlapping square-root
+ *          Hann windows. Bin powers are grouped into @ref SPNS_BANDS bands. The noise
+ *          level of every band is estimated by minimum statistics: the minimum of the
+ *          smoothed band power over a window of about 1.4 s, split into sub-windows so
+ *          that the estimate follows rising noise. A Wiener gain derived from the band
+ *          signal-to-noise ratio, limited by the configured floor, is applied to all bins
+ *          of the band before resynthesis.
+ *
+ *          The library uses only the Opus FFT and the C library, so it can be built
+ *          and profiled on a host with the same FIXED_POINT/OPUS_BUILD definitions as
+ *          the firmware. Output is delayed by @ref SPNS_FFT_SIZE samples.
+ */
+#ifndef __SPNS_H__
+#define __SPNS_H__
+
+#include <stdint.h>
+#include "kiss_fft.h"
+
+/**@brief FFT size. */
+#define SPNS_FFT_SIZE       120
+
+/**@brief Number of new samples consumed by each frame. */
+#define SPNS_HOP_SIZE       (SPNS_FFT_SIZE / 2)
+
+/**@brief Number of suppression bands. */
+#define SPNS_BANDS          16
+
+/**@brief Number of sub-windows kept by the minimum statistics noise tracker. */
+#define SPNS_MIN_SUBWINDOWS 6
+
+/**@brief Noise suppressor state. */
+typedef struct
+{
+    const kiss_fft_state   *p_fft;
+    uint16_t                gain_floor;
+    uint16_t                fill;
+    uint16_t                subwindow_frames;
+    uint8_t                 subwindow;
+    int16_t                 in_frame[SPNS_FFT_SIZE];
+    int16_t                 out_frame[SPNS_HOP_SIZE];
+    int32_t                 overlap[SPNS_HOP_SIZE];
+    uint64_t                smooth_power[SPNS_BANDS];
+    uint64_t                noise_power[SPNS_BANDS];
+    uint64_t                min_current[SPNS_BANDS];
+    uint64_t                min_window[SPNS_BANDS][SPNS_MIN_SUBWINDOWS];
+    uint16_t                gain[SPNS_BANDS];
+} spns_t;
+
+/**@brief Initialize noise suppression.
+ *
+ * @param[out] p_spns       Pointer to the state to initialize.
+ * @param[in]  gain_floor   Minimum gain in Q15. 32767 passes the signal through unchanged.
+ *
+ * @return 0 on success, -1 if the FFT is not available.
+ */
+int spns_init(spns_t *p_spns, uint16_t gain_floor);
+
+/**@brief Process a block of mono samples in place.
+ *
+ * @param[in,out] p_spns    Pointer to the state.
+ * @param[in,out] p_samples Samples to process.
+ * @param[in]     count     Number of samples.
+ *
+ * @note The FFT work buffers are shared, so only one instance may be processed at a time.
+ */
+void spns_process(spns_t *p_spns, int16_t *p_samples, unsigned int count);
+
+#endif /* __SPNS_H__ */
+/** @} */
@@ -38,6 +38,7 @@
  * 
  */
 
+#include "nrf_assert.h"
 #include "nrf_pwr_mgmt.h"
 #include "app_error.h"
 #include "app_timer.h"
@@ -54,6 +55,134 @@
 #include "nrf_log.h"
 NRF_LOG_MODULE_REGISTER();
 
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+#define M_ACC_MOTION_CHECK_INTERVAL     200     /**< Interval between two stationary checks [ms]. */
+#define M_ACC_MOTION_MIN_SAMPLES        8       /**< Minimal number of samples needed for a stationary check. */
+#define M_ACC_STATIONARY_CHECKS         CEIL_DIV(CONFIG_GYRO_STATIONARY_TIME, M_ACC_MOTION_CHECK_INTERVAL)
+
+// The FIFO has to hold all samples collected between two consecutive checks.
+STATIC_ASSERT((M_ACC_MOTION_CHECK_INTERVAL * DRV_ACC_MOTION_TRACK_ODR / 1000) <= DRV_ACC_FIFO_SIZE);
+
+static m_acc_motion_handler_t   m_acc_motion_handler;       /**< Motion state change handler. */
+static bool                     m_acc_motion_tracking;      /**< True if motion tracking is enabled. */
+static bool                     m_acc_stationary;           /**< True if the device is stationary. */
+static volatile bool            m_acc_motion_pending;       /**< True if a motion interrupt has been scheduled for processing. */
+static uint8_t                  m_acc_stationary_checks;    /**< Number of consecutive stationary checks. */
+APP_TIMER_DEF                   (m_acc_motion_timer);       /**< Stationary check timer. */
+
+/**@brief Compute the sum of per-axis variances of the given samples.
+ *
+ * @param[in] p_samples Pointer to the samples.
+ * @param[in] count     Number of samples.
+ *
+ * @return Variance in mg^2.
+ */
+static uint32_t m_acc_variance(drv_acc_sample_t const *p_samples, uint8_t count)
+{
+    int32_t sum_x = 0, sum_y = 0, sum_z = 0;
+    int32_t mean_x, mean_y, mean_z;
+    uint32_t variance = 0;
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        sum_x += p_samples[i].x;
+        sum_y += p_samples[i].y;
+        sum_z += p_samples[i].z;
+    }
+
+    mean_x = sum_x / count;
+    mean_y = sum_y / count;
+    mean_z = sum_z / count;
+
+    for (i = 0; i < count; i++)
+    {
+        int32_t dx = p_samples[i].x - mean_x;
+        int32_t dy = p_samples[i].y - mean_y;
+        int32_t dz = p_samples[i].z - mean_z;
+
+        variance += (uint32_t)(dx * dx + dy * dy + dz * dz);
+    }
+
+    return variance / count;
+}
+
+/**@brief Stationary check timer handler. */
+static void m_acc_motion_timer_handler(void *p_context)
+{
+    drv_acc_sample_t samples[DRV_ACC_FIFO_SIZE];
+    uint8_t count = ARRAY_SIZE(samples);
+    uint32_t variance;
+
+    if (!m_acc_motion_tracking || m_acc_stationary)
+    {
+        return;
+    }
+
+    APP_ERROR_CHECK(drv_acc_fifo_read(samples, &count));
+    if (count < M_ACC_MOTION_MIN_SAMPLES)
+    {
+        return;
+    }
+
+    variance = m_acc_variance(samples, count);
+    if (variance >= CONFIG_GYRO_STATIONARY_VARIANCE)
+    {
+        m_acc_stationary_checks = 0;
+        return;
+    }
+
+    if (++m_acc_stationary_checks < M_ACC_STATIONARY_CHECKS)
+    {
+        return;
+    }
+
+    NRF_LOG_DEBUG("Stationary (variance: %u mg^2)", variance);
+
+    // Arm the motion interrupt before the handler powers anything down.
+    m_acc_stationary        = true;
+    m_acc_motion_pending    = false;
+
+    APP_ERROR_CHECK(app_timer_stop(m_acc_motion_timer));
+    APP_ERROR_CHECK(drv_acc_mode_set(DRV_ACC_MODE_MOTION_WAKE));
+
+    m_acc_motion_handler(false);
+}
+
+/**@brief Motion event handler. Executed in the main context. */
+static void m_acc_motion_evt_handler(void *p_context)
+{
+    if (!m_acc_motion_tracking || !m_acc_stationary)
+    {
+        return;
+    }
+
+    NRF_LOG_DEBUG("Moving");
+
+    m_acc_stationary        = false;
+    m_acc_stationary_checks = 0;
+
+    // Notify the handler first - the gyroscope wake-up is the longest part of the process.
+    m_acc_motion_handler(true);
+
+    APP_ERROR_CHECK(drv_acc_mode_set(DRV_ACC_MODE_MOTION_TRACK));
+    APP_ERROR_CHECK(app_timer_start(m_acc_motion_timer,
+                                    APP_TIMER_TICKS(M_ACC_MOTION_CHECK_INTERVAL),
+                                    NULL));
+}
+
+/**@brief Accelerometer motion handler. Executed in the interrupt context. */
+static void m_acc_motion_handler_irq(void)
+{
+    // The motion interrupt is not latched and keeps firing while the device moves.
+    if (!m_acc_motion_pending)
+    {
+        m_acc_motion_pending = true;
+        APP_ERROR_CHECK(app_isched_event_put(&g_fg_scheduler, m_acc_motion_evt_handler, NULL));
+    }
+}
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
+
 /**@brief Accelerometer click handler. */
 static void m_acc_click_handler(void)
 {
@@ -65,7 +194,23 @@ static void m_acc_click_handler(void)
 
 ret_code_t m_acc_init(void)
 {
-    return drv_acc_init(m_acc_click_handler);
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+    ret_code_t status;
+
+    m_acc_motion_tracking = false;
+
+    status = app_timer_create(&m_acc_motion_timer,
+                              APP_TIMER_MODE_REPEATED,
+                              m_acc_motion_timer_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    return drv_acc_init(m_acc_click_handler, m_acc_motion_handler_irq);
+#else
+    return drv_acc_init(m_acc_click_handler, NULL);
+#endif
 }
 
 #if CONFIG_ACC_USE_CLICK_DETECTION
@@ -80,9 +225,54 @@ ret_code_t m_acc_click_detection_disable(void)
 }
 #endif /* CONFIG_ACC_USE_CLICK_DETECTION */
 
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+ret_code_t m_acc_motion_tracking_enable(m_acc_motion_handler_t handler)
+{
+    ret_code_t status;
+
+    ASSERT(handler != NULL);
+
+    m_acc_motion_handler    = handler;
+    m_acc_motion_tracking   = true;
+    m_acc_stationary        = false;
+    m_acc_motion_pending    = false;
+    m_acc_stationary_checks = 0;
+
+    status = drv_acc_mode_set(DRV_ACC_MODE_MOTION_TRACK);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    return app_timer_start(m_acc_motion_timer,
+                           APP_TIMER_TICKS(M_ACC_MOTION_CHECK_INTERVAL),
+                           NULL);
+}
+
+ret_code_t m_acc_motion_tracking_disable(void)
+{
+    ret_code_t status;
+
+    m_acc_motion_tracking = false;
+
+    status = app_timer_stop(m_acc_motion_timer);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    return drv_acc_mode_set(DRV_ACC_MODE_IDLE);
+}
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
+
 #if CONFIG_PWR_MGMT_ENABLED
 static bool m_acc_shutdown(nrf_pwr_mgmt_evt_t event)
 {
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+    m_acc_motion_tracking = false;
+    APP_ERROR_CHECK(app_timer_stop(m_acc_motion_timer));
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
+
 #if CONFIG_ACC_WAKEUP_SOURCE
     if (event == NRF_PWR_MGMT_EVT_PREPARE_WAKEUP)
     {
@@ -47,8 +47,15 @@
 #ifndef __M_ACC__
 #define __M_ACC__
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/**@brief Motion state change handler.
+ *
+ * @param[in] moving    True if the device started moving, false if it became stationary.
+ */
+typedef void (*m_acc_motion_handler_t)(bool moving);
+
 /**@brief Function for initializing the accelerometer module.
  *
  * @return NRF_SUCCESS on success, otherwise an error code.
@@ -67,6 +74,26 @@ ret_code_t m_acc_click_detection_enable(void);
  */
 ret_code_t m_acc_click_detection_disable(void);
 
+/**@brief Function for enabling motion tracking.
+ *
+ * @details The accelerometer FIFO is checked periodically. When the variance of the collected samples
+ *          stays below CONFIG_GYRO_STATIONARY_VARIANCE for CONFIG_GYRO_STATIONARY_TIME, the handler is
+ *          notified that the device is stationary and the accelerometer is switched to a low power
+ *          motion wake mode. The first motion interrupt notifies the handler and resumes the tracking.
+ *          Click detection stays active during tracking, if enabled.
+ *
+ * @param[in] handler   Motion state change handler. Executed in the main context.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_acc_motion_tracking_enable(m_acc_motion_handler_t handler);
+
+/**@brief Function for disabling motion tracking.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_acc_motion_tracking_disable(void);
+
 #endif /* __M_ACC__ */
 /** @} */
 
@@ -38,6 +38,8 @@
  * 
  */
 
+#include <string.h>
+
 #include "nrf_atomic.h"
 #include "nrf_assert.h"
 #include "nrf_balloc.h"
@@ -46,14 +48,18 @@
 #include "app_debug.h"
 #include "app_error.h"
 #include "app_isched.h"
+#include "app_util.h"
 
 #include "drv_audio.h"
 #include "drv_audio_anr.h"
 #include "drv_audio_dsp.h"
+#include "drv_audio_ns.h"
+#include "drv_audio_src.h"
 #include "drv_audio_codec.h"
 
 #include "m_audio.h"
 #include "m_audio_gauges.h"
+#include "m_batt_meas.h"
 #include "m_audio_probe.h"
 #include "m_coms.h"
 
@@ -69,53 +75,100 @@ NRF_LOG_MODULE_REGISTER();
 
 /* Make sure that ANR gets a two-channel input. */
 #if CONFIG_AUDIO_ANR_ENABLED
-STATIC_ASSERT(CONFIG_PDM_BUFFER_SIZE_SAMPLES == (2 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES));
+STATIC_ASSERT(CONFIG_PDM_BUFFER_SIZE_SAMPLES == (2 * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES));
 #else /* !CONFIG_AUDIO_ANR_ENABLED */
-STATIC_ASSERT(CONFIG_PDM_BUFFER_SIZE_SAMPLES == (1 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES));
+STATIC_ASSERT(CONFIG_PDM_BUFFER_SIZE_SAMPLES == (1 * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES));
 #endif /* CONFIG_AUDIO_ANR_ENABLED */
 
+/* Frames are assembled from converted or partial blocks, otherwise each captured block is a frame. */
+#define M_AUDIO_FRAME_ASSEMBLY_ENABLED  (CONFIG_AUDIO_SRC_ENABLED ||                                        \
+                                         (CONFIG_AUDIO_BLOCK_SIZE_SAMPLES != CONFIG_AUDIO_FRAME_SIZE_SAMPLES))
+
 #if !CONFIG_AUDIO_HID_ENABLED && !CONFIG_AUDIO_ATVV_ENABLED
 #error At least one audio service (HID or AATV) has to be enabled!
 #endif /* !CONFIG_AUDIO_HID_ENABLED && !CONFIG_AUDIO_ATVV_ENABLED */
 
 NRF_BALLOC_DEF(m_audio_buffer_pool,
                (sizeof(int16_t) * CONFIG_PDM_BUFFER_SIZE_SAMPLES),
-               CONFIG_AUDIO_BUFFER_POOL_SIZE);
+               CONFIG_PDM_BUFFER_POOL_SIZE);
 
 static bool                     m_audio_enabled;
+static uint32_t                 m_audio_sampling_frequency = CONFIG_AUDIO_SAMPLING_FREQUENCY;
+
+/* Sampling frequency of audio passed to the codec. */
+#if CONFIG_AUDIO_SRC_ENABLED
+#define M_AUDIO_CODEC_FREQUENCY         m_audio_sampling_frequency
+#else /* !CONFIG_AUDIO_SRC_ENABLED */
+#define M_AUDIO_CODEC_FREQUENCY         CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY
+#endif /* CONFIG_AUDIO_SRC_ENABLED */
+
+#if CONFIG_AUDIO_SRC_ENABLED
+/* The sampling frequency can be raised at most to the PDM (or default) one. */
+#define M_AUDIO_SRC_MAX_FREQUENCY       MAX(CONFIG_AUDIO_SAMPLING_FREQUENCY, CONFIG_PDM_SAMPLING_FREQUENCY)
+#define M_AUDIO_BLOCK_OUTPUT_MAX        (CEIL_DIV(CONFIG_AUDIO_BLOCK_SIZE_SAMPLES * M_AUDIO_SRC_MAX_FREQUENCY,  \
+                                                  CONFIG_PDM_REAL_SAMPLING_FREQUENCY) + 1)
+#else /* !CONFIG_AUDIO_SRC_ENABLED */
+#define M_AUDIO_BLOCK_OUTPUT_MAX        CONFIG_AUDIO_BLOCK_SIZE_SAMPLES
+#endif /* CONFIG_AUDIO_SRC_ENABLED */
+
+#if M_AUDIO_FRAME_ASSEMBLY_ENABLED
+/* Processed samples waiting for encoding: less than a frame left over and the output of one block. */
+#define M_AUDIO_FRAME_BUFFER_SIZE       (CONFIG_AUDIO_FRAME_SIZE_SAMPLES - 1 + M_AUDIO_BLOCK_OUTPUT_MAX)
+
+static int16_t                  m_audio_frame_buffer[M_AUDIO_FRAME_BUFFER_SIZE];
+static unsigned int             m_audio_frame_buffer_fill;
+#endif
 
 #if CONFIG_AUDIO_GAUGES_ENABLED
 static m_audio_loss_gauge_t     m_loss_gauge;
 static m_audio_bitrate_gauge_t  m_bitrate_gauge;
 static m_audio_cpu_gauge_t      m_total_cpu_gauge;
 static m_audio_cpu_gauge_t      m_codec_cpu_gauge;
+static m_audio_cpu_gauge_t      m_send_cpu_gauge;
 
 #if CONFIG_AUDIO_ANR_ENABLED
 static m_audio_cpu_gauge_t      m_anr_cpu_gauge;
 #endif
+#if CONFIG_AUDIO_NS_ENABLED
+static m_audio_cpu_gauge_t      m_ns_cpu_gauge;
+#endif
 #if CONFIG_AUDIO_EQUALIZER_ENABLED
 static m_audio_cpu_gauge_t      m_eq_cpu_gauge;
 #endif
 #if CONFIG_AUDIO_GAIN_CONTROL_ENABLED
 static m_audio_cpu_gauge_t      m_gain_cpu_gauge;
 #endif
+#if CONFIG_AUDIO_SRC_ENABLED
+static m_audio_cpu_gauge_t      m_src_cpu_gauge;
+#endif
 
 static void m_audio_reset_gauges(void *p_context)
 {
     m_audio_loss_gauge_reset(&m_loss_gauge);
     m_audio_bitrate_gauge_reset(&m_bitrate_gauge);
-    m_audio_cpu_gauge_reset(&m_total_cpu_gauge);
-    m_audio_cpu_gauge_reset(&m_codec_cpu_gauge);
+    m_audio_cpu_gauge_reset(&m_total_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
+    m_audio_cpu_gauge_reset(&m_codec_cpu_gauge, CONFIG_AUDIO_FRAME_SIZE_SAMPLES, M_AUDIO_CODEC_FREQUENCY);
 
 #if CONFIG_AUDIO_ANR_ENABLED
-    m_audio_cpu_gauge_reset(&m_anr_cpu_gauge);
+    m_audio_cpu_gauge_reset(&m_anr_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
+#endif
+#if CONFIG_AUDIO_NS_ENABLED
+    m_audio_cpu_gauge_reset(&m_ns_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
 #endif
 #if CONFIG_AUDIO_EQUALIZER_ENABLED
-    m_audio_cpu_gauge_reset(&m_eq_cpu_gauge);
+    m_audio_cpu_gauge_reset(&m_eq_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
 #endif
 #if CONFIG_AUDIO_GAIN_CONTROL_ENABLED
-    m_audio_cpu_gauge_reset(&m_gain_cpu_gauge);
+    m_audio_cpu_gauge_reset(&m_gain_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
 #endif
+#if CONFIG_AUDIO_SRC_ENABLED
+    m_audio_cpu_gauge_reset(&m_src_cpu_gauge, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
+#endif
+}
+
+static void m_audio_reset_send_gauge(void *p_context)
+{
+    m_audio_cpu_gauge_reset(&m_send_cpu_gauge, CONFIG_AUDIO_FRAME_SIZE_SAMPLES, M_AUDIO_CODEC_FREQUENCY);
 }
 
 static void m_audio_log_gauges(void *p_context)
@@ -127,14 +180,21 @@ static void m_audio_log_gauges(void *p_context)
 #if CONFIG_AUDIO_ANR_ENABLED
     m_audio_cpu_gauge_log(&m_anr_cpu_gauge, "\t- ANR");
 #endif
+#if CONFIG_AUDIO_NS_ENABLED
+    m_audio_cpu_gauge_log(&m_ns_cpu_gauge, "\t- NS");
+#endif
 #if CONFIG_AUDIO_EQUALIZER_ENABLED
     m_audio_cpu_gauge_log(&m_eq_cpu_gauge, "\t- Equalizer");
 #endif
 #if CONFIG_AUDIO_GAIN_CONTROL_ENABLED
     m_audio_cpu_gauge_log(&m_gain_cpu_gauge, "\t- Gain");
 #endif
+#if CONFIG_AUDIO_SRC_ENABLED
+    m_audio_cpu_gauge_log(&m_src_cpu_gauge, "\t- SRC");
+#endif
 
     m_audio_cpu_gauge_log(&m_codec_cpu_gauge, "\t- Codec");
+    m_audio_cpu_gauge_log(&m_send_cpu_gauge, "\t- Send");
 }
 #endif /* CONFIG_AUDIO_GAUGES_ENABLED */
 
@@ -148,7 +208,9 @@ static void m_audio_send(void *p_context)
 
     if (m_audio_enabled)
     {
+        m_audio_measure_cpu_usage_start(&m_send_cpu_gauge);
         status = m_coms_send_audio(p_frame);
+        m_audio_measure_cpu_usage_end(&m_send_cpu_gauge);
         if (status != NRF_SUCCESS)
         {
             m_audio_count_lost(&m_loss_gauge);
@@ -170,9 +232,77 @@ static void m_audio_send(void *p_context)
 #endif
 }
 
-static void m_audio_process(void *p_context)
+/**@brief Encode a frame of audio and schedule its transmission. */
+static ret_code_t m_audio_encode(int16_t *p_samples)
 {
     m_audio_frame_t *p_frame;
+    ret_code_t status;
+
+    m_audio_count_total(&m_loss_gauge);
+
+    p_frame = m_audio_frame_get(NULL);
+    if (p_frame == NULL)
+    {
+        m_audio_count_lost(&m_loss_gauge);
+
+        NRF_LOG_WARNING("%s(): WARNING: Cannot allocate audio frame!", __func__);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // ---- CODEC ----
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_CODEC_IN, p_samples, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
+    m_audio_measure_cpu_usage_start(&m_codec_cpu_gauge);
+    drv_audio_codec_encode(p_samples, p_frame);
+    m_audio_measure_cpu_usage_end(&m_codec_cpu_gauge);
+    m_audio_measure_bitrate(&m_bitrate_gauge, p_frame->data_size);
+
+    // Schedule audio transmission. It cannot be done from this context.
+    status = app_isched_event_put(&g_fg_scheduler, m_audio_send, p_frame);
+    if (status != NRF_SUCCESS)
+    {
+        m_audio_frame_put(p_frame);
+        m_audio_count_lost(&m_loss_gauge);
+
+        NRF_LOG_WARNING("%s(): WARNING: Cannot schedule audio frame transmission!", __func__);
+    }
+
+    return status;
+}
+
+#if M_AUDIO_FRAME_ASSEMBLY_ENABLED
+/**@brief Encode all complete frames waiting in the frame buffer. */
+static ret_code_t m_audio_encode_frames(void)
+{
+    ret_code_t status = NRF_SUCCESS;
+    unsigned int offset;
+
+    for (offset = 0;
+         (m_audio_frame_buffer_fill - offset) >= CONFIG_AUDIO_FRAME_SIZE_SAMPLES;
+         offset += CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+    {
+        ret_code_t frame_status = m_audio_encode(&m_audio_frame_buffer[offset]);
+
+        if (frame_status != NRF_SUCCESS)
+        {
+            status = frame_status;
+        }
+    }
+
+    // Keep the samples which belong to the next frame.
+    if (offset != 0)
+    {
+        m_audio_frame_buffer_fill -= offset;
+        memmove(m_audio_frame_buffer,
+                &m_audio_frame_buffer[offset],
+                m_audio_frame_buffer_fill * sizeof(int16_t));
+    }
+
+    return status;
+}
+#endif /* M_AUDIO_FRAME_ASSEMBLY_ENABLED */
+
+static void m_audio_process(void *p_context)
+{
     int16_t *p_buffer;
     ret_code_t status;
 
@@ -189,68 +319,69 @@ static void m_audio_process(void *p_context)
     m_audio_measure_cpu_usage_start(&m_total_cpu_gauge);
     DBG_PIN_SET(CONFIG_IO_DBG_AUDIO_PROCESS);
 
-    m_audio_count_total(&m_loss_gauge);
     m_audio_probe_point(M_AUDIO_PROBE_POINT_PDM_OUT, p_buffer, CONFIG_PDM_BUFFER_SIZE_SAMPLES);
 
-    p_frame = m_audio_frame_get(NULL);
-    if (p_frame != NULL)
-    {
-        // ---- ANR ----
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_ANR_IN, p_buffer, CONFIG_PDM_BUFFER_SIZE_SAMPLES);
+    // ---- ANR ----
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_ANR_IN, p_buffer, CONFIG_PDM_BUFFER_SIZE_SAMPLES);
 #if CONFIG_AUDIO_ANR_ENABLED
-        m_audio_measure_cpu_usage_start(&m_anr_cpu_gauge);
-        drv_audio_anr_perfrom(p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-        m_audio_measure_cpu_usage_end(&m_anr_cpu_gauge);
+    m_audio_measure_cpu_usage_start(&m_anr_cpu_gauge);
+    drv_audio_anr_perfrom(p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+    m_audio_measure_cpu_usage_end(&m_anr_cpu_gauge);
 #endif /* CONFIG_AUDIO_ANR_ENABLED */
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_ANR_OUT, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-
-        // ---- EQ ----
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_EQ_IN, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_ANR_OUT, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+
+    // ---- NS ----
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_NS_IN, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+#if CONFIG_AUDIO_NS_ENABLED
+    m_audio_measure_cpu_usage_start(&m_ns_cpu_gauge);
+    drv_audio_ns_perform(p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+    m_audio_measure_cpu_usage_end(&m_ns_cpu_gauge);
+#endif /* CONFIG_AUDIO_NS_ENABLED */
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_NS_OUT, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+
+    // ---- EQ ----
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_EQ_IN, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
 #if CONFIG_AUDIO_EQUALIZER_ENABLED
-        m_audio_measure_cpu_usage_start(&m_eq_cpu_gauge);
-        drv_audio_dsp_equalizer((q15_t *)p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-        m_audio_measure_cpu_usage_end(&m_eq_cpu_gauge);
+    m_audio_measure_cpu_usage_start(&m_eq_cpu_gauge);
+    drv_audio_dsp_equalizer((q15_t *)p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+    m_audio_measure_cpu_usage_end(&m_eq_cpu_gauge);
 #endif /* CONFIG_AUDIO_EQUALIZER_ENABLED */
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_EQ_OUT, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_EQ_OUT, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
 
-        // ---- GAIN ----
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_GAIN_IN, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
+    // ---- GAIN ----
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_GAIN_IN, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
 #if CONFIG_AUDIO_GAIN_CONTROL_ENABLED
-        m_audio_measure_cpu_usage_start(&m_gain_cpu_gauge);
-        drv_audio_dsp_gain_control((q15_t *)p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-        m_audio_measure_cpu_usage_end(&m_gain_cpu_gauge);
+    m_audio_measure_cpu_usage_start(&m_gain_cpu_gauge);
+    drv_audio_dsp_gain_control((q15_t *)p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+    m_audio_measure_cpu_usage_end(&m_gain_cpu_gauge);
 #endif /* CONFIG_AUDIO_GAIN_CONTROL_ENABLED */
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_GAIN_OUT, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-
-        // ---- CODEC ----
-        m_audio_probe_point(M_AUDIO_PROBE_POINT_CODEC_IN, p_buffer, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
-        m_audio_measure_cpu_usage_start(&m_codec_cpu_gauge);
-        drv_audio_codec_encode(p_buffer, p_frame);
-        m_audio_measure_cpu_usage_end(&m_codec_cpu_gauge);
-        m_audio_measure_bitrate(&m_bitrate_gauge, p_frame->data_size);
-
-        // Free audio buffer since it is no longer needed.
-        nrf_balloc_free(&m_audio_buffer_pool, p_buffer);
-
-        // Schedule audio transmission. It cannot be done from this context.
-        status = app_isched_event_put(&g_fg_scheduler, m_audio_send, p_frame);
-        if (status != NRF_SUCCESS)
-        {
-            m_audio_frame_put(p_frame);
-            m_audio_count_lost(&m_loss_gauge);
-
-            NRF_LOG_WARNING("%s(): WARNING: Cannot schedule audio frame transmission!", __func__);
-        }
-    }
-    else
-    {
-        // Frame allocation failed: Free audio buffer.
-        nrf_balloc_free(&m_audio_buffer_pool, p_buffer);
-        m_audio_count_lost(&m_loss_gauge);
-        status = NRF_ERROR_NO_MEM;
-
-        NRF_LOG_WARNING("%s(): WARNING: Cannot allocate audio frame!", __func__);
-    }
+    m_audio_probe_point(M_AUDIO_PROBE_POINT_GAIN_OUT, p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+
+#if M_AUDIO_FRAME_ASSEMBLY_ENABLED
+#if CONFIG_AUDIO_SRC_ENABLED
+    // ---- SRC ----
+    m_audio_measure_cpu_usage_start(&m_src_cpu_gauge);
+    drv_audio_src_write(p_buffer, CONFIG_AUDIO_BLOCK_SIZE_SAMPLES);
+    m_audio_frame_buffer_fill += drv_audio_src_read(&m_audio_frame_buffer[m_audio_frame_buffer_fill],
+                                                    M_AUDIO_FRAME_BUFFER_SIZE - m_audio_frame_buffer_fill);
+    m_audio_measure_cpu_usage_end(&m_src_cpu_gauge);
+#else /* !CONFIG_AUDIO_SRC_ENABLED */
+    memcpy(&m_audio_frame_buffer[m_audio_frame_buffer_fill],
+           p_buffer,
+           CONFIG_AUDIO_BLOCK_SIZE_SAMPLES * sizeof(int16_t));
+    m_audio_frame_buffer_fill += CONFIG_AUDIO_BLOCK_SIZE_SAMPLES;
+#endif /* CONFIG_AUDIO_SRC_ENABLED */
+
+    // Free audio buffer since it is no longer needed.
+    nrf_balloc_free(&m_audio_buffer_pool, p_buffer);
+
+    status = m_audio_encode_frames();
+#else /* !M_AUDIO_FRAME_ASSEMBLY_ENABLED */
+    status = m_audio_encode(p_buffer);
+
+    // Free audio buffer since it is no longer needed.
+    nrf_balloc_free(&m_audio_buffer_pool, p_buffer);
+#endif /* M_AUDIO_FRAME_ASSEMBLY_ENABLED */
 
     if (status != NRF_SUCCESS)
     {
@@ -299,6 +430,19 @@ ret_code_t m_audio_enable(void)
 
 #if CONFIG_AUDIO_ANR_ENABLED
     drv_audio_anr_init();
+#endif
+#if CONFIG_AUDIO_NS_ENABLED
+    drv_audio_ns_init();
+#endif
+#if CONFIG_AUDIO_SRC_ENABLED
+    status = drv_audio_src_init(m_audio_sampling_frequency);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+#endif
+#if M_AUDIO_FRAME_ASSEMBLY_ENABLED
+    m_audio_frame_buffer_fill = 0;
 #endif
     drv_audio_codec_init();
 
@@ -309,6 +453,12 @@ ret_code_t m_audio_enable(void)
     {
         return status;
     }
+
+    status = app_isched_event_put(&g_fg_scheduler, m_audio_reset_send_gauge, NULL);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
 #endif
 
     status = drv_audio_enable();
@@ -317,6 +467,10 @@ ret_code_t m_audio_enable(void)
         return status;
     }
 
+#if CONFIG_BATT_MEAS_ENABLED
+    m_batt_meas_load_set(M_BATT_MEAS_LOAD_AUDIO, true);
+#endif
+
     m_audio_enabled = true;
 
     return NRF_SUCCESS;
@@ -335,6 +489,10 @@ ret_code_t m_audio_disable(void)
         return status;
     }
 
+#if CONFIG_BATT_MEAS_ENABLED
+    m_batt_meas_load_set(M_BATT_MEAS_LOAD_AUDIO, false);
+#endif
+
 #if CONFIG_AUDIO_GAUGES_ENABLED
     /*
      * Audio is disabled but some buffers might be present in the background scheduler queue.
@@ -352,6 +510,40 @@ ret_code_t m_audio_disable(void)
     return NRF_SUCCESS;
 }
 
+ret_code_t m_audio_sampling_frequency_set(uint32_t frequency)
+{
+    if (m_audio_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+#if CONFIG_AUDIO_SRC_ENABLED && (CONFIG_AUDIO_CODEC == CONFIG_AUDIO_CODEC_ADPCM)
+    // ADPCM does not depend on the sampling frequency, so the converter may produce any frequency it supports.
+    if ((frequency < DRV_AUDIO_SRC_MIN_FREQUENCY) || (frequency > M_AUDIO_SRC_MAX_FREQUENCY))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+#else
+    if (frequency != CONFIG_AUDIO_SAMPLING_FREQUENCY)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    if (m_audio_sampling_frequency != frequency)
+    {
+        NRF_LOG_INFO("Sampling frequency: %u Hz", frequency);
+        m_audio_sampling_frequency = frequency;
+    }
+
+    return NRF_SUCCESS;
+}
+
+uint32_t m_audio_sampling_frequency_get(void)
+{
+    return m_audio_sampling_frequency;
+}
+
 #if CONFIG_PWR_MGMT_ENABLED
 static bool m_audio_shutdown(nrf_pwr_mgmt_evt_t event)
 {
@@ -420,10 +612,18 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
 
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Configuration:\r\n");
 
+#if CONFIG_AUDIO_SRC_ENABLED
+    nrf_cli_fprintf(p_cli,
+                    NRF_CLI_NORMAL,
+                    "\tSampling Frequency:\t%u Hz (converted from %u Hz)\r\n",
+                    m_audio_sampling_frequency,
+                    CONFIG_PDM_REAL_SAMPLING_FREQUENCY);
+#else
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\tSampling Frequency:\t%u Hz\r\n",
                     CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY);
+#endif
 
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
@@ -434,6 +634,14 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
                     CONFIG_AUDIO_FRAME_SIZE_BYTES,
                     8ul * CONFIG_AUDIO_FRAME_SIZE_BYTES * CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY / CONFIG_AUDIO_FRAME_SIZE_SAMPLES / 1000);
 
+    nrf_cli_fprintf(p_cli,
+                    NRF_CLI_NORMAL,
+                    "\tCapture Block:\t\t%u.%02u ms (%u samples, %u buffers)\r\n",
+                    (1000ul * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES / CONFIG_PDM_REAL_SAMPLING_FREQUENCY),
+                    (100000ul * CONFIG_AUDIO_BLOCK_SIZE_SAMPLES / CONFIG_PDM_REAL_SAMPLING_FREQUENCY) % 100,
+                    CONFIG_AUDIO_BLOCK_SIZE_SAMPLES,
+                    CONFIG_PDM_BUFFER_POOL_SIZE);
+
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\r\nStatus: %s\r\n",
@@ -487,6 +695,16 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
                     m_audio_gauge_get_max_cpu_usage(&m_anr_cpu_gauge));
 #endif
 
+#if CONFIG_AUDIO_NS_ENABLED
+    nrf_cli_fprintf(p_cli,
+                    NRF_CLI_NORMAL,
+                    "\t    - NS:\t\t%u%% (min/avg/max: %u%%/%u%%/%u%%)\r\n",
+                    m_audio_gauge_get_cur_cpu_usage(&m_ns_cpu_gauge),
+                    m_audio_gauge_get_min_cpu_usage(&m_ns_cpu_gauge),
+                    m_audio_gauge_get_avg_cpu_usage(&m_ns_cpu_gauge),
+                    m_audio_gauge_get_max_cpu_usage(&m_ns_cpu_gauge));
+#endif
+
 #if CONFIG_AUDIO_EQUALIZER_ENABLED
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
@@ -507,6 +725,16 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
                     m_audio_gauge_get_max_cpu_usage(&m_gain_cpu_gauge));
 #endif
 
+#if CONFIG_AUDIO_SRC_ENABLED
+    nrf_cli_fprintf(p_cli,
+                    NRF_CLI_NORMAL,
+                    "\t    - SRC:\t\t%u%% (min/avg/max: %u%%/%u%%/%u%%)\r\n",
+                    m_audio_gauge_get_cur_cpu_usage(&m_src_cpu_gauge),
+                    m_audio_gauge_get_min_cpu_usage(&m_src_cpu_gauge),
+                    m_audio_gauge_get_avg_cpu_usage(&m_src_cpu_gauge),
+                    m_audio_gauge_get_max_cpu_usage(&m_src_cpu_gauge));
+#endif
+
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\t    - Codec:\t\t%u%% (min/avg/max: %u%%/%u%%/%u%%)\r\n",
@@ -514,21 +742,29 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
                     m_audio_gauge_get_min_cpu_usage(&m_codec_cpu_gauge),
                     m_audio_gauge_get_avg_cpu_usage(&m_codec_cpu_gauge),
                     m_audio_gauge_get_max_cpu_usage(&m_codec_cpu_gauge));
+
+    nrf_cli_fprintf(p_cli,
+                    NRF_CLI_NORMAL,
+                    "\t    - Send:\t\t%u%% (min/avg/max: %u%%/%u%%/%u%%)\r\n",
+                    m_audio_gauge_get_cur_cpu_usage(&m_send_cpu_gauge),
+                    m_audio_gauge_get_min_cpu_usage(&m_send_cpu_gauge),
+                    m_audio_gauge_get_avg_cpu_usage(&m_send_cpu_gauge),
+                    m_audio_gauge_get_max_cpu_usage(&m_send_cpu_gauge));
 #endif /* CONFIG_AUDIO_GAUGES_ENABLED */
 
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\r\n\tBuffer Pool Usage:\t%u%% (%u out of %u buffers)\r\n",
-                    100ul * buffer_pool_usage / CONFIG_AUDIO_BUFFER_POOL_SIZE,
+                    100ul * buffer_pool_usage / CONFIG_PDM_BUFFER_POOL_SIZE,
                     buffer_pool_usage,
-                    CONFIG_AUDIO_BUFFER_POOL_SIZE);
+                    CONFIG_PDM_BUFFER_POOL_SIZE);
 
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
                     "\t    - Maximum:\t\t%u%% (%u out of %u buffers)\r\n",
-                    100ul * buffer_pool_max_usage / CONFIG_AUDIO_BUFFER_POOL_SIZE,
+                    100ul * buffer_pool_max_usage / CONFIG_PDM_BUFFER_POOL_SIZE,
                     buffer_pool_max_usage,
-                    CONFIG_AUDIO_BUFFER_POOL_SIZE);
+                    CONFIG_PDM_BUFFER_POOL_SIZE);
 
     nrf_cli_fprintf(p_cli,
                     NRF_CLI_NORMAL,
@@ -545,9 +781,149 @@ static void m_audio_info_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
                     CONFIG_AUDIO_FRAME_POOL_SIZE);
 }
 
+#if CONFIG_AUDIO_GAUGES_ENABLED && CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+typedef struct
+{
+    const char          *p_name;
+    m_audio_cpu_gauge_t *p_gauge;
+} m_audio_cpu_stage_t;
+
+static const m_audio_cpu_stage_t m_audio_cpu_stages[] =
+{
+    { "total",  &m_total_cpu_gauge },
+#if CONFIG_AUDIO_ANR_ENABLED
+    { "anr",    &m_anr_cpu_gauge },
+#endif
+#if CONFIG_AUDIO_NS_ENABLED
+    { "ns",     &m_ns_cpu_gauge },
+#endif
+#if CONFIG_AUDIO_EQUALIZER_ENABLED
+    { "eq",     &m_eq_cpu_gauge },
+#endif
+#if CONFIG_AUDIO_GAIN_CONTROL_ENABLED
+    { "gain",   &m_gain_cpu_gauge },
+#endif
+#if CONFIG_AUDIO_SRC_ENABLED
+    { "src",    &m_src_cpu_gauge },
+#endif
+    { "codec",  &m_codec_cpu_gauge },
+    { "send",   &m_send_cpu_gauge },
+};
+
+/**@brief Take a consistent copy of a gauge which might be updated by audio processing. */
+static void m_audio_cpu_gauge_snapshot(const m_audio_cpu_gauge_t *p_gauge, m_audio_cpu_gauge_t *p_copy)
+{
+    CRITICAL_REGION_ENTER();
+    memcpy(p_copy, p_gauge, sizeof(*p_copy));
+    CRITICAL_REGION_EXIT();
+}
+
+/**@brief Convert clock ticks to microseconds. */
+static uint32_t m_audio_cpu_ticks_to_us(uint32_t ticks)
+{
+    return (uint64_t)ticks * 1000000ul / m_audio_cpu_gauge_clock_frequency();
+}
+
+static void m_audio_cpu_dump_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    m_audio_cpu_gauge_t gauge;
+    uint32_t lower, upper;
+    unsigned int bin;
+
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    // Header: fixed columns followed by the lower edges of the histogram bins.
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "stage,clock_hz,frame,frames,overruns,min,avg,max");
+    for (bin = 0; bin < M_AUDIO_CPU_HISTOGRAM_BINS; bin++)
+    {
+        m_audio_cpu_gauge_bin_range(bin, &lower, &upper);
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, ",%u", lower);
+    }
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\r\n");
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_audio_cpu_stages); i++)
+    {
+        m_audio_cpu_gauge_snapshot(m_audio_cpu_stages[i].p_gauge, &gauge);
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%s,%u,%u,%u,%u,%u,%u,%u",
+                        m_audio_cpu_stages[i].p_name,
+                        m_audio_cpu_gauge_clock_frequency(),
+                        gauge.frame_time,
+                        gauge.frames,
+                        gauge.overruns,
+                        (gauge.frames != 0) ? gauge.min_time : 0,
+                        (gauge.frames != 0) ? (uint32_t)(gauge.cpu_time / gauge.frames) : 0,
+                        gauge.max_time);
+
+        for (bin = 0; bin < M_AUDIO_CPU_HISTOGRAM_BINS; bin++)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, ",%u", gauge.histogram[bin]);
+        }
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\r\n");
+    }
+}
+
+static void m_audio_cpu_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    m_audio_cpu_gauge_t gauge;
+
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    if (argc >= 2)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Unknown subcommand '%s'!\r\n", argv[1]);
+        return;
+    }
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Processing time [us] (block: %u us, frame: %u us):\r\n",
+                    m_audio_cpu_ticks_to_us(m_total_cpu_gauge.frame_time),
+                    m_audio_cpu_ticks_to_us(m_codec_cpu_gauge.frame_time));
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%8s%8s%8s%8s%8s%8s%8s%8s%8s\r\n",
+                    "Stage", "Count", "Overrun", "Min", "Avg", "P50", "P90", "P99", "Max");
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_audio_cpu_stages); i++)
+    {
+        m_audio_cpu_gauge_snapshot(m_audio_cpu_stages[i].p_gauge, &gauge);
+
+        if (gauge.frames == 0)
+        {
+            continue;
+        }
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%8s%8u%8u%8u%8u%8u%8u%8u%8u\r\n",
+                        m_audio_cpu_stages[i].p_name,
+                        gauge.frames,
+                        gauge.overruns,
+                        m_audio_cpu_ticks_to_us(gauge.min_time),
+                        m_audio_cpu_ticks_to_us(gauge.cpu_time / gauge.frames),
+                        m_audio_cpu_ticks_to_us(m_audio_cpu_gauge_percentile(&gauge, 50)),
+                        m_audio_cpu_ticks_to_us(m_audio_cpu_gauge_percentile(&gauge, 90)),
+                        m_audio_cpu_ticks_to_us(m_audio_cpu_gauge_percentile(&gauge, 99)),
+                        m_audio_cpu_ticks_to_us(gauge.max_time));
+    }
+}
+
+NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_audio_cpu_subcmds)
+{
+    NRF_CLI_CMD(dump,   NULL,   "print processing time histograms in CSV format",   m_audio_cpu_dump_cmd),
+    {NULL}
+};
+#endif /* CONFIG_AUDIO_GAUGES_ENABLED && CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED */
+
 NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_audio_subcmds)
 {
     NRF_CLI_CMD(codec,  &drv_audio_codec_subcmds,   "show or configure audio codec parameters",     m_audio_cmd),
+#if CONFIG_AUDIO_GAUGES_ENABLED && CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED
+    NRF_CLI_CMD(cpu,    &m_audio_cpu_subcmds,       "show processing time percentiles of audio stages", m_audio_cpu_cmd),
+#endif
     NRF_CLI_CMD(driver, &drv_audio_subcmds,         "show or configure audio driver parameters",    m_audio_cmd),
     NRF_CLI_CMD(info,   NULL,                       "print information about audio subsystem",      m_audio_info_cmd),
 #if CONFIG_AUDIO_PROBE_ENABLED
@@ -75,6 +75,26 @@ ret_code_t m_audio_enable(void);
  */
 ret_code_t m_audio_disable(void);
 
+/**@brief Function for setting the sampling frequency of transmitted audio.
+ *
+ * @details The frequency can be changed only while audio is disabled. Frequencies other than
+ *          CONFIG_AUDIO_SAMPLING_FREQUENCY require sample rate conversion and a codec which
+ *          does not depend on the sampling frequency (ADPCM).
+ *
+ * @param[in] frequency Sampling frequency in Hz.
+ *
+ * @retval NRF_SUCCESS
+ * @retval NRF_ERROR_INVALID_STATE  Audio is enabled.
+ * @retval NRF_ERROR_NOT_SUPPORTED  The frequency cannot be used with the current configuration.
+ */
+ret_code_t m_audio_sampling_frequency_set(uint32_t frequency);
+
+/**@brief Function for getting the sampling frequency of transmitted audio.
+ *
+ * @return Sampling frequency in Hz.
+ */
+uint32_t m_audio_sampling_frequency_get(void);
+
 /**@brief Function for printing audio module statistics. */
 void m_audio_print_stats(void);
 
@@ -54,6 +54,9 @@
 /**@brief Compressed audio frame representation. */
 typedef struct
 {
+#if CONFIG_AUDIO_FRAME_HEADROOM
+    uint8_t     headroom[CONFIG_AUDIO_FRAME_HEADROOM];  /**< Space for a transport header completed directly in front of the data. */
+#endif
     uint8_t     data[CONFIG_AUDIO_FRAME_SIZE_BYTES];
     uint8_t     reference_count;
     uint16_t    data_size;
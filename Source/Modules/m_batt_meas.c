@@ -42,8 +42,10 @@
 
 #include "nrf_drv_saadc.h"
 #include "nrf_pwr_mgmt.h"
+#include "nrf_soc.h"
 #include "app_debug.h"
 #include "app_timer.h"
+#include "app_util_platform.h"
 
 #include "event_bus.h"
 #include "m_batt_meas.h"
@@ -60,44 +62,207 @@ NRF_LOG_MODULE_REGISTER();
 
 // Verify SDK configuration.
 STATIC_ASSERT(SAADC_ENABLED);
+STATIC_ASSERT(NRF_SDH_BLE_ENABLED);
 
 #define ADC_CHANNEL     0
 #define ADC_DIVIDER     6
 #define ADC_REFERENCE   600 /* mV */
 #define ADC_MAX_CONV    ((1 << 14) - 1)
 
+/**@brief Time after which the measurement is taken even if no radio event has ended [ms]. */
+#define BATT_MEAS_SYNC_TIMEOUT  2000
+
+/**@brief The load is accounted at least every 240 s, so that the 24-bit RTC counter cannot wrap in the meantime. */
+#define BATT_MEAS_TIMER_STEPS   CEIL_DIV(CONFIG_BATT_MEAS_POLL_INTERVAL, 240)
+#define BATT_MEAS_TIMER_PERIOD  (CONFIG_BATT_MEAS_POLL_INTERVAL / BATT_MEAS_TIMER_STEPS) /* s */
+
+/**@brief Weight of the voltage based estimate when it is combined with the charge based prediction (1/2^N). */
+#define BATT_MEAS_SOC_FILTER_SHIFT      2
+
+/**@brief Weight of the newest measurement period in the average current (1/2^N). */
+#define BATT_MEAS_CURRENT_FILTER_SHIFT  8
+
+/**@brief Charge of 1 per mille of the battery capacity [uA * s]. */
+#define BATT_MEAS_SOC_UNIT      (CONFIG_BATT_MEAS_CAPACITY * 3600)
+
+#define BATT_MEAS_SOC_INVALID   UINT16_MAX
+
+STATIC_ASSERT(CONFIG_BATT_MEAS_MAX_LEVEL > CONFIG_BATT_MEAS_MIN_LEVEL);
+STATIC_ASSERT(CONFIG_BATT_MEAS_CAPACITY > 0);
+
+/**@brief Discharge curve: the battery voltage at 0%, 10%, ..., 100% state of charge.
+ *
+ * @details The voltage is given in per mille of the range between @ref CONFIG_BATT_MEAS_MIN_LEVEL and
+ *          @ref CONFIG_BATT_MEAS_MAX_LEVEL. The curve follows two alkaline cells under low load, which
+ *          drop quickly when fresh and nearly empty, and slowly in between.
+ */
+static const uint16_t m_batt_meas_discharge_curve[] =
+{
+    0, 308, 431, 508, 569, 631, 692, 754, 815, 892, 1000,
+};
+
+/**@brief Current drawn by each of the loads [uA]. */
+static const uint16_t m_batt_meas_load_current[M_BATT_MEAS_LOAD_COUNT] =
+{
+    [M_BATT_MEAS_LOAD_AUDIO]    = CONFIG_BATT_MEAS_AUDIO_CURRENT,
+    [M_BATT_MEAS_LOAD_GYRO]     = CONFIG_BATT_MEAS_GYRO_CURRENT,
+    [M_BATT_MEAS_LOAD_LED]      = CONFIG_BATT_MEAS_LED_CURRENT,
+};
+
 APP_TIMER_DEF           (m_batt_timer);                 /**< Battery measurement timer. */
+APP_TIMER_DEF           (m_batt_sync_timer);            /**< Radio synchronization timeout timer. */
 static uint8_t          m_batt_meas_prev_level = 255;   /**< Previous notified battery level. */
+static uint8_t          m_batt_meas_timer_steps;        /**< Timer expirations since the last measurement. */
+static uint8_t          m_batt_meas_loads;              /**< Bitmask of active loads. */
+static uint32_t         m_batt_meas_timestamp;          /**< Time of the last load accounting. */
+static uint32_t         m_batt_meas_elapsed;            /**< Ticks since the last measurement. */
+static uint64_t         m_batt_meas_charge;             /**< Charge drawn since the last measurement [uA * tick]. */
+static uint32_t         m_batt_meas_charge_carry;       /**< Charge drawn, but not subtracted from the state of charge yet [uA * s]. */
+static uint32_t         m_batt_meas_current_sum;        /**< Average current multiplied by 2^BATT_MEAS_CURRENT_FILTER_SHIFT [uA]. */
+static uint16_t         m_batt_meas_soc;                /**< Estimated state of charge [per mille]. */
+static volatile bool    m_batt_meas_sample_pending;     /**< Measurement waits for the end of a radio event. */
 #if CONFIG_PWR_MGMT_ENABLED
 static bool             m_batt_meas_going_down;         /**< True if module shutdown was requested. */
 #endif
 
-/**@brief Process ADC data. */
-static void m_batt_meas_process(void *p_context)
+/**@brief Get the current drawn by the active loads [uA]. */
+static uint32_t m_batt_meas_load_current_get(void)
 {
-    nrf_saadc_value_t measurement = *(nrf_saadc_value_t *)(p_context);
-    uint32_t voltage;
-    uint8_t level;
+    uint32_t current = 0;
 
-    // Calculate battery voltage.
-    voltage = ((uint32_t)(measurement) * ADC_DIVIDER * ADC_REFERENCE) / ADC_MAX_CONV;
+    for (size_t i = 0; i < ARRAY_SIZE(m_batt_meas_load_current); i++)
+    {
+        if (m_batt_meas_loads & (1u << i))
+        {
+            current += m_batt_meas_load_current[i];
+        }
+    }
+
+    return current;
+}
+
+/**@brief Account the charge drawn since the last call. */
+static void m_batt_meas_account(void)
+{
+    uint32_t now        = app_timer_cnt_get();
+    uint32_t elapsed    = app_timer_cnt_diff_compute(now, m_batt_meas_timestamp);
+
+    m_batt_meas_charge      += (uint64_t)(CONFIG_BATT_MEAS_IDLE_CURRENT + m_batt_meas_load_current_get()) * elapsed;
+    m_batt_meas_elapsed     += elapsed;
+    m_batt_meas_timestamp    = now;
+}
+
+/**@brief Convert the battery voltage to the state of charge using the discharge curve.
+ *
+ * @param[in] voltage   Battery voltage without load [mV].
+ *
+ * @return State of charge [per mille].
+ */
+static uint16_t m_batt_meas_voltage_to_soc(uint32_t voltage)
+{
+    uint32_t relative;
+    size_t i;
 
-    // A simple linear approximation is sufficient when the power consumption is fairly low (< 100 mW).
     if (voltage >= CONFIG_BATT_MEAS_MAX_LEVEL)
     {
-        level = 100;
+        return 1000;
+    }
+
+    if (voltage <= CONFIG_BATT_MEAS_MIN_LEVEL)
+    {
+        return 0;
+    }
+
+    relative = 1000 * (voltage - CONFIG_BATT_MEAS_MIN_LEVEL) /
+               (CONFIG_BATT_MEAS_MAX_LEVEL - CONFIG_BATT_MEAS_MIN_LEVEL);
+
+    for (i = 1; relative > m_batt_meas_discharge_curve[i]; i++)
+    {
+        /* Find the curve segment */
     }
-    else if (voltage <= CONFIG_BATT_MEAS_MIN_LEVEL)
+
+    return (100 * (i - 1)) + ((100 * (relative - m_batt_meas_discharge_curve[i - 1])) /
+                              (m_batt_meas_discharge_curve[i] - m_batt_meas_discharge_curve[i - 1]));
+}
+
+/**@brief Update the state of charge with a new voltage measurement.
+ *
+ * @details The charge drawn by the loads predicts how much the state of charge has dropped since
+ *          the last measurement. The prediction is then corrected towards the value read from the
+ *          discharge curve, so that the model error cannot accumulate, while the voltage noise
+ *          is filtered out.
+ *
+ * @param[in] voltage   Battery voltage without load [mV].
+ */
+static void m_batt_meas_soc_update(uint32_t voltage)
+{
+    uint32_t ticks_per_s    = APP_TIMER_TICKS(1000);
+    uint32_t charge         = (uint32_t)(m_batt_meas_charge / ticks_per_s); /* uA * s */
+    int32_t  soc_voltage    = m_batt_meas_voltage_to_soc(voltage);
+    int32_t  soc;
+    uint32_t used;
+
+    if (m_batt_meas_elapsed >= ticks_per_s)
     {
-        level = 0;
+        uint32_t current = charge / (m_batt_meas_elapsed / ticks_per_s);
+
+        m_batt_meas_current_sum += current - (m_batt_meas_current_sum >> BATT_MEAS_CURRENT_FILTER_SHIFT);
+    }
+
+    if (m_batt_meas_soc == BATT_MEAS_SOC_INVALID)
+    {
+        soc = soc_voltage;
+        m_batt_meas_charge_carry = 0;
     }
     else
     {
-        level = 100 * (voltage - CONFIG_BATT_MEAS_MIN_LEVEL) /
-                (CONFIG_BATT_MEAS_MAX_LEVEL - CONFIG_BATT_MEAS_MIN_LEVEL);
+        // A single period rarely drains a whole per mille, so keep the remainder for the next one.
+        charge += m_batt_meas_charge_carry;
+        used    = charge / BATT_MEAS_SOC_UNIT;
+        m_batt_meas_charge_carry = charge - (used * BATT_MEAS_SOC_UNIT);
+
+        soc = MAX((int32_t)(m_batt_meas_soc) - (int32_t)(used), 0);
+        soc += (soc_voltage - soc) / (1 << BATT_MEAS_SOC_FILTER_SHIFT);
     }
 
-    NRF_LOG_INFO("Battery level: %u%% (%u mV)", level, voltage);
+    m_batt_meas_soc     = soc;
+    m_batt_meas_charge  = 0;
+    m_batt_meas_elapsed = 0;
+}
+
+/**@brief Get the remaining battery life at the average current [h]. */
+static uint32_t m_batt_meas_remaining_time(void)
+{
+    uint32_t current = MAX(m_batt_meas_current_sum >> BATT_MEAS_CURRENT_FILTER_SHIFT, 1);
+
+    // Remaining charge [uAh] divided by the average current [uA].
+    return (m_batt_meas_soc * CONFIG_BATT_MEAS_CAPACITY) / current;
+}
+
+/**@brief Process ADC data. */
+static void m_batt_meas_process(void *p_context)
+{
+    nrf_saadc_value_t measurement = *(nrf_saadc_value_t *)(p_context);
+    uint32_t voltage;
+    uint32_t drop;
+    uint8_t level;
+
+    APP_ERROR_CHECK(app_timer_stop(m_batt_sync_timer));
+    m_batt_meas_account();
+
+    // Calculate battery voltage.
+    voltage = ((uint32_t)(measurement) * ADC_DIVIDER * ADC_REFERENCE) / ADC_MAX_CONV;
+
+    // The measurement is taken between radio events, but other loads might be active. Compensate for the voltage drop they cause.
+    drop = (m_batt_meas_load_current_get() * CONFIG_BATT_MEAS_INTERNAL_RESISTANCE) / 1000000;
+
+    m_batt_meas_soc_update(voltage + drop);
+    level = (m_batt_meas_soc + 5) / 10;
+
+    NRF_LOG_INFO("Battery level: %u%% (%u mV + %u mV)", level, voltage, drop);
+    NRF_LOG_DEBUG("Average current: %u uA, remaining time: %u h",
+                  m_batt_meas_current_sum >> BATT_MEAS_CURRENT_FILTER_SHIFT,
+                  m_batt_meas_remaining_time());
 
     /*
      * Only notify the application about the battery level if:
@@ -113,13 +278,58 @@ static void m_batt_meas_process(void *p_context)
     }
 }
 
-static void m_batt_meas_timeout_handler(void* p_context)
+/**@brief Stop waiting for the end of a radio event.
+ *
+ * @return True if the measurement was still pending.
+ */
+static bool m_batt_meas_sync_stop(void)
+{
+    bool pending;
+
+    CRITICAL_REGION_ENTER();
+    pending = m_batt_meas_sample_pending;
+    m_batt_meas_sample_pending = false;
+    CRITICAL_REGION_EXIT();
+
+    if (pending)
+    {
+        // The notification wakes the CPU after every radio event, so it is enabled only while a sample waits for it.
+        APP_ERROR_CHECK(sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_NONE,
+                                                      NRF_RADIO_NOTIFICATION_DISTANCE_NONE));
+    }
+
+    return pending;
+}
+
+void m_batt_meas_radio_evt_handler(void)
+{
+    if (m_batt_meas_sync_stop())
+    {
+        APP_ERROR_CHECK(nrf_drv_saadc_sample());
+    }
+}
+
+/**@brief Sample the battery voltage if no radio event has ended in time. */
+static void m_batt_meas_sync_timeout_handler(void *p_context)
+{
+    if (m_batt_meas_sync_stop())
+    {
+        APP_ERROR_CHECK(nrf_drv_saadc_sample());
+    }
+}
+
+/**@brief Start the measurement.
+ *
+ * @details Radio bursts make the battery voltage sag, so the sample is taken at the end of the
+ *          nearest radio event.
+ */
+static void m_batt_meas_start(void *p_context)
 {
     static nrf_saadc_value_t buffer;
 
 #if CONFIG_PWR_MGMT_ENABLED
     /*
-     * Timeout handler might be called after shutdown, when the SAADC driver is already uninitialized.
+     * Measurement might be requested after shutdown, when the SAADC driver is already uninitialized.
      * In such case, the measurement cannot be perfomed.
      */
     if (m_batt_meas_going_down)
@@ -128,8 +338,35 @@ static void m_batt_meas_timeout_handler(void* p_context)
     }
 #endif
 
+    if (m_batt_meas_sample_pending)
+    {
+        return;
+    }
+
     APP_ERROR_CHECK(nrf_drv_saadc_buffer_convert(&buffer, 1));
-    APP_ERROR_CHECK(nrf_drv_saadc_sample());
+
+    m_batt_meas_sample_pending = true;
+    APP_ERROR_CHECK(sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_INT_ON_INACTIVE,
+                                                  NRF_RADIO_NOTIFICATION_DISTANCE_NONE));
+    APP_ERROR_CHECK(app_timer_start(m_batt_sync_timer, APP_TIMER_TICKS(BATT_MEAS_SYNC_TIMEOUT), NULL));
+}
+
+static void m_batt_meas_timeout_handler(void* p_context)
+{
+#if CONFIG_PWR_MGMT_ENABLED
+    if (m_batt_meas_going_down)
+    {
+        return;
+    }
+#endif
+
+    m_batt_meas_account();
+
+    if (++m_batt_meas_timer_steps >= BATT_MEAS_TIMER_STEPS)
+    {
+        m_batt_meas_timer_steps = 0;
+        m_batt_meas_start(NULL);
+    }
 }
 
 
@@ -140,12 +377,12 @@ void m_batt_meas_saadc_event_handler(const nrf_drv_saadc_evt_t *p_event)
         case NRF_DRV_SAADC_EVT_CALIBRATEDONE:
             // Perform first measurement just after calibration.
             APP_ERROR_CHECK(app_isched_event_put(&g_fg_scheduler,
-                                                 m_batt_meas_timeout_handler,
+                                                 m_batt_meas_start,
                                                  NULL));
 
             // The following measurements will be done at regular intervals.
             APP_ERROR_CHECK(app_timer_start(m_batt_timer,
-                                            APP_TIMER_TICKS(1000u * CONFIG_BATT_MEAS_POLL_INTERVAL),
+                                            APP_TIMER_TICKS(1000u * BATT_MEAS_TIMER_PERIOD),
                                             NULL));
             break;
 
@@ -162,6 +399,40 @@ void m_batt_meas_saadc_event_handler(const nrf_drv_saadc_evt_t *p_event)
     }
 }
 
+void m_batt_meas_load_set(m_batt_meas_load_t load, bool active)
+{
+    ASSERT(load < M_BATT_MEAS_LOAD_COUNT);
+
+    // Account the charge drawn with the previous set of loads.
+    m_batt_meas_account();
+
+    if (active)
+    {
+        m_batt_meas_loads |= (1u << load);
+    }
+    else
+    {
+        m_batt_meas_loads &= ~(1u << load);
+    }
+}
+
+ret_code_t m_batt_meas_remaining_time_get(uint32_t *p_hours)
+{
+    if (p_hours == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (m_batt_meas_soc == BATT_MEAS_SOC_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    *p_hours = m_batt_meas_remaining_time();
+
+    return NRF_SUCCESS;
+}
+
 ret_code_t m_batt_meas_init(void)
 {
     nrf_saadc_channel_config_t adc_channel_config = NRF_DRV_SAADC_DEFAULT_CHANNEL_CONFIG_SE(NRF_SAADC_INPUT_VDD);
@@ -176,6 +447,14 @@ ret_code_t m_batt_meas_init(void)
     adc_channel_config.burst = (SAADC_CONFIG_OVERSAMPLE != 0) ? NRF_SAADC_BURST_ENABLED :
                                                                 NRF_SAADC_BURST_DISABLED;
 
+    m_batt_meas_soc             = BATT_MEAS_SOC_INVALID;
+    m_batt_meas_current_sum     = CONFIG_BATT_MEAS_IDLE_CURRENT << BATT_MEAS_CURRENT_FILTER_SHIFT;
+    m_batt_meas_charge          = 0;
+    m_batt_meas_elapsed         = 0;
+    m_batt_meas_timer_steps     = 0;
+    m_batt_meas_timestamp       = app_timer_cnt_get();
+    m_batt_meas_sample_pending  = false;
+
     status = nrf_drv_saadc_init(NULL, m_batt_meas_saadc_event_handler);
     if (status != NRF_SUCCESS)
     {
@@ -194,6 +473,12 @@ ret_code_t m_batt_meas_init(void)
         return status;
     }
 
+    status = app_timer_create(&m_batt_sync_timer, APP_TIMER_MODE_SINGLE_SHOT, m_batt_meas_sync_timeout_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
     // Trigger calibration procedure.
     return nrf_drv_saadc_calibrate_offset();
 }
@@ -204,6 +489,12 @@ static bool m_batt_meas_shutdown(nrf_pwr_mgmt_evt_t event)
     m_batt_meas_going_down = true;
 
     app_timer_stop(m_batt_timer);
+    app_timer_stop(m_batt_sync_timer);
+
+    // The SoftDevice might be already disabled, so the pending measurement is dropped without checking the result.
+    m_batt_meas_sample_pending = false;
+    (void)sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_NONE, NRF_RADIO_NOTIFICATION_DISTANCE_NONE);
+
     nrf_drv_saadc_channel_uninit(ADC_CHANNEL);
     nrf_drv_saadc_uninit();
 
@@ -47,14 +47,52 @@
 #ifndef __M_BATT_MEAS_H__
 #define __M_BATT_MEAS_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/**@brief Loads taken into account by the battery state estimation. */
+typedef enum
+{
+    M_BATT_MEAS_LOAD_AUDIO,     /**< Microphone and audio processing. */
+    M_BATT_MEAS_LOAD_GYRO,      /**< Gyroscope. */
+    M_BATT_MEAS_LOAD_LED,       /**< Any of the LEDs. */
+    M_BATT_MEAS_LOAD_COUNT
+} m_batt_meas_load_t;
+
 /**@brief Function for initializing battery measurement.
+ *
+ * @note The SoftDevice has to be enabled, as the measurement is synchronized with the radio activity.
  *
  * @return NRF_SUCCESS on success, otherwise an error code.
  */
 ret_code_t m_batt_meas_init(void);
 
+/**@brief Function for reporting the state of a load.
+ *
+ * @details The load is used to estimate the charge drawn from the battery and to compensate
+ *          the voltage drop on the battery internal resistance.
+ *
+ * @param[in] load      Load which state has changed.
+ * @param[in] active    True if the load has been turned on, false if it has been turned off.
+ */
+void m_batt_meas_load_set(m_batt_meas_load_t load, bool active);
+
+/**@brief Function for getting the estimated remaining battery life.
+ *
+ * @param[out] p_hours  Remaining time at the average current drawn so far [h].
+ *
+ * @return NRF_SUCCESS on success, NRF_ERROR_INVALID_STATE if the battery has not been measured yet.
+ */
+ret_code_t m_batt_meas_remaining_time_get(uint32_t *p_hours);
+
+/**@brief Function for handling the radio notification.
+ *
+ * @details The notification is enabled while a measurement is pending and comes at the end of the next radio event,
+ *          when the battery voltage does not sag. Has to be called from the SWI1 interrupt handler, only when the
+ *          interrupt was not raised by the foreground scheduler.
+ */
+void m_batt_meas_radio_evt_handler(void);
+
 #endif /* __M_BATT_MEAS_H__ */
 /** @} */
 
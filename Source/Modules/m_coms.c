@@ -51,6 +51,7 @@
 #include "m_coms_ble.h"
 #include "m_coms_ble_adv.h"
 #include "m_coms_ble_atvv.h"
+#include "m_coms_ble_conn_policy.h"
 #include "m_coms_ble_hid.h"
 #include "m_protocol_hid_state.h"
 #include "m_nfc.h"
@@ -115,8 +116,14 @@ NRF_LOG_MODULE_REGISTER();
 # error "Unsupported Audio Compression"
 #endif
 
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+# define AUDIO_TRANSPORT_CONFIG_ID      0x80    /**< Audio frames are packed into reports behind chunk headers. */
+#else
+# define AUDIO_TRANSPORT_CONFIG_ID      0x00    /**< Audio frames are fragmented into reports. */
+#endif
+
 // Use AUDIO_CONFIG_ID to pass details about audio processing chain configuration.
-#define AUDIO_CONFIG_ID                 (AUDIO_SAMPLING_FREQUENCY_ID | AUDIO_CODEC_CONFIG_ID)
+#define AUDIO_CONFIG_ID                 (AUDIO_SAMPLING_FREQUENCY_ID | AUDIO_CODEC_CONFIG_ID | AUDIO_TRANSPORT_CONFIG_ID)
 
 // Make sure that the complete Audio Input Report size is byte aligned.
 STATIC_ASSERT(((AUDIO_IN_REP_SIZE * AUDIO_IN_REP_COUNT) % 8) == 0);
@@ -150,15 +157,25 @@ STATIC_ASSERT(((CONSUMER_CTRL_IN_REP_SIZE * CONSUMER_CTRL_IN_REP_COUNT) % 8) ==
 STATIC_ASSERT(((MOUSE_BTN_IN_REP_SIZE * MOUSE_BTN_IN_REP_COUNT) % 8) == 0);
 
 #define MOUSE_XY_IN_REP_ID              8   /**< Mouse X/Y Input Report ID. */
+#if CONFIG_HID_HIGH_RES_ENABLED
+#define MOUSE_XY_IN_REP_SIZE            16  /**< Size of a single field in the Mouse X/Y Input Report [bits]. */
+#else
 #define MOUSE_XY_IN_REP_SIZE            12  /**< Size of a single field in the Mouse X/Y Input Report [bits]. */
+#endif
 #define MOUSE_XY_IN_REP_COUNT           2   /**< Number of fields in the Mouse X/Y Input Report. */
+#define MOUSE_XY_IN_REP_MAX             ((1 << (MOUSE_XY_IN_REP_SIZE - 1)) - 1) /**< Maximum magnitude of a field in the Mouse X/Y Input Report. */
 
 // Make sure that the complete Mouse X/Y Input Report size is byte aligned.
 STATIC_ASSERT(((MOUSE_XY_IN_REP_SIZE * MOUSE_XY_IN_REP_COUNT) % 8) == 0);
 
 #define MOUSE_WP_IN_REP_ID              9   /**< Mouse Wheel/Pan Input Report ID. */
+#if CONFIG_HID_HIGH_RES_ENABLED
+#define MOUSE_WP_IN_REP_SIZE            16  /**< Size of a single field in the Mouse Wheel/Pan Input Report [bits]. */
+#else
 #define MOUSE_WP_IN_REP_SIZE            8   /**< Size of a single field in the Mouse Wheel/Pan Input Report [bits]. */
+#endif
 #define MOUSE_WP_IN_REP_COUNT           2   /**< Number of fields in the Mouse Wheel/Pan Input Report. */
+#define MOUSE_WP_IN_REP_MAX             ((1 << (MOUSE_WP_IN_REP_SIZE - 1)) - 1) /**< Maximum magnitude of a field in the Mouse Wheel/Pan Input Report. */
 
 // Make sure that the complete Mouse Wheel/Pan Input Report size is byte aligned.
 STATIC_ASSERT(((MOUSE_WP_IN_REP_SIZE * MOUSE_WP_IN_REP_COUNT) % 8) == 0);
@@ -166,6 +183,18 @@ STATIC_ASSERT(((MOUSE_WP_IN_REP_SIZE * MOUSE_WP_IN_REP_COUNT) % 8) == 0);
 // Make sure that Mouse Wheel/Pan report count matches HID descriptor.
 STATIC_ASSERT(MOUSE_WP_IN_REP_COUNT == 2);
 
+#if CONFIG_HID_HIGH_RES_ENABLED
+#define MOUSE_WP_FEATURE_REP_ID         10  /**< Mouse Wheel/Pan Resolution Multiplier Feature Report ID. */
+#define MOUSE_WP_FEATURE_REP_SIZE       4   /**< Size of a single field (multiplier and padding) in the Mouse Wheel/Pan Feature Report [bits]. */
+#define MOUSE_WP_FEATURE_REP_COUNT      2   /**< Number of fields in the Mouse Wheel/Pan Feature Report. */
+
+// Make sure that the complete Mouse Wheel/Pan Feature Report size is byte aligned.
+STATIC_ASSERT(((MOUSE_WP_FEATURE_REP_SIZE * MOUSE_WP_FEATURE_REP_COUNT) % 8) == 0);
+
+// The Resolution Multiplier is declared with a one-byte Physical Maximum.
+STATIC_ASSERT(CONFIG_HID_WHEEL_RES_MULTIPLIER <= INT8_MAX);
+#endif /* CONFIG_HID_HIGH_RES_ENABLED */
+
 /**@brief Get the ID of a given HID report. */
 #define HID_REPORT_ID(_name)    (_name ## _REP_ID)
 
@@ -256,13 +285,70 @@ __ALIGN(4) static const uint8_t m_coms_hid_desc[] =
     0x85, MOUSE_XY_IN_REP_ID,       //          Report ID (MOUSE_XY_IN_REP_ID)
     0x75, MOUSE_XY_IN_REP_SIZE,     //          Report Size (MOUSE_XY_IN_REP_SIZE)
     0x95, MOUSE_XY_IN_REP_COUNT,    //          Report Count (MOUSE_XY_IN_REP_COUNT)
-    0x16, 0x01, 0xF8,               //          Logical Minimum (-2047)
-    0x26, 0xFF, 0x07,               //          Logical Maximum (2047)
+    0x16, LSB_16(-MOUSE_XY_IN_REP_MAX), MSB_16(-MOUSE_XY_IN_REP_MAX),
+                                    //          Logical Minimum (-MOUSE_XY_IN_REP_MAX)
+    0x26, LSB_16(MOUSE_XY_IN_REP_MAX), MSB_16(MOUSE_XY_IN_REP_MAX),
+                                    //          Logical Maximum (MOUSE_XY_IN_REP_MAX)
     0x05, 0x01,                     //          Usage Page (Generic Desktop)
     0x09, 0x30,                     //          Usage (X)
     0x09, 0x31,                     //          Usage (Y)
     0x81, 0x06,                     //          Input (Data, Var, Rel)
     0xC0,                           //      End Collection
+#if CONFIG_HID_HIGH_RES_ENABLED
+    0xA1, 0x00,                     //      Collection (Physical)
+    0xA1, 0x02,                     //          Collection (Logical)
+    0x85, MOUSE_WP_FEATURE_REP_ID,  //              Report ID (MOUSE_WP_FEATURE_REP_ID)
+    0x05, 0x01,                     //              Usage Page (Generic Desktop)
+    0x09, 0x48,                     //              Usage (Resolution Multiplier)
+    0x15, 0x00,                     //              Logical Minimum (0)
+    0x25, 0x01,                     //              Logical Maximum (1)
+    0x35, 0x01,                     //              Physical Minimum (1)
+    0x45, CONFIG_HID_WHEEL_RES_MULTIPLIER,
+                                    //              Physical Maximum (CONFIG_HID_WHEEL_RES_MULTIPLIER)
+    0x75, 0x02,                     //              Report Size (2)
+    0x95, 0x01,                     //              Report Count (1)
+    0xB1, 0x02,                     //              Feature (Data, Var, Abs)
+    0x75, MOUSE_WP_FEATURE_REP_SIZE - 2,
+                                    //              Report Size (MOUSE_WP_FEATURE_REP_SIZE - 2)
+    0xB1, 0x03,                     //              Feature (Const, Var, Abs)
+    0x35, 0x00,                     //              Physical Minimum (0)
+    0x45, 0x00,                     //              Physical Maximum (0)
+    0x85, MOUSE_WP_IN_REP_ID,       //              Report ID (MOUSE_WP_IN_REP_ID)
+    0x75, MOUSE_WP_IN_REP_SIZE,     //              Report Size (MOUSE_WP_IN_REP_SIZE)
+    0x16, LSB_16(-MOUSE_WP_IN_REP_MAX), MSB_16(-MOUSE_WP_IN_REP_MAX),
+                                    //              Logical Minimum (-MOUSE_WP_IN_REP_MAX)
+    0x26, LSB_16(MOUSE_WP_IN_REP_MAX), MSB_16(MOUSE_WP_IN_REP_MAX),
+                                    //              Logical Maximum (MOUSE_WP_IN_REP_MAX)
+    0x09, 0x38,                     //              Usage (Wheel)
+    0x81, 0x06,                     //              Input (Data, Var, Rel)
+    0xC0,                           //          End Collection
+    0xA1, 0x02,                     //          Collection (Logical)
+    0x85, MOUSE_WP_FEATURE_REP_ID,  //              Report ID (MOUSE_WP_FEATURE_REP_ID)
+    0x09, 0x48,                     //              Usage (Resolution Multiplier)
+    0x15, 0x00,                     //              Logical Minimum (0)
+    0x25, 0x01,                     //              Logical Maximum (1)
+    0x35, 0x01,                     //              Physical Minimum (1)
+    0x45, CONFIG_HID_WHEEL_RES_MULTIPLIER,
+                                    //              Physical Maximum (CONFIG_HID_WHEEL_RES_MULTIPLIER)
+    0x75, 0x02,                     //              Report Size (2)
+    0xB1, 0x02,                     //              Feature (Data, Var, Abs)
+    0x75, MOUSE_WP_FEATURE_REP_SIZE - 2,
+                                    //              Report Size (MOUSE_WP_FEATURE_REP_SIZE - 2)
+    0xB1, 0x03,                     //              Feature (Const, Var, Abs)
+    0x35, 0x00,                     //              Physical Minimum (0)
+    0x45, 0x00,                     //              Physical Maximum (0)
+    0x85, MOUSE_WP_IN_REP_ID,       //              Report ID (MOUSE_WP_IN_REP_ID)
+    0x75, MOUSE_WP_IN_REP_SIZE,     //              Report Size (MOUSE_WP_IN_REP_SIZE)
+    0x16, LSB_16(-MOUSE_WP_IN_REP_MAX), MSB_16(-MOUSE_WP_IN_REP_MAX),
+                                    //              Logical Minimum (-MOUSE_WP_IN_REP_MAX)
+    0x26, LSB_16(MOUSE_WP_IN_REP_MAX), MSB_16(MOUSE_WP_IN_REP_MAX),
+                                    //              Logical Maximum (MOUSE_WP_IN_REP_MAX)
+    0x05, 0x0C,                     //              Usage Page (Consumer Devices)
+    0x0A, 0x38, 0x02,               //              Usage (AC Pan)
+    0x81, 0x06,                     //              Input (Data, Var, Rel)
+    0xC0,                           //          End Collection
+    0xC0,                           //      End Collection
+#else
     0xA1, 0x00,                     //      Collection (Physical)
     0x85, MOUSE_WP_IN_REP_ID,       //          Report ID (MOUSE_WP_IN_REP_ID)
     0x75, MOUSE_WP_IN_REP_SIZE,     //          Report Size (MOUSE_WP_IN_REP_SIZE)
@@ -280,6 +366,7 @@ __ALIGN(4) static const uint8_t m_coms_hid_desc[] =
     0x0A, 0x38, 0x02,               //          Usage (AC Pan)
     0x81, 0x06,                     //          Input (Data, Var, Rel)
     0xC0,                           //      End Collection
+#endif /* CONFIG_HID_HIGH_RES_ENABLED */
     0xC0,                           // End Collection
 };
 
@@ -370,9 +457,20 @@ static uint8_t          m_coms_max_packets_in_fly;  /**< Maximum number of packe
 static uint8_t          m_coms_effective_mtu;       /**< Effective MTU of the connection. */
 static uint8_t          m_coms_audio_srv_bitmsk;    /**< Audio services enabled for transmission. */
 #endif
+#if CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_HID_ENABLED
+static uint32_t         m_coms_audio_hid_frames;    /**< Number of audio frames sent over HID since the service was enabled. */
+static uint32_t         m_coms_audio_hid_air_bytes; /**< Number of bytes these frames occupied on air. */
+#endif
 #if CONFIG_PWR_MGMT_ENABLED
 static bool             m_coms_going_down;          /**< True if module is executing a shutdown procedure. */
 #endif
+#if CONFIG_HID_HIGH_RES_ENABLED
+static uint8_t          m_coms_wheel_divisor;       /**< Wheel motion units per Mouse Wheel/Pan report count. */
+static uint8_t          m_coms_pan_divisor;         /**< Pan motion units per Mouse Wheel/Pan report count. */
+#else
+#define m_coms_wheel_divisor    HID_REL_WHEEL_SCALE
+#define m_coms_pan_divisor      HID_REL_WHEEL_SCALE
+#endif
 
 // ----------------------------------------------------------------------------
 // HID Interface
@@ -403,6 +501,98 @@ enum {
     HID_NUMBER_OF_OUT_REPS    /**< Number of OUT reports.*/
 };
 
+enum {
+#if CONFIG_HID_HIGH_RES_ENABLED
+    HID_MOUSE_WP_FEATURE_REP_IDX,   /**< HID Mouse Wheel/Pan Resolution Multiplier Feature Report Index. */
+#endif
+    HID_NUMBER_OF_FEATURE_REPS      /**< Number of Feature reports.*/
+};
+
+// ----------------------------------------------------------------------------
+// HID report layouts
+// ----------------------------------------------------------------------------
+
+/**@brief Layout of an input report built from the report definitions used in m_coms_hid_desc.
+ *
+ * @details All fields of a report have the same size and are packed LSB first without gaps.
+ *          Array reports list the active usages of a single usage page, one usage ID per field.
+ *          Variable reports carry one value per field.
+ */
+typedef struct
+{
+    uint16_t usage_page;    /**< Usage page listed by an array report. */
+    uint8_t  field_size;    /**< Size of a single field [bits]. */
+    uint8_t  field_count;   /**< Number of fields. */
+    bool     array;         /**< True for an array report, false for a variable report. */
+} m_coms_report_layout_t;
+
+/**@brief Define the layout of a given HID input report. */
+#define HID_REPORT_LAYOUT(_name, _usage_page, _array)   \
+    [HID_REPORT_IDX(_name)] = {                         \
+        .usage_page  = (_usage_page),                   \
+        .field_size  = _name ## _REP_SIZE,              \
+        .field_count = _name ## _REP_COUNT,             \
+        .array       = (_array),                        \
+    }
+
+/**@brief Maximum number of fields in a packed input report. */
+#define HID_MAX_REPORT_FIELD_COUNT  MAX(MAX(KEYBOARD_IN_REP_COUNT, CONSUMER_CTRL_IN_REP_COUNT),   \
+                                        MAX(MOUSE_BTN_IN_REP_COUNT,                               \
+                                            MAX(MOUSE_XY_IN_REP_COUNT, MOUSE_WP_IN_REP_COUNT)))
+
+// Fields are packed through a 32-bit window.
+STATIC_ASSERT(MAX(MAX(KEYBOARD_IN_REP_SIZE, CONSUMER_CTRL_IN_REP_SIZE),
+                  MAX(MOUSE_BTN_IN_REP_SIZE, MAX(MOUSE_XY_IN_REP_SIZE, MOUSE_WP_IN_REP_SIZE))) <= 16);
+
+static const m_coms_report_layout_t m_coms_report_layouts[HID_NUMBER_OF_IN_REPS] =
+{
+    HID_REPORT_LAYOUT(KEYBOARD_IN,      0x07, true),
+    HID_REPORT_LAYOUT(CONSUMER_CTRL_IN, 0x0C, true),
+    HID_REPORT_LAYOUT(MOUSE_BTN_IN,     0x09, false),
+    HID_REPORT_LAYOUT(MOUSE_XY_IN,      0x01, false),
+    HID_REPORT_LAYOUT(MOUSE_WP_IN,      0x01, false),
+};
+
+/**@brief Pack field values into a report.
+ *
+ * @param[in]  report_idx   Report index.
+ * @param[out] p_report     Report buffer.
+ * @param[in]  p_fields     Field values. Values are truncated to the field size.
+ *
+ * @return Report size in bytes.
+ */
+static size_t m_coms_report_pack(uint8_t report_idx, uint8_t *p_report, int16_t const *p_fields)
+{
+    m_coms_report_layout_t const *p_layout;
+    uint32_t mask;
+    uint32_t value;
+    size_t   offset;
+    size_t   size;
+    size_t   i;
+    size_t   j;
+
+    ASSERT(report_idx < ARRAY_SIZE(m_coms_report_layouts));
+    p_layout = &m_coms_report_layouts[report_idx];
+    ASSERT(p_layout->field_count != 0);
+
+    mask = (1UL << p_layout->field_size) - 1;
+    size = (p_layout->field_size * p_layout->field_count) / 8;
+
+    memset(p_report, 0, size);
+
+    for (i = 0, offset = 0; i < p_layout->field_count; i++, offset += p_layout->field_size)
+    {
+        value = ((uint32_t)p_fields[i] & mask) << (offset & 0x07);
+
+        for (j = 0; j < (((offset & 0x07) + p_layout->field_size + 7) / 8); j++)
+        {
+            p_report[(offset / 8) + j] |= (uint8_t)(value >> (8 * j));
+        }
+    }
+
+    return size;
+}
+
 // ----------------------------------------------------------------------------
 // HID report pools and queues
 // ----------------------------------------------------------------------------
@@ -434,6 +624,10 @@ typedef struct
             uint8_t  report_idx;                 /**< HID Report index. */
             uint16_t max_packet_size;            /**< Maximum packet size. */
         } hid;
+        struct
+        {
+            uint16_t conn_handle;                /**< Connection handle of the ATVV peer. */
+        } atvv;
     } service_params;
 
     m_coms_service_type_t type;                  /**< Type of data. */
@@ -453,18 +647,46 @@ NRF_QUEUE_DEF(m_coms_data_desc_t *,
               m_coms_audio_hid_channel_backlog,
               (CONFIG_AUDIO_FRAME_POOL_SIZE - 1),
               NRF_QUEUE_MODE_NO_OVERFLOW);
+
+/**@brief Overhead of one audio notification on air [bytes].
+ *
+ * @details ATT header (3), L2CAP header (4), LL header (2), MIC (4), preamble, access address and CRC (8).
+ *          Assumes that a notification fits into a single LL packet, which holds when Data Length Extension
+ *          covers the ATT MTU.
+ */
+#define AUDIO_HID_AIR_OVERHEAD          21
+
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+/*
+ * In packing mode, every audio report is a sequence of chunks. Each chunk starts with a one-byte header
+ * which holds the chunk length and a flag telling whether the frame continues in the next chunk.
+ * A report which is not completely filled with chunks ends with a zero header, so a decoder never reads
+ * past the data written for this report.
+ */
+#define AUDIO_HID_CHUNK_LEN_MASK        0x7F    /**< Chunk header: length of the chunk payload. */
+#define AUDIO_HID_CHUNK_MORE_FLAG       0x80    /**< Chunk header: the frame continues in the next chunk. */
+
+static uint8_t          m_coms_audio_hid_packet[HID_REPORT_SIZE(AUDIO_IN)]; /**< Audio report being assembled. */
+static uint16_t         m_coms_audio_hid_packet_size;                       /**< Size of the assembled report, zero if empty. */
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
 #endif /* CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_HID_ENABLED */
 
 #if CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_ATVV_ENABLED
 static m_coms_channel_t m_coms_audio_atvv_channel; /**< Audio channel (ATVV service) */
 
-/**@brief Backlog queue for audio channel. */
+/**@brief Backlog queue for audio channel. Every streaming peer has its own descriptor for each frame. */
 NRF_QUEUE_DEF(m_coms_data_desc_t *,
               m_coms_audio_atvv_channel_backlog,
-              (CONFIG_AUDIO_FRAME_POOL_SIZE - 1),
+              ((CONFIG_AUDIO_FRAME_POOL_SIZE - 1) * CONFIG_AUDIO_ATVV_PEER_NUM),
               NRF_QUEUE_MODE_NO_OVERFLOW);
+
+# define M_COMS_AUDIO_ATVV_DESC_NUM (CONFIG_AUDIO_FRAME_POOL_SIZE * CONFIG_AUDIO_ATVV_PEER_NUM)
 #endif /* CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_ATVV_ENABLED */
 
+#ifndef M_COMS_AUDIO_ATVV_DESC_NUM
+# define M_COMS_AUDIO_ATVV_DESC_NUM 0
+#endif
+
 static m_coms_channel_t m_coms_keys_channel;       /**< Keys channel. */
 
 /**@brief Backlog queue for keys channel. */
@@ -482,7 +704,22 @@ NRF_BALLOC_DEF(m_coms_report_pool,
 /**@brief Allocator for report descriptors. */
 NRF_BALLOC_DEF(m_coms_data_desc_pool,
                sizeof(m_coms_data_desc_t),
-               (CONFIG_AUDIO_FRAME_POOL_SIZE + CONFIG_HID_REPORT_POOL_SIZE + 1));
+               (CONFIG_AUDIO_FRAME_POOL_SIZE + M_COMS_AUDIO_ATVV_DESC_NUM + CONFIG_HID_REPORT_POOL_SIZE + 1));
+
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+#define M_COMS_REPORT_COALESCE_USAGES_MAX   8   /**< Maximum number of usages whose transitions can be merged into one queued report. */
+
+/**@brief Newest unsent snapshot of a given report in the keys channel. */
+typedef struct
+{
+    m_coms_data_desc_t *p_data_desc;                                /**< Queued report descriptor or NULL if there is none. */
+    uint32_t            usages[M_COMS_REPORT_COALESCE_USAGES_MAX];  /**< Usages which changed state in the queued report. */
+    uint8_t             usage_count;                                /**< Number of entries in the usages array. */
+} m_coms_report_pending_t;
+
+static m_coms_report_pending_t m_coms_report_pending[HID_NUMBER_OF_IN_REPS];
+static uint32_t                m_coms_report_coalesced;     /**< Number of reports merged into queued snapshots. */
+#endif /* CONFIG_HID_REPORT_COALESCING_ENABLED */
 
 static ble_hids_t m_ble_hids_instances[HID_NUMBER_OF_INTERFACES];
 
@@ -556,17 +793,30 @@ static const ble_hid_report_record_t m_reports_out[] = {
         [HID_NUMBER_OF_OUT_REPS] = { 0 }
 };
 
+static const ble_hid_report_record_t m_reports_feature[] = {
+#if CONFIG_HID_HIGH_RES_ENABLED
+        [HID_MOUSE_WP_FEATURE_REP_IDX] = BLE_HID_REPORT_CONF(
+                HID_BASE_INTERFACE_IDX,
+                hid_report_type_feature,
+                false,
+                HID_REPORT_ID(MOUSE_WP_FEATURE),
+                HID_REPORT_SIZE(MOUSE_WP_FEATURE)
+        ),
+#endif
+        [HID_NUMBER_OF_FEATURE_REPS] = { 0 }
+};
+
 // Persistent instance of ble_hid_db
 static const ble_hid_db_t m_ble_hid_db = {
         .report_maps_size = ARRAY_SIZE(m_report_maps),
         .reports_in_size = HID_NUMBER_OF_IN_REPS,
         .reports_out_size = HID_NUMBER_OF_OUT_REPS,
-        .reports_feature_size = 0,
+        .reports_feature_size = HID_NUMBER_OF_FEATURE_REPS,
         .ext_maps_size = 0,
         .report_maps = m_report_maps,
         .reports_in = m_reports_in,
         .reports_out = m_reports_out,
-        .reports_feature = NULL,
+        .reports_feature = m_reports_feature,
         .ext_mappings = NULL
 };
 
@@ -577,6 +827,20 @@ static const ble_hid_db_t m_ble_hid_db = {
 /**@brief Report-freeing function compatible with m_coms_free_func_t. */
 static void m_coms_report_free_func(void *p_report)
 {
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    unsigned int i;
+
+    // The report has been sent or dropped: it cannot absorb further changes.
+    for (i = 0; i < ARRAY_SIZE(m_coms_report_pending); i++)
+    {
+        if ((m_coms_report_pending[i].p_data_desc != NULL) &&
+            (m_coms_report_pending[i].p_data_desc->p_free_func_context == p_report))
+        {
+            m_coms_report_pending[i].p_data_desc = NULL;
+        }
+    }
+#endif /* CONFIG_HID_REPORT_COALESCING_ENABLED */
+
     nrf_balloc_free(&m_coms_report_pool, p_report);
 }
 
@@ -606,6 +870,16 @@ static void m_coms_data_desc_destroy(m_coms_data_desc_t *p_data_desc)
     nrf_balloc_free(&m_coms_data_desc_pool, p_data_desc);
 }
 
+/**@brief Release the current descriptor of a given channel and move to the next one. */
+static void m_coms_channel_next(m_coms_channel_t *p_channel)
+{
+    m_coms_data_desc_destroy(p_channel->p_current_data_desc);
+    if (nrf_queue_pop(p_channel->p_backlog, &(p_channel->p_current_data_desc)) != NRF_SUCCESS)
+    {
+        p_channel->p_current_data_desc = NULL;
+    }
+}
+
 /**@brief Expire packets in a given channel. */
 static void m_coms_channel_drop(m_coms_channel_t *p_channel)
 {
@@ -613,11 +887,7 @@ static void m_coms_channel_drop(m_coms_channel_t *p_channel)
 
     NRF_LOG_WARNING("Packet lost!");
 
-    m_coms_data_desc_destroy(p_channel->p_current_data_desc);
-    if (nrf_queue_pop(p_channel->p_backlog, &(p_channel->p_current_data_desc)) != NRF_SUCCESS)
-    {
-        p_channel->p_current_data_desc = NULL;
-    }
+    m_coms_channel_next(p_channel);
 }
 
 /**@brief Enqueue data in the channel. */
@@ -646,6 +916,34 @@ static ret_code_t m_coms_channel_enqueue(m_coms_channel_t *p_channel,
     return status;
 }
 
+/**@brief Translate the result of a HID report transmission into the data processing status. */
+static ret_code_t m_coms_hid_send_status(ret_code_t err_code, m_coms_data_process_status_t * p_status)
+{
+    switch (err_code)
+    {
+        case NRF_SUCCESS:
+            *p_status = M_COMS_STATUS_SUCCESS;
+            return NRF_SUCCESS;
+
+        case BLE_ERROR_GATTS_SYS_ATTR_MISSING:
+            /* Fall through */
+        case NRF_ERROR_INVALID_STATE:
+            /* Fall through */
+        case NRF_ERROR_BUSY:
+            /* Fall through */
+        case NRF_ERROR_FORBIDDEN:
+            *p_status = M_COMS_STATUS_CANNOT_SEND;
+            return NRF_SUCCESS;
+
+        case NRF_ERROR_RESOURCES:
+            *p_status = M_COMS_STATUS_SD_BUFFER_FULL;
+            return NRF_SUCCESS;
+
+        default:
+            return err_code;
+    }
+}
+
 /**@brief Send one packet from a given channel. */
 static ret_code_t m_coms_channel_process(m_coms_channel_t *p_channel, m_coms_data_process_status_t * p_status)
 {
@@ -675,36 +973,22 @@ static ret_code_t m_coms_channel_process(m_coms_channel_t *p_channel, m_coms_dat
                                                   packet_size,
                                                   p_data_desc->service_params.hid.interface_idx,
                                                   p_data_desc->service_params.hid.report_idx);
-            switch (err_code)
+            err_code = m_coms_hid_send_status(err_code, p_status);
+            if ((err_code != NRF_SUCCESS) || (*p_status != M_COMS_STATUS_SUCCESS))
             {
-                case NRF_SUCCESS:
-                    bytes_sent = packet_size;
-                    *p_status  = M_COMS_STATUS_SUCCESS;
-                    break;
-
-                case BLE_ERROR_GATTS_SYS_ATTR_MISSING:
-                    /* Fall through */
-                case NRF_ERROR_INVALID_STATE:
-                    /* Fall through */
-                case NRF_ERROR_BUSY:
-                    /* Fall through */
-                case NRF_ERROR_FORBIDDEN:
-                    *p_status = M_COMS_STATUS_CANNOT_SEND;
-                    return NRF_SUCCESS;
-
-                case NRF_ERROR_RESOURCES:
-                    *p_status = M_COMS_STATUS_SD_BUFFER_FULL;
-                    return NRF_SUCCESS;
-
-                default:
-                    return err_code;
-
+                return err_code;
             }
+
+            bytes_sent = packet_size;
             break;
 
 #if CONFIG_AUDIO_ATVV_ENABLED
         case M_COMS_SERVICE_TYPE_ATVV:
-            err_code = m_coms_ble_atvv_audio_send(p_data_desc->p_data, p_data_desc->data_size, &bytes_sent, p_status);
+            err_code = m_coms_ble_atvv_audio_send(p_data_desc->service_params.atvv.conn_handle,
+                                                  p_data_desc->p_data,
+                                                  p_data_desc->data_size,
+                                                  &bytes_sent,
+                                                  p_status);
             if (err_code != NRF_SUCCESS)
             {
                 return err_code;
@@ -730,21 +1014,101 @@ static ret_code_t m_coms_channel_process(m_coms_channel_t *p_channel, m_coms_dat
 
     if (p_data_desc->data_size == 0)
     {
-        m_coms_data_desc_destroy(p_data_desc);
-        if (nrf_queue_pop(p_channel->p_backlog, &(p_channel->p_current_data_desc)) != NRF_SUCCESS)
-        {
-            p_channel->p_current_data_desc = NULL;
-        }
+        m_coms_channel_next(p_channel);
     }
 
     return NRF_SUCCESS;
 }
 
 #if CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_HID_ENABLED
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+/**@brief Move as much audio data as possible from the channel into the assembled report. */
+static void m_coms_audio_hid_pack(uint16_t max_packet_size)
+{
+    m_coms_channel_t *p_channel = &m_coms_audio_hid_channel;
+
+    while ((p_channel->p_current_data_desc != NULL) &&
+           ((m_coms_audio_hid_packet_size + 1) < max_packet_size))
+    {
+        m_coms_data_desc_t *p_data_desc = p_channel->p_current_data_desc;
+        uint16_t            chunk_size;
+
+        if (p_data_desc->data_size > 0)
+        {
+            chunk_size = MIN(p_data_desc->data_size, max_packet_size - m_coms_audio_hid_packet_size - 1);
+            chunk_size = MIN(chunk_size, AUDIO_HID_CHUNK_LEN_MASK);
+
+            m_coms_audio_hid_packet[m_coms_audio_hid_packet_size++] =
+                chunk_size | ((chunk_size < p_data_desc->data_size) ? AUDIO_HID_CHUNK_MORE_FLAG : 0);
+
+            memcpy(&m_coms_audio_hid_packet[m_coms_audio_hid_packet_size], p_data_desc->p_data, chunk_size);
+            m_coms_audio_hid_packet_size += chunk_size;
+
+            p_data_desc->p_data    += chunk_size;
+            p_data_desc->data_size -= chunk_size;
+        }
+
+        if (p_data_desc->data_size == 0)
+        {
+            m_coms_channel_next(p_channel);
+        }
+    }
+}
+
+/**@brief Discard all audio data waiting for transmission over HID. */
+static void m_coms_audio_hid_flush(void)
+{
+    while (m_coms_audio_hid_channel.p_current_data_desc != NULL)
+    {
+        m_coms_channel_next(&m_coms_audio_hid_channel);
+    }
+
+    m_coms_audio_hid_packet_size = 0;
+}
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
+
 /**@brief Send one packet from an audio stream. */
 static ret_code_t m_coms_process_audio_hid(m_coms_data_process_status_t * p_status)
 {
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+    uint16_t    max_packet_size = MIN(HID_REPORT_SIZE(AUDIO_IN), (m_coms_effective_mtu - 3));
+    uint16_t    packet_size;
+    ret_code_t  err_code;
+
+    m_coms_audio_hid_pack(max_packet_size);
+
+    // Send a partially filled report only if the link is idle. Otherwise wait for the next
+    // transmission completion, which gives the encoder time to add more frames.
+    if ((m_coms_audio_hid_packet_size == 0) ||
+        (((m_coms_audio_hid_packet_size + 1) < max_packet_size) && (m_coms_packets_in_fly != 0)))
+    {
+        *p_status = M_COMS_STATUS_QUEUE_EMPTY;
+        return NRF_SUCCESS;
+    }
+
+    // Terminate a partially filled report. The terminator is not counted in the assembled size,
+    // so more chunks can still overwrite it if the report cannot be sent now.
+    packet_size = m_coms_audio_hid_packet_size;
+    if (packet_size < max_packet_size)
+    {
+        m_coms_audio_hid_packet[packet_size++] = 0;
+    }
+
+    err_code = m_coms_ble_hid_report_send(m_coms_audio_hid_packet,
+                                          packet_size,
+                                          HID_BASE_INTERFACE_IDX,
+                                          HID_REPORT_IDX(AUDIO_IN));
+    err_code = m_coms_hid_send_status(err_code, p_status);
+    if ((err_code == NRF_SUCCESS) && (*p_status == M_COMS_STATUS_SUCCESS))
+    {
+        m_coms_audio_hid_air_bytes  += packet_size + AUDIO_HID_AIR_OVERHEAD;
+        m_coms_audio_hid_packet_size = 0;
+    }
+
+    return err_code;
+#else /* !CONFIG_AUDIO_HID_PACKING_ENABLED */
     return m_coms_channel_process(&m_coms_audio_hid_channel, p_status);
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
 }
 #endif /* CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_HID_ENABLED */
 
@@ -800,9 +1164,10 @@ static ret_code_t m_coms_process_keys(m_coms_data_process_status_t * p_status)
 static ret_code_t m_coms_process_xy_motion(m_coms_data_process_status_t * p_status)
 {
     uint8_t report[HID_REPORT_SIZE(MOUSE_XY_IN)];
+    int16_t fields[MOUSE_XY_IN_REP_COUNT];
     ret_code_t err_code;
-    int16_t x = 0;
-    int16_t y = 0;
+    int32_t x = 0;
+    int32_t y = 0;
     m_protocol_hid_state_item_t *p_x = m_protocol_hid_state_get(HID_USAGE(0x01, 0x30));
     m_protocol_hid_state_item_t *p_y = m_protocol_hid_state_get(HID_USAGE(0x01, 0x31));
 
@@ -816,6 +1181,10 @@ static ret_code_t m_coms_process_xy_motion(m_coms_data_process_status_t * p_stat
         y = p_y->value;
     }
 
+    // Send whole report counts only. The remainder stays accumulated in the HID state.
+    x /= HID_REL_POINTER_SCALE;
+    y /= HID_REL_POINTER_SCALE;
+
     if ((x == 0) && (y == 0))
     {
         // There is nothing to send.
@@ -824,16 +1193,15 @@ static ret_code_t m_coms_process_xy_motion(m_coms_data_process_status_t * p_stat
     }
 
     // Make sure that the reported values are within limits defined in the HID report descriptor.
-    x = MIN(x,  2047);
-    x = MAX(x, -2047);
+    x = MIN(x,  MOUSE_XY_IN_REP_MAX);
+    x = MAX(x, -MOUSE_XY_IN_REP_MAX);
 
-    y = MIN(y,  2047);
-    y = MAX(y, -2047);
+    y = MIN(y,  MOUSE_XY_IN_REP_MAX);
+    y = MAX(y, -MOUSE_XY_IN_REP_MAX);
 
-    STATIC_ASSERT(sizeof(report) == 3);
-    report[0] = x & 0x00FF;
-    report[1] = ((y & 0x000F) << 4) | ((x & 0x0F00) >> 8);
-    report[2] = (y & 0x0FF0) >> 4;
+    fields[0] = x;
+    fields[1] = y;
+    UNUSED_RETURN_VALUE(m_coms_report_pack(HID_REPORT_IDX(MOUSE_XY_IN), report, fields));
 
     err_code = m_coms_ble_hid_report_send(report,
                                         sizeof(report),
@@ -865,12 +1233,12 @@ static ret_code_t m_coms_process_xy_motion(m_coms_data_process_status_t * p_stat
 
     if (p_x)
     {
-        p_x->value -= x;
+        p_x->value -= x * HID_REL_POINTER_SCALE;
     }
 
     if (p_y)
     {
-        p_y->value -= y;
+        p_y->value -= y * HID_REL_POINTER_SCALE;
     }
 
     return NRF_SUCCESS;
@@ -880,9 +1248,10 @@ static ret_code_t m_coms_process_xy_motion(m_coms_data_process_status_t * p_stat
 static ret_code_t m_coms_process_wp_motion(m_coms_data_process_status_t * p_status)
 {
     uint8_t report[HID_REPORT_SIZE(MOUSE_WP_IN)];
+    int16_t fields[MOUSE_WP_IN_REP_COUNT];
     ret_code_t err_code;
-    int16_t w = 0;
-    int16_t p = 0;
+    int32_t w = 0;
+    int32_t p = 0;
     m_protocol_hid_state_item_t * p_w;
     m_protocol_hid_state_item_t * p_p;
 
@@ -899,6 +1268,10 @@ static ret_code_t m_coms_process_wp_motion(m_coms_data_process_status_t * p_stat
         p = p_p->value;
     }
 
+    // Send whole report counts only. The remainder stays accumulated in the HID state.
+    w /= m_coms_wheel_divisor;
+    p /= m_coms_pan_divisor;
+
     if ((w == 0) && (p == 0))
     {
         // There is nothing to send.
@@ -907,15 +1280,15 @@ static ret_code_t m_coms_process_wp_motion(m_coms_data_process_status_t * p_stat
     }
 
     // Make sure that the reported values are within limits defined in the HID report descriptor.
-    w = MIN(w,  127);
-    w = MAX(w, -127);
+    w = MIN(w,  MOUSE_WP_IN_REP_MAX);
+    w = MAX(w, -MOUSE_WP_IN_REP_MAX);
 
-    p = MIN(p,  127);
-    p = MAX(p, -127);
+    p = MIN(p,  MOUSE_WP_IN_REP_MAX);
+    p = MAX(p, -MOUSE_WP_IN_REP_MAX);
 
-    STATIC_ASSERT(sizeof(report) == 2);
-    report[0] = w;
-    report[1] = p;
+    fields[0] = w;
+    fields[1] = p;
+    UNUSED_RETURN_VALUE(m_coms_report_pack(HID_REPORT_IDX(MOUSE_WP_IN), report, fields));
 
     err_code = m_coms_ble_hid_report_send(report,
                                         sizeof(report),
@@ -947,12 +1320,12 @@ static ret_code_t m_coms_process_wp_motion(m_coms_data_process_status_t * p_stat
 
     if (p_w)
     {
-        p_w->value -= w;
+        p_w->value -= w * m_coms_wheel_divisor;
     }
 
     if (p_p)
     {
-        p_p->value -= p;
+        p_p->value -= p * m_coms_pan_divisor;
     }
 
     return NRF_SUCCESS;
@@ -1054,97 +1427,215 @@ static void m_coms_process_data(void)
 // ----------------------------------------------------------------------------
 
 
-/**@brief Create a Keyboard Report from the keyboard state array. */
-static size_t m_coms_create_keyboard_report(uint8_t *p_report)
+/**@brief Get the next active usage listed by an array report.
+ *
+ * @param[in] usage_page    Usage page of the report.
+ * @param[in] p_item        Previous item or NULL to get the first one.
+ */
+static m_protocol_hid_state_item_t const *m_coms_array_report_item_next(uint16_t usage_page,
+                                                                        m_protocol_hid_state_item_t const *p_item)
 {
-    size_t i = 0;
-
-    memset(p_report, 0, HID_REPORT_SIZE(KEYBOARD_IN));
-    m_protocol_hid_state_item_t const *p_item = m_protocol_hid_state_page_it_init(0x07);
+    p_item = (p_item == NULL) ? m_protocol_hid_state_page_it_init(usage_page) :
+                                m_protocol_hid_state_page_it_next(p_item);
 
-    do {
-        if (!p_item || (HID_USAGE_PAGE(p_item->usage) != 0x07))
+    while ((p_item != NULL) && (HID_USAGE_PAGE(p_item->usage) == usage_page))
+    {
+        /* AC Pan value is stored on the same page. Ignore it as this value is handled
+         * by a different function. */
+        if (p_item->usage != HID_USAGE(0x0C, 0x238))
         {
-            break;
+            ASSERT(p_item->value != 0);
+            return p_item;
         }
 
-        ASSERT(p_item->value != 0);
-        p_report[i] = HID_USAGE_ID(p_item->usage);
-        ++i;
         p_item = m_protocol_hid_state_page_it_next(p_item);
-    } while (i < HID_REPORT_SIZE(KEYBOARD_IN));
+    }
 
-    return HID_REPORT_SIZE(KEYBOARD_IN);
+    return NULL;
 }
 
-/**@brief Create a Consumer Control report from the consumer control state array. */
-static size_t m_coms_create_consumer_ctrl_report(uint8_t *p_report)
+/**@brief Create an array report from the state of its usage page. */
+static size_t m_coms_create_array_report(uint8_t report_idx, uint8_t *p_report)
 {
-    size_t i = 0;
+    m_coms_report_layout_t const      *p_layout = &m_coms_report_layouts[report_idx];
+    m_protocol_hid_state_item_t const *p_item   = NULL;
+    int16_t fields[HID_MAX_REPORT_FIELD_COUNT];
+    size_t  i;
 
-    memset(p_report, 0, HID_REPORT_SIZE(CONSUMER_CTRL_IN));
-    m_protocol_hid_state_item_t const *p_item = m_protocol_hid_state_page_it_init(0x0C);
+    ASSERT(p_layout->array);
+    memset(fields, 0, sizeof(fields));
 
-    do {
-        if (!p_item || (HID_USAGE_PAGE(p_item->usage) != 0x0C))
+    for (i = 0; i < p_layout->field_count; i++)
+    {
+        p_item = m_coms_array_report_item_next(p_layout->usage_page, p_item);
+        if (p_item == NULL)
         {
             break;
         }
 
-        /* AC Pan value is stored on the same page. Ignore it as this value is handled
-         * by a different function. */
-        if (p_item->usage != HID_USAGE(0x0C, 0x238))
-        {
-            ASSERT(p_item->value != 0);
-            if ((i & 1) == 0)
-            {
-                p_report[3*i/2 + 0]  = ((HID_USAGE_ID(p_item->usage) >> 0) & 0xFF) << 0;
-                p_report[3*i/2 + 1]  = ((HID_USAGE_ID(p_item->usage) >> 8) & 0x0F) << 0;
-            }
-            else
-            {
-                p_report[3*i/2 + 0] |= ((HID_USAGE_ID(p_item->usage) >> 0) & 0x0F) << 4;
-                p_report[3*i/2 + 1]  = ((HID_USAGE_ID(p_item->usage) >> 4) & 0xFF) << 0;
-            }
-        }
+        fields[i] = HID_USAGE_ID(p_item->usage);
+    }
 
-        ++i;
-        p_item = m_protocol_hid_state_page_it_next(p_item);
-    } while (i < HID_REPORT_SIZE(CONSUMER_CTRL_IN));
+    return m_coms_report_pack(report_idx, p_report, fields);
+}
+
+/**@brief Create a Keyboard Report from the keyboard state array. */
+static size_t m_coms_create_keyboard_report(uint8_t *p_report)
+{
+    return m_coms_create_array_report(HID_REPORT_IDX(KEYBOARD_IN), p_report);
+}
 
-    return HID_REPORT_SIZE(CONSUMER_CTRL_IN);
+/**@brief Create a Consumer Control report from the consumer control state array. */
+static size_t m_coms_create_consumer_ctrl_report(uint8_t *p_report)
+{
+    return m_coms_create_array_report(HID_REPORT_IDX(CONSUMER_CTRL_IN), p_report);
 }
 
 /**@brief Create a Mouse Button report from the mouse button state array. */
 static size_t m_coms_create_mouse_btn_report(uint8_t *p_report)
 {
-    size_t i = 0;
+    m_protocol_hid_state_item_t const *p_item = m_protocol_hid_state_page_it_init(0x09);
+    int16_t fields[MOUSE_BTN_IN_REP_COUNT];
 
-    memset(p_report, 0, HID_REPORT_SIZE(MOUSE_BTN_IN));
+    memset(fields, 0, sizeof(fields));
 
-    m_protocol_hid_state_item_t const *p_item = m_protocol_hid_state_page_it_init(0x09);
-    do {
-        if (!p_item || (HID_USAGE_PAGE(p_item->usage) != 0x09))
+    while ((p_item != NULL) && (HID_USAGE_PAGE(p_item->usage) == 0x09))
+    {
+        size_t key = HID_USAGE_ID(p_item->usage) - 1;
+
+        ASSERT(p_item->value != 0);
+        ASSERT(key < ARRAY_SIZE(fields));
+        fields[key] = 1;
+
+        p_item = m_protocol_hid_state_page_it_next(p_item);
+    }
+
+    return m_coms_report_pack(HID_REPORT_IDX(MOUSE_BTN_IN), p_report, fields);
+}
+
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+/**@brief Check if a report may not be able to show all active usages of its page.
+ *
+ * @details An array report with all fields in use can hide or reveal a usage which did not
+ *          change state, so it is never coalesced.
+ */
+static bool m_coms_report_saturated(uint8_t report_idx)
+{
+    m_coms_report_layout_t const      *p_layout = &m_coms_report_layouts[report_idx];
+    m_protocol_hid_state_item_t const *p_item   = NULL;
+    size_t count;
+
+    if (!p_layout->array)
+    {
+        // Every usage has its own field.
+        return false;
+    }
+
+    for (count = 0; count < p_layout->field_count; count++)
+    {
+        p_item = m_coms_array_report_item_next(p_layout->usage_page, p_item);
+        if (p_item == NULL)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**@brief Merge a state change into the queued, unsent snapshot of the same report.
+ *
+ * @details Each call corresponds to a single usage transition. The transition can be merged
+ *          if the queued snapshot does not already carry a transition of the same usage, so the
+ *          host still observes every press and release of every usage in order. Transitions
+ *          of different usages may end up in the same report.
+ *
+ * @param[in] report_idx            Report index.
+ * @param[in] usage                 Usage which changed state.
+ * @param[in] create_report_func    Report creation function.
+ * @param[in] force                 Merge even if a transition of the same usage gets lost.
+ *
+ * @return True if the change has been merged, false if a new report has to be queued.
+ */
+static bool m_coms_report_coalesce(uint8_t report_idx,
+                                   uint32_t usage,
+                                   size_t (*create_report_func)(uint8_t *p_report),
+                                   bool force)
+{
+    m_coms_report_pending_t *p_pending;
+    unsigned int i;
+
+    ASSERT(report_idx < ARRAY_SIZE(m_coms_report_pending));
+    p_pending = &m_coms_report_pending[report_idx];
+
+    if (p_pending->p_data_desc == NULL)
+    {
+        return false;
+    }
+
+    if (!force && m_coms_report_saturated(report_idx))
+    {
+        return false;
+    }
+
+    for (i = 0; i < p_pending->usage_count; i++)
+    {
+        if (p_pending->usages[i] == usage)
         {
             break;
         }
+    }
 
-        size_t key = HID_USAGE_ID(p_item->usage) - 1;
+    if (i == p_pending->usage_count)
+    {
+        if (i < ARRAY_SIZE(p_pending->usages))
+        {
+            p_pending->usages[p_pending->usage_count++] = usage;
+        }
+        else if (!force)
+        {
+            return false;
+        }
+    }
+    else if (!force)
+    {
+        return false;
+    }
 
-        ASSERT(p_item->value != 0);
-        ASSERT(key < 8);
-        p_report[key >> 3] |= 1 << (key & 0x07);
+    // Reports are sent in one packet, so an unsent snapshot is still complete and can be rebuilt.
+    ASSERT(p_pending->p_data_desc->p_data == p_pending->p_data_desc->p_free_func_context);
+    UNUSED_RETURN_VALUE(create_report_func(p_pending->p_data_desc->p_data));
+    m_coms_report_coalesced += 1;
 
-        ++i;
-        p_item = m_protocol_hid_state_page_it_next(p_item);
-    } while (i < HID_REPORT_SIZE(MOUSE_BTN_IN));
+    return true;
+}
+
+/**@brief Make room in a full keys channel.
+ *
+ * @details Drops the oldest report which is followed by a newer report with the same index,
+ *          so the host is never left with a usage which is no longer active.
+ */
+static void m_coms_report_drop_superseded(m_coms_channel_t *p_channel)
+{
+    m_coms_data_desc_t *p_data_desc = p_channel->p_current_data_desc;
+    uint8_t             report_idx  = p_data_desc->service_params.hid.report_idx;
 
-    return HID_REPORT_SIZE(MOUSE_BTN_IN);
+    if (m_coms_report_pending[report_idx].p_data_desc != p_data_desc)
+    {
+        m_coms_channel_drop(p_channel);
+    }
+    else if (nrf_queue_pop(p_channel->p_backlog, &p_data_desc) == NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("Packet lost!");
+        m_coms_data_desc_destroy(p_data_desc);
+    }
 }
+#endif /* CONFIG_HID_REPORT_COALESCING_ENABLED */
 
 /**@brief Enqueue a Keys report. */
 static ret_code_t m_coms_enqueue_report(m_coms_channel_t *p_channel,
                                         uint8_t report_idx,
+                                        uint32_t usage,
                                         size_t (*create_report_func)(uint8_t *p_report))
 {
     m_coms_data_desc_t *p_data_desc;
@@ -1154,6 +1645,27 @@ static ret_code_t m_coms_enqueue_report(m_coms_channel_t *p_channel,
 
     ASSERT(p_channel != NULL);
 
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    if (m_coms_report_coalesce(report_idx, usage, create_report_func, false))
+    {
+        return NRF_SUCCESS;
+    }
+
+    if ((p_channel->p_current_data_desc != NULL) && nrf_queue_is_full(p_channel->p_backlog))
+    {
+        // Out of queue space: let the latest state win instead of dropping the oldest report.
+        if (m_coms_report_coalesce(report_idx, usage, create_report_func, true))
+        {
+            NRF_LOG_WARNING("Report transitions merged!");
+            return NRF_SUCCESS;
+        }
+
+        m_coms_report_drop_superseded(p_channel);
+    }
+#else
+    UNUSED_PARAMETER(usage);
+#endif /* CONFIG_HID_REPORT_COALESCING_ENABLED */
+
     // Allocate report buffer.
     p_report_buff = nrf_balloc_alloc(&m_coms_report_pool);
     if (p_report_buff == NULL)
@@ -1191,6 +1703,20 @@ static ret_code_t m_coms_enqueue_report(m_coms_channel_t *p_channel,
     {
         m_coms_data_desc_destroy(p_data_desc);
     }
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    else
+    {
+        m_coms_report_pending[report_idx].p_data_desc = p_data_desc;
+        m_coms_report_pending[report_idx].usages[0]   = usage;
+        m_coms_report_pending[report_idx].usage_count = 1;
+
+        if (m_coms_report_saturated(report_idx))
+        {
+            // The transitions carried by this report are not known exactly: do not extend it.
+            m_coms_report_pending[report_idx].usage_count = M_COMS_REPORT_COALESCE_USAGES_MAX;
+        }
+    }
+#endif /* CONFIG_HID_REPORT_COALESCING_ENABLED */
 
     return status;
 }
@@ -1210,9 +1736,49 @@ static void m_coms_hid_boot_mode_callback(m_coms_hid_boot_pkt_t *      p_boot_pk
     APP_ERROR_CHECK_BOOL(false);
 }
 
-/**@brief Utility function for handling the received data (output reports). */
+#if CONFIG_HID_HIGH_RES_ENABLED
+/**@brief Apply the Resolution Multiplier settings of the Mouse Wheel/Pan Feature Report.
+ *
+ * @param[in] feature   Feature report value. Zero disables both multipliers.
+ */
+static void m_coms_res_multiplier_set(uint8_t feature)
+{
+    m_coms_wheel_divisor = ((feature >> 0) & 0x03) ? 1 : HID_REL_WHEEL_SCALE;
+    m_coms_pan_divisor   = ((feature >> MOUSE_WP_FEATURE_REP_SIZE) & 0x03) ? 1 : HID_REL_WHEEL_SCALE;
+
+    NRF_LOG_INFO("Resolution Multiplier: wheel x%u, pan x%u",
+                 HID_REL_WHEEL_SCALE / m_coms_wheel_divisor,
+                 HID_REL_WHEEL_SCALE / m_coms_pan_divisor);
+}
+
+/**@brief Restore the default Resolution Multiplier settings for a new connection. */
+static void m_coms_res_multiplier_reset(void)
+{
+    uint8_t feature[HID_REPORT_SIZE(MOUSE_WP_FEATURE)];
+
+    memset(feature, 0, sizeof(feature));
+    m_coms_res_multiplier_set(feature[0]);
+
+    UNUSED_RETURN_VALUE(m_coms_ble_hid_feature_report_set(HID_BASE_INTERFACE_IDX,
+                                                          HID_REPORT_IDX(MOUSE_WP_FEATURE),
+                                                          feature,
+                                                          sizeof(feature)));
+}
+#endif /* CONFIG_HID_HIGH_RES_ENABLED */
+
+/**@brief Utility function for handling the received data (output and feature reports). */
 static void m_coms_handle_rx(m_coms_ble_evt_t *p_evt)
 {
+#if CONFIG_HID_HIGH_RES_ENABLED
+    if ((p_evt->data.data_received.report_type == BLE_HIDS_REP_TYPE_FEATURE) &&
+        (p_evt->data.data_received.report_idx == HID_REPORT_IDX(MOUSE_WP_FEATURE)) &&
+        (p_evt->data.data_received.len == HID_REPORT_SIZE(MOUSE_WP_FEATURE)))
+    {
+        m_coms_res_multiplier_set(p_evt->data.data_received.data[0]);
+        return;
+    }
+#endif
+
     if (p_evt->data.data_received.report_type != BLE_HIDS_REP_TYPE_OUTPUT)
     {
         return;
@@ -1249,6 +1815,9 @@ static void m_coms_ble_evt_handler(void *p_event_data, uint16_t event_size)
 #if CONFIG_AUDIO_ENABLED
             m_coms_effective_mtu    = BLE_GATT_ATT_MTU_DEFAULT;
 #endif
+#if CONFIG_HID_HIGH_RES_ENABLED
+            m_coms_res_multiplier_reset();
+#endif
 
             APP_ERROR_CHECK(event_send(EVT_BT_CONN_STATE,
                                        BT_CONN_STATE_CONNECTED,
@@ -1436,6 +2005,9 @@ ret_code_t m_coms_init(bool delete_bonds)
 #if CONFIG_AUDIO_HID_ENABLED
     memset(&m_coms_audio_hid_channel, 0, sizeof(m_coms_audio_hid_channel));
     m_coms_audio_hid_channel.p_backlog = &m_coms_audio_hid_channel_backlog;
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+    m_coms_audio_hid_packet_size       = 0;
+#endif
 #endif /* CONFIG_AUDIO_HID_ENABLED */
 #if CONFIG_AUDIO_ATVV_ENABLED
     memset(&m_coms_audio_atvv_channel, 0, sizeof(m_coms_audio_atvv_channel));
@@ -1445,6 +2017,10 @@ ret_code_t m_coms_init(bool delete_bonds)
 
     memset(&m_coms_keys_channel, 0, sizeof(m_coms_keys_channel));
     m_coms_keys_channel.p_backlog = &m_coms_keys_channel_backlog;
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    memset(m_coms_report_pending, 0, sizeof(m_coms_report_pending));
+    m_coms_report_coalesced = 0;
+#endif
 
     status = nrf_balloc_init(&m_coms_report_pool);
     if (status != NRF_SUCCESS)
@@ -1492,6 +2068,7 @@ static ret_code_t m_coms_send_hid_report(uint32_t usage, int16_t report)
         case 0x07: // Keyboard
             status = m_coms_enqueue_report(&m_coms_keys_channel,
                                            HID_REPORT_IDX(KEYBOARD_IN),
+                                           usage,
                                            m_coms_create_keyboard_report);
             break;
 
@@ -1503,6 +2080,7 @@ static ret_code_t m_coms_send_hid_report(uint32_t usage, int16_t report)
 
             status = m_coms_enqueue_report(&m_coms_keys_channel,
                                            HID_REPORT_IDX(MOUSE_BTN_IN),
+                                           usage,
                                            m_coms_create_mouse_btn_report);
             break;
 
@@ -1515,6 +2093,7 @@ static ret_code_t m_coms_send_hid_report(uint32_t usage, int16_t report)
 
             status = m_coms_enqueue_report(&m_coms_keys_channel,
                                            HID_REPORT_IDX(CONSUMER_CTRL_IN),
+                                           usage,
                                            m_coms_create_consumer_ctrl_report);
             break;
 
@@ -1549,6 +2128,12 @@ bool m_coms_event_handler(const event_t *p_event)
             break;
 #endif
 
+#if CONFIG_CONN_POLICY_ENABLED
+        case EVT_SYSTEM_GYRO_STATE:
+            status = m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, p_event->system.data);
+            break;
+#endif
+
         default:
             /* Ignore */
             break;
@@ -1560,16 +2145,56 @@ bool m_coms_event_handler(const event_t *p_event)
 }
 
 #if CONFIG_AUDIO_ENABLED
+#if CONFIG_CONN_POLICY_ENABLED
+/**@brief Get the connection policy traffic type that corresponds to the given audio service. */
+static m_coms_ble_traffic_t m_coms_audio_service_traffic(m_coms_audio_service_t service)
+{
+    return (service == M_COMS_AUDIO_SERVICE_ATVV) ? M_COMS_BLE_TRAFFIC_ATVV_VOICE : M_COMS_BLE_TRAFFIC_HID_VOICE;
+}
+#endif
+
 void m_coms_audio_service_enable(m_coms_audio_service_t service)
 {
     ASSERT((m_coms_audio_srv_bitmsk & service) == 0);
     m_coms_audio_srv_bitmsk |= service;
+
+#if CONFIG_AUDIO_HID_ENABLED
+    if (service == M_COMS_AUDIO_SERVICE_HID)
+    {
+# if CONFIG_AUDIO_HID_PACKING_ENABLED
+        // Chunks left from the previous stream would corrupt the framing of the new one.
+        m_coms_audio_hid_flush();
+# endif
+        m_coms_audio_hid_frames     = 0;
+        m_coms_audio_hid_air_bytes  = 0;
+    }
+#endif /* CONFIG_AUDIO_HID_ENABLED */
+
+#if CONFIG_CONN_POLICY_ENABLED
+    APP_ERROR_CHECK(m_coms_ble_conn_policy_traffic_set(m_coms_audio_service_traffic(service), true));
+#endif
 }
 
 void m_coms_audio_service_disable(m_coms_audio_service_t service)
 {
     ASSERT((m_coms_audio_srv_bitmsk & service) != 0);
     m_coms_audio_srv_bitmsk &= ~service;
+
+#if CONFIG_AUDIO_HID_ENABLED
+    if ((service == M_COMS_AUDIO_SERVICE_HID) && (m_coms_audio_hid_frames > 0))
+    {
+        uint32_t speech_ms = (uint32_t)(((uint64_t)m_coms_audio_hid_frames * CONFIG_AUDIO_FRAME_SIZE_SAMPLES * 1000) /
+                                        CONFIG_AUDIO_SAMPLING_FREQUENCY);
+
+        NRF_LOG_INFO("HID voice: %u frames, %u bytes on air per second of speech",
+                     m_coms_audio_hid_frames,
+                     (uint32_t)(((uint64_t)m_coms_audio_hid_air_bytes * 1000) / MAX(speech_ms, 1)));
+    }
+#endif /* CONFIG_AUDIO_HID_ENABLED */
+
+#if CONFIG_CONN_POLICY_ENABLED
+    APP_ERROR_CHECK(m_coms_ble_conn_policy_traffic_set(m_coms_audio_service_traffic(service), false));
+#endif
 }
 
 /**@brief Audio frame freeing function compatible with m_coms_free_func_t. */
@@ -1618,6 +2243,13 @@ ret_code_t m_coms_send_audio(m_audio_frame_t *p_audio_frame)
         }
         else
         {
+            m_coms_audio_hid_frames += 1;
+#if !CONFIG_AUDIO_HID_PACKING_ENABLED
+            // Each frame is fragmented into separate notifications.
+            m_coms_audio_hid_air_bytes += p_audio_frame->data_size +
+                                          AUDIO_HID_AIR_OVERHEAD * CEIL_DIV(p_audio_frame->data_size,
+                                                                            p_data_desc->service_params.hid.max_packet_size);
+#endif
             trigger_processing = true;
         }
     }
@@ -1626,32 +2258,54 @@ ret_code_t m_coms_send_audio(m_audio_frame_t *p_audio_frame)
 #if CONFIG_AUDIO_ATVV_ENABLED
     if (m_coms_audio_srv_bitmsk & M_COMS_AUDIO_SERVICE_ATVV)
     {
-        m_coms_data_desc_t *p_data_desc;
+        uint16_t   conn_handles[CONFIG_AUDIO_ATVV_PEER_NUM];
+        size_t     peer_count;
+        ret_code_t atvv_status;
 
-        // Allocate report descriptor.
-        p_data_desc = m_coms_data_desc_create();
-        if (p_data_desc == NULL)
+        // The frame is shared by all streaming peers. Each peer gets its own descriptor.
+        // If no peer has opened the microphone, the frame is not needed.
+        peer_count  = m_coms_ble_atvv_audio_peers_get(conn_handles, ARRAY_SIZE(conn_handles));
+        atvv_status = NRF_SUCCESS;
+
+        for (size_t i = 0; i < peer_count; i++)
         {
-            return NRF_ERROR_NO_MEM;
-        }
+            m_coms_data_desc_t *p_data_desc;
+            ret_code_t          peer_status;
 
-        // Fill in report descriptor.
-        p_data_desc->type                 = M_COMS_SERVICE_TYPE_ATVV;
-        p_data_desc->p_data               = p_audio_frame->data;
-        p_data_desc->data_size            = p_audio_frame->data_size;
+            // Allocate report descriptor. The peers served so far keep their descriptors.
+            p_data_desc = m_coms_data_desc_create();
+            if (p_data_desc == NULL)
+            {
+                atvv_status = NRF_ERROR_NO_MEM;
+                break;
+            }
 
-        p_data_desc->free_func            = m_coms_audio_frame_free_func;
-        p_data_desc->p_free_func_context  = m_audio_frame_get(p_audio_frame);
+            // Fill in report descriptor.
+            p_data_desc->type                            = M_COMS_SERVICE_TYPE_ATVV;
+            p_data_desc->p_data                          = p_audio_frame->data;
+            p_data_desc->data_size                       = p_audio_frame->data_size;
+            p_data_desc->service_params.atvv.conn_handle = conn_handles[i];
 
-        // Append descriptor to the channel queue.
-        status = m_coms_channel_enqueue(&m_coms_audio_atvv_channel, p_data_desc);
-        if (status != NRF_SUCCESS)
-        {
-            m_coms_data_desc_destroy(p_data_desc);
+            p_data_desc->free_func                       = m_coms_audio_frame_free_func;
+            p_data_desc->p_free_func_context             = m_audio_frame_get(p_audio_frame);
+
+            // Append descriptor to the channel queue.
+            peer_status = m_coms_channel_enqueue(&m_coms_audio_atvv_channel, p_data_desc);
+            if (peer_status != NRF_SUCCESS)
+            {
+                m_coms_data_desc_destroy(p_data_desc);
+                atvv_status = peer_status;
+            }
+            else
+            {
+                trigger_processing = true;
+            }
         }
-        else
+
+        // Report the failure even if the frame has been queued for some of the peers.
+        if ((atvv_status != NRF_SUCCESS) || (status == NRF_ERROR_INVALID_STATE))
         {
-            trigger_processing = true;
+            status = atvv_status;
         }
     }
 #endif /* CONFIG_AUDIO_ATVV_ENABLED */
@@ -1705,6 +2359,10 @@ static bool m_coms_log_statistics(nrf_pwr_mgmt_evt_t event)
     NRF_LOG_INFO("Maximum Keys Packets queue usage: %d entries",
               nrf_queue_max_utilization_get(m_coms_keys_channel.p_backlog));
 
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    NRF_LOG_INFO("Coalesced HID Reports: %u", m_coms_report_coalesced);
+#endif
+
     NRF_LOG_INFO("Maximum SoftDevice queue usage: %d entries",
               m_coms_max_packets_in_fly);
 
@@ -60,6 +60,7 @@
 #include "m_coms_ble_addr.h"
 #include "m_coms_ble_adv.h"
 #include "m_coms_ble_atvv.h"
+#include "m_coms_ble_conn_policy.h"
 #include "m_coms_ble_dfu.h"
 #include "m_coms_ble_hid.h"
 #include "m_coms_ble_lesc.h"
@@ -1370,6 +1371,15 @@ ret_code_t m_coms_ble_init(const m_coms_ble_params_t * p_ble_params,
         return status;
     }
 
+#if CONFIG_CONN_POLICY_ENABLED
+    // Initializing traffic-dependent connection parameter selection
+    status = m_coms_ble_conn_policy_init(&sp_ble_params->conn_params);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+#endif
+
     // Initializing Advertising.
     status = m_coms_ble_adv_init(sp_ble_params);
     if (status != NRF_SUCCESS)
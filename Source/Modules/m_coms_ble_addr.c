@@ -66,6 +66,11 @@ typedef struct
 {
     pm_peer_id_t    id;
     uint32_t        rank;
+    ble_gap_addr_t  peer_addr;      /**< Peer identity address. */
+#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
+    ble_gap_addr_t  local_addr;     /**< Local address used with the peer. */
+#endif
+    bool            valid;          /**< True if all peer data used by the application is present. */
 } m_coms_ble_addr_peer_t;
 
 /**@brief Application data attached to peer. */
@@ -80,14 +85,181 @@ STATIC_ASSERT((sizeof(m_coms_ble_addr_app_data_t) % sizeof(uint32_t)) == 0);
 
 typedef struct
 {
+    pm_peer_id_t                peer_id;
     pm_store_token_t            token;
     m_coms_ble_addr_app_data_t  app_data;
 } m_coms_ble_addr_app_data_buffer_t;
 
-#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
+/**@brief Summary of the peer database kept in RAM, sorted by rank (the least recently used peer first). */
+static m_coms_ble_addr_peer_t               s_peers[CONFIG_MAX_BONDS];
+static unsigned int                         s_peers_num;
+static bool                                 s_peers_overflow;
 
+#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
 /**@brief Data buffer holding application data during flash operations. */
 static m_coms_ble_addr_app_data_buffer_t    s_app_data_buffer[MAX_SIMULTANEOUS_CONTEXT_WRITES];
+#endif
+
+/**@brief Load the summary of the given peer from flash. */
+static void m_coms_ble_addr_peer_load(m_coms_ble_addr_peer_t *p_peer)
+{
+    pm_peer_data_bonding_t bonding_data;
+
+    p_peer->rank  = 0;
+    p_peer->valid = true;
+
+#if CONFIG_BLE_PEER_RANK_ENABLED
+    uint16_t rank_len = sizeof(p_peer->rank);
+
+    if ((pm_peer_data_load(p_peer->id, PM_PEER_DATA_ID_PEER_RANK, &p_peer->rank, &rank_len) != NRF_SUCCESS) ||
+        (rank_len != sizeof(p_peer->rank)))
+    {
+        p_peer->valid = false;
+    }
+#endif /* CONFIG_BLE_PEER_RANK_ENABLED */
+
+#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
+    m_coms_ble_addr_app_data_t app_data;
+    uint16_t app_data_len = sizeof(app_data);
+
+    if ((pm_peer_data_app_data_load(p_peer->id, (uint8_t *)&app_data, &app_data_len) != NRF_SUCCESS) ||
+        (app_data_len != sizeof(app_data)))
+    {
+        p_peer->valid = false;
+    }
+    else
+    {
+        p_peer->local_addr = app_data.ble_addr;
+    }
+#endif /* CONFIG_BLE_DYNAMIC_ADDR_ENABLED */
+
+    if (pm_peer_data_bonding_load(p_peer->id, &bonding_data) != NRF_SUCCESS)
+    {
+        p_peer->valid = false;
+    }
+    else
+    {
+        p_peer->peer_addr = bonding_data.peer_ble_id.id_addr_info;
+    }
+}
+
+/**@brief Sort cached peers by rank. */
+static void m_coms_ble_addr_peers_sort(void)
+{
+    /*
+     * There are only a few elements on the list,
+     * so use a simple algorithm with small footprint.
+     * Peers of equal rank are ordered by ID, like Peer Manager lists them.
+     */
+    for (size_t k = 0; k < s_peers_num; k++)
+    {
+        size_t id = k;
+        for (size_t l = k + 1; l < s_peers_num; l++)
+        {
+            if ((s_peers[l].rank < s_peers[id].rank) ||
+                ((s_peers[l].rank == s_peers[id].rank) && (s_peers[l].id < s_peers[id].id)))
+            {
+                id = l;
+            }
+        }
+        if (id != k)
+        {
+            m_coms_ble_addr_peer_t tmp = s_peers[k];
+            s_peers[k]  = s_peers[id];
+            s_peers[id] = tmp;
+        }
+    }
+
+#if CONFIG_BLE_PEER_RANK_ENABLED
+    NRF_LOG_DEBUG("Peer Ranks:");
+    for (size_t i = 0; i < s_peers_num; i++)
+    {
+        NRF_LOG_DEBUG("\t- Peer %d Rank: %d", s_peers[i].id, s_peers[i].rank);
+    }
+#endif /* CONFIG_BLE_PEER_RANK_ENABLED */
+}
+
+/**@brief Find the given peer in the cache. */
+static m_coms_ble_addr_peer_t * m_coms_ble_addr_peer_find(pm_peer_id_t peer_id)
+{
+    for (size_t i = 0; i < s_peers_num; i++)
+    {
+        if (s_peers[i].id == peer_id)
+        {
+            return &s_peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Rebuild the peer cache from the content of the peer database. */
+static void m_coms_ble_addr_peers_build(void)
+{
+    pm_peer_id_t peer_id = PM_PEER_ID_INVALID;
+
+    s_peers_num         = 0;
+    s_peers_overflow    = false;
+
+    while ((peer_id = pm_next_peer_id_get(peer_id)) != PM_PEER_ID_INVALID)
+    {
+        if (s_peers_num >= CONFIG_MAX_BONDS)
+        {
+            NRF_LOG_WARNING("Too many peers in the database!");
+            s_peers_overflow = true;
+            break;
+        }
+
+        s_peers[s_peers_num].id = peer_id;
+        m_coms_ble_addr_peer_load(&s_peers[s_peers_num++]);
+    }
+
+    m_coms_ble_addr_peers_sort();
+}
+
+/**@brief Reload the summary of the given peer after its data has changed. */
+static void m_coms_ble_addr_peer_update(pm_peer_id_t peer_id)
+{
+    m_coms_ble_addr_peer_t *p_peer = m_coms_ble_addr_peer_find(peer_id);
+
+    if (p_peer == NULL)
+    {
+        if (s_peers_num >= CONFIG_MAX_BONDS)
+        {
+            NRF_LOG_WARNING("Too many peers in the database!");
+            s_peers_overflow = true;
+            return;
+        }
+
+        p_peer      = &s_peers[s_peers_num++];
+        p_peer->id  = peer_id;
+    }
+
+    m_coms_ble_addr_peer_load(p_peer);
+    m_coms_ble_addr_peers_sort();
+}
+
+/**@brief Remove the given peer from the cache. */
+static void m_coms_ble_addr_peer_remove(pm_peer_id_t peer_id)
+{
+    m_coms_ble_addr_peer_t *p_peer;
+
+    if (s_peers_overflow)
+    {
+        // Some peers were left out of the cache. Now there might be room for them.
+        m_coms_ble_addr_peers_build();
+        return;
+    }
+
+    p_peer = m_coms_ble_addr_peer_find(peer_id);
+    if (p_peer != NULL)
+    {
+        s_peers_num -= 1;
+        memmove(p_peer, p_peer + 1, (uint8_t *)&s_peers[s_peers_num] - (uint8_t *)p_peer);
+    }
+}
+
+#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
 
 ret_code_t m_coms_ble_addr_local_addr_set(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr)
 {
@@ -115,6 +287,7 @@ ret_code_t m_coms_ble_addr_local_addr_set(pm_peer_id_t peer_id, ble_gap_addr_t *
     }
 
     memcpy(&(p_app_data_buffer->app_data.ble_addr), p_ble_addr, sizeof(ble_gap_addr_t));
+    p_app_data_buffer->peer_id = peer_id;
 
     status = pm_peer_data_app_data_store(peer_id,
                                        (const uint8_t *)&(p_app_data_buffer->app_data),
@@ -139,34 +312,29 @@ ret_code_t m_coms_ble_addr_local_addr_set(pm_peer_id_t peer_id, ble_gap_addr_t *
 
 ret_code_t m_coms_ble_addr_local_addr_get(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr)
 {
-    m_coms_ble_addr_app_data_t app_data;
-    uint16_t app_data_len;
-    ret_code_t status;
+    m_coms_ble_addr_peer_t *p_peer;
 
     if (!p_ble_addr)
     {
         return NRF_ERROR_INVALID_PARAM;
     }
 
-    app_data_len = sizeof(app_data);
-    status = pm_peer_data_app_data_load(peer_id, (uint8_t *)&app_data, &app_data_len);
-    if (status != NRF_SUCCESS)
+    p_peer = m_coms_ble_addr_peer_find(peer_id);
+    if ((p_peer == NULL) || !p_peer->valid)
     {
-        return status;
+        return NRF_ERROR_NOT_FOUND;
     }
 
-    ASSERT(app_data_len == sizeof(app_data));
-
-    NRF_LOG_DEBUG("Application data load: %d", peer_id);
-    NRF_LOG_DEBUG("\t- Local Address: %02X:%02X:%02X:%02X:%02X:%02X",
-               app_data.ble_addr.addr[5],
-               app_data.ble_addr.addr[4],
-               app_data.ble_addr.addr[3],
-               app_data.ble_addr.addr[2],
-               app_data.ble_addr.addr[1],
-               app_data.ble_addr.addr[0]);
+    NRF_LOG_DEBUG("Local address of peer %d: %02X:%02X:%02X:%02X:%02X:%02X",
+               peer_id,
+               p_peer->local_addr.addr[5],
+               p_peer->local_addr.addr[4],
+               p_peer->local_addr.addr[3],
+               p_peer->local_addr.addr[2],
+               p_peer->local_addr.addr[1],
+               p_peer->local_addr.addr[0]);
 
-    *p_ble_addr = app_data.ble_addr;
+    *p_ble_addr = p_peer->local_addr;
 
     return NRF_SUCCESS;
 }
@@ -174,32 +342,24 @@ ret_code_t m_coms_ble_addr_local_addr_get(pm_peer_id_t peer_id, ble_gap_addr_t *
 ret_code_t m_coms_ble_addr_local_addr_new(ble_gap_addr_t *addr)
 {
     uint64_t largest_addr_val;
-    pm_peer_id_t peer_id;
 
     largest_addr_val = 0;
-    peer_id = PM_PEER_ID_INVALID;
-    while ((peer_id = pm_next_peer_id_get(peer_id)) != PM_PEER_ID_INVALID)
+    for (size_t i = 0; i < s_peers_num; i++)
     {
-        m_coms_ble_addr_app_data_t app_data;
-        uint16_t app_data_len;
+        const ble_gap_addr_t *p_local_addr = &s_peers[i].local_addr;
         uint64_t addr_val;
-        ret_code_t status;
 
-        app_data_len = sizeof(app_data);
-        status = pm_peer_data_app_data_load(peer_id, (uint8_t *)&app_data, &app_data_len);
-        if (status != NRF_SUCCESS)
+        if (!s_peers[i].valid)
         {
-            return status;
+            continue;
         }
 
-        ASSERT(app_data_len == sizeof(app_data));
-
-        addr_val =  (uint64_t)(app_data.ble_addr.addr[0]) << 0;
-        addr_val |= (uint64_t)(app_data.ble_addr.addr[1]) << 8;
-        addr_val |= (uint64_t)(app_data.ble_addr.addr[2]) << 16;
-        addr_val |= (uint64_t)(app_data.ble_addr.addr[3]) << 24;
-        addr_val |= (uint64_t)(app_data.ble_addr.addr[4]) << 32;
-        addr_val |= (uint64_t)(app_data.ble_addr.addr[5]) << 40;
+        addr_val =  (uint64_t)(p_local_addr->addr[0]) << 0;
+        addr_val |= (uint64_t)(p_local_addr->addr[1]) << 8;
+        addr_val |= (uint64_t)(p_local_addr->addr[2]) << 16;
+        addr_val |= (uint64_t)(p_local_addr->addr[3]) << 24;
+        addr_val |= (uint64_t)(p_local_addr->addr[4]) << 32;
+        addr_val |= (uint64_t)(p_local_addr->addr[5]) << 40;
 
         if (addr_val > largest_addr_val)
         {
@@ -234,113 +394,169 @@ ret_code_t m_coms_ble_addr_local_addr_new(ble_gap_addr_t *addr)
     return NRF_SUCCESS;
 }
 
-static void m_coms_ble_addr_pm_evt_handler(const pm_evt_t *p_evt)
+/**@brief Handle completion of the application data update. Returns true if the peer cache was updated. */
+static bool m_coms_ble_addr_app_data_stored(const pm_evt_t *p_evt)
 {
     size_t i;
 
+    NRF_LOG_DEBUG("PM_EVT_PEER_DATA_UPDATE_SUCCEEDED: %d [0x%08X]",
+              p_evt->peer_id,
+              (p_evt->params.peer_data_update_succeeded.action != PM_PEER_DATA_OP_DELETE) ? p_evt->params.peer_data_update_succeeded.token : PM_STORE_TOKEN_INVALID);
+
+    if (p_evt->params.peer_data_update_succeeded.action == PM_PEER_DATA_OP_DELETE)
+    {
+        return false;
+    }
+
+    // Free application data buffer since it is no longer needed.
+    for (i = 0; i < ARRAY_SIZE(s_app_data_buffer); i++)
+    {
+        if (s_app_data_buffer[i].token == p_evt->params.peer_data_update_succeeded.token)
+        {
+            m_coms_ble_addr_peer_t *p_peer = m_coms_ble_addr_peer_find(p_evt->peer_id);
+
+            s_app_data_buffer[i].token = PM_STORE_TOKEN_INVALID;
+
+            // The stored address is known, so there is no need to read it back.
+            if ((p_peer != NULL) && p_peer->valid && (s_app_data_buffer[i].peer_id == p_evt->peer_id))
+            {
+                p_peer->local_addr = s_app_data_buffer[i].app_data.ble_addr;
+                return true;
+            }
+            break;
+        }
+    }
+
+    if (i == ARRAY_SIZE(s_app_data_buffer))
+    {
+        NRF_LOG_WARNING("%s(): WARNING: No application data buffer found for PM store token 0x%08X!",
+                  (uint32_t)__func__, p_evt->params.peer_data_update_succeeded.token);
+    }
+
+    return false;
+}
+#endif /* CONFIG_BLE_DYNAMIC_ADDR_ENABLED */
+
+static void m_coms_ble_addr_pm_evt_handler(const pm_evt_t *p_evt)
+{
     switch (p_evt->evt_id)
     {
         case PM_EVT_PEER_DATA_UPDATE_SUCCEEDED:
-            if (p_evt->params.peer_data_update_succeeded.data_id == PM_PEER_DATA_ID_APPLICATION)
+            switch (p_evt->params.peer_data_update_succeeded.data_id)
             {
-                NRF_LOG_DEBUG("PM_EVT_PEER_DATA_UPDATE_SUCCEEDED: %d [0x%08X]",
-                          p_evt->peer_id,
-                          (p_evt->params.peer_data_update_succeeded.action != PM_PEER_DATA_OP_DELETE) ? p_evt->params.peer_data_update_succeeded.token : PM_STORE_TOKEN_INVALID);
-
-                if (p_evt->params.peer_data_update_succeeded.action != PM_PEER_DATA_OP_DELETE)
-                {
-                    // Free application data buffer since it is no longer needed.
-                    for (i = 0; i < ARRAY_SIZE(s_app_data_buffer); i++)
+                case PM_PEER_DATA_ID_APPLICATION:
+#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
+                    if (m_coms_ble_addr_app_data_stored(p_evt))
                     {
-                        if (s_app_data_buffer[i].token == p_evt->params.peer_data_update_succeeded.token)
-                        {
-                            s_app_data_buffer[i].token = PM_STORE_TOKEN_INVALID;
-                            break;
-                        }
+                        break;
                     }
+#endif
+                    /* Fall through */
 
-                    if (i == ARRAY_SIZE(s_app_data_buffer))
-                    {
-                        NRF_LOG_WARNING("%s(): WARNING: No application data buffer found for PM store token 0x%08X!",
-                                  (uint32_t)__func__, p_evt->params.peer_data_update_succeeded.token);
-                    }
-                }
+                case PM_PEER_DATA_ID_BONDING:
+                case PM_PEER_DATA_ID_PEER_RANK:
+                    m_coms_ble_addr_peer_update(p_evt->peer_id);
+                    break;
+
+                default:
+                    /* Ignore */
+                    break;
             }
             break;
 
+        case PM_EVT_PEER_DATA_UPDATE_FAILED:
+        case PM_EVT_PEER_DELETE_FAILED:
+            // The content of the database is uncertain. Read it again.
+            m_coms_ble_addr_peers_build();
+            break;
+
+        case PM_EVT_PEER_DELETE_SUCCEEDED:
+            m_coms_ble_addr_peer_remove(p_evt->peer_id);
+            break;
+
+        case PM_EVT_PEERS_DELETE_SUCCEEDED:
+        case PM_EVT_PEERS_DELETE_FAILED:
+            m_coms_ble_addr_peers_build();
+            break;
+
         default:
             /* Ignore */
             break;
     }
 }
-#endif /* CONFIG_BLE_DYNAMIC_ADDR_ENABLED */
 
-ret_code_t m_coms_ble_addr_peer_ids_get(pm_peer_id_t *p_peer_ids, unsigned int *p_peers_num)
+ret_code_t m_coms_ble_addr_peers_check(unsigned int *p_peers_num)
 {
-    m_coms_ble_addr_peer_t peers[CONFIG_MAX_BONDS];
-    pm_peer_id_t peer_id = PM_PEER_ID_INVALID;
     unsigned int n = 0;
+    size_t i = 0;
 
-    while ((peer_id = pm_next_peer_id_get(peer_id)) != PM_PEER_ID_INVALID)
+    while (i < s_peers_num)
     {
-        if (n >= CONFIG_MAX_BONDS)
+        if (!s_peers[i].valid)
         {
-            return NRF_ERROR_NO_MEM;
-        }
+            pm_peer_id_t peer_id = s_peers[i].id;
+            ret_code_t status;
 
-#if CONFIG_BLE_PEER_RANK_ENABLED
-        uint16_t   rank_len = sizeof(peers[n].rank);
-        ret_code_t status;
+            NRF_LOG_WARNING("Deleting Corrupted Peer %d ...", peer_id);
+            status = pm_peer_delete(peer_id);
+            if (status != NRF_SUCCESS)
+            {
+                return status;
+            }
 
-        status = pm_peer_data_load(peer_id, PM_PEER_DATA_ID_PEER_RANK, &peers[n].rank, &rank_len);
-        if (status != NRF_SUCCESS)
-        {
-            return status;
+            // Peer Manager does not report a peer marked for deletion anymore.
+            m_coms_ble_addr_peer_remove(peer_id);
+            continue;
         }
 
-        ASSERT(rank_len == sizeof(peers[n].rank));
-#endif /* CONFIG_BLE_PEER_RANK_ENABLED */
+        n += 1;
+        i += 1;
+    }
+
+    *p_peers_num = n;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t m_coms_ble_addr_peer_ids_get(pm_peer_id_t *p_peer_ids, unsigned int *p_peers_num)
+{
+    unsigned int n = 0;
 
-        peers[n++].id = peer_id;
+    if (s_peers_overflow)
+    {
+        return NRF_ERROR_NO_MEM;
     }
 
-#if CONFIG_BLE_PEER_RANK_ENABLED
-    /*
-     * Sort peers by rank. There are only a few elements on the list,
-     * so use a simple algorithm with small footprint.
-     */
-    for (size_t k = 0; k < n; k++)
+    for (size_t i = 0; i < s_peers_num; i++)
     {
-        size_t id = k;
-        for (size_t l = k + 1; l < n; l++)
-        {
-            if (peers[l].rank < peers[id].rank)
-            {
-                id = l;
-            }
-        }
-        if (id != k)
+        if (s_peers[i].valid)
         {
-            m_coms_ble_addr_peer_t tmp = peers[k];
-            peers[k]  = peers[id];
-            peers[id] = tmp;
+            p_peer_ids[n++] = s_peers[i].id;
         }
     }
 
-    NRF_LOG_DEBUG("Peer Ranks:");
-    for (size_t i = 0; i < n; i++)
+    *p_peers_num = n;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t m_coms_ble_addr_peer_addr_get(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr)
+{
+    m_coms_ble_addr_peer_t *p_peer;
+
+    if (!p_ble_addr)
     {
-        NRF_LOG_DEBUG("\t- Peer %d Rank: %d", peers[i].id, peers[i].rank);
+        return NRF_ERROR_INVALID_PARAM;
     }
-#endif /* CONFIG_BLE_PEER_RANK_ENABLED */
 
-    *p_peers_num = n;
-    while (n > 0)
+    p_peer = m_coms_ble_addr_peer_find(peer_id);
+    if ((p_peer == NULL) || !p_peer->valid)
     {
-        n -= 1;
-        p_peer_ids[n] = peers[n].id;
+        return NRF_ERROR_NOT_FOUND;
     }
 
+    *p_ble_addr = p_peer->peer_addr;
+
     return NRF_SUCCESS;
 }
 
@@ -377,23 +593,16 @@ ret_code_t m_coms_ble_addr_init(void)
 #endif /* CONFIG_BOND_PUBLIC_ADDR_ENABLED */
 
 #if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
+    // Initialize application data buffers.
+    for (size_t i = 0; i < ARRAY_SIZE(s_app_data_buffer); i++)
     {
-        ret_code_t status;
-
-        // Initialize application data buffers.
-        for (size_t i = 0; i < ARRAY_SIZE(s_app_data_buffer); i++)
-        {
-            s_app_data_buffer[i].token = PM_STORE_TOKEN_INVALID;
-        }
-
-        // Register the module in Peer Manager and return.
-        status = pm_register(m_coms_ble_addr_pm_evt_handler);
-        if (status != NRF_SUCCESS)
-        {
-            return status;
-        }
+        s_app_data_buffer[i].token = PM_STORE_TOKEN_INVALID;
     }
 #endif
 
-    return NRF_SUCCESS;
+    // Read the peer database once. From now on the cache follows Peer Manager events.
+    m_coms_ble_addr_peers_build();
+
+    // Register the module in Peer Manager and return.
+    return pm_register(m_coms_ble_addr_pm_evt_handler);
 }
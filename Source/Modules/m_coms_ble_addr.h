@@ -45,6 +45,9 @@
  * @{
  * @brief This module deals with storing and maintaining local address information in flash.
  *
+ * @details The module keeps a summary of the peer database (ranks, local and peer addresses) in RAM.
+ *          The summary is read from flash once at initialization and then follows Peer Manager events,
+ *          so advertising can be started without walking the peer database in flash.
  */
 #ifndef __M_COMS_BLE_ADDR_H__
 #define __M_COMS_BLE_ADDR_H__
@@ -69,16 +72,37 @@ ret_code_t m_coms_ble_addr_init(void);
  */
 ret_code_t m_coms_ble_addr_local_addr_set(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr);
 
-/**@brief Function for getting the BLE address from the application context flash area of the Device Manager.
+/**@brief Function for getting the local BLE address used with the given peer.
  *
  * @param[in]  peer_id      Peer Manager device ID.
  * @param[out] p_ble_addr   BLE GAP address.
  *
- * @return NRF_SUCCESS on success, otherwise an error code.
+ * @return NRF_SUCCESS on success, NRF_ERROR_NOT_FOUND if the peer is unknown or its data is corrupted.
  */
 ret_code_t m_coms_ble_addr_local_addr_get(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr);
 
+/**@brief Function for getting the identity address of the given peer.
+ *
+ * @param[in]  peer_id      Peer Manager device ID.
+ * @param[out] p_ble_addr   BLE GAP address.
+ *
+ * @return NRF_SUCCESS on success, NRF_ERROR_NOT_FOUND if the peer is unknown or its data is corrupted.
+ */
+ret_code_t m_coms_ble_addr_peer_addr_get(pm_peer_id_t peer_id, ble_gap_addr_t *p_ble_addr);
+
+/**@brief Function for checking the integrity of the peer database.
+ *
+ * @details Peers with missing rank, application or bonding data are deleted.
+ *
+ * @param[out]  p_peers_num Number of valid peers.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_coms_ble_addr_peers_check(unsigned int *p_peers_num);
+
 /**@brief Function for getting the device IDs and the number of bonded hosts.
+ *
+ * @details Peers are sorted by rank, the least recently used one first.
  *
  * @param[out]  p_peer_ids  Pointer to an array of peer IDs.
  * @param[out]  p_peers_num Number of peer IDs found.
@@ -50,6 +50,7 @@
 #include "m_coms_ble_addr.h"
 #include "m_coms_ble_adv.h"
 #include "m_coms_ble_lesc.h"
+#include "m_coms_ble_reconn.h"
 #include "app_debug.h"
 
 #include "resources.h"
@@ -68,6 +69,9 @@ typedef enum
     ADV_MODE_DIRECTED_MULTIPLE,     /**< Multiple directed advertisings (in sequence), one targeted at each bonded Central. */
     ADV_MODE_UNDIRECTED_BONDABLE,   /**< Undirected advertising. */
     ADV_MODE_UNDIRECTED_WHITELIST,  /**< Undirected advertising with whitelist (when directed cannot be used, not bondable). */
+#if CONFIG_ADV_RECONN_ENABLED
+    ADV_MODE_RECONNECT,             /**< Directed or whitelist advertising following the plan made by the reconnection strategy. */
+#endif
 } m_coms_ble_adv_mode_t;
 
 /**@brief Struct to keep track of advertising type and dynamic parameters. */
@@ -81,6 +85,9 @@ typedef struct
                                                  In direct advertising mode, there are DIRECTED_ADV_COUNT sessions targetted at the same peer. */
     uint8_t                 adv_type;       /**< See BLE_GAP_ADV_TYPES. */
     uint8_t                 adv_flags;      /**< See BLE_GAP_DISC_MODES. */
+#if CONFIG_ADV_RECONN_ENABLED
+    uint8_t                 attempt;        /**< Current attempt of the reconnection plan. In this mode adv_count is kept per attempt. */
+#endif
 } m_coms_ble_adv_state_t;
 
 // Check if manufacturer data can with within advertising packet
@@ -226,6 +233,12 @@ static void m_coms_ble_adv_on_ble_evt(const ble_evt_t *p_ble_evt, void *p_contex
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_CONNECTED:
+#if CONFIG_ADV_RECONN_ENABLED
+            if (s_state.mode == ADV_MODE_RECONNECT)
+            {
+                m_coms_ble_reconn_attempt_succeeded();
+            }
+#endif
             NRF_LOG_DEBUG("Mode Change: BLE_GAP_EVT_CONNECTED => ADV_MODE_NONE");
             s_state.mode            = ADV_MODE_NONE;
             s_state.adv_active      = false;
@@ -327,54 +340,69 @@ ret_code_t m_coms_ble_adv_init(const m_coms_ble_params_t *p_ble_params)
     memset(&s_state, 0, sizeof(s_state));
     s_state.mode = ADV_MODE_NONE;
 
+#if CONFIG_ADV_RECONN_ENABLED
+    ret_code_t status = m_coms_ble_reconn_init();
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+#endif
+
     return pm_register(m_coms_ble_adv_pm_evt_handler);
 }
 
-/**@brief Determine the best advertising method based on the module state. */
-static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
+#if CONFIG_ADV_RECONN_ENABLED
+/**@brief Start reconnection to bonded masters in the order chosen by the reconnection strategy.
+ *
+ * @param[in] all_peers Target all bonded masters instead of the most likely one only.
+ */
+static void m_coms_ble_adv_reconnect(bool all_peers)
 {
-    pm_peer_id_t peer_id, next_peer_id;
-    unsigned int peer_count = 0;
-
-    // Check integrity of the peer database.
-    for (peer_id = pm_next_peer_id_get(PM_PEER_ID_INVALID);
-         peer_id != PM_PEER_ID_INVALID;
-         peer_id = next_peer_id)
-    {
-        bool peer_data_corrupted = false;
-
-        // Obtain the ID of the next peer.
-        next_peer_id = pm_next_peer_id_get(peer_id);
+    pm_peer_id_t peer_ids[CONFIG_MAX_BONDS];
+    unsigned int peer_count;
+    unsigned int attempts;
+
+    APP_ERROR_CHECK(m_coms_ble_addr_peer_ids_get(peer_ids, &peer_count));
+    attempts = m_coms_ble_reconn_plan(peer_ids,
+                                      peer_count,
+                                      (all_peers) ? peer_count : 1,
+                                      sp_ble_params->bond_params.directed_adv);
+    APP_ERROR_CHECK_BOOL(attempts > 0);
+
+    NRF_LOG_INFO("Mode Change: ADV_MODE_NONE => ADV_MODE_RECONNECT");
+    s_state.mode    = ADV_MODE_RECONNECT;
+    s_state.attempt = 0;
+}
 
-#if CONFIG_BLE_PEER_RANK_ENABLED
-        uint32_t rank;
-        uint16_t rank_size = sizeof(rank);
+/**@brief Advance the reconnection plan after an advertising timeout.
+ *
+ * @return True if there are more attempts to make.
+ */
+static bool m_coms_ble_adv_reconnect_next(void)
+{
+    m_coms_ble_reconn_attempt_t attempt;
 
-        if (pm_peer_data_load(peer_id, PM_PEER_DATA_ID_PEER_RANK, &rank, &rank_size) != NRF_SUCCESS)
-        {
-            peer_data_corrupted = true;
-        }
-#endif /* CONFIG_BLE_PEER_RANK_ENABLED */
+    APP_ERROR_CHECK(m_coms_ble_reconn_attempt_get(s_state.attempt, &attempt));
+    if ((attempt.method == M_COMS_BLE_RECONN_DIRECTED) && (s_state.adv_count < DIRECTED_ADV_COUNT))
+    {
+        // Continue directed advertising to the same peer.
+        return true;
+    }
 
-#if CONFIG_BLE_DYNAMIC_ADDR_ENABLED
-        ble_gap_addr_t addr;
+    s_state.attempt  += 1;
+    s_state.adv_count = 0;
 
-        if (m_coms_ble_addr_local_addr_get(peer_id, &addr) != NRF_SUCCESS)
-        {
-            peer_data_corrupted = true;
-        }
-#endif /* CONFIG_BLE_DYNAMIC_ADDR_ENABLED */
+    return (m_coms_ble_reconn_attempt_get(s_state.attempt, &attempt) == NRF_SUCCESS);
+}
+#endif /* CONFIG_ADV_RECONN_ENABLED */
 
-        if (peer_data_corrupted)
-        {
-            NRF_LOG_WARNING("Deleting Corrupted Peer %d ...", peer_id);
-            APP_ERROR_CHECK(pm_peer_delete(peer_id));
-            continue;
-        }
+/**@brief Determine the best advertising method based on the module state. */
+static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
+{
+    unsigned int peer_count;
 
-        // Count peer as valid.
-        peer_count += 1;
-    }
+    // Check integrity of the peer database.
+    APP_ERROR_CHECK(m_coms_ble_addr_peers_check(&peer_count));
 
     // Differentiate between bonding behavior and normal behavior.
     if (s_state.bond_initiate)
@@ -389,6 +417,10 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
                 }
                 else if (sp_ble_params->bond_params.bond_reconnect_all && peer_count > 0)
                 {
+#if CONFIG_ADV_RECONN_ENABLED
+                    // Try advertising vs. all bonded masters, the most promising attempts first.
+                    m_coms_ble_adv_reconnect(true);
+#else
                     // Try advertising vs. all bonded masters.
                     // Use undirected advertising with whitelist if directed advertising is not to be used.
                     if (sp_ble_params->bond_params.directed_adv)
@@ -401,6 +433,7 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
                         NRF_LOG_INFO("Mode Change: ADV_MODE_NONE => ADV_MODE_UNDIRECTED_WHITELIST");
                         s_state.mode = ADV_MODE_UNDIRECTED_WHITELIST;
                     }
+#endif /* CONFIG_ADV_RECONN_ENABLED */
                 }
                 else
                 {
@@ -445,6 +478,25 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
                 }
                 break;
 
+#if CONFIG_ADV_RECONN_ENABLED
+            case ADV_MODE_RECONNECT:
+                if (p_ble_evt &&
+                    p_ble_evt->header.evt_id == BLE_GAP_EVT_TIMEOUT)
+                {
+                    if (m_coms_ble_adv_reconnect_next())
+                    {
+                        // Continue with the next attempt.
+                    }
+                    else
+                    {
+                        // Reconnection attempt completed: start undirected bondable.
+                        NRF_LOG_INFO("Mode Change: ADV_MODE_RECONNECT => ADV_MODE_UNDIRECTED_BONDABLE");
+                        s_state.mode = ADV_MODE_UNDIRECTED_BONDABLE;
+                    }
+                }
+                break;
+#endif /* CONFIG_ADV_RECONN_ENABLED */
+
             case ADV_MODE_UNDIRECTED_BONDABLE:
                 if (p_ble_evt && p_ble_evt->header.evt_id == BLE_GAP_EVT_TIMEOUT)
                 {
@@ -472,6 +524,20 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
                 }
                 else if (peer_count > 0)
                 {
+#if CONFIG_ADV_RECONN_ENABLED
+                    if (sp_ble_params->bond_params.reconnect_all ||
+                        sp_ble_params->bond_params.directed_adv ||
+                        CONFIG_ADV_WHITELIST)
+                    {
+                        // Target bonded masters, the most promising attempts first.
+                        m_coms_ble_adv_reconnect(sp_ble_params->bond_params.reconnect_all);
+                    }
+                    else
+                    {
+                        NRF_LOG_INFO("Mode Change: ADV_MODE_NONE => ADV_MODE_UNDIRECTED_BONDABLE");
+                        s_state.mode = ADV_MODE_UNDIRECTED_BONDABLE;
+                    }
+#else
                     if (sp_ble_params->bond_params.reconnect_all)
                     {
                         // Try advertising vs. all bonded masters.
@@ -506,6 +572,7 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
 #endif /* CONFIG_ADV_WHITELIST */
                         }
                     }
+#endif /* CONFIG_ADV_RECONN_ENABLED */
                 }
                 else
                 {
@@ -567,6 +634,25 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
                 }
                 break;
 
+#if CONFIG_ADV_RECONN_ENABLED
+            case ADV_MODE_RECONNECT:
+                if (p_ble_evt &&
+                    p_ble_evt->header.evt_id == BLE_GAP_EVT_TIMEOUT)
+                {
+                    if (m_coms_ble_adv_reconnect_next())
+                    {
+                        // Continue with the next attempt.
+                    }
+                    else
+                    {
+                        // Reconnection plan completed.
+                        NRF_LOG_INFO("Mode Change: ADV_MODE_RECONNECT => ADV_MODE_NONE");
+                        s_state.mode = ADV_MODE_NONE;
+                    }
+                }
+                break;
+#endif /* CONFIG_ADV_RECONN_ENABLED */
+
             case ADV_MODE_UNDIRECTED_BONDABLE:
                 NRF_LOG_INFO("Mode Change: ADV_MODE_UNDIRECTED_BONDABLE => ADV_MODE_NONE");
                 s_state.mode = ADV_MODE_NONE;
@@ -583,6 +669,19 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
     switch (s_state.mode)
     {
 #if CONFIG_SEC_ALLOW_REPAIRING
+#if CONFIG_ADV_RECONN_ENABLED
+        case ADV_MODE_RECONNECT:
+            if (s_state.adv_count != 0)
+            {
+                // We are continuing advertising to the same peer. Skip LESC key renewal.
+                break;
+            }
+
+            // Change LESC key when switching to a new peer.
+            reset_lesc_key();
+            break;
+#endif /* CONFIG_ADV_RECONN_ENABLED */
+
         case ADV_MODE_DIRECTED_SINGLE:
         case ADV_MODE_DIRECTED_MULTIPLE:
             if ((s_state.adv_count % DIRECTED_ADV_COUNT) != 0)
@@ -597,6 +696,9 @@ static bool m_coms_ble_adv_determine(const ble_evt_t *p_ble_evt)
             reset_lesc_key();
             break;
 #else /* !CONFIG_SEC_ALLOW_REPAIRING */
+#if CONFIG_ADV_RECONN_ENABLED
+        case ADV_MODE_RECONNECT:
+#endif
         case ADV_MODE_DIRECTED_SINGLE:
         case ADV_MODE_DIRECTED_MULTIPLE:
         case ADV_MODE_UNDIRECTED_WHITELIST:
@@ -626,7 +728,7 @@ static ret_code_t m_coms_ble_adv_real_start(void)
     pm_peer_id_t peer_id;
     pm_peer_id_t peer_ids[CONFIG_MAX_BONDS];
     unsigned int peer_count;
-    pm_peer_data_bonding_t peer_data;
+    ble_gap_addr_t peer_addr;
 
     ble_gap_adv_params_t adv_params;
     bool use_whitelist;
@@ -711,17 +813,46 @@ static ret_code_t m_coms_ble_adv_real_start(void)
             use_whitelist       = true;
             break;
 
+#if CONFIG_ADV_RECONN_ENABLED
+        case ADV_MODE_RECONNECT:
+        {
+            m_coms_ble_reconn_attempt_t attempt;
+
+            status = m_coms_ble_reconn_attempt_get(s_state.attempt, &attempt);
+            if (status != NRF_SUCCESS)
+            {
+                return status;
+            }
+
+            if (s_state.adv_count == 0)
+            {
+                // First advertising session of this attempt.
+                m_coms_ble_reconn_attempt_started(s_state.attempt);
+            }
+
+            peer_id = attempt.peer_id;
+
+            if (attempt.method == M_COMS_BLE_RECONN_DIRECTED)
+            {
+                s_state.adv_type    = BLE_GAP_ADV_TYPE_ADV_DIRECT_IND;
+            }
+            else
+            {
+                s_state.adv_type    = BLE_GAP_ADV_TYPE_ADV_IND;
+                use_whitelist       = true;
+            }
+
+            s_state.adv_count   += 1;
+            break;
+        }
+#endif /* CONFIG_ADV_RECONN_ENABLED */
+
         case ADV_MODE_UNDIRECTED_BONDABLE:
             // Check whether we need to make room for the new bond.
             if (peer_count >= CONFIG_MAX_BONDS)
             {
-                pm_peer_id_t peer_id;
-
-                status = pm_peer_ranks_get(NULL, NULL, &peer_id, NULL);
-                if (status != NRF_SUCCESS)
-                {
-                    return status;
-                }
+                // Remove the least recently used one.
+                pm_peer_id_t peer_id = peer_ids[0];
 
                 status = pm_peer_delete(peer_id);
                 if (status != NRF_SUCCESS)
@@ -762,7 +893,7 @@ static ret_code_t m_coms_ble_adv_real_start(void)
         }
 #endif
         // Get the peer address.
-        status = pm_peer_data_bonding_load(peer_id, &peer_data);
+        status = m_coms_ble_addr_peer_addr_get(peer_id, &peer_addr);
         if (status != NRF_SUCCESS)
         {
             return status;
@@ -906,7 +1037,7 @@ static ret_code_t m_coms_ble_adv_real_start(void)
         case BLE_GAP_ADV_TYPE_ADV_DIRECT_IND:
             // Directed advertising.
             adv_params.type         = BLE_GAP_ADV_TYPE_ADV_DIRECT_IND;
-            adv_params.p_peer_addr  = &peer_data.peer_ble_id.id_addr_info;
+            adv_params.p_peer_addr  = &peer_addr;
 
             // Not bondable.
             s_state.adv_flags       = BLE_GAP_ADV_FLAG_BR_EDR_NOT_SUPPORTED;
@@ -41,9 +41,11 @@
 #include "m_coms_ble_atvv.h"
 
 #include <stdarg.h>
+#include <stddef.h>
 
 #include "app_timer.h"
 #include "ble_conn_state.h"
+#include "m_audio_frame.h"
 #include "m_coms_ble_atvv_srv.h"
 #include "nrf_queue.h"
 #include "peer_manager.h"
@@ -76,7 +78,6 @@ NRF_LOG_MODULE_REGISTER();
 #define ATVV_MIC_OPEN_TIMEOUT2   APP_TIMER_TICKS(ATVV_TIMEOUT_2_STREAMING_DURATION - ATVV_TIMEOUT_1_MIC_OPEN) /* Used to limit maximum streaming duration. */
 
 BLE_ATVV_DEF(m_atvv);
-APP_TIMER_DEF(m_mic_timer);
 
 /**@brief ADPCM frame header specified in ATVV specification. */
 typedef PACKED_STRUCT
@@ -87,6 +88,16 @@ typedef PACKED_STRUCT
     uint8_t index;                    /**< Index in ADPCM step size table. */
 } atvv_adpcm_frame_header;
 
+/*
+ * The codec writes the ADPCM state (prev_pred and index) at the beginning of the frame data. The sequence number
+ * and the remote control ID are filled in the frame headroom, so that the first fragment can be sent directly
+ * from the frame buffer.
+ */
+#define ATVV_HEADER_HEADROOM_LEN offsetof(atvv_adpcm_frame_header, prev_pred)
+
+STATIC_ASSERT(ATVV_HEADER_HEADROOM_LEN == CONFIG_AUDIO_FRAME_HEADROOM);
+STATIC_ASSERT(offsetof(m_audio_frame_t, data) == CONFIG_AUDIO_FRAME_HEADROOM);
+
 /**@brief ATVV connection states. */
 typedef enum
 {
@@ -106,6 +117,8 @@ typedef struct
     bool             frame_in_transit;/**< True when a frame is currently partially transmitted. */
     uint8_t          sampling_rate;   /**< Audio sampling rate [kHz]. */
     atvv_mic_state_t state;           /**< State of an instance. */
+    app_timer_t      mic_timer_data;  /**< Memory for the microphone time-out timer. */
+    app_timer_id_t   mic_timer;       /**< Microphone time-out timer. Each peer is timed independently. */
 } atvv_instance_t;
 
 /**@brief Queued ATVV command. */
@@ -154,6 +167,7 @@ static ret_code_t m_coms_ble_atvv_ctl_msg_send(
 
         default:
             // No parameters for other control message types
+            p_param = NULL;
             break;
     }
 
@@ -250,6 +264,8 @@ static void m_coms_ble_atvv_instance_free(uint16_t conn_handle)
     {
         if (m_instances[i].conn_handle == conn_handle)
         {
+            // Pending time-out of this instance must not reach a reused instance.
+            (void) app_timer_stop(m_instances[i].mic_timer);
             m_instances[i].conn_handle = BLE_CONN_HANDLE_INVALID;
         }
     }
@@ -313,12 +329,12 @@ static ret_code_t m_coms_ble_atvv_state_update(atvv_instance_t * p_instance,
                     p_instance->frame_in_transit = false;
                     evt                          = EVT_ATVV_STATE_MIC_OPEN;
 
-                    err_code = app_timer_stop(m_mic_timer);
+                    err_code = app_timer_stop(p_instance->mic_timer);
                     if (err_code != NRF_SUCCESS)
                     {
                         return err_code;
                     }
-                    err_code = app_timer_start(m_mic_timer, ATVV_MIC_OPEN_TIMEOUT1, (void*) p_instance);
+                    err_code = app_timer_start(p_instance->mic_timer, ATVV_MIC_OPEN_TIMEOUT1, (void*) p_instance);
 
                     break;
 
@@ -365,7 +381,7 @@ static ret_code_t m_coms_ble_atvv_state_update(atvv_instance_t * p_instance,
                 case MIC_STATE_CLOSING:
                     p_instance->state = MIC_STATE_CLOSED;
                     evt               = EVT_ATVV_STATE_MIC_CLOSE;
-                    err_code = app_timer_stop(m_mic_timer);
+                    err_code = app_timer_stop(p_instance->mic_timer);
                     break;
 
                 default:
@@ -389,18 +405,18 @@ static ret_code_t m_coms_ble_atvv_state_update(atvv_instance_t * p_instance,
                     {
                         return err_code;
                     }
-                    err_code = app_timer_stop(m_mic_timer);
+                    err_code = app_timer_stop(p_instance->mic_timer);
                     break;
 
                 case MIC_STATE_OPEN_ACTIVE:
                     p_instance->state = MIC_STATE_OPEN_ACTIVE;
 
-                    err_code = app_timer_stop(m_mic_timer);
+                    err_code = app_timer_stop(p_instance->mic_timer);
                     if (err_code != NRF_SUCCESS)
                     {
                         return err_code;
                     }
-                    err_code = app_timer_start(m_mic_timer, ATVV_MIC_OPEN_TIMEOUT2, (void*) p_instance);
+                    err_code = app_timer_start(p_instance->mic_timer, ATVV_MIC_OPEN_TIMEOUT2, (void*) p_instance);
                     break;
 
                 default:
@@ -433,7 +449,7 @@ static ret_code_t m_coms_ble_atvv_state_update(atvv_instance_t * p_instance,
                     {
                         p_instance->state = MIC_STATE_CLOSING;
                     }
-                    err_code = app_timer_stop(m_mic_timer);
+                    err_code = app_timer_stop(p_instance->mic_timer);
                     break;
 
                 default:
@@ -511,7 +527,7 @@ static void m_coms_atvv_srv_event_handler(ble_atvv_evt_t const * p_evt)
 
             if (p_instance->state != MIC_STATE_CLOSED)
             {
-                // This or another instance already opened
+                // This instance already opened
                 NRF_LOG_DEBUG("Mic already open");
                 APP_ERROR_CHECK(m_coms_ble_atvv_ctl_msg_send(p_instance,
                                                              MIC_STATE_INVALID,
@@ -521,7 +537,17 @@ static void m_coms_atvv_srv_event_handler(ble_atvv_evt_t const * p_evt)
                 return;
             }
 
-            if (p_evt->params.mic_open.codec != BLE_ATVV_USED_CODEC_ADPCM_8KHZ)
+            if (p_evt->params.mic_open.codec == BLE_ATVV_USED_CODEC_ADPCM_8KHZ)
+            {
+                p_instance->sampling_rate = 8;
+            }
+#if CONFIG_AUDIO_SRC_ENABLED && (CONFIG_AUDIO_SRC_PDM_SAMPLING_FREQUENCY >= 16000)
+            else if (p_evt->params.mic_open.codec == BLE_ATVV_USED_CODEC_ADPCM_16KHZ)
+            {
+                p_instance->sampling_rate = 16;
+            }
+#endif
+            else
             {
                 APP_ERROR_CHECK(m_coms_ble_atvv_ctl_msg_send(p_instance,
                                                              MIC_STATE_INVALID,
@@ -531,10 +557,6 @@ static void m_coms_atvv_srv_event_handler(ble_atvv_evt_t const * p_evt)
                 m_coms_ble_atvv_ctl_queue_ping(p_instance);
                 return;
             }
-            else
-            {
-                p_instance->sampling_rate = 8;
-            }
 
             APP_ERROR_CHECK(m_coms_ble_atvv_state_update(p_instance, MIC_STATE_OPEN_IDLE));
             break;
@@ -604,15 +626,17 @@ ret_code_t m_coms_ble_atvv_init(void)
     for (size_t i = 0; i < ARRAY_SIZE(m_instances); ++i)
     {
         m_instances[i].conn_handle = BLE_CONN_HANDLE_INVALID;
-    }
+        m_instances[i].state       = MIC_STATE_CLOSED;
+        m_instances[i].mic_timer   = &m_instances[i].mic_timer_data;
 
-    err_code = app_timer_create(&m_mic_timer,
-                                APP_TIMER_MODE_SINGLE_SHOT,
-                                m_coms_atvv_mic_timeout_handler);
-    if (err_code != NRF_SUCCESS)
-    {
-        return err_code;
-    };
+        err_code = app_timer_create(&m_instances[i].mic_timer,
+                                    APP_TIMER_MODE_SINGLE_SHOT,
+                                    m_coms_atvv_mic_timeout_handler);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        };
+    }
 
     return ble_atvv_init(&m_atvv, m_coms_atvv_srv_event_handler);
 }
@@ -644,20 +668,50 @@ ret_code_t m_coms_ble_atvv_start_search(uint16_t conn_handle)
         return err_code;
     };
 
-    err_code = app_timer_stop(m_mic_timer);
+    err_code = app_timer_stop(p_instance->mic_timer);
     if (err_code != NRF_SUCCESS)
     {
         return err_code;
     };
 
-    err_code = app_timer_start(m_mic_timer, ATVV_SEARCH_OPEN_TIMEOUT, (void*) p_instance);
+    err_code = app_timer_start(p_instance->mic_timer, ATVV_SEARCH_OPEN_TIMEOUT, (void*) p_instance);
 
     m_coms_ble_atvv_ctl_queue_ping(p_instance);
 
     return err_code;
 }
 
-ret_code_t m_coms_ble_atvv_audio_send(uint8_t const                * p_frame_buf,
+size_t m_coms_ble_atvv_audio_peers_get(uint16_t * p_conn_handles, size_t max_count)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(m_instances); ++i)
+    {
+        if ((m_instances[i].conn_handle == BLE_CONN_HANDLE_INVALID) ||
+            (m_instances[i].state       == MIC_STATE_CLOSED)        ||
+            (m_instances[i].state       == MIC_STATE_CLOSING))
+        {
+            continue;
+        }
+
+        if (p_conn_handles != NULL)
+        {
+            if (count >= max_count)
+            {
+                break;
+            }
+
+            p_conn_handles[count] = m_instances[i].conn_handle;
+        }
+
+        count += 1;
+    }
+
+    return count;
+}
+
+ret_code_t m_coms_ble_atvv_audio_send(uint16_t                       conn_handle,
+                                      uint8_t                      * p_frame_buf,
                                       uint16_t                       frame_buf_len,
                                       uint16_t                     * p_bytes_transmitted,
                                       m_coms_data_process_status_t * p_status)
@@ -669,25 +723,9 @@ ret_code_t m_coms_ble_atvv_audio_send(uint8_t const                * p_frame_buf
     ASSERT(p_frame_buf != 0);
     ASSERT(frame_buf_len <= ATVV_CAPS_FRAME_SIZE_DEFAULT_134);
 
-    // Find the active instance (only one active instance is currently supported)
-    // NOTE: This should eventually be replaced by explicitly providing conn_handle as the function argument
-    p_instance = 0;
-    for (size_t i = 0; i < ARRAY_SIZE(m_instances); ++i)
-    {
-        if ((m_instances[i].conn_handle != BLE_CONN_HANDLE_INVALID) &&
-            (m_instances[i].state       != MIC_STATE_CLOSED))
-        {
-            p_instance = &m_instances[i];
-            break;
-        }
-    }
-
-    if (p_instance == 0)
-    {
-        *p_status = M_COMS_STATUS_CANNOT_SEND;
-        return NRF_SUCCESS;
-    };
-    if (p_instance->state == MIC_STATE_CLOSED)
+    if ((conn_handle == BLE_CONN_HANDLE_INVALID) ||
+        (m_coms_ble_atvv_instance_find(conn_handle, &p_instance) != NRF_SUCCESS) ||
+        (p_instance->state == MIC_STATE_CLOSED))
     {
         *p_status = M_COMS_STATUS_CANNOT_SEND;
         return NRF_SUCCESS;
@@ -711,30 +749,24 @@ ret_code_t m_coms_ble_atvv_audio_send(uint8_t const                * p_frame_buf
     if (!p_instance->frame_in_transit)
     {
         atvv_adpcm_frame_header * header;
-        uint8_t                   frame_packet[CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN];
+        uint16_t                  packet_len;
 
         // First packet of frame: Header needs to be populated
         // ADPCM frame already comes with state information from the codec driver. Only must add "seq number" and "Id"
-        // ADPCM state information is 3 bytes: 16-bit prediction, and 8-bit index
+        // in the headroom in front of the frame. The header is rewritten for every peer, as the notification data is
+        // copied by the SoftDevice.
 
-        header            = (atvv_adpcm_frame_header *) frame_packet;
-        header->id        = CONFIG_AUDIO_ATVV_REMOTE_CONTROL_ID;
-        header->prev_pred = *(int16_t*) &p_frame_buf[0];
-        header->index     = *(uint8_t*) &p_frame_buf[2];
+        header     = (atvv_adpcm_frame_header *) (p_frame_buf - ATVV_HEADER_HEADROOM_LEN);
+        header->id = CONFIG_AUDIO_ATVV_REMOTE_CONTROL_ID;
         uint16_big_encode(p_instance->frame_counter, header->sequence_number);
 
-        frame_bytes_sent = (CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN - sizeof(atvv_adpcm_frame_header) + 3);
-
-        // Fill the rest of the packet with frame contents
-        memcpy(&frame_packet[sizeof(atvv_adpcm_frame_header)],
-               &p_frame_buf[3],
-               CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN - sizeof(atvv_adpcm_frame_header));
+        packet_len       = MIN(frame_buf_len + ATVV_HEADER_HEADROOM_LEN, CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN);
+        frame_bytes_sent = packet_len - ATVV_HEADER_HEADROOM_LEN;
 
         err_code = ble_atvv_frame_data_transmit(&m_atvv,
-                                                frame_packet,
-                                                CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN,
+                                                (uint8_t const *) header,
+                                                packet_len,
                                                 p_instance->conn_handle);
-
     }
     else
     {
@@ -49,6 +49,7 @@
 #ifndef __M_COMS_BLE_ATVV_H__
 #define __M_COMS_BLE_ATVV_H__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -77,14 +78,26 @@ ret_code_t m_coms_ble_atvv_init(void);
  */
 ret_code_t m_coms_ble_atvv_start_search(uint16_t conn_handle);
 
-/**@brief Function for sending audio data.
+/**@brief Function for getting the peers that currently stream, or are about to stream, ATVV audio.
+ *
+ * @param[out] p_conn_handles Array where the connection handles will be stored. Can be NULL to only count the peers.
+ * @param[in]  max_count      Size of the @p p_conn_handles array.
+ *
+ * @return Number of peers found. If @p p_conn_handles is not NULL, at most @p max_count peers are returned.
+ */
+size_t m_coms_ble_atvv_audio_peers_get(uint16_t * p_conn_handles, size_t max_count);
+
+/**@brief Function for sending audio data to a peer.
  *
  * @note The data pointer must be updated according to how many bytes are transmitted per call to this function.
  *
  * @details If audio frame length is longer than the MTU size or ATVV-permitted transmit size, the frame will be sent
-            in multiple chunks. The @p p_bytes_transmitted is set to the number of bytes of the frame sent.
- *          The ATVV frame header is automatically inserted.
+ *          in multiple chunks. The @p p_bytes_transmitted is set to the number of bytes of the frame sent.
+ *          The ATVV frame header is completed in place: the first chunk of a frame is sent starting
+ *          @ref CONFIG_AUDIO_FRAME_HEADROOM bytes before @p p_frame_buf, so the frame must come from an
+ *          @ref m_audio_frame_t. No copy of the frame is made.
  *
+ * @param[in]  conn_handle         Connection handle of the peer.
  * @param[in]  p_frame_buf         Pointer to the frame buffer.
  * @param[in]  frame_buf_len       Length of the frame buffer.
  * @param[out] p_bytes_transmitted Pointer to memory where number of bytes transmitted will be stored.
@@ -92,7 +105,8 @@ ret_code_t m_coms_ble_atvv_start_search(uint16_t conn_handle);
  *
  * @retval NRF_SUCCESS No errors occured.
  */
-ret_code_t m_coms_ble_atvv_audio_send(uint8_t const                * p_frame_buf,
+ret_code_t m_coms_ble_atvv_audio_send(uint16_t                       conn_handle,
+                                      uint8_t                      * p_frame_buf,
                                       uint16_t                       frame_buf_len,
                                       uint16_t                     * p_bytes_transmitted,
                                       m_coms_data_process_status_t * p_status);
@@ -55,7 +55,12 @@ NRF_LOG_MODULE_REGISTER();
 #define ATVV_FRAME_HEADER_SIZE 6
 #define ATVV_FRAME_SIZE        (ATVV_FRAME_HEADER_SIZE + \
                                ((CONFIG_AUDIO_FRAME_SIZE_SAMPLES * sizeof(int16_t)) / 4))
+#if CONFIG_AUDIO_SRC_ENABLED && (CONFIG_AUDIO_SRC_PDM_SAMPLING_FREQUENCY >= 16000)
+// Sample rate conversion lets the host choose between 8 kHz and 16 kHz at runtime.
+#define ATVV_CODECS_SUPPORTED  ATVV_CAPS_SUPP_CODEC_ADPCM_8_KHZ_16KHZ
+#else
 #define ATVV_CODECS_SUPPORTED  ATVV_CAPS_SUPP_CODEC_ADPCM_8KHZ
+#endif
 #else
 #error ATVV only supports ADPCM codec
 #endif /* CONFIG_AUDIO_CODEC == CONFIG_AUDIO_CODEC_ADPCM */
@@ -0,0 +1,370 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ble_conn_params.h"
+#include "nrf_sdh_ble.h"
+#include "app_debug.h"
+#include "app_timer.h"
+#include "app_util.h"
+
+#include "m_coms_ble_conn_policy.h"
+#include "resources.h"
+#include "sr3_config.h"
+
+#if CONFIG_CONN_POLICY_ENABLED
+
+#define NRF_LOG_MODULE_NAME m_coms_ble_conn_policy
+#define NRF_LOG_LEVEL CONFIG_BLE_CONN_POLICY_LOG_LEVEL
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+/**@brief Check that the supervision time-out is long enough for the given parameters.
+ *
+ * @details The time-out has to be larger than (1 + slave latency) * max. connection interval * 2.
+ *          Both sides are expressed in 0.25 ms units.
+ */
+#define CONN_POLICY_SUP_TIMEOUT_OK(_max_interval, _slave_latency) \
+    ((4u * (CONFIG_CONN_SUP_TIMEOUT_MS)) > (10u * (1u + (_slave_latency)) * (_max_interval)))
+
+STATIC_ASSERT(CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL <= CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL);
+STATIC_ASSERT(CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL <= CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL);
+STATIC_ASSERT(CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL <= CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL);
+STATIC_ASSERT(CONN_POLICY_SUP_TIMEOUT_OK(CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL, CONFIG_CONN_POLICY_AIR_MOUSE_SLAVE_LATENCY));
+STATIC_ASSERT(CONN_POLICY_SUP_TIMEOUT_OK(CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL, CONFIG_CONN_POLICY_HID_VOICE_SLAVE_LATENCY));
+STATIC_ASSERT(CONN_POLICY_SUP_TIMEOUT_OK(CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL, CONFIG_CONN_POLICY_ATVV_VOICE_SLAVE_LATENCY));
+
+/**@brief Connection parameters requested for a given traffic type. */
+typedef struct
+{
+    ble_gap_conn_params_t   conn_params;    /**< Requested connection parameters. */
+    bool                    phy_2mbps;      /**< True if 2 Mbps PHY should be requested. */
+    const char             *p_name;         /**< Traffic type name used in logs. */
+} m_coms_ble_conn_policy_profile_t;
+
+static m_coms_ble_conn_policy_profile_t s_profiles[M_COMS_BLE_TRAFFIC_COUNT] =
+{
+    [M_COMS_BLE_TRAFFIC_IDLE] =
+    {
+        // Filled in by m_coms_ble_conn_policy_init().
+        .phy_2mbps  = false,
+        .p_name     = "idle",
+    },
+    [M_COMS_BLE_TRAFFIC_AIR_MOUSE] =
+    {
+        .conn_params =
+        {
+            .min_conn_interval  = CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL,
+            .max_conn_interval  = CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL,
+            .slave_latency      = CONFIG_CONN_POLICY_AIR_MOUSE_SLAVE_LATENCY,
+            .conn_sup_timeout   = CONFIG_CONN_SUP_TIMEOUT,
+        },
+        .phy_2mbps  = (CONFIG_CONN_POLICY_AIR_MOUSE_PHY_2MBPS != 0),
+        .p_name     = "air mouse",
+    },
+    [M_COMS_BLE_TRAFFIC_HID_VOICE] =
+    {
+        .conn_params =
+        {
+            .min_conn_interval  = CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL,
+            .max_conn_interval  = CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL,
+            .slave_latency      = CONFIG_CONN_POLICY_HID_VOICE_SLAVE_LATENCY,
+            .conn_sup_timeout   = CONFIG_CONN_SUP_TIMEOUT,
+        },
+        .phy_2mbps  = (CONFIG_CONN_POLICY_HID_VOICE_PHY_2MBPS != 0),
+        .p_name     = "HID voice",
+    },
+    [M_COMS_BLE_TRAFFIC_ATVV_VOICE] =
+    {
+        .conn_params =
+        {
+            .min_conn_interval  = CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL,
+            .max_conn_interval  = CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL,
+            .slave_latency      = CONFIG_CONN_POLICY_ATVV_VOICE_SLAVE_LATENCY,
+            .conn_sup_timeout   = CONFIG_CONN_SUP_TIMEOUT,
+        },
+        .phy_2mbps  = (CONFIG_CONN_POLICY_ATVV_VOICE_PHY_2MBPS != 0),
+        .p_name     = "ATVV voice",
+    },
+};
+
+APP_TIMER_DEF(s_downgrade_timer);                       /**< Delays switching to less demanding parameters. */
+
+static uint16_t             s_conn_handle;              /**< Handle of the current connection. */
+static ble_gap_conn_params_t s_conn_params;             /**< Parameters negotiated on the current connection. */
+static bool                 s_conn_params_pending;      /**< True if the Connection Parameters module is negotiating s_requested_traffic parameters. */
+static m_coms_ble_traffic_t s_requested_traffic;        /**< Traffic type whose parameters the Connection Parameters module prefers. */
+static uint32_t             s_active_traffic;           /**< Bit mask of active traffic types. */
+static m_coms_ble_traffic_t s_applied_traffic;          /**< Traffic type whose parameters were requested last. */
+static bool                 s_downgrade_pending;        /**< True if the downgrade timer is running. */
+static bool                 s_phy_2mbps_requested;      /**< True if 2 Mbps PHY has been requested on the current connection. */
+
+/**@brief Get the most demanding active traffic type. */
+static m_coms_ble_traffic_t m_coms_ble_conn_policy_target(void)
+{
+    m_coms_ble_traffic_t traffic = (m_coms_ble_traffic_t)(M_COMS_BLE_TRAFFIC_COUNT - 1);
+
+    while ((traffic != M_COMS_BLE_TRAFFIC_IDLE) && !(s_active_traffic & (1ul << traffic)))
+    {
+        traffic--;
+    }
+
+    return traffic;
+}
+
+/**@brief Check if the negotiated parameters already satisfy the given ones.
+ *
+ * @param[in]   p_params    Requested connection parameters.
+ *
+ * @return      True if the connection interval is within the requested range and the slave latency matches.
+ *              The negotiated interval is reported in both interval fields.
+ */
+static bool m_coms_ble_conn_policy_params_ok(const ble_gap_conn_params_t *p_params)
+{
+    return ((s_conn_params.max_conn_interval >= p_params->min_conn_interval) &&
+            (s_conn_params.max_conn_interval <= p_params->max_conn_interval) &&
+            (s_conn_params.slave_latency == p_params->slave_latency));
+}
+
+/**@brief Request the parameters assigned to the given traffic type.
+ *
+ * @param[in]   traffic Traffic type.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code.
+ */
+static ret_code_t m_coms_ble_conn_policy_apply(m_coms_ble_traffic_t traffic)
+{
+    const m_coms_ble_conn_policy_profile_t *p_profile = &s_profiles[traffic];
+    ret_code_t status;
+
+    s_applied_traffic = traffic;
+
+    if (s_conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        // Parameters will be requested when the connection is established.
+        return NRF_SUCCESS;
+    }
+
+    if (m_coms_ble_conn_policy_params_ok(&p_profile->conn_params))
+    {
+        NRF_LOG_DEBUG("Negotiated parameters suit %s traffic.", (uint32_t)(p_profile->p_name));
+    }
+    else if ((traffic == s_requested_traffic) && s_conn_params_pending)
+    {
+        // The Connection Parameters module is already negotiating these parameters. Do not race with it.
+        NRF_LOG_DEBUG("Negotiation of %s parameters in progress.", (uint32_t)(p_profile->p_name));
+    }
+    else
+    {
+        NRF_LOG_INFO("Requesting %s parameters (interval: %u-%u, latency: %u).",
+                     (uint32_t)(p_profile->p_name),
+                     p_profile->conn_params.min_conn_interval,
+                     p_profile->conn_params.max_conn_interval,
+                     p_profile->conn_params.slave_latency);
+
+        // The Connection Parameters module keeps renegotiating until the new parameters are accepted,
+        // so a busy procedure or a link that is going down is not an error here.
+        status = ble_conn_params_change_conn_params(s_conn_handle,
+                                                    (ble_gap_conn_params_t *)&p_profile->conn_params);
+        if ((status != NRF_SUCCESS) &&
+            (status != NRF_ERROR_BUSY) &&
+            (status != NRF_ERROR_INVALID_STATE) &&
+            (status != BLE_ERROR_INVALID_CONN_HANDLE))
+        {
+            return status;
+        }
+
+        s_requested_traffic     = traffic;
+        s_conn_params_pending   = true;
+    }
+
+#if CONFIG_PHY_TX_2MBPS && CONFIG_PHY_RX_2MBPS
+    // 2 Mbps PHY is kept until the link is closed: it only shortens the time on air.
+    if (p_profile->phy_2mbps && !s_phy_2mbps_requested)
+    {
+        const ble_gap_phys_t phys =
+        {
+            .tx_phys = BLE_GAP_PHY_2MBPS,
+            .rx_phys = BLE_GAP_PHY_2MBPS,
+        };
+
+        status = sd_ble_gap_phy_update(s_conn_handle, &phys);
+        if (status == NRF_SUCCESS)
+        {
+            s_phy_2mbps_requested = true;
+        }
+        else if ((status != NRF_ERROR_BUSY) &&
+                 (status != NRF_ERROR_INVALID_STATE) &&
+                 (status != BLE_ERROR_INVALID_CONN_HANDLE))
+        {
+            return status;
+        }
+    }
+#endif
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Re-evaluate the policy after a traffic change. */
+static ret_code_t m_coms_ble_conn_policy_update(void)
+{
+    m_coms_ble_traffic_t target = m_coms_ble_conn_policy_target();
+
+    if ((target >= s_applied_traffic) && s_downgrade_pending)
+    {
+        APP_ERROR_CHECK(app_timer_stop(s_downgrade_timer));
+        s_downgrade_pending = false;
+    }
+
+    if (target > s_applied_traffic)
+    {
+        return m_coms_ble_conn_policy_apply(target);
+    }
+
+    if ((target < s_applied_traffic) && !s_downgrade_pending)
+    {
+        if ((CONFIG_CONN_POLICY_DOWNGRADE_DELAY_MS == 0) || (s_conn_handle == BLE_CONN_HANDLE_INVALID))
+        {
+            return m_coms_ble_conn_policy_apply(target);
+        }
+
+        s_downgrade_pending = true;
+        return app_timer_start(s_downgrade_timer,
+                               APP_TIMER_TICKS(CONFIG_CONN_POLICY_DOWNGRADE_DELAY_MS),
+                               NULL);
+    }
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Downgrade timer handler. */
+static void m_coms_ble_conn_policy_downgrade_timeout(void *p_context)
+{
+    s_downgrade_pending = false;
+    APP_ERROR_CHECK(m_coms_ble_conn_policy_apply(m_coms_ble_conn_policy_target()));
+}
+
+/**@brief BLE Stack event handler.
+ *
+ * @param[in]   p_ble_evt   Bluetooth stack event.
+ */
+static void m_coms_ble_conn_policy_on_ble_evt(ble_evt_t const * p_ble_evt, void *p_context)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            s_conn_handle           = p_ble_evt->evt.gap_evt.conn_handle;
+            s_conn_params           = p_ble_evt->evt.gap_evt.params.connected.conn_params;
+            s_phy_2mbps_requested   = false;
+
+            // The Connection Parameters module negotiates its preferred parameters on a new link by itself.
+            s_conn_params_pending   = true;
+
+            // Parameters of the previous link do not matter: start from the current traffic.
+            APP_ERROR_CHECK(m_coms_ble_conn_policy_apply(m_coms_ble_conn_policy_target()));
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            s_conn_params           = p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params;
+            s_conn_params_pending   = false;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            s_conn_handle           = BLE_CONN_HANDLE_INVALID;
+            s_conn_params_pending   = false;
+
+            if (s_downgrade_pending)
+            {
+                APP_ERROR_CHECK(app_timer_stop(s_downgrade_timer));
+                s_downgrade_pending = false;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+NRF_SDH_BLE_OBSERVER(m_coms_ble_conn_policy_observer, BLE_OBSERVER_PRIORITY_LOW, m_coms_ble_conn_policy_on_ble_evt, NULL);
+
+ret_code_t m_coms_ble_conn_policy_traffic_set(m_coms_ble_traffic_t traffic, bool active)
+{
+    if ((traffic == M_COMS_BLE_TRAFFIC_IDLE) || (traffic >= M_COMS_BLE_TRAFFIC_COUNT))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (active)
+    {
+        s_active_traffic |= (1ul << traffic);
+    }
+    else
+    {
+        s_active_traffic &= ~(1ul << traffic);
+    }
+
+    return m_coms_ble_conn_policy_update();
+}
+
+ret_code_t m_coms_ble_conn_policy_init(const ble_gap_conn_params_t *p_idle_params)
+{
+    if (p_idle_params == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    s_profiles[M_COMS_BLE_TRAFFIC_IDLE].conn_params = *p_idle_params;
+
+    s_conn_handle           = BLE_CONN_HANDLE_INVALID;
+    s_active_traffic        = (1ul << M_COMS_BLE_TRAFFIC_IDLE);
+    s_applied_traffic       = M_COMS_BLE_TRAFFIC_IDLE;
+    s_requested_traffic     = M_COMS_BLE_TRAFFIC_IDLE;
+    s_conn_params_pending   = false;
+    s_downgrade_pending     = false;
+    s_phy_2mbps_requested   = false;
+
+    return app_timer_create(&s_downgrade_timer,
+                            APP_TIMER_MODE_SINGLE_SHOT,
+                            m_coms_ble_conn_policy_downgrade_timeout);
+}
+
+#endif /* CONFIG_CONN_POLICY_ENABLED */
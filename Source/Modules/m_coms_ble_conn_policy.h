@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/**
+ * @defgroup MOD_COMS_BLE_CONN_POLICY BLE connection parameter policy submodule
+ * @ingroup ble
+ * @{
+ * @brief This module selects the connection parameters that match the current traffic.
+ *
+ * @details Each traffic type has its own set of connection parameters. When several traffic types
+ *          are active at the same time, the most demanding one selects the parameters. Upgrades are
+ *          requested immediately, downgrades are delayed to avoid renegotiation on short pauses.
+ */
+#ifndef __M_COMS_BLE_CONN_POLICY_H__
+#define __M_COMS_BLE_CONN_POLICY_H__
+
+#include <stdbool.h>
+
+#include "ble_gap.h"
+#include "sdk_errors.h"
+
+/**@brief Traffic types, ordered from the least to the most demanding. */
+typedef enum
+{
+    M_COMS_BLE_TRAFFIC_IDLE,        /**< Only keys are in use. */
+    M_COMS_BLE_TRAFFIC_AIR_MOUSE,   /**< Gyroscope-driven pointer motion is active. */
+    M_COMS_BLE_TRAFFIC_HID_VOICE,   /**< Audio is streamed over the HID service. */
+    M_COMS_BLE_TRAFFIC_ATVV_VOICE,  /**< Audio is streamed over the ATVV service. */
+    M_COMS_BLE_TRAFFIC_COUNT
+} m_coms_ble_traffic_t;
+
+/**@brief Function for marking a traffic type as active or inactive.
+ *
+ * @param[in]   traffic Traffic type. M_COMS_BLE_TRAFFIC_IDLE is always active and cannot be changed.
+ * @param[in]   active  True if the traffic type has started, false if it has ended.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_coms_ble_conn_policy_traffic_set(m_coms_ble_traffic_t traffic, bool active);
+
+/**@brief Function for initializing the connection parameter policy.
+ *
+ * @param[in]   p_idle_params   Connection parameters used when only keys are in use.
+ *
+ * @return      NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_coms_ble_conn_policy_init(const ble_gap_conn_params_t *p_idle_params);
+
+#endif /* __M_COMS_BLE_CONN_POLICY_H__ */
+
+/** @} */
@@ -411,7 +411,31 @@ uint32_t m_coms_ble_hid_feature_report_set(uint8_t   p_interface_idx,
                                           uint8_t * p_data,
                                           uint16_t   p_len)
 {
-    return NRF_ERROR_NOT_SUPPORTED;
+    ble_gatts_value_t   gatts_value;
+    ble_hids_t const  * p_hids;
+
+    if (p_interface_idx >= s_hid_db->report_maps_size)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_hids = s_hid_db->report_maps[p_interface_idx].interface;
+
+    if (p_report_idx >= p_hids->feature_rep_count)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&gatts_value, 0, sizeof(gatts_value));
+
+    gatts_value.len     = p_len;
+    gatts_value.offset  = 0;
+    gatts_value.p_value = p_data;
+
+    // The feature report value is stored in the GATT table, so it is also valid before connection.
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_hids->feature_rep_array[p_report_idx].char_handles.value_handle,
+                                  &gatts_value);
 }
 
 static void m_coms_ble_hid_on_ble_evt(ble_evt_t const * p_ble_evt, void *p_context)
@@ -0,0 +1,637 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include <string.h>
+
+#include "app_timer.h"
+#include "app_util.h"
+#include "fds.h"
+#include "nrf_error.h"
+#include "nrf_pwr_mgmt.h"
+#include "peer_manager.h"
+
+#include "m_coms_ble_reconn.h"
+#include "resources.h"
+#include "sr3_config.h"
+
+#if CONFIG_ADV_RECONN_ENABLED
+#define NRF_LOG_MODULE_NAME m_coms_ble_reconn
+#define NRF_LOG_LEVEL CONFIG_BLE_RECONN_LOG_LEVEL
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+#define M_COMS_BLE_RECONN_FILE_ID       0x5243  // "RC"
+#define M_COMS_BLE_RECONN_RECORD_KEY    0x5354  // "ST"
+
+// Check if we can cast FDS error codes to SDK error codes.
+STATIC_ASSERT(FDS_SUCCESS == NRF_SUCCESS);
+
+#define RECONN_WEIGHT_ONE           256     /**< History weight of a single connection. */
+#define RECONN_WEIGHT_PRIOR         64      /**< Weight given to each host regardless of its history. */
+#define RECONN_WEIGHT_DECAY_SHIFT   3       /**< History weights decay by 1/8 with each connection. */
+#define RECONN_TRIES_MAX            32      /**< Method statistics are halved when this number of tries is reached. */
+
+/* Time spent on a failed attempt [ms]. Must match the advertising module. */
+#define RECONN_DIRECTED_DURATION    (ROUNDED_DIV(1000ul * CONFIG_ADV_TIMEOUT, 1280) * 1280ul)
+#define RECONN_WHITELIST_DURATION   (1000ul * CONFIG_ADV_TIMEOUT)
+
+/**@brief Statistics of a single method used with a host. */
+typedef struct
+{
+    uint8_t     tries;          /**< Attempts made while the host was the one to connect to. */
+    uint8_t     hits;           /**< Attempts which led to a connection. */
+    uint16_t    latency;        /**< Average time from the start of the attempt to the connection [ms]. */
+} m_coms_ble_reconn_method_stats_t;
+
+/**@brief Statistics of a bonded host. */
+typedef struct
+{
+    pm_peer_id_t                        peer_id;
+    uint16_t                            weight;         /**< Decaying number of connections, in RECONN_WEIGHT_ONE units. */
+    m_coms_ble_reconn_method_stats_t    method[M_COMS_BLE_RECONN_METHODS];
+} m_coms_ble_reconn_peer_t;
+
+/**@brief Assumed statistics of a host never seen before. Directed advertising connects faster. */
+static const m_coms_ble_reconn_method_stats_t s_method_prior[M_COMS_BLE_RECONN_METHODS] =
+{
+    [M_COMS_BLE_RECONN_DIRECTED]    = { .tries = 4, .hits = 3, .latency = 100 },
+    [M_COMS_BLE_RECONN_WHITELIST]   = { .tries = 4, .hits = 3, .latency = 300 },
+};
+
+static const uint32_t s_method_duration[M_COMS_BLE_RECONN_METHODS] =
+{
+    [M_COMS_BLE_RECONN_DIRECTED]    = RECONN_DIRECTED_DURATION,
+    [M_COMS_BLE_RECONN_WHITELIST]   = RECONN_WHITELIST_DURATION,
+};
+
+// Statistics are stored in flash as they are, so their size has to be multiple of word size.
+STATIC_ASSERT((sizeof(m_coms_ble_reconn_peer_t[CONFIG_MAX_BONDS]) % sizeof(uint32_t)) == 0);
+
+__ALIGN(4) static m_coms_ble_reconn_peer_t  s_peers[CONFIG_MAX_BONDS];
+static bool                         s_peers_changed;    /**< Statistics in RAM differ from the ones in flash. */
+#if CONFIG_PWR_MGMT_ENABLED
+static bool                         s_peers_storing;    /**< Statistics are being written to flash before shutdown. */
+#endif
+
+static m_coms_ble_reconn_attempt_t  s_plan[M_COMS_BLE_RECONN_MAX_ATTEMPTS];
+static unsigned int                 s_plan_len;
+static unsigned int                 s_attempt;
+static uint32_t                     s_attempt_timestamp;
+static bool                         s_session_open;     /**< A plan has been built and no connection has been made yet. */
+static bool                         s_explore;          /**< The last plan failed: try fallback methods as well. */
+
+/**@brief Find statistics of the given host. */
+static m_coms_ble_reconn_peer_t * m_coms_ble_reconn_peer_find(pm_peer_id_t peer_id)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(s_peers); i++)
+    {
+        if (s_peers[i].peer_id == peer_id)
+        {
+            return &s_peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Find statistics of the given host, create empty ones if it is not known yet. */
+static m_coms_ble_reconn_peer_t * m_coms_ble_reconn_peer_get(pm_peer_id_t peer_id)
+{
+    m_coms_ble_reconn_peer_t *p_peer = m_coms_ble_reconn_peer_find(peer_id);
+
+    if (p_peer == NULL)
+    {
+        // Use a free entry or the one with the least history.
+        p_peer = &s_peers[0];
+        for (size_t i = 0; i < ARRAY_SIZE(s_peers); i++)
+        {
+            if (s_peers[i].peer_id == PM_PEER_ID_INVALID)
+            {
+                p_peer = &s_peers[i];
+                break;
+            }
+
+            if (s_peers[i].weight < p_peer->weight)
+            {
+                p_peer = &s_peers[i];
+            }
+        }
+
+        memset(p_peer, 0, sizeof(*p_peer));
+        p_peer->peer_id = peer_id;
+    }
+
+    return p_peer;
+}
+
+/**@brief Get the probability of success of the given method (Q8). */
+static uint32_t m_coms_ble_reconn_hit_rate(const m_coms_ble_reconn_peer_t *p_peer, m_coms_ble_reconn_method_t method)
+{
+    uint32_t hits  = p_peer->method[method].hits  + s_method_prior[method].hits;
+    uint32_t tries = p_peer->method[method].tries + s_method_prior[method].tries;
+
+    return (hits << 8) / tries;
+}
+
+/**@brief Get the average connection latency of the given method [ms]. */
+static uint32_t m_coms_ble_reconn_latency(const m_coms_ble_reconn_peer_t *p_peer, m_coms_ble_reconn_method_t method)
+{
+    return (p_peer->method[method].hits != 0) ? p_peer->method[method].latency : s_method_prior[method].latency;
+}
+
+/**@brief Update statistics of the given method. */
+static void m_coms_ble_reconn_method_update(m_coms_ble_reconn_method_stats_t *p_stats, bool hit, uint32_t latency)
+{
+    if (p_stats->tries >= RECONN_TRIES_MAX)
+    {
+        // Forget older results, so that the statistics follow changes in the household.
+        p_stats->tries /= 2;
+        p_stats->hits  /= 2;
+    }
+
+    p_stats->tries += 1;
+
+    if (hit)
+    {
+        latency = MIN(latency, UINT16_MAX);
+
+        if (p_stats->hits == 0)
+        {
+            p_stats->latency = latency;
+        }
+        else
+        {
+            // Exponential average, the new sample weighs 1/4.
+            p_stats->latency = (3 * (uint32_t)p_stats->latency + latency) / 4;
+        }
+
+        p_stats->hits += 1;
+    }
+}
+
+/**@brief Account a connection to the given host. */
+static void m_coms_ble_reconn_peer_connected(pm_peer_id_t peer_id)
+{
+    m_coms_ble_reconn_peer_t *p_peer = m_coms_ble_reconn_peer_get(peer_id);
+
+    for (size_t i = 0; i < ARRAY_SIZE(s_peers); i++)
+    {
+        s_peers[i].weight -= s_peers[i].weight >> RECONN_WEIGHT_DECAY_SHIFT;
+    }
+
+    p_peer->weight += RECONN_WEIGHT_ONE;
+    s_peers_changed = true;
+
+    NRF_LOG_DEBUG("Peer %d connected: weight %u", peer_id, p_peer->weight);
+}
+
+static void m_coms_ble_reconn_pm_evt_handler(const pm_evt_t *p_evt)
+{
+    m_coms_ble_reconn_peer_t *p_peer;
+
+    switch (p_evt->evt_id)
+    {
+        case PM_EVT_BONDED_PEER_CONNECTED:
+            m_coms_ble_reconn_peer_connected(p_evt->peer_id);
+            break;
+
+        case PM_EVT_CONN_SEC_SUCCEEDED:
+            if (p_evt->params.conn_sec_succeeded.procedure == PM_LINK_SECURED_PROCEDURE_BONDING)
+            {
+                // A new bond: start with clean statistics.
+                p_peer = m_coms_ble_reconn_peer_find(p_evt->peer_id);
+                if (p_peer != NULL)
+                {
+                    p_peer->peer_id = PM_PEER_ID_INVALID;
+                }
+
+                m_coms_ble_reconn_peer_connected(p_evt->peer_id);
+            }
+            break;
+
+        case PM_EVT_PEER_DELETE_SUCCEEDED:
+            p_peer = m_coms_ble_reconn_peer_find(p_evt->peer_id);
+            if (p_peer != NULL)
+            {
+                p_peer->peer_id = PM_PEER_ID_INVALID;
+                s_peers_changed = true;
+            }
+            break;
+
+        case PM_EVT_PEERS_DELETE_SUCCEEDED:
+            for (size_t i = 0; i < ARRAY_SIZE(s_peers); i++)
+            {
+                s_peers[i].peer_id = PM_PEER_ID_INVALID;
+            }
+            s_peers_changed = true;
+            break;
+
+        default:
+            /* Ignore */
+            break;
+    }
+}
+
+unsigned int m_coms_ble_reconn_plan(const pm_peer_id_t *p_peer_ids,
+                                    unsigned int        peers_num,
+                                    unsigned int        max_peers,
+                                    bool                directed_allowed)
+{
+    m_coms_ble_reconn_peer_t *p_cand[CONFIG_MAX_BONDS];
+    uint32_t mass[CONFIG_MAX_BONDS];
+    uint8_t methods[CONFIG_MAX_BONDS];
+    m_coms_ble_reconn_method_t primary[CONFIG_MAX_BONDS];
+    uint32_t total_mass;
+    unsigned int n;
+
+    if (s_session_open)
+    {
+        // The previous plan did not lead to a connection. Maybe the preferred method does not work.
+        s_explore = true;
+    }
+
+    /*
+     * Select the hosts which are the most likely to accept the connection.
+     * Go from the most recently connected host (the highest rank), so that it wins ties.
+     */
+    n = 0;
+    for (size_t i = peers_num; i > 0; i--)
+    {
+        m_coms_ble_reconn_peer_t *p_peer = m_coms_ble_reconn_peer_get(p_peer_ids[i - 1]);
+        size_t k;
+
+        // Insertion sort by weight, the highest first.
+        for (k = MIN(n, max_peers); k > 0; k--)
+        {
+            if (p_cand[k - 1]->weight >= p_peer->weight)
+            {
+                break;
+            }
+
+            if (k < max_peers)
+            {
+                p_cand[k] = p_cand[k - 1];
+            }
+        }
+
+        if (k < max_peers)
+        {
+            p_cand[k] = p_peer;
+            n = MIN(n + 1, max_peers);
+        }
+    }
+
+    /*
+     * Select the methods to use with each host. Always use the one with the best chance per time spent.
+     * Use the other one as well if the first one often fails with the given host. It is tried after
+     * the first one, so that a failure of the first one is noticed when the other one succeeds.
+     */
+    total_mass = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        mass[i]     = p_cand[i]->weight + RECONN_WEIGHT_PRIOR;
+        total_mass += mass[i];
+        methods[i]  = (1u << M_COMS_BLE_RECONN_WHITELIST);
+        primary[i]  = M_COMS_BLE_RECONN_WHITELIST;
+
+        if (directed_allowed)
+        {
+            m_coms_ble_reconn_method_t best = M_COMS_BLE_RECONN_DIRECTED;
+            m_coms_ble_reconn_method_t other = M_COMS_BLE_RECONN_WHITELIST;
+
+            if ((m_coms_ble_reconn_hit_rate(p_cand[i], other) * m_coms_ble_reconn_latency(p_cand[i], best)) >
+                (m_coms_ble_reconn_hit_rate(p_cand[i], best) * m_coms_ble_reconn_latency(p_cand[i], other)))
+            {
+                best  = M_COMS_BLE_RECONN_WHITELIST;
+                other = M_COMS_BLE_RECONN_DIRECTED;
+            }
+
+            methods[i] = (1u << best);
+            primary[i] = best;
+            if (s_explore ||
+                (m_coms_ble_reconn_hit_rate(p_cand[i], best) < ((CONFIG_ADV_RECONN_FALLBACK_LEVEL << 8) / 100)))
+            {
+                methods[i] |= (1u << other);
+            }
+        }
+    }
+
+    /*
+     * Order the attempts. Searching for the host, the expected time is minimal when the attempts are
+     * sorted by the probability of success divided by the expected time spent on them. After each
+     * attempt the probability of the targeted host is decreased, as if the attempt had failed.
+     */
+    s_plan_len = 0;
+    while (s_plan_len < ARRAY_SIZE(s_plan))
+    {
+        uint32_t best_q     = 0;
+        uint32_t best_cost  = 1;
+        size_t   best_cand  = n;
+        m_coms_ble_reconn_method_t best_method = M_COMS_BLE_RECONN_DIRECTED;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            for (m_coms_ble_reconn_method_t m = M_COMS_BLE_RECONN_DIRECTED; m < M_COMS_BLE_RECONN_METHODS; m++)
+            {
+                uint32_t q, cost;
+
+                if (((methods[i] & (1u << m)) == 0) ||
+                    ((m != primary[i]) && ((methods[i] & (1u << primary[i])) != 0)))
+                {
+                    continue;
+                }
+
+                // Probability of success (Q16) and expected time spent [ms].
+                q    = (uint32_t)(((uint64_t)mass[i] * m_coms_ble_reconn_hit_rate(p_cand[i], m) << 8) / total_mass);
+                cost = (uint32_t)(((uint64_t)q * m_coms_ble_reconn_latency(p_cand[i], m) +
+                                   (uint64_t)(0x10000 - q) * s_method_duration[m]) >> 16);
+                cost = MAX(cost, 1);
+
+                if ((best_cand == n) || ((uint64_t)q * best_cost > (uint64_t)best_q * cost))
+                {
+                    best_q      = q;
+                    best_cost   = cost;
+                    best_cand   = i;
+                    best_method = m;
+                }
+            }
+        }
+
+        if (best_cand == n)
+        {
+            break;
+        }
+
+        s_plan[s_plan_len].peer_id  = p_cand[best_cand]->peer_id;
+        s_plan[s_plan_len].method   = best_method;
+        s_plan_len                 += 1;
+
+        methods[best_cand] &= ~(1u << best_method);
+
+        total_mass      -= mass[best_cand];
+        mass[best_cand]  = MAX(1, (mass[best_cand] * (256 - m_coms_ble_reconn_hit_rate(p_cand[best_cand], best_method))) >> 8);
+        total_mass      += mass[best_cand];
+    }
+
+    NRF_LOG_DEBUG("Reconnection plan:");
+    for (size_t i = 0; i < s_plan_len; i++)
+    {
+        NRF_LOG_DEBUG("\t- Peer %d: %s", s_plan[i].peer_id,
+                      (uint32_t)((s_plan[i].method == M_COMS_BLE_RECONN_DIRECTED) ? "directed" : "whitelist"));
+    }
+
+    s_attempt       = 0;
+    s_session_open  = (s_plan_len != 0);
+
+    return s_plan_len;
+}
+
+ret_code_t m_coms_ble_reconn_attempt_get(unsigned int index, m_coms_ble_reconn_attempt_t *p_attempt)
+{
+    if (index >= s_plan_len)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *p_attempt = s_plan[index];
+
+    return NRF_SUCCESS;
+}
+
+void m_coms_ble_reconn_attempt_started(unsigned int index)
+{
+    s_attempt           = index;
+    s_attempt_timestamp = app_timer_cnt_get();
+}
+
+void m_coms_ble_reconn_attempt_succeeded(void)
+{
+    m_coms_ble_reconn_attempt_t *p_attempt = &s_plan[s_attempt];
+    m_coms_ble_reconn_peer_t *p_peer;
+    uint32_t latency;
+
+    if (!s_session_open)
+    {
+        return;
+    }
+
+    s_session_open  = false;
+    s_explore       = false;
+
+    latency = app_timer_cnt_diff_compute(app_timer_cnt_get(), s_attempt_timestamp);
+    latency = ROUNDED_DIV((uint64_t)latency * 1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1), APP_TIMER_CLOCK_FREQ);
+
+    p_peer = m_coms_ble_reconn_peer_get(p_attempt->peer_id);
+
+    // Earlier attempts targeted at this host failed although it was there.
+    for (size_t i = 0; i < s_attempt; i++)
+    {
+        if (s_plan[i].peer_id == p_attempt->peer_id)
+        {
+            m_coms_ble_reconn_method_update(&p_peer->method[s_plan[i].method], false, 0);
+        }
+    }
+
+    m_coms_ble_reconn_method_update(&p_peer->method[p_attempt->method], true, latency);
+    s_peers_changed = true;
+
+    NRF_LOG_INFO("Reconnected to peer %d in %u ms (attempt %u)", p_attempt->peer_id, latency, s_attempt + 1);
+}
+
+/**@brief Load statistics stored before the last shutdown. */
+static void m_coms_ble_reconn_file_read(void)
+{
+    fds_find_token_t ftok = { 0 };
+    fds_flash_record_t record;
+    fds_record_desc_t rdesc;
+
+    if (fds_record_find(M_COMS_BLE_RECONN_FILE_ID, M_COMS_BLE_RECONN_RECORD_KEY, &rdesc, &ftok) != FDS_SUCCESS)
+    {
+        return;
+    }
+
+    if (fds_record_open(&rdesc, &record) != FDS_SUCCESS)
+    {
+        return;
+    }
+
+    // Ignore statistics stored by firmware with a different configuration.
+    if ((record.p_header->length_words * sizeof(uint32_t)) == sizeof(s_peers))
+    {
+        memcpy(s_peers, record.p_data, sizeof(s_peers));
+        NRF_LOG_DEBUG("Statistics loaded.");
+    }
+
+    APP_ERROR_CHECK(fds_record_close(&rdesc));
+}
+
+/**@brief Store statistics, so that they survive the shutdown. */
+static ret_code_t m_coms_ble_reconn_file_write(void)
+{
+    fds_record_t record =
+    {
+        .file_id            = M_COMS_BLE_RECONN_FILE_ID,
+        .key                = M_COMS_BLE_RECONN_RECORD_KEY,
+        .data.p_data        = s_peers,
+        .data.length_words  = CEIL_DIV(sizeof(s_peers), sizeof(uint32_t)),
+    };
+
+    fds_find_token_t ftok = { 0 };
+    fds_record_desc_t rdesc;
+    ret_code_t status;
+
+    status = fds_record_find(M_COMS_BLE_RECONN_FILE_ID, M_COMS_BLE_RECONN_RECORD_KEY, &rdesc, &ftok);
+    switch (status)
+    {
+        case FDS_SUCCESS:
+            // Update existing record.
+            return fds_record_update(&rdesc, &record);
+
+        case FDS_ERR_NOT_FOUND:
+            // Create new file/record.
+            return fds_record_write(&rdesc, &record);
+
+        default:
+            return status;
+    }
+}
+
+static void m_coms_ble_reconn_fds_evt_handler(fds_evt_t const * const p_fds_evt)
+{
+    switch (p_fds_evt->id)
+    {
+        case FDS_EVT_INIT:
+            if (p_fds_evt->result == FDS_SUCCESS)
+            {
+                m_coms_ble_reconn_file_read();
+            }
+            break;
+
+#if CONFIG_PWR_MGMT_ENABLED
+        case FDS_EVT_WRITE:
+        case FDS_EVT_UPDATE:
+            if ((p_fds_evt->write.file_id == M_COMS_BLE_RECONN_FILE_ID) &&
+                (p_fds_evt->write.record_key == M_COMS_BLE_RECONN_RECORD_KEY) &&
+                s_peers_storing)
+            {
+                if (p_fds_evt->result != FDS_SUCCESS)
+                {
+                    NRF_LOG_WARNING("Statistics could not be stored!");
+                }
+
+                // Do not retry, the shutdown must not be blocked.
+                s_peers_storing = false;
+                s_peers_changed = false;
+                nrf_pwr_mgmt_shutdown(NRF_PWR_MGMT_SHUTDOWN_CONTINUE);
+            }
+            break;
+#endif /* CONFIG_PWR_MGMT_ENABLED */
+
+        default:
+            /* Ignore */
+            break;
+    }
+}
+
+ret_code_t m_coms_ble_reconn_init(void)
+{
+    ret_code_t status;
+
+    for (size_t i = 0; i < ARRAY_SIZE(s_peers); i++)
+    {
+        s_peers[i].peer_id = PM_PEER_ID_INVALID;
+    }
+
+    s_peers_changed = false;
+    s_plan_len      = 0;
+    s_session_open  = false;
+    s_explore       = false;
+
+    status = fds_register(m_coms_ble_reconn_fds_evt_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    // Peer Manager has already initialized the storage. If it has not finished, load on FDS_EVT_INIT.
+    m_coms_ble_reconn_file_read();
+
+    return pm_register(m_coms_ble_reconn_pm_evt_handler);
+}
+
+#if CONFIG_PWR_MGMT_ENABLED
+static bool m_coms_ble_reconn_shutdown(nrf_pwr_mgmt_evt_t event)
+{
+    ret_code_t status;
+
+    if (s_peers_storing)
+    {
+        // Wait for the flash operation.
+        return false;
+    }
+
+    if (!s_peers_changed)
+    {
+        return true;
+    }
+
+    status = m_coms_ble_reconn_file_write();
+    switch (status)
+    {
+        case FDS_SUCCESS:
+            s_peers_storing = true;
+            return false;
+
+        case FDS_ERR_NO_SPACE_IN_FLASH:
+            // Reclaim the space for the next time. The statistics gathered since the last shutdown are lost.
+            (void)fds_gc();
+            break;
+
+        default:
+            NRF_LOG_WARNING("Statistics could not be stored: %d", status);
+            break;
+    }
+
+    s_peers_changed = false;
+    return true;
+}
+NRF_PWR_MGMT_HANDLER_REGISTER(m_coms_ble_reconn_shutdown, SHUTDOWN_PRIORITY_EARLY);
+#endif /* CONFIG_PWR_MGMT_ENABLED */
+#endif /* CONFIG_ADV_RECONN_ENABLED */
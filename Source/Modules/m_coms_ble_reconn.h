@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+/** @file
+ *
+ * @defgroup MOD_COMS_BLE_RECONN BLE reconnection strategy
+ * @ingroup ble
+ * @{
+ * @brief This module decides in which order bonded hosts are targeted when the remote reconnects.
+ *
+ * @details The module learns how often each bonded host is the one the remote reconnects to,
+ *          how quickly each advertising method succeeds with it and how often directed advertising
+ *          is accepted by it. Based on these statistics, a reconnection plan is built which
+ *          minimizes the expected time from the start of advertising to the connection.
+ */
+#ifndef __M_COMS_BLE_RECONN_H__
+#define __M_COMS_BLE_RECONN_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "peer_manager.h"
+#include "sr3_config.h"
+
+/**@brief Reconnection methods. */
+typedef enum
+{
+    M_COMS_BLE_RECONN_DIRECTED,     /**< Directed advertising bursts targeted at the host. */
+    M_COMS_BLE_RECONN_WHITELIST,    /**< Undirected advertising with the host on the whitelist. */
+    M_COMS_BLE_RECONN_METHODS,      /**< Number of methods. */
+} m_coms_ble_reconn_method_t;
+
+/**@brief Single reconnection attempt. */
+typedef struct
+{
+    pm_peer_id_t                peer_id;    /**< Targeted host. */
+    m_coms_ble_reconn_method_t  method;     /**< Advertising method. */
+} m_coms_ble_reconn_attempt_t;
+
+/**@brief Maximum number of attempts in the reconnection plan. */
+#define M_COMS_BLE_RECONN_MAX_ATTEMPTS  (CONFIG_MAX_BONDS * M_COMS_BLE_RECONN_METHODS)
+
+/**@brief Function for initializing the module.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_coms_ble_reconn_init(void);
+
+/**@brief Function for building a new reconnection plan.
+ *
+ * @param[in]  p_peer_ids       Bonded hosts, sorted by rank (the least recently used one first).
+ * @param[in]  peers_num        Number of bonded hosts.
+ * @param[in]  max_peers        Maximum number of hosts to target.
+ * @param[in]  directed_allowed True if directed advertising can be used.
+ *
+ * @return Number of attempts in the plan.
+ */
+unsigned int m_coms_ble_reconn_plan(const pm_peer_id_t *p_peer_ids,
+                                    unsigned int        peers_num,
+                                    unsigned int        max_peers,
+                                    bool                directed_allowed);
+
+/**@brief Function for getting an attempt from the current reconnection plan.
+ *
+ * @param[in]  index        Attempt index.
+ * @param[out] p_attempt    Attempt.
+ *
+ * @return NRF_SUCCESS on success, NRF_ERROR_INVALID_PARAM if the index is out of the plan.
+ */
+ret_code_t m_coms_ble_reconn_attempt_get(unsigned int index, m_coms_ble_reconn_attempt_t *p_attempt);
+
+/**@brief Function for notifying the module that the given attempt of the plan has started.
+ *
+ * @param[in]  index        Attempt index.
+ */
+void m_coms_ble_reconn_attempt_started(unsigned int index);
+
+/**@brief Function for notifying the module that the current attempt has led to a connection. */
+void m_coms_ble_reconn_attempt_succeeded(void);
+
+#endif /* __M_COMS_BLE_RECONN_H__ */
+
+/** @} */
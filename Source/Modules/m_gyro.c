@@ -51,6 +51,7 @@
 #include "fds.h"
 
 #include "event_bus.h"
+#include "m_batt_meas.h"
 #include "m_gyro.h"
 
 #include "resources.h"
@@ -75,6 +76,15 @@ STATIC_ASSERT(FDS_SUCCESS == NRF_SUCCESS);
 STATIC_ASSERT((AIRMOTIONLIB_VERSION_MAJOR == 4) &&
               (AIRMOTIONLIB_VERSION_MINOR == 1));
 
+/*
+ * The Air Motion Library outputs whole deltas. To resolve motion finer than a report count, its gain is raised by
+ * M_GYRO_DELTA_SCALE, as far as the 8-bit gain allows, and the deltas are converted back to 1/HID_REL_POINTER_SCALE
+ * units. The remainder of the conversion is carried over to the next delta.
+ */
+#define M_GYRO_DELTA_SCALE  MIN(HID_REL_POINTER_SCALE, UINT8_MAX / MAX(CONFIG_GYRO_X_GAIN, CONFIG_GYRO_Y_GAIN))
+
+STATIC_ASSERT(M_GYRO_DELTA_SCALE >= 1);
+
 
 typedef struct
 {
@@ -95,16 +105,19 @@ APP_TIMER_DEF                                   (s_timer);
 static t_struct_AIR_MOTION_Init                 s_lInitParameters;
 static t_struct_AIR_MOTION_ProcessDeltaSamples  s_samples;
 static bool                                     s_gyro_enabled;
+static bool                                     s_gyro_suspended;
 static bool                                     s_gyro_calibration;
 static bool                                     s_gyro_click_detected;
 static bool                                     s_gyro_shutdown;
+static int32_t                                  s_gyro_x_remainder;
+static int32_t                                  s_gyro_y_remainder;
 __ALIGN(4) static m_gyro_file_t                 s_gyro_file;
 
 static void m_gyro_calibration_end(void)
 {
     s_gyro_calibration = false;
 
-    if (!s_gyro_enabled)
+    if (!s_gyro_enabled || s_gyro_suspended)
     {
         APP_ERROR_CHECK(m_gyro_stop());
     }
@@ -151,7 +164,7 @@ static ret_code_t m_gyro_file_read(m_gyro_file_t *file)
         return status;
     }
 
-    ASSERT((record.p_header->length_words * sizeof(uint32_t)) >= sizeof(*file))
+    ASSERT((record.p_header->length_words * sizeof(uint32_t)) >= sizeof(*file));
     memcpy(file, record.p_data, sizeof(*file));
 
     return fds_record_close(&rdesc);
@@ -189,6 +202,23 @@ static ret_code_t m_gyro_file_write(const m_gyro_file_t *file)
     }
 }
 
+/**@brief Convert a delta from the Air Motion Library to relative motion units.
+ *
+ * @param[in]     delta         Delta computed by the library.
+ * @param[in,out] p_remainder   Remainder of the previous conversions. Updated with the remainder of this one.
+ *
+ * @return Motion in 1/HID_REL_POINTER_SCALE of a report count.
+ */
+static int32_t m_gyro_delta_convert(int32_t delta, int32_t *p_remainder)
+{
+    int32_t motion = *p_remainder + delta * HID_REL_POINTER_SCALE;
+    int32_t result = motion / M_GYRO_DELTA_SCALE;
+
+    *p_remainder = motion - result * M_GYRO_DELTA_SCALE;
+
+    return result;
+}
+
 static void m_gyro_evt_handler(void *p_context)
 {
     t_struct_AIR_MOTION_ProcessDeltaSamples *p_samples = p_context;
@@ -248,16 +278,19 @@ static void m_gyro_evt_handler(void *p_context)
         }
     }
 
-    if (s_gyro_enabled && lProcessDeltaStatus.Status.IsDeltaComputed)
+    if (s_gyro_enabled && !s_gyro_suspended && lProcessDeltaStatus.Status.IsDeltaComputed)
     {
-        if (lProcessDeltaStatus.Delta.X != 0)
+        int32_t x = m_gyro_delta_convert(lProcessDeltaStatus.Delta.X, &s_gyro_x_remainder);
+        int32_t y = m_gyro_delta_convert(-lProcessDeltaStatus.Delta.Y, &s_gyro_y_remainder);
+
+        if (x != 0)
         {
-            event_send(EVT_REL_X, lProcessDeltaStatus.Delta.X);
+            event_send(EVT_REL_X, x);
         }
 
-        if (lProcessDeltaStatus.Delta.Y != 0)
+        if (y != 0)
         {
-            event_send(EVT_REL_Y, -lProcessDeltaStatus.Delta.Y);
+            event_send(EVT_REL_Y, y);
         }
     }
 }
@@ -303,10 +336,11 @@ ret_code_t m_gyro_init(bool force_calibration)
     }
 
     s_gyro_enabled                          = false;
+    s_gyro_suspended                        = false;
     s_gyro_calibration                      = false;
 
-    s_lInitParameters.DeltaGain.X           = CONFIG_GYRO_X_GAIN;
-    s_lInitParameters.DeltaGain.Y           = CONFIG_GYRO_Y_GAIN;
+    s_lInitParameters.DeltaGain.X           = CONFIG_GYRO_X_GAIN * M_GYRO_DELTA_SCALE;
+    s_lInitParameters.DeltaGain.Y           = CONFIG_GYRO_Y_GAIN * M_GYRO_DELTA_SCALE;
     s_lInitParameters.GyroStaticMaxNoise    = 4;
     s_lInitParameters.StaticSamples         = 100;
     s_lInitParameters.SwipeMinDist          = 64;
@@ -398,6 +432,10 @@ static ret_code_t m_gyro_start(void)
 {
     AIR_MOTION_Init(&s_lInitParameters);
 
+#if CONFIG_BATT_MEAS_ENABLED
+    m_batt_meas_load_set(M_BATT_MEAS_LOAD_GYRO, true);
+#endif
+
     return drv_gyro_enable();
 }
 
@@ -407,7 +445,10 @@ ret_code_t m_gyro_enable(void)
     NRF_LOG_INFO("Enabled");
 
     s_gyro_enabled          = true;
+    s_gyro_suspended        = false;
     s_gyro_click_detected   = false;
+    s_gyro_x_remainder      = 0;
+    s_gyro_y_remainder      = 0;
 
     if (s_gyro_calibration)
     {
@@ -427,6 +468,10 @@ static ret_code_t m_gyro_stop(void)
         return err_code;
     }
 
+#if CONFIG_BATT_MEAS_ENABLED
+    m_batt_meas_load_set(M_BATT_MEAS_LOAD_GYRO, false);
+#endif
+
     return drv_gyro_disable();
 }
 
@@ -442,9 +487,60 @@ ret_code_t m_gyro_disable(void)
         return NRF_SUCCESS;
     }
 
+    if (s_gyro_suspended)
+    {
+        s_gyro_suspended = false;
+        return NRF_SUCCESS;
+    }
+
     return m_gyro_stop();
 }
 
+ret_code_t m_gyro_suspend(void)
+{
+    ASSERT(s_gyro_enabled == true);
+
+    if (s_gyro_suspended)
+    {
+        return NRF_SUCCESS;
+    }
+
+    NRF_LOG_INFO("Suspended");
+    s_gyro_suspended = true;
+
+    if (s_gyro_calibration)
+    {
+        return NRF_SUCCESS;
+    }
+
+    return m_gyro_stop();
+}
+
+ret_code_t m_gyro_resume(void)
+{
+    ASSERT(s_gyro_enabled == true);
+
+    if (!s_gyro_suspended)
+    {
+        return NRF_SUCCESS;
+    }
+
+    NRF_LOG_INFO("Resumed");
+    s_gyro_suspended = false;
+
+    if (s_gyro_calibration)
+    {
+        return NRF_SUCCESS;
+    }
+
+#if CONFIG_BATT_MEAS_ENABLED
+    m_batt_meas_load_set(M_BATT_MEAS_LOAD_GYRO, true);
+#endif
+
+    // Skip AIR_MOTION_Init() - the library resumes with its filters and offsets intact.
+    return drv_gyro_enable();
+}
+
 ret_code_t m_gyro_calibrate(void)
 {
     if (s_gyro_calibration)
@@ -461,7 +557,7 @@ ret_code_t m_gyro_calibrate(void)
     NRF_LOG_INFO("Starting calibration...");
     s_gyro_calibration = true;
 
-    if (!s_gyro_enabled)
+    if (!s_gyro_enabled || s_gyro_suspended)
     {
         return m_gyro_start();
     }
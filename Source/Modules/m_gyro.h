@@ -70,6 +70,21 @@ ret_code_t m_gyro_enable(void);
  */
 ret_code_t m_gyro_disable(void);
 
+/**@brief Function for powering the gyroscope down while the gyro module stays enabled.
+ *
+ * @details The Air Motion Library state is preserved, so that cursor movements are reported
+ *          immediately after @ref m_gyro_resume, without the library startup period.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_gyro_suspend(void);
+
+/**@brief Function for powering the gyroscope up after @ref m_gyro_suspend.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+ret_code_t m_gyro_resume(void);
+
 /**@brief Function for initiating gyro calibration.
  *
  * @note Gyro will be automatically turned on if not already enabled.
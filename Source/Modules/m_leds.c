@@ -48,6 +48,7 @@
 #include "app_timer.h"
 
 #include "drv_leds.h"
+#include "m_batt_meas.h"
 #include "m_leds.h"
 
 #include "resources.h"
@@ -62,81 +63,175 @@ NRF_LOG_MODULE_REGISTER();
 
 #define MAX_LEDS        4
 
-typedef enum
-{
-    LED_STATE_OFF,
-    LED_STATE_BLINKING,
-    LED_STATE_BLINKING_FOREVER,
-    LED_STATE_ON,
-} led_state_t;
+/**@brief Time unit of the LED_OP_WAIT instruction [ms]. */
+#define LED_PATTERN_TIME_UNIT   10
+
+/**@brief LED pattern instructions.
+ *
+ * @details A pattern is a byte string executed independently for each LED. All LEDs share one
+ *          single-shot timer, which is always armed for the nearest LED_OP_WAIT deadline.
+ */
+#define LED_OP_END              0x00    /**< End of the pattern. The LED keeps its state. */
+#define LED_OP_SET              0x01    /**< Turn the LED on. */
+#define LED_OP_CLR              0x02    /**< Turn the LED off. */
+#define LED_OP_LOOP             0x03    /**< Restart the pattern until the repeat count is exhausted. Repeat count 0 loops forever. */
+#define LED_OP_WAIT_FLAG        0x80
+#define LED_OP_WAIT(_ms)        (LED_OP_WAIT_FLAG | ((_ms) / LED_PATTERN_TIME_UNIT)) /**< Wait for up to 1270 ms. */
+
+STATIC_ASSERT((CONFIG_LED_FLIP_INTERVAL >= LED_PATTERN_TIME_UNIT) &&
+              (CONFIG_LED_FLIP_INTERVAL / LED_PATTERN_TIME_UNIT) <= 0x7F);
 
 typedef struct
 {
-    led_state_t     state;
-    uint8_t         state_data;
-
-    app_timer_id_t  timer;
-    app_timer_t     timer_data;
+    const uint8_t  *p_pattern;  /**< Pattern being executed, NULL if the LED is idle. */
+    uint8_t         pc;         /**< Index of the next instruction. */
+    uint8_t         repeats;    /**< Number of pattern repeats left. 0 means forever. */
+    uint32_t        countdown;  /**< Timer ticks left until the pattern resumes. */
 } led_entry_t;
 
+static const uint8_t    m_leds_pattern_on[]     = { LED_OP_SET, LED_OP_END };
+static const uint8_t    m_leds_pattern_off[]    = { LED_OP_CLR, LED_OP_END };
+static const uint8_t    m_leds_pattern_blink[]  =
+{
+    LED_OP_SET, LED_OP_WAIT(CONFIG_LED_FLIP_INTERVAL),
+    LED_OP_CLR, LED_OP_WAIT(CONFIG_LED_FLIP_INTERVAL),
+    LED_OP_LOOP,
+};
+
 static led_entry_t      m_leds[MAX_LEDS];
+static uint8_t          m_leds_lit;
+static uint32_t         m_leds_timestamp;
+APP_TIMER_DEF           (m_leds_timer);
 #if CONFIG_PWR_MGMT_ENABLED
 static bool             m_leds_going_down;
 #endif
 
-static void m_leds_state_machine(void* p_context)
+/**@brief Track which LEDs are lit, so that the battery measurement can account for them.
+ *
+ * @param[in] lit   Bitmask of the lit LEDs.
+ */
+static void m_leds_lit_update(uint8_t lit)
 {
-    unsigned int led    = (unsigned int)(p_context);
-    led_entry_t *p_led  = &m_leds[led];
+#if CONFIG_BATT_MEAS_ENABLED
+    if ((lit != 0) != (m_leds_lit != 0))
+    {
+        m_batt_meas_load_set(M_BATT_MEAS_LOAD_LED, (lit != 0));
+    }
+#endif
 
-    switch (p_led->state)
+    m_leds_lit = lit;
+}
+
+/**@brief Execute the pattern of the given LED up to the next wait or to its end.
+ *
+ * @param[in] led   LED index.
+ * @param[in] late  Number of ticks the LED was resumed late. Subtracted from the next wait to avoid drift.
+ *
+ * @return True if the pattern is still running, false if it has ended.
+ */
+static bool m_leds_pattern_run(unsigned int led, uint32_t late)
+{
+    led_entry_t *p_led = &m_leds[led];
+
+    while (p_led->p_pattern != NULL)
     {
-        case LED_STATE_OFF:
-            APP_ERROR_CHECK(drv_leds_clr(1 << led));
-            break;
+        uint8_t op = p_led->p_pattern[p_led->pc++];
 
-        case LED_STATE_ON:
-            APP_ERROR_CHECK(drv_leds_set(1 << led));
-            break;
+        if (op & LED_OP_WAIT_FLAG)
+        {
+            uint32_t ticks = APP_TIMER_TICKS((op & ~LED_OP_WAIT_FLAG) * LED_PATTERN_TIME_UNIT);
 
-        case LED_STATE_BLINKING_FOREVER:
-            p_led->state_data |= ~1;
-            /* FALLTHROUGH */
+            p_led->countdown = ticks - MIN(late, ticks - 1);
+            return true;
+        }
 
-        case LED_STATE_BLINKING:
-            if (--(p_led->state_data) & 1)
-            {
+        switch (op)
+        {
+            case LED_OP_SET:
                 APP_ERROR_CHECK(drv_leds_set(1 << led));
-            }
-            else
-            {
-                APP_ERROR_CHECK(drv_leds_clr(1 << led));
-            }
+                m_leds_lit_update(m_leds_lit | (1 << led));
+                break;
 
-            if (p_led->state_data != 0)
-            {
-                APP_ERROR_CHECK(app_timer_start(p_led->timer, APP_TIMER_TICKS(CONFIG_LED_FLIP_INTERVAL), (void *)(led)));
-            }
-            else
-            {
-                p_led->state = LED_STATE_OFF;
+            case LED_OP_CLR:
+                APP_ERROR_CHECK(drv_leds_clr(1 << led));
+                m_leds_lit_update(m_leds_lit & ~(1 << led));
+                break;
 
-#if CONFIG_PWR_MGMT_ENABLED
-                if (m_leds_going_down)
+            case LED_OP_LOOP:
+                if ((p_led->repeats == 0) || (--(p_led->repeats) != 0))
                 {
-                    nrf_pwr_mgmt_shutdown(NRF_PWR_MGMT_SHUTDOWN_CONTINUE);
+                    p_led->pc = 0;
+                    break;
                 }
-#endif /* CONFIG_PWR_MGMT_ENABLED */
-            }
+                /* FALLTHROUGH */
 
-            break;
+            default:
+                p_led->p_pattern = NULL;
+                break;
+        }
+    }
+
+    return false;
+}
+
+/**@brief Advance all patterns to the current time and re-arm the shared timer. */
+static void m_leds_update(void)
+{
+    uint32_t now        = app_timer_cnt_get();
+    uint32_t elapsed    = app_timer_cnt_diff_compute(now, m_leds_timestamp);
+    uint32_t timeout    = UINT32_MAX;
+    bool     ended      = false;
+    unsigned int i;
+
+    m_leds_timestamp = now;
+
+    for (i = 0; i < MAX_LEDS; i++)
+    {
+        led_entry_t *p_led = &m_leds[i];
+
+        if (p_led->p_pattern == NULL)
+        {
+            continue;
+        }
+
+        if (p_led->countdown > elapsed)
+        {
+            p_led->countdown -= elapsed;
+        }
+        else if (!m_leds_pattern_run(i, elapsed - p_led->countdown))
+        {
+            ended = true;
+            continue;
+        }
+
+        timeout = MIN(timeout, p_led->countdown);
+    }
+
+    APP_ERROR_CHECK(app_timer_stop(m_leds_timer));
+    if (timeout != UINT32_MAX)
+    {
+        APP_ERROR_CHECK(app_timer_start(m_leds_timer, MAX(timeout, APP_TIMER_MIN_TIMEOUT_TICKS), NULL));
+    }
+
+#if CONFIG_PWR_MGMT_ENABLED
+    if (ended && m_leds_going_down)
+    {
+        nrf_pwr_mgmt_shutdown(NRF_PWR_MGMT_SHUTDOWN_CONTINUE);
     }
+#else
+    UNUSED_VARIABLE(ended);
+#endif /* CONFIG_PWR_MGMT_ENABLED */
+}
+
+/**@brief Shared LED timer handler. */
+static void m_leds_timer_handler(void *p_context)
+{
+    m_leds_update();
 }
 
 ret_code_t m_leds_init(void)
 {
     ret_code_t status;
-    unsigned int i;
 
     // Initialize the LED driver
     status = drv_leds_init();
@@ -154,18 +249,13 @@ ret_code_t m_leds_init(void)
 
     // Initialize module state
     memset(m_leds, 0, sizeof(m_leds));
-    for (i = 0; i < MAX_LEDS; i++)
-    {
-        led_entry_t *p_led = &m_leds[i];
-
-        p_led->state = LED_STATE_OFF;
-        p_led->timer = &(p_led->timer_data);
+    m_leds_lit       = 0;
+    m_leds_timestamp = app_timer_cnt_get();
 
-        status = app_timer_create(&(p_led->timer), APP_TIMER_MODE_SINGLE_SHOT, m_leds_state_machine);
-        if (status != NRF_SUCCESS)
-        {
-            return status;
-        }
+    status = app_timer_create(&m_leds_timer, APP_TIMER_MODE_SINGLE_SHOT, m_leds_timer_handler);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
     }
 
 #if CONFIG_PWR_MGMT_ENABLED
@@ -175,13 +265,15 @@ ret_code_t m_leds_init(void)
     return NRF_SUCCESS;
 }
 
-/**@brief Turn on LEDs.
+/**@brief Start a pattern on LEDs.
  *
- * @param[in] leds_mask Indicates which LEDs to turn on.
+ * @param[in] leds_mask Indicates which LEDs should execute the pattern.
+ * @param[in] p_pattern Pointer to the pattern.
+ * @param[in] repeats   Number of pattern repeats. Set to 0 in order to repeat forever.
  *
  * @return    NRF_SUCCESS on success, otherwise an error code.
  */
-static ret_code_t m_leds_set(uint8_t leds_mask)
+static ret_code_t m_leds_play(uint8_t leds_mask, const uint8_t *p_pattern, uint8_t repeats)
 {
     unsigned int i;
 
@@ -191,20 +283,38 @@ static ret_code_t m_leds_set(uint8_t leds_mask)
         return NRF_ERROR_INVALID_PARAM;
     }
 
+    // Bring the running patterns up to date before the new ones start.
+    m_leds_update();
+
     for (i = 0; (leds_mask != 0) && (i < MAX_LEDS); i++)
     {
         led_entry_t *p_led = &m_leds[i];
 
         if (leds_mask & (1 << i))
         {
-            p_led->state = LED_STATE_ON;
-            m_leds_state_machine((void *)(i));
+            p_led->p_pattern    = p_pattern;
+            p_led->pc           = 0;
+            p_led->repeats      = repeats;
+            p_led->countdown    = 0;
         }
     }
 
+    m_leds_update();
+
     return NRF_SUCCESS;
 }
 
+/**@brief Turn on LEDs.
+ *
+ * @param[in] leds_mask Indicates which LEDs to turn on.
+ *
+ * @return    NRF_SUCCESS on success, otherwise an error code.
+ */
+static ret_code_t m_leds_set(uint8_t leds_mask)
+{
+    return m_leds_play(leds_mask, m_leds_pattern_on, 1);
+}
+
 /**@brief Turn off LEDs.
  *
  * @param[in] leds_mask Indicates which LEDs to turn off.
@@ -213,26 +323,7 @@ static ret_code_t m_leds_set(uint8_t leds_mask)
  */
 static ret_code_t m_leds_clr(uint8_t leds_mask)
 {
-    unsigned int i;
-
-    // Check if all requested LEDs are suppoted.
-    if (leds_mask & ~drv_leds_all())
-    {
-        return NRF_ERROR_INVALID_PARAM;
-    }
-
-    for (i = 0; (leds_mask != 0) && (i < MAX_LEDS); i++)
-    {
-        led_entry_t *p_led = &m_leds[i];
-
-        if (leds_mask & (1 << i))
-        {
-            p_led->state = LED_STATE_OFF;
-            m_leds_state_machine((void *)(i));
-        }
-    }
-
-    return NRF_SUCCESS;
+    return m_leds_play(leds_mask, m_leds_pattern_off, 1);
 }
 
 /**@brief Turn flashing on an LED on or off.
@@ -244,30 +335,7 @@ static ret_code_t m_leds_clr(uint8_t leds_mask)
  */
 static ret_code_t m_leds_flash(uint8_t leds_mask, uint8_t times)
 {
-    unsigned int i;
-
-    /*
-     * Check if all requested LEDs are suppoted.
-     * Check if the 'times' parameter could be safely doubled.
-     */
-    if ((leds_mask & ~drv_leds_all()) || (times & 0x80))
-    {
-        return NRF_ERROR_INVALID_PARAM;
-    }
-
-    for (i = 0; (leds_mask != 0) && (i < MAX_LEDS); i++)
-    {
-        led_entry_t *p_led = &m_leds[i];
-
-        if (leds_mask & (1 << i))
-        {
-            p_led->state      = (times == 0) ? LED_STATE_BLINKING_FOREVER : LED_STATE_BLINKING;
-            p_led->state_data = (times << 1);
-            m_leds_state_machine((void *)(i));
-        }
-    }
-
-    return NRF_SUCCESS;
+    return m_leds_play(leds_mask, m_leds_pattern_blink, times);
 }
 
 bool m_leds_event_handler(const event_t *p_event)
@@ -377,21 +445,15 @@ static bool m_leds_shutdown(nrf_pwr_mgmt_evt_t event)
         {
             led_entry_t *p_led = &m_leds[i];
 
-            if (p_led->state == LED_STATE_BLINKING_FOREVER)
+            if (p_led->p_pattern != NULL)
             {
-                p_led->state = LED_STATE_BLINKING;
-            }
-
-            if (p_led->state == LED_STATE_BLINKING)
-            {
-                if ((p_led->state_data >> 1) > 3)
+                if ((p_led->repeats == 0) || (p_led->repeats > 3))
                 {
-                   p_led->state_data = (3 << 1) | (p_led->state_data & 0x01);
+                    p_led->repeats = 3;
                 }
 
                 retval = false;
             }
-
         }
     }
 
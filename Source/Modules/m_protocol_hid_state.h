@@ -58,7 +58,7 @@ extern "C" {
 typedef struct
 {
     uint32_t usage; /**< HID usage. */
-    int16_t  value; /**< HID value. */
+    int32_t  value; /**< HID value. */
 } m_protocol_hid_state_item_t;
 
 
@@ -186,6 +186,11 @@ static void m_system_state_audio_ctrl(uint8_t command)
             break;
 
         case 0x01:
+            // HID audio is announced with the configured sampling frequency.
+            if (m_audio_sampling_frequency_set(CONFIG_AUDIO_SAMPLING_FREQUENCY) != NRF_SUCCESS)
+            {
+                NRF_LOG_WARNING("Cannot stream HID audio at %u Hz", CONFIG_AUDIO_SAMPLING_FREQUENCY);
+            }
             m_system_state_audio_service_enable(M_COMS_AUDIO_SERVICE_HID);
             break;
 
@@ -208,11 +213,19 @@ static void m_system_state_atvv_event_handle(const event_t * p_event)
                 APP_ERROR_CHECK(m_coms_ble_sl_enable());
                 m_atvv_has_disabled_sl = false;
             }
+            if (m_audio_sampling_frequency_set(1000ul * p_event->atvv.rate_khz) != NRF_SUCCESS)
+            {
+                NRF_LOG_WARNING("Cannot stream ATVV audio at %u kHz", p_event->atvv.rate_khz);
+            }
             m_system_state_audio_service_enable(M_COMS_AUDIO_SERVICE_ATVV);
             break;
 
         case EVT_ATVV_STATE_MIC_CLOSE:
-            m_system_state_audio_service_disable(M_COMS_AUDIO_SERVICE_ATVV);
+            if (m_coms_ble_atvv_audio_peers_get(NULL, 0) == 0)
+            {
+                // Keep streaming as long as any peer has the microphone open
+                m_system_state_audio_service_disable(M_COMS_AUDIO_SERVICE_ATVV);
+            }
             break;
 
         case EVT_ATVV_STATE_SEARCH_TIMEOUT:
@@ -230,8 +243,14 @@ static void m_system_state_atvv_event_handle(const event_t * p_event)
             break;
 
         case EVT_ATVV_STATE_DISABLED:
-            m_atvv_peer_conn_handle = BLE_CONN_HANDLE_INVALID;
-            m_system_state_audio_service_disable(M_COMS_AUDIO_SERVICE_ATVV);
+            if (m_atvv_peer_conn_handle == p_event->atvv.conn_id)
+            {
+                m_atvv_peer_conn_handle = BLE_CONN_HANDLE_INVALID;
+            }
+            if (m_coms_ble_atvv_audio_peers_get(NULL, 0) == 0)
+            {
+                m_system_state_audio_service_disable(M_COMS_AUDIO_SERVICE_ATVV);
+            }
             break;
 
         default:
@@ -241,6 +260,19 @@ static void m_system_state_atvv_event_handle(const event_t * p_event)
 #endif /* CONFIG_AUDIO_ENABLED && CONFIG_AUDIO_ATVV_ENABLED */
 
 #if CONFIG_GYRO_ENABLED
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+/**@brief Power the gyroscope down while the device is stationary. */
+static void m_system_state_gyro_motion_handler(bool moving)
+{
+    if (m_gyro_active == false)
+    {
+        return;
+    }
+
+    APP_ERROR_CHECK(moving ? m_gyro_resume() : m_gyro_suspend());
+}
+#endif /* CONFIG_GYRO_MOTION_GATING_ENABLED */
+
 /**@brief Handle Gyroscope On/Off Button Press. */
 static void m_system_state_gyro_toggle(void)
 {
@@ -256,7 +288,9 @@ static void m_system_state_gyro_toggle(void)
             APP_ERROR_CHECK(app_timer_start(m_gyro_timer,
                                             APP_TIMER_TICKS(1000),
                                             NULL));
-#if CONFIG_ACC_USE_CLICK_DETECTION
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+            APP_ERROR_CHECK(m_acc_motion_tracking_enable(m_system_state_gyro_motion_handler));
+#elif CONFIG_ACC_USE_CLICK_DETECTION
             APP_ERROR_CHECK(m_acc_click_detection_enable());
 #endif
 
@@ -278,7 +312,9 @@ static void m_system_state_gyro_toggle(void)
         case true:
             m_gyro_active   = false;
 
-#if CONFIG_ACC_USE_CLICK_DETECTION
+#if CONFIG_GYRO_MOTION_GATING_ENABLED
+            APP_ERROR_CHECK(m_acc_motion_tracking_disable());
+#elif CONFIG_ACC_USE_CLICK_DETECTION
             APP_ERROR_CHECK(m_acc_click_detection_disable());
 #endif
             APP_ERROR_CHECK(app_timer_stop(m_gyro_timer));
@@ -97,8 +97,8 @@ static void m_touchpad_read_handler(ret_code_t status, drv_touchpad_data_t *p_da
     /* When gyroscope is enabled, the touchpad sends only wheel/pan motion. */
     if (s_gyro_enabled)
     {
-        p_data->pan     += p_data->x;
-        p_data->scroll  += p_data->y;
+        p_data->pan     += p_data->x * HID_REL_WHEEL_SCALE / HID_REL_POINTER_SCALE;
+        p_data->scroll  += p_data->y * HID_REL_WHEEL_SCALE / HID_REL_POINTER_SCALE;
 
         p_data->x       = 0;
         p_data->y       = 0;
@@ -0,0 +1,9 @@
+/* Stand-in for the CMSIS DSP header: the sample type used by the DSP driver interface. */
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+
+#endif // _ARM_MATH_H
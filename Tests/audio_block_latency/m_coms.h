@@ -0,0 +1,9 @@
+/* Stand-in for the header of the same name: the audio transmission entry point, implemented by the test. */
+#ifndef __M_COMS_H__
+#define __M_COMS_H__
+
+#include "m_audio.h"
+
+ret_code_t m_coms_send_audio(m_audio_frame_t *p_audio_frame);
+
+#endif /* __M_COMS_H__ */
@@ -0,0 +1,10 @@
+/* Stand-in for the header of the same name: the schedulers. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#include "app_isched.h"
+
+extern app_isched_t g_fg_scheduler;
+extern app_isched_t g_bg_scheduler;
+
+#endif /* __RESOURCES_H__ */
@@ -0,0 +1,7 @@
+/* Stand-in for the SDK configuration. As in the firmware, it includes the application configuration. */
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+#include "sr3_config.h"
+
+#endif // SDK_CONFIG_H
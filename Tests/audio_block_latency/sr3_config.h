@@ -0,0 +1,42 @@
+/* Audio configuration used by the test: the built-in ANR and the ADPCM codec, without the other processing stages,
+ * gauges, probes, power management or CLI. The frame size, the ANR and codec settings, the pool sizes and the
+ * capture block size are set by the Makefile. The derived audio parameters come from sr3_config_audio.h. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_AUDIO_CODEC_ADPCM            1
+#define CONFIG_AUDIO_CODEC_BV32FP           2
+#define CONFIG_AUDIO_CODEC_OPUS             3
+#define CONFIG_AUDIO_CODEC_SBC              4
+#define CONFIG_AUDIO_ANR_ENGINE_BUILTIN     0
+#define CONFIG_AUDIO_ANR_ENGINE_VOCAL       1
+
+#define CONFIG_AUDIO_ENABLED                1
+#define CONFIG_AUDIO_HID_ENABLED            1
+#define CONFIG_AUDIO_ATVV_ENABLED           0
+#define CONFIG_AUDIO_CODEC                  CONFIG_AUDIO_CODEC_ADPCM
+#define CONFIG_AUDIO_SAMPLING_FREQUENCY     16000
+#define CONFIG_AUDIO_ANR_ENABLED            1
+#define CONFIG_AUDIO_ANR_ENGINE             CONFIG_AUDIO_ANR_ENGINE_BUILTIN
+#define CONFIG_AUDIO_NS_ENABLED             0
+#define CONFIG_AUDIO_EQUALIZER_ENABLED      0
+#define CONFIG_AUDIO_GAIN_CONTROL_ENABLED   0
+#define CONFIG_AUDIO_SRC_ENABLED            0
+#define CONFIG_AUDIO_GAUGES_ENABLED         0
+#define CONFIG_AUDIO_PROBE_ENABLED          0
+
+#define CONFIG_AUDIO_MODULE_LOG_LEVEL       0
+#define CONFIG_AUDIO_DRV_ANR_LOG_LEVEL      0
+#define CONFIG_AUDIO_DRV_CODEC_LOG_LEVEL    0
+
+#define CONFIG_PWR_MGMT_ENABLED             0
+#define CONFIG_BATT_MEAS_ENABLED            0
+#define CONFIG_CLI_ENABLED                  0
+
+#include "sr3_config_audio.h"
+
+#endif // SR3_CONFIG_H
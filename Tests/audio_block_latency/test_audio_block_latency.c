@@ -0,0 +1,259 @@
+/**@file
+ *
+ * @brief Latency of capture blocks smaller than the codec frame, through the audio module.
+ *
+ * @details The test includes m_audio.c and builds it with the built-in ANR (drv_audio_anr.c), the ADPCM codec driver
+ *          (drv_audio_codec_adpcm.c) and the frame pool (m_audio_frame.c) of the firmware. The capture block size
+ *          is set by the Makefile, one build per size, so the frame assembly of m_audio_process() is the one the
+ *          firmware gets for that CONFIG_AUDIO_CAPTURE_BLOCK_SIZE.
+ *
+ *          The microphone driver is replaced by a capture loop which fills buffers from the pool given to
+ *          drv_audio_init() and passes them to the buffer handler. After every block, the background and then
+ *          the foreground scheduler queues are run to completion, and the frames passed to m_coms_send_audio()
+ *          are appended to the bitstream.
+ *
+ *          The bitstream must match the one obtained by calling the ANR and codec drivers directly on whole frames,
+ *          which does not depend on the block size. No frame may be lost and all buffers and frames must be back in
+ *          their pools. The median host time from the capture of the block which completes a frame to the delivery
+ *          of the encoded frame to m_coms_send_audio() is reported.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "m_coms.h"         // Stand-in, ahead of the m_coms.h next to m_audio.c.
+#include "m_audio.c"
+
+#define FS                  16000
+#define INPUT_LENGTH        (6 * FS)
+#define INPUT_FRAMES        (INPUT_LENGTH / CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+#define RUNS                5                   /**< The fastest of several runs is reported. */
+#define QUEUE_SIZE          16
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+STATIC_ASSERT((INPUT_LENGTH % CONFIG_AUDIO_BLOCK_SIZE_SAMPLES) == 0);
+
+/**@brief Scheduler instance: a queue of events run by the test. */
+typedef struct
+{
+    app_isched_event_t  events[QUEUE_SIZE];
+    unsigned int        count;
+} queue_t;
+
+app_isched_t                        g_fg_scheduler;
+app_isched_t                        g_bg_scheduler;
+
+static queue_t                      s_fg_queue;
+static queue_t                      s_bg_queue;
+
+static nrf_balloc_t const          *s_p_buffer_pool;
+static drv_audio_buffer_handler_t   s_buffer_handler;
+static bool                         s_capture_enabled;
+
+static int16_t                      s_input[2 * INPUT_LENGTH];
+static int16_t                      s_frame[2 * CONFIG_AUDIO_FRAME_SIZE_SAMPLES];
+static uint8_t                      s_bitstream[INPUT_FRAMES * CONFIG_AUDIO_FRAME_SIZE_BYTES];
+static uint8_t                      s_reference[INPUT_FRAMES * CONFIG_AUDIO_FRAME_SIZE_BYTES];
+static size_t                       s_bitstream_size;
+static unsigned int                 s_frames_sent;
+static double                       s_send_ns;
+static double                       s_tail_ns[INPUT_FRAMES];
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context)
+{
+    queue_t *p_queue = (p_isched == &g_bg_scheduler) ? &s_bg_queue : &s_fg_queue;
+
+    if (p_queue->count == QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_queue->events[p_queue->count].handler   = handler;
+    p_queue->events[p_queue->count].p_context = p_context;
+    p_queue->count++;
+
+    return NRF_SUCCESS;
+}
+
+static void queue_run(queue_t *p_queue)
+{
+    while (p_queue->count != 0)
+    {
+        app_isched_event_t event = p_queue->events[0];
+
+        p_queue->count--;
+        memmove(&p_queue->events[0], &p_queue->events[1], p_queue->count * sizeof(event));
+        event.handler(event.p_context);
+    }
+}
+
+ret_code_t drv_audio_init(nrf_balloc_t const *p_buffer_pool, drv_audio_buffer_handler_t buffer_handler)
+{
+    s_p_buffer_pool  = p_buffer_pool;
+    s_buffer_handler = buffer_handler;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_audio_enable(void)
+{
+    s_capture_enabled = true;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_audio_disable(void)
+{
+    s_capture_enabled = false;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t m_coms_send_audio(m_audio_frame_t *p_audio_frame)
+{
+    memcpy(&s_bitstream[s_bitstream_size], p_audio_frame->data, p_audio_frame->data_size);
+    s_bitstream_size += p_audio_frame->data_size;
+    s_frames_sent++;
+    s_send_ns = now_ns();
+
+    return NRF_SUCCESS;
+}
+
+static int compare_double(const void *p_a, const void *p_b)
+{
+    double a = *(const double *)p_a;
+    double b = *(const double *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/**@brief Encode the input frame by frame with the drivers alone. */
+static void reference_encode(void)
+{
+    m_audio_frame_t frame;
+    size_t          pos;
+
+    drv_audio_anr_init();
+    drv_audio_codec_init();
+    s_bitstream_size = 0;
+
+    for (pos = 0; pos < (INPUT_FRAMES * CONFIG_AUDIO_FRAME_SIZE_SAMPLES); pos += CONFIG_AUDIO_FRAME_SIZE_SAMPLES)
+    {
+        memcpy(s_frame, &s_input[2 * pos], sizeof(s_frame));
+        drv_audio_anr_perfrom(s_frame, CONFIG_AUDIO_FRAME_SIZE_SAMPLES);
+        drv_audio_codec_encode(s_frame, &frame);
+
+        memcpy(&s_reference[s_bitstream_size], frame.data, frame.data_size);
+        s_bitstream_size += frame.data_size;
+    }
+}
+
+/**@brief Capture the input in blocks and run the audio module on them.
+ *
+ * @return Median time from the capture of a block to the delivery of the frame it completes.
+ */
+static double run(void)
+{
+    size_t  frames = 0;
+    size_t  pos;
+
+    s_bitstream_size = 0;
+    s_frames_sent    = 0;
+
+    TEST_CHECK(m_audio_enable() == NRF_SUCCESS);
+    queue_run(&s_bg_queue);
+    queue_run(&s_fg_queue);
+
+    for (pos = 0; s_capture_enabled && (pos < INPUT_LENGTH); pos += CONFIG_AUDIO_BLOCK_SIZE_SAMPLES)
+    {
+        int16_t        *p_buffer = nrf_balloc_alloc(s_p_buffer_pool);
+        unsigned int    frames_before = s_frames_sent;
+        double          start;
+
+        TEST_CHECK(p_buffer != NULL);
+        if (p_buffer == NULL)
+        {
+            break;
+        }
+
+        memcpy(p_buffer, &s_input[2 * pos], CONFIG_PDM_BUFFER_SIZE_SAMPLES * sizeof(int16_t));
+
+        // The last sample of the block has just been captured.
+        start = now_ns();
+
+        s_buffer_handler(p_buffer);
+        queue_run(&s_bg_queue);
+        queue_run(&s_fg_queue);
+
+        if (s_frames_sent != frames_before)
+        {
+            TEST_CHECK(s_frames_sent == (frames_before + 1));
+            s_tail_ns[frames++] = s_send_ns - start;
+        }
+    }
+
+    TEST_CHECK(m_audio_disable() == NRF_SUCCESS);
+    queue_run(&s_bg_queue);
+    queue_run(&s_fg_queue);
+
+    TEST_CHECK(frames == INPUT_FRAMES);
+    TEST_CHECK(m_audio_frame_pool_current_utilization_get() == 0);
+    TEST_CHECK(nrf_balloc_utilization_get(s_p_buffer_pool) == 0);
+#if M_AUDIO_FRAME_ASSEMBLY_ENABLED
+    TEST_CHECK(m_audio_frame_buffer_fill == (INPUT_LENGTH % CONFIG_AUDIO_FRAME_SIZE_SAMPLES));
+#endif
+
+    qsort(s_tail_ns, frames, sizeof(s_tail_ns[0]), compare_double);
+    return (frames != 0) ? s_tail_ns[frames / 2] : INFINITY;
+}
+
+int main(void)
+{
+    size_t  reference_size;
+    double  tail = INFINITY;
+    size_t  i;
+    int     r;
+
+    srand(3);
+    for (i = 0; i < INPUT_LENGTH; i++)
+    {
+        double t = (double)i / FS;
+
+        s_input[2 * i]     = (int16_t)((6000.0 * sin(2.0 * M_PI * 300.0 * t)) + (800.0 * ((double)rand() / RAND_MAX - 0.5)));
+        s_input[2 * i + 1] = (int16_t)(1500.0 * ((double)rand() / RAND_MAX - 0.5));
+    }
+
+    reference_encode();
+    reference_size = s_bitstream_size;
+
+    TEST_CHECK(m_audio_frame_init() == NRF_SUCCESS);
+    TEST_CHECK(m_audio_init() == NRF_SUCCESS);
+
+    for (r = 0; r < RUNS; r++)
+    {
+        tail = MIN(tail, run());
+
+        TEST_CHECK(s_bitstream_size == reference_size);
+        TEST_CHECK(memcmp(s_bitstream, s_reference, MIN(s_bitstream_size, reference_size)) == 0);
+    }
+
+    printf("block %3u samples: median %5.1f us from capture to m_coms_send_audio() on the host, %zu bytes\n",
+           CONFIG_AUDIO_BLOCK_SIZE_SAMPLES, tail / 1e3, s_bitstream_size);
+
+    return TEST_RESULT();
+}
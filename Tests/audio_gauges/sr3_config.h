@@ -0,0 +1,11 @@
+/* Audio gauge configuration used by the test. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#define CONFIG_AUDIO_GAUGES_ENABLED             1
+#define CONFIG_AUDIO_GAUGES_HISTOGRAM_ENABLED   1
+#define CONFIG_AUDIO_MODULE_LOG_LEVEL           0
+#define CONFIG_AUDIO_FRAME_SIZE_SAMPLES         128
+#define CONFIG_AUDIO_REAL_SAMPLING_FREQUENCY    16000
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,183 @@
+/**@file
+ *
+ * @brief Test of the audio CPU gauges in their host build.
+ *
+ * @details The test provides clock_gettime(), so that every measurement takes a chosen number of nanoseconds.
+ *          It checks the histogram bins, the percentiles against the exact ones, overrun counting, the clock
+ *          wrap-around and saturation of the histogram.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "m_audio_gauges.h"
+
+#define FS                  16000
+#define FRAME_SAMPLES       128
+#define FRAME_TIME          (FRAME_SAMPLES * 1000000000ull / FS)    /**< Frame length in nanoseconds. */
+#define MEASUREMENTS        5000
+
+static uint64_t s_now;
+
+int clock_gettime(clockid_t clock_id, struct timespec *p_ts)
+{
+    p_ts->tv_sec  = s_now / 1000000000ull;
+    p_ts->tv_nsec = s_now % 1000000000ull;
+
+    return 0;
+}
+
+static void measure(m_audio_cpu_gauge_t *p_gauge, uint32_t time)
+{
+    m_audio_measure_cpu_usage_start(p_gauge);
+    s_now += time;
+    m_audio_measure_cpu_usage_end(p_gauge);
+    s_now += 1000;
+}
+
+static int compare_u32(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/**@brief Bins must cover all times without gaps, and every time must be counted by the bin which covers it. */
+static void bins_test(void)
+{
+    m_audio_cpu_gauge_t gauge;
+    uint32_t            lower;
+    uint32_t            upper;
+    uint32_t            next = 0;
+    unsigned int        bin;
+
+    for (bin = 0; bin < M_AUDIO_CPU_HISTOGRAM_BINS; bin++)
+    {
+        m_audio_cpu_gauge_bin_range(bin, &lower, &upper);
+        TEST_CHECK(lower == next);
+        TEST_CHECK(upper > lower);
+
+        m_audio_cpu_gauge_reset(&gauge, FRAME_SAMPLES, FS);
+        measure(&gauge, lower);
+        measure(&gauge, upper - 1);
+        TEST_CHECK(gauge.histogram[bin] == 2);
+
+        // Apart from the first octave, a bin is at most a quarter of its lower edge wide.
+        if (lower >= (1ul << M_AUDIO_CPU_HISTOGRAM_MIN_LOG2) && (bin < (M_AUDIO_CPU_HISTOGRAM_BINS - 1)))
+        {
+            TEST_CHECK((upper - lower) <= (lower / 4));
+        }
+
+        next = upper;
+    }
+
+    TEST_CHECK(upper == UINT32_MAX);
+}
+
+/**@brief Percentiles of a skewed distribution with rare long frames. The result is the upper edge of the bin
+ *        holding the exact percentile, so it is at most a quarter of an octave above it.
+ */
+static void percentile_test(void)
+{
+    static const unsigned int percentiles[] = { 0, 1, 10, 50, 90, 99, 100 };
+    static uint32_t     times[MEASUREMENTS];
+    m_audio_cpu_gauge_t gauge;
+    size_t              i;
+
+    m_audio_cpu_gauge_reset(&gauge, FRAME_SAMPLES, FS);
+    TEST_CHECK(gauge.frame_time == FRAME_TIME);
+    TEST_CHECK(m_audio_cpu_gauge_percentile(&gauge, 50) == 0);
+
+    srand(1);
+    for (i = 0; i < MEASUREMENTS; i++)
+    {
+        double u = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+
+        times[i] = (uint32_t)(2000000.0 * exp(0.3 * sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979 * rand() / RAND_MAX)));
+        if ((i % 97) == 0)
+        {
+            times[i] = 9000000 + (rand() % 1000000);
+        }
+
+        measure(&gauge, times[i]);
+    }
+
+    qsort(times, MEASUREMENTS, sizeof(times[0]), compare_u32);
+
+    TEST_CHECK(gauge.frames == MEASUREMENTS);
+    TEST_CHECK(gauge.min_time == times[0]);
+    TEST_CHECK(gauge.max_time == times[MEASUREMENTS - 1]);
+    TEST_CHECK(gauge.overruns == (uint32_t)(MEASUREMENTS / 97 + 1));
+
+    for (i = 0; i < ARRAY_SIZE(percentiles); i++)
+    {
+        size_t      index = (percentiles[i] == 0) ? 0 : (CEIL_DIV(MEASUREMENTS * percentiles[i], 100) - 1);
+        uint32_t    exact = times[index];
+        uint32_t    value = m_audio_cpu_gauge_percentile(&gauge, percentiles[i]);
+
+        printf("p%-3u exact %8u ns, gauge %8u ns, %4.1f%% above\n",
+               percentiles[i], exact, value, 100.0 * ((double)value - exact) / exact);
+
+        TEST_CHECK(value >= exact);
+        TEST_CHECK(value <= (exact + (exact / 4)));
+    }
+
+    printf("CPU usage min %u%%, avg %u%%, p99 %u%%, max %u%%, overruns %u\n",
+           m_audio_gauge_get_min_cpu_usage(&gauge),
+           m_audio_gauge_get_avg_cpu_usage(&gauge),
+           m_audio_gauge_time_to_cpu_usage(&gauge, m_audio_cpu_gauge_percentile(&gauge, 99)),
+           m_audio_gauge_get_max_cpu_usage(&gauge),
+           m_audio_gauge_get_overrun_count(&gauge));
+
+    TEST_CHECK(m_audio_gauge_get_max_cpu_usage(&gauge) == (100ull * gauge.max_time / FRAME_TIME));
+}
+
+/**@brief The 32-bit clock wraps around about every 4.3 s on the host, and 67 s at 64 MHz on the target. */
+static void wrap_test(void)
+{
+    m_audio_cpu_gauge_t gauge;
+
+    m_audio_cpu_gauge_reset(&gauge, FRAME_SAMPLES, FS);
+
+    s_now = (1ull << 32) - 1000;
+    measure(&gauge, 3000);
+
+    TEST_CHECK(gauge.cur_time == 3000);
+    TEST_CHECK(gauge.overruns == 0);
+}
+
+/**@brief A full histogram bin must stop counting instead of wrapping around to zero. */
+static void saturation_test(void)
+{
+    m_audio_cpu_gauge_t gauge;
+    uint32_t            i;
+
+    m_audio_cpu_gauge_reset(&gauge, FRAME_SAMPLES, FS);
+
+    for (i = 0; i < (UINT16_MAX + 10ul); i++)
+    {
+        measure(&gauge, 100000);
+    }
+    measure(&gauge, 7000000);
+
+    TEST_CHECK(gauge.histogram[0] == 0);
+    TEST_CHECK(m_audio_cpu_gauge_percentile(&gauge, 50) >= 100000);
+    TEST_CHECK(m_audio_cpu_gauge_percentile(&gauge, 50) < 125000);
+    TEST_CHECK(m_audio_cpu_gauge_percentile(&gauge, 100) == 7000000);
+}
+
+int main(void)
+{
+    bins_test();
+    percentile_test();
+    wrap_test();
+    saturation_test();
+
+    return TEST_RESULT();
+}
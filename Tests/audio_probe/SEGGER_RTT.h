@@ -0,0 +1,14 @@
+/* Stand-in for the RTT header. The functions are implemented by the test. */
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+
+#include <stddef.h>
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP   0
+
+int      SEGGER_RTT_ConfigUpBuffer(unsigned buffer_index, const char *p_name, void *p_buffer, unsigned size, unsigned flags);
+int      SEGGER_RTT_ConfigDownBuffer(unsigned buffer_index, const char *p_name, void *p_buffer, unsigned size, unsigned flags);
+unsigned SEGGER_RTT_Write(unsigned buffer_index, const void *p_buffer, unsigned num_bytes);
+unsigned SEGGER_RTT_Read(unsigned buffer_index, void *p_buffer, unsigned buffer_size);
+
+#endif // SEGGER_RTT_H
@@ -0,0 +1,11 @@
+/* RTT configuration used by the test. As in the firmware, it includes the application configuration. */
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+#include "sr3_config.h"
+
+#define SEGGER_RTT_CONFIG_MAX_NUM_UP_BUFFERS    3
+#define SEGGER_RTT_CONFIG_MAX_NUM_DOWN_BUFFERS  3
+#define SEGGER_RTT_CONFIG_BUFFER_SIZE_DOWN      32
+
+#endif // SDK_CONFIG_H
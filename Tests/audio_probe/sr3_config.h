@@ -0,0 +1,22 @@
+/* Audio probe configuration used by the test: the multiplexed tap stream on one RTT up channel. The number of
+ * buffers in the channel and compression come from the board configuration. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_AUDIO_PROBE_ENABLED          1
+#define CONFIG_AUDIO_PROBE_STREAM_ENABLED   1
+#define CONFIG_AUDIO_PROBE_RTT_CHANNEL_FIRST 2
+#define CONFIG_AUDIO_PROBE_RTT_CHANNELS_UP  1
+#define CONFIG_AUDIO_PROBE_RTT_CHANNELS_DOWN 0
+#define CONFIG_AUDIO_PROBE_RTT_INJECT_BUFFERS 0
+#define CONFIG_AUDIO_MODULE_LOG_LEVEL       0
+#define CONFIG_CLI_ENABLED                  1
+
+#define CONFIG_AUDIO_FRAME_SIZE_SAMPLES     128
+#define CONFIG_PDM_BUFFER_SIZE_SAMPLES      (2 * 128)   /**< Stereo capture blocks, as with ANR. */
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,269 @@
+/**@file
+ *
+ * @brief Test of the multiplexed audio probe tap stream and its host decoder.
+ *
+ * @details Usage: test_audio_probe <capture> <prefix>
+ *
+ *          Three tap points share one RTT up channel. The RTT buffer is emptied by a simulated host with a
+ *          limited bandwidth which stops reading for a while, so that some frames are dropped. The bytes read
+ *          by the host are written to <capture>, preceded by the tail of a frame as if the capture started in
+ *          the middle of one. For each tap point, <prefix>_<point>.wav holds the tapped samples with the
+ *          dropped frames replaced by silence, which is what Tools/audio_probe_decode.py must reproduce.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "m_audio_probe.h"
+#include "SEGGER_RTT.h"
+#include "sr3_config.h"
+
+#define FS                  16000
+#define PERIODS             400                 /**< Number of audio blocks tapped at every point. */
+#define HOST_READ_SIZE      1200                /**< Bytes read by the host per audio block. */
+#define HOST_STALL_START    150                 /**< First audio block during which the host does not read. */
+#define HOST_STALL_LENGTH   12                  /**< Number of audio blocks during which the host does not read. */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct
+{
+    m_audio_probe_point_enum_t  point;
+    const char                  *p_name;
+    size_t                      samples;        /**< Samples per tapped buffer. */
+    size_t                      written;        /**< Frames written to RTT. */
+    size_t                      dropped;        /**< Frames dropped after the first written frame. */
+    int16_t                     *p_expected;    /**< Samples expected from the decoder. */
+    size_t                      expected;
+} tap_t;
+
+static tap_t s_taps[] =
+{
+    { M_AUDIO_PROBE_POINT_PDM_OUT,  "pdm.out",  CONFIG_PDM_BUFFER_SIZE_SAMPLES },
+    { M_AUDIO_PROBE_POINT_ANR_OUT,  "anr.out",  CONFIG_AUDIO_FRAME_SIZE_SAMPLES },
+    { M_AUDIO_PROBE_POINT_NS_OUT,   "ns.out",   CONFIG_AUDIO_FRAME_SIZE_SAMPLES },
+};
+
+static uint8_t  *s_rtt_buffer;
+static unsigned s_rtt_size;
+static unsigned s_rtt_used;
+static bool     s_rtt_written;
+static uint8_t  s_capture[8 * 1024 * 1024];
+static size_t   s_capture_size;
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned buffer_index, const char *p_name, void *p_buffer, unsigned size, unsigned flags)
+{
+    TEST_CHECK(buffer_index == CONFIG_AUDIO_PROBE_RTT_CHANNEL_FIRST);
+    TEST_CHECK(flags == SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+    s_rtt_buffer = p_buffer;
+    s_rtt_size   = size;
+    s_rtt_used   = 0;
+
+    return 0;
+}
+
+int SEGGER_RTT_ConfigDownBuffer(unsigned buffer_index, const char *p_name, void *p_buffer, unsigned size, unsigned flags)
+{
+    return -1;
+}
+
+/* In SKIP mode, data which does not fit is discarded completely. One byte of the buffer is never used. */
+unsigned SEGGER_RTT_Write(unsigned buffer_index, const void *p_buffer, unsigned num_bytes)
+{
+    TEST_CHECK(buffer_index == CONFIG_AUDIO_PROBE_RTT_CHANNEL_FIRST);
+
+    s_rtt_written = (s_rtt_used + num_bytes) <= (s_rtt_size - 1);
+    if (!s_rtt_written)
+    {
+        return 0;
+    }
+
+    memcpy(&s_rtt_buffer[s_rtt_used], p_buffer, num_bytes);
+    s_rtt_used += num_bytes;
+
+    return num_bytes;
+}
+
+unsigned SEGGER_RTT_Read(unsigned buffer_index, void *p_buffer, unsigned buffer_size)
+{
+    return 0;
+}
+
+static void host_read(size_t size)
+{
+    size = MIN(size, s_rtt_used);
+    TEST_CHECK((s_capture_size + size + 100) <= sizeof(s_capture));
+
+    memcpy(&s_capture[s_capture_size], s_rtt_buffer, size);
+    s_capture_size += size;
+
+    memmove(s_rtt_buffer, &s_rtt_buffer[size], s_rtt_used - size);
+    s_rtt_used -= size;
+}
+
+static void probe_cmd(const char *p_point, const char *p_channel)
+{
+    char *argv[] = { "probe", (char *)p_point, (char *)p_channel };
+
+    m_audio_probe_cmd(NULL, ARRAY_SIZE(argv), argv);
+}
+
+/**@brief Fill a buffer with the signal of a tap point: white noise which does not compress, a voice-like
+ *        signal, and a signal alternating silence and full-scale steps which need escape codes.
+ */
+static void tap_signal(const tap_t *p_tap, size_t period, int16_t *p_samples)
+{
+    size_t i;
+
+    for (i = 0; i < p_tap->samples; i++)
+    {
+        size_t n = (period * p_tap->samples) + i;
+        double t = (double)n / FS;
+
+        switch (p_tap->point)
+        {
+            case M_AUDIO_PROBE_POINT_PDM_OUT:
+                p_samples[i] = (int16_t)((rand() % 65536) - 32768);
+                break;
+
+            case M_AUDIO_PROBE_POINT_ANR_OUT:
+                p_samples[i] = (int16_t)((4000.0 * sin(2.0 * M_PI * 150.0 * t)) +
+                                         (1500.0 * sin(2.0 * M_PI * 450.0 * t + 1.0)) +
+                                         ((rand() % 64) - 32));
+                break;
+
+            default:
+                p_samples[i] = ((period % 4) == 0) ? 0 : (((n / 7) & 1) ? 32767 : -32768);
+                break;
+        }
+    }
+}
+
+static bool file_write(const char *p_path, const void *p_data, size_t size)
+{
+    FILE    *p_file = fopen(p_path, "wb");
+    bool    ok;
+
+    if (p_file == NULL)
+    {
+        return false;
+    }
+
+    ok = (fwrite(p_data, 1, size, p_file) == size);
+    return (fclose(p_file) == 0) && ok;
+}
+
+static bool wav_write(const char *p_path, const int16_t *p_samples, size_t samples)
+{
+    uint32_t    data_size = samples * sizeof(int16_t);
+    uint8_t     *p_file = malloc(44 + data_size);
+    bool        ok;
+
+    memcpy(&p_file[0], "RIFF", 4);
+    uint32_encode(36 + data_size, &p_file[4]);
+    memcpy(&p_file[8], "WAVEfmt ", 8);
+    uint32_encode(16, &p_file[16]);
+    uint16_encode(1, &p_file[20]);
+    uint16_encode(1, &p_file[22]);
+    uint32_encode(FS, &p_file[24]);
+    uint32_encode(FS * sizeof(int16_t), &p_file[28]);
+    uint16_encode(sizeof(int16_t), &p_file[32]);
+    uint16_encode(16, &p_file[34]);
+    memcpy(&p_file[36], "data", 4);
+    uint32_encode(data_size, &p_file[40]);
+    memcpy(&p_file[44], p_samples, data_size);
+
+    ok = file_write(p_path, p_file, 44 + data_size);
+    free(p_file);
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    int16_t samples[CONFIG_PDM_BUFFER_SIZE_SAMPLES];
+    char    path[256];
+    size_t  pending[ARRAY_SIZE(s_taps)] = { 0 };
+    size_t  period;
+    size_t  i;
+
+    if (argc != 3)
+    {
+        printf("Usage: %s <capture> <prefix>\n", argv[0]);
+        return 2;
+    }
+
+    srand(1);
+
+    m_audio_probe_init();
+    for (i = 0; i < ARRAY_SIZE(s_taps); i++)
+    {
+        probe_cmd(s_taps[i].p_name, "2");
+        s_taps[i].p_expected = malloc(PERIODS * s_taps[i].samples * sizeof(int16_t));
+    }
+
+    for (period = 0; period < PERIODS; period++)
+    {
+        for (i = 0; i < ARRAY_SIZE(s_taps); i++)
+        {
+            tap_t *p_tap = &s_taps[i];
+
+            tap_signal(p_tap, period, samples);
+            m_audio_probe_point(p_tap->point, samples, p_tap->samples);
+
+            if (s_rtt_written)
+            {
+                // Frames dropped between two written frames come out of the decoder as silence.
+                memset(&p_tap->p_expected[p_tap->expected], 0, pending[i] * p_tap->samples * sizeof(int16_t));
+                p_tap->expected += pending[i] * p_tap->samples;
+                memcpy(&p_tap->p_expected[p_tap->expected], samples, p_tap->samples * sizeof(int16_t));
+                p_tap->expected += p_tap->samples;
+                p_tap->dropped  += pending[i];
+                p_tap->written  += 1;
+                pending[i]       = 0;
+            }
+            else
+            {
+                pending[i] += 1;
+            }
+        }
+
+        if ((period < HOST_STALL_START) || (period >= (HOST_STALL_START + HOST_STALL_LENGTH)))
+        {
+            host_read(HOST_READ_SIZE);
+        }
+    }
+
+    host_read(s_rtt_used);
+    probe_cmd("info", "");
+
+    // Start the capture in the middle of a frame: the decoder must skip its tail and find the next sync word.
+    memmove(&s_capture[100], &s_capture[0], s_capture_size);
+    memcpy(&s_capture[0], &s_capture[s_capture_size], 100);
+    s_capture_size += 100;
+
+    TEST_CHECK(file_write(argv[1], s_capture, s_capture_size));
+
+    for (i = 0; i < ARRAY_SIZE(s_taps); i++)
+    {
+        const tap_t *p_tap = &s_taps[i];
+
+        printf("%-8s %zu frames written, %zu dropped, %zu bytes expected\n",
+               p_tap->p_name, p_tap->written, p_tap->dropped, p_tap->expected * sizeof(int16_t));
+
+        TEST_CHECK(p_tap->dropped > 0);
+        TEST_CHECK(pending[i] == 0);
+
+        snprintf(path, sizeof(path), "%s_%s.wav", argv[2], p_tap->p_name);
+        TEST_CHECK(wav_write(path, p_tap->p_expected, p_tap->expected));
+    }
+
+    return TEST_RESULT();
+}
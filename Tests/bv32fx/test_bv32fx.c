@@ -0,0 +1,321 @@
+/**@file
+ *
+ * @brief Comparison of the fixed-point BV32 encoder with the floating-point reference.
+ *
+ * @details Both encoders code the same synthetic signals, and both bit streams are decoded with the
+ *          floating-point decoder used on the host side. The fixed-point port is not bit-exact, so the test
+ *          checks the decoded quality instead: the SNR and segmental SNR against the input must be within
+ *          MAX_SNR_LOSS_DB of the reference. Index agreement per quantizer and the host encoding time are
+ *          reported.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+#include "bv32.h"
+#include "bv32fx.h"
+
+#define FS                  16000
+#define SIGNAL_LENGTH       (10 * FS)
+#define MAX_DELAY           200         /**< Largest codec delay searched, in samples. */
+#define MAX_SNR_LOSS_DB     0.5
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct
+{
+    double  snr;
+    double  seg_snr;
+    double  time;
+} result_t;
+
+static short    s_input[SIGNAL_LENGTH];
+static short    s_output[2][SIGNAL_LENGTH];
+static uint32_t s_seed;
+
+static double noise(void)
+{
+    s_seed = (s_seed * 1664525) + 1013904223;
+
+    return (int32_t)s_seed / 2147483648.0;
+}
+
+/**@brief Second-order resonator used to shape formants. */
+static void resonate(double *p_x, size_t len, double freq, double bandwidth)
+{
+    double r  = exp(-M_PI * bandwidth / FS);
+    double a1 = -2.0 * r * cos(2.0 * M_PI * freq / FS);
+    double a2 = r * r;
+    double y1 = 0.0;
+    double y2 = 0.0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        double y = ((1.0 - r) * p_x[i]) - (a1 * y1) - (a2 * y2);
+
+        y2      = y1;
+        y1      = y;
+        p_x[i]  = y;
+    }
+}
+
+/**@brief Generate speech-like segments: voiced with formants and a pitch glide, unvoiced and silence.
+ *
+ * @param[in] f0_low    Lowest pitch frequency.
+ * @param[in] f0_high   Highest pitch frequency.
+ * @param[in] level_db  Peak level relative to full scale.
+ * @param[in] noise_rms Level of the added white noise.
+ */
+static void speech_generate(uint32_t seed, double f0_low, double f0_high, double level_db, double noise_rms)
+{
+    static double   x[SIGNAL_LENGTH];
+    double          peak = 0.0;
+    size_t          pos = 0;
+    size_t          i;
+
+    s_seed = seed;
+
+    while (pos < SIGNAL_LENGTH)
+    {
+        size_t  len = (size_t)((0.06 + 0.12 * (noise() + 1.0)) * FS);
+        int     kind = (int)((noise() + 1.0) * 2.5);
+        double  gain = pow(10.0, -7.5 * (noise() + 1.0) / 20.0);
+        double *p_seg = &x[pos];
+        double  seg_peak = 0.0;
+
+        len = MIN(len, SIGNAL_LENGTH - pos);
+
+        if (kind == 0)
+        {
+            for (i = 0; i < len; i++)
+            {
+                p_seg[i] = 0.0005 * noise();
+            }
+            gain = 0.0;
+        }
+        else if (kind == 1)
+        {
+            for (i = 0; i < len; i++)
+            {
+                p_seg[i] = noise();
+            }
+            resonate(p_seg, len, 4250.0 + 1750.0 * noise(), 1500.0);
+        }
+        else
+        {
+            double f0_start = f0_low + (f0_high - f0_low) * (noise() + 1.0) / 2.0;
+            double f0_end   = f0_low + (f0_high - f0_low) * (noise() + 1.0) / 2.0;
+            double phase    = 0.0;
+
+            for (i = 0; i < len; i++)
+            {
+                double f0 = f0_start + (f0_end - f0_start) * i / len;
+
+                phase      += f0 / FS;
+                p_seg[i]    = (phase >= 1.0) ? 1.0 : 0.0;
+                phase      -= floor(phase);
+            }
+            resonate(p_seg, len, 550.0 + 250.0 * noise(), 80.0);
+            resonate(p_seg, len, 1600.0 + 700.0 * noise(), 120.0);
+            resonate(p_seg, len, 2800.0 + 400.0 * noise(), 200.0);
+            for (i = 0; i < len; i++)
+            {
+                p_seg[i] += 0.002 * noise();
+            }
+        }
+
+        // Fade in and out over 20 ms, and normalize the segment.
+        for (i = 0; i < len; i++)
+        {
+            double env = MIN(1.0, MIN(i, len - 1 - i) / (0.02 * FS));
+
+            p_seg[i] *= env;
+            seg_peak  = MAX(seg_peak, fabs(p_seg[i]));
+        }
+        for (i = 0; (gain > 0.0) && (i < len); i++)
+        {
+            p_seg[i] *= gain / seg_peak;
+        }
+
+        pos += len;
+    }
+
+    for (i = 0; i < SIGNAL_LENGTH; i++)
+    {
+        peak = MAX(peak, fabs(x[i]));
+    }
+
+    for (i = 0; i < SIGNAL_LENGTH; i++)
+    {
+        double v = (x[i] / peak) * pow(10.0, level_db / 20.0) * 32767.0 + noise_rms * noise() * sqrt(3.0);
+
+        s_input[i] = (short)MAX(-32768.0, MIN(32767.0, v));
+    }
+}
+
+static void chirp_generate(void)
+{
+    size_t i;
+
+    for (i = 0; i < SIGNAL_LENGTH; i++)
+    {
+        double t = (double)i / FS;
+
+        s_input[i] = (short)(8000.0 * sin(2.0 * M_PI * (100.0 * t + (6900.0 / 20.0) * t * t)));
+    }
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + (ts.tv_nsec * 1e-9);
+}
+
+/**@brief Code the input with both encoders and compare the decoded signals with the input. */
+static void signal_compare(const char *p_name)
+{
+    static struct BV32_Encoder_State    fp_encoder;
+    static struct BV32FX_Encoder_State  fx_encoder;
+    static struct BV32_Decoder_State    decoder[2];
+    struct BV32_Bit_Stream              bs[2];
+    result_t                            result[2];
+    unsigned long                       agree[5] = { 0 };
+    size_t                              frames = SIGNAL_LENGTH / FRSZ;
+    size_t                              delay = 0;
+    double                              best_corr = -1.0;
+    size_t                              fr, i, k;
+
+    Reset_BV32_Coder(&fp_encoder);
+    Reset_BV32FX_Coder(&fx_encoder);
+    Reset_BV32_Decoder(&decoder[0]);
+    Reset_BV32_Decoder(&decoder[1]);
+    memset(result, 0, sizeof(result));
+
+    for (fr = 0; fr < frames; fr++)
+    {
+        short  *p_x = &s_input[fr * FRSZ];
+        double  start;
+
+        start = seconds();
+        BV32_Encode(&bs[0], &fp_encoder, p_x);
+        result[0].time += seconds() - start;
+
+        start = seconds();
+        BV32FX_Encode(&bs[1], &fx_encoder, p_x);
+        result[1].time += seconds() - start;
+
+        BV32_Decode(&bs[0], &decoder[0], &s_output[0][fr * FRSZ]);
+        BV32_Decode(&bs[1], &decoder[1], &s_output[1][fr * FRSZ]);
+
+        agree[0] += (memcmp(bs[0].lspidx, bs[1].lspidx, sizeof(bs[0].lspidx)) == 0);
+        agree[1] += (bs[0].ppidx == bs[1].ppidx);
+        agree[2] += (bs[0].bqidx == bs[1].bqidx);
+        agree[3] += (memcmp(bs[0].gidx, bs[1].gidx, sizeof(bs[0].gidx)) == 0);
+        for (i = 0; i < NVPSF; i++)
+        {
+            agree[4] += (bs[0].qvidx[i] == bs[1].qvidx[i]);
+        }
+    }
+
+    // Align the output of the reference with the input.
+    for (k = 0; k < MAX_DELAY; k++)
+    {
+        double corr = 0.0;
+
+        for (i = 0; (i + k) < SIGNAL_LENGTH; i++)
+        {
+            corr += (double)s_input[i] * s_output[0][i + k];
+        }
+
+        if (corr > best_corr)
+        {
+            best_corr   = corr;
+            delay       = k;
+        }
+    }
+
+    for (k = 0; k < 2; k++)
+    {
+        double  signal = 0.0;
+        double  error = 0.0;
+        size_t  seg_frames = 0;
+
+        for (fr = 0; ((fr + 1) * FRSZ + delay) <= SIGNAL_LENGTH; fr++)
+        {
+            double seg_signal = 0.0;
+            double seg_error = 0.0;
+
+            for (i = fr * FRSZ; i < (fr + 1) * FRSZ; i++)
+            {
+                double d = (double)s_input[i] - s_output[k][i + delay];
+
+                seg_signal  += (double)s_input[i] * s_input[i];
+                seg_error   += d * d;
+            }
+
+            signal  += seg_signal;
+            error   += seg_error;
+
+            // Segmental SNR over active frames only.
+            if (seg_signal > (FRSZ * 1e4))
+            {
+                result[k].seg_snr += 10.0 * log10(seg_signal / (seg_error + 1.0));
+                seg_frames++;
+            }
+        }
+
+        result[k].snr       = 10.0 * log10(signal / error);
+        result[k].seg_snr  /= MAX(seg_frames, 1);
+    }
+
+    printf("%-8s SNR %6.2f / %6.2f dB  segSNR %6.2f / %6.2f dB  "
+           "agreement lsp %3.0f%% pp %3.0f%% bq %3.0f%% g %3.0f%% qv %3.0f%%  time %5.1f / %5.1f us/frame\n",
+           p_name,
+           result[0].snr, result[1].snr,
+           result[0].seg_snr, result[1].seg_snr,
+           100.0 * agree[0] / frames, 100.0 * agree[1] / frames, 100.0 * agree[2] / frames,
+           100.0 * agree[3] / frames, 100.0 * agree[4] / (frames * NVPSF),
+           1e6 * result[0].time / frames, 1e6 * result[1].time / frames);
+
+    TEST_CHECK(result[1].snr >= (result[0].snr - MAX_SNR_LOSS_DB));
+    TEST_CHECK(result[1].seg_snr >= (result[0].seg_snr - MAX_SNR_LOSS_DB));
+}
+
+int main(void)
+{
+    printf("Float / fixed-point encoder, decoded with the float decoder:\n");
+
+    speech_generate(1, 85.0, 150.0, -3.0, 0.0);
+    signal_compare("male");
+
+    speech_generate(2, 170.0, 290.0, -6.0, 0.0);
+    signal_compare("female");
+
+    speech_generate(3, 250.0, 400.0, -10.0, 0.0);
+    signal_compare("child");
+
+    speech_generate(4, 100.0, 200.0, -40.0, 0.0);
+    signal_compare("quiet");
+
+    speech_generate(5, 100.0, 220.0, -8.0, 300.0);
+    signal_compare("noisy");
+
+    chirp_generate();
+    signal_compare("chirp");
+
+    return TEST_RESULT();
+}
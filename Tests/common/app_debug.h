@@ -0,0 +1,8 @@
+/* Stand-in for the Smart Remote header of the same name: debug pins are not used on the host. */
+#ifndef __APP_DEBUG_H__
+#define __APP_DEBUG_H__
+
+#define DBG_PIN_SET(pin)        do { } while (0)
+#define DBG_PIN_CLEAR(pin)      do { } while (0)
+
+#endif /* __APP_DEBUG_H__ */
@@ -0,0 +1,13 @@
+/* Stand-in for the SDK header of the same name: errors abort the test. */
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include "sdk_errors.h"
+
+#define APP_ERROR_CHECK(_err_code)      assert((_err_code) == NRF_SUCCESS)
+#define APP_ERROR_CHECK_BOOL(_bool)     assert(_bool)
+
+#endif // APP_ERROR_H__
@@ -0,0 +1,20 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef APP_GPIOTE_H__
+#define APP_GPIOTE_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+typedef uint8_t app_gpiote_user_id_t;
+typedef void (*app_gpiote_event_handler_t)(uint32_t const *p_event_pins_low_to_high,
+                                           uint32_t const *p_event_pins_high_to_low);
+
+ret_code_t app_gpiote_user_register(app_gpiote_user_id_t *p_user_id,
+                                    uint32_t const *p_pins_low_to_high_mask,
+                                    uint32_t const *p_pins_high_to_low_mask,
+                                    app_gpiote_event_handler_t event_handler);
+ret_code_t app_gpiote_user_enable(app_gpiote_user_id_t user_id);
+ret_code_t app_gpiote_user_disable(app_gpiote_user_id_t user_id);
+
+#endif // APP_GPIOTE_H__
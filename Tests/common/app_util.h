@@ -0,0 +1,68 @@
+/* Stand-in for the SDK header of the same name: the utility macros used by the firmware. */
+#ifndef APP_UTIL_H__
+#define APP_UTIL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compiler_abstraction.h"
+
+#define STATIC_ASSERT(_expr)                _Static_assert((_expr), #_expr)
+#define ARRAY_SIZE(_arr)                    (sizeof(_arr) / sizeof((_arr)[0]))
+#define CEIL_DIV(_a, _b)                    (((_a) + (_b) - 1) / (_b))
+#define ROUNDED_DIV(_a, _b)                 (((_a) + ((_b) / 2)) / (_b))
+#define ALIGN_NUM(_alignment, _number)      (((_number) - 1) + (_alignment) - (((_number) - 1) % (_alignment)))
+#define IS_POWER_OF_TWO(_a)                 (((_a) != 0) && ((((_a) - 1) & (_a)) == 0))
+#define BYTES_TO_WORDS(_bytes)              (((_bytes) + 3) >> 2)
+#define UNUSED_VARIABLE(_x)                 ((void)(_x))
+#define UNUSED_PARAMETER(_x)                ((void)(_x))
+#define UNUSED_RETURN_VALUE(_x)             ((void)(_x))
+
+#define LSB_16(_a)                          ((_a) & 0x00FF)
+#define MSB_16(_a)                          (((_a) & 0xFF00) >> 8)
+
+#ifndef MIN
+#define MIN(_a, _b)                         (((_a) < (_b)) ? (_a) : (_b))
+#endif
+#ifndef MAX
+#define MAX(_a, _b)                         (((_a) > (_b)) ? (_a) : (_b))
+#endif
+
+static inline uint8_t uint16_encode(uint16_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0x00FF) >> 0);
+    p_encoded_data[1] = (uint8_t) ((value & 0xFF00) >> 8);
+    return sizeof(uint16_t);
+}
+
+static inline uint8_t uint16_big_encode(uint16_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0xFF00) >> 8);
+    p_encoded_data[1] = (uint8_t) ((value & 0x00FF) >> 0);
+    return sizeof(uint16_t);
+}
+
+static inline uint8_t uint32_encode(uint32_t value, uint8_t * p_encoded_data)
+{
+    p_encoded_data[0] = (uint8_t) ((value & 0x000000FF) >> 0);
+    p_encoded_data[1] = (uint8_t) ((value & 0x0000FF00) >> 8);
+    p_encoded_data[2] = (uint8_t) ((value & 0x00FF0000) >> 16);
+    p_encoded_data[3] = (uint8_t) ((value & 0xFF000000) >> 24);
+    return sizeof(uint32_t);
+}
+
+static inline uint16_t uint16_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint16_t)p_encoded_data[0])) | (((uint16_t)p_encoded_data[1]) << 8));
+}
+
+static inline uint32_t uint32_decode(const uint8_t * p_encoded_data)
+{
+    return ((((uint32_t)p_encoded_data[0]) << 0)  |
+            (((uint32_t)p_encoded_data[1]) << 8)  |
+            (((uint32_t)p_encoded_data[2]) << 16) |
+            (((uint32_t)p_encoded_data[3]) << 24));
+}
+
+#endif // APP_UTIL_H__
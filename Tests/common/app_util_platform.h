@@ -0,0 +1,15 @@
+/* Stand-in for the SDK header of the same name. The tests are single-threaded, and anonymous unions are enabled
+ * by default in GCC. */
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include "compiler_abstraction.h"
+#include "sdk_errors.h"
+
+#define CRITICAL_REGION_ENTER()     do {
+#define CRITICAL_REGION_EXIT()      } while (0)
+
+#define ANON_UNIONS_ENABLE
+#define ANON_UNIONS_DISABLE
+
+#endif // APP_UTIL_PLATFORM_H__
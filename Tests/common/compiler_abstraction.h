@@ -0,0 +1,10 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef COMPILER_ABSTRACTION_H
+#define COMPILER_ABSTRACTION_H
+
+#define __INLINE                            inline
+#define __STATIC_INLINE                     static inline
+#define PACKED_STRUCT                       struct __attribute__((packed))
+#define __ALIGN(_n)                         __attribute__((aligned(_n)))
+
+#endif // COMPILER_ABSTRACTION_H
@@ -0,0 +1,17 @@
+/* Stand-in for the MDK header of the same name: the device family, the UICR base address, and the CMSIS
+ * intrinsics and functions used by the firmware. __CORTEX_M is not defined, so the audio gauges measure time
+ * with clock_gettime(). */
+#ifndef NRF_H
+#define NRF_H
+
+#include <stdint.h>
+
+#define NRF52_SERIES
+
+#define NRF_UICR_BASE           0x10001000UL
+
+#define __CLZ(_value)           __builtin_clz(_value)
+
+void NVIC_SystemReset(void);
+
+#endif // NRF_H
@@ -0,0 +1,40 @@
+/* Stand-in for the SDK header of the same name. The tests run in a single context. */
+#ifndef NRF_ATOMIC_H__
+#define NRF_ATOMIC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef volatile uint32_t nrf_atomic_u32_t;
+typedef volatile uint32_t nrf_atomic_flag_t;
+
+static inline uint32_t nrf_atomic_u32_add(nrf_atomic_u32_t *p_data, uint32_t value)
+{
+    return *p_data += value;
+}
+
+static inline bool nrf_atomic_flag_set_fetch(nrf_atomic_flag_t *p_flag)
+{
+    bool previous = *p_flag;
+    *p_flag = 1;
+    return previous;
+}
+
+static inline bool nrf_atomic_flag_clear_fetch(nrf_atomic_flag_t *p_flag)
+{
+    bool previous = *p_flag;
+    *p_flag = 0;
+    return previous;
+}
+
+static inline void nrf_atomic_flag_set(nrf_atomic_flag_t *p_flag)
+{
+    *p_flag = 1;
+}
+
+static inline void nrf_atomic_flag_clear(nrf_atomic_flag_t *p_flag)
+{
+    *p_flag = 0;
+}
+
+#endif // NRF_ATOMIC_H__
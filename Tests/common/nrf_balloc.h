@@ -0,0 +1,101 @@
+/* Stand-in for the SDK header of the same name: a stack of free blocks, as in the SDK. Freeing a block which
+ * does not belong to the pool or which is already free aborts the test. */
+#ifndef NRF_BALLOC_H__
+#define NRF_BALLOC_H__
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+typedef struct
+{
+    uint8_t **p_stack_pointer;
+    uint8_t   max_utilization;
+} nrf_balloc_cb_t;
+
+typedef struct
+{
+    nrf_balloc_cb_t *p_cb;
+    uint8_t        **p_stack_base;
+    uint8_t        **p_stack_limit;
+    uint8_t         *p_memory_begin;
+    size_t           block_size;
+    size_t           pool_size;
+} nrf_balloc_t;
+
+#define NRF_BALLOC_DEF(_name, _element_size, _pool_size)                        \
+    static uint8_t         *_name##_stack[(_pool_size)];                        \
+    static uint8_t          _name##_pool[(_pool_size)][(_element_size)]         \
+                            __attribute__((aligned(4)));                        \
+    static nrf_balloc_cb_t  _name##_cb;                                         \
+    static const nrf_balloc_t _name =                                           \
+    {                                                                           \
+        .p_cb           = &_name##_cb,                                          \
+        .p_stack_base   = _name##_stack,                                        \
+        .p_stack_limit  = _name##_stack + (_pool_size),                         \
+        .p_memory_begin = &_name##_pool[0][0],                                  \
+        .block_size     = (_element_size),                                      \
+        .pool_size      = (_pool_size),                                         \
+    }
+
+/**@brief Number of blocks currently allocated from the pool. */
+static inline size_t nrf_balloc_utilization_get(nrf_balloc_t const *p_pool)
+{
+    return p_pool->pool_size - (size_t)(p_pool->p_cb->p_stack_pointer - p_pool->p_stack_base);
+}
+
+static inline ret_code_t nrf_balloc_init(nrf_balloc_t const *p_pool)
+{
+    size_t i;
+
+    p_pool->p_cb->p_stack_pointer = p_pool->p_stack_base;
+    p_pool->p_cb->max_utilization = 0;
+
+    for (i = 0; i < p_pool->pool_size; i++)
+    {
+        *(p_pool->p_cb->p_stack_pointer++) = p_pool->p_memory_begin + (p_pool->pool_size - 1 - i) * p_pool->block_size;
+    }
+
+    return NRF_SUCCESS;
+}
+
+static inline void *nrf_balloc_alloc(nrf_balloc_t const *p_pool)
+{
+    if (p_pool->p_cb->p_stack_pointer == p_pool->p_stack_base)
+    {
+        return NULL;
+    }
+
+    if (p_pool->p_cb->max_utilization < nrf_balloc_utilization_get(p_pool) + 1)
+    {
+        p_pool->p_cb->max_utilization = nrf_balloc_utilization_get(p_pool) + 1;
+    }
+
+    return *(--p_pool->p_cb->p_stack_pointer);
+}
+
+static inline void nrf_balloc_free(nrf_balloc_t const *p_pool, void *p_element)
+{
+    uint8_t **pp_block;
+
+    assert(((uint8_t *)p_element >= p_pool->p_memory_begin) &&
+           ((uint8_t *)p_element < p_pool->p_memory_begin + p_pool->pool_size * p_pool->block_size) &&
+           ((((uint8_t *)p_element - p_pool->p_memory_begin) % p_pool->block_size) == 0));
+
+    for (pp_block = p_pool->p_stack_base; pp_block < p_pool->p_cb->p_stack_pointer; pp_block++)
+    {
+        assert(*pp_block != p_element);
+    }
+
+    assert(p_pool->p_cb->p_stack_pointer < p_pool->p_stack_limit);
+    *(p_pool->p_cb->p_stack_pointer++) = p_element;
+}
+
+static inline uint8_t nrf_balloc_max_utilization_get(nrf_balloc_t const *p_pool)
+{
+    return p_pool->p_cb->max_utilization;
+}
+
+#endif // NRF_BALLOC_H__
@@ -0,0 +1,60 @@
+/* Stand-in for the CLI header: the types used to declare commands, and printing to stdout. */
+#ifndef NRF_CLI_H__
+#define NRF_CLI_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "app_util.h"
+
+typedef struct nrf_cli nrf_cli_t;
+
+typedef void (*nrf_cli_cmd_handler)(nrf_cli_t const * p_cli, size_t argc, char **argv);
+
+typedef struct nrf_cli_cmd_entry nrf_cli_cmd_entry_t;
+
+typedef struct
+{
+    char const                  *p_syntax;
+    char const                  *p_help;
+    nrf_cli_cmd_entry_t const   *p_subcmd;
+    nrf_cli_cmd_handler         handler;
+} nrf_cli_static_entry_t;
+
+typedef void (*nrf_cli_dynamic_get)(size_t idx, nrf_cli_static_entry_t * p_static);
+
+struct nrf_cli_cmd_entry
+{
+    bool is_dynamic;
+    union
+    {
+        nrf_cli_dynamic_get             p_dynamic_get;
+        nrf_cli_static_entry_t const    *p_static;
+    } u;
+};
+
+typedef struct
+{
+    char const *p_optname;
+    char const *p_optname_short;
+    char const *p_optname_help;
+} nrf_cli_getopt_option_t;
+
+#define NRF_CLI_OPT(_p_optname, _p_shortname, _p_help)  { (_p_optname), (_p_shortname), (_p_help) }
+
+#define NRF_CLI_CREATE_DYNAMIC_CMD(_name, _p_get)       \
+    static nrf_cli_cmd_entry_t const _name =            \
+    {                                                   \
+        .is_dynamic         = true,                     \
+        .u.p_dynamic_get    = (_p_get),                 \
+    }
+
+#define NRF_CLI_NORMAL  0
+#define NRF_CLI_ERROR   1
+
+#define nrf_cli_fprintf(_p_cli, _color, ...)            printf(__VA_ARGS__)
+#define nrf_cli_help_requested(_p_cli)                  false
+#define nrf_cli_help_print(_p_cli, _p_opt, _opt_len)    ((void)(_p_opt))
+
+#endif // NRF_CLI_H__
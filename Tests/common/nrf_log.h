@@ -0,0 +1,17 @@
+/* Stand-in for the SDK header of the same name: logging is compiled out. ASSERT() comes with it, through
+ * sdk_common.h in the SDK. */
+#ifndef NRF_LOG_H__
+#define NRF_LOG_H__
+
+#include "nrf_assert.h"
+
+#define NRF_LOG_MODULE_REGISTER()
+#define NRF_LOG_ERROR(...)          do { } while (0)
+#define NRF_LOG_WARNING(...)        do { } while (0)
+#define NRF_LOG_INFO(...)           do { } while (0)
+#define NRF_LOG_DEBUG(...)          do { } while (0)
+#define NRF_LOG_RAW_INFO(...)       do { } while (0)
+#define NRF_LOG_HEXDUMP_DEBUG(...)  do { } while (0)
+#define NRF_LOG_FLUSH()             do { } while (0)
+
+#endif // NRF_LOG_H__
@@ -0,0 +1,33 @@
+/* Stand-in for the SDK header of the same name. Shutdown handlers are registered as constants which the tests
+ * call themselves, and nrf_pwr_mgmt_run() is implemented by the tests which wait. */
+#ifndef NRF_PWR_MGMT_H__
+#define NRF_PWR_MGMT_H__
+
+#include <stdbool.h>
+
+typedef enum
+{
+    NRF_PWR_MGMT_EVT_PREPARE_WAKEUP,
+    NRF_PWR_MGMT_EVT_PREPARE_SYSOFF,
+    NRF_PWR_MGMT_EVT_PREPARE_DFU,
+    NRF_PWR_MGMT_EVT_PREPARE_RESET,
+} nrf_pwr_mgmt_evt_t;
+
+typedef enum
+{
+    NRF_PWR_MGMT_SHUTDOWN_GOTO_SYSOFF,
+    NRF_PWR_MGMT_SHUTDOWN_STAY_IN_SYSOFF,
+    NRF_PWR_MGMT_SHUTDOWN_GOTO_DFU,
+    NRF_PWR_MGMT_SHUTDOWN_RESET,
+    NRF_PWR_MGMT_SHUTDOWN_CONTINUE,
+} nrf_pwr_mgmt_shutdown_t;
+
+typedef bool (*nrf_pwr_mgmt_shutdown_handler_t)(nrf_pwr_mgmt_evt_t event);
+
+#define NRF_PWR_MGMT_HANDLER_REGISTER(_handler, _priority)  \
+    nrf_pwr_mgmt_shutdown_handler_t const _handler##_registered = _handler
+
+void nrf_pwr_mgmt_run(void);
+void nrf_pwr_mgmt_shutdown(nrf_pwr_mgmt_shutdown_t shutdown_type);
+
+#endif // NRF_PWR_MGMT_H__
@@ -0,0 +1,113 @@
+/* Stand-in for the SDK header of the same name: a ring buffer with the same interface, no-overflow mode only. */
+#ifndef NRF_QUEUE_H__
+#define NRF_QUEUE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_QUEUE_MODE_OVERFLOW,
+    NRF_QUEUE_MODE_NO_OVERFLOW,
+} nrf_queue_mode_t;
+
+typedef struct
+{
+    size_t front;
+    size_t back;
+    size_t max_utilization;
+} nrf_queue_cb_t;
+
+typedef struct
+{
+    nrf_queue_cb_t *p_cb;
+    void           *p_buffer;
+    size_t          size;
+    size_t          element_size;
+} nrf_queue_t;
+
+#define NRF_QUEUE_DEF(_type, _name, _size, _mode)                   \
+    static _type          _name##_buffer[(_size) + 1];              \
+    static nrf_queue_cb_t _name##_cb;                               \
+    static const nrf_queue_t _name =                                \
+    {                                                               \
+        .p_cb         = &_name##_cb,                                \
+        .p_buffer     = _name##_buffer,                             \
+        .size         = (_size),                                    \
+        .element_size = sizeof(_type),                              \
+    }
+
+static inline size_t nrf_queue_utilization_get(nrf_queue_t const *p_queue)
+{
+    return (p_queue->p_cb->back + p_queue->size + 1 - p_queue->p_cb->front) % (p_queue->size + 1);
+}
+
+static inline bool nrf_queue_is_empty(nrf_queue_t const *p_queue)
+{
+    return nrf_queue_utilization_get(p_queue) == 0;
+}
+
+static inline bool nrf_queue_is_full(nrf_queue_t const *p_queue)
+{
+    return nrf_queue_utilization_get(p_queue) == p_queue->size;
+}
+
+static inline size_t nrf_queue_max_utilization_get(nrf_queue_t const *p_queue)
+{
+    return p_queue->p_cb->max_utilization;
+}
+
+static inline ret_code_t nrf_queue_push(nrf_queue_t const *p_queue, void const *p_element)
+{
+    nrf_queue_cb_t *p_cb = p_queue->p_cb;
+
+    if (nrf_queue_is_full(p_queue))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memcpy((uint8_t *)p_queue->p_buffer + p_cb->back * p_queue->element_size, p_element, p_queue->element_size);
+    p_cb->back = (p_cb->back + 1) % (p_queue->size + 1);
+
+    if (p_cb->max_utilization < nrf_queue_utilization_get(p_queue))
+    {
+        p_cb->max_utilization = nrf_queue_utilization_get(p_queue);
+    }
+
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t nrf_queue_peek(nrf_queue_t const *p_queue, void *p_element)
+{
+    nrf_queue_cb_t *p_cb = p_queue->p_cb;
+
+    if (nrf_queue_is_empty(p_queue))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    memcpy(p_element, (uint8_t *)p_queue->p_buffer + p_cb->front * p_queue->element_size, p_queue->element_size);
+
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t nrf_queue_pop(nrf_queue_t const *p_queue, void *p_element)
+{
+    nrf_queue_cb_t *p_cb = p_queue->p_cb;
+
+    if (nrf_queue_is_empty(p_queue))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    memcpy(p_element, (uint8_t *)p_queue->p_buffer + p_cb->front * p_queue->element_size, p_queue->element_size);
+    p_cb->front = (p_cb->front + 1) % (p_queue->size + 1);
+
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_QUEUE_H__
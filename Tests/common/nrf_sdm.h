@@ -0,0 +1,16 @@
+/* Stand-in for the SoftDevice header of the same name. The SoftDevice information is read from the given address. */
+#ifndef NRF_SDM_H__
+#define NRF_SDM_H__
+
+#include <stdint.h>
+
+#define SD_INFO_STRUCT_OFFSET       0x2000
+#define SD_SIZE_OFFSET              (SD_INFO_STRUCT_OFFSET + 0x08)
+#define SD_FWID_OFFSET              (SD_INFO_STRUCT_OFFSET + 0x0C)
+#define SD_VERSION_OFFSET           (SD_INFO_STRUCT_OFFSET + 0x14)
+
+#define SD_SIZE_GET(_base)          (*((uint32_t *)((_base) + SD_SIZE_OFFSET)))
+#define SD_FWID_GET(_base)          (*((uint16_t *)((_base) + SD_FWID_OFFSET)))
+#define SD_VERSION_GET(_base)       (*((uint32_t *)((_base) + SD_VERSION_OFFSET)))
+
+#endif // NRF_SDM_H__
@@ -0,0 +1,16 @@
+/* Stand-in for the SDK header of the same name: a section is an array defined by the test, and registered items
+ * are dropped. */
+#ifndef NRF_SECTION_H__
+#define NRF_SECTION_H__
+
+#include <stddef.h>
+
+#define NRF_SECTION_DEF(_section_name, _data_type)                  \
+    extern _data_type _section_name##_items[];                      \
+    extern size_t     _section_name##_count
+
+#define NRF_SECTION_ITEM_COUNT(_section_name, _data_type)           (_section_name##_count)
+#define NRF_SECTION_ITEM_GET(_section_name, _data_type, _i)         (&_section_name##_items[(_i)])
+#define NRF_SECTION_ITEM_REGISTER(_section_name, _section_var)
+
+#endif // NRF_SECTION_H__
@@ -0,0 +1,53 @@
+/* Stand-in for the SDK header of the same name: the transaction types, executed by the bus model of the test. */
+#ifndef NRF_TWI_MNGR_H__
+#define NRF_TWI_MNGR_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define NRF_TWI_MNGR_NO_STOP            0x01
+
+#define NRF_TWI_MNGR_READ_OP(_address)  (((_address) << 1) | 1)
+#define NRF_TWI_MNGR_WRITE_OP(_address) ((_address) << 1)
+#define NRF_TWI_MNGR_IS_READ_OP(_op)    ((_op) & 1)
+
+#define NRF_TWI_MNGR_TRANSFER(_operation, _p_data, _length, _flags) \
+    {                                                               \
+        .p_data    = (uint8_t *)(_p_data),                          \
+        .length    = _length,                                       \
+        .operation = _operation,                                    \
+        .flags     = _flags                                         \
+    }
+
+#define NRF_TWI_MNGR_WRITE(_address, _p_data, _length, _flags)     \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_WRITE_OP(_address), _p_data, _length, _flags)
+
+#define NRF_TWI_MNGR_READ(_address, _p_data, _length, _flags)      \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_READ_OP(_address), _p_data, _length, _flags)
+
+typedef struct
+{
+    uint32_t frequency;
+} nrf_drv_twi_config_t;
+
+typedef struct
+{
+    uint8_t   * p_data;
+    uint8_t     length;
+    uint8_t     operation;
+    uint8_t     flags;
+} nrf_twi_mngr_transfer_t;
+
+typedef void (*nrf_twi_mngr_callback_t)(ret_code_t result, void *p_user_data);
+
+typedef struct
+{
+    nrf_twi_mngr_callback_t         callback;
+    void                          * p_user_data;
+    nrf_twi_mngr_transfer_t const * p_transfers;
+    uint8_t                         number_of_transfers;
+    nrf_drv_twi_config_t const    * p_required_twi_cfg;
+} nrf_twi_mngr_transaction_t;
+
+#endif // NRF_TWI_MNGR_H__
@@ -0,0 +1,11 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef SDK_ERRORS_H__
+#define SDK_ERRORS_H__
+
+#include <stdint.h>
+
+#include "nrf_error.h"
+
+typedef uint32_t ret_code_t;
+
+#endif // SDK_ERRORS_H__
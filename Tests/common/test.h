@@ -0,0 +1,33 @@
+/**@file
+ *
+ * @brief Minimal helpers shared by the host tests.
+ *
+ * @details Every test is a single program built from the test source and the firmware sources under test.
+ *          SDK headers are replaced by the stand-ins in this directory and in the test directory.
+ */
+#ifndef TEST_H__
+#define TEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int s_test_failures;
+
+/**@brief Record a failure if the condition does not hold. */
+#define TEST_CHECK(_cond)                                                           \
+    do                                                                              \
+    {                                                                               \
+        if (!(_cond))                                                               \
+        {                                                                           \
+            s_test_failures++;                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #_cond);        \
+        }                                                                           \
+    } while (0)
+
+/**@brief Print the summary and return the process exit code. */
+#define TEST_RESULT()                                                               \
+    (printf("%s: %s (%d failed checks)\n", __FILE__,                                \
+            (s_test_failures == 0) ? "PASS" : "FAIL", s_test_failures),             \
+     (s_test_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif // TEST_H__
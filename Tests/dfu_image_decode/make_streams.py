@@ -0,0 +1,93 @@
+"""Generate the images and streams decoded by test_dfu_image_decode.
+
+Writes the files and cases.txt into the given directory. Every line of cases.txt holds:
+<name> <ok|reject> <current application> <expected image> <stream> <image size>
+"""
+
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', '..', 'Tools'))
+import dfu_image_encode  # noqa: E402
+
+
+def firmware_like(rng, size):
+    """Code-like content: a small vocabulary of instruction words, tables and zero padding."""
+    words = [rng.getrandbits(16).to_bytes(2, 'little') for _ in range(300)]
+    data = bytearray()
+    while len(data) < size:
+        kind = rng.random()
+        if kind < 0.8:
+            data += b''.join(rng.choice(words) for _ in range(rng.randint(4, 40)))
+        elif kind < 0.95:
+            data += bytes(rng.getrandbits(8) for _ in range(rng.randint(8, 64)))
+        else:
+            data += bytes(rng.randint(16, 256))
+    return data[:size]
+
+
+def modified(rng, base):
+    """A new build of base: edited, inserted and removed regions and a longer end."""
+    data = bytearray(base)
+    for _ in range(20):
+        pos = rng.randrange(len(data))
+        op = rng.random()
+        if op < 0.4:
+            data[pos:pos + 4] = rng.getrandbits(32).to_bytes(4, 'little')
+        elif op < 0.7:
+            data[pos:pos] = bytes(rng.getrandbits(8) for _ in range(rng.randint(1, 200)))
+        else:
+            del data[pos:pos + rng.randint(1, 200)]
+    data += firmware_like(rng, 3000)
+    return data
+
+
+def main(out_dir):
+    rng = random.Random(30)
+    os.makedirs(out_dir, exist_ok=True)
+    cases = []
+
+    def write(name, data):
+        with open(os.path.join(out_dir, name), 'wb') as f:
+            f.write(data)
+        return name
+
+    def case(name, expect, base, image, stream, image_size=None):
+        cases.append('{} {} {} {} {} {}'.format(
+            name, expect, write(name + '.base', base), write(name + '.image', image),
+            write(name + '.stream', stream), len(image) if image_size is None else image_size))
+
+    v1 = firmware_like(rng, 60000)
+    v2 = modified(rng, v1)
+    empty = bytes()
+
+    compressed = dfu_image_encode.encode(v1)
+    delta = dfu_image_encode.encode(v2, v1)
+
+    case('compressed', 'ok', v1, v1, compressed)
+    case('compressed_odd_size', 'ok', v1, v1[:-77], dfu_image_encode.encode(v1[:-77]))
+    case('delta', 'ok', v1, v2, delta)
+    case('delta_self_reference', 'ok', v2, v2 + v2[:5000], dfu_image_encode.encode(v2 + v2[:5000], v2))
+    case('empty_base', 'ok', empty, v2, dfu_image_encode.encode(v2))
+
+    # The stream must be rejected when it does not match the image or the current application.
+    changed_base = bytearray(v1)
+    changed_base[100] ^= 0xFF
+    bad_magic = bytearray(compressed)
+    bad_magic[0] ^= 0x01
+    case('delta_wrong_base', 'reject', changed_base, v2, delta)
+    case('delta_no_base', 'reject', empty, v2, delta)
+    case('bad_magic', 'reject', v1, v1, bad_magic)
+    case('truncated', 'reject', v1, v2, delta[:-10])
+    case('image_too_short', 'reject', v1, v2, delta, len(v2) - 1)
+    case('image_too_long', 'reject', v1, v2, delta, len(v2) + 1)
+
+    with open(os.path.join(out_dir, 'cases.txt'), 'w') as f:
+        f.write('\n'.join(cases) + '\n')
+
+    print('{}: image {} B, compressed {} B, delta {} B'.format(out_dir, len(v2), len(compressed), len(delta)))
+
+
+if __name__ == '__main__':
+    main(sys.argv[1])
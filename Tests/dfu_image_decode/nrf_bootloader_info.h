@@ -0,0 +1,11 @@
+/* Stand-in for the bootloader header of the same name. The application area is provided by the test. */
+#ifndef NRF_BOOTLOADER_INFO_H__
+#define NRF_BOOTLOADER_INFO_H__
+
+#include <stdint.h>
+
+extern uint32_t g_test_app_start_addr;
+
+#define MAIN_APPLICATION_START_ADDR g_test_app_start_addr
+
+#endif // NRF_BOOTLOADER_INFO_H__
@@ -0,0 +1,19 @@
+/* Stand-in for the bootloader header of the same name. The functions are implemented by the test. */
+#ifndef NRF_DFU_FLASH_H__
+#define NRF_DFU_FLASH_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+typedef struct
+{
+    ret_code_t result;
+} nrf_fstorage_evt_t;
+
+typedef void (*dfu_flash_callback_t)(nrf_fstorage_evt_t * p_evt);
+
+ret_code_t nrf_dfu_flash_store(uint32_t dest, void const * p_src, uint32_t len, dfu_flash_callback_t callback);
+ret_code_t nrf_dfu_flash_erase(uint32_t page_addr, uint32_t num_pages, dfu_flash_callback_t callback);
+
+#endif // NRF_DFU_FLASH_H__
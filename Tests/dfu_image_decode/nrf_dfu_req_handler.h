@@ -0,0 +1,18 @@
+/* Stand-in for the bootloader header of the same name: only the result codes. */
+#ifndef NRF_DFU_REQ_HANDLER_H__
+#define NRF_DFU_REQ_HANDLER_H__
+
+typedef enum
+{
+    NRF_DFU_RES_CODE_INVALID                 = 0x00,
+    NRF_DFU_RES_CODE_SUCCESS                 = 0x01,
+    NRF_DFU_RES_CODE_OP_CODE_NOT_SUPPORTED   = 0x02,
+    NRF_DFU_RES_CODE_INVALID_PARAMETER       = 0x03,
+    NRF_DFU_RES_CODE_INSUFFICIENT_RESOURCES  = 0x04,
+    NRF_DFU_RES_CODE_INVALID_OBJECT          = 0x05,
+    NRF_DFU_RES_CODE_UNSUPPORTED_TYPE        = 0x07,
+    NRF_DFU_RES_CODE_OPERATION_NOT_PERMITTED = 0x08,
+    NRF_DFU_RES_CODE_OPERATION_FAILED        = 0x0A,
+} nrf_dfu_res_code_t;
+
+#endif // NRF_DFU_REQ_HANDLER_H__
@@ -0,0 +1,9 @@
+/* Stand-in for the bootloader header of the same name. */
+#ifndef NRF_DFU_SETTINGS_H__
+#define NRF_DFU_SETTINGS_H__
+
+#include "nrf_dfu_types.h"
+
+extern nrf_dfu_settings_t s_dfu_settings;
+
+#endif // NRF_DFU_SETTINGS_H__
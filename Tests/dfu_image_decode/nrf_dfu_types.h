@@ -0,0 +1,24 @@
+/* Stand-in for the bootloader header of the same name: only the fields used by the decoder. */
+#ifndef NRF_DFU_TYPES_H__
+#define NRF_DFU_TYPES_H__
+
+#include <stdint.h>
+
+#define CODE_PAGE_SIZE          4096
+#define NRF_DFU_BANK_INVALID    0x00
+#define NRF_DFU_BANK_VALID_APP  0x01
+
+typedef struct
+{
+    uint32_t image_size;
+    uint32_t image_crc;
+    uint32_t bank_code;
+} nrf_dfu_bank_t;
+
+typedef struct
+{
+    nrf_dfu_bank_t bank_0;
+    nrf_dfu_bank_t bank_1;
+} nrf_dfu_settings_t;
+
+#endif // NRF_DFU_TYPES_H__
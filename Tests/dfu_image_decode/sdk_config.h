@@ -0,0 +1,7 @@
+/* Bootloader configuration used by the test. */
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+#define FLASH_BUFFER_LENGTH 128
+
+#endif // SDK_CONFIG_H
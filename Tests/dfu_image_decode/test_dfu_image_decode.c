@@ -0,0 +1,251 @@
+/**@file
+ *
+ * @brief Round-trip test of the encoded application image decoder.
+ *
+ * @details Streams produced by Tools/dfu_image_encode.py are decoded by dfu_image_decode.c into emulated flash.
+ *          The decoded image must match the original one, and invalid streams must be rejected. Flash stores
+ *          complete asynchronously and can only clear bits, as on the device.
+ *
+ *          Usage: test_dfu_image_decode <directory with cases.txt>
+ */
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "test.h"
+#include "crc32.h"
+#include "dfu_image_decode.h"
+#include "nrf_dfu_flash.h"
+#include "nrf_dfu_settings.h"
+#include "sdk_config.h"
+
+#define FLASH_SIZE          (8u << 20)
+#define APP_OFFSET          0               /**< Current application. */
+#define IMAGE_OFFSET        (2u << 20)      /**< Decoded image area. */
+#define STREAM_OFFSET       (5u << 20)      /**< Received stream. */
+#define AREA_SIZE           (2u << 20)
+#define BUFFER_COUNT        3
+#define STORE_QUEUE_SIZE    16
+
+typedef struct
+{
+    uint32_t                dest;
+    uint8_t                 data[FLASH_BUFFER_LENGTH];
+    uint32_t                len;
+    dfu_flash_callback_t    callback;
+} store_op_t;
+
+nrf_dfu_settings_t  s_dfu_settings;
+uint32_t            g_test_app_start_addr;
+
+static uint8_t     *s_flash;
+static uint8_t      s_buffers[BUFFER_COUNT][FLASH_BUFFER_LENGTH];
+static store_op_t   s_store_queue[STORE_QUEUE_SIZE];
+static size_t       s_store_head;
+static size_t       s_store_tail;
+static bool         s_unerased_write;
+static bool         s_out_of_area_write;
+static int          s_result;
+
+uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc)
+{
+    uint32_t crc = (p_crc == NULL) ? 0xFFFFFFFF : ~(*p_crc);
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= p_data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+ret_code_t nrf_dfu_flash_store(uint32_t dest, void const * p_src, uint32_t len, dfu_flash_callback_t callback)
+{
+    store_op_t *p_op;
+
+    if ((s_store_tail - s_store_head) == STORE_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // Like fstorage, copy the data only when the operation is executed.
+    p_op            = &s_store_queue[s_store_tail++ % STORE_QUEUE_SIZE];
+    p_op->dest      = dest;
+    p_op->len       = len;
+    p_op->callback  = callback;
+    memcpy(p_op->data, p_src, len);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_dfu_flash_erase(uint32_t page_addr, uint32_t num_pages, dfu_flash_callback_t callback)
+{
+    nrf_fstorage_evt_t evt = { .result = NRF_SUCCESS };
+
+    memset((void *)(uintptr_t)page_addr, 0xFF, num_pages * CODE_PAGE_SIZE);
+    callback(&evt);
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Execute queued flash stores until none is left. */
+static void flash_run(void)
+{
+    while (s_store_head != s_store_tail)
+    {
+        store_op_t         *p_op = &s_store_queue[s_store_head++ % STORE_QUEUE_SIZE];
+        uint8_t            *p_dest = (uint8_t *)(uintptr_t)p_op->dest;
+        nrf_fstorage_evt_t  evt = { .result = NRF_SUCCESS };
+
+        if ((p_dest < s_flash + IMAGE_OFFSET) || (p_dest + p_op->len > s_flash + IMAGE_OFFSET + AREA_SIZE))
+        {
+            s_out_of_area_write = true;
+        }
+
+        for (uint32_t i = 0; i < p_op->len; i++)
+        {
+            if (p_dest[i] != 0xFF)
+            {
+                s_unerased_write = true;
+            }
+
+            // Programming can only clear bits.
+            p_dest[i] &= p_op->data[i];
+        }
+
+        p_op->callback(&evt);
+    }
+}
+
+static void decode_completed(nrf_dfu_res_code_t res_code)
+{
+    s_result = res_code;
+}
+
+static size_t file_load(const char *p_dir, const char *p_name, uint8_t *p_dest)
+{
+    char    path[512];
+    FILE   *p_file;
+    size_t  size;
+
+    snprintf(path, sizeof(path), "%s/%s", p_dir, p_name);
+    p_file = fopen(path, "rb");
+    if (p_file == NULL)
+    {
+        printf("Cannot open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    size = fread(p_dest, 1, AREA_SIZE, p_file);
+    fclose(p_file);
+
+    return size;
+}
+
+/**@brief Decode one stream and check the result. */
+static void test_case(const char *p_dir, const char *p_line)
+{
+    static uint8_t  expected[AREA_SIZE];
+    char            name[64], expect[16], base[128], image[128], stream[128];
+    unsigned long   image_size;
+    size_t          base_size, expected_size, stream_size;
+    int             res_code;
+    bool            ok;
+
+    if (sscanf(p_line, "%63s %15s %127s %127s %127s %lu", name, expect, base, image, stream, &image_size) != 6)
+    {
+        return;
+    }
+
+    memset(s_flash, 0xFF, FLASH_SIZE);
+    base_size       = file_load(p_dir, base, s_flash + APP_OFFSET);
+    expected_size   = file_load(p_dir, image, expected);
+    stream_size     = file_load(p_dir, stream, s_flash + STREAM_OFFSET);
+
+    s_dfu_settings.bank_0.bank_code     = (base_size != 0) ? NRF_DFU_BANK_VALID_APP : NRF_DFU_BANK_INVALID;
+    s_dfu_settings.bank_0.image_size    = base_size;
+    s_unerased_write                    = false;
+    s_out_of_area_write                 = false;
+    s_result                            = -1;
+
+    res_code = dfu_image_decode_start((uint32_t)(uintptr_t)(s_flash + IMAGE_OFFSET),
+                                      image_size,
+                                      (uint32_t)(uintptr_t)(s_flash + STREAM_OFFSET),
+                                      stream_size,
+                                      s_buffers,
+                                      BUFFER_COUNT,
+                                      decode_completed);
+    if (res_code == NRF_DFU_RES_CODE_SUCCESS)
+    {
+        flash_run();
+        res_code = s_result;
+    }
+
+    ok = (res_code == NRF_DFU_RES_CODE_SUCCESS);
+    printf("%-24s %s\n", name, ok ? "decoded" : "rejected");
+
+    TEST_CHECK(!s_unerased_write);
+    TEST_CHECK(!s_out_of_area_write);
+
+    if (strcmp(expect, "ok") == 0)
+    {
+        TEST_CHECK(ok);
+        TEST_CHECK(image_size == expected_size);
+        TEST_CHECK(memcmp(s_flash + IMAGE_OFFSET, expected, expected_size) == 0);
+
+        // The bank CRC is computed over the decoded image, and must match the CRC of the original image.
+        TEST_CHECK(crc32_compute(s_flash + IMAGE_OFFSET, image_size, NULL) ==
+                   crc32_compute(expected, expected_size, NULL));
+    }
+    else
+    {
+        TEST_CHECK(!ok);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char    path[512];
+    char    line[1024];
+    FILE   *p_cases;
+
+    if (argc != 2)
+    {
+        printf("Usage: %s <directory with cases.txt>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The decoder works with 32-bit flash addresses.
+    s_flash = mmap(NULL, FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (s_flash == MAP_FAILED)
+    {
+        printf("Cannot map the emulated flash\n");
+        return EXIT_FAILURE;
+    }
+
+    g_test_app_start_addr = (uint32_t)(uintptr_t)(s_flash + APP_OFFSET);
+
+    snprintf(path, sizeof(path), "%s/cases.txt", argv[1]);
+    p_cases = fopen(path, "r");
+    if (p_cases == NULL)
+    {
+        printf("Cannot open %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    while (fgets(line, sizeof(line), p_cases) != NULL)
+    {
+        test_case(argv[1], line);
+    }
+
+    fclose(p_cases);
+
+    return TEST_RESULT();
+}
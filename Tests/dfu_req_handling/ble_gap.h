@@ -0,0 +1,48 @@
+/* Stand-in for the SoftDevice header of the same name: the key and address types of the bootloader settings. */
+#ifndef BLE_GAP_H__
+#define BLE_GAP_H__
+
+#include <stdint.h>
+
+#define BLE_GAP_ADDR_LEN                    6
+#define BLE_GAP_SEC_KEY_LEN                 16
+
+typedef struct
+{
+    uint8_t addr_id_peer : 1;
+    uint8_t addr_type    : 7;
+    uint8_t addr[BLE_GAP_ADDR_LEN];
+} ble_gap_addr_t;
+
+typedef struct
+{
+    uint8_t irk[BLE_GAP_SEC_KEY_LEN];
+} ble_gap_irk_t;
+
+typedef struct
+{
+    ble_gap_irk_t  id_info;
+    ble_gap_addr_t id_addr_info;
+} ble_gap_id_key_t;
+
+typedef struct
+{
+    uint8_t ltk[BLE_GAP_SEC_KEY_LEN];
+    uint8_t lesc     : 1;
+    uint8_t auth     : 1;
+    uint8_t ltk_len  : 6;
+} ble_gap_enc_info_t;
+
+typedef struct
+{
+    uint16_t ediv;
+    uint8_t  rand[8];
+} ble_gap_master_id_t;
+
+typedef struct
+{
+    ble_gap_enc_info_t  enc_info;
+    ble_gap_master_id_t master_id;
+} ble_gap_enc_key_t;
+
+#endif // BLE_GAP_H__
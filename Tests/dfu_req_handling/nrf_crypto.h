@@ -0,0 +1,67 @@
+/* Stand-in for the SDK header of the same name. The functions are implemented by the test. */
+#ifndef NRF_CRYPTO_H__
+#define NRF_CRYPTO_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define NRF_CRYPTO_HASH_SIZE_SHA256                 32
+#define NRF_CRYPTO_ECDSA_SIGNATURE_SIZE_SECP256R1   64
+
+typedef enum
+{
+    NRF_CRYPTO_HASH_TYPE_SHA256,
+} nrf_crypto_hash_type_t;
+
+typedef enum
+{
+    NRF_CRYPTO_CURVE_SECP256R1,
+} nrf_crypto_curve_type_t;
+
+typedef enum
+{
+    NRF_CRYPTO_ENDIAN_LE,
+} nrf_crypto_endian_t;
+
+typedef struct
+{
+    nrf_crypto_hash_type_t  hash_type;
+    nrf_crypto_endian_t     endian_type;
+} nrf_crypto_hash_info_t;
+
+typedef struct
+{
+    nrf_crypto_curve_type_t curve_type;
+    nrf_crypto_hash_type_t  hash_type;
+    nrf_crypto_endian_t     endian_type;
+} nrf_crypto_signature_info_t;
+
+typedef struct
+{
+    uint8_t  * p_value;
+    uint32_t   length;
+} nrf_value_length_t;
+
+#define NRF_CRYPTO_ECC_PUBLIC_KEY_RAW_CREATE_FROM_ARRAY(_name, _curve, _array)                     \
+    static nrf_value_length_t _name = { .p_value = (uint8_t *)(_array), .length = sizeof(_array) }
+
+#define NRF_CRYPTO_ECDSA_SIGNATURE_CREATE(_name, _curve)                                            \
+    static uint8_t _name##_buffer[NRF_CRYPTO_ECDSA_SIGNATURE_SIZE_##_curve];                        \
+    static nrf_value_length_t _name = { .p_value = _name##_buffer, .length = sizeof(_name##_buffer) }
+
+#define NRF_CRYPTO_HASH_CREATE(_name, _type)                                                        \
+    static uint8_t _name##_buffer[NRF_CRYPTO_HASH_SIZE_##_type];                                    \
+    static nrf_value_length_t _name = { .p_value = _name##_buffer, .length = sizeof(_name##_buffer) }
+
+ret_code_t nrf_crypto_hash_compute(nrf_crypto_hash_info_t     hash_info,
+                                   uint8_t            const * p_data,
+                                   uint32_t                   len,
+                                   nrf_value_length_t       * p_hash);
+
+ret_code_t nrf_crypto_ecdsa_verify_hash(nrf_crypto_signature_info_t         sig_info,
+                                        nrf_value_length_t          const * p_p_key,
+                                        nrf_value_length_t          const * p_hash,
+                                        nrf_value_length_t          const * p_signature);
+
+#endif // NRF_CRYPTO_H__
@@ -0,0 +1,29 @@
+/* Stand-in for the SDK header of the same name: the event passed to the flash callbacks. */
+#ifndef NRF_FSTORAGE_H__
+#define NRF_FSTORAGE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_FSTORAGE_EVT_WRITE_RESULT,
+    NRF_FSTORAGE_EVT_ERASE_RESULT,
+} nrf_fstorage_evt_id_t;
+
+typedef struct
+{
+    nrf_fstorage_evt_id_t   id;
+    ret_code_t              result;
+    uint32_t                addr;
+    uint32_t                len;
+    void                  * p_param;
+} nrf_fstorage_evt_t;
+
+typedef void (*nrf_fstorage_evt_handler_t)(nrf_fstorage_evt_t * p_evt);
+
+bool nrf_fstorage_is_busy(void const * p_fs);
+
+#endif // NRF_FSTORAGE_H__
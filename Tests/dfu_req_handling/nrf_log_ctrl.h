@@ -0,0 +1,7 @@
+/* Stand-in for the SDK header of the same name: logging is compiled out. */
+#ifndef NRF_LOG_CTRL_H
+#define NRF_LOG_CTRL_H
+
+#include "nrf_log.h"
+
+#endif // NRF_LOG_CTRL_H
@@ -0,0 +1,8 @@
+/* Stand-in for the SoftDevice header of the same name. */
+#ifndef NRF_MBR_H__
+#define NRF_MBR_H__
+
+#define MBR_SIZE                    0x1000
+#define MBR_PAGE_SIZE_IN_WORDS      1024
+
+#endif // NRF_MBR_H__
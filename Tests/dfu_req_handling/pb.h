@@ -0,0 +1,38 @@
+/* Stand-in for the nanopb header of the same name: the types used by the generated DFU messages. */
+#ifndef PB_H_INCLUDED
+#define PB_H_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PB_PROTO_HEADER_VERSION     30
+
+#define PB_BYTES_ARRAY_T(_n)        struct { pb_size_t size; uint8_t bytes[_n]; }
+
+typedef uint_least16_t pb_size_t;
+
+typedef enum
+{
+    PB_WT_VARINT = 0,
+    PB_WT_64BIT  = 1,
+    PB_WT_STRING = 2,
+    PB_WT_32BIT  = 5,
+} pb_wire_type_t;
+
+typedef struct pb_field_s
+{
+    uint8_t      tag;
+    void const * ptr;
+} pb_field_t;
+
+typedef struct pb_istream_s pb_istream_t;
+
+struct pb_istream_s
+{
+    void    * state;
+    size_t    bytes_left;
+    void   (* decoding_callback)(pb_istream_t * stream, uint32_t tag, pb_wire_type_t wire_type, void * iter);
+};
+
+#endif // PB_H_INCLUDED
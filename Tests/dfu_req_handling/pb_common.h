@@ -0,0 +1,13 @@
+/* Stand-in for the nanopb header of the same name. */
+#ifndef PB_COMMON_H_INCLUDED
+#define PB_COMMON_H_INCLUDED
+
+#include "pb.h"
+
+typedef struct
+{
+    pb_field_t const * start;
+    pb_field_t const * pos;
+} pb_field_iter_t;
+
+#endif // PB_COMMON_H_INCLUDED
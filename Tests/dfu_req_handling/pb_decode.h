@@ -0,0 +1,10 @@
+/* Stand-in for the nanopb header of the same name. The functions are implemented by the test. */
+#ifndef PB_DECODE_H_INCLUDED
+#define PB_DECODE_H_INCLUDED
+
+#include "pb.h"
+
+pb_istream_t pb_istream_from_buffer(uint8_t const * buf, size_t bufsize);
+bool pb_decode(pb_istream_t * stream, pb_field_t const fields[], void * dest_struct);
+
+#endif // PB_DECODE_H_INCLUDED
@@ -0,0 +1,9 @@
+/* Bootloader configuration used by the test. The flash buffers and the flash queue size are passed by the Makefile. */
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+#define NRF_DFU_INACTIVITY_TIMEOUT_MS           120000
+#define NRF_DFU_UPDATABLE_APPLICATION_ONLY      0
+#define NRF_DFU_DUAL_BANK_SUPPORT               1
+
+#endif // SDK_CONFIG_H
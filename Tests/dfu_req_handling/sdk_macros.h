@@ -0,0 +1,16 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef SDK_MACROS_H__
+#define SDK_MACROS_H__
+
+#include "sdk_errors.h"
+
+#define VERIFY_SUCCESS(_err_code)                   \
+    do                                              \
+    {                                               \
+        if ((_err_code) != NRF_SUCCESS)             \
+        {                                           \
+            return (_err_code);                     \
+        }                                           \
+    } while (0)
+
+#endif // SDK_MACROS_H__
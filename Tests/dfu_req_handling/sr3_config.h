@@ -0,0 +1,7 @@
+/* Stand-in for the board configuration: the settings used by the DFU request handler. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#define CONFIG_DFU_HW_VERSION   52
+
+#endif // SR3_CONFIG_H
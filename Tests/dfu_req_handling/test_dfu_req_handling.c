@@ -0,0 +1,635 @@
+/**@file
+ *
+ * @brief Flow control of the DFU data object transfer against simulated flash latencies.
+ *
+ * @details An application image is transferred to the DFU request handler (dfu_req_handling.c) over a simulated BLE
+ *          link, by a DFU controller that follows the nrfutil sequence: create, write packets, calculate CRC and
+ *          execute for every data object, waiting for a packet receipt every PRN packets. The transport part of
+ *          nrf_ble_dfu.c that turns the PRN window into CRC requests is reproduced by the test.
+ *
+ *          Flash stores and erases complete in order after a latency, through a queue of the size of the fstorage
+ *          queue, and read the source buffer only when they are executed. Every transfer must complete, every CRC
+ *          reported must match the data received so far, and the flash must hold the image. The transfer time and
+ *          the time packet receipts are held back are printed for each PRN and flash latency.
+ */
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "test.h"
+#include "app_error.h"      // Included through sdk_common.h by the SDK headers.
+#include "nrf_assert.h"
+#include "sdk_config.h"
+#include "dfu_req_handling.c"
+
+#define CONN_INTERVAL_US        7500        /**< Connection interval of the DFU controller. */
+#define PACKETS_PER_EVENT       6           /**< Packets the link carries in one connection event. */
+#define PACKET_LEN              20          /**< Data packet length at the default ATT MTU. */
+#define FLASH_WORD_WRITE_US     41          /**< Time to write one word of flash. */
+#define FLASH_PAGE_ERASE_US     85000       /**< Time to erase one page of flash. */
+#define SETTINGS_WRITE_US       (FLASH_PAGE_ERASE_US + CODE_PAGE_SIZE / 4 * FLASH_WORD_WRITE_US)
+#define IMAGE_SIZE              (12 * CODE_PAGE_SIZE + 1732)
+#define FLASH_SIZE              (16 * CODE_PAGE_SIZE)
+#define TIMEOUT_US              (60 * 1000000)
+
+/**@brief Flash latency profile. */
+typedef struct
+{
+    char const * name;
+    uint32_t     schedule_us;   /**< Delay before each flash operation, waiting for the SoftDevice to grant flash access. */
+} flash_profile_t;
+
+/**@brief Queued flash operation. */
+typedef struct
+{
+    bool                    erase;
+    uint32_t                dest;
+    uint8_t const         * p_src;
+    uint32_t                len;
+    uint8_t                 data[FLASH_BUFFER_LENGTH];  /**< Copy of the source when the store was scheduled. */
+    uint32_t                duration_us;
+    dfu_flash_callback_t    callback;
+} flash_op_t;
+
+/**@brief Notification from the DFU target to the DFU controller. */
+typedef struct
+{
+    nrf_dfu_req_op_t    op;
+    nrf_dfu_res_code_t  res_code;
+    uint32_t            offset;
+    uint32_t            crc;
+    uint64_t            time_us;
+} notification_t;
+
+/**@brief DFU controller state. */
+typedef enum
+{
+    HOST_CREATE,
+    HOST_WRITE,
+    HOST_CRC,
+    HOST_EXECUTE,
+    HOST_DONE,
+    HOST_FAILED,
+} host_state_t;
+
+nrf_dfu_settings_t      s_dfu_settings;
+__ALIGN(4) const uint8_t pk[64];
+const pb_field_t        dfu_init_command_fields[11];
+const pb_field_t        dfu_packet_fields[3];
+app_timer_id_t const    nrf_dfu_inactivity_timeout_timer_id;
+app_timer_id_t const    nrf_dfu_post_sd_bl_timeout_timer_id;
+
+static flash_profile_t const s_profiles[] =
+{
+    { "idle radio",             0 },
+    { "access every interval",  CONN_INTERVAL_US },
+    { "access every 2 intervals", 2 * CONN_INTERVAL_US },
+};
+
+static uint16_t const s_prn_values[] = { 0, 4, 12, 30 };
+
+static uint8_t         *s_flash;
+static uint8_t          s_image[IMAGE_SIZE];
+static uint64_t         s_now_us;
+
+static flash_profile_t const *s_profile;
+static flash_op_t       s_flash_queue[NRF_FSTORAGE_SD_QUEUE_SIZE];
+static size_t           s_flash_head;
+static size_t           s_flash_count;
+static uint64_t         s_flash_head_done_us;
+static uint64_t         s_flash_busy_us;        /**< Time spent executing flash operations during the transfer. */
+static bool             s_flash_source_changed;
+static bool             s_flash_out_of_area;
+
+static notification_t   s_notifications[64];
+static size_t           s_notification_count;
+
+static uint16_t         s_pkt_notif_target;
+static uint16_t         s_pkt_notif_target_cnt;
+static uint64_t         s_receipt_request_us;
+static bool             s_receipt_requested;
+static uint64_t         s_receipt_delay_max_us;
+static uint32_t         s_receipts_held;
+static uint32_t         s_write_failures;
+
+uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc)
+{
+    uint32_t crc = (p_crc == NULL) ? 0xFFFFFFFF : ~(*p_crc);
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= p_data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+/**@brief Hash of the test: the CRC of the image in the first word, which is what the init command carries. */
+ret_code_t nrf_crypto_hash_compute(nrf_crypto_hash_info_t     hash_info,
+                                   uint8_t            const * p_data,
+                                   uint32_t                   len,
+                                   nrf_value_length_t       * p_hash)
+{
+    memset(p_hash->p_value, 0, p_hash->length);
+    (void)uint32_encode(crc32_compute(p_data, len, NULL), p_hash->p_value);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_crypto_ecdsa_verify_hash(nrf_crypto_signature_info_t         sig_info,
+                                        nrf_value_length_t          const * p_p_key,
+                                        nrf_value_length_t          const * p_hash,
+                                        nrf_value_length_t          const * p_signature)
+{
+    return NRF_SUCCESS;
+}
+
+pb_istream_t pb_istream_from_buffer(uint8_t const * buf, size_t bufsize)
+{
+    pb_istream_t stream = { .state = (void *)buf, .bytes_left = bufsize };
+
+    return stream;
+}
+
+bool pb_decode(pb_istream_t * stream, pb_field_t const fields[], void * dest_struct)
+{
+    // The init command is set up by the test.
+    return false;
+}
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    return NRF_SUCCESS;
+}
+
+void NVIC_SystemReset(void)
+{
+}
+
+nrf_dfu_res_code_t ext_error_set(nrf_dfu_ext_error_code_t error_code)
+{
+    return NRF_DFU_RES_CODE_EXT_ERROR;
+}
+
+uint32_t nrf_dfu_find_cache(uint32_t size_req, uint32_t * p_address)
+{
+    return NRF_ERROR_NO_MEM;
+}
+
+uint32_t nrf_dfu_transports_close(void)
+{
+    return NRF_SUCCESS;
+}
+
+nrf_dfu_res_code_t dfu_image_decode_start(uint32_t                    image_addr,
+                                          uint32_t                    image_size,
+                                          uint32_t                    stream_addr,
+                                          uint32_t                    stream_size,
+                                          void                      * p_buffers,
+                                          size_t                      buffer_count,
+                                          dfu_image_decode_callback_t callback)
+{
+    // Encoded images are not transferred by the test.
+    return NRF_DFU_RES_CODE_OPERATION_FAILED;
+}
+
+bool nrf_fstorage_is_busy(void const * p_fs)
+{
+    return (s_flash_count != 0);
+}
+
+ret_code_t nrf_dfu_flash_init(bool sd_irq_initialized)
+{
+    return NRF_SUCCESS;
+}
+
+/**@brief Schedule a flash operation. Like fstorage, fail when the queue is full. */
+static ret_code_t flash_op_schedule(flash_op_t const * p_op)
+{
+    if (s_flash_count == NRF_FSTORAGE_SD_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    if (s_flash_count == 0)
+    {
+        s_flash_head_done_us = s_now_us + p_op->duration_us;
+    }
+
+    s_flash_queue[(s_flash_head + s_flash_count) % NRF_FSTORAGE_SD_QUEUE_SIZE] = *p_op;
+    s_flash_count++;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_dfu_flash_store(uint32_t dest, void const * p_src, uint32_t len, dfu_flash_callback_t callback)
+{
+    flash_op_t op =
+    {
+        .erase       = false,
+        .dest        = dest,
+        .p_src       = p_src,
+        .len         = len,
+        .duration_us = s_profile->schedule_us + CEIL_DIV(len, 4) * FLASH_WORD_WRITE_US,
+        .callback    = callback,
+    };
+
+    if ((p_src != NULL) && (len <= sizeof(op.data)))
+    {
+        memcpy(op.data, p_src, len);
+    }
+
+    return flash_op_schedule(&op);
+}
+
+ret_code_t nrf_dfu_flash_erase(uint32_t page_addr, uint32_t num_pages, dfu_flash_callback_t callback)
+{
+    flash_op_t op =
+    {
+        .erase       = true,
+        .dest        = page_addr,
+        .len         = num_pages * CODE_PAGE_SIZE,
+        .duration_us = s_profile->schedule_us + num_pages * FLASH_PAGE_ERASE_US,
+        .callback    = callback,
+    };
+
+    return flash_op_schedule(&op);
+}
+
+/**@brief The settings page is erased and written. It is outside of the emulated flash. */
+ret_code_t nrf_dfu_settings_write(void)
+{
+    flash_op_t op =
+    {
+        .erase       = true,
+        .duration_us = s_profile->schedule_us + SETTINGS_WRITE_US,
+    };
+
+    return flash_op_schedule(&op);
+}
+
+/**@brief Execute the flash operations that complete until the given time. */
+static void flash_run(uint64_t until_us)
+{
+    while ((s_flash_count != 0) && (s_flash_head_done_us <= until_us))
+    {
+        flash_op_t         op  = s_flash_queue[s_flash_head];
+        nrf_fstorage_evt_t evt =
+        {
+            .id      = op.erase ? NRF_FSTORAGE_EVT_ERASE_RESULT : NRF_FSTORAGE_EVT_WRITE_RESULT,
+            .result  = NRF_SUCCESS,
+            .addr    = op.dest,
+            .len     = op.len,
+            .p_param = (void *)op.callback,
+        };
+
+        s_now_us         = s_flash_head_done_us;
+        s_flash_busy_us += op.duration_us;
+        s_flash_head     = (s_flash_head + 1) % NRF_FSTORAGE_SD_QUEUE_SIZE;
+        s_flash_count--;
+
+        if (s_flash_count != 0)
+        {
+            s_flash_head_done_us = s_now_us + s_flash_queue[s_flash_head].duration_us;
+        }
+
+        if (op.dest != 0)
+        {
+            uint8_t * p_dest = (uint8_t *)(uintptr_t)op.dest;
+
+            if ((p_dest < s_flash) || (p_dest + op.len > s_flash + FLASH_SIZE))
+            {
+                s_flash_out_of_area = true;
+            }
+            else if (op.erase)
+            {
+                memset(p_dest, 0xFF, op.len);
+            }
+            else
+            {
+                // The source buffer is read now, so it must not have been reused since the store was scheduled.
+                if (memcmp(op.p_src, op.data, op.len) != 0)
+                {
+                    s_flash_source_changed = true;
+                }
+
+                for (uint32_t i = 0; i < op.len; i++)
+                {
+                    // Programming can only clear bits.
+                    p_dest[i] &= op.p_src[i];
+                }
+            }
+        }
+
+        if (op.callback != NULL)
+        {
+            op.callback(&evt);
+        }
+    }
+
+    s_now_us = until_us;
+}
+
+/**@brief Queue a notification to the DFU controller. */
+static void notification_send(nrf_dfu_req_op_t op, nrf_dfu_res_code_t res_code, nrf_dfu_res_t const * p_res)
+{
+    notification_t *p_notification;
+
+    TEST_CHECK(s_notification_count < ARRAY_SIZE(s_notifications));
+    if (s_notification_count == ARRAY_SIZE(s_notifications))
+    {
+        return;
+    }
+
+    p_notification           = &s_notifications[s_notification_count++];
+    p_notification->op       = op;
+    p_notification->res_code = res_code;
+    p_notification->offset   = (p_res != NULL) ? p_res->offset : 0;
+    p_notification->crc      = (p_res != NULL) ? p_res->crc : 0;
+    p_notification->time_us  = s_now_us;
+}
+
+static void response_create(void const * p_context, nrf_dfu_res_code_t res_code, nrf_dfu_res_t const * p_res)
+{
+    notification_send(NRF_DFU_OBJECT_OP_CREATE, res_code, NULL);
+}
+
+static void response_execute(void const * p_context, nrf_dfu_res_code_t res_code, nrf_dfu_res_t const * p_res)
+{
+    notification_send(NRF_DFU_OBJECT_OP_EXECUTE, res_code, NULL);
+}
+
+static void response_crc(void const * p_context, nrf_dfu_res_code_t res_code, nrf_dfu_res_t const * p_res)
+{
+    if (s_receipt_requested)
+    {
+        uint64_t delay_us = s_now_us - s_receipt_request_us;
+
+        s_receipt_requested    = false;
+        s_receipts_held       += (delay_us != 0) ? 1 : 0;
+        s_receipt_delay_max_us = MAX(s_receipt_delay_max_us, delay_us);
+    }
+
+    notification_send(NRF_DFU_OBJECT_OP_CRC, res_code, p_res);
+}
+
+/**@brief Response to a data packet, as in process_handler_response_write() of nrf_ble_dfu.c. */
+static void response_write(void const * p_context, nrf_dfu_res_code_t res_code, nrf_dfu_res_t const * p_res)
+{
+    if (res_code != NRF_DFU_RES_CODE_SUCCESS)
+    {
+        s_write_failures++;
+    }
+
+    if (s_pkt_notif_target != 0)
+    {
+        s_pkt_notif_target_cnt--;
+
+        if (s_pkt_notif_target_cnt == 0)
+        {
+            nrf_dfu_req_t dfu_req;
+
+            memset(&dfu_req, 0, sizeof(nrf_dfu_req_t));
+
+            dfu_req.req_type = NRF_DFU_OBJECT_OP_CRC;
+
+            s_receipt_requested  = true;
+            s_receipt_request_us = s_now_us;
+            nrf_dfu_req_handler_on_req(NULL, &dfu_req, response_crc);
+
+            s_pkt_notif_target_cnt = s_pkt_notif_target;
+        }
+    }
+}
+
+/**@brief Check a CRC reported to the DFU controller against the data it sent. */
+static bool crc_check(notification_t const * p_notification, uint32_t offset)
+{
+    return (p_notification->res_code == NRF_DFU_RES_CODE_SUCCESS) &&
+           (p_notification->offset == offset) &&
+           (p_notification->crc == crc32_compute(s_image, offset, NULL));
+}
+
+/**@brief Transfer the image with the given PRN and check the result. */
+static void transfer(uint16_t prn)
+{
+    host_state_t state         = HOST_CREATE;
+    bool         waiting       = false;     // Waiting for a response or a packet receipt.
+    uint32_t     object_offset = 0;
+    uint32_t     object_size   = 0;
+    uint32_t     offset        = 0;
+    uint32_t     packets       = 0;         // Packets sent in the current object.
+    bool         crc_ok        = true;
+    uint64_t     time_us;
+
+    memset(s_flash, 0x00, FLASH_SIZE);
+    memset(&s_dfu_settings, 0, sizeof(s_dfu_settings));
+    s_dfu_settings.bank_current = NRF_DFU_CURRENT_BANK_0;
+
+    s_now_us               = 0;
+    s_notification_count   = 0;
+    s_flash_busy_us        = 0;
+    s_flash_source_changed = false;
+    s_flash_out_of_area    = false;
+    s_receipt_requested    = false;
+    s_receipt_delay_max_us = 0;
+    s_receipts_held        = 0;
+    s_write_failures       = 0;
+    s_pkt_notif_target     = prn;
+    s_pkt_notif_target_cnt = prn;
+
+    // State left by a valid init command for an application image (dfu_handle_prevalidate()).
+    m_valid_init_packet_present                     = true;
+    m_firmware_start_addr                           = (uint32_t)(uintptr_t)s_flash;
+    m_firmware_size_req                             = IMAGE_SIZE;
+    m_image_size_req                                = 0;
+    memset(&dfu_init_packet, 0, sizeof(dfu_init_packet));
+    dfu_init_packet.signed_command.command.init.type           = DFU_FW_TYPE_APPLICATION;
+    dfu_init_packet.signed_command.command.init.hash.hash_type = DFU_HASH_TYPE_SHA256;
+    dfu_init_packet.signed_command.command.init.hash.hash.size = NRF_CRYPTO_HASH_SIZE_SHA256;
+    (void)uint32_encode(crc32_compute(s_image, IMAGE_SIZE, NULL), dfu_init_packet.signed_command.command.init.hash.hash.bytes);
+
+    while ((state != HOST_DONE) && (state != HOST_FAILED) && (s_now_us < TIMEOUT_US))
+    {
+        nrf_dfu_req_t req;
+
+        flash_run(s_now_us + CONN_INTERVAL_US);
+
+        // Notifications sent before this connection event are received by the DFU controller.
+        for (size_t i = 0; i < s_notification_count; i++)
+        {
+            notification_t const * p_notification = &s_notifications[i];
+
+            switch (p_notification->op)
+            {
+                case NRF_DFU_OBJECT_OP_CREATE:
+                    state   = (p_notification->res_code == NRF_DFU_RES_CODE_SUCCESS) ? HOST_WRITE : HOST_FAILED;
+                    waiting = false;
+                    break;
+
+                case NRF_DFU_OBJECT_OP_CRC:
+                    crc_ok  = crc_ok && crc_check(p_notification, offset);
+                    waiting = false;
+                    if (state == HOST_CRC)
+                    {
+                        state = HOST_EXECUTE;
+                    }
+                    break;
+
+                case NRF_DFU_OBJECT_OP_EXECUTE:
+                    waiting = false;
+                    if (p_notification->res_code != NRF_DFU_RES_CODE_SUCCESS)
+                    {
+                        state = HOST_FAILED;
+                    }
+                    else if (offset == IMAGE_SIZE)
+                    {
+                        state = HOST_DONE;
+                    }
+                    else
+                    {
+                        state = HOST_CREATE;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        s_notification_count = 0;
+
+        for (int slot = 0; (slot < PACKETS_PER_EVENT) && !waiting && (state != HOST_DONE) && (state != HOST_FAILED); slot++)
+        {
+            memset(&req, 0, sizeof(req));
+
+            switch (state)
+            {
+                case HOST_CREATE:
+                    object_offset = offset;
+                    object_size   = MIN(DATA_OBJECT_MAX_SIZE, IMAGE_SIZE - offset);
+                    packets       = 0;
+
+                    s_pkt_notif_target_cnt = s_pkt_notif_target;
+
+                    req.req_type    = NRF_DFU_OBJECT_OP_CREATE;
+                    req.obj_type    = NRF_DFU_OBJ_TYPE_DATA;
+                    req.object_size = object_size;
+                    nrf_dfu_req_handler_on_req(NULL, &req, response_create);
+                    waiting = true;
+                    break;
+
+                case HOST_WRITE:
+                    req.req_type = NRF_DFU_OBJECT_OP_WRITE;
+                    req.p_req    = &s_image[offset];
+                    req.req_len  = MIN(PACKET_LEN, object_offset + object_size - offset);
+                    nrf_dfu_req_handler_on_req(NULL, &req, response_write);
+
+                    offset  += req.req_len;
+                    packets += 1;
+
+                    waiting = (prn != 0) && ((packets % prn) == 0);
+                    if (offset == object_offset + object_size)
+                    {
+                        state = HOST_CRC;
+                    }
+                    break;
+
+                case HOST_CRC:
+                    req.req_type = NRF_DFU_OBJECT_OP_CRC;
+                    nrf_dfu_req_handler_on_req(NULL, &req, response_crc);
+                    waiting = true;
+                    break;
+
+                case HOST_EXECUTE:
+                    req.req_type = NRF_DFU_OBJECT_OP_EXECUTE;
+                    nrf_dfu_req_handler_on_req(NULL, &req, response_execute);
+                    waiting = true;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    time_us = s_now_us;
+    printf("%-26s PRN %2u: %5.2f s, %5.2f kB/s, flash busy %3.0f%%, %3u receipts held back, longest %5.1f ms\n",
+           s_profile->name, prn, time_us / 1e6, IMAGE_SIZE * 1e3 / time_us, 100.0 * s_flash_busy_us / time_us,
+           s_receipts_held, s_receipt_delay_max_us / 1e3);
+
+    // Let the settings be stored.
+    flash_run(UINT64_MAX);
+
+    TEST_CHECK(state == HOST_DONE);
+    TEST_CHECK(crc_ok);
+    TEST_CHECK(s_write_failures == 0);
+    TEST_CHECK(!s_flash_source_changed);
+    TEST_CHECK(!s_flash_out_of_area);
+    TEST_CHECK(memcmp(s_flash, s_image, IMAGE_SIZE) == 0);
+    TEST_CHECK(s_dfu_settings.bank_0.bank_code == NRF_DFU_BANK_VALID_APP);
+    TEST_CHECK(s_dfu_settings.bank_0.image_size == IMAGE_SIZE);
+    TEST_CHECK(s_dfu_settings.bank_0.image_crc == crc32_compute(s_image, IMAGE_SIZE, NULL));
+
+    if (s_profile->schedule_us != 0)
+    {
+        // Flash is slower than the link: the flow control must keep it busy.
+        TEST_CHECK(s_flash_busy_us >= time_us * 95 / 100);
+    }
+    else if (prn == 0)
+    {
+        // Flash is faster than the link: data objects must be streamed close to the link rate.
+        TEST_CHECK(time_us <= (uint64_t)IMAGE_SIZE * CONN_INTERVAL_US / (PACKETS_PER_EVENT * PACKET_LEN) * 12 / 10);
+    }
+}
+
+int main(void)
+{
+    // The request handler works with 32-bit flash addresses.
+    s_flash = mmap(NULL, FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (s_flash == MAP_FAILED)
+    {
+        printf("Cannot map the emulated flash\n");
+        return EXIT_FAILURE;
+    }
+
+    srand(29);
+    for (size_t i = 0; i < sizeof(s_image); i++)
+    {
+        s_image[i] = (uint8_t)rand();
+    }
+
+    TEST_CHECK(nrf_dfu_req_handler_init() == NRF_SUCCESS);
+
+    printf("%u B image, %u flash buffers of %u B, %u packets of %u B per %u us connection event\n",
+           (unsigned)IMAGE_SIZE, FLASH_BUFFER_COUNT, FLASH_BUFFER_LENGTH, PACKETS_PER_EVENT, PACKET_LEN, CONN_INTERVAL_US);
+
+    for (size_t i = 0; i < ARRAY_SIZE(s_profiles); i++)
+    {
+        s_profile = &s_profiles[i];
+
+        for (size_t j = 0; j < ARRAY_SIZE(s_prn_values); j++)
+        {
+            transfer(s_prn_values[j]);
+        }
+    }
+
+    return TEST_RESULT();
+}
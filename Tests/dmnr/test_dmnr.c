@@ -0,0 +1,364 @@
+/**@file
+ *
+ * @brief WAV-in/WAV-out harness and test of the built-in dual-microphone noise reduction.
+ *
+ * @details Usage:
+ *          test_dmnr                       Run the synthetic scenarios. The two-microphone input and the
+ *                                          processed output of each one are written as WAV files to the
+ *                                          current directory.
+ *          test_dmnr <input> <output>      Process a 16-bit stereo WAV file (left: voice microphone, right:
+ *                                          noise microphone) into a mono WAV file.
+ *
+ *          The filter length, delay, step size and gain floor are those of the board configuration, converted
+ *          as in drv_audio_anr.c. For each scenario the test reports the SNR before and after noise reduction
+ *          and the host time spent in dmnr_process() per frame of BLOCK_SIZE samples.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "dmnr.h"
+
+#define FS                  16000
+#define BLOCK_SIZE          128                                 /**< Samples per dmnr_process() call (one frame). */
+#define LATENCY             (SPNS_FFT_SIZE + ANR_DELAY_LENGTH)  /**< Output delay of the engine. */
+#define SCENARIO_LENGTH     (12 * FS)
+#define SETTLE_LENGTH       (4 * FS)                            /**< Samples skipped before measuring. */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct
+{
+    const char *p_name;
+    double      noise_gain;         /**< Level of the noise source. */
+    double      uncorrelated;       /**< Level of noise reaching only the voice microphone. */
+    double      leak;               /**< Part of the voice reaching the noise microphone. */
+    double      min_gain_db;        /**< Required SNR improvement. */
+} scenario_t;
+
+static const scenario_t s_scenarios[] =
+{
+    { "coherent",       0.3, 0.0,  0.0,   8.0 },
+    { "uncorrelated",   0.3, 0.05, 0.0,   7.5 },
+    { "voice_leak",     0.3, 0.0,  0.1,   8.0 },
+    { "loud",           2.0, 0.0,  0.0,  20.0 },
+};
+
+static dmnr_t   s_dmnr;
+static int16_t  s_ref_history[2 * ANR_LENGTH];
+static int32_t  s_weights[ANR_LENGTH];
+static int16_t  s_delay_line[ANR_DELAY_LENGTH];
+static double   s_clean[SCENARIO_LENGTH];
+static double   s_voice_mic[SCENARIO_LENGTH];
+static int16_t  s_buffer[2 * SCENARIO_LENGTH];
+static clock_t  s_elapsed;                                      /**< Time spent in dmnr_process(). */
+
+static void engine_init(uint16_t step_size)
+{
+    const dmnr_config_t cfg =
+    {
+        .p_ref_history  = s_ref_history,
+        .p_weights      = s_weights,
+        .p_delay_line   = s_delay_line,
+        .filter_length  = ANR_LENGTH,
+        .delay_length   = ANR_DELAY_LENGTH,
+        .step_size      = step_size,
+        .gain_floor     = (ANR_GAIN_FLOOR * 32767) / 100,
+    };
+
+    TEST_CHECK(dmnr_init(&s_dmnr, &cfg) == 0);
+    s_elapsed = 0;
+}
+
+/**@brief Process interleaved samples in blocks. The output is written to the first half of the buffer.
+ *
+ * @return False if an adaptive filter weight wrapped around between two blocks.
+ */
+static bool engine_run(int16_t *p_samples, size_t pairs)
+{
+    int32_t weights[ANR_LENGTH];
+    bool    wrapped = false;
+    size_t  pos;
+    size_t  k;
+    clock_t start;
+
+    for (pos = 0; (pos + BLOCK_SIZE) <= pairs; pos += BLOCK_SIZE)
+    {
+        memcpy(weights, s_weights, sizeof(weights));
+
+        start = clock();
+        dmnr_process(&s_dmnr, &p_samples[2 * pos], BLOCK_SIZE);
+        s_elapsed += clock() - start;
+
+        memmove(&p_samples[pos], &p_samples[2 * pos], BLOCK_SIZE * sizeof(int16_t));
+
+        // A wrap moves a weight from one end of the range to the other within one block.
+        for (k = 0; k < ANR_LENGTH; k++)
+        {
+            wrapped |= ((weights[k] > (INT32_MAX / 2)) && (s_weights[k] < (INT32_MIN / 2))) ||
+                       ((weights[k] < (INT32_MIN / 2)) && (s_weights[k] > (INT32_MAX / 2)));
+        }
+    }
+
+    return !wrapped;
+}
+
+static void wav_header_write(FILE *p_file, uint16_t channels, uint32_t samples)
+{
+    uint32_t data_size = samples * channels * sizeof(int16_t);
+    uint8_t  header[44];
+
+    memcpy(&header[0], "RIFF", 4);
+    uint32_encode(36 + data_size, &header[4]);
+    memcpy(&header[8], "WAVEfmt ", 8);
+    uint32_encode(16, &header[16]);
+    uint16_encode(1, &header[20]);
+    uint16_encode(channels, &header[22]);
+    uint32_encode(FS, &header[24]);
+    uint32_encode(FS * channels * sizeof(int16_t), &header[28]);
+    uint16_encode(channels * sizeof(int16_t), &header[32]);
+    uint16_encode(16, &header[34]);
+    memcpy(&header[36], "data", 4);
+    uint32_encode(data_size, &header[40]);
+
+    fwrite(header, 1, sizeof(header), p_file);
+}
+
+static bool wav_write(const char *p_path, const int16_t *p_samples, uint16_t channels, uint32_t samples)
+{
+    FILE *p_file = fopen(p_path, "wb");
+
+    if (p_file == NULL)
+    {
+        printf("Cannot create %s\n", p_path);
+        return false;
+    }
+
+    wav_header_write(p_file, channels, samples);
+    fwrite(p_samples, sizeof(int16_t), (size_t)samples * channels, p_file);
+    fclose(p_file);
+
+    return true;
+}
+
+/**@brief Read a 16-bit stereo WAV file at 16 kHz.
+ *
+ * @return Number of sample pairs read, or 0 on error.
+ */
+static size_t wav_read(const char *p_path, int16_t *p_samples, size_t max_pairs)
+{
+    FILE       *p_file = fopen(p_path, "rb");
+    uint8_t     chunk[8];
+    uint8_t     fmt[16];
+    bool        fmt_ok = false;
+    size_t      pairs = 0;
+
+    if ((p_file == NULL) || (fread(chunk, 1, 8, p_file) != 8) || (memcmp(chunk, "RIFF", 4) != 0) ||
+        (fread(chunk, 1, 4, p_file) != 4) || (memcmp(chunk, "WAVE", 4) != 0))
+    {
+        printf("%s is not a WAV file\n", p_path);
+        goto exit;
+    }
+
+    while (fread(chunk, 1, 8, p_file) == 8)
+    {
+        uint32_t size = uint32_decode(&chunk[4]);
+
+        if ((memcmp(chunk, "fmt ", 4) == 0) && (size >= sizeof(fmt)))
+        {
+            if (fread(fmt, 1, sizeof(fmt), p_file) != sizeof(fmt))
+            {
+                break;
+            }
+            fseek(p_file, size - sizeof(fmt), SEEK_CUR);
+
+            fmt_ok = (uint16_decode(&fmt[0]) == 1) &&       // PCM
+                     (uint16_decode(&fmt[2]) == 2) &&       // Stereo
+                     (uint32_decode(&fmt[4]) == FS) &&
+                     (uint16_decode(&fmt[14]) == 16);
+        }
+        else if ((memcmp(chunk, "data", 4) == 0) && fmt_ok)
+        {
+            pairs = fread(p_samples, 2 * sizeof(int16_t), MIN(size / 4, max_pairs), p_file);
+            break;
+        }
+        else
+        {
+            fseek(p_file, size + (size & 1), SEEK_CUR);
+        }
+    }
+
+    if (!fmt_ok)
+    {
+        printf("%s must be 16-bit stereo PCM at %u Hz\n", p_path, FS);
+    }
+
+exit:
+    if (p_file != NULL)
+    {
+        fclose(p_file);
+    }
+
+    return pairs;
+}
+
+static int16_t sat16(double x)
+{
+    return (int16_t)MAX(-32768.0, MIN(32767.0, x));
+}
+
+/**@brief Generate a scenario: a harmonic voice on the voice microphone, and a noise source reaching the
+ *        noise microphone directly and the voice microphone through a short acoustic path.
+ */
+static void scenario_generate(const scenario_t *p_scenario)
+{
+    static double   source[SCENARIO_LENGTH];
+    double          lowpass = 0.0;
+    size_t          i;
+    int             h;
+
+    srand(1);
+
+    for (i = 0; i < SCENARIO_LENGTH; i++)
+    {
+        double white = ((double)rand() / RAND_MAX) - 0.5;
+
+        lowpass     = (0.7 * lowpass) + (0.3 * white);
+        source[i]   = p_scenario->noise_gain * 8000.0 * (lowpass + 0.3 * sin(2.0 * M_PI * 180.0 * i / FS));
+    }
+
+    for (i = 0; i < SCENARIO_LENGTH; i++)
+    {
+        double t    = (double)i / FS;
+        double env  = ((t > 1.0) && (fmod(t, 2.0) < 1.0)) ? 0.5 * (1.0 - cos(2.0 * M_PI * fmod(t, 1.0))) : 0.0;
+        double f0   = 140.0 + 20.0 * sin(2.0 * M_PI * 0.7 * t);
+        double path;
+
+        s_clean[i] = 0.0;
+        for (h = 1; h < 15; h++)
+        {
+            s_clean[i] += 3000.0 * env * sin(2.0 * M_PI * f0 * h * t + h) / h;
+        }
+
+        path = (0.6 * ((i >= 2) ? source[i - 2] : 0.0)) +
+               (0.25 * ((i >= 3) ? source[i - 3] : 0.0)) -
+               (0.1 * ((i >= 5) ? source[i - 5] : 0.0));
+
+        s_voice_mic[i]      = s_clean[i] + path +
+                              (p_scenario->uncorrelated * 8000.0 * (((double)rand() / RAND_MAX) - 0.5));
+        s_buffer[2 * i]     = sat16(s_voice_mic[i]);
+        s_buffer[2 * i + 1] = sat16(source[i] + (p_scenario->leak * s_clean[i]));
+    }
+}
+
+static void scenario_run(const scenario_t *p_scenario)
+{
+    char    path[128];
+    double  signal = 0.0;
+    double  noise_in = 0.0;
+    double  noise_out = 0.0;
+    double  gain;
+    size_t  i;
+
+    scenario_generate(p_scenario);
+
+    snprintf(path, sizeof(path), "dmnr_%s_in.wav", p_scenario->p_name);
+    TEST_CHECK(wav_write(path, s_buffer, 2, SCENARIO_LENGTH));
+
+    engine_init(ANR_STEP_SIZE * 32);
+    TEST_CHECK(engine_run(s_buffer, SCENARIO_LENGTH));
+
+    snprintf(path, sizeof(path), "dmnr_%s_out.wav", p_scenario->p_name);
+    TEST_CHECK(wav_write(path, s_buffer, 1, SCENARIO_LENGTH));
+
+    for (i = SETTLE_LENGTH; (i + LATENCY) < SCENARIO_LENGTH; i++)
+    {
+        double out = s_buffer[i + LATENCY];
+
+        signal      += s_clean[i] * s_clean[i];
+        noise_in    += (s_voice_mic[i] - s_clean[i]) * (s_voice_mic[i] - s_clean[i]);
+        noise_out   += (out - s_clean[i]) * (out - s_clean[i]);
+    }
+
+    gain = 10.0 * log10(noise_in / noise_out);
+    printf("%-13s SNR in %6.2f dB, out %6.2f dB, %5.1f us/frame\n",
+           p_scenario->p_name, 10.0 * log10(signal / noise_in), 10.0 * log10(signal / noise_out),
+           ((double)s_elapsed * 1e6 * BLOCK_SIZE) / (CLOCKS_PER_SEC * SCENARIO_LENGTH));
+
+    TEST_CHECK(gain >= p_scenario->min_gain_db);
+}
+
+/**@brief Drive one weight towards the end of its range.
+ *
+ * @details A small constant voice level and a sparse reference keep both level followers at zero, so
+ *          adaptation never freezes. A single tap sees a reference of 1 and must reach 31 in Q28 to cancel
+ *          the voice, which is beyond the weight range. With the largest step size this takes about 4.2M
+ *          samples.
+ */
+static void stress_run(void)
+{
+    bool    no_wrap = true;
+    size_t  run;
+    size_t  i;
+
+    engine_init(1024 * 32);
+
+    for (run = 0; run < 24; run++)
+    {
+        for (i = 0; i < SCENARIO_LENGTH; i++)
+        {
+            s_buffer[2 * i]     = 31;
+            s_buffer[2 * i + 1] = ((i % 64) == 0) ? 1 : 0;
+        }
+
+        no_wrap &= engine_run(s_buffer, SCENARIO_LENGTH);
+    }
+
+    printf("Weight stress: %s\n", no_wrap ? "saturated" : "wrapped");
+    TEST_CHECK(no_wrap);
+}
+
+static int file_process(const char *p_input, const char *p_output)
+{
+    static int16_t  samples[2 * 600 * FS];
+    size_t          pairs = wav_read(p_input, samples, ARRAY_SIZE(samples) / 2);
+
+    if (pairs == 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    engine_init(ANR_STEP_SIZE * 32);
+    engine_run(samples, pairs);
+
+    return wav_write(p_output, samples, 1, pairs - (pairs % BLOCK_SIZE)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t i;
+
+    if (argc == 3)
+    {
+        return file_process(argv[1], argv[2]);
+    }
+
+    printf("Filter %u taps, delay %u, step %u/1024, floor %u%%\n",
+           ANR_LENGTH, ANR_DELAY_LENGTH, ANR_STEP_SIZE, ANR_GAIN_FLOOR);
+
+    for (i = 0; i < ARRAY_SIZE(s_scenarios); i++)
+    {
+        scenario_run(&s_scenarios[i]);
+    }
+
+    stress_run();
+
+    return TEST_RESULT();
+}
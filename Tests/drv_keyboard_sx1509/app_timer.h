@@ -0,0 +1,41 @@
+/* Stand-in for the SDK header of the same name: timers driven by the millisecond clock of the test. */
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define APP_TIMER_DEF(_timer_id)                                    \
+    static app_timer_t _timer_id##_data;                            \
+    static app_timer_id_t const _timer_id = &_timer_id##_data
+
+#define APP_TIMER_TICKS(_ms)    ((uint32_t)(_ms))
+
+typedef void (*app_timer_timeout_handler_t)(void *p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED,
+} app_timer_mode_t;
+
+typedef struct
+{
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t            mode;
+    bool                        active;
+    uint32_t                    deadline;
+    uint32_t                    period;
+    void                      * p_context;
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler);
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context);
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+#endif // APP_TIMER_H__
@@ -0,0 +1,5 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef NRF_GPIO_H__
+#define NRF_GPIO_H__
+
+#endif // NRF_GPIO_H__
@@ -0,0 +1,11 @@
+/* Stand-in for the header of the same name: the TWI resources. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#include "nrf_twi_mngr.h"
+
+#define SX1509_TWI_ADDRESS  (0x3E)
+
+extern nrf_drv_twi_config_t const g_twi_bus_config[2];
+
+#endif /* __RESOURCES_H__ */
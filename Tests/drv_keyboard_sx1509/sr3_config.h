@@ -0,0 +1,24 @@
+/* Keyboard configuration used by the test: the SX1509 driver on TWI bus 0. The keypad engine setting and the
+ * timings come from the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define IS_IO_VALID(io)                 (((io) & ~0x1F) == 0)
+
+#define CONFIG_KBD_ENABLED              1
+#define CONFIG_KBD_DRIVER_GPIO          1
+#define CONFIG_KBD_DRIVER_SX1509        2
+#define CONFIG_KBD_DRIVER               CONFIG_KBD_DRIVER_SX1509
+#define CONFIG_KBD_TWI_BUS              0
+#define CONFIG_KBD_DRV_LOG_LEVEL        0
+#define CONFIG_IO_KBD_SX1509_NINT       5
+#define CONFIG_PWR_MGMT_ENABLED         1
+#define CONFIG_HID_HIGH_RES_ENABLED     0
+
+#include "sr3_config_hid.h"
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,403 @@
+/**@file
+ *
+ * @brief Test of the SX1509 keyboard driver against a mock TWI bus.
+ *
+ * @details The test includes drv_keyboard_sx1509.c. TWI transactions are queued by twi_schedule() and executed
+ *          every millisecond by a register model of the SX1509, which counts the bytes on the bus, including the
+ *          address byte of every transfer. In column polling, the model returns the rows of the held keys in the
+ *          driven columns. With the keypad engine on, it pulls NINT low once per scan cycle while a key is held,
+ *          and releases it when RegKeyData2 is read.
+ *
+ *          The test measures the bus traffic idle, with one key held and with two keys held. It checks that both
+ *          keys of a chord are reported, and that every one of a series of random taps is reported as one press
+ *          and one release. With the keypad engine, there must be no traffic while idle, and much less traffic
+ *          with one key held than with two keys held, when the driver falls back to polling.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of drv_keyboard.h.
+#include "drv_keyboard_sx1509.c"
+
+#define QUEUE_SIZE      8
+#define MAX_TIMERS      4
+#define TAPS            200
+
+nrf_drv_twi_config_t const g_twi_bus_config[2];
+
+static uint32_t                             s_now;
+static uint32_t                             s_bus_bytes;
+static uint8_t                              s_registers[256];
+static uint8_t                              s_register_addr;
+static bool                                 s_pressed[KEYBOARD_NUM_OF_ROWS][KEYBOARD_NUM_OF_COLUMNS];
+static bool                                 s_nint_low;
+static bool                                 s_gpiote_enabled;
+static app_gpiote_event_handler_t           s_gpiote_handler;
+static app_timer_t                        * s_timers[MAX_TIMERS];
+static unsigned int                         s_timer_count;
+static nrf_twi_mngr_transaction_t const   * s_queue[QUEUE_SIZE];
+static unsigned int                         s_queue_size;
+
+static uint8_t                              s_keys[DRV_KEYBOARD_MAX_KEYS];
+static uint8_t                              s_key_count;
+static unsigned int                         s_key_events;
+
+ret_code_t twi_schedule(nrf_twi_mngr_transaction_t const *p_transaction)
+{
+    TEST_CHECK(s_queue_size < QUEUE_SIZE);
+    s_queue[s_queue_size++] = p_transaction;
+    return NRF_SUCCESS;
+}
+
+ret_code_t twi_register_read(nrf_drv_twi_config_t const *p_bus_config, uint8_t device_addr,
+                             uint8_t register_addr, uint8_t *p_value)
+{
+    s_bus_bytes += 4;
+    *p_value = s_registers[register_addr];
+    return NRF_SUCCESS;
+}
+
+ret_code_t twi_register_bulk_write(nrf_drv_twi_config_t const *p_bus_config, uint8_t device_addr,
+                                   const uint8_t p_reg_val_array[][2], unsigned int reg_val_array_size,
+                                   bool perform_verification)
+{
+    for (unsigned int i = 0; i < reg_val_array_size; i++)
+    {
+        s_registers[p_reg_val_array[i][0]] = p_reg_val_array[i][1];
+        s_bus_bytes += 3;
+    }
+
+    // The software reset leaves RegReset at zero.
+    s_registers[RegReset] = 0;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(s_timer_count < MAX_TIMERS);
+
+    (*p_timer_id)->handler = timeout_handler;
+    (*p_timer_id)->mode    = mode;
+    s_timers[s_timer_count++] = *p_timer_id;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    // A running repeated timer is not restarted, like on the RTC.
+    if (timer_id->active && (timer_id->mode == APP_TIMER_MODE_REPEATED))
+    {
+        return NRF_SUCCESS;
+    }
+
+    timer_id->active    = true;
+    timer_id->deadline  = s_now + timeout_ticks;
+    timer_id->period    = timeout_ticks;
+    timer_id->p_context = p_context;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_register(app_gpiote_user_id_t *p_user_id,
+                                    uint32_t const *p_pins_low_to_high_mask,
+                                    uint32_t const *p_pins_high_to_low_mask,
+                                    app_gpiote_event_handler_t event_handler)
+{
+    TEST_CHECK(*p_pins_high_to_low_mask == (1ul << CONFIG_IO_KBD_SX1509_NINT));
+    s_gpiote_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_enable(app_gpiote_user_id_t user_id)
+{
+    s_gpiote_enabled = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_disable(app_gpiote_user_id_t user_id)
+{
+    s_gpiote_enabled = false;
+    return NRF_SUCCESS;
+}
+
+/**@brief Rows or columns of the held keys, active low, as in RegKeyData1 and RegKeyData2. */
+static uint8_t key_data(bool columns)
+{
+    uint8_t rows = 0;
+    uint8_t cols = 0;
+
+    for (int row = 0; row < KEYBOARD_NUM_OF_ROWS; row++)
+    {
+        for (int col = 0; col < KEYBOARD_NUM_OF_COLUMNS; col++)
+        {
+            if (s_pressed[row][col])
+            {
+                rows |= 1u << row;
+                cols |= 1u << col;
+            }
+        }
+    }
+
+    return (uint8_t)~(columns ? cols : rows);
+}
+
+/**@brief Rows of the held keys in the driven columns. */
+static uint8_t row_data(void)
+{
+    uint8_t rows = 0;
+
+    for (int row = 0; row < KEYBOARD_NUM_OF_ROWS; row++)
+    {
+        for (int col = 0; col < KEYBOARD_NUM_OF_COLUMNS; col++)
+        {
+            if (s_pressed[row][col] && (s_registers[RegDataB] & (1u << col)))
+            {
+                rows |= 1u << row;
+            }
+        }
+    }
+
+    return rows;
+}
+
+static uint8_t register_read(uint8_t addr)
+{
+    switch (addr)
+    {
+        case RegKeyData1:
+            return key_data(true);
+
+        case RegKeyData2:
+            s_nint_low = false;
+            return key_data(false);
+
+        case RegDataA:
+            return row_data();
+
+        default:
+            return s_registers[addr];
+    }
+}
+
+static void transfer_execute(nrf_twi_mngr_transfer_t const *p_transfer)
+{
+    TEST_CHECK((p_transfer->operation >> 1) == SX1509_TWI_ADDRESS);
+    s_bus_bytes += p_transfer->length + 1;
+
+    if (NRF_TWI_MNGR_IS_READ_OP(p_transfer->operation))
+    {
+        for (uint8_t i = 0; i < p_transfer->length; i++)
+        {
+            p_transfer->p_data[i] = register_read(s_register_addr + i);
+        }
+    }
+    else
+    {
+        s_register_addr = p_transfer->p_data[0];
+        for (uint8_t i = 1; i < p_transfer->length; i++)
+        {
+            s_registers[s_register_addr + i - 1] = p_transfer->p_data[i];
+        }
+    }
+}
+
+/**@brief Execute the queued transactions. Transactions scheduled by the callbacks wait for the next call. */
+static void bus_run(void)
+{
+    nrf_twi_mngr_transaction_t const *queue[QUEUE_SIZE];
+    unsigned int size = s_queue_size;
+
+    memcpy(queue, s_queue, sizeof(queue));
+    s_queue_size = 0;
+
+    for (unsigned int i = 0; i < size; i++)
+    {
+        for (uint8_t j = 0; j < queue[i]->number_of_transfers; j++)
+        {
+            transfer_execute(&queue[i]->p_transfers[j]);
+        }
+        queue[i]->callback(NRF_SUCCESS, queue[i]->p_user_data);
+    }
+}
+
+void nrf_pwr_mgmt_run(void)
+{
+    bus_run();
+}
+
+static bool any_key_pressed(void)
+{
+    for (int row = 0; row < KEYBOARD_NUM_OF_ROWS; row++)
+    {
+        for (int col = 0; col < KEYBOARD_NUM_OF_COLUMNS; col++)
+        {
+            if (s_pressed[row][col])
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**@brief Advance the clock by one millisecond: keypad engine, timers and bus. */
+static void tick(void)
+{
+    bool engine_on = ((s_registers[RegKeyConfig2] & 0x38) != 0);
+
+    s_now++;
+
+    if (engine_on && any_key_pressed() && !s_nint_low &&
+        ((s_now % (KEYBOARD_NUM_OF_ROWS << CONFIG_KBD_SX1509_SCAN_TIME)) == 0))
+    {
+        uint32_t low_to_high = 0;
+        uint32_t high_to_low = 1ul << CONFIG_IO_KBD_SX1509_NINT;
+
+        s_nint_low = true;
+        if (s_gpiote_enabled)
+        {
+            s_gpiote_handler(&low_to_high, &high_to_low);
+        }
+    }
+
+    for (unsigned int i = 0; i < s_timer_count; i++)
+    {
+        app_timer_t *p_timer = s_timers[i];
+
+        if (p_timer->active && (s_now == p_timer->deadline))
+        {
+            if (p_timer->mode == APP_TIMER_MODE_REPEATED)
+            {
+                p_timer->deadline += p_timer->period;
+            }
+            else
+            {
+                p_timer->active = false;
+            }
+            p_timer->handler(p_timer->p_context);
+        }
+    }
+
+    bus_run();
+}
+
+/**@brief Run for the given time and return the number of bytes on the bus. */
+static uint32_t run(uint32_t ms)
+{
+    uint32_t bytes = s_bus_bytes;
+
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        tick();
+    }
+
+    return s_bus_bytes - bytes;
+}
+
+static void keyboard_event_handler(uint8_t *p_pressed_keys, uint8_t num_of_pressed_keys, bool keys_blocked)
+{
+    if (keys_blocked)
+    {
+        return;
+    }
+
+    if ((num_of_pressed_keys != s_key_count) || (memcmp(p_pressed_keys, s_keys, num_of_pressed_keys) != 0))
+    {
+        memcpy(s_keys, p_pressed_keys, num_of_pressed_keys);
+        s_key_count = num_of_pressed_keys;
+        s_key_events++;
+    }
+}
+
+static bool key_reported(uint8_t key_id)
+{
+    return memchr(s_keys, key_id, s_key_count) != NULL;
+}
+
+int main(void)
+{
+    uint8_t keys[DRV_KEYBOARD_MAX_KEYS];
+    uint8_t key_count;
+    bool    keys_blocked;
+
+    TEST_CHECK(drv_keyboard_init(keyboard_event_handler) == NRF_SUCCESS);
+    TEST_CHECK(drv_keyboard_keys_get(keys, &key_count, &keys_blocked) == NRF_SUCCESS);
+    TEST_CHECK(key_count == 0);
+    TEST_CHECK(drv_keyboard_enable() == NRF_SUCCESS);
+    run(100);
+
+    uint32_t idle = run(10000) / 10;
+
+    s_pressed[2][3] = true;
+    uint32_t one_key = run(1000);
+    TEST_CHECK((s_key_count == 1) && key_reported(KEYBOARD_KEY_ID(2, 3)));
+    s_pressed[2][3] = false;
+    run(200);
+    TEST_CHECK(s_key_count == 0);
+
+    s_pressed[2][3] = true;
+    run(100);
+    s_pressed[4][5] = true;
+    uint32_t two_keys = run(1000);
+    TEST_CHECK((s_key_count == 2) && key_reported(KEYBOARD_KEY_ID(2, 3)) && key_reported(KEYBOARD_KEY_ID(4, 5)));
+    s_pressed[2][3] = false;
+    run(100);
+    TEST_CHECK((s_key_count == 1) && key_reported(KEYBOARD_KEY_ID(4, 5)));
+    s_pressed[4][5] = false;
+    run(300);
+    TEST_CHECK(s_key_count == 0);
+
+    uint32_t idle_after = run(10000) / 10;
+
+    unsigned int wrong_taps = 0;
+
+    srand(1);
+    for (int tap = 0; tap < TAPS; tap++)
+    {
+        int          row    = rand() % KEYBOARD_NUM_OF_ROWS;
+        int          col    = rand() % KEYBOARD_NUM_OF_COLUMNS;
+        unsigned int events = s_key_events;
+        bool         press_reported;
+
+        s_pressed[row][col] = true;
+        run(50 + rand() % 300);
+        press_reported = (s_key_count == 1) && (s_keys[0] == KEYBOARD_KEY_ID(row, col));
+        s_pressed[row][col] = false;
+        run(200);
+
+        if (!press_reported || (s_key_count != 0) || (s_key_events != events + 2))
+        {
+            wrong_taps++;
+        }
+    }
+
+    TEST_CHECK(wrong_taps == 0);
+    TEST_CHECK(drv_keyboard_disable() == NRF_SUCCESS);
+
+    printf("%s: idle %u B/s, one key held %u B/s, two keys held %u B/s, idle afterwards %u B/s, "
+           "%u of %u random taps wrong\n",
+           CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED ? "keypad engine" : "column polling",
+           (unsigned)idle, (unsigned)one_key, (unsigned)two_keys, (unsigned)idle_after, wrong_taps, TAPS);
+
+#if CONFIG_KBD_SX1509_KEYPAD_ENGINE_ENABLED
+    TEST_CHECK((idle == 0) && (idle_after == 0));
+    TEST_CHECK(one_key * 10 < two_keys);
+#else
+    TEST_CHECK((idle > 0) && (idle_after == idle));
+#endif
+
+    return TEST_RESULT();
+}
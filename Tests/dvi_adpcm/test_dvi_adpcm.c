@@ -0,0 +1,287 @@
+/**@file
+ *
+ * @brief Golden-vector and equivalence test of the IMA/DVI ADPCM encoders, with a benchmark.
+ *
+ * @details dvi_adpcm_encode_fast() must produce the same stream and state as the reference
+ *          dvi_adpcm_encode() for every frame size, with and without header. dvi_adpcm_encode_lookahead()
+ *          must produce a stream that a standard decoder reconstructs at least as well as the reference.
+ *          Encoding times on the host are reported, and the fast encoder must not take longer than the
+ *          reference over the whole set of signals.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "dvi_adpcm.h"
+
+#define SIGNAL_LENGTH       200000
+#define BENCH_LENGTH        2000000
+#define BENCH_FRAME         128
+#define MAX_FRAME           161
+#define MAX_SNR_LOSS_DB     0.05        /**< Lookahead decisions are greedy, so they may lose marginally. */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**@brief Golden vector: a noisy sine encoded with header by the reference encoder. */
+static const int16_t s_golden_input[] =
+{
+     -1000,   5508,   9316,  11832,  12661,  11662,   8976,   4998,
+       321,  -4356,  -8334, -11020, -12019, -11190,  -8674,  -4866,
+      -359,   4148,   7956,  10472,  11301,  10302,   7616,   3638,
+       962,  -3715,  -7693, -10379, -11378, -10549,  -8033,  -4225,
+};
+
+static const uint8_t s_golden_output[] =
+{
+    0x00, 0x00, 0x00, 0xF7, 0x77, 0x77, 0x76, 0xEC, 0xA9, 0x91, 0x23, 0x53, 0x32, 0x19, 0xBD, 0xAD,
+    0xAA, 0x91, 0x24,
+};
+
+static const int s_index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static const int s_step_table[89] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767,
+};
+
+static const char * const s_signal_names[] = { "noise", "sweep", "bursts", "square", "steps" };
+
+static int16_t s_signal[BENCH_LENGTH];
+static uint8_t s_stream[2][BENCH_LENGTH / 2];
+static double  s_ref_time;                  /**< Reference encoder time over all signals. */
+static double  s_fast_time;                 /**< Fast encoder time over all signals. */
+
+static void signal_generate(int type, size_t len)
+{
+    double  phase = 0.0;
+    size_t  i;
+
+    srand(type);
+
+    for (i = 0; i < len; i++)
+    {
+        double v;
+
+        switch (type)
+        {
+            case 0:
+                v = (rand() % 65536) - 32768;
+                break;
+
+            case 1:
+                phase += 2.0 * M_PI * (50.0 + 7900.0 * (i % 160000) / 160000.0) / 16000.0;
+                v = 30000.0 * sin(phase);
+                break;
+
+            case 2:
+                v = ((i / 3000) % 2) ? (4000.0 * sin(i * 0.03) + 2000.0 * sin(i * 0.31) + (rand() % 600) - 300)
+                                     : ((rand() % 40) - 20);
+                break;
+
+            case 3:
+                v = ((i % 100) < 50) ? 32767 : -32768;
+                break;
+
+            default:
+                v = ((rand() % 3) - 1) * ((i % 7) * 4000.0);
+                break;
+        }
+
+        s_signal[i] = (int16_t)MAX(-32768.0, MIN(32767.0, v));
+    }
+}
+
+/**@brief Decode a headerless stream with a standard IMA/DVI decoder and return the SNR. */
+static double stream_snr(const uint8_t *p_stream, size_t len)
+{
+    double  signal = 0.0;
+    double  error = 0.0;
+    int     valpred = 0;
+    int     index = 0;
+    size_t  i;
+
+    for (i = 0; i < len; i++)
+    {
+        int code = (i & 1) ? (p_stream[i / 2] & 0x0F) : (p_stream[i / 2] >> 4);
+        int step = s_step_table[index];
+        int diff = step >> 3;
+        double e;
+
+        diff    += (code & 4) ? step : 0;
+        diff    += (code & 2) ? (step >> 1) : 0;
+        diff    += (code & 1) ? (step >> 2) : 0;
+        valpred += (code & 8) ? -diff : diff;
+        valpred  = MAX(-32768, MIN(32767, valpred));
+        index    = MAX(0, MIN(88, index + s_index_table[code]));
+
+        e        = (double)s_signal[i] - valpred;
+        signal  += (double)s_signal[i] * s_signal[i];
+        error   += e * e;
+    }
+
+    return 10.0 * log10(signal / error);
+}
+
+static void test_golden(void)
+{
+    uint8_t             out[sizeof(s_golden_output)];
+    dvi_adpcm_state_t   state;
+    int                 out_size;
+
+    dvi_adpcm_init_state(&state);
+    dvi_adpcm_encode((void *)s_golden_input, sizeof(s_golden_input), out, &out_size, &state, true);
+    TEST_CHECK(out_size == sizeof(s_golden_output));
+    TEST_CHECK(memcmp(out, s_golden_output, sizeof(s_golden_output)) == 0);
+    TEST_CHECK((state.valpred == -4199) && (state.index == 66));
+
+    dvi_adpcm_init_state(&state);
+    dvi_adpcm_encode_fast((void *)s_golden_input, sizeof(s_golden_input), out, &out_size, &state, true);
+    TEST_CHECK(out_size == sizeof(s_golden_output));
+    TEST_CHECK(memcmp(out, s_golden_output, sizeof(s_golden_output)) == 0);
+    TEST_CHECK((state.valpred == -4199) && (state.index == 66));
+}
+
+/**@brief Encode the signal in chained frames with both encoders and compare streams and states. */
+static void test_equivalence(int type)
+{
+    int frame;
+    int hflag;
+
+    for (frame = 1; frame <= MAX_FRAME; frame++)
+    {
+        for (hflag = 0; hflag <= 1; hflag++)
+        {
+            dvi_adpcm_state_t   ref_state;
+            dvi_adpcm_state_t   fast_state;
+            size_t              pos;
+            bool                same = true;
+
+            dvi_adpcm_init_state(&ref_state);
+            dvi_adpcm_init_state(&fast_state);
+
+            for (pos = 0; same && ((pos + frame) <= SIGNAL_LENGTH / 10); pos += frame)
+            {
+                uint8_t ref_out[(MAX_FRAME + 1) / 2 + 3];
+                uint8_t fast_out[(MAX_FRAME + 1) / 2 + 3];
+                int     ref_size;
+                int     fast_size;
+
+                dvi_adpcm_encode(&s_signal[pos], frame * 2, ref_out, &ref_size, &ref_state, hflag);
+                dvi_adpcm_encode_fast(&s_signal[pos], frame * 2, fast_out, &fast_size, &fast_state, hflag);
+
+                same = (ref_size == fast_size) &&
+                       (memcmp(ref_out, fast_out, ref_size) == 0) &&
+                       (ref_state.valpred == fast_state.valpred) &&
+                       (ref_state.index == fast_state.index);
+            }
+
+            if (!same)
+            {
+                printf("%s: frame %d, header %d differs at sample %zu\n",
+                       s_signal_names[type], frame, hflag, pos - frame);
+            }
+            TEST_CHECK(same);
+        }
+    }
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + (ts.tv_nsec * 1e-9);
+}
+
+/**@brief Encode the benchmark signal with each encoder, report times and check the SNR. */
+static void test_benchmark(int type)
+{
+    dvi_adpcm_state_t   state;
+    double              start, ref_time, fast_time, ref_snr;
+    size_t              pos;
+    int                 out_size;
+    int                 depth;
+
+    dvi_adpcm_init_state(&state);
+    start = seconds();
+    for (pos = 0; pos < BENCH_LENGTH; pos += BENCH_FRAME)
+    {
+        dvi_adpcm_encode(&s_signal[pos], BENCH_FRAME * 2, &s_stream[0][pos / 2], &out_size, &state, false);
+    }
+    ref_time = seconds() - start;
+
+    dvi_adpcm_init_state(&state);
+    start = seconds();
+    for (pos = 0; pos < BENCH_LENGTH; pos += BENCH_FRAME)
+    {
+        dvi_adpcm_encode_fast(&s_signal[pos], BENCH_FRAME * 2, &s_stream[1][pos / 2], &out_size, &state, false);
+    }
+    fast_time = seconds() - start;
+
+    TEST_CHECK(memcmp(s_stream[0], s_stream[1], sizeof(s_stream[0])) == 0);
+
+    s_ref_time  += ref_time;
+    s_fast_time += fast_time;
+
+    ref_snr = stream_snr(s_stream[0], BENCH_LENGTH);
+    printf("%-7s reference %5.2f ns/sample, fast %5.2f ns/sample, SNR %6.2f dB",
+           s_signal_names[type], 1e9 * ref_time / BENCH_LENGTH, 1e9 * fast_time / BENCH_LENGTH, ref_snr);
+
+    for (depth = 1; depth <= 3; depth++)
+    {
+        double snr;
+
+        dvi_adpcm_init_state(&state);
+        start = seconds();
+        for (pos = 0; pos < BENCH_LENGTH; pos += BENCH_FRAME)
+        {
+            dvi_adpcm_encode_lookahead(&s_signal[pos],
+                                       BENCH_FRAME * 2,
+                                       &s_stream[1][pos / 2],
+                                       &out_size,
+                                       &state,
+                                       false,
+                                       depth);
+        }
+        snr = stream_snr(s_stream[1], BENCH_LENGTH);
+        printf(" | lookahead %d: %5.2f ns/sample, %+5.2f dB", depth, 1e9 * (seconds() - start) / BENCH_LENGTH,
+               snr - ref_snr);
+
+        TEST_CHECK(snr >= (ref_snr - MAX_SNR_LOSS_DB));
+    }
+
+    printf("\n");
+}
+
+int main(void)
+{
+    int type;
+
+    test_golden();
+
+    for (type = 0; type < (int)ARRAY_SIZE(s_signal_names); type++)
+    {
+        signal_generate(type, BENCH_LENGTH);
+        test_equivalence(type);
+        test_benchmark(type);
+    }
+
+    printf("all     reference %5.2f ns/sample, fast %5.2f ns/sample\n",
+           1e9 * s_ref_time / (BENCH_LENGTH * ARRAY_SIZE(s_signal_names)),
+           1e9 * s_fast_time / (BENCH_LENGTH * ARRAY_SIZE(s_signal_names)));
+    TEST_CHECK(s_fast_time <= s_ref_time);
+
+    return TEST_RESULT();
+}
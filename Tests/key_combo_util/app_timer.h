@@ -0,0 +1,29 @@
+/* Stand-in for the SDK header of the same name: one timer, driven by the clock of the test. */
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define APP_TIMER_DEF(_timer_id)        static app_timer_id_t _timer_id
+#define APP_TIMER_TICKS(_ms)            ((uint32_t)(_ms))
+#define APP_TIMER_MIN_TIMEOUT_TICKS     5
+
+typedef void * app_timer_id_t;
+typedef void (*app_timer_timeout_handler_t)(void *p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED,
+} app_timer_mode_t;
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler);
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context);
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+uint32_t app_timer_cnt_get(void);
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+#endif // APP_TIMER_H__
@@ -0,0 +1,16 @@
+/* Key combo configuration used by the test. The number of combos comes from the board configuration. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_KBD_KEY_COMBO_ENABLED        1
+#define CONFIG_KBD_COMBO_LOG_LEVEL          0
+#define CONFIG_HID_HIGH_RES_ENABLED         0
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
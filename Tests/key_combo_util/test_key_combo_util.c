@@ -0,0 +1,374 @@
+/**@file
+ *
+ * @brief Test of the key combo matcher.
+ *
+ * @details The test includes key_combo_util.c, so it can reach the matcher state. The combo sections are arrays
+ *          defined by the test, and app_timer is a single timer driven by a millisecond clock which the test
+ *          advances. The members fill all KEY_COMBO_MAX_MEMBERS bits of the key mask, and one chord uses the
+ *          six highest bits.
+ *
+ *          The chord tests check hold and early release, order independence, exact set matching, re-arming on
+ *          press and release, invalidation by a key which is not a member, and that a stale timeout does not
+ *          fire a re-armed chord early. The sequence tests check the window, breaking by other keys, restarting
+ *          and double taps. The init tests check the validation of the sections.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "key_combo_util.c"
+
+#define KEY_A           0x10
+#define KEY_B           0x11
+#define KEY_C           0x12
+#define KEY_D           0x20
+#define KEY_OTHER       0x55
+#define KEY_WIDE(_i)    (0xC0 + (_i))   /**< Members which get the highest bits of the key mask. */
+#define KEY_FILLER      0x80            /**< First member added to fill the key mask. */
+
+enum
+{
+    COMBO_A,
+    COMBO_AB,
+    COMBO_CBA,
+    COMBO_SEQ_DC,
+    COMBO_SEQ_DD,
+    COMBO_WIDE,
+    COMBO_COUNT
+};
+
+static uint32_t                     s_now;
+static uint32_t                     s_timer_deadline;
+static bool                         s_timer_running;
+static void                       * s_timer_context;
+static app_timer_timeout_handler_t  s_timer_handler;
+static unsigned int                 s_hits[COMBO_COUNT];
+
+static void combo_a_handler(void *p_context)        { s_hits[COMBO_A]++; }
+static void combo_ab_handler(void *p_context)       { s_hits[COMBO_AB]++; }
+static void combo_cba_handler(void *p_context)      { s_hits[COMBO_CBA]++; }
+static void combo_seq_dc_handler(void *p_context)   { s_hits[COMBO_SEQ_DC]++; }
+static void combo_seq_dd_handler(void *p_context)   { s_hits[COMBO_SEQ_DD]++; }
+static void combo_wide_handler(void *p_context)     { s_hits[COMBO_WIDE]++; }
+
+key_combo_desc_t combo_descriptions_items[CONFIG_KBD_KEY_COMBO_MAX_COUNT + 1] =
+{
+    [COMBO_A]      = { { KEY_A },               1, KEY_COMBO_TYPE_CHORD,    3000, combo_a_handler },
+    [COMBO_AB]     = { { KEY_A, KEY_B },        2, KEY_COMBO_TYPE_CHORD,    1000, combo_ab_handler },
+    [COMBO_CBA]    = { { KEY_C, KEY_B, KEY_A }, 3, KEY_COMBO_TYPE_CHORD,    1000, combo_cba_handler },
+    [COMBO_SEQ_DC] = { { KEY_D, KEY_C },        2, KEY_COMBO_TYPE_SEQUENCE, 500,  combo_seq_dc_handler },
+    [COMBO_SEQ_DD] = { { KEY_D, KEY_D },        2, KEY_COMBO_TYPE_SEQUENCE, 300,  combo_seq_dd_handler },
+    [COMBO_WIDE]   = { { KEY_WIDE(0), KEY_WIDE(1), KEY_WIDE(2), KEY_WIDE(3), KEY_WIDE(4), KEY_WIDE(5) },
+                       6, KEY_COMBO_TYPE_CHORD, 200, combo_wide_handler },
+};
+size_t combo_descriptions_count = COMBO_COUNT;
+
+key_combo_member_t combo_member_keys_items[KEY_COMBO_MAX_MEMBERS + 2];
+size_t combo_member_keys_count;
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(mode == APP_TIMER_MODE_SINGLE_SHOT);
+    s_timer_handler = timeout_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    s_timer_running  = true;
+    s_timer_deadline = s_now + timeout_ticks;
+    s_timer_context  = p_context;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    s_timer_running = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return s_now & 0xFFFFFF;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & 0xFFFFFF;
+}
+
+/**@brief Advance the clock, firing the timer when it expires. */
+static void advance(uint32_t ms)
+{
+    for (uint32_t end = s_now + ms; s_now < end; )
+    {
+        s_now++;
+        if (s_timer_running && (s_now == s_timer_deadline))
+        {
+            s_timer_running = false;
+            s_timer_handler(s_timer_context);
+        }
+    }
+}
+
+static void key_event(event_type_t type, uint8_t key_id)
+{
+    event_t event = { .type = type };
+
+    event.key.id = key_id;
+    TEST_CHECK(key_combo_util_key_process(&event) == false);
+}
+
+static void key_down(uint8_t key_id)
+{
+    key_event(EVT_KEY_DOWN, key_id);
+}
+
+static void key_up(uint8_t key_id)
+{
+    key_event(EVT_KEY_UP, key_id);
+}
+
+static void key_tap(uint8_t key_id)
+{
+    key_down(key_id);
+    key_up(key_id);
+}
+
+/**@brief Register the member keys: the combo keys, one of them twice, and fillers up to the maximum. */
+static void members_register(void)
+{
+    static const uint8_t keys[] = { KEY_A, KEY_B, KEY_C, KEY_D, KEY_A };
+    uint8_t filler = KEY_FILLER;
+
+    combo_member_keys_count = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(keys); i++)
+    {
+        combo_member_keys_items[combo_member_keys_count++].key_id = keys[i];
+    }
+
+    while (combo_member_keys_count < KEY_COMBO_MAX_MEMBERS + 1 - 6)
+    {
+        combo_member_keys_items[combo_member_keys_count++].key_id = filler++;
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        combo_member_keys_items[combo_member_keys_count++].key_id = KEY_WIDE(i);
+    }
+}
+
+static void test_chords(void)
+{
+    // Single key held: triggers once, at the deadline.
+    key_down(KEY_A);
+    advance(2999);
+    TEST_CHECK(s_hits[COMBO_A] == 0);
+    advance(1);
+    TEST_CHECK(s_hits[COMBO_A] == 1);
+    advance(5000);
+    TEST_CHECK(s_hits[COMBO_A] == 1);
+    key_up(KEY_A);
+
+    // Released early: does not trigger.
+    key_down(KEY_A);
+    advance(1000);
+    key_up(KEY_A);
+    advance(5000);
+    TEST_CHECK(s_hits[COMBO_A] == 1);
+
+    // Two keys in any order. The chord is armed when the set matches.
+    key_down(KEY_B);
+    advance(200);
+    key_down(KEY_A);
+    advance(999);
+    TEST_CHECK(s_hits[COMBO_AB] == 0);
+    advance(1);
+    TEST_CHECK(s_hits[COMBO_AB] == 1);
+
+    // Releasing a key leaves a set which matches another chord, armed from the release.
+    key_up(KEY_B);
+    advance(2999);
+    TEST_CHECK(s_hits[COMBO_A] == 1);
+    advance(1);
+    TEST_CHECK(s_hits[COMBO_A] == 2);
+    key_up(KEY_A);
+
+    // A superset matches only the larger chord.
+    key_down(KEY_A);
+    key_down(KEY_B);
+    advance(500);
+    key_down(KEY_C);
+    advance(600);
+    TEST_CHECK(s_hits[COMBO_AB] == 1);
+    advance(400);
+    TEST_CHECK(s_hits[COMBO_CBA] == 1);
+    key_up(KEY_A);
+    key_up(KEY_B);
+    key_up(KEY_C);
+    advance(5000);
+    TEST_CHECK((s_hits[COMBO_AB] == 1) && (s_hits[COMBO_A] == 2));
+
+    // A key which is not a member invalidates the chord.
+    key_down(KEY_A);
+    advance(1000);
+    key_down(KEY_OTHER);
+    advance(5000);
+    TEST_CHECK(s_hits[COMBO_A] == 2);
+    key_up(KEY_OTHER);
+    key_up(KEY_A);
+    advance(5000);
+
+    // A timeout queued before the chord was re-armed is ignored.
+    key_down(KEY_A);
+    advance(2000);
+    key_up(KEY_A);
+    key_down(KEY_A);
+    advance(1);
+    s_timer_handler(s_timer_context);
+    TEST_CHECK(s_hits[COMBO_A] == 2);
+    advance(2999);
+    TEST_CHECK(s_hits[COMBO_A] == 3);
+    key_up(KEY_A);
+
+    // Six keys on the highest bits of the key mask.
+    for (int i = 5; i >= 0; i--)
+    {
+        key_down(KEY_WIDE(i));
+    }
+    advance(200);
+    TEST_CHECK(s_hits[COMBO_WIDE] == 1);
+    for (int i = 0; i < 6; i++)
+    {
+        key_up(KEY_WIDE(i));
+    }
+    advance(5000);
+
+    // A chord does not trigger with a member key missing.
+    for (int i = 0; i < 5; i++)
+    {
+        key_down(KEY_WIDE(i));
+    }
+    advance(5000);
+    TEST_CHECK(s_hits[COMBO_WIDE] == 1);
+    for (int i = 0; i < 5; i++)
+    {
+        key_up(KEY_WIDE(i));
+    }
+    advance(5000);
+    TEST_CHECK((s_hits[COMBO_A] == 3) && (s_hits[COMBO_AB] == 1) && (s_hits[COMBO_CBA] == 1));
+}
+
+static void test_sequences(void)
+{
+    // Within the window.
+    key_tap(KEY_D);
+    advance(400);
+    key_down(KEY_C);
+    TEST_CHECK(s_hits[COMBO_SEQ_DC] == 1);
+    key_up(KEY_C);
+
+    // Too slow.
+    advance(1000);
+    key_tap(KEY_D);
+    advance(600);
+    key_down(KEY_C);
+    TEST_CHECK(s_hits[COMBO_SEQ_DC] == 1);
+    key_up(KEY_C);
+
+    // Broken by another member key and by a key which is not a member.
+    advance(1000);
+    key_tap(KEY_D);
+    advance(100);
+    key_tap(KEY_B);
+    key_down(KEY_C);
+    TEST_CHECK(s_hits[COMBO_SEQ_DC] == 1);
+    key_up(KEY_C);
+
+    advance(1000);
+    key_tap(KEY_D);
+    advance(100);
+    key_tap(KEY_OTHER);
+    key_down(KEY_C);
+    TEST_CHECK(s_hits[COMBO_SEQ_DC] == 1);
+    key_up(KEY_C);
+
+    // Double tap. A third tap starts a new pair.
+    advance(1000);
+    key_tap(KEY_D);
+    advance(200);
+    key_tap(KEY_D);
+    TEST_CHECK(s_hits[COMBO_SEQ_DD] == 1);
+    advance(100);
+    key_tap(KEY_D);
+    TEST_CHECK(s_hits[COMBO_SEQ_DD] == 1);
+    advance(100);
+    key_tap(KEY_D);
+    TEST_CHECK(s_hits[COMBO_SEQ_DD] == 2);
+
+    // A first key too late restarts the sequence.
+    advance(1000);
+    key_tap(KEY_D);
+    advance(2000);
+    key_tap(KEY_D);
+    advance(100);
+    key_down(KEY_C);
+    TEST_CHECK(s_hits[COMBO_SEQ_DC] == 2);
+    key_up(KEY_C);
+
+    // Sequences do not arm chords of their keys.
+    advance(5000);
+    TEST_CHECK((s_hits[COMBO_A] == 3) && (s_hits[COMBO_AB] == 1) && (s_hits[COMBO_CBA] == 1));
+}
+
+static void test_init(void)
+{
+    // Key not registered as a member.
+    combo_descriptions_items[COMBO_AB].combo_keys[1] = KEY_OTHER;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_INVALID_DATA);
+
+    // Same key twice in a chord.
+    combo_descriptions_items[COMBO_AB].combo_keys[1] = KEY_A;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_INVALID_DATA);
+    combo_descriptions_items[COMBO_AB].combo_keys[1] = KEY_B;
+
+    // No keys, and too many keys.
+    combo_descriptions_items[COMBO_A].combo_num_keys = 0;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_INVALID_DATA);
+    combo_descriptions_items[COMBO_A].combo_num_keys = KEY_COMBO_MAX_KEYS + 1;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_INVALID_DATA);
+    combo_descriptions_items[COMBO_A].combo_num_keys = 1;
+
+    // Too many combos.
+    combo_descriptions_count = CONFIG_KBD_KEY_COMBO_MAX_COUNT + 1;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_NO_MEM);
+    combo_descriptions_count = COMBO_COUNT;
+
+    // Too many members.
+    combo_member_keys_items[combo_member_keys_count++].key_id = KEY_OTHER;
+    TEST_CHECK(key_combo_util_init() == NRF_ERROR_INVALID_DATA);
+    combo_member_keys_count--;
+
+    TEST_CHECK(key_combo_util_init() == NRF_SUCCESS);
+}
+
+int main(void)
+{
+    members_register();
+
+    TEST_CHECK(key_combo_util_init() == NRF_SUCCESS);
+    TEST_CHECK(m_key_bit[KEY_WIDE(5)] == KEY_COMBO_MAX_MEMBERS - 1);
+
+    test_chords();
+    test_sequences();
+    test_init();
+
+    printf("hits: A %u, AB %u, CBA %u, D-C %u, D-D %u, wide %u\n",
+           s_hits[COMBO_A], s_hits[COMBO_AB], s_hits[COMBO_CBA],
+           s_hits[COMBO_SEQ_DC], s_hits[COMBO_SEQ_DD], s_hits[COMBO_WIDE]);
+
+    return TEST_RESULT();
+}
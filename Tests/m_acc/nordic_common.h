@@ -0,0 +1,16 @@
+/* Stand-in for the SDK header of the same name: the bit masks used by the accelerometer driver. */
+#ifndef NORDIC_COMMON_H__
+#define NORDIC_COMMON_H__
+
+#include "app_util.h"
+
+#define BIT_0   0x01
+#define BIT_1   0x02
+#define BIT_2   0x04
+#define BIT_3   0x08
+#define BIT_4   0x10
+#define BIT_5   0x20
+#define BIT_6   0x40
+#define BIT_7   0x80
+
+#endif // NORDIC_COMMON_H__
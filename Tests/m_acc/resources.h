@@ -0,0 +1,18 @@
+/* Stand-in for the header of the same name: the foreground scheduler and the TWI resources. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#include "sdk_errors.h"
+#include "nrf_twi_mngr.h"
+
+#define LIS3DH_TWI_ADDRESS  (0x19)
+
+typedef struct __app_isched_struct { int unused; } app_isched_t;
+typedef void (*app_isched_event_handler_t)(void *p_context);
+
+extern app_isched_t g_fg_scheduler;
+extern nrf_drv_twi_config_t const g_twi_bus_config[2];
+
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context);
+
+#endif /* __RESOURCES_H__ */
@@ -0,0 +1,32 @@
+/* Accelerometer configuration used by the test: the LIS3DH driver on TWI bus 0, motion gating without click
+ * detection and without power management. The thresholds and the stationary timing come from the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define IS_IO_VALID(io)                     (((io) & ~0x1F) == 0)
+
+#define CONFIG_ACC_ENABLED                  1
+#define CONFIG_ACC_DRIVER_LIS3DH            1
+#define CONFIG_ACC_DRIVER_BMA222E           2
+#define CONFIG_ACC_DRIVER                   CONFIG_ACC_DRIVER_LIS3DH
+#define CONFIG_ACC_TWI_BUS                  0
+#define CONFIG_ACC_USE_CLICK_DETECTION      0
+#define CONFIG_ACC_WAKEUP_SOURCE            1
+#define CONFIG_ACC_MODULE_LOG_LEVEL         0
+#define CONFIG_ACC_DRV_LOG_LEVEL            0
+#define CONFIG_IO_ACC_IRQ                   5
+
+#define CONFIG_GYRO_ENABLED                 1
+#define CONFIG_GYRO_MOTION_GATING_ENABLED   1
+
+#define CONFIG_PWR_MGMT_ENABLED             0
+#define CONFIG_HID_HIGH_RES_ENABLED         0
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
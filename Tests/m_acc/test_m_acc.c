@@ -0,0 +1,493 @@
+/**@file
+ *
+ * @brief Test of the gyroscope motion gating state machine in the accelerometer module.
+ *
+ * @details The test includes m_acc.c and drv_acc_lis3dh.c. TWI transfers are executed by a register model of the
+ *          LIS3DH, which samples a synthetic acceleration trace every 10 ms while the sensor is powered, fills the
+ *          FIFO in stream mode and raises the IRQ pin when the high-pass filtered acceleration of an enabled axis
+ *          exceeds INT1_THS. The clock advances by one millisecond per step, running the timers and then the
+ *          foreground scheduler queue. The motion handler stands in for the gyroscope.
+ *
+ *          The traces string together the remote lying on a desk, held in a still hand, swung around, and being
+ *          put down or picked up. The gyroscope must be parked within PARK_DELAY_MAX ms of the remote reaching the
+ *          desk, and woken within WAKE_DELAY_MAX ms of the remote being moved. It must never be parked while the
+ *          remote is held or swung, and the handler must never be told the state it is already in.
+ */
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "m_acc.c"
+#include "drv_acc_lis3dh.c"
+
+#define MAX_TIMERS          4
+#define QUEUE_SIZE          8
+#define SAMPLE_INTERVAL     10      /**< Sampling interval of the model, at DRV_ACC_MOTION_TRACK_ODR [ms]. */
+#define HP_FILTER_SHIFT     4       /**< Time constant of the model high-pass filter, in samples (log2). */
+#define THS_LSB             16      /**< INT1_THS unit at +/-2 g [mg]. */
+#define PARK_DELAY_MAX      900     /**< Longest time from reaching the desk to parking the gyroscope [ms]. */
+#define WAKE_DELAY_MAX      30      /**< Longest time from starting to move to waking the gyroscope [ms]. */
+#define DESK_MIN_TIME       2000    /**< Shortest desk segment checked for parking [ms]. */
+
+/**@brief Motion of the remote. */
+typedef enum
+{
+    MOTION_DESK,        /**< Lying on a desk, sensor noise only. */
+    MOTION_HELD,        /**< Held in a still hand, with tremor. */
+    MOTION_SWING,       /**< Swung around to point. */
+    MOTION_TRANSIENT,   /**< Put down or picked up. */
+} motion_t;
+
+typedef struct
+{
+    motion_t motion;
+    uint32_t duration;  /**< Duration of the segment [ms]. */
+} segment_t;
+
+nrf_drv_twi_config_t const g_twi_bus_config[2];
+app_isched_t               g_fg_scheduler;
+
+static uint32_t                     s_now;
+static uint32_t                     s_bus_bytes;
+static uint8_t                      s_registers[128];
+static int16_t                      s_fifo[DRV_ACC_FIFO_SIZE][3];
+static unsigned int                 s_fifo_count;
+static double                       s_hp_reference[3];
+static bool                         s_irq_high;
+static bool                         s_gpiote_enabled;
+static app_gpiote_event_handler_t   s_gpiote_handler;
+static app_timer_t                * s_timers[MAX_TIMERS];
+static unsigned int                 s_timer_count;
+static app_isched_event_handler_t   s_queue[QUEUE_SIZE];
+static unsigned int                 s_queue_size;
+static uint32_t                     s_random = 1;
+
+static bool                         s_gyro_on;
+static uint32_t                     s_gyro_on_time;
+static uint32_t                     s_gyro_changed;
+static unsigned int                 s_parks;
+static unsigned int                 s_wakes;
+static unsigned int                 s_duplicates;
+
+ret_code_t event_send(event_type_t event_type, ...)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return s_now;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(s_timer_count < MAX_TIMERS);
+
+    (*p_timer_id)->handler = timeout_handler;
+    (*p_timer_id)->mode    = mode;
+    s_timers[s_timer_count++] = *p_timer_id;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    // A running repeated timer is not restarted, like on the RTC.
+    if (timer_id->active && (timer_id->mode == APP_TIMER_MODE_REPEATED))
+    {
+        return NRF_SUCCESS;
+    }
+
+    timer_id->active    = true;
+    timer_id->deadline  = s_now + timeout_ticks;
+    timer_id->period    = timeout_ticks;
+    timer_id->p_context = p_context;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_register(app_gpiote_user_id_t *p_user_id,
+                                    uint32_t const *p_pins_low_to_high_mask,
+                                    uint32_t const *p_pins_high_to_low_mask,
+                                    app_gpiote_event_handler_t event_handler)
+{
+    TEST_CHECK(*p_pins_low_to_high_mask == (1ul << CONFIG_IO_ACC_IRQ));
+    s_gpiote_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_enable(app_gpiote_user_id_t user_id)
+{
+    s_gpiote_enabled = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_gpiote_user_disable(app_gpiote_user_id_t user_id)
+{
+    s_gpiote_enabled = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context)
+{
+    if (s_queue_size == QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    s_queue[s_queue_size++] = handler;
+    return NRF_SUCCESS;
+}
+
+/**@brief True if the FIFO is enabled and in stream mode. */
+static bool fifo_enabled(void)
+{
+    return (s_registers[CTRL_REG5] & 0x40) && (s_registers[FIFO_CTRL_REG] == 0x80);
+}
+
+/**@brief FIFO_SRC_REG: watermark, overrun, empty and sample count. */
+static uint8_t fifo_source(void)
+{
+    if (s_fifo_count == DRV_ACC_FIFO_SIZE)
+    {
+        return 0x40 | (DRV_ACC_FIFO_SIZE - 1);
+    }
+
+    return (s_fifo_count == 0) ? 0x20 : s_fifo_count;
+}
+
+ret_code_t twi_perform(nrf_drv_twi_config_t const *p_bus_config,
+                       nrf_twi_mngr_transfer_t const *p_transfers,
+                       uint8_t transfer_count)
+{
+    uint8_t addr = p_transfers[0].p_data[0] & 0x7F;
+
+    TEST_CHECK((p_transfers[0].operation >> 1) == LIS3DH_TWI_ADDRESS);
+    TEST_CHECK(!NRF_TWI_MNGR_IS_READ_OP(p_transfers[0].operation));
+
+    for (uint8_t i = 0; i < transfer_count; i++)
+    {
+        s_bus_bytes += p_transfers[i].length + 1;
+    }
+
+    if (transfer_count == 1)
+    {
+        for (uint8_t i = 1; i < p_transfers[0].length; i++, addr++)
+        {
+            s_registers[addr] = p_transfers[0].p_data[i];
+
+            // Bypass mode empties the FIFO.
+            if ((addr == FIFO_CTRL_REG) && (s_registers[addr] == 0))
+            {
+                s_fifo_count = 0;
+            }
+        }
+
+        return NRF_SUCCESS;
+    }
+
+    uint8_t *p_data = p_transfers[1].p_data;
+    uint8_t  length = p_transfers[1].length;
+
+    TEST_CHECK(transfer_count == 2);
+    TEST_CHECK(NRF_TWI_MNGR_IS_READ_OP(p_transfers[1].operation));
+
+    if ((addr == OUT_X_L) && fifo_enabled())
+    {
+        TEST_CHECK((length % sizeof(s_fifo[0])) == 0);
+        TEST_CHECK(length / sizeof(s_fifo[0]) <= s_fifo_count);
+
+        memcpy(p_data, s_fifo, length);
+        s_fifo_count -= length / sizeof(s_fifo[0]);
+        memmove(s_fifo, &s_fifo[length / sizeof(s_fifo[0])], s_fifo_count * sizeof(s_fifo[0]));
+
+        return NRF_SUCCESS;
+    }
+
+    for (uint8_t i = 0; i < length; i++, addr++)
+    {
+        switch (addr)
+        {
+            case WHO_AM_I:
+                p_data[i] = 0x33;
+                break;
+
+            case FIFO_SRC_REG:
+                p_data[i] = fifo_source();
+                break;
+
+            default:
+                p_data[i] = s_registers[addr];
+                break;
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+/**@brief Gyroscope stand-in. */
+static void motion_handler(bool moving)
+{
+    if (moving == s_gyro_on)
+    {
+        s_duplicates++;
+        return;
+    }
+
+    s_gyro_on      = moving;
+    s_gyro_changed = s_now;
+
+    if (moving)
+    {
+        s_wakes++;
+    }
+    else
+    {
+        s_parks++;
+    }
+}
+
+static double uniform(void)
+{
+    s_random = s_random * 1103515245 + 12345;
+    return ((s_random >> 8) & 0xFFFF) / 65536.0;
+}
+
+static double gaussian(void)
+{
+    return sqrt(-2.0 * log(uniform() + 1e-9)) * cos(2.0 * M_PI * uniform());
+}
+
+/**@brief Acceleration of the remote at the given time into a segment [mg]. */
+static void acceleration(motion_t motion, uint32_t time, double acc[3])
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        acc[axis] = (axis == 2) ? 1000.0 : 0.0;
+
+        switch (motion)
+        {
+            case MOTION_DESK:
+                acc[axis] += 1.5 * gaussian();
+                break;
+
+            case MOTION_HELD:
+                acc[axis] += 10.0 * gaussian() + 15.0 * sin(time * 0.06 + axis);
+                break;
+
+            case MOTION_SWING:
+                acc[axis] += 10.0 * gaussian() + 300.0 * sin(time * 0.008 + axis);
+                break;
+
+            case MOTION_TRANSIENT:
+                acc[axis] += 10.0 * gaussian() + ((time < 150) ? 250.0 * time / 150 : 250.0);
+                break;
+        }
+    }
+}
+
+/**@brief Take one sample: fill the FIFO and update the IRQ pin. */
+static void sensor_sample(motion_t motion, uint32_t time)
+{
+    double  acc[3];
+    int16_t raw[3];
+    bool    irq_high = false;
+
+    acceleration(motion, time, acc);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        // Normal mode: 10-bit samples, left-justified.
+        raw[axis] = (int16_t)(((int)lround(acc[axis]) & ~3) * 16);
+
+        double high_pass = acc[axis] - s_hp_reference[axis];
+
+        s_hp_reference[axis] += high_pass / (1 << HP_FILTER_SHIFT);
+        if ((s_registers[INT1_CFG] & (0x02 << (2 * axis))) && (fabs(high_pass) > s_registers[INT1_THS] * THS_LSB))
+        {
+            irq_high = true;
+        }
+    }
+
+    if (fifo_enabled())
+    {
+        // Stream mode: the oldest sample is dropped on overrun.
+        if (s_fifo_count == DRV_ACC_FIFO_SIZE)
+        {
+            memmove(s_fifo, &s_fifo[1], (DRV_ACC_FIFO_SIZE - 1) * sizeof(s_fifo[0]));
+            s_fifo_count--;
+        }
+        memcpy(s_fifo[s_fifo_count++], raw, sizeof(raw));
+    }
+
+    // INT1 is routed to the pin by I1_AOI1.
+    irq_high = irq_high && (s_registers[CTRL_REG3] & 0x40);
+
+    if (irq_high && !s_irq_high && s_gpiote_enabled)
+    {
+        uint32_t low_to_high = 1ul << CONFIG_IO_ACC_IRQ;
+        uint32_t high_to_low = 0;
+
+        s_gpiote_handler(&low_to_high, &high_to_low);
+    }
+    s_irq_high = irq_high;
+}
+
+/**@brief Advance the clock by one millisecond. */
+static void step(motion_t motion, uint32_t time)
+{
+    s_now++;
+
+    // Any output data rate selected in CTRL_REG1 is modeled at DRV_ACC_MOTION_TRACK_ODR.
+    if (((s_now % SAMPLE_INTERVAL) == 0) && (s_registers[CTRL_REG1] & 0xF0))
+    {
+        sensor_sample(motion, time);
+    }
+
+    for (unsigned int i = 0; i < s_timer_count; i++)
+    {
+        app_timer_t *p_timer = s_timers[i];
+
+        if (p_timer->active && (p_timer->deadline == s_now))
+        {
+            if (p_timer->mode == APP_TIMER_MODE_REPEATED)
+            {
+                p_timer->deadline += p_timer->period;
+            }
+            else
+            {
+                p_timer->active = false;
+            }
+
+            p_timer->handler(p_timer->p_context);
+        }
+    }
+
+    while (s_queue_size > 0)
+    {
+        app_isched_event_handler_t handler = s_queue[0];
+
+        memmove(s_queue, &s_queue[1], --s_queue_size * sizeof(s_queue[0]));
+        handler(NULL);
+    }
+
+    if (s_gyro_on)
+    {
+        s_gyro_on_time++;
+    }
+}
+
+/**@brief Run a trace with motion tracking on, starting with the gyroscope on. */
+static void run(char const *p_name, segment_t const *p_segments, size_t segment_count)
+{
+    uint32_t total_time = 0;
+
+    s_now          = 0;
+    s_bus_bytes    = 0;
+    s_gyro_on      = true;
+    s_gyro_on_time = 0;
+    s_parks        = 0;
+    s_wakes        = 0;
+    s_duplicates   = 0;
+
+    s_hp_reference[0] = 0.0;
+    s_hp_reference[1] = 0.0;
+    s_hp_reference[2] = 1000.0;
+
+    TEST_CHECK(m_acc_motion_tracking_enable(motion_handler) == NRF_SUCCESS);
+
+    for (size_t i = 0; i < segment_count; i++)
+    {
+        segment_t const *p_segment = &p_segments[i];
+        uint32_t         start     = s_now;
+        unsigned int     parks     = s_parks;
+        unsigned int     wakes     = s_wakes;
+        bool             gyro_on   = s_gyro_on;
+
+        for (uint32_t time = 0; time < p_segment->duration; time++)
+        {
+            step(p_segment->motion, time);
+        }
+        total_time += p_segment->duration;
+
+        if (p_segment->motion == MOTION_DESK)
+        {
+            if (p_segment->duration >= DESK_MIN_TIME)
+            {
+                TEST_CHECK(!s_gyro_on);
+                TEST_CHECK(s_parks > parks);
+                TEST_CHECK(s_gyro_changed - start <= PARK_DELAY_MAX);
+            }
+            continue;
+        }
+
+        if (!gyro_on)
+        {
+            TEST_CHECK(s_wakes > wakes);
+            TEST_CHECK(s_parks > parks || (s_gyro_changed - start <= WAKE_DELAY_MAX));
+        }
+
+        // A transient may start or end on the desk.
+        if (p_segment->motion != MOTION_TRANSIENT)
+        {
+            TEST_CHECK(s_parks == parks);
+        }
+    }
+
+    TEST_CHECK(m_acc_motion_tracking_disable() == NRF_SUCCESS);
+    TEST_CHECK(s_duplicates == 0);
+
+    printf("%-18s gyro on %5u/%5u ms (%3.0f%%), parks %u, wakes %u, accelerometer TWI %4.0f B/s\n",
+           p_name, (unsigned)s_gyro_on_time, (unsigned)total_time, 100.0 * s_gyro_on_time / total_time,
+           s_parks, s_wakes, s_bus_bytes * 1000.0 / total_time);
+}
+
+int main(void)
+{
+    static const segment_t put_down_pick_up[] =
+    {
+        { MOTION_HELD,      3000 },
+        { MOTION_TRANSIENT, 300  },
+        { MOTION_DESK,      5000 },
+        { MOTION_TRANSIENT, 300  },
+        { MOTION_SWING,     2000 },
+        { MOTION_HELD,      1000 },
+        { MOTION_TRANSIENT, 300  },
+        { MOTION_DESK,      4000 },
+        { MOTION_SWING,     1000 },
+    };
+    static const segment_t held_still[] =
+    {
+        { MOTION_HELD,      15000 },
+    };
+    static const segment_t desk_swing_desk[] =
+    {
+        { MOTION_DESK,      10000 },
+        { MOTION_SWING,     500   },
+        { MOTION_DESK,      3000  },
+    };
+
+    TEST_CHECK(m_acc_init() == NRF_SUCCESS);
+
+    run("put-down/pick-up", put_down_pick_up, ARRAY_SIZE(put_down_pick_up));
+
+    run("held still", held_still, ARRAY_SIZE(held_still));
+    TEST_CHECK(s_parks == 0);
+
+    run("desk-swing-desk", desk_swing_desk, ARRAY_SIZE(desk_swing_desk));
+    TEST_CHECK(s_parks == 2);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,70 @@
+/* Stand-in for the SDK header of the same name: one channel sampled by the test. The SDK configuration is the one
+ * of the firmware projects. */
+#ifndef NRF_DRV_SAADC_H__
+#define NRF_DRV_SAADC_H__
+
+#include <stdint.h>
+
+#include "nrf_assert.h"
+#include "sdk_errors.h"
+
+#define SAADC_ENABLED                   1
+#define SAADC_CONFIG_RESOLUTION         NRF_SAADC_RESOLUTION_14BIT
+#define SAADC_CONFIG_OVERSAMPLE         3
+
+#define NRF_SAADC_RESOLUTION_14BIT      3
+#define NRF_SAADC_INPUT_VDD             9
+#define NRF_SAADC_REFERENCE_INTERNAL    0
+#define NRF_SAADC_GAIN1_6               0
+#define NRF_SAADC_BURST_DISABLED        0
+#define NRF_SAADC_BURST_ENABLED         1
+
+#define NRF_DRV_SAADC_DEFAULT_CHANNEL_CONFIG_SE(_pin)   \
+{                                                       \
+    .reference  = NRF_SAADC_REFERENCE_INTERNAL,         \
+    .gain       = NRF_SAADC_GAIN1_6,                    \
+    .burst      = NRF_SAADC_BURST_DISABLED,             \
+    .pin_p      = (_pin),                               \
+}
+
+typedef int16_t nrf_saadc_value_t;
+
+typedef struct
+{
+    int reference;
+    int gain;
+    int burst;
+    int pin_p;
+} nrf_saadc_channel_config_t;
+
+typedef enum
+{
+    NRF_DRV_SAADC_EVT_DONE,
+    NRF_DRV_SAADC_EVT_LIMIT,
+    NRF_DRV_SAADC_EVT_CALIBRATEDONE,
+} nrf_drv_saadc_evt_type_t;
+
+typedef struct
+{
+    nrf_drv_saadc_evt_type_t type;
+    union
+    {
+        struct
+        {
+            nrf_saadc_value_t * p_buffer;
+            uint16_t            size;
+        } done;
+    } data;
+} nrf_drv_saadc_evt_t;
+
+typedef void (*nrf_drv_saadc_event_handler_t)(nrf_drv_saadc_evt_t const *p_event);
+
+ret_code_t nrf_drv_saadc_init(void const *p_config, nrf_drv_saadc_event_handler_t event_handler);
+void nrf_drv_saadc_uninit(void);
+ret_code_t nrf_drv_saadc_channel_init(uint8_t channel, nrf_saadc_channel_config_t const *p_config);
+ret_code_t nrf_drv_saadc_channel_uninit(uint8_t channel);
+ret_code_t nrf_drv_saadc_buffer_convert(nrf_saadc_value_t *p_buffer, uint16_t size);
+ret_code_t nrf_drv_saadc_sample(void);
+ret_code_t nrf_drv_saadc_calibrate_offset(void);
+
+#endif // NRF_DRV_SAADC_H__
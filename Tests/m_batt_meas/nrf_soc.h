@@ -0,0 +1,25 @@
+/* Stand-in for the SoftDevice header of the same name: the radio notification configuration. */
+#ifndef NRF_SOC_H__
+#define NRF_SOC_H__
+
+#include <stdint.h>
+
+#define NRF_SDH_BLE_ENABLED     1
+
+enum NRF_RADIO_NOTIFICATION_TYPES
+{
+    NRF_RADIO_NOTIFICATION_TYPE_NONE,
+    NRF_RADIO_NOTIFICATION_TYPE_INT_ON_ACTIVE,
+    NRF_RADIO_NOTIFICATION_TYPE_INT_ON_INACTIVE,
+    NRF_RADIO_NOTIFICATION_TYPE_INT_ON_BOTH,
+};
+
+enum NRF_RADIO_NOTIFICATION_DISTANCES
+{
+    NRF_RADIO_NOTIFICATION_DISTANCE_NONE,
+    NRF_RADIO_NOTIFICATION_DISTANCE_800US,
+};
+
+uint32_t sd_radio_notification_cfg_set(uint8_t type, uint8_t distance);
+
+#endif // NRF_SOC_H__
@@ -0,0 +1,18 @@
+/* Stand-in for the header of the same name: the foreground scheduler and the shutdown priorities. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#include "sdk_errors.h"
+
+#define SHUTDOWN_PRIORITY_EARLY     0
+#define SHUTDOWN_PRIORITY_DEFAULT   1
+#define SHUTDOWN_PRIORITY_LATE      2
+
+typedef struct __app_isched_struct { int unused; } app_isched_t;
+typedef void (*app_isched_event_handler_t)(void *p_context);
+
+extern app_isched_t g_fg_scheduler;
+
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context);
+
+#endif /* __RESOURCES_H__ */
@@ -0,0 +1,19 @@
+/* Battery measurement configuration used by the test, with power management. The measurement interval, the battery
+ * and the load currents come from the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_BATT_MEAS_ENABLED                1
+#define CONFIG_BATT_MEAS_MODULE_LOG_LEVEL       0
+
+#define CONFIG_PWR_MGMT_ENABLED                 1
+#define CONFIG_HID_HIGH_RES_ENABLED             0
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,553 @@
+/**@file
+ *
+ * @brief Simulated discharge through the battery measurement module.
+ *
+ * @details The test includes m_batt_meas.c. SWI1 is dispatched like in main.c: the entries raised by the foreground
+ *          scheduler run the scheduler, the other ones are radio notifications. The radio notification is checked
+ *          first: it is enabled only while a measurement is pending, and the measurement is sampled at the end of the
+ *          next radio event, or by the timeout if the radio is idle. A scheduler event raised in the middle of a radio
+ *          event must not take the sample.
+ *
+ *          Then a discharge of two alkaline cells is replayed until they are empty. The remote is connected
+ *          40 minutes an hour and streams audio, runs the gyroscope and lights the LEDs at random. The battery
+ *          has an internal resistance which grows as it discharges, so the loads and the radio make the voltage sag.
+ *          The battery level notified by the module is compared with the true state of charge, and with a linear
+ *          map of a single sample taken every minute at a random time, as it was done before the estimation.
+ *
+ *          Last, the shutdown must drop a pending measurement.
+ */
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "m_batt_meas.c"
+
+#define TIMERS              2
+#define ISCHED_QUEUE_SIZE   4
+#define COUNTER_MASK        0xFFFFFF
+#define STEP                APP_TIMER_TICKS(250)    /**< Simulation step [ticks]. */
+#define TICKS_PER_S         APP_TIMER_TICKS(1000)
+#define DISCHARGE_HOURS     900                     /**< Longest simulated discharge [h]. */
+#define NOISE               3.0                     /**< Standard deviation of the sampled voltage [mV]. */
+
+typedef struct
+{
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t            mode;
+    uint32_t                    period;
+    uint64_t                    due;
+    bool                        active;
+} test_timer_t;
+
+app_isched_t                                g_fg_scheduler;
+
+static uint64_t                             s_now;
+static test_timer_t                              s_timers[TIMERS];
+static unsigned int                         s_timers_num;
+static app_isched_event_handler_t           s_isched_handlers[ISCHED_QUEUE_SIZE];
+static void                               * s_isched_contexts[ISCHED_QUEUE_SIZE];
+static unsigned int                         s_isched_num;
+static bool                                 s_swi1_pending;
+static bool                                 s_fg_scheduler_pending;
+static nrf_drv_saadc_event_handler_t        s_saadc_handler;
+static nrf_saadc_value_t                  * s_saadc_buffer;
+static unsigned int                         s_samples;
+static unsigned int                         s_radio_cfg_calls;
+static uint8_t                              s_radio_cfg_type;
+static unsigned int                         s_radio_notifications;
+
+// Battery and loads.
+static double                               s_soc;          /**< True state of charge. */
+static bool                                 s_audio;
+static bool                                 s_gyro;
+static bool                                 s_led;
+static bool                                 s_in_radio;     /**< The radio is transmitting. */
+
+// Battery level notifications.
+static unsigned int                         s_notifications;
+static unsigned int                         s_upward;
+static int                                  s_level = -1;
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(s_now & COUNTER_MASK);
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & COUNTER_MASK;
+}
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(s_timers_num < TIMERS);
+
+    s_timers[s_timers_num].handler = timeout_handler;
+    s_timers[s_timers_num].mode    = mode;
+    *p_timer_id = &s_timers[s_timers_num++];
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    test_timer_t *p_timer = timer_id;
+
+    p_timer->period = timeout_ticks;
+    p_timer->due    = s_now + timeout_ticks;
+    p_timer->active = true;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    ((test_timer_t *)timer_id)->active = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context)
+{
+    TEST_CHECK(s_isched_num < ISCHED_QUEUE_SIZE);
+
+    s_isched_handlers[s_isched_num] = handler;
+    s_isched_contexts[s_isched_num] = p_context;
+    s_isched_num++;
+
+    // Post-put hook of main.c.
+    s_fg_scheduler_pending = true;
+    s_swi1_pending         = true;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_radio_notification_cfg_set(uint8_t type, uint8_t distance)
+{
+    s_radio_cfg_calls++;
+    s_radio_cfg_type = type;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_init(void const *p_config, nrf_drv_saadc_event_handler_t event_handler)
+{
+    s_saadc_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_saadc_uninit(void)
+{
+    s_saadc_handler = NULL;
+}
+
+ret_code_t nrf_drv_saadc_channel_init(uint8_t channel, nrf_saadc_channel_config_t const *p_config)
+{
+    TEST_CHECK(p_config->burst == NRF_SAADC_BURST_ENABLED);
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_channel_uninit(uint8_t channel)
+{
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_buffer_convert(nrf_saadc_value_t *p_buffer, uint16_t size)
+{
+    s_saadc_buffer = p_buffer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_calibrate_offset(void)
+{
+    nrf_drv_saadc_evt_t event = { .type = NRF_DRV_SAADC_EVT_CALIBRATEDONE };
+
+    s_saadc_handler(&event);
+    return NRF_SUCCESS;
+}
+
+ret_code_t event_send(event_type_t event_type, ...)
+{
+    va_list args;
+    int     level;
+
+    TEST_CHECK(event_type == EVT_SYSTEM_BATTERY_LEVEL);
+
+    va_start(args, event_type);
+    level = va_arg(args, int);
+    va_end(args);
+
+    if ((s_level >= 0) && (level > s_level))
+    {
+        s_upward++;
+    }
+
+    s_level = level;
+    s_notifications++;
+
+    return NRF_SUCCESS;
+}
+
+static double uniform(void)
+{
+    return rand() / (RAND_MAX + 1.0);
+}
+
+static double gaussian(void)
+{
+    return sqrt(-2.0 * log(1.0 - uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+/**@brief Open circuit voltage of the battery [mV]. Slightly off the discharge curve of the module. */
+static double battery_ocv(double soc)
+{
+    static const double curve[] = { 0, 0.318, 0.425, 0.510, 0.575, 0.635, 0.690, 0.750, 0.812, 0.890, 1.0 };
+    double              x       = 10.0 * soc;
+    unsigned int        i       = (unsigned int)x;
+
+    if (i >= 10)
+    {
+        return CONFIG_BATT_MEAS_MAX_LEVEL;
+    }
+
+    return CONFIG_BATT_MEAS_MIN_LEVEL + (CONFIG_BATT_MEAS_MAX_LEVEL - CONFIG_BATT_MEAS_MIN_LEVEL) *
+                                        (curve[i] + (x - i) * (curve[i + 1] - curve[i]));
+}
+
+/**@brief Battery voltage under the present load [mV]. */
+static double battery_voltage(void)
+{
+    double resistance = 0.4 + 0.9 * (1.0 - s_soc);     // [Ohm]
+    double current    = 0.05 +                          // [mA]
+                        (s_audio    ? 2.5 : 0.0) +
+                        (s_gyro     ? 3.7 : 0.0) +
+                        (s_led      ? 2.0 : 0.0) +
+                        (s_in_radio ? 8.0 : 0.0);
+
+    return battery_ocv(s_soc) - current * resistance + NOISE * gaussian();
+}
+
+ret_code_t nrf_drv_saadc_sample(void)
+{
+    nrf_drv_saadc_evt_t event = { .type = NRF_DRV_SAADC_EVT_DONE };
+
+    TEST_CHECK(s_saadc_buffer != NULL);
+    TEST_CHECK(!s_in_radio);
+
+    *s_saadc_buffer = (nrf_saadc_value_t)(battery_voltage() * ADC_MAX_CONV / (ADC_DIVIDER * ADC_REFERENCE));
+    s_samples++;
+
+    event.data.done.p_buffer = s_saadc_buffer;
+    event.data.done.size     = 1;
+    s_saadc_buffer           = NULL;
+    s_saadc_handler(&event);
+
+    return NRF_SUCCESS;
+}
+
+static void isched_execute(void)
+{
+    while (s_isched_num > 0)
+    {
+        app_isched_event_handler_t handler   = s_isched_handlers[0];
+        void                     * p_context = s_isched_contexts[0];
+
+        s_isched_num--;
+        memmove(&s_isched_handlers[0], &s_isched_handlers[1], s_isched_num * sizeof(s_isched_handlers[0]));
+        memmove(&s_isched_contexts[0], &s_isched_contexts[1], s_isched_num * sizeof(s_isched_contexts[0]));
+        handler(p_context);
+    }
+}
+
+/**@brief Run SWI1 while it is pending, dispatched like SWI1_EGU1_IRQHandler() in main.c. */
+static void swi1_run(void)
+{
+    while (s_swi1_pending)
+    {
+        s_swi1_pending = false;
+
+        if (s_fg_scheduler_pending)
+        {
+            s_fg_scheduler_pending = false;
+            isched_execute();
+        }
+        else
+        {
+            m_batt_meas_radio_evt_handler();
+        }
+    }
+}
+
+/**@brief Advance the clock, running the timers on the way. */
+static void run_for(uint64_t ticks)
+{
+    uint64_t end = s_now + ticks;
+
+    for (;;)
+    {
+        test_timer_t *p_next = NULL;
+
+        for (unsigned int i = 0; i < s_timers_num; i++)
+        {
+            if (s_timers[i].active && (s_timers[i].due <= end) && ((p_next == NULL) || (s_timers[i].due < p_next->due)))
+            {
+                p_next = &s_timers[i];
+            }
+        }
+
+        if (p_next == NULL)
+        {
+            break;
+        }
+
+        s_now = p_next->due;
+        if (p_next->mode == APP_TIMER_MODE_REPEATED)
+        {
+            p_next->due += p_next->period;
+        }
+        else
+        {
+            p_next->active = false;
+        }
+
+        p_next->handler(NULL);
+        swi1_run();
+    }
+
+    s_now = end;
+}
+
+/**@brief End of a radio event. The SoftDevice raises SWI1 if the notification is enabled. */
+static void radio_event_end(void)
+{
+    s_in_radio = false;
+
+    if (s_radio_cfg_type == NRF_RADIO_NOTIFICATION_TYPE_INT_ON_INACTIVE)
+    {
+        s_radio_notifications++;
+        s_swi1_pending = true;
+        swi1_run();
+    }
+}
+
+static void dummy_event_handler(void *p_context)
+{
+}
+
+static void load_update(bool *p_state, m_batt_meas_load_t load, bool active)
+{
+    if (*p_state != active)
+    {
+        *p_state = active;
+        m_batt_meas_load_set(load, active);
+    }
+}
+
+/**@brief Measurements are sampled at the end of a radio event, or by the timeout. */
+static void test_radio_sync(void)
+{
+    unsigned int samples;
+
+    s_soc = 1.0;
+    TEST_CHECK(m_batt_meas_init() == NRF_SUCCESS);
+
+    // The first measurement starts after the calibration and waits for a radio event, in the middle of which a
+    // scheduler event comes.
+    s_in_radio = true;
+    swi1_run();
+    TEST_CHECK(m_batt_meas_sample_pending);
+    TEST_CHECK(s_radio_cfg_type == NRF_RADIO_NOTIFICATION_TYPE_INT_ON_INACTIVE);
+
+    TEST_CHECK(app_isched_event_put(&g_fg_scheduler, dummy_event_handler, NULL) == NRF_SUCCESS);
+    swi1_run();
+    TEST_CHECK(m_batt_meas_sample_pending);
+    TEST_CHECK(s_samples == 0);
+
+    radio_event_end();
+    swi1_run();
+    TEST_CHECK(s_samples == 1);
+    TEST_CHECK(!m_batt_meas_sample_pending);
+    TEST_CHECK(s_notifications == 1);
+    TEST_CHECK(s_radio_cfg_type == NRF_RADIO_NOTIFICATION_TYPE_NONE);
+
+    // Nothing pending: the notification is disabled.
+    radio_event_end();
+    radio_event_end();
+    TEST_CHECK(s_samples == 1);
+    TEST_CHECK(s_radio_notifications == 1);
+
+    // No radio event: the timeout samples.
+    samples = s_samples;
+    run_for(APP_TIMER_TICKS(1000u * CONFIG_BATT_MEAS_POLL_INTERVAL + BATT_MEAS_SYNC_TIMEOUT));
+    TEST_CHECK(s_samples == samples + 1);
+    TEST_CHECK(!m_batt_meas_sample_pending);
+    TEST_CHECK(s_radio_cfg_type == NRF_RADIO_NOTIFICATION_TYPE_NONE);
+
+    printf("radio sync: %u samples, %u radio notifications, %u radio notification configuration calls\n",
+           s_samples, s_radio_notifications, s_radio_cfg_calls);
+}
+
+/**@brief Discharge until empty. */
+static void test_discharge(void)
+{
+    uint64_t     start          = s_now;
+    uint64_t     end            = start + (uint64_t)DISCHARGE_HOURS * 3600 * TICKS_PER_S;
+    uint64_t     half_time      = 0;
+    uint32_t     half_estimate  = 0;
+    double       stream_end     = 0.0;
+    double       gyro_end       = 0.0;
+    double       led_end        = 0.0;
+    double       zero_soc       = -1.0;
+    double       error          = 0.0;
+    double       linear_error   = 0.0;
+    unsigned int linear_notifications = 0;
+    unsigned int linear_upward  = 0;
+    int          linear_level   = -1;
+    unsigned int errors_num     = 0;
+    unsigned int radio_events   = 0;
+    unsigned int notifications  = s_radio_notifications;
+    unsigned int samples        = s_samples;
+    uint32_t     hours;
+
+    srand(1);
+
+    while ((s_now < end) && (s_soc > 0.0))
+    {
+        double t         = (double)(s_now - start) / TICKS_PER_S;
+        bool   connected = fmod(t, 3600.0) < 2400.0;
+        double current;
+
+        if (connected && !s_audio && (uniform() < 0.25 / 3600 * 4))
+        {
+            load_update(&s_audio, M_BATT_MEAS_LOAD_AUDIO, true);
+            stream_end = t + 10.0 + 40.0 * uniform();
+        }
+        else if (s_audio && (t > stream_end))
+        {
+            load_update(&s_audio, M_BATT_MEAS_LOAD_AUDIO, false);
+        }
+
+        if (connected && !s_gyro && (uniform() < 1.0 / 3600 * 4))
+        {
+            load_update(&s_gyro, M_BATT_MEAS_LOAD_GYRO, true);
+            gyro_end = t + 60.0 + 300.0 * uniform();
+        }
+        else if (s_gyro && (t > gyro_end))
+        {
+            load_update(&s_gyro, M_BATT_MEAS_LOAD_GYRO, false);
+        }
+
+        if (!s_led && (uniform() < 2.0 / 3600 * 4))
+        {
+            load_update(&s_led, M_BATT_MEAS_LOAD_LED, true);
+            led_end = t + 1.0 + 5.0 * uniform();
+        }
+        else if (s_led && (t > led_end))
+        {
+            load_update(&s_led, M_BATT_MEAS_LOAD_LED, false);
+        }
+
+        // Audio streaming keeps the radio busy as well.
+        current = 0.05 + (s_audio ? 4.0 : 0.0) + (s_gyro ? 3.7 : 0.0) + (s_led ? 2.0 : 0.0) + (connected ? 0.03 : 0.0);
+        s_soc   = MAX(s_soc - current * 0.25 / 3600 / CONFIG_BATT_MEAS_CAPACITY, 0.0);
+
+        if ((half_time == 0) && (s_soc < 0.5))
+        {
+            half_time = s_now;
+            TEST_CHECK(m_batt_meas_remaining_time_get(&half_estimate) == NRF_SUCCESS);
+        }
+
+        run_for(STEP);
+
+        if (connected)
+        {
+            radio_events++;
+            radio_event_end();
+        }
+
+        // Linear map of a sample taken at a random time, every minute.
+        if (((s_now - start) % (60 * TICKS_PER_S)) == 0)
+        {
+            int truth = (int)(100.0 * s_soc + 0.5);
+            int level;
+            double voltage;
+
+            s_in_radio = connected && (uniform() < (s_audio ? 0.3 : 0.02));
+            voltage    = battery_voltage();
+            s_in_radio = false;
+
+            level = (voltage >= CONFIG_BATT_MEAS_MAX_LEVEL) ? 100 :
+                    (voltage <= CONFIG_BATT_MEAS_MIN_LEVEL) ? 0 :
+                    (int)(100 * (voltage - CONFIG_BATT_MEAS_MIN_LEVEL) /
+                          (CONFIG_BATT_MEAS_MAX_LEVEL - CONFIG_BATT_MEAS_MIN_LEVEL));
+
+            if ((linear_level < 0) || (abs(level - linear_level) >= CONFIG_BATT_NOTIFICATION_THRESHOLD) || (level == 0))
+            {
+                linear_upward += ((linear_level >= 0) && (level > linear_level)) ? 1 : 0;
+                linear_notifications++;
+                linear_level = level;
+            }
+
+            if ((s_level == 0) && (zero_soc < 0.0))
+            {
+                zero_soc = s_soc;
+            }
+
+            error        += abs(s_level - truth);
+            linear_error += abs(linear_level - truth);
+            errors_num++;
+        }
+    }
+
+    TEST_CHECK(m_batt_meas_remaining_time_get(&hours) == NRF_SUCCESS);
+
+    notifications = s_radio_notifications - notifications;
+    samples       = s_samples - samples;
+
+    printf("discharge: %.0f h, %u radio events, %u radio notifications, %u samples\n",
+           (double)(s_now - start) / TICKS_PER_S / 3600, radio_events, notifications, samples);
+    printf("at 50%%: %u h estimated, %.0f h left; level 0 first notified at %.1f%%\n",
+           half_estimate, (double)(s_now - half_time) / TICKS_PER_S / 3600, 100.0 * zero_soc);
+    printf("linear map: %5u notifications, %5u upward, mean error %5.2f points\n",
+           linear_notifications, linear_upward, linear_error / errors_num);
+    printf("estimation: %5u notifications, %5u upward, mean error %5.2f points\n",
+           s_notifications, s_upward, error / errors_num);
+
+    TEST_CHECK(s_soc == 0.0);
+    TEST_CHECK(notifications <= samples);
+    TEST_CHECK(s_notifications < linear_notifications / 4);
+    TEST_CHECK(s_upward < linear_upward / 4);
+    TEST_CHECK(error / errors_num < 1.0);
+    TEST_CHECK(fabs(half_estimate - (double)(s_now - half_time) / TICKS_PER_S / 3600) < 0.1 * half_estimate);
+    TEST_CHECK((zero_soc >= 0.0) && (zero_soc < 0.01));
+}
+
+/**@brief The shutdown drops a pending measurement. */
+static void test_shutdown(void)
+{
+    unsigned int samples = s_samples;
+
+    // Up to the start of the next measurement.
+    run_for(((test_timer_t *)m_batt_timer)->due - s_now);
+    TEST_CHECK(m_batt_meas_sample_pending);
+
+    TEST_CHECK(m_batt_meas_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    radio_event_end();
+    run_for(APP_TIMER_TICKS(10000u * CONFIG_BATT_MEAS_POLL_INTERVAL));
+
+    TEST_CHECK(s_samples == samples);
+    TEST_CHECK(s_radio_cfg_type == NRF_RADIO_NOTIFICATION_TYPE_NONE);
+}
+
+int main(void)
+{
+    test_radio_sync();
+    test_discharge();
+    test_shutdown();
+
+    return TEST_RESULT();
+}
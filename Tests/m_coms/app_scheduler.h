@@ -0,0 +1,11 @@
+/* Stand-in for the header of the same name. */
+#ifndef APP_SCHEDULER_H__
+#define APP_SCHEDULER_H__
+
+#include <stdint.h>
+
+#include "nrf_balloc.h"
+
+typedef void (*app_sched_event_handler_t)(void *p_event_data, uint16_t event_size);
+
+#endif // APP_SCHEDULER_H__
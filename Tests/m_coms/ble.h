@@ -0,0 +1,21 @@
+/* Stand-in for the SoftDevice header of the same name: the definitions used by the communication module. */
+#ifndef BLE_H__
+#define BLE_H__
+
+#include <stdint.h>
+
+#define BLE_CONN_HANDLE_INVALID                 0xFFFF
+#define BLE_ERROR_GATTS_SYS_ATTR_MISSING        0x3401
+#define BLE_GATT_ATT_MTU_DEFAULT                23
+#define BLE_GAP_IO_CAPS_NONE                    0x03
+#define BLE_APPEARANCE_GENERIC_REMOTE_CONTROL   384
+
+typedef struct
+{
+    uint16_t min_conn_interval;
+    uint16_t max_conn_interval;
+    uint16_t slave_latency;
+    uint16_t conn_sup_timeout;
+} ble_gap_conn_params_t;
+
+#endif // BLE_H__
@@ -0,0 +1,12 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef BLE_ADVDATA_H__
+#define BLE_ADVDATA_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint8_t tk[16];
+} ble_advdata_tk_value_t;
+
+#endif // BLE_ADVDATA_H__
@@ -0,0 +1,7 @@
+/* Stand-in for the SoftDevice header of the same name. */
+#ifndef BLE_GATTS_H__
+#define BLE_GATTS_H__
+
+#include "ble.h"
+
+#endif // BLE_GATTS_H__
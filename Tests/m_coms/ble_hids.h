@@ -0,0 +1,28 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef BLE_HIDS_H__
+#define BLE_HIDS_H__
+
+#include <stdint.h>
+
+#include "ble.h"
+
+#define BLE_HIDS_REP_TYPE_INPUT                 1
+#define BLE_HIDS_REP_TYPE_OUTPUT                2
+#define BLE_HIDS_REP_TYPE_FEATURE               3
+
+#define HID_INFO_FLAG_REMOTE_WAKE_MSK           0x01
+#define HID_INFO_FLAG_NORMALLY_CONNECTABLE_MSK  0x02
+
+typedef struct
+{
+    uint16_t conn_handle;
+} ble_hids_t;
+
+typedef struct
+{
+    uint8_t evt_type;
+} ble_hids_evt_t;
+
+typedef void (*ble_srv_error_handler_t)(uint32_t nrf_error);
+
+#endif // BLE_HIDS_H__
@@ -0,0 +1,7 @@
+/* Stand-in for the SoftDevice header of the same name. */
+#ifndef BLE_TYPES_H__
+#define BLE_TYPES_H__
+
+#include "ble.h"
+
+#endif // BLE_TYPES_H__
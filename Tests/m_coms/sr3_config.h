@@ -0,0 +1,74 @@
+/* Communication module configuration used by the test: keys and mouse reports, no power management. HID audio
+ * with packing is enabled by the Makefile for the packing test. Pool and queue sizes come from the board
+ * configuration. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#ifndef CONFIG_AUDIO_ENABLED
+#define CONFIG_AUDIO_ENABLED                0
+#endif
+#ifndef CONFIG_AUDIO_HID_ENABLED
+#define CONFIG_AUDIO_HID_ENABLED            0
+#endif
+#define CONFIG_AUDIO_ATVV_ENABLED           0
+#ifndef CONFIG_AUDIO_HID_PACKING_ENABLED
+#define CONFIG_AUDIO_HID_PACKING_ENABLED    0
+#endif
+#define CONFIG_AUDIO_CODEC_ADPCM            1
+#define CONFIG_AUDIO_CODEC_OPUS             3
+#ifndef CONFIG_AUDIO_CODEC
+#define CONFIG_AUDIO_CODEC                  CONFIG_AUDIO_CODEC_ADPCM
+#endif
+#define CONFIG_AUDIO_SAMPLING_FREQUENCY     16000
+#define CONFIG_AUDIO_FRAME_SIZE_SAMPLES     128
+#ifndef CONFIG_AUDIO_FRAME_SIZE_BYTES
+#define CONFIG_AUDIO_FRAME_SIZE_BYTES       68
+#endif
+#define CONFIG_AUDIO_FRAME_HEADROOM         0
+
+#define CONFIG_PWR_MGMT_ENABLED             0
+#define CONFIG_BATT_MEAS_ENABLED            0
+#define CONFIG_CONN_POLICY_ENABLED          0
+#define CONFIG_NFC_ENABLED                  0
+#define CONFIG_NFC_PAIRING_TAG              0
+#define CONFIG_SEC_LEGACY_PAIRING           0
+#define CONFIG_BLE_MODULE_LOG_LEVEL         0
+
+#define CONFIG_DEVICE_NAME                  "Smart Remote 3"
+#define CONFIG_MANUFACTURER_NAME            "Nordic Semiconductor"
+#define CONFIG_FIRMWARE_REVISION            "test"
+#define CONFIG_HARDWARE_REVISION            "test"
+#define CONFIG_SERIAL_NUMBER                "0"
+#define CONFIG_PNP_PRODUCT_ID               0
+#define CONFIG_PNP_PRODUCT_VERSION          0
+#define CONFIG_PNP_VENDOR_ID                0
+#define CONFIG_PNP_VENDOR_ID_SOURCE         0
+#define CONFIG_HID_VERSION                  0x0101
+#define CONFIG_HID_COUNTRY_CODE             0
+#define CONFIG_ADV_INTERVAL                 32
+#define CONFIG_ADV_TIMEOUT                  180
+#define CONFIG_ADV_DIRECTED                 0
+#define CONFIG_CHANGE_ADDRESS               0
+#define CONFIG_BOND_RECONNECT_ALL           0
+#define CONFIG_RECONNECT_ALL                0
+#define CONFIG_MIN_CONN_INTERVAL_MS         7
+#define CONFIG_MIN_CONN_INTERVAL            ROUNDED_DIV(100u * CONFIG_MIN_CONN_INTERVAL_MS, 125)
+#define CONFIG_MAX_CONN_INTERVAL_MS         7
+#define CONFIG_MAX_CONN_INTERVAL            ROUNDED_DIV(100u * CONFIG_MAX_CONN_INTERVAL_MS, 125)
+#define CONFIG_SLAVE_LATENCY                99
+#define CONFIG_CONN_SUP_TIMEOUT_MS          3000
+#define CONFIG_CONN_SUP_TIMEOUT             ROUNDED_DIV(CONFIG_CONN_SUP_TIMEOUT_MS, 10)
+#define CONFIG_MAX_BONDS                    1
+
+#ifndef CONFIG_HID_HIGH_RES_ENABLED
+#define CONFIG_HID_HIGH_RES_ENABLED         0
+#endif
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
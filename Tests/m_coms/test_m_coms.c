@@ -0,0 +1,935 @@
+/**@file
+ *
+ * @brief Test of the HID report queueing in the communication module.
+ *
+ * @details The test includes m_coms.c, so it can reach the module state. The BLE layer is replaced by a link
+ *          model: m_coms_ble_hid_report_send() records the report while the SoftDevice has a free buffer, and the
+ *          test completes transmissions at random, in bursts, to let the keys channel fill up. The HID state is
+ *          a sorted list of the active usages, like the one kept by m_protocol_hid_state.c.
+ *
+ *          The report layout test walks m_coms_hid_desc and checks the size, offset, kind and usage page of
+ *          every input report field against m_coms_report_layouts. It then packs random field values with
+ *          m_coms_report_pack() and reads them back at the offsets found in the descriptor.
+ *
+ *          The coalescing fuzz test presses and releases random keys, consumer controls and mouse buttons.
+ *          Every state change is also rendered into a reference report, as it would be sent without any
+ *          queueing. For every usage, the sequence of reports in which it is visible must match the reference
+ *          in every run which never found the keys channel full. All pools must be free after every run.
+ *
+ *          All usages must end up released. Without coalescing, this holds only if the keys channel never
+ *          fills up: a full channel drops its oldest report, which may be the last report of another report ID.
+ *
+ *          With HID audio packing, the test streams frames of random sizes, including the sizes around the
+ *          7-bit chunk length, at the default and at the largest MTU. Every audio report is parsed back into
+ *          frames as a host would: a chunk header holds the length and the "more" flag, and a zero header ends
+ *          a report which is not full. The frames must come out unchanged and in order, and every frame must be
+ *          released.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "m_coms.c"
+
+#define FUZZ_RUNS           2000
+#define FUZZ_EVENTS         40      /**< State changes per run. */
+#define STATE_SIZE          32      /**< Maximum number of active usages. */
+#define LOG_SIZE            1024    /**< Maximum number of reports per run. */
+#define LAYOUT_ROUNDS       100000  /**< Random field sets packed for each report. */
+
+/**@brief A queued report, as sent over the link or rendered for reference. */
+typedef struct
+{
+    uint8_t report_idx;
+    uint8_t data[HID_MAX_QUEUED_REPORT_SIZE];
+} report_t;
+
+/**@brief Usages toggled by the fuzz test. Each array report gets more usages than it has fields. */
+static const uint32_t s_usages[] =
+{
+    HID_USAGE(0x07, 0x04), HID_USAGE(0x07, 0x05), HID_USAGE(0x07, 0x06), HID_USAGE(0x07, 0x07),
+    HID_USAGE(0x07, 0x08),
+    HID_USAGE(0x0C, 0xE9), HID_USAGE(0x0C, 0xEA), HID_USAGE(0x0C, 0xCD),
+    HID_USAGE(0x09, 0x01), HID_USAGE(0x09, 0x02), HID_USAGE(0x09, 0x03),
+};
+
+static m_protocol_hid_state_item_t s_state[STATE_SIZE];
+static size_t   s_state_size;
+
+static report_t s_sent[LOG_SIZE];
+static size_t   s_sent_count;
+static report_t s_reference[LOG_SIZE];
+static size_t   s_reference_count;
+
+static unsigned s_sd_buffers;       /**< Free SoftDevice buffers. */
+static unsigned s_sd_queued;        /**< Reports waiting for the transmission to complete. */
+
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+#define AUDIO_FRAMES        2000    /**< Frames per stream. */
+#define AUDIO_LOG_SIZE      (AUDIO_FRAMES * CONFIG_AUDIO_FRAME_SIZE_BYTES)
+
+/**@brief Audio frames, as sent to the module or as parsed from the reports. */
+typedef struct
+{
+    uint8_t     data[AUDIO_LOG_SIZE];
+    uint16_t    sizes[AUDIO_FRAMES];
+    size_t      count;
+    size_t      size;
+} audio_log_t;
+
+static m_audio_frame_t  s_audio_frames[CONFIG_AUDIO_FRAME_POOL_SIZE];
+static audio_log_t      s_audio_sent;
+static audio_log_t      s_audio_received;
+static size_t           s_audio_frame_size;     /**< Size of the frame being parsed so far. */
+static uint16_t         s_audio_max_report;     /**< Largest report allowed by the MTU. */
+static unsigned         s_audio_reports;
+static unsigned         s_audio_terminated;     /**< Reports ended by a zero header. */
+static unsigned         s_audio_long_chunks;    /**< Chunks of the largest length the header can hold. */
+static unsigned         s_audio_split_frames;   /**< Frames continued in the next report. */
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
+
+// ----------------------------------------------------------------------------
+// HID state
+// ----------------------------------------------------------------------------
+
+m_protocol_hid_state_item_t *m_protocol_hid_state_get(uint32_t usage)
+{
+    size_t i;
+
+    for (i = 0; i < s_state_size; i++)
+    {
+        if (s_state[i].usage == usage)
+        {
+            return &s_state[i];
+        }
+    }
+
+    return NULL;
+}
+
+m_protocol_hid_state_item_t const *m_protocol_hid_state_page_it_init(uint16_t page)
+{
+    size_t i;
+
+    for (i = 0; i < s_state_size; i++)
+    {
+        if (HID_USAGE_PAGE(s_state[i].usage) == page)
+        {
+            return &s_state[i];
+        }
+    }
+
+    return NULL;
+}
+
+m_protocol_hid_state_item_t const *m_protocol_hid_state_page_it_next(m_protocol_hid_state_item_t const *p_item)
+{
+    return (++p_item < &s_state[s_state_size]) ? p_item : NULL;
+}
+
+/**@brief Press or release a usage, keeping the list sorted. */
+static void state_set(uint32_t usage, bool active)
+{
+    size_t i;
+
+    for (i = 0; (i < s_state_size) && (s_state[i].usage < usage); i++)
+    {
+    }
+
+    if (active)
+    {
+        TEST_CHECK((i == s_state_size) || (s_state[i].usage != usage));
+        TEST_CHECK(s_state_size < ARRAY_SIZE(s_state));
+        memmove(&s_state[i + 1], &s_state[i], (s_state_size - i) * sizeof(s_state[0]));
+        s_state[i].usage = usage;
+        s_state[i].value = 1;
+        s_state_size    += 1;
+    }
+    else
+    {
+        TEST_CHECK((i < s_state_size) && (s_state[i].usage == usage));
+        memmove(&s_state[i], &s_state[i + 1], (s_state_size - i - 1) * sizeof(s_state[0]));
+        s_state_size    -= 1;
+    }
+}
+
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+// ----------------------------------------------------------------------------
+// Audio frames
+// ----------------------------------------------------------------------------
+
+m_audio_frame_t *m_audio_frame_get(m_audio_frame_t *p_frame)
+{
+    p_frame->reference_count += 1;
+    return p_frame;
+}
+
+void m_audio_frame_put(m_audio_frame_t *p_frame)
+{
+    TEST_CHECK(p_frame->reference_count > 0);
+    p_frame->reference_count -= 1;
+}
+
+/**@brief Parse the chunks of an audio report into frames, as a host would. */
+static void audio_report_parse(uint8_t const *p_data, uint8_t len)
+{
+    audio_log_t *p_log = &s_audio_received;
+    size_t       offset = 0;
+
+    TEST_CHECK((len > 0) && (len <= s_audio_max_report));
+    s_audio_reports += 1;
+
+    while (offset < len)
+    {
+        uint8_t header = p_data[offset++];
+        uint8_t chunk  = header & AUDIO_HID_CHUNK_LEN_MASK;
+
+        if (header == 0)
+        {
+            // The terminator is the last byte of the report.
+            TEST_CHECK(offset == len);
+            s_audio_terminated += 1;
+            break;
+        }
+
+        TEST_CHECK(chunk > 0);
+        TEST_CHECK(offset + chunk <= len);
+        TEST_CHECK(p_log->size + chunk <= sizeof(p_log->data));
+        if ((offset + chunk > len) || (p_log->size + chunk > sizeof(p_log->data)))
+        {
+            return;
+        }
+
+        memcpy(&p_log->data[p_log->size], &p_data[offset], chunk);
+        p_log->size        += chunk;
+        s_audio_frame_size += chunk;
+        offset             += chunk;
+
+        if (chunk == AUDIO_HID_CHUNK_LEN_MASK)
+        {
+            s_audio_long_chunks += 1;
+        }
+
+        if ((header & AUDIO_HID_CHUNK_MORE_FLAG) == 0)
+        {
+            TEST_CHECK(p_log->count < ARRAY_SIZE(p_log->sizes));
+            if (p_log->count < ARRAY_SIZE(p_log->sizes))
+            {
+                p_log->sizes[p_log->count++] = (uint16_t)s_audio_frame_size;
+            }
+            s_audio_frame_size = 0;
+        }
+        else if (offset == len)
+        {
+            s_audio_split_frames += 1;
+        }
+    }
+}
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
+
+// ----------------------------------------------------------------------------
+// BLE layer
+// ----------------------------------------------------------------------------
+
+ret_code_t m_coms_ble_init(const m_coms_ble_params_t *p_ble_params,
+                           const struct ble_hid_db_s *p_hid_db,
+                           bool delete_bonds)
+{
+    return NRF_SUCCESS;
+}
+
+ret_code_t m_coms_ble_hid_report_send(uint8_t *p_data, uint8_t len, uint8_t interface_idx, uint8_t report_idx)
+{
+    if (s_sd_buffers == 0)
+    {
+        return NRF_ERROR_RESOURCES;
+    }
+
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+    if (report_idx == HID_REPORT_IDX(AUDIO_IN))
+    {
+        audio_report_parse(p_data, len);
+
+        s_sd_buffers -= 1;
+        s_sd_queued  += 1;
+
+        return NRF_SUCCESS;
+    }
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
+
+    TEST_CHECK(len <= HID_MAX_QUEUED_REPORT_SIZE);
+    TEST_CHECK(s_sent_count < ARRAY_SIZE(s_sent));
+    if (s_sent_count < ARRAY_SIZE(s_sent))
+    {
+        s_sent[s_sent_count].report_idx = report_idx;
+        memcpy(s_sent[s_sent_count].data, p_data, len);
+        s_sent_count += 1;
+    }
+
+    s_sd_buffers -= 1;
+    s_sd_queued  += 1;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t event_send(event_type_t event_type, ...)
+{
+    return NRF_SUCCESS;
+}
+
+/**@brief Complete the transmission of a number of queued reports. */
+static void link_complete(unsigned count)
+{
+    m_coms_ble_evt_t evt;
+
+    count = MIN(count, s_sd_queued);
+    if (count == 0)
+    {
+        return;
+    }
+
+    s_sd_queued  -= count;
+    s_sd_buffers += count;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.type                    = M_COMS_BLE_EVT_TX_COMPLETE;
+    evt.data.tx_complete.count  = count;
+    m_coms_ble_evt_handler(&evt, sizeof(evt));
+}
+
+/**@brief Initialize the module and bring it to the state of a secured connection. */
+static void link_open(void)
+{
+    TEST_CHECK(m_coms_init(false) == NRF_SUCCESS);
+
+    m_coms_state  = M_COMS_STATE_SECURED;
+    s_sd_buffers  = CONFIG_GATTS_CONN_HVN_TX_QUEUE_SIZE;
+    s_sd_queued   = 0;
+    s_sent_count  = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Reports
+// ----------------------------------------------------------------------------
+
+/**@brief Get a field of a report, packed LSB first. */
+static uint16_t report_field_get(uint8_t const *p_data, unsigned field_size, unsigned field)
+{
+    unsigned offset = field * field_size;
+    uint32_t window = 0;
+    unsigned i;
+
+    for (i = 0; i < ((offset % 8) + field_size + 7) / 8; i++)
+    {
+        window |= (uint32_t)p_data[(offset / 8) + i] << (8 * i);
+    }
+
+    return (window >> (offset % 8)) & ((1u << field_size) - 1);
+}
+
+/**@brief Get the index of the report carrying a given usage. */
+static uint8_t usage_report_idx(uint32_t usage)
+{
+    switch (HID_USAGE_PAGE(usage))
+    {
+        case 0x07:
+            return HID_REPORT_IDX(KEYBOARD_IN);
+
+        case 0x0C:
+            return HID_REPORT_IDX(CONSUMER_CTRL_IN);
+
+        default:
+            return HID_REPORT_IDX(MOUSE_BTN_IN);
+    }
+}
+
+/**@brief Check if a usage is active in a report. */
+static bool usage_visible(report_t const *p_report, uint32_t usage)
+{
+    unsigned i;
+
+    switch (p_report->report_idx)
+    {
+        case HID_REPORT_IDX(KEYBOARD_IN):
+            for (i = 0; i < KEYBOARD_IN_REP_COUNT; i++)
+            {
+                if (report_field_get(p_report->data, KEYBOARD_IN_REP_SIZE, i) == HID_USAGE_ID(usage))
+                {
+                    return true;
+                }
+            }
+            return false;
+
+        case HID_REPORT_IDX(CONSUMER_CTRL_IN):
+            for (i = 0; i < CONSUMER_CTRL_IN_REP_COUNT; i++)
+            {
+                if (report_field_get(p_report->data, CONSUMER_CTRL_IN_REP_SIZE, i) == HID_USAGE_ID(usage))
+                {
+                    return true;
+                }
+            }
+            return false;
+
+        default:
+            return report_field_get(p_report->data, MOUSE_BTN_IN_REP_SIZE, HID_USAGE_ID(usage) - 1) != 0;
+    }
+}
+
+/**@brief Render the current state into a reference report. */
+static void reference_add(uint32_t usage)
+{
+    report_t *p_report = &s_reference[s_reference_count++];
+
+    p_report->report_idx = usage_report_idx(usage);
+    memset(p_report->data, 0, sizeof(p_report->data));
+
+    switch (p_report->report_idx)
+    {
+        case HID_REPORT_IDX(KEYBOARD_IN):
+            UNUSED_RETURN_VALUE(m_coms_create_keyboard_report(p_report->data));
+            break;
+
+        case HID_REPORT_IDX(CONSUMER_CTRL_IN):
+            UNUSED_RETURN_VALUE(m_coms_create_consumer_ctrl_report(p_report->data));
+            break;
+
+        default:
+            UNUSED_RETURN_VALUE(m_coms_create_mouse_btn_report(p_report->data));
+            break;
+    }
+}
+
+/**@brief Get the sequence of visibility changes of a usage in a list of reports.
+ *
+ * @return Number of changes. Odd if the usage is left active.
+ */
+static size_t usage_transitions(report_t const *p_reports, size_t count, uint32_t usage, bool *p_changes)
+{
+    bool   visible = false;
+    size_t changes = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((p_reports[i].report_idx == usage_report_idx(usage)) &&
+            (usage_visible(&p_reports[i], usage) != visible))
+        {
+            visible              = !visible;
+            p_changes[changes++] = visible;
+        }
+    }
+
+    return changes;
+}
+
+/**@brief Toggle a usage and pass the change to the module, as the HID state module does. */
+static void usage_toggle(uint32_t usage, bool *p_channel_full)
+{
+    bool    active = (m_protocol_hid_state_get(usage) == NULL);
+    event_t evt;
+
+    state_set(usage, active);
+    reference_add(usage);
+
+    // A full keys channel forces the module to merge transitions or to drop a report.
+    if ((m_coms_keys_channel.p_current_data_desc != NULL) && nrf_queue_is_full(m_coms_keys_channel.p_backlog))
+    {
+        *p_channel_full = true;
+    }
+
+    evt.type        = EVT_HID_REPORT_INPUT;
+    evt.hid.usage   = usage;
+    evt.hid.report  = active;
+    UNUSED_RETURN_VALUE(m_coms_event_handler(&evt));
+}
+
+// ----------------------------------------------------------------------------
+// Tests
+// ----------------------------------------------------------------------------
+
+/**@brief Press and release random usages while the link is congested at random. */
+static void test_report_fuzz(void)
+{
+    static bool changes_sent[LOG_SIZE];
+    static bool changes_reference[LOG_SIZE];
+    unsigned    clean_runs      = 0;
+    unsigned    lost_runs       = 0;
+    unsigned    stuck_runs      = 0;
+    unsigned    stuck_clean     = 0;
+    unsigned    leaking_runs    = 0;
+    unsigned    sent_total      = 0;
+    unsigned    reference_total = 0;
+    unsigned    run;
+
+    srand(1);
+
+    for (run = 0; run < FUZZ_RUNS; run++)
+    {
+        unsigned congestion   = rand() % 4;
+        bool     channel_full = false;
+        bool     lost         = false;
+        bool     stuck        = false;
+        unsigned event;
+        unsigned i;
+
+        link_open();
+        s_state_size      = 0;
+        s_reference_count = 0;
+
+        for (event = 0; event < FUZZ_EVENTS; event++)
+        {
+            usage_toggle(s_usages[rand() % ARRAY_SIZE(s_usages)], &channel_full);
+
+            // Without congestion, some transmissions complete after most changes. Otherwise the link
+            // stalls for a while and then completes several transmissions at once.
+            if (congestion == 0)
+            {
+                link_complete(rand() % 3);
+            }
+            else if ((rand() % (3 * congestion)) == 0)
+            {
+                link_complete(4);
+            }
+        }
+
+        // Release everything and let the link drain.
+        while (s_state_size > 0)
+        {
+            usage_toggle(s_state[rand() % s_state_size].usage, &channel_full);
+            link_complete(rand() % 2);
+        }
+
+        while (s_sd_queued > 0)
+        {
+            link_complete(s_sd_queued);
+        }
+
+        for (i = 0; i < ARRAY_SIZE(s_usages); i++)
+        {
+            size_t sent_changes      = usage_transitions(s_sent, s_sent_count, s_usages[i], changes_sent);
+            size_t reference_changes = usage_transitions(s_reference, s_reference_count, s_usages[i],
+                                                         changes_reference);
+
+            if ((sent_changes % 2) != 0)
+            {
+                stuck = true;
+            }
+
+            if ((sent_changes != reference_changes) ||
+                (memcmp(changes_sent, changes_reference, sent_changes * sizeof(changes_sent[0])) != 0))
+            {
+                lost = true;
+            }
+        }
+
+        if (!channel_full)
+        {
+            clean_runs  += 1;
+            lost_runs   += lost;
+            stuck_clean += stuck;
+        }
+
+        stuck_runs += stuck;
+
+        if ((m_coms_keys_channel.p_current_data_desc != NULL) ||
+            (nrf_balloc_utilization_get(&m_coms_report_pool) != 0) ||
+            (nrf_balloc_utilization_get(&m_coms_data_desc_pool) != 0))
+        {
+            leaking_runs += 1;
+        }
+
+        sent_total      += s_sent_count;
+        reference_total += s_reference_count;
+    }
+
+    printf("report fuzz: %u runs, %u without a full channel, %u of them lost transitions, %u stuck, %u leaked;"
+           " %u reports sent for %u state changes\n",
+           FUZZ_RUNS, clean_runs, lost_runs, stuck_runs, leaking_runs, sent_total, reference_total);
+
+    TEST_CHECK(clean_runs > FUZZ_RUNS / 4);
+    TEST_CHECK(clean_runs < FUZZ_RUNS);
+    TEST_CHECK(lost_runs == 0);
+    TEST_CHECK(stuck_clean == 0);
+    TEST_CHECK(leaking_runs == 0);
+
+#if CONFIG_HID_REPORT_COALESCING_ENABLED
+    TEST_CHECK(stuck_runs == 0);
+    TEST_CHECK(m_coms_report_coalesced > 0);
+#endif
+}
+
+/**@brief Input report fields found in the report descriptor. */
+typedef struct
+{
+    uint8_t  report_id;
+    uint16_t usage_page;    /**< Usage page in effect at the Input item. */
+    uint8_t  size;          /**< Field size [bits]. */
+    uint16_t offset;        /**< Field offset in the report [bits]. */
+    bool     array;         /**< True if declared by an Input (Ary) item. */
+    bool     is_signed;     /**< True if the Logical Minimum is negative. */
+} desc_field_t;
+
+static desc_field_t s_desc_fields[64];
+static size_t       s_desc_field_count;
+
+/**@brief Walk the HID report descriptor and list the fields of all input reports.
+ *
+ * @details Only the short items used by m_coms_hid_desc are interpreted: Usage Page, Logical Minimum, Report
+ *          Size, Report ID, Report Count and Input.
+ */
+static void desc_parse(uint8_t const *p_desc, size_t size)
+{
+    uint16_t report_bits[256];
+    uint8_t  report_id    = 0;
+    uint16_t usage_page   = 0;
+    uint8_t  field_size   = 0;
+    uint8_t  field_count  = 0;
+    int32_t  logical_min  = 0;
+    size_t   i = 0;
+
+    memset(report_bits, 0, sizeof(report_bits));
+    s_desc_field_count = 0;
+
+    while (i < size)
+    {
+        uint8_t  prefix    = p_desc[i];
+        size_t   data_size = ((prefix & 0x03) == 3) ? 4 : (prefix & 0x03);
+        uint32_t data      = 0;
+        size_t   j;
+
+        TEST_CHECK(i + data_size < size);
+        for (j = 0; j < data_size; j++)
+        {
+            data |= (uint32_t)p_desc[i + 1 + j] << (8 * j);
+        }
+
+        switch (prefix & 0xFC)
+        {
+            case 0x04:  // Usage Page
+                usage_page = data;
+                break;
+
+            case 0x14:  // Logical Minimum
+                logical_min = (data_size == 1) ? (int8_t)data : (data_size == 2) ? (int16_t)data : (int32_t)data;
+                break;
+
+            case 0x74:  // Report Size
+                field_size = data;
+                break;
+
+            case 0x84:  // Report ID
+                report_id = data;
+                break;
+
+            case 0x94:  // Report Count
+                field_count = data;
+                break;
+
+            case 0x80:  // Input
+                for (j = 0; j < field_count; j++)
+                {
+                    desc_field_t *p_field = &s_desc_fields[s_desc_field_count++];
+
+                    p_field->report_id  = report_id;
+                    p_field->usage_page = usage_page;
+                    p_field->size       = field_size;
+                    p_field->offset     = report_bits[report_id];
+                    p_field->array      = ((data & 0x02) == 0);
+                    p_field->is_signed  = (logical_min < 0);
+
+                    report_bits[report_id] += field_size;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        i += 1 + data_size;
+    }
+}
+
+/**@brief Get the ID of the report with a given index. */
+static uint8_t report_id_get(uint8_t report_idx)
+{
+    static const uint8_t report_ids[HID_NUMBER_OF_IN_REPS] =
+    {
+        [HID_REPORT_IDX(KEYBOARD_IN)]       = HID_REPORT_ID(KEYBOARD_IN),
+        [HID_REPORT_IDX(CONSUMER_CTRL_IN)]  = HID_REPORT_ID(CONSUMER_CTRL_IN),
+        [HID_REPORT_IDX(MOUSE_BTN_IN)]      = HID_REPORT_ID(MOUSE_BTN_IN),
+        [HID_REPORT_IDX(MOUSE_XY_IN)]       = HID_REPORT_ID(MOUSE_XY_IN),
+        [HID_REPORT_IDX(MOUSE_WP_IN)]       = HID_REPORT_ID(MOUSE_WP_IN),
+    };
+
+    return report_ids[report_idx];
+}
+
+/**@brief Check the report layouts against the report descriptor and pack random field values through them. */
+static void test_report_layouts(void)
+{
+    unsigned report_idx;
+
+    desc_parse(m_coms_hid_desc, sizeof(m_coms_hid_desc));
+
+    srand(2);
+
+    for (report_idx = 0; report_idx < HID_NUMBER_OF_IN_REPS; report_idx++)
+    {
+        m_coms_report_layout_t const *p_layout = &m_coms_report_layouts[report_idx];
+        desc_field_t const           *p_fields[HID_MAX_REPORT_FIELD_COUNT + 1];
+        size_t   field_count = 0;
+        size_t   report_bits = 0;
+        unsigned mismatches  = 0;
+        unsigned round;
+        size_t   i;
+
+        if (p_layout->field_count == 0)
+        {
+            // Not an input report built by the module.
+            continue;
+        }
+
+        for (i = 0; i < s_desc_field_count; i++)
+        {
+            if ((s_desc_fields[i].report_id == report_id_get(report_idx)) &&
+                (field_count < ARRAY_SIZE(p_fields)))
+            {
+                p_fields[field_count++] = &s_desc_fields[i];
+                report_bits            += s_desc_fields[i].size;
+            }
+        }
+
+        TEST_CHECK(field_count == p_layout->field_count);
+        if (field_count != p_layout->field_count)
+        {
+            continue;
+        }
+
+        for (i = 0; i < field_count; i++)
+        {
+            TEST_CHECK(p_fields[i]->size == p_layout->field_size);
+            TEST_CHECK(p_fields[i]->offset == i * p_layout->field_size);
+            TEST_CHECK(p_fields[i]->array == p_layout->array);
+            TEST_CHECK(!p_layout->array || (p_fields[i]->usage_page == p_layout->usage_page));
+        }
+
+        for (round = 0; round < LAYOUT_ROUNDS; round++)
+        {
+            int16_t fields[HID_MAX_REPORT_FIELD_COUNT];
+            uint8_t report[HID_MAX_REPORT_FIELD_COUNT * 2 + 1];
+            size_t  size;
+
+            for (i = 0; i < field_count; i++)
+            {
+                int32_t range = 1L << p_fields[i]->size;
+
+                fields[i] = p_fields[i]->is_signed ? ((rand() % (range - 1)) - (range / 2 - 1)) : (rand() % range);
+            }
+
+            memset(report, 0xA5, sizeof(report));
+            size = m_coms_report_pack(report_idx, report, fields);
+
+            if ((size * 8 != report_bits) || (report[size] != 0xA5))
+            {
+                mismatches += 1;
+                continue;
+            }
+
+            for (i = 0; i < field_count; i++)
+            {
+                int32_t value = report_field_get(report, p_fields[i]->size, i);
+
+                if (p_fields[i]->is_signed && (value >= (1L << (p_fields[i]->size - 1))))
+                {
+                    value -= 1L << p_fields[i]->size;
+                }
+
+                if (value != fields[i])
+                {
+                    mismatches += 1;
+                    break;
+                }
+            }
+        }
+
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+/**@brief Check the report creation from the HID state, including usages which are not listed. */
+static void test_report_create(void)
+{
+    static const uint32_t active[] =
+    {
+        HID_USAGE(0x07, 0x04),
+        HID_USAGE(0x09, 0x01), HID_USAGE(0x09, 0x03), HID_USAGE(0x09, 0x08),
+        HID_USAGE(0x0C, 0xE9), HID_USAGE(0x0C, 0x238), HID_USAGE(0x0C, 0x240), HID_USAGE(0x0C, 0x241),
+    };
+    uint8_t report[HID_MAX_QUEUED_REPORT_SIZE + 1];
+    size_t  i;
+
+    s_state_size = 0;
+    for (i = 0; i < ARRAY_SIZE(active); i++)
+    {
+        state_set(active[i], true);
+    }
+
+    // AC Pan is carried by the Wheel/Pan report, so it does not take a consumer control field.
+    memset(report, 0xA5, sizeof(report));
+    TEST_CHECK(m_coms_create_consumer_ctrl_report(report) == HID_REPORT_SIZE(CONSUMER_CTRL_IN));
+    TEST_CHECK((report[0] == 0xE9) && (report[1] == 0x00) && (report[2] == 0x24));
+    TEST_CHECK(report[HID_REPORT_SIZE(CONSUMER_CTRL_IN)] == 0xA5);
+
+    // Every pressed button is shown.
+    TEST_CHECK(m_coms_create_mouse_btn_report(report) == HID_REPORT_SIZE(MOUSE_BTN_IN));
+    TEST_CHECK(report[0] == 0x85);
+
+    TEST_CHECK(m_coms_create_keyboard_report(report) == HID_REPORT_SIZE(KEYBOARD_IN));
+    TEST_CHECK((report[0] == 0x04) && (report[1] == 0x00) && (report[2] == 0x00));
+
+    s_state_size = 0;
+}
+
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+// ----------------------------------------------------------------------------
+// Audio packing
+// ----------------------------------------------------------------------------
+
+/**@brief Get a frame size: mostly random, often around the largest chunk length and the report size. */
+static uint16_t audio_frame_size(void)
+{
+    static const uint16_t edges[] =
+    {
+        1, AUDIO_HID_CHUNK_LEN_MASK - 1, AUDIO_HID_CHUNK_LEN_MASK, AUDIO_HID_CHUNK_LEN_MASK + 1,
+        2 * AUDIO_HID_CHUNK_LEN_MASK, 2 * AUDIO_HID_CHUNK_LEN_MASK + 1, CONFIG_AUDIO_FRAME_SIZE_BYTES,
+    };
+    uint16_t size;
+
+    if (rand() % 4 == 0)
+    {
+        size = edges[rand() % ARRAY_SIZE(edges)];
+    }
+    else
+    {
+        size = (uint16_t)(1 + rand() % CONFIG_AUDIO_FRAME_SIZE_BYTES);
+    }
+
+    return MIN(size, CONFIG_AUDIO_FRAME_SIZE_BYTES);
+}
+
+/**@brief Get a frame which is not referenced by the module, or NULL if all are in use. */
+static m_audio_frame_t *audio_frame_free(void)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(s_audio_frames); i++)
+    {
+        if (s_audio_frames[i].reference_count == 0)
+        {
+            return &s_audio_frames[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Stream frames at a given MTU and parse them back from the reports. */
+static void audio_stream(uint8_t mtu)
+{
+    m_coms_ble_evt_t evt;
+    size_t           i;
+
+    link_open();
+
+    memset(&evt, 0, sizeof(evt));
+    evt.type                            = M_COMS_BLE_EVT_MTU_CHANGED;
+    evt.data.mtu_changed.effective_mtu  = mtu;
+    m_coms_ble_evt_handler(&evt, sizeof(evt));
+
+    s_audio_max_report   = MIN(HID_REPORT_SIZE(AUDIO_IN), mtu - 3);
+    s_audio_frame_size   = 0;
+    s_audio_reports      = 0;
+    s_audio_terminated   = 0;
+    s_audio_long_chunks  = 0;
+    s_audio_split_frames = 0;
+    memset(&s_audio_sent, 0, sizeof(s_audio_sent));
+    memset(&s_audio_received, 0, sizeof(s_audio_received));
+
+    m_coms_audio_service_enable(M_COMS_AUDIO_SERVICE_HID);
+
+    while (s_audio_sent.count < AUDIO_FRAMES)
+    {
+        m_audio_frame_t *p_frame = audio_frame_free();
+
+        // Frames are released when the last chunk is packed, transmissions complete in bursts.
+        if ((p_frame == NULL) || (rand() % 3 == 0))
+        {
+            link_complete(1 + rand() % CONFIG_GATTS_CONN_HVN_TX_QUEUE_SIZE);
+            continue;
+        }
+
+        p_frame->data_size = audio_frame_size();
+        for (i = 0; i < p_frame->data_size; i++)
+        {
+            p_frame->data[i] = (uint8_t)rand();
+        }
+
+        memcpy(&s_audio_sent.data[s_audio_sent.size], p_frame->data, p_frame->data_size);
+        s_audio_sent.size                          += p_frame->data_size;
+        s_audio_sent.sizes[s_audio_sent.count++]    = p_frame->data_size;
+
+        TEST_CHECK(m_coms_send_audio(p_frame) == NRF_SUCCESS);
+    }
+
+    // Flush the last report.
+    while (s_sd_queued > 0)
+    {
+        link_complete(s_sd_queued);
+    }
+
+    TEST_CHECK(s_audio_frame_size == 0);
+    TEST_CHECK(s_audio_received.count == s_audio_sent.count);
+    TEST_CHECK(memcmp(s_audio_received.sizes, s_audio_sent.sizes, sizeof(s_audio_sent.sizes)) == 0);
+    TEST_CHECK(s_audio_received.size == s_audio_sent.size);
+    TEST_CHECK(memcmp(s_audio_received.data, s_audio_sent.data, s_audio_sent.size) == 0);
+    TEST_CHECK(audio_frame_free() != NULL);
+    for (i = 0; i < ARRAY_SIZE(s_audio_frames); i++)
+    {
+        TEST_CHECK(s_audio_frames[i].reference_count == 0);
+    }
+
+    // Every framing case must have occurred.
+    TEST_CHECK(s_audio_terminated > 0);
+    TEST_CHECK(s_audio_split_frames > 0);
+    TEST_CHECK((s_audio_long_chunks > 0) || (s_audio_max_report <= AUDIO_HID_CHUNK_LEN_MASK));
+
+    m_coms_audio_service_disable(M_COMS_AUDIO_SERVICE_HID);
+
+    printf("Audio packing, MTU %u: %u frames, %u bytes in %u reports (%u terminated, %u split frames, "
+           "%u chunks of %u bytes)\n",
+           mtu, (unsigned)s_audio_sent.count, (unsigned)s_audio_sent.size, s_audio_reports, s_audio_terminated,
+           s_audio_split_frames, s_audio_long_chunks, AUDIO_HID_CHUNK_LEN_MASK);
+}
+
+static void test_audio_packing(void)
+{
+    srand(7);
+
+    audio_stream(BLE_GATT_ATT_MTU_DEFAULT);
+    audio_stream(NRF_SDH_BLE_GATT_MAX_MTU_SIZE);
+}
+#endif /* CONFIG_AUDIO_HID_PACKING_ENABLED */
+
+int main(void)
+{
+    test_report_layouts();
+    test_report_create();
+    test_report_fuzz();
+#if CONFIG_AUDIO_HID_PACKING_ENABLED
+    test_audio_packing();
+#endif
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,22 @@
+/* Stand-in for the SoftDevice header of the same name: the GAP address. */
+#ifndef BLE_H__
+#define BLE_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define BLE_GAP_ADDR_LEN                    6
+#define BLE_GAP_ADDR_TYPE_PUBLIC            0x00
+#define BLE_GAP_ADDR_TYPE_RANDOM_STATIC     0x01
+
+typedef struct
+{
+    uint8_t addr_id_peer : 1;
+    uint8_t addr_type    : 7;
+    uint8_t addr[BLE_GAP_ADDR_LEN];
+} ble_gap_addr_t;
+
+ret_code_t sd_ble_gap_addr_set(ble_gap_addr_t const *p_addr);
+
+#endif // BLE_H__
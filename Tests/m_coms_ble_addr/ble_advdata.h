@@ -0,0 +1,5 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef BLE_ADVDATA_H__
+#define BLE_ADVDATA_H__
+
+#endif // BLE_ADVDATA_H__
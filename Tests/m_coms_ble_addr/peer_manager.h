@@ -0,0 +1,80 @@
+/* Stand-in for the SDK header of the same name: the peer database, mocked by the test. */
+#ifndef PEER_MANAGER_H__
+#define PEER_MANAGER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ble.h"
+#include "sdk_errors.h"
+
+#define PM_PEER_ID_INVALID      0xFFFF
+#define PM_STORE_TOKEN_INVALID  0
+
+typedef uint16_t pm_peer_id_t;
+typedef uint32_t pm_store_token_t;
+
+typedef enum
+{
+    PM_PEER_DATA_ID_BONDING,
+    PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING,
+    PM_PEER_DATA_ID_GATT_LOCAL,
+    PM_PEER_DATA_ID_GATT_REMOTE,
+    PM_PEER_DATA_ID_PEER_RANK,
+    PM_PEER_DATA_ID_APPLICATION,
+} pm_peer_data_id_t;
+
+typedef enum
+{
+    PM_PEER_DATA_OP_UPDATE,
+    PM_PEER_DATA_OP_DELETE,
+} pm_peer_data_op_t;
+
+typedef enum
+{
+    PM_EVT_BONDED_PEER_CONNECTED,
+    PM_EVT_PEER_DATA_UPDATE_SUCCEEDED,
+    PM_EVT_PEER_DATA_UPDATE_FAILED,
+    PM_EVT_PEER_DELETE_SUCCEEDED,
+    PM_EVT_PEER_DELETE_FAILED,
+    PM_EVT_PEERS_DELETE_SUCCEEDED,
+    PM_EVT_PEERS_DELETE_FAILED,
+} pm_evt_id_t;
+
+typedef struct
+{
+    struct
+    {
+        ble_gap_addr_t id_addr_info;
+    } peer_ble_id;
+} pm_peer_data_bonding_t;
+
+typedef struct
+{
+    pm_evt_id_t     evt_id;
+    pm_peer_id_t    peer_id;
+    uint16_t        conn_handle;
+    union
+    {
+        struct
+        {
+            pm_peer_data_id_t   data_id;
+            pm_peer_data_op_t   action;
+            pm_store_token_t    token;
+            bool                flash_changed;
+        } peer_data_update_succeeded;
+    } params;
+} pm_evt_t;
+
+typedef void (*pm_evt_handler_t)(pm_evt_t const *p_event);
+
+ret_code_t   pm_register(pm_evt_handler_t event_handler);
+pm_peer_id_t pm_next_peer_id_get(pm_peer_id_t prev_peer_id);
+ret_code_t   pm_peer_data_load(pm_peer_id_t peer_id, pm_peer_data_id_t data_id, void *p_data, uint16_t *p_len);
+ret_code_t   pm_peer_data_bonding_load(pm_peer_id_t peer_id, pm_peer_data_bonding_t *p_data);
+ret_code_t   pm_peer_data_app_data_load(pm_peer_id_t peer_id, uint8_t *p_data, uint16_t *p_len);
+ret_code_t   pm_peer_data_app_data_store(pm_peer_id_t peer_id, uint8_t const *p_data, uint16_t len,
+                                         pm_store_token_t *p_token);
+ret_code_t   pm_peer_delete(pm_peer_id_t peer_id);
+
+#endif // PEER_MANAGER_H__
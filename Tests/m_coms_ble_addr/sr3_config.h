@@ -0,0 +1,17 @@
+/* Bonding configuration used by the test: several bonds, each with its own local address, ordered by peer rank. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_SEC_BOND                     1
+#define CONFIG_MAX_BONDS                    3
+#define CONFIG_CHANGE_ADDRESS               1
+#define CONFIG_BOND_PUBLIC_ADDR_ENABLED     0
+#define CONFIG_BLE_DYNAMIC_ADDR_ENABLED     1
+#define CONFIG_BLE_PEER_RANK_ENABLED        1
+#define CONFIG_BLE_ADDR_LOG_LEVEL           0
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,460 @@
+/**@file
+ *
+ * @brief Test of the in-RAM peer summary of the BLE address module.
+ *
+ * @details The test includes m_coms_ble_addr.c. Peer Manager is replaced by a model of the peer database, which
+ *          counts the flash reads, and the test sends the Peer Manager events that go with every change it makes to
+ *          the database: new bonds stored in the order bonding data, rank, local address; rank updates; local
+ *          addresses deleted; peers deleted one by one or all at once; failed updates; and unrelated data updates.
+ *
+ *          After every change, the peer list, the local and peer addresses of every peer and the next local address
+ *          must match the database, and none of the queries may read flash. Storing the local address of a known
+ *          peer must not read flash either. Peers with missing data must be reported as corrupted and deleted.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "m_coms_ble_addr.c"
+
+#define PEER_SLOTS          6       /**< Peer IDs used by the database model, more than CONFIG_MAX_BONDS. */
+#define SOAK_OPERATIONS     200000
+#define ADDR_MASK           0x3FFFFFFFFFFFULL
+
+/**@brief Peer database entry. */
+typedef struct
+{
+    bool            exists;
+    bool            delete_pending;
+    bool            has_bonding;
+    bool            has_rank;
+    bool            has_app_data;
+    uint32_t        rank;
+    ble_gap_addr_t  peer_addr;
+    ble_gap_addr_t  local_addr;
+} db_peer_t;
+
+static db_peer_t            s_db[PEER_SLOTS];
+static pm_evt_handler_t     s_pm_evt_handler;
+static unsigned int         s_flash_reads;
+static unsigned int         s_deletes;
+static pm_store_token_t     s_next_token = 1;
+static pm_store_token_t     s_stored_token;
+static uint8_t              s_stored_data[sizeof(m_coms_ble_addr_app_data_t)];
+static uint32_t             s_rank;
+
+ret_code_t pm_register(pm_evt_handler_t event_handler)
+{
+    s_pm_evt_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+static bool db_listed(pm_peer_id_t peer_id)
+{
+    return s_db[peer_id].exists && !s_db[peer_id].delete_pending;
+}
+
+static bool db_valid(pm_peer_id_t peer_id)
+{
+    return db_listed(peer_id) && s_db[peer_id].has_bonding && s_db[peer_id].has_rank && s_db[peer_id].has_app_data;
+}
+
+pm_peer_id_t pm_next_peer_id_get(pm_peer_id_t prev_peer_id)
+{
+    for (pm_peer_id_t id = (prev_peer_id == PM_PEER_ID_INVALID) ? 0 : prev_peer_id + 1; id < PEER_SLOTS; id++)
+    {
+        if (db_listed(id))
+        {
+            return id;
+        }
+    }
+
+    return PM_PEER_ID_INVALID;
+}
+
+ret_code_t pm_peer_data_load(pm_peer_id_t peer_id, pm_peer_data_id_t data_id, void *p_data, uint16_t *p_len)
+{
+    s_flash_reads++;
+    TEST_CHECK(data_id == PM_PEER_DATA_ID_PEER_RANK);
+
+    if (!s_db[peer_id].exists || !s_db[peer_id].has_rank)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    memcpy(p_data, &s_db[peer_id].rank, sizeof(s_db[peer_id].rank));
+    *p_len = sizeof(s_db[peer_id].rank);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t pm_peer_data_bonding_load(pm_peer_id_t peer_id, pm_peer_data_bonding_t *p_data)
+{
+    s_flash_reads++;
+
+    if (!s_db[peer_id].exists || !s_db[peer_id].has_bonding)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    p_data->peer_ble_id.id_addr_info = s_db[peer_id].peer_addr;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t pm_peer_data_app_data_load(pm_peer_id_t peer_id, uint8_t *p_data, uint16_t *p_len)
+{
+    s_flash_reads++;
+
+    if (!s_db[peer_id].exists || !s_db[peer_id].has_app_data)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    memset(p_data, 0, sizeof(m_coms_ble_addr_app_data_t));
+    memcpy(p_data, &s_db[peer_id].local_addr, sizeof(ble_gap_addr_t));
+    *p_len = sizeof(m_coms_ble_addr_app_data_t);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t pm_peer_data_app_data_store(pm_peer_id_t peer_id, uint8_t const *p_data, uint16_t len,
+                                       pm_store_token_t *p_token)
+{
+    TEST_CHECK(len == sizeof(s_stored_data));
+
+    memcpy(s_stored_data, p_data, sizeof(s_stored_data));
+    s_stored_token = *p_token = s_next_token++;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t pm_peer_delete(pm_peer_id_t peer_id)
+{
+    s_deletes++;
+    s_db[peer_id].delete_pending = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t sd_ble_gap_addr_set(ble_gap_addr_t const *p_addr)
+{
+    return NRF_SUCCESS;
+}
+
+static void pm_evt_send(pm_evt_id_t evt_id, pm_peer_id_t peer_id, pm_peer_data_id_t data_id,
+                        pm_peer_data_op_t action, pm_store_token_t token)
+{
+    pm_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_id                                       = evt_id;
+    evt.peer_id                                      = peer_id;
+    evt.params.peer_data_update_succeeded.data_id    = data_id;
+    evt.params.peer_data_update_succeeded.action     = action;
+    evt.params.peer_data_update_succeeded.token      = token;
+
+    s_pm_evt_handler(&evt);
+}
+
+static void addr_random(ble_gap_addr_t *p_addr)
+{
+    memset(p_addr, 0, sizeof(*p_addr));
+    for (int i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        p_addr->addr[i] = rand();
+    }
+}
+
+static uint64_t addr_value(ble_gap_addr_t const *p_addr)
+{
+    uint64_t value = 0;
+
+    for (int i = BLE_GAP_ADDR_LEN - 1; i >= 0; i--)
+    {
+        value = (value << 8) | p_addr->addr[i];
+    }
+
+    return value;
+}
+
+/**@brief Compare the module answers with the database. None of the queries may read flash. */
+static void summary_check(void)
+{
+    pm_peer_id_t    ids[CONFIG_MAX_BONDS];
+    pm_peer_id_t    expected[PEER_SLOTS];
+    unsigned int    expected_num = 0;
+    unsigned int    listed_num = 0;
+    unsigned int    ids_num = 0;
+    unsigned int    flash_reads = s_flash_reads;
+    uint64_t        largest_addr = 0;
+    ble_gap_addr_t  addr;
+
+    for (pm_peer_id_t id = 0; id < PEER_SLOTS; id++)
+    {
+        listed_num += db_listed(id);
+    }
+
+    if (listed_num > CONFIG_MAX_BONDS)
+    {
+        TEST_CHECK(m_coms_ble_addr_peer_ids_get(ids, &ids_num) == NRF_ERROR_NO_MEM);
+        return;
+    }
+
+    // Valid peers, least recently used first.
+    for (pm_peer_id_t id = 0; id < PEER_SLOTS; id++)
+    {
+        unsigned int i = expected_num++;
+
+        if (!db_valid(id))
+        {
+            expected_num--;
+            continue;
+        }
+
+        for (; (i > 0) && (s_db[expected[i - 1]].rank > s_db[id].rank); i--)
+        {
+            expected[i] = expected[i - 1];
+        }
+        expected[i] = id;
+    }
+
+    TEST_CHECK(m_coms_ble_addr_peer_ids_get(ids, &ids_num) == NRF_SUCCESS);
+    TEST_CHECK(ids_num == expected_num);
+    TEST_CHECK(memcmp(ids, expected, MIN(ids_num, expected_num) * sizeof(ids[0])) == 0);
+
+    for (pm_peer_id_t id = 0; id < PEER_SLOTS; id++)
+    {
+        if (!db_valid(id))
+        {
+            TEST_CHECK(m_coms_ble_addr_local_addr_get(id, &addr) == NRF_ERROR_NOT_FOUND);
+            TEST_CHECK(m_coms_ble_addr_peer_addr_get(id, &addr) == NRF_ERROR_NOT_FOUND);
+            continue;
+        }
+
+        TEST_CHECK(m_coms_ble_addr_local_addr_get(id, &addr) == NRF_SUCCESS);
+        TEST_CHECK(memcmp(addr.addr, s_db[id].local_addr.addr, BLE_GAP_ADDR_LEN) == 0);
+        TEST_CHECK(m_coms_ble_addr_peer_addr_get(id, &addr) == NRF_SUCCESS);
+        TEST_CHECK(memcmp(addr.addr, s_db[id].peer_addr.addr, BLE_GAP_ADDR_LEN) == 0);
+
+        largest_addr = MAX(largest_addr, addr_value(&s_db[id].local_addr));
+    }
+
+    if (largest_addr == 0)
+    {
+        TEST_CHECK(m_coms_ble_addr_local_addr_new(&addr) == NRF_ERROR_INVALID_STATE);
+    }
+    else
+    {
+        TEST_CHECK(m_coms_ble_addr_local_addr_new(&addr) == NRF_SUCCESS);
+        TEST_CHECK((addr_value(&addr) & ADDR_MASK) == ((largest_addr + 1) & ADDR_MASK));
+    }
+
+    TEST_CHECK(s_flash_reads == flash_reads);
+}
+
+/**@brief Store a new bond, in the order Peer Manager and the address module store its data. */
+static void peer_bond(pm_peer_id_t peer_id)
+{
+    ble_gap_addr_t local_addr;
+
+    memset(&s_db[peer_id], 0, sizeof(s_db[peer_id]));
+    s_db[peer_id].exists      = true;
+    s_db[peer_id].has_bonding = true;
+    addr_random(&s_db[peer_id].peer_addr);
+    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_BONDING, PM_PEER_DATA_OP_UPDATE, 0);
+    summary_check();
+
+    s_db[peer_id].has_rank = true;
+    s_db[peer_id].rank     = ++s_rank;
+    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_PEER_RANK, PM_PEER_DATA_OP_UPDATE, 0);
+    summary_check();
+
+    addr_random(&local_addr);
+    TEST_CHECK(m_coms_ble_addr_local_addr_set(peer_id, &local_addr) == NRF_SUCCESS);
+    s_db[peer_id].has_app_data = true;
+    memcpy(&s_db[peer_id].local_addr, s_stored_data, sizeof(ble_gap_addr_t));
+    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_APPLICATION, PM_PEER_DATA_OP_UPDATE,
+                s_stored_token);
+    summary_check();
+
+    if (!db_valid(peer_id))
+    {
+        return;
+    }
+
+    // The address of a known peer is taken from the write buffer.
+    unsigned int flash_reads = s_flash_reads;
+
+    local_addr.addr[0] ^= 1;
+    TEST_CHECK(m_coms_ble_addr_local_addr_set(peer_id, &local_addr) == NRF_SUCCESS);
+    memcpy(&s_db[peer_id].local_addr, s_stored_data, sizeof(ble_gap_addr_t));
+    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_APPLICATION, PM_PEER_DATA_OP_UPDATE,
+                s_stored_token);
+    TEST_CHECK(s_flash_reads == flash_reads);
+}
+
+/**@brief Delete a peer and report the deletion. */
+static void peer_delete(pm_peer_id_t peer_id)
+{
+    memset(&s_db[peer_id], 0, sizeof(s_db[peer_id]));
+    pm_evt_send(PM_EVT_PEER_DELETE_SUCCEEDED, peer_id, 0, PM_PEER_DATA_OP_DELETE, 0);
+}
+
+static void peer_init(pm_peer_id_t peer_id, uint32_t rank, bool has_app_data)
+{
+    memset(&s_db[peer_id], 0, sizeof(s_db[peer_id]));
+    s_db[peer_id].exists       = true;
+    s_db[peer_id].has_bonding  = true;
+    s_db[peer_id].has_rank     = true;
+    s_db[peer_id].has_app_data = has_app_data;
+    s_db[peer_id].rank         = rank;
+    addr_random(&s_db[peer_id].peer_addr);
+    addr_random(&s_db[peer_id].local_addr);
+}
+
+/**@brief Read the database at init and delete a corrupted peer. */
+static void test_init(void)
+{
+    unsigned int peers_num;
+
+    peer_init(0, 5, true);
+    peer_init(1, 2, false);
+    peer_init(2, 9, true);
+    s_rank = 9;
+
+    TEST_CHECK(m_coms_ble_addr_init() == NRF_SUCCESS);
+    TEST_CHECK(s_flash_reads == 9);
+
+    s_flash_reads = 0;
+    TEST_CHECK(m_coms_ble_addr_peers_check(&peers_num) == NRF_SUCCESS);
+    TEST_CHECK(peers_num == 2);
+    TEST_CHECK(s_deletes == 1);
+    TEST_CHECK(s_db[1].delete_pending);
+    TEST_CHECK(s_flash_reads == 0);
+    summary_check();
+
+    peer_delete(1);
+    summary_check();
+}
+
+/**@brief Random changes to the database. */
+static void test_soak(void)
+{
+    unsigned int events = 0;
+    unsigned int flash_reads = s_flash_reads;
+
+    for (int i = 0; i < SOAK_OPERATIONS; i++)
+    {
+        pm_peer_id_t peer_id = rand() % PEER_SLOTS;
+        unsigned int listed_num = 0;
+        unsigned int peers_num;
+
+        switch (rand() % 8)
+        {
+            case 0:
+                if (db_listed(peer_id))
+                {
+                    s_db[peer_id].rank = ++s_rank;
+                    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_PEER_RANK,
+                                PM_PEER_DATA_OP_UPDATE, 0);
+                    events++;
+                }
+                break;
+
+            case 1:
+                if (!s_db[peer_id].exists)
+                {
+                    peer_bond(peer_id);
+                    events += 4;
+                }
+                break;
+
+            case 2:
+                if (db_listed(peer_id))
+                {
+                    TEST_CHECK(pm_peer_delete(peer_id) == NRF_SUCCESS);
+                    peer_delete(peer_id);
+                    events++;
+                }
+                break;
+
+            case 3:
+                if (db_listed(peer_id) && s_db[peer_id].has_app_data)
+                {
+                    s_db[peer_id].has_app_data = false;
+                    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_APPLICATION,
+                                PM_PEER_DATA_OP_DELETE, 0);
+                    events++;
+                }
+                break;
+
+            case 4:
+            {
+                // Data not in the summary must not cause flash reads.
+                unsigned int reads = s_flash_reads;
+
+                pm_evt_send(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, peer_id, PM_PEER_DATA_ID_GATT_LOCAL,
+                            PM_PEER_DATA_OP_UPDATE, 0);
+                TEST_CHECK(s_flash_reads == reads);
+                events++;
+                break;
+            }
+
+            case 5:
+                if ((rand() % 50) == 0)
+                {
+                    memset(s_db, 0, sizeof(s_db));
+                    pm_evt_send(PM_EVT_PEERS_DELETE_SUCCEEDED, PM_PEER_ID_INVALID, 0, PM_PEER_DATA_OP_DELETE, 0);
+                    events++;
+                }
+                break;
+
+            case 6:
+                for (pm_peer_id_t id = 0; id < PEER_SLOTS; id++)
+                {
+                    listed_num += db_listed(id);
+                }
+
+                if (listed_num <= CONFIG_MAX_BONDS)
+                {
+                    TEST_CHECK(m_coms_ble_addr_peers_check(&peers_num) == NRF_SUCCESS);
+                    for (pm_peer_id_t id = 0; id < PEER_SLOTS; id++)
+                    {
+                        if (s_db[id].delete_pending)
+                        {
+                            peer_delete(id);
+                            events++;
+                        }
+                    }
+                }
+                break;
+
+            case 7:
+                if (db_listed(peer_id) && ((rand() % 4) == 0))
+                {
+                    s_db[peer_id].has_rank = false;
+                    pm_evt_send(PM_EVT_PEER_DATA_UPDATE_FAILED, peer_id, PM_PEER_DATA_ID_PEER_RANK,
+                                PM_PEER_DATA_OP_UPDATE, 0);
+                    events++;
+                }
+                break;
+        }
+
+        summary_check();
+    }
+
+    printf("%u Peer Manager events, %u flash reads (%.2f per event), %u peer deletions\n",
+           events, s_flash_reads - flash_reads, (double)(s_flash_reads - flash_reads) / events, s_deletes);
+}
+
+int main(void)
+{
+    srand(1);
+
+    test_init();
+    test_soak();
+
+    return TEST_RESULT();
+}
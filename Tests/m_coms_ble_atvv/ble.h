@@ -0,0 +1,8 @@
+/* Stand-in for the SoftDevice header of the same name: the definitions used by the ATVV module. */
+#ifndef BLE_H__
+#define BLE_H__
+
+#define BLE_CONN_HANDLE_INVALID                 0xFFFF
+#define BLE_ERROR_GATTS_SYS_ATTR_MISSING        0x3401
+
+#endif // BLE_H__
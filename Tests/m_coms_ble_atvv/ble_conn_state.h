@@ -0,0 +1,7 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef BLE_CONN_STATE_H__
+#define BLE_CONN_STATE_H__
+
+#include "ble.h"
+
+#endif // BLE_CONN_STATE_H__
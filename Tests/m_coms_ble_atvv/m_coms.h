@@ -0,0 +1,15 @@
+/* Stand-in for the header of the same name: the data processing status of the communication module. */
+#ifndef __M_COMS_H__
+#define __M_COMS_H__
+
+#include "sdk_errors.h"
+
+typedef enum
+{
+    M_COMS_STATUS_SUCCESS        = NRF_SUCCESS,
+    M_COMS_STATUS_SD_BUFFER_FULL,
+    M_COMS_STATUS_QUEUE_EMPTY,
+    M_COMS_STATUS_CANNOT_SEND,
+} m_coms_data_process_status_t;
+
+#endif /* __M_COMS_H__ */
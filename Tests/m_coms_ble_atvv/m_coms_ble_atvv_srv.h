@@ -0,0 +1,93 @@
+/* Stand-in for the header of the same name: the ATVV Service interface, with the service itself replaced by the
+ * link model of the test. */
+#ifndef BLE_ATVV_H__
+#define BLE_ATVV_H__
+
+#include <stdint.h>
+
+#include "ble.h"
+#include "sdk_errors.h"
+
+#define BLE_ATVV_DEF(_name)                         static ble_atvv_t _name
+
+#define ATVV_CTL_AUDIO_STOP                         (0x00)
+#define ATVV_CTL_AUDIO_START                        (0x04)
+#define ATVV_CTL_START_SEARCH                       (0x08)
+#define ATVV_CTL_AUDIO_SYNC                         (0x0A)
+#define ATVV_CTL_GET_CAPS_RESP                      (0x0B)
+#define ATVV_CTL_MIC_OPEN_ERROR                     (0x0C)
+
+#define ATVV_CAPS_FRAME_SIZE_DEFAULT_134            (0x0086)
+
+#define ATVV_TIMEOUT_1_MIC_OPEN                     (1000)
+#define ATVV_TIMEOUT_2_STREAMING_DURATION           (7000)
+
+typedef enum
+{
+    BLE_ATVV_EVT_ENABLED,
+    BLE_ATVV_EVT_DISABLED,
+    BLE_ATVV_EVT_MIC_OPEN,
+    BLE_ATVV_EVT_MIC_CLOSE,
+    BLE_ATVV_EVT_GET_CAPS,
+} ble_atvv_evt_type_t;
+
+typedef enum
+{
+    BLE_ATVV_CTL_AUDIO_STOP     = ATVV_CTL_AUDIO_STOP,
+    BLE_ATVV_CTL_AUDIO_START    = ATVV_CTL_AUDIO_START,
+    BLE_ATVV_CTL_START_SEARCH   = ATVV_CTL_START_SEARCH,
+    BLE_ATVV_CTL_AUDIO_SYNC     = ATVV_CTL_AUDIO_SYNC,
+    BLE_ATVV_CTL_GET_CAPS_RESP  = ATVV_CTL_GET_CAPS_RESP,
+    BLE_ATVV_CTL_MIC_OPEN_ERROR = ATVV_CTL_MIC_OPEN_ERROR,
+} ble_atvv_ctl_type_t;
+
+typedef enum
+{
+    BLE_ATVV_USED_CODEC_ADPCM_8KHZ  = 0x0001,
+    BLE_ATVV_USED_CODEC_ADPCM_16KHZ = 0x0002,
+    BLE_ATVV_USED_CODEC_OPUS        = 0x0004,
+} ble_atvv_used_codec_t;
+
+typedef enum
+{
+    BLE_ATVV_ERROR_INVALID_CODEC    = 0x0F01,
+    BLE_ATVV_ERROR_MIC_OPEN_TIMEOUT = 0x0F02,
+    BLE_ATVV_ERROR_INVALID_STATE    = 0x0F03,
+} ble_atvv_error_code_t;
+
+typedef struct ble_atvv_s ble_atvv_t;
+
+typedef struct
+{
+    ble_atvv_evt_type_t type;
+    ble_atvv_t const *  p_atvv;
+    uint16_t            conn_handle;
+    union
+    {
+        struct
+        {
+            ble_atvv_used_codec_t codec;
+        } mic_open;
+        struct
+        {
+            uint16_t peer_version;
+            uint16_t peer_codec_support;
+        } get_caps;
+    } params;
+} ble_atvv_evt_t;
+
+typedef void (*ble_atvv_evt_handler_t)(ble_atvv_evt_t const *p_evt);
+
+struct ble_atvv_s
+{
+    ble_atvv_evt_handler_t event_handler;
+};
+
+ret_code_t ble_atvv_init(ble_atvv_t *p_atvv, ble_atvv_evt_handler_t p_evt_handler);
+ret_code_t ble_atvv_ctl_send(ble_atvv_t const *p_atvv, uint16_t conn_handle, ble_atvv_ctl_type_t type, void *p_param);
+ret_code_t ble_atvv_frame_data_transmit(ble_atvv_t const *p_atvv,
+                                        uint8_t const *p_frame_data,
+                                        uint16_t len,
+                                        uint16_t conn_handle);
+
+#endif // BLE_ATVV_H__
@@ -0,0 +1,15 @@
+/* Stand-in for the SDK header of the same name: the peer ID lookup reported in the ATVV events. */
+#ifndef PEER_MANAGER_H__
+#define PEER_MANAGER_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define PM_PEER_ID_INVALID  0xFFFF
+
+typedef uint16_t pm_peer_id_t;
+
+ret_code_t pm_peer_id_get(uint16_t conn_handle, pm_peer_id_t *p_peer_id);
+
+#endif // PEER_MANAGER_H__
@@ -0,0 +1,5 @@
+/* Stand-in for the header of the same name: the ATVV module takes no resources from it. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#endif /* __RESOURCES_H__ */
@@ -0,0 +1,33 @@
+/* ATVV configuration used by the test: 8 kHz ADPCM frames of 256 samples, as required by ATVV v0.4, streamed to
+ * two peers. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_AUDIO_ENABLED                    1
+#define CONFIG_AUDIO_ATVV_ENABLED               1
+#define CONFIG_AUDIO_CODEC_ADPCM                1
+#define CONFIG_AUDIO_CODEC                      CONFIG_AUDIO_CODEC_ADPCM
+#define CONFIG_AUDIO_SAMPLING_FREQUENCY         8000
+#define CONFIG_AUDIO_FRAME_SIZE_SAMPLES         256
+#define CONFIG_AUDIO_FRAME_SIZE_BYTES           ((CONFIG_AUDIO_FRAME_SIZE_SAMPLES / 2) + 3)
+#define CONFIG_AUDIO_FRAME_HEADROOM             3
+#define CONFIG_AUDIO_SRC_ENABLED                0
+
+#define CONFIG_AUDIO_ATVV_REMOTE_CONTROL_ID     0x01
+#define CONFIG_AUDIO_ATVV_SYNC_INTERVAL         15
+#define CONFIG_AUDIO_ATVV_SEARCH_TIMEOUT        1000
+#define CONFIG_AUDIO_ATVV_CTL_MSG_QUEUE_LEN     2
+#define CONFIG_AUDIO_ATVV_PEER_NUM              2
+#define CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN        20
+
+#define CONFIG_KBD_KEY_COMBO_ENABLED            1
+#define CONFIG_KBD_ATVV_KEY_CHORDS_ENABLED      1
+#define CONFIG_BLE_ATVV_LOG_LEVEL               0
+
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,440 @@
+/**@file
+ *
+ * @brief Test of the ATVV audio frame fragmentation of the ATVV module.
+ *
+ * @details The test includes m_coms_ble_atvv.c. The ATVV Service is replaced by a link model which copies every
+ *          notification while the SoftDevice has a free buffer, and the test frees the buffers at random. The
+ *          audio channel of the communication module is modelled by one queued frame per streaming peer, which
+ *          is handed to m_coms_ble_atvv_audio_send() until it is sent or cannot be sent, and the control message
+ *          queue is processed in between.
+ *
+ *          Two peers stream the same audio frames. The second peer opens the microphone later than the first one,
+ *          so their sequence numbers differ, and the peers are served in turns, one notification each, so their
+ *          frames are in transit at the same time. The first peer closes the microphone between two frames, the
+ *          second one in the middle of a frame.
+ *
+ *          For every peer, the notifications must form complete frames of fragments of the ATVV length. The first
+ *          fragment must be sent from the headroom of the audio frame, with the sequence number of the peer and
+ *          the remote control ID, followed by the frame data. The audio start message must come before the first
+ *          frame, the sync messages must carry the number of frames sent to the peer and the audio stop message
+ *          must come after the last frame.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "nrf_assert.h"
+#include "m_coms.h"         // Stand-ins of the headers next to m_coms_ble_atvv.c, included ahead of it.
+#include "m_coms_ble_atvv_srv.h"
+#include "m_coms_ble_atvv.c"
+
+#define FRAMES          200
+#define PEERS           CONFIG_AUDIO_ATVV_PEER_NUM
+#define SD_BUFFERS      3           /**< SoftDevice notification buffers. */
+#define LOG_SIZE        (FRAMES * PEERS * 16)
+#define FRAME_LEN       (ATVV_HEADER_HEADROOM_LEN + CONFIG_AUDIO_FRAME_SIZE_BYTES)
+#define SEED            42
+
+/**@brief Notification sent to a peer. */
+typedef struct
+{
+    uint16_t            conn_handle;
+    bool                audio;                  /**< True for frame data, false for a control message. */
+    int                 frame;                  /**< Audio frame the data was sent from. */
+    uint8_t const     * p_data;                 /**< Location the data was sent from. */
+    uint16_t            len;
+    uint8_t             data[CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN];
+    ble_atvv_ctl_type_t type;
+    uint32_t            param;
+} packet_t;
+
+/**@brief Peer, with the frame queued for it in the communication module. */
+typedef struct
+{
+    uint16_t        conn_handle;
+    int             open_frame;                 /**< Frame at which the microphone is opened. */
+    int             close_frame;                /**< Frame at which the microphone is closed. */
+    unsigned int    close_fragment;             /**< Fragments of the close frame sent before the close. */
+    int             frame;                      /**< Queued frame, or -1. */
+    uint8_t       * p_data;
+    uint16_t        data_size;
+    unsigned int    fragments;                  /**< Fragments of the queued frame sent. */
+} peer_t;
+
+static peer_t s_peers[PEERS] =
+{
+    { .conn_handle = 0x10, .open_frame = 0,  .close_frame = 150, .close_fragment = 0, .frame = -1 },
+    { .conn_handle = 0x20, .open_frame = 7,  .close_frame = 180, .close_fragment = 2, .frame = -1 },
+};
+
+static ble_atvv_evt_handler_t s_atvv_evt_handler;
+static m_audio_frame_t  s_frame;
+static uint8_t          s_frame_data[FRAMES][CONFIG_AUDIO_FRAME_SIZE_BYTES];
+static int              s_current_frame;
+static unsigned int     s_sd_buffers = SD_BUFFERS;
+static packet_t         s_log[LOG_SIZE];
+static size_t           s_log_count;
+static unsigned int     s_mic_open_evts;
+static unsigned int     s_mic_close_evts;
+
+// ----------------------------------------------------------------------------
+// Stand-ins
+// ----------------------------------------------------------------------------
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id,
+                            app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    (*p_timer_id)->handler = timeout_handler;
+    (*p_timer_id)->running = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    timer_id->p_context = p_context;
+    timer_id->timeout   = timeout_ticks;
+    timer_id->running   = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->running = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t pm_peer_id_get(uint16_t conn_handle, pm_peer_id_t *p_peer_id)
+{
+    *p_peer_id = conn_handle;
+    return NRF_SUCCESS;
+}
+
+ret_code_t event_send(event_type_t event_type, ...)
+{
+    va_list args;
+    int     type;
+
+    va_start(args, event_type);
+    type = va_arg(args, int);
+    va_end(args);
+
+    TEST_CHECK(event_type == EVT_ATVV_STATE);
+    s_mic_open_evts  += (type == EVT_ATVV_STATE_MIC_OPEN);
+    s_mic_close_evts += (type == EVT_ATVV_STATE_MIC_CLOSE);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t ble_atvv_init(ble_atvv_t *p_atvv, ble_atvv_evt_handler_t p_evt_handler)
+{
+    p_atvv->event_handler = p_evt_handler;
+    s_atvv_evt_handler    = p_evt_handler;
+    return NRF_SUCCESS;
+}
+
+/**@brief Take a SoftDevice buffer and log a notification. */
+static packet_t *packet_log(uint16_t conn_handle)
+{
+    packet_t *p_packet;
+
+    if (s_sd_buffers == 0)
+    {
+        return NULL;
+    }
+
+    TEST_CHECK(s_log_count < LOG_SIZE);
+    s_sd_buffers -= 1;
+    p_packet = &s_log[s_log_count++ % LOG_SIZE];
+    memset(p_packet, 0, sizeof(*p_packet));
+    p_packet->conn_handle = conn_handle;
+
+    return p_packet;
+}
+
+ret_code_t ble_atvv_ctl_send(ble_atvv_t const *p_atvv, uint16_t conn_handle, ble_atvv_ctl_type_t type, void *p_param)
+{
+    packet_t *p_packet = packet_log(conn_handle);
+
+    if (p_packet == NULL)
+    {
+        return NRF_ERROR_RESOURCES;
+    }
+
+    p_packet->type  = type;
+    p_packet->param = (uint32_t)(uintptr_t)p_param;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t ble_atvv_frame_data_transmit(ble_atvv_t const *p_atvv,
+                                        uint8_t const *p_frame_data,
+                                        uint16_t len,
+                                        uint16_t conn_handle)
+{
+    packet_t *p_packet;
+
+    TEST_CHECK(len <= CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN);
+
+    p_packet = packet_log(conn_handle);
+    if (p_packet == NULL)
+    {
+        return NRF_ERROR_RESOURCES;
+    }
+
+    p_packet->audio  = true;
+    p_packet->frame  = s_current_frame;
+    p_packet->p_data = p_frame_data;
+    p_packet->len    = len;
+    memcpy(p_packet->data, p_frame_data, len);
+
+    return NRF_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Streaming
+// ----------------------------------------------------------------------------
+
+/**@brief Pass an ATVV Service event to the module. */
+static void atvv_evt(peer_t const *p_peer, ble_atvv_evt_type_t type)
+{
+    ble_atvv_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.type                   = type;
+    evt.conn_handle            = p_peer->conn_handle;
+    evt.params.mic_open.codec  = BLE_ATVV_USED_CODEC_ADPCM_8KHZ;
+
+    s_atvv_evt_handler(&evt);
+}
+
+/**@brief Hand one fragment of the queued frame to the module. Returns true if the frame is still queued. */
+static bool peer_process(peer_t *p_peer)
+{
+    m_coms_data_process_status_t status;
+    uint16_t                     bytes_sent = 0;
+
+    s_current_frame = p_peer->frame;
+    TEST_CHECK(m_coms_ble_atvv_audio_send(p_peer->conn_handle,
+                                          p_peer->p_data,
+                                          p_peer->data_size,
+                                          &bytes_sent,
+                                          &status) == NRF_SUCCESS);
+    switch (status)
+    {
+        case M_COMS_STATUS_SUCCESS:
+            p_peer->p_data    += bytes_sent;
+            p_peer->data_size -= bytes_sent;
+            p_peer->fragments += 1;
+
+            if ((p_peer->frame == p_peer->close_frame) && (p_peer->fragments == p_peer->close_fragment))
+            {
+                atvv_evt(p_peer, BLE_ATVV_EVT_MIC_CLOSE);
+            }
+            break;
+
+        case M_COMS_STATUS_CANNOT_SEND:
+            // Dropped by the communication module.
+            p_peer->data_size = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    if (p_peer->data_size == 0)
+    {
+        p_peer->frame = -1;
+    }
+
+    return (p_peer->frame >= 0);
+}
+
+/**@brief Encode a frame and send it to the streaming peers. */
+static void frame_stream(int frame)
+{
+    uint16_t conn_handles[PEERS];
+    size_t   count;
+    size_t   i;
+    size_t   j;
+    bool     busy;
+
+    for (i = 0; i < CONFIG_AUDIO_FRAME_SIZE_BYTES; i++)
+    {
+        s_frame_data[frame][i] = rand();
+    }
+    memcpy(s_frame.data, s_frame_data[frame], sizeof(s_frame.data));
+    memset(s_frame.headroom, 0xEE, sizeof(s_frame.headroom));
+    s_frame.data_size = CONFIG_AUDIO_FRAME_SIZE_BYTES;
+
+    count = m_coms_ble_atvv_audio_peers_get(conn_handles, ARRAY_SIZE(conn_handles));
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < PEERS; j++)
+        {
+            if (s_peers[j].conn_handle == conn_handles[i])
+            {
+                s_peers[j].frame     = frame;
+                s_peers[j].p_data    = s_frame.data;
+                s_peers[j].data_size = s_frame.data_size;
+                s_peers[j].fragments = 0;
+            }
+        }
+    }
+
+    do
+    {
+        busy = false;
+
+        for (j = 0; j < PEERS; j++)
+        {
+            if (s_peers[j].frame >= 0)
+            {
+                busy |= peer_process(&s_peers[j]);
+            }
+        }
+
+        busy |= (m_coms_ble_atvv_ctl_pkt_queue_process() != NRF_ERROR_NOT_FOUND);
+
+        s_sd_buffers = MIN(s_sd_buffers + (rand() % 3), SD_BUFFERS);
+    } while (busy);
+}
+
+/**@brief Check the notifications received by a peer. */
+static unsigned int peer_check(peer_t const *p_peer)
+{
+    int          first_frame = p_peer->open_frame + 1;  // The first frame is dropped while audio start is sent.
+    int          last_frame  = p_peer->close_frame - ((p_peer->close_fragment == 0) ? 1 : 0);
+    unsigned int frames      = 0;
+    unsigned int offset      = 0;
+    bool         started     = false;
+    bool         stopped     = false;
+    size_t       i;
+
+    for (i = 0; i < s_log_count; i++)
+    {
+        packet_t const *p_packet = &s_log[i];
+
+        if (p_packet->conn_handle != p_peer->conn_handle)
+        {
+            continue;
+        }
+
+        if (!p_packet->audio)
+        {
+            switch (p_packet->type)
+            {
+                case BLE_ATVV_CTL_AUDIO_START:
+                    TEST_CHECK(!started && (frames == 0));
+                    started = true;
+                    break;
+
+                case BLE_ATVV_CTL_AUDIO_SYNC:
+                    TEST_CHECK((offset == 0) && (p_packet->param == frames));
+                    TEST_CHECK((frames % CONFIG_AUDIO_ATVV_SYNC_INTERVAL) == 0);
+                    break;
+
+                case BLE_ATVV_CTL_AUDIO_STOP:
+                    TEST_CHECK(started && !stopped && (offset == 0));
+                    stopped = true;
+                    break;
+
+                default:
+                    TEST_CHECK(false);
+                    break;
+            }
+            continue;
+        }
+
+        TEST_CHECK(started && !stopped);
+        TEST_CHECK(p_packet->frame == first_frame + (int)frames);
+        TEST_CHECK(p_packet->len == MIN(FRAME_LEN - offset, CONFIG_AUDIO_ATVV_FRAME_FRAG_LEN));
+
+        if (offset == 0)
+        {
+            TEST_CHECK(p_packet->p_data == s_frame.headroom);
+            TEST_CHECK(p_packet->data[0] == MSB_16(frames));
+            TEST_CHECK(p_packet->data[1] == LSB_16(frames));
+            TEST_CHECK(p_packet->data[2] == CONFIG_AUDIO_ATVV_REMOTE_CONTROL_ID);
+            TEST_CHECK(memcmp(&p_packet->data[ATVV_HEADER_HEADROOM_LEN],
+                              s_frame_data[p_packet->frame],
+                              p_packet->len - ATVV_HEADER_HEADROOM_LEN) == 0);
+        }
+        else
+        {
+            TEST_CHECK(memcmp(p_packet->data,
+                              &s_frame_data[p_packet->frame][offset - ATVV_HEADER_HEADROOM_LEN],
+                              p_packet->len) == 0);
+        }
+
+        offset += p_packet->len;
+        if (offset == FRAME_LEN)
+        {
+            offset  = 0;
+            frames += 1;
+        }
+    }
+
+    TEST_CHECK(started && stopped && (offset == 0));
+    TEST_CHECK(frames == (unsigned int)(last_frame - first_frame + 1));
+
+    return frames;
+}
+
+int main(void)
+{
+    unsigned int interleaved = 0;
+    uint16_t     last_conn_handle = BLE_CONN_HANDLE_INVALID;
+    int          frame;
+    size_t       i;
+
+    srand(SEED);
+
+    TEST_CHECK(m_coms_ble_atvv_init() == NRF_SUCCESS);
+    for (i = 0; i < PEERS; i++)
+    {
+        atvv_evt(&s_peers[i], BLE_ATVV_EVT_ENABLED);
+    }
+
+    for (frame = 0; frame < FRAMES; frame++)
+    {
+        for (i = 0; i < PEERS; i++)
+        {
+            if (frame == s_peers[i].open_frame)
+            {
+                atvv_evt(&s_peers[i], BLE_ATVV_EVT_MIC_OPEN);
+            }
+            if ((frame == s_peers[i].close_frame) && (s_peers[i].close_fragment == 0))
+            {
+                atvv_evt(&s_peers[i], BLE_ATVV_EVT_MIC_CLOSE);
+            }
+        }
+
+        frame_stream(frame);
+    }
+
+    TEST_CHECK(m_coms_ble_atvv_audio_peers_get(NULL, 0) == 0);
+    TEST_CHECK((s_mic_open_evts == PEERS) && (s_mic_close_evts == PEERS));
+
+    for (i = 0; i < s_log_count; i++)
+    {
+        if (s_log[i].audio)
+        {
+            interleaved     += (last_conn_handle != BLE_CONN_HANDLE_INVALID) &&
+                               (last_conn_handle != s_log[i].conn_handle);
+            last_conn_handle = s_log[i].conn_handle;
+        }
+    }
+    TEST_CHECK(interleaved > FRAMES);
+
+    for (i = 0; i < PEERS; i++)
+    {
+        printf("peer 0x%02X: %u frames\n", s_peers[i].conn_handle, peer_check(&s_peers[i]));
+    }
+    printf("%zu notifications, %u changes of peer between fragments\n", s_log_count, interleaved);
+
+    return TEST_RESULT();
+}
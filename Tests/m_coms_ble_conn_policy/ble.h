@@ -0,0 +1,70 @@
+/* Stand-in for the SoftDevice header of the same name: the GAP events, parameters and PHY update used by the
+ * connection parameter policy. */
+#ifndef BLE_H__
+#define BLE_H__
+
+#include <stdint.h>
+
+#include "nrf_error.h"
+
+#define BLE_CONN_HANDLE_INVALID         0xFFFF
+#define BLE_ERROR_INVALID_CONN_HANDLE   0x3002
+
+#define BLE_GAP_PHY_1MBPS               0x01
+#define BLE_GAP_PHY_2MBPS               0x02
+
+enum
+{
+    BLE_GAP_EVT_CONNECTED           = 0x10,
+    BLE_GAP_EVT_DISCONNECTED        = 0x11,
+    BLE_GAP_EVT_CONN_PARAM_UPDATE   = 0x12,
+};
+
+typedef struct
+{
+    uint16_t min_conn_interval;
+    uint16_t max_conn_interval;
+    uint16_t slave_latency;
+    uint16_t conn_sup_timeout;
+} ble_gap_conn_params_t;
+
+typedef struct
+{
+    uint8_t tx_phys;
+    uint8_t rx_phys;
+} ble_gap_phys_t;
+
+typedef struct
+{
+    uint16_t evt_id;
+    uint16_t evt_len;
+} ble_evt_hdr_t;
+
+typedef struct
+{
+    uint16_t conn_handle;
+    union
+    {
+        struct
+        {
+            ble_gap_conn_params_t conn_params;
+        } connected;
+        struct
+        {
+            ble_gap_conn_params_t conn_params;
+        } conn_param_update;
+    } params;
+} ble_gap_evt_t;
+
+typedef struct
+{
+    ble_evt_hdr_t header;
+    union
+    {
+        ble_gap_evt_t gap_evt;
+    } evt;
+} ble_evt_t;
+
+uint32_t sd_ble_gap_phy_update(uint16_t conn_handle, ble_gap_phys_t const *p_gap_phys);
+
+#endif // BLE_H__
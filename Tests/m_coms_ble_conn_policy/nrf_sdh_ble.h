@@ -0,0 +1,13 @@
+/* Stand-in for the SDK header of the same name: the observer is a pointer to its handler, which the test calls
+ * with the events of the simulated link. */
+#ifndef NRF_SDH_BLE_H__
+#define NRF_SDH_BLE_H__
+
+#include "ble.h"
+
+typedef void (*nrf_sdh_ble_evt_handler_t)(ble_evt_t const *p_ble_evt, void *p_context);
+
+#define NRF_SDH_BLE_OBSERVER(_name, _prio, _handler, _context) \
+    static nrf_sdh_ble_evt_handler_t const _name = (_handler)
+
+#endif // NRF_SDH_BLE_H__
@@ -0,0 +1,9 @@
+/* Stand-in for the header of the same name: the BLE observer priorities. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#define BLE_OBSERVER_PRIORITY_HIGH      1
+#define BLE_OBSERVER_PRIORITY_DEFAULT   2
+#define BLE_OBSERVER_PRIORITY_LOW       3
+
+#endif /* __RESOURCES_H__ */
@@ -0,0 +1,24 @@
+/* Connection parameter policy configuration used by the test: the profiles, the downgrade delay and the PHY
+ * settings come from the board configuration through the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_CONN_POLICY_ENABLED                      1
+#define CONFIG_BLE_CONN_POLICY_LOG_LEVEL                0
+
+#define CONFIG_MIN_CONN_INTERVAL                        ROUNDED_DIV(100u * CONFIG_MIN_CONN_INTERVAL_MS, 125)
+#define CONFIG_MAX_CONN_INTERVAL                        ROUNDED_DIV(100u * CONFIG_MAX_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_SUP_TIMEOUT                         ROUNDED_DIV(CONFIG_CONN_SUP_TIMEOUT_MS, 10)
+
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL  ROUNDED_DIV(100u * CONFIG_CONN_POLICY_AIR_MOUSE_MIN_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL  ROUNDED_DIV(100u * CONFIG_CONN_POLICY_AIR_MOUSE_MAX_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL  ROUNDED_DIV(100u * CONFIG_CONN_POLICY_HID_VOICE_MIN_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL  ROUNDED_DIV(100u * CONFIG_CONN_POLICY_HID_VOICE_MAX_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_ATVV_VOICE_MIN_CONN_INTERVAL_MS, 125)
+#define CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL ROUNDED_DIV(100u * CONFIG_CONN_POLICY_ATVV_VOICE_MAX_CONN_INTERVAL_MS, 125)
+
+#endif // SR3_CONFIG_H
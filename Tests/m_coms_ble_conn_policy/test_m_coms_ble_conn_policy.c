@@ -0,0 +1,283 @@
+/**@file
+ *
+ * @brief Connection parameter policy against a simulated link.
+ *
+ * @details The test includes m_coms_ble_conn_policy.c. The Connection Parameters module and the SoftDevice are
+ *          replaced by functions which record the requests, and the link is driven through the BLE observer of
+ *          the module. The profiles and the downgrade delay are the board's.
+ *
+ *          The test checks that a more demanding traffic type is requested at once and a less demanding one only
+ *          when the downgrade timer expires, that a downgrade is cancelled when the traffic comes back, that
+ *          nothing is requested while the Connection Parameters module negotiates the same parameters or when
+ *          the negotiated parameters already suit the traffic, and that 2 Mbps PHY is requested once per link.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "m_coms_ble_conn_policy.c"
+
+#define CONN_HANDLE         3
+
+static const ble_gap_conn_params_t s_idle_params =
+{
+    .min_conn_interval  = CONFIG_MIN_CONN_INTERVAL,
+    .max_conn_interval  = CONFIG_MAX_CONN_INTERVAL,
+    .slave_latency      = CONFIG_SLAVE_LATENCY,
+    .conn_sup_timeout   = CONFIG_CONN_SUP_TIMEOUT,
+};
+
+/**@brief Parameters chosen by the central when the link is established: 30 ms, no latency. */
+static const ble_gap_conn_params_t s_central_params =
+{
+    .min_conn_interval  = 24,
+    .max_conn_interval  = 24,
+    .slave_latency      = 0,
+    .conn_sup_timeout   = 400,
+};
+
+static app_timer_timeout_handler_t  s_timer_handler;
+static bool                         s_timer_active;
+static uint32_t                     s_timer_ticks;
+
+static unsigned int                 s_param_requests;
+static ble_gap_conn_params_t        s_param_request;
+static ret_code_t                   s_param_status;
+static unsigned int                 s_phy_requests;
+static ble_gap_phys_t               s_phy_request;
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(mode == APP_TIMER_MODE_SINGLE_SHOT);
+    s_timer_handler = timeout_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    TEST_CHECK(!s_timer_active);
+    s_timer_active = true;
+    s_timer_ticks  = timeout_ticks;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    s_timer_active = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t ble_conn_params_change_conn_params(uint16_t conn_handle, ble_gap_conn_params_t *p_new_params)
+{
+    TEST_CHECK(conn_handle == CONN_HANDLE);
+    s_param_requests++;
+    s_param_request = *p_new_params;
+    return s_param_status;
+}
+
+uint32_t sd_ble_gap_phy_update(uint16_t conn_handle, ble_gap_phys_t const *p_gap_phys)
+{
+    TEST_CHECK(conn_handle == CONN_HANDLE);
+    s_phy_requests++;
+    s_phy_request = *p_gap_phys;
+    return NRF_SUCCESS;
+}
+
+/**@brief Fire the downgrade timer. */
+static void timer_expire(void)
+{
+    TEST_CHECK(s_timer_active);
+    s_timer_active = false;
+    s_timer_handler(NULL);
+}
+
+static void link_connect(const ble_gap_conn_params_t *p_params)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                               = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle                     = CONN_HANDLE;
+    evt.evt.gap_evt.params.connected.conn_params    = *p_params;
+    m_coms_ble_conn_policy_observer(&evt, NULL);
+}
+
+/**@brief Report the parameters accepted by the central. The interval is reported in both fields. */
+static void link_update(const ble_gap_conn_params_t *p_params)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                                       = BLE_GAP_EVT_CONN_PARAM_UPDATE;
+    evt.evt.gap_evt.conn_handle                             = CONN_HANDLE;
+    evt.evt.gap_evt.params.conn_param_update.conn_params    = *p_params;
+    evt.evt.gap_evt.params.conn_param_update.conn_params.min_conn_interval = p_params->max_conn_interval;
+    m_coms_ble_conn_policy_observer(&evt, NULL);
+}
+
+static void link_disconnect(void)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    m_coms_ble_conn_policy_observer(&evt, NULL);
+}
+
+/**@brief Check that the last parameter request was the one of the given traffic type. */
+static bool requested(m_coms_ble_traffic_t traffic)
+{
+    return (memcmp(&s_param_request, &s_profiles[traffic].conn_params, sizeof(s_param_request)) == 0);
+}
+
+/**@brief Upgrades are requested at once, downgrades after the delay, and a returning traffic cancels them. */
+static void test_upgrade_downgrade(void)
+{
+    unsigned int requests;
+
+    TEST_CHECK(m_coms_ble_conn_policy_init(&s_idle_params) == NRF_SUCCESS);
+    s_param_requests = 0;
+    s_phy_requests   = 0;
+
+    // The Connection Parameters module negotiates the idle parameters on a new link: no request of our own.
+    link_connect(&s_central_params);
+    TEST_CHECK(s_param_requests == 0);
+    link_update(&s_idle_params);
+
+    // Upgrade.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_param_requests == 1);
+    TEST_CHECK(requested(M_COMS_BLE_TRAFFIC_AIR_MOUSE));
+    TEST_CHECK(!s_timer_active);
+    TEST_CHECK(s_phy_requests == (CONFIG_CONN_POLICY_AIR_MOUSE_PHY_2MBPS ? 1 : 0));
+
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_HID_VOICE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_param_requests == 2);
+    TEST_CHECK(requested(M_COMS_BLE_TRAFFIC_HID_VOICE));
+    link_update(&s_profiles[M_COMS_BLE_TRAFFIC_HID_VOICE].conn_params);
+
+    // Delayed downgrade.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_HID_VOICE, false) == NRF_SUCCESS);
+    TEST_CHECK(s_param_requests == 2);
+    TEST_CHECK(s_timer_active);
+    TEST_CHECK(s_timer_ticks == APP_TIMER_TICKS(CONFIG_CONN_POLICY_DOWNGRADE_DELAY_MS));
+    timer_expire();
+    TEST_CHECK(s_param_requests == 3);
+    TEST_CHECK(requested(M_COMS_BLE_TRAFFIC_AIR_MOUSE));
+    link_update(&s_profiles[M_COMS_BLE_TRAFFIC_AIR_MOUSE].conn_params);
+
+    // A downgrade cancelled by the traffic coming back requests nothing.
+    requests = s_param_requests;
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, false) == NRF_SUCCESS);
+    TEST_CHECK(s_timer_active);
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, true) == NRF_SUCCESS);
+    TEST_CHECK(!s_timer_active);
+    TEST_CHECK(s_param_requests == requests);
+
+    // Down to idle.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, false) == NRF_SUCCESS);
+    timer_expire();
+    TEST_CHECK(s_param_requests == requests + 1);
+    TEST_CHECK(requested(M_COMS_BLE_TRAFFIC_IDLE));
+
+    // The idle traffic is not a type which can be switched.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_IDLE, true) == NRF_ERROR_INVALID_PARAM);
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_COUNT, true) == NRF_ERROR_INVALID_PARAM);
+
+    link_disconnect();
+
+    printf("Upgrade and downgrade: %u parameter requests, %u PHY requests\n", s_param_requests, s_phy_requests);
+}
+
+/**@brief Nothing is requested when the parameters are already being negotiated or already suit the traffic. */
+static void test_skips(void)
+{
+    ble_gap_conn_params_t params;
+
+    TEST_CHECK(m_coms_ble_conn_policy_init(&s_idle_params) == NRF_SUCCESS);
+    s_param_requests = 0;
+
+    // Voice starts before the link: its parameters are requested on connection, not when the traffic is set.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_ATVV_VOICE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_param_requests == 0);
+    link_connect(&s_central_params);
+    TEST_CHECK(s_param_requests == 1);
+    TEST_CHECK(requested(M_COMS_BLE_TRAFFIC_ATVV_VOICE));
+
+    // The Connection Parameters module keeps the requested parameters as its preferred ones and negotiates them
+    // on the next link by itself.
+    link_disconnect();
+    link_connect(&s_central_params);
+    TEST_CHECK(s_param_requests == 1);
+    link_update(&s_profiles[M_COMS_BLE_TRAFFIC_ATVV_VOICE].conn_params);
+
+    // The central settles on an interval in the air mouse range with the air mouse latency before the downgrade
+    // delay expires: nothing to request.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_AIR_MOUSE, true) == NRF_SUCCESS);
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_ATVV_VOICE, false) == NRF_SUCCESS);
+    params                   = s_profiles[M_COMS_BLE_TRAFFIC_AIR_MOUSE].conn_params;
+    params.max_conn_interval = params.min_conn_interval;
+    link_update(&params);
+    timer_expire();
+    TEST_CHECK(s_param_requests == 1);
+
+    // A busy procedure is retried by the Connection Parameters module and is not an error.
+    s_param_status = NRF_ERROR_BUSY;
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_ATVV_VOICE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_param_requests == 2);
+    TEST_CHECK(s_conn_params_pending);
+    s_param_status = NRF_SUCCESS;
+
+    link_disconnect();
+}
+
+/**@brief 2 Mbps PHY is requested once per link, by the first traffic type which wants it. */
+static void test_phy(void)
+{
+    unsigned int expected = (CONFIG_PHY_TX_2MBPS && CONFIG_PHY_RX_2MBPS) ? 1 : 0;
+
+    TEST_CHECK(m_coms_ble_conn_policy_init(&s_idle_params) == NRF_SUCCESS);
+    s_phy_requests = 0;
+
+    link_connect(&s_central_params);
+    link_update(&s_idle_params);
+    TEST_CHECK(s_phy_requests == 0);
+
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_HID_VOICE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_phy_requests == (CONFIG_CONN_POLICY_HID_VOICE_PHY_2MBPS ? expected : 0));
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_ATVV_VOICE, true) == NRF_SUCCESS);
+    TEST_CHECK(s_phy_requests == ((CONFIG_CONN_POLICY_HID_VOICE_PHY_2MBPS ||
+                                   CONFIG_CONN_POLICY_ATVV_VOICE_PHY_2MBPS) ? expected : 0));
+    if (s_phy_requests != 0)
+    {
+        TEST_CHECK((s_phy_request.tx_phys == BLE_GAP_PHY_2MBPS) && (s_phy_request.rx_phys == BLE_GAP_PHY_2MBPS));
+    }
+
+    // A downgrade pending at disconnection is dropped; the new link gets its own PHY request.
+    TEST_CHECK(m_coms_ble_conn_policy_traffic_set(M_COMS_BLE_TRAFFIC_ATVV_VOICE, false) == NRF_SUCCESS);
+    TEST_CHECK(s_timer_active);
+    link_disconnect();
+    TEST_CHECK(!s_timer_active);
+
+    s_phy_requests = 0;
+    link_connect(&s_central_params);
+    TEST_CHECK(s_phy_requests == (CONFIG_CONN_POLICY_HID_VOICE_PHY_2MBPS ? expected : 0));
+
+    printf("2 Mbps PHY: %u request(s) on the new link\n", s_phy_requests);
+
+    link_disconnect();
+}
+
+int main(void)
+{
+    s_param_status = NRF_SUCCESS;
+
+    test_upgrade_downgrade();
+    test_skips();
+    test_phy();
+
+    return TEST_RESULT();
+}
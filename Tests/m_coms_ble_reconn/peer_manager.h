@@ -0,0 +1,46 @@
+/* Stand-in for the SDK header of the same name: the events followed by the reconnection strategy. */
+#ifndef PEER_MANAGER_H__
+#define PEER_MANAGER_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define PM_PEER_ID_INVALID  0xFFFF
+
+typedef uint16_t pm_peer_id_t;
+
+typedef enum
+{
+    PM_EVT_BONDED_PEER_CONNECTED,
+    PM_EVT_CONN_SEC_SUCCEEDED,
+    PM_EVT_PEER_DELETE_SUCCEEDED,
+    PM_EVT_PEERS_DELETE_SUCCEEDED,
+} pm_evt_id_t;
+
+typedef enum
+{
+    PM_LINK_SECURED_PROCEDURE_ENCRYPTION,
+    PM_LINK_SECURED_PROCEDURE_BONDING,
+    PM_LINK_SECURED_PROCEDURE_PAIRING,
+} pm_conn_sec_procedure_t;
+
+typedef struct
+{
+    pm_evt_id_t     evt_id;
+    pm_peer_id_t    peer_id;
+    uint16_t        conn_handle;
+    union
+    {
+        struct
+        {
+            pm_conn_sec_procedure_t procedure;
+        } conn_sec_succeeded;
+    } params;
+} pm_evt_t;
+
+typedef void (*pm_evt_handler_t)(pm_evt_t const *p_event);
+
+ret_code_t pm_register(pm_evt_handler_t event_handler);
+
+#endif // PEER_MANAGER_H__
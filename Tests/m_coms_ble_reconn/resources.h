@@ -0,0 +1,9 @@
+/* Stand-in for the header of the same name: the shutdown priorities. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#define SHUTDOWN_PRIORITY_EARLY         0
+#define SHUTDOWN_PRIORITY_DEFAULT       1
+#define SHUTDOWN_PRIORITY_LATE          2
+
+#endif /* __RESOURCES_H__ */
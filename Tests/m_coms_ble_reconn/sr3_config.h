@@ -0,0 +1,16 @@
+/* Reconnection strategy configuration used by the test: three bonds, with power management. The advertising
+ * timeout and the fallback level come from the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_MAX_BONDS                    3
+#define CONFIG_ADV_RECONN_ENABLED           1
+#define CONFIG_BLE_RECONN_LOG_LEVEL         0
+
+#define CONFIG_PWR_MGMT_ENABLED             1
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,435 @@
+/**@file
+ *
+ * @brief Simulation of multi-host reconnection with the adaptive reconnection strategy.
+ *
+ * @details The test includes m_coms_ble_reconn.c. A household of three bonded hosts is simulated. Each time the
+ *          remote reconnects, one of the hosts is the one to connect to, at random with fixed odds. The host
+ *          answers directed advertising, if it accepts it, and whitelist advertising after exponentially
+ *          distributed delays; an attempt fails when the delay exceeds the attempt duration. The hosts are ranked
+ *          by their last connection, like in Peer Manager.
+ *
+ *          Each scenario is run with the fixed sequence used without the strategy, which targets the hosts from
+ *          the most recent one with one method, and with the plans of the strategy, on the same random trace. The
+ *          strategy must not be slower on average and must almost never run out of attempts.
+ *
+ *          The persistence test checks that the statistics are stored in flash at shutdown only when they have
+ *          changed, that the shutdown waits for the write, and that they are loaded back after a restart unless
+ *          the stored record does not match the configuration.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "m_coms_ble_reconn.c"
+
+#define HOSTS               CONFIG_MAX_BONDS
+#define RECONNECTIONS       20000
+#define SEED                42
+#define NEVER               (1u << 30)
+
+/**@brief Bonded host. */
+typedef struct
+{
+    double  odds;               /**< Probability of being the host to connect to. */
+    bool    directed;           /**< True if the host accepts directed advertising. */
+    double  directed_latency;   /**< Mean time to connect with directed advertising [ms]. */
+    double  whitelist_latency;  /**< Mean time to connect with whitelist advertising [ms]. */
+} host_t;
+
+typedef struct
+{
+    double          time;       /**< Mean time to connect [ms]. */
+    unsigned int    failures;   /**< Reconnections which ran out of attempts. */
+} result_t;
+
+static uint64_t             s_now;                  /**< Time [ms]. */
+static pm_evt_handler_t     s_pm_evt_handler;
+static fds_cb_t             s_fds_evt_handler;
+static pm_peer_id_t         s_rank_order[HOSTS];    /**< Hosts by rank, the least recently used first. */
+
+static __ALIGN(4) uint8_t   s_flash[sizeof(s_peers)];
+static fds_header_t         s_flash_header;
+static bool                 s_flash_record;
+static ret_code_t           s_flash_write_status;
+static unsigned int         s_flash_writes;
+static unsigned int         s_flash_gcs;
+static fds_evt_t            s_fds_evt;
+static unsigned int         s_shutdowns;
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(s_now * APP_TIMER_CLOCK_FREQ / 1000) & 0xFFFFFF;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & 0xFFFFFF;
+}
+
+ret_code_t pm_register(pm_evt_handler_t event_handler)
+{
+    s_pm_evt_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t fds_register(fds_cb_t cb)
+{
+    s_fds_evt_handler = cb;
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t *p_desc,
+                           fds_find_token_t *p_token)
+{
+    TEST_CHECK((file_id == M_COMS_BLE_RECONN_FILE_ID) && (record_key == M_COMS_BLE_RECONN_RECORD_KEY));
+    return s_flash_record ? FDS_SUCCESS : FDS_ERR_NOT_FOUND;
+}
+
+ret_code_t fds_record_open(fds_record_desc_t *p_desc, fds_flash_record_t *p_flash_record)
+{
+    p_flash_record->p_header = &s_flash_header;
+    p_flash_record->p_data   = s_flash;
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_close(fds_record_desc_t *p_desc)
+{
+    return FDS_SUCCESS;
+}
+
+static ret_code_t flash_write(fds_record_t const *p_record, fds_evt_id_t evt_id)
+{
+    s_flash_writes++;
+
+    if (s_flash_write_status != FDS_SUCCESS)
+    {
+        return s_flash_write_status;
+    }
+
+    TEST_CHECK(p_record->data.length_words * sizeof(uint32_t) <= sizeof(s_flash));
+    memcpy(s_flash, p_record->data.p_data, p_record->data.length_words * sizeof(uint32_t));
+    s_flash_header.length_words = p_record->data.length_words;
+    s_flash_record              = true;
+
+    memset(&s_fds_evt, 0, sizeof(s_fds_evt));
+    s_fds_evt.id                = evt_id;
+    s_fds_evt.result            = FDS_SUCCESS;
+    s_fds_evt.write.file_id     = p_record->file_id;
+    s_fds_evt.write.record_key  = p_record->key;
+
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_write(fds_record_desc_t *p_desc, fds_record_t const *p_record)
+{
+    return flash_write(p_record, FDS_EVT_WRITE);
+}
+
+ret_code_t fds_record_update(fds_record_desc_t *p_desc, fds_record_t const *p_record)
+{
+    return flash_write(p_record, FDS_EVT_UPDATE);
+}
+
+ret_code_t fds_gc(void)
+{
+    s_flash_gcs++;
+    return FDS_SUCCESS;
+}
+
+void nrf_pwr_mgmt_shutdown(nrf_pwr_mgmt_shutdown_t shutdown_type)
+{
+    TEST_CHECK(shutdown_type == NRF_PWR_MGMT_SHUTDOWN_CONTINUE);
+    s_shutdowns++;
+}
+
+static double uniform(void)
+{
+    return rand() / (RAND_MAX + 1.0);
+}
+
+static double exponential(double mean)
+{
+    return -mean * log(1.0 - uniform());
+}
+
+/**@brief Pick the host to connect to. */
+static pm_peer_id_t host_pick(host_t const *p_hosts)
+{
+    double x = uniform();
+
+    for (pm_peer_id_t id = 0; id < HOSTS - 1; id++)
+    {
+        if (x < p_hosts[id].odds)
+        {
+            return id;
+        }
+        x -= p_hosts[id].odds;
+    }
+
+    return HOSTS - 1;
+}
+
+/**@brief Time to connect with the given attempt, or a negative value if the attempt fails. */
+static double attempt_run(host_t const *p_hosts, pm_peer_id_t target, m_coms_ble_reconn_attempt_t const *p_attempt)
+{
+    host_t const *p_host = &p_hosts[target];
+    double        latency;
+
+    if (p_attempt->peer_id != target)
+    {
+        return -1.0;
+    }
+
+    if (p_attempt->method == M_COMS_BLE_RECONN_DIRECTED)
+    {
+        if (!p_host->directed)
+        {
+            return -1.0;
+        }
+        latency = exponential(p_host->directed_latency);
+    }
+    else
+    {
+        latency = exponential(p_host->whitelist_latency);
+    }
+
+    return (latency < s_method_duration[p_attempt->method]) ? latency : -1.0;
+}
+
+/**@brief Reconnect with the fixed sequence. Returns the time to connect, negative if all attempts failed. */
+static double fixed_reconnect(host_t const *p_hosts, pm_peer_id_t target, bool directed_allowed)
+{
+    m_coms_ble_reconn_attempt_t attempt;
+    double                      time = 0.0;
+
+    attempt.method = directed_allowed ? M_COMS_BLE_RECONN_DIRECTED : M_COMS_BLE_RECONN_WHITELIST;
+
+    for (int i = HOSTS - 1; i >= 0; i--)
+    {
+        attempt.peer_id = s_rank_order[i];
+
+        double latency = attempt_run(p_hosts, target, &attempt);
+        if (latency >= 0.0)
+        {
+            return time + latency;
+        }
+        time += s_method_duration[attempt.method];
+    }
+
+    return -time;
+}
+
+/**@brief Reconnect with the plan of the strategy. Returns the time to connect, negative if all attempts failed. */
+static double adaptive_reconnect(host_t const *p_hosts, pm_peer_id_t target, bool directed_allowed)
+{
+    unsigned int attempts = m_coms_ble_reconn_plan(s_rank_order, HOSTS, HOSTS, directed_allowed);
+    uint64_t     start    = s_now;
+    double       time     = 0.0;
+
+    for (unsigned int i = 0; i < attempts; i++)
+    {
+        m_coms_ble_reconn_attempt_t attempt;
+
+        TEST_CHECK(m_coms_ble_reconn_attempt_get(i, &attempt) == NRF_SUCCESS);
+
+        s_now = start + (uint64_t)time;
+        m_coms_ble_reconn_attempt_started(i);
+
+        double latency = attempt_run(p_hosts, target, &attempt);
+        if (latency >= 0.0)
+        {
+            s_now = start + (uint64_t)(time + latency);
+            m_coms_ble_reconn_attempt_succeeded();
+            return time + latency;
+        }
+        time += s_method_duration[attempt.method];
+    }
+
+    s_now = start + (uint64_t)time;
+    return -time;
+}
+
+/**@brief Connection to the given host, as reported by Peer Manager. */
+static void host_connected(pm_peer_id_t peer_id)
+{
+    pm_evt_t     evt;
+    unsigned int i;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_id  = PM_EVT_BONDED_PEER_CONNECTED;
+    evt.peer_id = peer_id;
+    s_pm_evt_handler(&evt);
+
+    for (i = 0; s_rank_order[i] != peer_id; i++)
+    {
+    }
+    for (; i < HOSTS - 1; i++)
+    {
+        s_rank_order[i] = s_rank_order[i + 1];
+    }
+    s_rank_order[HOSTS - 1] = peer_id;
+}
+
+/**@brief Run reconnections with the fixed sequence or with the strategy. The household changes at the given one. */
+static result_t reconnections_run(host_t const *p_hosts, host_t const *p_hosts_later, unsigned int change_at,
+                                  bool directed_allowed, bool adaptive)
+{
+    result_t result = { 0 };
+
+    for (pm_peer_id_t id = 0; id < HOSTS; id++)
+    {
+        s_rank_order[id] = id;
+    }
+
+    memset(s_flash, 0, sizeof(s_flash));
+    s_flash_record = false;
+    TEST_CHECK(m_coms_ble_reconn_init() == NRF_SUCCESS);
+
+    for (unsigned int i = 0; i < RECONNECTIONS; i++)
+    {
+        host_t const *p_household = (i < change_at) ? p_hosts : p_hosts_later;
+        pm_peer_id_t  target;
+        double        time;
+
+        // Same host and same delays with the fixed sequence and with the strategy.
+        srand(SEED + i);
+        target = host_pick(p_household);
+
+        time = adaptive ? adaptive_reconnect(p_household, target, directed_allowed) :
+                          fixed_reconnect(p_household, target, directed_allowed);
+
+        if (time >= 0.0)
+        {
+            host_connected(target);
+        }
+        else
+        {
+            result.failures++;
+            time = -time;
+        }
+
+        result.time += time / RECONNECTIONS;
+    }
+
+    return result;
+}
+
+static void scenario_run(char const *p_name, host_t const *p_hosts, host_t const *p_hosts_later,
+                         unsigned int change_at, bool directed_allowed)
+{
+    result_t fixed    = reconnections_run(p_hosts, p_hosts_later, change_at, directed_allowed, false);
+    result_t adaptive = reconnections_run(p_hosts, p_hosts_later, change_at, directed_allowed, true);
+
+    printf("%-38s fixed %6.0f ms (%5u failed)   adaptive %6.0f ms (%5u failed)\n",
+           p_name, fixed.time, fixed.failures, adaptive.time, adaptive.failures);
+
+    TEST_CHECK(adaptive.time <= fixed.time * 1.01);
+    TEST_CHECK(adaptive.failures <= RECONNECTIONS / 1000);
+}
+
+static void test_scenarios(void)
+{
+    static const host_t main_tv[HOSTS] =
+    {
+        { 0.70, true,  30, 400 },
+        { 0.20, true,  30, 400 },
+        { 0.10, true,  30, 400 },
+    };
+    static const host_t main_tv_later[HOSTS] =
+    {
+        { 0.10, true,  30, 400 },
+        { 0.20, true,  30, 400 },
+        { 0.70, true,  30, 400 },
+    };
+    static const host_t main_tv_no_directed[HOSTS] =
+    {
+        { 0.70, false, 30, 400 },
+        { 0.20, true,  30, 400 },
+        { 0.10, true,  30, 400 },
+    };
+    static const host_t uniform_tvs[HOSTS] =
+    {
+        { 0.34, true,  30, 400 },
+        { 0.33, true,  30, 400 },
+        { 0.33, true,  30, 400 },
+    };
+    static const host_t two_tvs[HOSTS] =
+    {
+        { 0.60, true,  30, 400 },
+        { 0.40, true,  30, 300 },
+        { 0.00, true,  30, 400 },
+    };
+    static const host_t two_tvs_no_directed[HOSTS] =
+    {
+        { 0.50, false, 30, 400 },
+        { 0.50, false, 30, 400 },
+        { 0.00, true,  30, 400 },
+    };
+
+    scenario_run("3 hosts 70/20/10",                    main_tv,             NULL,          NEVER, true);
+    scenario_run("main host rejects directed",          main_tv_no_directed, NULL,          NEVER, true);
+    scenario_run("3 hosts uniform",                     uniform_tvs,         NULL,          NEVER, true);
+    scenario_run("household 70/20/10 -> 10/20/70",      main_tv,             main_tv_later, RECONNECTIONS / 2, true);
+    scenario_run("whitelist only",                      two_tvs,             NULL,          NEVER, false);
+    scenario_run("2 hosts reject directed",             two_tvs_no_directed, NULL,          NEVER, true);
+}
+
+static void test_persistence(void)
+{
+    static const pm_peer_id_t   peer_ids[] = { 1, 0 };   // By rank, the least recently used first.
+    m_coms_ble_reconn_attempt_t attempt = { 0 };
+
+    memset(s_flash, 0, sizeof(s_flash));
+    s_flash_record = false;
+    s_flash_writes = 0;
+
+    // Nothing to store.
+    TEST_CHECK(m_coms_ble_reconn_init() == NRF_SUCCESS);
+    TEST_CHECK(m_coms_ble_reconn_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    TEST_CHECK(s_flash_writes == 0);
+
+    // The shutdown waits for the statistics to be written.
+    host_connected(1);
+    TEST_CHECK(!m_coms_ble_reconn_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    TEST_CHECK(!m_coms_ble_reconn_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    TEST_CHECK(s_flash_writes == 1);
+    TEST_CHECK(s_shutdowns == 0);
+
+    s_fds_evt_handler(&s_fds_evt);
+    TEST_CHECK(s_shutdowns == 1);
+    TEST_CHECK(m_coms_ble_reconn_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    TEST_CHECK(s_flash_writes == 1);
+
+    // Restart: the host connected to before comes first, though it is not the most recent one by rank.
+    TEST_CHECK(m_coms_ble_reconn_init() == NRF_SUCCESS);
+    TEST_CHECK(m_coms_ble_reconn_peer_find(1) != NULL);
+    TEST_CHECK(m_coms_ble_reconn_plan(peer_ids, ARRAY_SIZE(peer_ids), ARRAY_SIZE(peer_ids), true) > 0);
+    TEST_CHECK(m_coms_ble_reconn_attempt_get(0, &attempt) == NRF_SUCCESS);
+    TEST_CHECK(attempt.peer_id == 1);
+
+    // A record of another configuration is ignored.
+    s_flash_header.length_words = 1;
+    TEST_CHECK(m_coms_ble_reconn_init() == NRF_SUCCESS);
+    TEST_CHECK(m_coms_ble_reconn_peer_find(1) == NULL);
+
+    // Flash full: the space is reclaimed for the next time and the shutdown goes on.
+    host_connected(0);
+    s_flash_write_status = FDS_ERR_NO_SPACE_IN_FLASH;
+    TEST_CHECK(m_coms_ble_reconn_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    TEST_CHECK(s_flash_gcs == 1);
+    TEST_CHECK(s_flash_writes == 2);
+
+    printf("persistence: %u flash writes, %u garbage collections, %u shutdown continuations\n",
+           s_flash_writes, s_flash_gcs, s_shutdowns);
+}
+
+int main(void)
+{
+    test_scenarios();
+    test_persistence();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,69 @@
+/* Stand-in for the Air Motion Library header: the types and functions used by m_gyro.c. */
+#ifndef AIR_MOTION_LIB_H
+#define AIR_MOTION_LIB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define AIRMOTIONLIB_VERSION_MAJOR  4
+#define AIRMOTIONLIB_VERSION_MINOR  1
+
+typedef enum
+{
+    AirMotionNormal,
+} t_enum_AIR_MOTION_ClickStillTolerance;
+
+typedef struct
+{
+    int16_t X;
+    int16_t Y;
+    int16_t Z;
+} t_struct_AIR_MOTION_Vector3D;
+
+typedef struct
+{
+    struct
+    {
+        uint8_t X;
+        uint8_t Y;
+    } DeltaGain;
+    t_struct_AIR_MOTION_Vector3D            GyroOffsets;
+    uint8_t                                 GyroStaticMaxNoise;
+    uint8_t                                 StaticSamples;
+    uint8_t                                 SwipeMinDist;
+    uint8_t                                 SwipeMaxNoise;
+    uint8_t                                 StartupSamples;
+    uint8_t                                 ClickStillSamples;
+    t_enum_AIR_MOTION_ClickStillTolerance   ClickStillTolerance;
+    bool                                    IsRollCompEnabled;
+    uint16_t                                Acc1gLsb;
+    uint16_t                                GyroSensitivity;
+    uint8_t                                 GyroTremorCanceling;
+} t_struct_AIR_MOTION_Init;
+
+typedef struct
+{
+    t_struct_AIR_MOTION_Vector3D    AccSamples;
+    t_struct_AIR_MOTION_Vector3D    GyroSamples;
+    bool                            ClickSample;
+} t_struct_AIR_MOTION_ProcessDeltaSamples;
+
+typedef struct
+{
+    struct
+    {
+        bool IsDeltaComputed;
+        bool NewGyroOffset;
+    } Status;
+    struct
+    {
+        int16_t X;
+        int16_t Y;
+    } Delta;
+    t_struct_AIR_MOTION_Vector3D    GyroOffsets;
+} t_struct_AIR_MOTION_ProcessDeltaStatus;
+
+void AIR_MOTION_Init(t_struct_AIR_MOTION_Init *p_init);
+t_struct_AIR_MOTION_ProcessDeltaStatus AIR_MOTION_ProcessDelta(t_struct_AIR_MOTION_ProcessDeltaSamples samples);
+
+#endif // AIR_MOTION_LIB_H
@@ -0,0 +1,9 @@
+/* Stand-in for the SDK header of the same name. */
+#ifndef NRF_SDH_H__
+#define NRF_SDH_H__
+
+#include <stdbool.h>
+
+bool nrf_sdh_is_enabled(void);
+
+#endif // NRF_SDH_H__
@@ -0,0 +1,20 @@
+/* Gyroscope module configuration used by the test: no power management and no battery measurement. The gains
+ * and the high-resolution settings are set by the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_GYRO_ENABLED                 1
+#define CONFIG_GYRO_POLL_INTERVAL           10
+#define CONFIG_GYRO_MODULE_LOG_LEVEL        0
+
+#define CONFIG_PWR_MGMT_ENABLED             0
+#define CONFIG_BATT_MEAS_ENABLED            0
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
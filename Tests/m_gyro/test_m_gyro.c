@@ -0,0 +1,190 @@
+/**@file
+ *
+ * @brief Test of the gyroscope motion conversion in the gyroscope module.
+ *
+ * @details The test includes m_gyro.c, so it can reach the module state. The Air Motion Library is replaced by a
+ *          model which scales the gyroscope rate by the configured gain and truncates the result to whole deltas,
+ *          without carrying anything to the next sample. The relative motion events sent by the module are summed
+ *          per axis.
+ *
+ *          The conversion test feeds random deltas to m_gyro_delta_convert(). The sent motion and the carried
+ *          remainder must always add up to the motion received, and the remainder must stay below one delta.
+ *
+ *          The motion test moves the remote at constant rates, some of them too slow to give a single delta per
+ *          sample at the configured gain. The motion sent over a run must match the ideal motion to within the
+ *          truncation of the library at the raised gain.
+ */
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test.h"
+#include "sr3_config.h"    // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "m_gyro.c"
+
+#define CONVERT_ROUNDS      100000
+#define MOTION_SAMPLES      1000
+#define RATE_UNIT           1024    /**< Gyroscope rate giving one delta per sample at unity gain. */
+
+static t_struct_AIR_MOTION_Init s_air_motion_init;
+static int32_t                  s_rel_x;
+static int32_t                  s_rel_y;
+static uint32_t                 s_rel_events;
+
+app_isched_t                    g_fg_scheduler;
+
+void AIR_MOTION_Init(t_struct_AIR_MOTION_Init *p_init)
+{
+    s_air_motion_init = *p_init;
+}
+
+t_struct_AIR_MOTION_ProcessDeltaStatus AIR_MOTION_ProcessDelta(t_struct_AIR_MOTION_ProcessDeltaSamples samples)
+{
+    t_struct_AIR_MOTION_ProcessDeltaStatus status = { 0 };
+
+    status.Status.IsDeltaComputed = true;
+    status.Delta.X = (int32_t)samples.GyroSamples.X * s_air_motion_init.DeltaGain.X / RATE_UNIT;
+    status.Delta.Y = (int32_t)samples.GyroSamples.Y * s_air_motion_init.DeltaGain.Y / RATE_UNIT;
+
+    return status;
+}
+
+ret_code_t event_send(event_type_t event_type, ...)
+{
+    va_list args;
+
+    va_start(args, event_type);
+    switch (event_type)
+    {
+        case EVT_REL_X:
+            s_rel_x += va_arg(args, int);
+            s_rel_events++;
+            break;
+
+        case EVT_REL_Y:
+            s_rel_y += va_arg(args, int);
+            s_rel_events++;
+            break;
+
+        default:
+            break;
+    }
+    va_end(args);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t fds_register(fds_cb_t cb)                                    { return FDS_SUCCESS; }
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t *p_desc,
+                           fds_find_token_t *p_token)                   { return FDS_ERR_NOT_FOUND; }
+ret_code_t fds_record_open(fds_record_desc_t *p_desc, fds_flash_record_t *p_flash_record)
+                                                                        { return FDS_ERR_NOT_FOUND; }
+ret_code_t fds_record_close(fds_record_desc_t *p_desc)                  { return FDS_SUCCESS; }
+ret_code_t fds_record_write(fds_record_desc_t *p_desc, fds_record_t const *p_record)
+                                                                        { return FDS_SUCCESS; }
+ret_code_t fds_record_update(fds_record_desc_t *p_desc, fds_record_t const *p_record)
+                                                                        { return FDS_SUCCESS; }
+ret_code_t fds_gc(void)                                                 { return FDS_SUCCESS; }
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler) { return NRF_SUCCESS; }
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+                                                                        { return NRF_SUCCESS; }
+ret_code_t app_timer_stop(app_timer_id_t timer_id)                      { return NRF_SUCCESS; }
+ret_code_t drv_gyro_init(drv_gyro_ready_handler_t ready_handler, drv_gyro_read_handler_t read_handler)
+                                                                        { return NRF_SUCCESS; }
+ret_code_t drv_gyro_enable(void)                                        { return NRF_SUCCESS; }
+ret_code_t drv_gyro_disable(void)                                       { return NRF_SUCCESS; }
+ret_code_t drv_gyro_schedule_read(t_struct_AIR_MOTION_ProcessDeltaSamples *p_samples)
+                                                                        { return NRF_SUCCESS; }
+ret_code_t app_isched_event_put(app_isched_t *p_isched, app_isched_event_handler_t handler, void *p_context)
+                                                                        { return NRF_SUCCESS; }
+bool nrf_sdh_is_enabled(void)                                           { return true; }
+
+/**@brief Check that the converted motion and the remainder account for all motion received. */
+static void test_delta_convert(void)
+{
+    int64_t received    = 0;
+    int64_t sent        = 0;
+    int32_t remainder   = 0;
+    int     bad_remainders = 0;
+
+    for (int round = 0; round < CONVERT_ROUNDS; round++)
+    {
+        int32_t delta = (rand() % 201) - 100;
+
+        received += delta * HID_REL_POINTER_SCALE;
+        sent     += m_gyro_delta_convert(delta, &remainder) * M_GYRO_DELTA_SCALE;
+
+        if ((remainder <= -M_GYRO_DELTA_SCALE) || (remainder >= M_GYRO_DELTA_SCALE))
+        {
+            bad_remainders++;
+        }
+    }
+
+    TEST_CHECK(sent + remainder == received);
+    TEST_CHECK(bad_remainders == 0);
+}
+
+/**@brief Move at constant rates and compare the sent motion with the ideal motion. */
+static void test_motion(void)
+{
+    static const int16_t rates[] = { 0, 13, 32, 37, 100, 127, 700, -13, -37, -700 };
+
+    TEST_CHECK(m_gyro_init(false) == NRF_SUCCESS);
+    TEST_CHECK(s_air_motion_init.DeltaGain.X == CONFIG_GYRO_X_GAIN * M_GYRO_DELTA_SCALE);
+    TEST_CHECK(s_air_motion_init.DeltaGain.Y == CONFIG_GYRO_Y_GAIN * M_GYRO_DELTA_SCALE);
+
+    printf("gain X %u Y %u, delta scale %u, pointer scale %u\n",
+           s_air_motion_init.DeltaGain.X, s_air_motion_init.DeltaGain.Y,
+           (unsigned)M_GYRO_DELTA_SCALE, (unsigned)HID_REL_POINTER_SCALE);
+    printf("   rate  ideal X  sent X  unscaled X  ideal Y  sent Y\n");
+
+    for (size_t i = 0; i < ARRAY_SIZE(rates); i++)
+    {
+        t_struct_AIR_MOTION_ProcessDeltaSamples samples = { 0 };
+
+        samples.GyroSamples.X = rates[i];
+        samples.GyroSamples.Y = -rates[i];
+
+        s_rel_x = 0;
+        s_rel_y = 0;
+        TEST_CHECK(m_gyro_enable() == NRF_SUCCESS);
+
+        for (int sample = 0; sample < MOTION_SAMPLES; sample++)
+        {
+            m_gyro_evt_handler(&samples);
+        }
+
+        TEST_CHECK(m_gyro_disable() == NRF_SUCCESS);
+
+        // Motion in 1/HID_REL_POINTER_SCALE of a report count: ideal, and as sent before the gain was raised.
+        double  ideal_x    = (double)rates[i] * CONFIG_GYRO_X_GAIN * MOTION_SAMPLES * HID_REL_POINTER_SCALE / RATE_UNIT;
+        double  ideal_y    = (double)rates[i] * CONFIG_GYRO_Y_GAIN * MOTION_SAMPLES * HID_REL_POINTER_SCALE / RATE_UNIT;
+        int32_t unscaled_x = rates[i] * CONFIG_GYRO_X_GAIN / RATE_UNIT * MOTION_SAMPLES * HID_REL_POINTER_SCALE;
+
+        // The library truncates less than one delta per sample, worth HID_REL_POINTER_SCALE / M_GYRO_DELTA_SCALE,
+        // and less than one unit stays in the remainder.
+        double  tolerance = (double)MOTION_SAMPLES * HID_REL_POINTER_SCALE / M_GYRO_DELTA_SCALE + 1;
+
+        printf("%7d %8.0f %7d %11d %8.0f %7d\n",
+               rates[i], ideal_x, (int)s_rel_x, (int)unscaled_x, ideal_y, (int)s_rel_y);
+
+        TEST_CHECK(fabs(s_rel_x - ideal_x) < tolerance);
+        TEST_CHECK(fabs(s_rel_y - ideal_y) < tolerance);
+        TEST_CHECK(fabs(s_rel_x - ideal_x) <= fabs(unscaled_x - ideal_x));
+    }
+
+    TEST_CHECK(s_rel_events > 0);
+}
+
+int main(void)
+{
+    srand(1);
+
+    test_delta_convert();
+    test_motion();
+
+    return TEST_RESULT();
+}
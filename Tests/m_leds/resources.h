@@ -0,0 +1,5 @@
+/* Stand-in for the header of the same name: the LED module uses none of the resources. */
+#ifndef __RESOURCES_H__
+#define __RESOURCES_H__
+
+#endif /* __RESOURCES_H__ */
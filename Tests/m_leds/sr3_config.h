@@ -0,0 +1,36 @@
+/* LED configuration used by the test: an advertising blink forever on LED 0 and a connection blink on LED 1,
+ * which leaves LED 0 running, with power management. The flip interval comes from the Makefile. */
+#ifndef SR3_CONFIG_H
+#define SR3_CONFIG_H
+
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_error.h"
+
+#define CONFIG_LED_ENABLED                      1
+#define CONFIG_LED_MODULE_LOG_LEVEL             0
+
+#define CONFIG_LED_SIGNAL_ADVERTISING           1
+#define CONFIG_LED_ADVERTISING_LEDS_CLEAR       0x01
+#define CONFIG_LED_ADVERTISING_LEDS_SET         0x00
+#define CONFIG_LED_ADVERTISING_LEDS_FLASH       0x01
+#define CONFIG_LED_ADVERTISING_FLASHES          0
+
+#define CONFIG_LED_SIGNAL_CONNECTION            1
+#define CONFIG_LED_CONNECTION_LEDS_CLEAR        0x02
+#define CONFIG_LED_CONNECTION_LEDS_SET          0x00
+#define CONFIG_LED_CONNECTION_LEDS_FLASH        0x02
+#define CONFIG_LED_CONNECTION_FLASHES           3
+
+#define CONFIG_LED_SIGNAL_CONNECTION_ERROR      0
+#define CONFIG_LED_SIGNAL_LOW_BATTERY           0
+#define CONFIG_LED_SIGNAL_IMMEDIATE_ALERT       0
+
+#define CONFIG_PWR_MGMT_ENABLED                 1
+#define CONFIG_BATT_MEAS_ENABLED                0
+#define CONFIG_HID_HIGH_RES_ENABLED             0
+
+#include "sr3_config_hid.h"
+#include "sr3_config_ir.h"
+
+#endif // SR3_CONFIG_H
@@ -0,0 +1,278 @@
+/**@file
+ *
+ * @brief Test of the LED pattern timing in the LED module.
+ *
+ * @details The test includes m_leds.c. The shared LED timer runs on a model of the 24-bit 32768 Hz RTC counter,
+ *          and fires up to MAX_LATENCY ticks late, at random. Every LED transition is checked against the ideal
+ *          grid of flip intervals starting at the event which started the pattern.
+ *
+ *          The test plays the connection blink alone, then the connection blink over the advertising blink started
+ *          100 ms earlier, then the advertising blink for an hour, across several counter wraps. No transition may
+ *          be more than MAX_LATENCY ticks off the grid, the timer must wake up at most once per flip interval and
+ *          stop once no pattern is running. Last, the shutdown handler must let a forever blink run at most three
+ *          more times and then continue the shutdown.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "sr3_config.h"     // Included by the SDK nrf_assert.h, ahead of event_bus.h.
+#include "m_leds.c"
+
+#define LED_COUNT           2
+#define MAX_LATENCY         3       /**< Longest delay of the timer handler [ticks]. */
+#define COUNTER_MASK        0xFFFFFF
+#define FLIP_TICKS          APP_TIMER_TICKS(CONFIG_LED_FLIP_INTERVAL)
+#define TICKS(_ms)          ((uint64_t)(_ms) * APP_TIMER_CLOCK_FREQ / 1000)
+
+typedef struct
+{
+    uint64_t     origin;        /**< Time of the event which started the pattern [ticks]. */
+    unsigned int transitions;   /**< Number of transitions since the origin. */
+    uint64_t     max_error;     /**< Largest distance of a transition from the grid [ticks]. */
+} led_trace_t;
+
+static uint64_t                     s_now;
+static uint8_t                      s_leds;
+static led_trace_t                  s_traces[LED_COUNT];
+static bool                         s_timer_active;
+static uint64_t                     s_timer_fire;
+static app_timer_timeout_handler_t  s_timer_handler;
+static unsigned int                 s_timer_wakeups;
+static unsigned int                 s_shutdowns;
+
+ret_code_t drv_leds_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint8_t drv_leds_all(void)
+{
+    return (1u << LED_COUNT) - 1;
+}
+
+/**@brief Record the transitions of the LEDs changing state. */
+static void leds_update(uint8_t leds)
+{
+    for (unsigned int i = 0; i < LED_COUNT; i++)
+    {
+        led_trace_t *p_trace = &s_traces[i];
+
+        if (((leds ^ s_leds) & (1u << i)) == 0)
+        {
+            continue;
+        }
+
+        uint64_t ideal = p_trace->origin + (uint64_t)p_trace->transitions * FLIP_TICKS;
+        uint64_t error = (s_now > ideal) ? (s_now - ideal) : (ideal - s_now);
+
+        p_trace->max_error = MAX(p_trace->max_error, error);
+        p_trace->transitions++;
+    }
+
+    s_leds = leds;
+}
+
+ret_code_t drv_leds_set(uint8_t leds_mask)
+{
+    leds_update(s_leds | leds_mask);
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_leds_clr(uint8_t leds_mask)
+{
+    leds_update(s_leds & ~leds_mask);
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    TEST_CHECK(mode == APP_TIMER_MODE_SINGLE_SHOT);
+    s_timer_handler = timeout_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    // The RTC compare register cannot be more than half the counter range ahead.
+    TEST_CHECK(timeout_ticks >= APP_TIMER_MIN_TIMEOUT_TICKS);
+    TEST_CHECK(timeout_ticks <= (COUNTER_MASK >> 1));
+
+    s_timer_active = true;
+    s_timer_fire   = s_now + timeout_ticks + rand() % (MAX_LATENCY + 1);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    s_timer_active = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(s_now & COUNTER_MASK);
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & COUNTER_MASK;
+}
+
+void nrf_pwr_mgmt_shutdown(nrf_pwr_mgmt_shutdown_t shutdown_type)
+{
+    TEST_CHECK(shutdown_type == NRF_PWR_MGMT_SHUTDOWN_CONTINUE);
+    s_shutdowns++;
+}
+
+/**@brief Advance the clock, running the timer handler on the way. */
+static void run_for(uint64_t ticks)
+{
+    uint64_t end = s_now + ticks;
+
+    while (s_timer_active && (s_timer_fire <= end))
+    {
+        s_now          = s_timer_fire;
+        s_timer_active = false;
+        s_timer_wakeups++;
+        s_timer_handler(NULL);
+    }
+
+    s_now = end;
+}
+
+/**@brief Start tracing the given LEDs from now. */
+static void trace_start(uint8_t leds_mask)
+{
+    for (unsigned int i = 0; i < LED_COUNT; i++)
+    {
+        if (leds_mask & (1u << i))
+        {
+            memset(&s_traces[i], 0, sizeof(s_traces[i]));
+            s_traces[i].origin = s_now;
+        }
+    }
+
+    s_timer_wakeups = 0;
+}
+
+static void bt_event_send(event_type_t type, uint8_t data)
+{
+    event_t event;
+
+    memset(&event, 0, sizeof(event));
+    event.type    = type;
+    event.bt.data = data;
+
+    m_leds_event_handler(&event);
+}
+
+/**@brief Connection blink alone. */
+static void test_connection(void)
+{
+    trace_start(CONFIG_LED_CONNECTION_LEDS_FLASH);
+    bt_event_send(EVT_BT_CONN_STATE, BT_CONN_STATE_CONNECTED);
+    run_for(TICKS(3000));
+
+    printf("connection blink: %u transitions, %u timer wakeups, max error %u ticks\n",
+           s_traces[1].transitions, s_timer_wakeups, (unsigned)s_traces[1].max_error);
+
+    TEST_CHECK(s_traces[1].transitions == 2 * CONFIG_LED_CONNECTION_FLASHES);
+    TEST_CHECK(s_traces[1].max_error <= MAX_LATENCY);
+    TEST_CHECK(s_timer_wakeups == 2 * CONFIG_LED_CONNECTION_FLASHES);
+    TEST_CHECK(!s_timer_active);
+    TEST_CHECK(s_leds == 0);
+    TEST_CHECK(m_leds_lit == 0);
+}
+
+/**@brief Connection blink over the advertising blink, started out of phase. */
+static void test_overlap(void)
+{
+    trace_start(CONFIG_LED_ADVERTISING_LEDS_FLASH);
+    bt_event_send(EVT_BT_ADV_STATE, BT_ADV_STATE_ACTIVE);
+    run_for(TICKS(100));
+
+    trace_start(CONFIG_LED_CONNECTION_LEDS_FLASH);
+    bt_event_send(EVT_BT_CONN_STATE, BT_CONN_STATE_CONNECTED);
+    run_for(TICKS(3000));
+
+    printf("overlapping blinks: %u and %u transitions, %u timer wakeups, max error %u and %u ticks\n",
+           s_traces[0].transitions, s_traces[1].transitions, s_timer_wakeups,
+           (unsigned)s_traces[0].max_error, (unsigned)s_traces[1].max_error);
+
+    // Both patterns flip every interval, out of phase: one wakeup per transition.
+    TEST_CHECK(s_traces[1].transitions == 2 * CONFIG_LED_CONNECTION_FLASHES);
+    TEST_CHECK(s_traces[0].transitions >= 3100 / CONFIG_LED_FLIP_INTERVAL);
+    TEST_CHECK(s_traces[0].max_error <= MAX_LATENCY);
+    TEST_CHECK(s_traces[1].max_error <= MAX_LATENCY);
+    TEST_CHECK(s_timer_wakeups <= s_traces[0].transitions + s_traces[1].transitions);
+    TEST_CHECK(s_timer_active);
+
+    bt_event_send(EVT_BT_ADV_STATE, BT_ADV_STATE_IDLE);
+    TEST_CHECK(!s_timer_active);
+    TEST_CHECK(s_leds == 0);
+}
+
+/**@brief Advertising blink for an hour, across counter wraps. */
+static void test_drift(void)
+{
+    uint64_t duration = TICKS(3600 * 1000 + CONFIG_LED_FLIP_INTERVAL / 2);
+
+    trace_start(CONFIG_LED_ADVERTISING_LEDS_FLASH);
+    bt_event_send(EVT_BT_ADV_STATE, BT_ADV_STATE_ACTIVE);
+    run_for(duration);
+
+    printf("1 h blink: %u transitions, %u timer wakeups, %u counter wraps, max error %u ticks\n",
+           s_traces[0].transitions, s_timer_wakeups, (unsigned)(duration >> 24), (unsigned)s_traces[0].max_error);
+
+    TEST_CHECK(s_traces[0].transitions == duration / FLIP_TICKS + 1);
+    TEST_CHECK(s_traces[0].max_error <= MAX_LATENCY);
+    TEST_CHECK(s_timer_wakeups == s_traces[0].transitions - 1);
+
+    bt_event_send(EVT_BT_ADV_STATE, BT_ADV_STATE_IDLE);
+    TEST_CHECK(!s_timer_active);
+}
+
+/**@brief Shutdown while blinking forever. */
+static void test_shutdown(void)
+{
+    trace_start(CONFIG_LED_ADVERTISING_LEDS_FLASH);
+    bt_event_send(EVT_BT_ADV_STATE, BT_ADV_STATE_ACTIVE);
+    run_for(TICKS(1000 + CONFIG_LED_FLIP_INTERVAL / 2));
+
+    unsigned int transitions = s_traces[0].transitions;
+
+    TEST_CHECK(!m_leds_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+    run_for(TICKS(10 * CONFIG_LED_FLIP_INTERVAL));
+
+    printf("shutdown: %u transitions after the request, %u shutdown continuations\n",
+           s_traces[0].transitions - transitions, s_shutdowns);
+
+    TEST_CHECK(s_traces[0].transitions - transitions <= 6);
+    TEST_CHECK(s_shutdowns == 1);
+    TEST_CHECK(!s_timer_active);
+    TEST_CHECK(s_leds == 0);
+
+    TEST_CHECK(m_leds_shutdown(NRF_PWR_MGMT_EVT_PREPARE_WAKEUP));
+}
+
+int main(void)
+{
+    srand(1);
+
+    // Start close to a counter wrap.
+    s_now = COUNTER_MASK - TICKS(500);
+
+    TEST_CHECK(m_leds_init() == NRF_SUCCESS);
+
+    test_connection();
+    test_overlap();
+    test_drift();
+    test_shutdown();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,283 @@
+/**@file
+ *
+ * @brief Peak scratch arena usage of the Opus encoder.
+ *
+ * @details Opus is built as in the firmware (FIXED_POINT, NONTHREADSAFE_PSEUDOSTACK, CUSTOM_SUPPORT) and
+ *          configured like drv_audio_codec_opus.c. Every sampling frequency, frame size, complexity and
+ *          bitrate mode supported by the selected Opus mode encodes a corpus of speech-like and worst-case
+ *          signals. The highest scratch allocation must fit the arena size set in the board configuration.
+ *
+ *          Every opus_encode() call also runs on a painted stack of its own, which gives the stack used outside
+ *          the arena. It must fit the codec stack reservation of the board configuration. Host frames hold
+ *          64-bit pointers and registers, so the figure is an upper bound for the Cortex-M4 build.
+ *
+ *          The test is built once for each mode, with CONFIG_OPUS_MODE, OPUS_SCRATCH_SIZE and OPUS_STACK_SIZE
+ *          set by the Makefile.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "opus.h"
+#include "custom_support.h"
+
+#define CORPUS_SECTION_MS   500     /**< Length of each corpus section. */
+#define CORPUS_SECTIONS     4
+#define MAX_FRAME_SAMPLES   (24000 * 60 / 1000)
+#define MAX_PACKET_SIZE     3840
+#define STACK_AREA_SIZE     (64 * 1024)
+#define STACK_PAINT         0xA5
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if   (CONFIG_OPUS_MODE == CONFIG_OPUS_MODE_CELT)
+# define OPUS_APPLICATION    OPUS_APPLICATION_RESTRICTED_LOWDELAY
+# define OPUS_MODE           "CELT"
+static const int s_sampling_frequencies[]   = { 8000, 16000, 24000 };
+static const int s_frame_sizes_ms[]         = { 5, 10, 20 };
+#elif (CONFIG_OPUS_MODE == CONFIG_OPUS_MODE_SILK)
+# define OPUS_APPLICATION    OPUS_APPLICATION_VOIP
+# define OPUS_MODE           "SILK"
+static const int s_sampling_frequencies[]   = { 8000, 16000 };
+static const int s_frame_sizes_ms[]         = { 10, 20, 40, 60 };
+#else
+# error "Unsupported OPUS Mode"
+#endif
+
+/**@brief Bitrate settings: VBR, and constrained VBR at the lowest and highest bitrates used by the remote. */
+static const int32_t s_bitrates[] = { OPUS_AUTO, 16000, 64000 };
+
+static uint64_t s_arena[(4 * OPUS_SCRATCH_SIZE) / sizeof(uint64_t)];   // Aligned like the firmware arena.
+static char    *s_arena_top;
+static int16_t  s_corpus[(CORPUS_SECTIONS * CORPUS_SECTION_MS * 24000) / 1000];
+
+static uint8_t  s_stack[STACK_AREA_SIZE] __attribute__((aligned(16)));  // Stack of the encoder calls.
+static ucontext_t s_main_context;
+static ucontext_t s_encoder_context;
+
+/**@brief Arguments and result of the encoder call running on s_stack. */
+static struct
+{
+    OpusEncoder    *p_encoder;
+    const int16_t  *p_pcm;
+    int             frame_samples;
+    uint8_t        *p_packet;
+    int             size;
+} s_call;
+
+void *drv_audio_codec_opus_scratch_get(size_t size)
+{
+    return s_arena;
+}
+
+void drv_audio_codec_opus_scratch_check(char const *p_top)
+{
+    if (p_top > s_arena_top)
+    {
+        s_arena_top = (char *)p_top;
+    }
+
+    // The arena is larger than the configured size, so the test can report by how much it is exceeded.
+    TEST_CHECK(p_top <= (char const *)s_arena + sizeof(s_arena));
+}
+
+/**@brief Generate the test corpus.
+ *
+ * @details Sections: voiced speech with a gliding pitch and formants, syllable-like bursts separated by
+ *          silence, full-scale white noise and a clipped frequency sweep.
+ */
+static size_t corpus_generate(int fs)
+{
+    size_t      section = (size_t)fs * CORPUS_SECTION_MS / 1000;
+    uint32_t    seed = 1;
+    double      phase = 0.0;
+    size_t      i;
+
+    for (i = 0; i < CORPUS_SECTIONS * section; i++)
+    {
+        double  t = (double)i / fs;
+        double  noise;
+        double  v;
+
+        seed  = (seed * 1664525) + 1013904223;
+        noise = (int32_t)seed / 2147483648.0;
+
+        switch (i / section)
+        {
+            case 0:
+                phase += 2.0 * M_PI * (110.0 + 50.0 * sin(2.0 * M_PI * 3.0 * t)) / fs;
+                v = 0.3 * sin(phase) + 0.2 * sin(3.0 * phase) + 0.15 * sin(7.0 * phase) + 0.05 * noise;
+                break;
+
+            case 1:
+                v = (fmod(t, 0.2) < 0.08) ? (0.8 * noise * sin(2.0 * M_PI * 5.0 * t)) : 0.0;
+                break;
+
+            case 2:
+                v = noise;
+                break;
+
+            default:
+                phase += 2.0 * M_PI * (50.0 + (fs / 2.0) * (t - 1.5)) / fs;
+                v = (sin(phase) >= 0.0) ? 0.99 : -0.99;
+                break;
+        }
+
+        s_corpus[i] = (int16_t)(v * 32767.0);
+    }
+
+    return i;
+}
+
+static void encode_call(void)
+{
+    s_call.size = opus_encode(s_call.p_encoder, s_call.p_pcm, s_call.frame_samples, s_call.p_packet, MAX_PACKET_SIZE);
+}
+
+/**@brief Encode one frame on the painted stack.
+ *
+ * @param[out]  p_stack     Stack used by the call, in bytes.
+ *
+ * @return      Result of opus_encode().
+ */
+static int frame_encode(OpusEncoder *p_encoder, const int16_t *p_pcm, int frame_samples, uint8_t *p_packet,
+                        size_t *p_stack)
+{
+    size_t i;
+
+    memset(s_stack, STACK_PAINT, sizeof(s_stack));
+
+    s_call.p_encoder        = p_encoder;
+    s_call.p_pcm            = p_pcm;
+    s_call.frame_samples    = frame_samples;
+    s_call.p_packet         = p_packet;
+
+    TEST_CHECK(getcontext(&s_encoder_context) == 0);
+    s_encoder_context.uc_stack.ss_sp    = s_stack;
+    s_encoder_context.uc_stack.ss_size  = sizeof(s_stack);
+    s_encoder_context.uc_link           = &s_main_context;
+    makecontext(&s_encoder_context, encode_call, 0);
+    TEST_CHECK(swapcontext(&s_main_context, &s_encoder_context) == 0);
+
+    // The stack grows down: the lowest byte which is not the paint any more is the deepest one used.
+    for (i = 0; (i < sizeof(s_stack)) && (s_stack[i] == STACK_PAINT); i++)
+    {
+    }
+
+    TEST_CHECK(i > 0);
+    *p_stack = sizeof(s_stack) - i;
+
+    return s_call.size;
+}
+
+/**@brief Encode the corpus with one encoder configuration.
+ *
+ * @param[out]  p_stack_peak    Peak stack usage outside the arena, in bytes.
+ *
+ * @return      Peak scratch usage in bytes.
+ */
+static size_t corpus_encode(OpusEncoder *p_encoder, int fs, int frame_ms, int complexity, int32_t bitrate,
+                            size_t *p_stack_peak)
+{
+    static uint8_t  packet[MAX_PACKET_SIZE];
+    size_t          frame_samples = (size_t)fs * frame_ms / 1000;
+    size_t          samples = corpus_generate(fs);
+    size_t          peak = 0;
+    size_t          pos;
+
+    *p_stack_peak = 0;
+
+    TEST_CHECK(opus_encoder_init(p_encoder, fs, 1, OPUS_APPLICATION) == OPUS_OK);
+
+    // Same settings as drv_audio_codec_init().
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_BITRATE(bitrate))                     == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_VBR(1))                               == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_VBR_CONSTRAINT((bitrate != OPUS_AUTO)))== OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_COMPLEXITY(complexity))               == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE))            == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_LSB_DEPTH(16))                        == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_DTX(0))                               == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_INBAND_FEC(0))                        == OPUS_OK);
+    TEST_CHECK(opus_encoder_ctl(p_encoder, OPUS_SET_PACKET_LOSS_PERC(0))                  == OPUS_OK);
+
+    for (pos = 0; (pos + frame_samples) <= samples; pos += frame_samples)
+    {
+        size_t  stack;
+        int     size;
+
+        s_arena_top = (char *)s_arena;
+        size        = frame_encode(p_encoder, &s_corpus[pos], frame_samples, packet, &stack);
+        TEST_CHECK((size > 0) && (size <= MAX_PACKET_SIZE));
+
+        *p_stack_peak = MAX(*p_stack_peak, stack);
+
+        if ((size_t)(s_arena_top - (char *)s_arena) > peak)
+        {
+            peak = s_arena_top - (char *)s_arena;
+        }
+    }
+
+    return peak;
+}
+
+int main(void)
+{
+    OpusEncoder    *p_encoder = malloc(opus_encoder_get_size(1));
+    size_t          max_peak = 0;
+    size_t          max_stack = 0;
+    size_t          f, m, b;
+    int             complexity;
+
+    TEST_CHECK(p_encoder != NULL);
+
+    printf("OPUS/" OPUS_MODE " peak scratch usage [bytes] (VBR / CVBR 16 kbit/s / CVBR 64 kbit/s):\n");
+
+    for (f = 0; f < ARRAY_SIZE(s_sampling_frequencies); f++)
+    {
+        for (m = 0; m < ARRAY_SIZE(s_frame_sizes_ms); m++)
+        {
+            printf("%5d Hz %2d ms:", s_sampling_frequencies[f], s_frame_sizes_ms[m]);
+
+            for (complexity = 0; complexity <= 10; complexity++)
+            {
+                size_t config_peak = 0;
+
+                for (b = 0; b < ARRAY_SIZE(s_bitrates); b++)
+                {
+                    size_t stack;
+                    size_t peak = corpus_encode(p_encoder,
+                                                s_sampling_frequencies[f],
+                                                s_frame_sizes_ms[m],
+                                                complexity,
+                                                s_bitrates[b],
+                                                &stack);
+
+                    config_peak = MAX(config_peak, peak);
+                    max_stack   = MAX(max_stack, stack);
+                }
+
+                printf(" %5zu", config_peak);
+                max_peak = MAX(max_peak, config_peak);
+            }
+
+            printf("  (complexity 0..10)\n");
+        }
+    }
+
+    printf("Maximum: %zu out of %u bytes\n", max_peak, OPUS_SCRATCH_SIZE);
+    TEST_CHECK(max_peak <= OPUS_SCRATCH_SIZE);
+
+    printf("Peak stack usage outside the arena: %zu out of %u bytes\n", max_stack, OPUS_STACK_SIZE);
+    TEST_CHECK(max_stack <= OPUS_STACK_SIZE);
+
+    free(p_encoder);
+
+    return TEST_RESULT();
+}
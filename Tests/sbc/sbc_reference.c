@@ -0,0 +1,23 @@
+/* The encoder as it was before the polyphase analysis filter and the bit allocation cache: sbc_encoder.c and
+ * sbc_analysis.c built with SBC_POLYPHASE_OPT and SBC_BIT_ALLOC_CACHE set to FALSE, with the ref_ prefix.
+ * SBC_ENC_PARAMS keeps the layout of the default build, so the DCT, bit allocation and packing of that build
+ * are shared. */
+#include <string.h>
+
+#define SBC_Encoder             ref_SBC_Encoder
+#define SBC_Encoder_Init        ref_SBC_Encoder_Init
+#define SbcAnalysisFilter4      ref_SbcAnalysisFilter4
+#define SbcAnalysisFilter8      ref_SbcAnalysisFilter8
+#define SbcAnalysisInit         ref_SbcAnalysisInit
+#define EncMaxShiftCounter      ref_EncMaxShiftCounter
+#define sbc_prtc_cb             ref_sbc_prtc_cb
+
+#define SBC_POLYPHASE_OPT       FALSE
+#include "sbc_encoder.h"
+#include "sbc_enc_func_declare.h"
+
+#undef  SBC_BIT_ALLOC_CACHE
+#define SBC_BIT_ALLOC_CACHE     FALSE
+
+#include "sbc_encoder.c"
+#include "sbc_analysis.c"
@@ -0,0 +1,37 @@
+/* The default encoder with the dual multiply-accumulate kernel of the polyphase analysis filter, which is only
+ * compiled for a Cortex-M4 target. The armcc branch of sbc_analysis_poly.c is selected and its __smlad()
+ * intrinsic is emulated. sbc_encoder.c and sbc_analysis_poly.c are built with the smlad_ prefix. */
+#include <stdint.h>
+#include <string.h>
+
+#define SBC_Encoder             smlad_SBC_Encoder
+#define SBC_Encoder_Init        smlad_SBC_Encoder_Init
+#define SbcAnalysisFilter4      smlad_SbcAnalysisFilter4
+#define SbcAnalysisFilter8      smlad_SbcAnalysisFilter8
+#define SbcAnalysisInit         smlad_SbcAnalysisInit
+#define EncMaxShiftCounter      smlad_EncMaxShiftCounter
+#define sbc_prtc_cb             smlad_sbc_prtc_cb
+
+#include "sbc_encoder.h"
+#include "sbc_enc_func_declare.h"
+
+/**@brief SMLAD: both signed 16x16 products of the halfwords, added to the accumulator modulo 2^32. */
+static inline int32_t __smlad(uint32_t x, uint32_t y, int32_t acc)
+{
+    uint32_t lo = (uint32_t)((int32_t)(int16_t)x * (int16_t)y);
+    uint32_t hi = (uint32_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+
+    return (int32_t)(lo + hi + (uint32_t)acc);
+}
+
+#define __CC_ARM
+#define __TARGET_FEATURE_DSPMUL
+#include "sbc_analysis_poly.c"
+#undef  __CC_ARM
+#undef  __TARGET_FEATURE_DSPMUL
+
+#if (SBC_POLY_DUAL_MAC != TRUE)
+#error "The dual multiply-accumulate kernel is not selected."
+#endif
+
+#include "sbc_encoder.c"
@@ -0,0 +1,228 @@
+/**@file
+ *
+ * @brief Bit-exactness of the SBC encoder with the polyphase analysis filter and the bit allocation cache.
+ *
+ * @details The default build of the library (SBC_POLYPHASE_OPT and SBC_BIT_ALLOC_CACHE set) is compared against
+ *          the shifting analysis filter without the cache (sbc_reference.c) and against the default build with
+ *          the emulated SMLAD kernel of the polyphase filter (sbc_smlad.c). Every configuration encodes noise,
+ *          a chirp, gated speech-like bursts, a square wave and silence, which keeps the bit allocation cached,
+ *          and all three streams must be byte-identical. The configurations are mSBC and custom mono settings
+ *          with 4 and 8 subbands, every block length, both allocation methods and bitpools from 2 to the
+ *          maximum.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "sbc_encoder.h"
+
+#define FRAMES              120
+#define MAX_FRAME_SAMPLES   (SBC_MAX_NUM_OF_BLOCKS * SBC_MAX_NUM_OF_SUBBANDS)
+#define MAX_FRAME_BYTES     512
+#define SIGNALS             5
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**@brief Encoder under test. */
+typedef struct
+{
+    const char  *p_name;
+    void        (*init)(SBC_ENC_PARAMS *);
+    void        (*encode)(SBC_ENC_PARAMS *);
+} encoder_t;
+
+extern void ref_SBC_Encoder(SBC_ENC_PARAMS *strEncParams);
+extern void ref_SBC_Encoder_Init(SBC_ENC_PARAMS *strEncParams);
+extern void smlad_SBC_Encoder(SBC_ENC_PARAMS *strEncParams);
+extern void smlad_SBC_Encoder_Init(SBC_ENC_PARAMS *strEncParams);
+
+static const encoder_t s_encoders[] =
+{
+    { "reference",  ref_SBC_Encoder_Init,   ref_SBC_Encoder },
+    { "polyphase",  SBC_Encoder_Init,       SBC_Encoder },
+    { "SMLAD",      smlad_SBC_Encoder_Init, smlad_SBC_Encoder },
+};
+
+static const char * const s_signal_names[SIGNALS] = { "noise", "chirp", "bursts", "square", "silence" };
+
+static int16_t  s_signal[FRAMES * MAX_FRAME_SAMPLES];
+static uint8_t  s_stream[ARRAY_SIZE(s_encoders)][FRAMES * MAX_FRAME_BYTES];
+static size_t   s_stream_size[ARRAY_SIZE(s_encoders)];
+static unsigned s_configs;
+static unsigned s_mismatches;
+
+static void signal_generate(int type, size_t len)
+{
+    double  phase = 0.0;
+    size_t  i;
+
+    srand(type);
+
+    for (i = 0; i < len; i++)
+    {
+        double v;
+
+        switch (type)
+        {
+            case 0:
+                v = (rand() % 65536) - 32768;
+                break;
+
+            case 1:
+                phase += 2.0 * M_PI * (50.0 + 7900.0 * (i % 16000) / 16000.0) / 16000.0;
+                v = 30000.0 * sin(phase);
+                break;
+
+            case 2:
+                v = ((i / 3000) % 2) ? (4000.0 * sin(i * 0.03) + 2000.0 * sin(i * 0.31) + (rand() % 600) - 300)
+                                     : ((rand() % 40) - 20);
+                break;
+
+            case 3:
+                v = ((i % 100) < 50) ? 32767 : -32768;
+                break;
+
+            default:
+                v = 0.0;
+                break;
+        }
+
+        s_signal[i] = (int16_t)MAX(-32768.0, MIN(32767.0, v));
+    }
+}
+
+/**@brief Encode the signal.
+ *
+ * @return      Size of the stream.
+ */
+static size_t encode(const encoder_t *p_encoder, const SBC_ENC_PARAMS *p_config, unsigned int frames,
+                     uint8_t *p_stream)
+{
+    SBC_ENC_PARAMS  params = *p_config;
+    int16_t         pcm[MAX_FRAME_SAMPLES];
+    size_t          frame_samples;
+    size_t          size = 0;
+    unsigned int    i;
+
+    p_encoder->init(&params);
+    frame_samples = params.s16NumOfBlocks * params.s16NumOfSubBands;
+
+    for (i = 0; i < frames; i++)
+    {
+        // Every encoder gets its own copy of the input.
+        memcpy(pcm, &s_signal[i * frame_samples], frame_samples * sizeof(pcm[0]));
+        params.ps16PcmBuffer = pcm;
+        params.pu8Packet     = &p_stream[size];
+
+        p_encoder->encode(&params);
+
+        TEST_CHECK((params.u16PacketLength > 0) && (params.u16PacketLength <= MAX_FRAME_BYTES));
+        size += params.u16PacketLength;
+    }
+
+    return size;
+}
+
+/**@brief Encode every signal with every encoder and compare the streams with the reference. */
+static void test_config(const SBC_ENC_PARAMS *p_config)
+{
+    size_t  frame_samples = p_config->s16NumOfBlocks * p_config->s16NumOfSubBands;
+    size_t  e;
+    int     type;
+
+    for (type = 0; type < SIGNALS; type++)
+    {
+        signal_generate(type, FRAMES * frame_samples);
+
+        for (e = 0; e < ARRAY_SIZE(s_encoders); e++)
+        {
+            s_stream_size[e] = encode(&s_encoders[e], p_config, FRAMES, s_stream[e]);
+        }
+
+        for (e = 1; e < ARRAY_SIZE(s_encoders); e++)
+        {
+            if ((s_stream_size[e] != s_stream_size[0]) ||
+                (memcmp(s_stream[e], s_stream[0], s_stream_size[0]) != 0))
+            {
+                s_mismatches++;
+                printf("%s differs from the reference: %s, %s, blocks %d, subbands %d, %s, bitpool %d\n",
+                       s_encoders[e].p_name, s_signal_names[type], p_config->mSBCEnabled ? "mSBC" : "SBC",
+                       p_config->s16NumOfBlocks, p_config->s16NumOfSubBands,
+                       (p_config->s16AllocationMethod == SBC_SNR) ? "SNR" : "loudness", p_config->s16BitPool);
+            }
+        }
+    }
+
+    s_configs++;
+}
+
+static SBC_ENC_PARAMS config(int blocks, int subbands, int allocation, int bitpool, bool msbc)
+{
+    SBC_ENC_PARAMS params;
+
+    memset(&params, 0, sizeof(params));
+    params.s16ChannelMode       = SBC_MONO;
+    params.s16NumOfChannels     = 1;
+    params.s16SamplingFreq      = SBC_sf16000;
+    params.s16NumOfBlocks       = blocks;
+    params.s16NumOfSubBands     = subbands;
+    params.s16BitPool           = bitpool;
+    params.s16AllocationMethod  = allocation;
+    params.mSBCEnabled          = msbc ? 1 : 0;
+
+    return params;
+}
+
+static void test_msbc(void)
+{
+    SBC_ENC_PARAMS params = config(15, SUB_BANDS_8, SBC_LOUDNESS, 26, true);
+
+    test_config(&params);
+}
+
+static void test_custom(void)
+{
+    static const int bitpools[] = { 2, 8, 19, 32, 53, 64, 100, 128 };
+    int subbands, blocks, allocation;
+    size_t i;
+
+    for (subbands = SUB_BANDS_4; subbands <= SUB_BANDS_8; subbands += SUB_BANDS_4)
+    {
+        for (blocks = SBC_BLOCK_0; blocks <= SBC_BLOCK_3; blocks += 4)
+        {
+            for (allocation = SBC_LOUDNESS; allocation <= SBC_SNR; allocation++)
+            {
+                for (i = 0; i < ARRAY_SIZE(bitpools); i++)
+                {
+                    SBC_ENC_PARAMS params;
+
+                    // A mono stream carries up to 16 bits per subband.
+                    if (bitpools[i] > 16 * subbands)
+                    {
+                        continue;
+                    }
+
+                    params = config(blocks, subbands, allocation, bitpools[i], false);
+                    test_config(&params);
+                }
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    test_msbc();
+    test_custom();
+
+    TEST_CHECK(s_mismatches == 0);
+    printf("%u configurations, %d signals, %u mismatches\n", s_configs, SIGNALS, s_mismatches);
+
+    return TEST_RESULT();
+}
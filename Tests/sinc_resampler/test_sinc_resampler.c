@@ -0,0 +1,252 @@
+/**@file
+ *
+ * @brief SNR, passband, aliasing and block size test of the sample rate converter, with a CPU benchmark.
+ *
+ * @details Every conversion between the PDM rates and the codec rates is checked with full-scale tones:
+ *          - in the passband (up to 0.35 of the lower rate), the output must be a clean tone of the same level,
+ *          - at 0.4 of the lower rate, where the filter starts to roll off, the level may drop by up to 2 dB,
+ *          - when downsampling, tones above the output Nyquist frequency must be suppressed.
+ *          The output must not depend on the sizes of the input and output blocks.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "sinc_resampler.h"
+
+#define INPUT_LENGTH        32000
+#define SKIP                200                 /**< Output samples skipped at both ends. */
+#define AMPLITUDE           16000.0
+#define TONES               8
+
+#define PASSBAND            0.35                /**< Upper edge of the passband, relative to the lower rate. */
+#define EDGE                0.4                 /**< Frequency of the edge tone, relative to the lower rate. */
+
+#define MIN_SNR_DB          55.0
+#define MAX_GAIN_ERROR_DB   0.2
+#define MAX_EDGE_LOSS_DB    2.0
+#define MAX_ALIAS_DB        -70.0
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* PDM rates reachable with the nRF52 clock dividers, and the codec rates. */
+static const uint32_t s_in_rates[]  = { 7936, 15625, 16125, 20833, 31250 };
+static const uint32_t s_out_rates[] = { 8000, 16000, 24000, 32000 };
+
+static int16_t s_input[INPUT_LENGTH];
+static int16_t s_output[5 * INPUT_LENGTH];
+static int16_t s_reference[5 * INPUT_LENGTH];
+static int16_t s_buffer[2048];
+
+/**@brief Convert the whole input, written in blocks of @p in_block and read in blocks of @p out_block samples.
+ *
+ * @return Number of output samples.
+ */
+static size_t convert(uint32_t in_rate, uint32_t out_rate, size_t in_block, size_t out_block, int16_t *p_output)
+{
+    sinc_resampler_t    resampler;
+    size_t              produced = 0;
+    size_t              pos;
+    unsigned int        count;
+
+    TEST_CHECK(SINC_RESAMPLER_BUFFER_SIZE(in_block, in_rate, out_rate) <= ARRAY_SIZE(s_buffer));
+    TEST_CHECK(sinc_resampler_init(&resampler, s_buffer, SINC_RESAMPLER_BUFFER_SIZE(in_block, in_rate, out_rate),
+                                   in_rate, out_rate) == 0);
+
+    for (pos = 0; (pos + in_block) <= INPUT_LENGTH; pos += in_block)
+    {
+        TEST_CHECK(sinc_resampler_write(&resampler, &s_input[pos], in_block) == in_block);
+
+        do
+        {
+            count     = sinc_resampler_read(&resampler, &p_output[produced], out_block);
+            produced += count;
+        } while (count == out_block);
+    }
+
+    return produced;
+}
+
+static void tone(double frequency, uint32_t rate)
+{
+    size_t i;
+
+    for (i = 0; i < INPUT_LENGTH; i++)
+    {
+        s_input[i] = (int16_t)lrint(AMPLITUDE * sin(2.0 * M_PI * frequency * i / rate));
+    }
+}
+
+/**@brief Fit a tone of the given frequency to the output by least squares.
+ *
+ * @param[out] p_gain_db    Level of the fitted tone relative to the input tone.
+ *
+ * @return Ratio of the fitted tone to the residual, in dB.
+ */
+static double tone_snr(const int16_t *p_output, size_t count, double frequency, uint32_t rate, double *p_gain_db)
+{
+    double sin_sum = 0.0, cos_sum = 0.0, sin_sin = 0.0, cos_cos = 0.0;
+    double signal = 0.0, error = 0.0;
+    double a, b;
+    size_t n;
+
+    for (n = SKIP; n < (count - SKIP); n++)
+    {
+        double s = sin(2.0 * M_PI * frequency * n / rate);
+        double c = cos(2.0 * M_PI * frequency * n / rate);
+
+        sin_sum += p_output[n] * s;
+        cos_sum += p_output[n] * c;
+        sin_sin += s * s;
+        cos_cos += c * c;
+    }
+
+    a = sin_sum / sin_sin;
+    b = cos_sum / cos_cos;
+
+    for (n = SKIP; n < (count - SKIP); n++)
+    {
+        double fit = (a * sin(2.0 * M_PI * frequency * n / rate)) + (b * cos(2.0 * M_PI * frequency * n / rate));
+
+        signal += fit * fit;
+        error  += (p_output[n] - fit) * (p_output[n] - fit);
+    }
+
+    *p_gain_db = 10.0 * log10(signal / ((count - 2 * SKIP) * AMPLITUDE * AMPLITUDE / 2.0));
+    return 10.0 * log10(signal / error);
+}
+
+/**@brief Output level relative to the input tone. */
+static double level_db(const int16_t *p_output, size_t count)
+{
+    double power = 0.0;
+    size_t n;
+
+    for (n = SKIP; n < (count - SKIP); n++)
+    {
+        power += (double)p_output[n] * p_output[n];
+    }
+
+    return 10.0 * log10((power + 1.0) / ((count - 2 * SKIP) * AMPLITUDE * AMPLITUDE / 2.0));
+}
+
+static void rates_test(uint32_t in_rate, uint32_t out_rate)
+{
+    double  passband = PASSBAND * MIN(in_rate, out_rate);
+    double  min_snr = INFINITY;
+    double  max_gain_error = 0.0;
+    double  max_alias = -INFINITY;
+    double  edge_gain;
+    double  frequency;
+    double  gain;
+    size_t  count;
+    int     i;
+
+    for (i = 0; i < TONES; i++)
+    {
+        frequency = 100.0 + ((passband - 100.0) * i / (TONES - 1));
+        tone(frequency, in_rate);
+        count = convert(in_rate, out_rate, 128, 100, s_output);
+
+        // The output rate is exact: only the input held back for the filter wing is not converted yet.
+        TEST_CHECK(count <= ((double)INPUT_LENGTH * out_rate / in_rate));
+        TEST_CHECK(count >= ((double)(INPUT_LENGTH - SINC_RESAMPLER_WING(in_rate, out_rate) - 2) * out_rate / in_rate));
+
+        min_snr         = MIN(min_snr, tone_snr(s_output, count, frequency, out_rate, &gain));
+        max_gain_error  = MAX(max_gain_error, fabs(gain));
+    }
+
+    frequency = EDGE * MIN(in_rate, out_rate);
+    tone(frequency, in_rate);
+    count   = convert(in_rate, out_rate, 128, 100, s_output);
+    min_snr = MIN(min_snr, tone_snr(s_output, count, frequency, out_rate, &edge_gain));
+
+    // Tones between 0.6 of the output rate and the input Nyquist frequency would alias into the passband.
+    for (frequency = 0.6 * out_rate; frequency < (0.5 * in_rate); frequency += 0.05 * out_rate)
+    {
+        tone(frequency, in_rate);
+        count     = convert(in_rate, out_rate, 128, 100, s_output);
+        max_alias = MAX(max_alias, level_db(s_output, count));
+    }
+
+    printf("%5u -> %5u Hz: SNR %5.1f dB, passband gain error %4.2f dB, edge gain %5.2f dB, aliasing %6.1f dB\n",
+           in_rate, out_rate, min_snr, max_gain_error, edge_gain, max_alias);
+
+    TEST_CHECK(min_snr >= MIN_SNR_DB);
+    TEST_CHECK(max_gain_error <= MAX_GAIN_ERROR_DB);
+    TEST_CHECK(fabs(edge_gain) <= MAX_EDGE_LOSS_DB);
+    TEST_CHECK(max_alias <= MAX_ALIAS_DB);
+}
+
+static void block_size_test(void)
+{
+    static const size_t blocks[][2] = { { 64, 7 }, { 1, 1 }, { 333, 1000 }, { 128, 128 } };
+    size_t              reference;
+    size_t              count;
+    size_t              i;
+
+    srand(1);
+    for (i = 0; i < INPUT_LENGTH; i++)
+    {
+        s_input[i] = (int16_t)((rand() % 40000) - 20000);
+    }
+
+    reference = convert(16125, 8000, 256, 256, s_reference);
+
+    for (i = 0; i < ARRAY_SIZE(blocks); i++)
+    {
+        count = convert(16125, 8000, blocks[i][0], blocks[i][1], s_output);
+
+        // Input not filling a whole block is not converted, so compare the common part.
+        TEST_CHECK(abs((int)count - (int)reference) <= 256);
+        TEST_CHECK(memcmp(s_output, s_reference, MIN(count, reference) * sizeof(int16_t)) == 0);
+    }
+}
+
+static void benchmark(uint32_t in_rate, uint32_t out_rate)
+{
+    const int   runs = 20;
+    size_t      count = 0;
+    clock_t     start;
+    double      elapsed;
+    int         run;
+
+    start = clock();
+    for (run = 0; run < runs; run++)
+    {
+        count = convert(in_rate, out_rate, 128, 128, s_output);
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC / runs;
+
+    printf("%5u -> %5u Hz: %u MAC per output sample, %.1f ns per output sample on the host\n",
+           in_rate, out_rate, 2 * SINC_RESAMPLER_WING(in_rate, out_rate), elapsed * 1e9 / count);
+}
+
+int main(void)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < ARRAY_SIZE(s_in_rates); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(s_out_rates); j++)
+        {
+            rates_test(s_in_rates[i], s_out_rates[j]);
+        }
+    }
+
+    block_size_test();
+
+    benchmark(16125, 16000);
+    benchmark(16125, 8000);
+    benchmark(16125, 32000);
+
+    return TEST_RESULT();
+}
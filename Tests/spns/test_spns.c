@@ -0,0 +1,199 @@
+/**@file
+ *
+ * @brief Quality test and CPU benchmark of the single-microphone spectral noise suppressor.
+ *
+ * @details A harmonic voice with pauses is mixed with stationary and slowly varying noise. For each
+ *          scenario the test reports the SNR, the segmental SNR over voiced 20 ms segments and the
+ *          attenuation during pauses, before and after suppression, and the host time per block.
+ *
+ *          The gain floor is that of the board configuration, converted as in drv_audio_ns.c.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "test.h"
+#include "app_util.h"
+#include "spns.h"
+
+#define FS                  16000
+#define BLOCK_SIZE          128                     /**< Samples per spns_process() call. */
+#define LATENCY             SPNS_FFT_SIZE           /**< Output delay of the suppressor. */
+#define SCENARIO_LENGTH     (12 * FS)
+#define SETTLE_LENGTH       (4 * FS)                /**< Samples skipped before measuring. */
+#define SEGMENT_LENGTH      (FS / 50)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef enum
+{
+    NOISE_WHITE,
+    NOISE_PINK_HUM,
+    NOISE_MODULATED,
+} noise_t;
+
+typedef struct
+{
+    const char *p_name;
+    noise_t     noise;
+    double      noise_gain;         /**< Level of the noise. */
+    double      min_seg_gain_db;    /**< Required segmental SNR improvement. */
+    double      min_atten_db;       /**< Required attenuation during pauses. */
+} scenario_t;
+
+static const scenario_t s_scenarios[] =
+{
+    { "white",          NOISE_WHITE,        0.1, 2.0, 12.0 },
+    { "white_loud",     NOISE_WHITE,        0.3, 3.5, 12.0 },
+    { "pink_hum",       NOISE_PINK_HUM,     0.1, 5.0, 10.0 },
+    { "modulated",      NOISE_MODULATED,    0.1, 1.0,  4.0 },
+};
+
+static spns_t   s_spns;
+static double   s_clean[SCENARIO_LENGTH];
+static double   s_noisy[SCENARIO_LENGTH];
+static int16_t  s_buffer[SCENARIO_LENGTH];
+
+static int16_t sat16(double x)
+{
+    return (int16_t)MAX(-32768.0, MIN(32767.0, x));
+}
+
+static void scenario_generate(const scenario_t *p_scenario)
+{
+    double  lowpass[2] = { 0.0, 0.0 };
+    size_t  i;
+    int     h;
+
+    srand(7);
+
+    for (i = 0; i < SCENARIO_LENGTH; i++)
+    {
+        double t        = (double)i / FS;
+        double env      = ((t > 1.0) && (fmod(t, 2.0) < 1.0)) ? 0.5 * (1.0 - cos(2.0 * M_PI * fmod(t, 1.0))) : 0.0;
+        double f0       = 140.0 + 20.0 * sin(2.0 * M_PI * 0.7 * t);
+        double white    = ((double)rand() / RAND_MAX) - 0.5;
+        double noise;
+
+        s_clean[i] = 0.0;
+        for (h = 1; h < 25; h++)
+        {
+            s_clean[i] += 3000.0 * env * sin(2.0 * M_PI * f0 * h * t + h) / h;
+        }
+
+        switch (p_scenario->noise)
+        {
+            case NOISE_PINK_HUM:
+                lowpass[0] = (0.9 * lowpass[0]) + (0.1 * white);
+                lowpass[1] = (0.9 * lowpass[1]) + (0.1 * lowpass[0]);
+                noise      = (20.0 * lowpass[1]) + (0.1 * sin(2.0 * M_PI * 100.0 * t));
+                break;
+
+            case NOISE_MODULATED:
+                noise = white * (1.0 + 0.5 * sin(2.0 * M_PI * 0.3 * t));
+                break;
+
+            default:
+                noise = white;
+                break;
+        }
+
+        s_noisy[i]  = s_clean[i] + (p_scenario->noise_gain * 8000.0 * noise);
+        s_buffer[i] = sat16(s_noisy[i]);
+    }
+}
+
+static double snr_db(double signal, double noise)
+{
+    return MAX(-10.0, MIN(35.0, 10.0 * log10(signal / noise)));
+}
+
+static void scenario_run(const scenario_t *p_scenario)
+{
+    double  seg_in = 0.0;
+    double  seg_out = 0.0;
+    double  signal = 0.0;
+    double  noise_in = 0.0;
+    double  noise_out = 0.0;
+    double  pause_in = 0.0;
+    double  pause_out = 0.0;
+    double  elapsed;
+    clock_t start;
+    size_t  segments = 0;
+    size_t  pos;
+    size_t  i;
+
+    scenario_generate(p_scenario);
+
+    TEST_CHECK(spns_init(&s_spns, (CONFIG_AUDIO_NS_GAIN_FLOOR * 32767) / 100) == 0);
+
+    start = clock();
+    for (pos = 0; pos < SCENARIO_LENGTH; pos += BLOCK_SIZE)
+    {
+        spns_process(&s_spns, &s_buffer[pos], BLOCK_SIZE);
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    for (pos = SETTLE_LENGTH; (pos + SEGMENT_LENGTH + LATENCY) <= SCENARIO_LENGTH; pos += SEGMENT_LENGTH)
+    {
+        double seg_signal = 0.0;
+        double seg_noise_in = 0.0;
+        double seg_noise_out = 0.0;
+
+        for (i = pos; i < (pos + SEGMENT_LENGTH); i++)
+        {
+            double out = s_buffer[i + LATENCY];
+
+            seg_signal      += s_clean[i] * s_clean[i];
+            seg_noise_in    += (s_noisy[i] - s_clean[i]) * (s_noisy[i] - s_clean[i]);
+            seg_noise_out   += (out - s_clean[i]) * (out - s_clean[i]);
+
+            if (s_clean[i] == 0.0)
+            {
+                pause_in    += s_noisy[i] * s_noisy[i];
+                pause_out   += out * out;
+            }
+        }
+
+        signal      += seg_signal;
+        noise_in    += seg_noise_in;
+        noise_out   += seg_noise_out;
+
+        // Only voiced segments count towards the segmental SNR.
+        if (seg_signal > (1000.0 * SEGMENT_LENGTH))
+        {
+            seg_in  += snr_db(seg_signal, seg_noise_in);
+            seg_out += snr_db(seg_signal, seg_noise_out);
+            segments++;
+        }
+    }
+
+    seg_in  /= segments;
+    seg_out /= segments;
+
+    printf("%-11s SNR %6.2f -> %6.2f dB, segSNR %6.2f -> %6.2f dB, pause attenuation %5.2f dB, %5.1f us/block\n",
+           p_scenario->p_name,
+           10.0 * log10(signal / noise_in), 10.0 * log10(signal / noise_out),
+           seg_in, seg_out,
+           10.0 * log10(pause_in / pause_out),
+           (elapsed * 1e6 * BLOCK_SIZE) / SCENARIO_LENGTH);
+
+    TEST_CHECK((seg_out - seg_in) >= p_scenario->min_seg_gain_db);
+    TEST_CHECK(10.0 * log10(pause_in / pause_out) >= p_scenario->min_atten_db);
+}
+
+int main(void)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(s_scenarios); i++)
+    {
+        scenario_run(&s_scenarios[i]);
+    }
+
+    return TEST_RESULT();
+}
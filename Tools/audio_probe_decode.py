@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form, except as embedded into a Nordic
+#    Semiconductor ASA integrated circuit in a product or a software update for
+#    such product, must reproduce the above copyright notice, this list of
+#    conditions and the following disclaimer in the documentation and/or other
+#    materials provided with the distribution.
+#
+# 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# 4. This software, with or without modification, must only be used with a
+#    Nordic Semiconductor ASA integrated circuit.
+#
+# 5. Any software provided in binary form under this license must not be reverse
+#    engineered, decompiled, modified and/or disassembled.
+#
+# THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+# OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Split a multiplexed Audio Probe tap stream into one WAV file per probe point.
+
+The input is the raw content of the RTT up channel, captured for example with
+JLinkRTTLogger. The frame format is described in docs/dox/tools/audioprobe.dox
+(CONFIG_AUDIO_PROBE_STREAM_ENABLED). The decoder searches for the sync word, so
+a capture may start in the middle of a frame. Frames missing from the sequence
+of a probe point are replaced with silence of the size of the next received
+frame, which keeps the recordings of all probe points aligned.
+"""
+
+import argparse
+import struct
+import sys
+import wave
+
+SYNC = 0xA55A
+HEADER = struct.Struct('<HBBHHHH')
+
+CODING_RAW = 0
+CODING_RICE = 1
+RICE_K_MAX = 15
+RICE_ESCAPE = 24
+RICE_ESCAPE_BITS = 17
+
+# Indexed by m_audio_probe_point_enum_t. Only tap points appear in the stream.
+POINTS = ('anr.in', 'anr.out', 'codec.in', 'eq.in', 'eq.out', 'gain.in', 'gain.out',
+          'info', 'ns.in', 'ns.out', 'pdm.out')
+
+
+class BitReader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def bit(self):
+        byte = self.data[self.pos >> 3]     # IndexError past the payload
+        value = (byte >> (7 - (self.pos & 7))) & 1
+        self.pos += 1
+        return value
+
+    def bits(self, count):
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | self.bit()
+        return value
+
+
+def rice_decode(payload, samples, k):
+    """Return the samples of a Rice-coded payload, or None if it is inconsistent."""
+    if len(payload) < 2:
+        return None
+
+    out = [struct.unpack_from('<h', payload)[0]]
+    reader = BitReader(payload[2:])
+
+    try:
+        for _ in range(samples - 1):
+            q = 0
+            while (q < RICE_ESCAPE) and reader.bit():
+                q += 1
+
+            if q == RICE_ESCAPE:
+                u = reader.bits(RICE_ESCAPE_BITS)
+            else:
+                u = (q << k) | reader.bits(k)
+
+            delta = -((u + 1) >> 1) if (u & 1) else (u >> 1)
+            out.append(((out[-1] + delta + 0x8000) & 0xFFFF) - 0x8000)
+    except IndexError:
+        return None
+
+    if (reader.pos + 7) // 8 != len(payload) - 2:
+        return None
+
+    return out
+
+
+def frame_parse(data, pos):
+    """Return (point, sequence, dropped, samples, frame size) of a valid frame at pos, or None."""
+    if pos + HEADER.size > len(data):
+        return None
+
+    sync, point, coding, sequence, count, payload_size, dropped = HEADER.unpack_from(data, pos)
+    if (sync != SYNC) or (point >= len(POINTS)) or (count == 0) or (coding > CODING_RICE + RICE_K_MAX):
+        return None
+
+    end = pos + HEADER.size + payload_size
+    if end > len(data):
+        return None
+
+    payload = data[pos + HEADER.size:end]
+    if coding == CODING_RAW:
+        if payload_size != 2 * count:
+            return None
+        samples = list(struct.unpack('<{}h'.format(count), payload))
+    else:
+        if payload_size >= 2 * count:
+            return None
+        samples = rice_decode(payload, count, coding - CODING_RICE)
+        if samples is None:
+            return None
+
+    return point, sequence, dropped, samples, end - pos
+
+
+class Track(object):
+    def __init__(self):
+        self.samples = []
+        self.sequence = None
+        self.frames = 0
+        self.missing = 0
+        self.dropped = 0
+
+
+def decode(data):
+    """Return a dictionary of tracks by probe point, and the number of bytes skipped while searching for frames."""
+    tracks = {}
+    skipped = 0
+    pos = 0
+
+    while pos < len(data):
+        frame = frame_parse(data, pos)
+        if frame is None:
+            pos += 1
+            skipped += 1
+            continue
+
+        point, sequence, dropped, samples, size = frame
+        track = tracks.setdefault(point, Track())
+
+        if track.sequence is not None:
+            gap = (sequence - track.sequence) & 0xFFFF
+            track.samples += [0] * (gap * len(samples))
+            track.missing += gap
+
+        track.samples += samples
+        track.sequence = (sequence + 1) & 0xFFFF
+        track.frames += 1
+        track.dropped = dropped
+        pos += size
+
+    return tracks, skipped
+
+
+def wav_write(path, samples, rate):
+    w = wave.open(path, 'wb')
+    w.setnchannels(1)
+    w.setsampwidth(2)
+    w.setframerate(rate)
+    w.writeframes(struct.pack('<{}h'.format(len(samples)), *samples))
+    w.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', help='raw RTT up channel capture')
+    parser.add_argument('prefix', help='output files are named <prefix>_<point>.wav')
+    parser.add_argument('--rate', type=int, default=16000, help='sampling frequency (default: %(default)s)')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        data = f.read()
+
+    tracks, skipped = decode(data)
+    if skipped:
+        print('{}: skipped {} B without a valid frame'.format(args.capture, skipped))
+
+    for point in sorted(tracks):
+        track = tracks[point]
+        path = '{}_{}.wav'.format(args.prefix, POINTS[point])
+        wav_write(path, track.samples, args.rate)
+        print('{}: {} frames, {} missing, {} dropped on target, {} samples'.format(
+            path, track.frames, track.missing, track.dropped, len(track.samples)))
+
+    return 0 if tracks else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2016 - 2018, Nordic Semiconductor ASA
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form, except as embedded into a Nordic
+#    Semiconductor ASA integrated circuit in a product or a software update for
+#    such product, must reproduce the above copyright notice, this list of
+#    conditions and the following disclaimer in the documentation and/or other
+#    materials provided with the distribution.
+#
+# 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# 4. This software, with or without modification, must only be used with a
+#    Nordic Semiconductor ASA integrated circuit.
+#
+# 5. Any software provided in binary form under this license must not be reverse
+#    engineered, decompiled, modified and/or disassembled.
+#
+# THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+# OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Encode an application image into the stream format decoded by the bootloader.
+
+The format is described in Source/Bootloader/dfu_req_handling/dfu_image_decode.h.
+Without --base, the stream is a compressed image. With --base, the stream may also
+copy from the application currently installed on the device, which must be the
+given file.
+
+The stream is sent instead of the image. Set app_stream_size in the init command
+to the size of the stream, while app_size and the hash still describe the image.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x315A5253
+
+LITERAL_MAX_LEN = 0x80
+COPY_OUTPUT_MIN_LEN = 3
+COPY_OUTPUT_MAX_LEN = 0x3F + COPY_OUTPUT_MIN_LEN
+COPY_OUTPUT_MAX_DISTANCE = 0x10000
+COPY_BASE_MAX_LEN = 0x4000
+COPY_BASE_MAX_OFFSET = 0xFFFFFF
+
+BASE_BLOCK_LEN = 8      # Base matches are found through blocks of this size.
+OUTPUT_HASH_LEN = 3     # Output matches are found through strings of this size.
+OUTPUT_CHAIN_DEPTH = 32 # Number of candidates tried for an output match.
+
+
+class Encoder(object):
+    def __init__(self, image, base):
+        self.image = image
+        self.base = base
+        self.stream = bytearray()
+        self.literal = bytearray()
+        self.base_index = {}
+        self.output_index = {}
+
+        for offset in range(0, min(len(base), COPY_BASE_MAX_OFFSET) - BASE_BLOCK_LEN + 1):
+            self.base_index.setdefault(bytes(base[offset:offset + BASE_BLOCK_LEN]), offset)
+
+    def flush_literal(self):
+        while self.literal:
+            chunk = self.literal[:LITERAL_MAX_LEN]
+            self.stream.append(len(chunk) - 1)
+            self.stream += chunk
+            self.literal = self.literal[LITERAL_MAX_LEN:]
+
+    def base_match(self, pos):
+        offset = self.base_index.get(bytes(self.image[pos:pos + BASE_BLOCK_LEN]))
+        if offset is None:
+            return 0, 0
+
+        length = 0
+        limit = min(COPY_BASE_MAX_LEN, len(self.image) - pos, len(self.base) - offset)
+        while (length < limit) and (self.image[pos + length] == self.base[offset + length]):
+            length += 1
+
+        return length, offset
+
+    def output_match(self, pos):
+        best_length, best_distance = 0, 0
+        limit = min(COPY_OUTPUT_MAX_LEN, len(self.image) - pos)
+
+        for start in reversed(self.output_index.get(bytes(self.image[pos:pos + OUTPUT_HASH_LEN]), [])):
+            distance = pos - start
+            if distance > COPY_OUTPUT_MAX_DISTANCE:
+                break
+
+            length = 0
+            while (length < limit) and (self.image[start + length] == self.image[pos + length]):
+                length += 1
+
+            if length > best_length:
+                best_length, best_distance = length, distance
+
+        return best_length, best_distance
+
+    def index_output(self, pos, length):
+        for i in range(pos, pos + length):
+            candidates = self.output_index.setdefault(bytes(self.image[i:i + OUTPUT_HASH_LEN]), [])
+            candidates.append(i)
+            del candidates[:-OUTPUT_CHAIN_DEPTH]
+
+    def encode(self):
+        base_crc = (zlib.crc32(bytes(self.base)) & 0xFFFFFFFF) if self.base else 0
+        self.stream += struct.pack('<III', MAGIC, len(self.base), base_crc)
+
+        pos = 0
+        while pos < len(self.image):
+            base_length, offset = self.base_match(pos)
+            output_length, distance = self.output_match(pos)
+
+            if (base_length >= BASE_BLOCK_LEN) and (base_length >= output_length):
+                self.flush_literal()
+                self.stream.append(0xC0 | ((base_length - 1) >> 8))
+                self.stream.append((base_length - 1) & 0xFF)
+                self.stream += struct.pack('<I', offset)[:3]
+                length = base_length
+            elif output_length >= COPY_OUTPUT_MIN_LEN:
+                self.flush_literal()
+                self.stream.append(0x80 | (output_length - COPY_OUTPUT_MIN_LEN))
+                self.stream += struct.pack('<H', distance - 1)
+                length = output_length
+            else:
+                self.literal.append(self.image[pos])
+                length = 1
+
+            self.index_output(pos, length)
+            pos += length
+
+        self.flush_literal()
+        return self.stream
+
+
+def encode(image, base=b''):
+    """Return the stream that decodes to image, optionally referring to base."""
+    return Encoder(bytearray(image), bytearray(base)).encode()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('image', help='new application image (binary)')
+    parser.add_argument('stream', help='output stream')
+    parser.add_argument('--base', help='application image currently installed on the device (binary)')
+    args = parser.parse_args()
+
+    with open(args.image, 'rb') as f:
+        image = f.read()
+
+    base = b''
+    if args.base:
+        with open(args.base, 'rb') as f:
+            base = f.read()
+
+    stream = encode(image, base)
+
+    with open(args.stream, 'wb') as f:
+        f.write(stream)
+
+    print('{}: {} B image encoded into {} B stream ({:.1f}%)'.format(
+        args.stream, len(image), len(stream), 100.0 * len(stream) / max(len(image), 1)))
+
+
+if __name__ == '__main__':
+    sys.exit(main())
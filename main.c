@@ -69,6 +69,7 @@
 #include "app_timer.h"
 #include "task_manager.h"
 
+#include "m_batt_meas.h"
 #include "m_init.h"
 
 #include "resources.h"
@@ -94,8 +95,13 @@
  * Safety Multiplier:                   1.5 (as SoftDevice might block application execution for a while)
  *
  * RESULT (rounded up):                 3 (5 with audio gauges enabled)
+ *
+ * Audio is processed in capture blocks. When a frame is split into several blocks,
+ * the queue has to be able to hold all additional blocks of the audio buffer pool.
  */
-#define APP_ISCHED_QUEUE_SIZE_BG        (3 + ((CONFIG_AUDIO_GAUGES_ENABLED) ? 2 : 0))
+#define APP_ISCHED_QUEUE_SIZE_BG        (3 + ((CONFIG_AUDIO_GAUGES_ENABLED) ? 2 : 0) +                           \
+                                         ((CONFIG_AUDIO_ENABLED) ?                                              \
+                                          (CONFIG_PDM_BUFFER_POOL_SIZE - CONFIG_AUDIO_BUFFER_POOL_SIZE) : 0))
 
 /**@brief SDK app_scheduler emmulation event pool size */
 #define APP_SCHED_EVENT_POOL_SIZE       APP_ISCHED_QUEUE_SIZE_FG
@@ -106,7 +112,8 @@
 /**@brief Number of modules using app_gpiote.
  *
  * drv_acc_lis3dh:                      1
- * drv_keyboard_matrix:                 1
+ * drv_keyboard_matrix or
+ * drv_keyboard_sx1509 (keypad engine): 1
  * ------------------------------------
  * TOTAL:                               2
  */
@@ -153,10 +160,28 @@ app_isched_t g_fg_scheduler;
 /**@brief Backgroud Scheduler. */
 app_isched_t g_bg_scheduler;
 
-/**@brief SWI1 IRQ Handler used to execute foregroud scheduler tasks. */
+/**@brief Set when the foreground scheduler raises SWI1. */
+static volatile bool s_fg_scheduler_pending;
+
+/**@brief SWI1 IRQ Handler used to execute foregroud scheduler tasks.
+ *
+ * @note The SoftDevice raises this interrupt also for the radio notification.
+ */
 void SWI1_EGU1_IRQHandler(void)
 {
-    app_isched_events_execute(&g_fg_scheduler);
+    if (s_fg_scheduler_pending)
+    {
+        s_fg_scheduler_pending = false;
+        app_isched_events_execute(&g_fg_scheduler);
+    }
+#if CONFIG_BATT_MEAS_ENABLED
+    else
+    {
+        // A radio notification which comes together with a scheduler event is missed. The measurement then waits
+        // for the next one, or for its timeout, but it is never taken in the middle of a radio event.
+        m_batt_meas_radio_evt_handler();
+    }
+#endif
 }
 
 /**@brief Foreground scheduler post-put hook */
@@ -164,6 +189,7 @@ static void fg_scheduler_post_put_hook(const app_isched_t *p_isched,
                                        const app_isched_event_t *p_evt,
                                        void *p_hook_context)
 {
+    s_fg_scheduler_pending = true;
     NVIC_SetPendingIRQ(SWI1_IRQn);
 }
 